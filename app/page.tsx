@@ -3,7 +3,7 @@
 import { useEffect, useMemo, useState } from 'react';
 import { storage } from '@/lib/storage';
 import { GhostMeshNetwork } from '@/lib/mesh-network';
-import { Message, Device, Contact, SOSLog } from '@/lib/types';
+import { Message, Device, Contact, SOSLog, NativeStats } from '@/lib/types';
 import { StatusBadge } from '@/components/StatusBadge';
 import { DashboardCard } from '@/components/DashboardCard';
 import { ContactsCard } from '@/components/ContactsCard';
@@ -32,6 +32,7 @@ export default function Home() {
   const [expandedSections, setExpandedSections] = useState<Set<TabKey>>(new Set(['dashboard']));
   const [meshActive, setMeshActive] = useState(false);
   const [performanceData, setPerformanceData] = useState<Array<{ timestamp: number; bleDeviceCount: number }>>([]);
+  const [nativeStats, setNativeStats] = useState<NativeStats | null>(null);
   const [sosLogs, setSosLogs] = useState<SOSLog[]>([]);
 
   const toggleSection = (section: TabKey) => {
@@ -111,6 +112,8 @@ export default function Home() {
     meshNetwork.setOnPerformanceUpdate((data) => {
       setPerformanceData([...data]);
     });
+    meshNetwork.setOnNativeStats(setNativeStats);
+    meshNetwork.setOnHistory(setMessages);
     setNetwork(meshNetwork);
     setDevices(meshNetwork.getAllDevices());
     setPerformanceData(meshNetwork.getPerformanceData());
@@ -398,6 +401,7 @@ export default function Home() {
           isExpanded={expandedSections.has('permon')}
           onToggle={() => toggleSection('permon')}
           performanceData={performanceData}
+          nativeStats={nativeStats}
         />
 
         <SignalHistogramCard
@@ -1,6 +1,7 @@
 import { useEffect, useRef } from 'react';
 import { CardHeader } from './CardHeader';
 import { StatCard } from './StatCard';
+import type { NativeStats } from '@/lib/types';
 
 interface PerformanceData {
   timestamp: number;
@@ -11,9 +12,10 @@ interface PerMonCardProps {
   isExpanded: boolean;
   onToggle: () => void;
   performanceData: PerformanceData[];
+  nativeStats?: NativeStats | null;
 }
 
-export const PerMonCard = ({ isExpanded, onToggle, performanceData }: PerMonCardProps) => {
+export const PerMonCard = ({ isExpanded, onToggle, performanceData, nativeStats }: PerMonCardProps) => {
   const canvasRef = useRef<HTMLCanvasElement>(null);
 
   useEffect(() => {
@@ -195,6 +197,45 @@ export const PerMonCard = ({ isExpanded, onToggle, performanceData }: PerMonCard
             />
           </div>
 
+          {/* Native BLE hot paths, when the server runs the native addon */}
+          {nativeStats && (
+            <div className="card-section">
+              <div className="section-header">
+                <h3 className="section-heading">Native BLE</h3>
+                <span className="text-xs text-gray-500 dark:text-gray-400">
+                  {nativeStats.emitsPerSecond.toFixed(1)} events/s • dispatch p99 {nativeStats.dispatchP99Us} µs
+                  {nativeStats.discoveryP99Ms > 0 && <> • discovery p99 {nativeStats.discoveryP99Ms} ms</>}
+                </span>
+              </div>
+              <div className="card-grid card-grid-4">
+                <StatCard
+                  label="Received/s"
+                  value={nativeStats.receivedPerSecond.toFixed(1)}
+                  icon="download"
+                  colorScheme="emerald"
+                />
+                <StatCard
+                  label="Delivered/s"
+                  value={nativeStats.deliveredPerSecond.toFixed(1)}
+                  icon="done_all"
+                  colorScheme="blue"
+                />
+                <StatCard
+                  label="Deduped"
+                  value={`${Math.round(nativeStats.dedupRatio * 100)}%`}
+                  icon="filter_alt"
+                  colorScheme="purple"
+                />
+                <StatCard
+                  label="Emit p99 µs"
+                  value={nativeStats.emitP99Us}
+                  icon="timer"
+                  colorScheme="red"
+                />
+              </div>
+            </div>
+          )}
+
           {/* Chart */}
           <div className="card-section">
             <div className="section-header">
@@ -109,21 +109,24 @@ export function matchMessageId(a: string, b: string): boolean {
 }
 'use client';
 
-import { Message, Device } from './types';
+import { Message, Device, NativeStats } from './types';
 import { storage } from './storage';
 import { WebBluetoothMesh } from './web-bluetooth';
+import { PeerTableMirror } from '../src/peer-stream';
 
 const WS_URL = process.env.NEXT_PUBLIC_BLE_WS_URL || 'ws://localhost:8080';
 const USE_WEB_BLUETOOTH = typeof window !== 'undefined' && WebBluetoothMesh.isSupported();
 
 interface ServerEvent {
-  type: 'connected' | 'device_update' | 'device_removed' | 'devices_list' | 'message_received' | 'message_sent' | 'error';
+  type: 'connected' | 'devices_list' | 'message_received' | 'message_sent' | 'message_history' | 'native_stats' | 'error';
   device?: any;
   devices?: any[];
   message?: any;
+  messages?: any[];
   error?: string;
   activeCount?: number;
   totalCount?: number;
+  nativeStats?: NativeStats;
 }
 
 export class GhostMeshNetwork {
@@ -137,11 +140,14 @@ export class GhostMeshNetwork {
   private reconnectTimeout: NodeJS.Timeout | null = null;
   private onDeviceUpdate?: (devices: Device[]) => void;
   private onMessageReceived?: (message: Message) => void;
+  private onHistory?: (messages: Message[]) => void;
   private meshActive: boolean = false;
   private onStatusChange?: (active: boolean) => void;
   private performanceData: Array<{ timestamp: number; bleDeviceCount: number }> = [];
   private onPerformanceUpdate?: (data: Array<{ timestamp: number; bleDeviceCount: number }>) => void;
   private performanceInterval: NodeJS.Timeout | null = null;
+  private onNativeStats?: (stats: NativeStats) => void;
+  private peerMirror = new PeerTableMirror();
   private bleDeviceCount: number = 0;
 
   constructor(myPhone: string) {
@@ -159,10 +165,13 @@ export class GhostMeshNetwork {
     try {
       console.log(`🔌 Connecting to BLE server at ${WS_URL}...`);
       this.ws = new WebSocket(WS_URL);
+      this.ws.binaryType = 'arraybuffer';
 
       this.ws.onopen = () => {
         console.log('✅ Connected to BLE server');
         this.reconnectAttempts = 0;
+        // The server opens every connection with a full table
+        this.peerMirror = new PeerTableMirror();
 
         // Initialize mesh node with our phone number
         this.sendCommand({
@@ -173,6 +182,11 @@ export class GhostMeshNetwork {
 
       this.ws.onmessage = (event) => {
         try {
+          // Binary frames are peer-table deltas; everything else is a JSON event
+          if (event.data instanceof ArrayBuffer) {
+            this.handlePeerFrame(event.data);
+            return;
+          }
           const serverEvent: ServerEvent = JSON.parse(event.data);
           this.handleServerEvent(serverEvent);
         } catch (error) {
@@ -281,32 +295,6 @@ export class GhostMeshNetwork {
         this.onStatusChange?.(true);
         break;
 
-      case 'device_update':
-        // Handle single device update
-        if (event.device) {
-          this.updateSingleDevice(event.device);
-        }
-        // Update active device count if provided
-        if (event.activeCount !== undefined) {
-          this.bleDeviceCount = event.activeCount;
-        }
-        break;
-
-      case 'device_removed':
-        // Handle device removal
-        if (event.devices) {
-          event.devices.forEach(removedDevice => {
-            this.devices = this.devices.filter(d => d.id !== removedDevice.id);
-          });
-          storage.updateDevices(this.devices);
-          this.onDeviceUpdate?.(this.devices);
-        }
-        // Update counts
-        if (event.activeCount !== undefined) {
-          this.bleDeviceCount = event.activeCount;
-        }
-        break;
-
       case 'devices_list':
         // Handle full device list
         if (event.devices) {
@@ -330,6 +318,18 @@ export class GhostMeshNetwork {
         }
         break;
 
+      case 'message_history':
+        if (event.messages) {
+          this.mergeHistory(event.messages);
+        }
+        break;
+
+      case 'native_stats':
+        if (event.nativeStats) {
+          this.onNativeStats?.(event.nativeStats);
+        }
+        break;
+
       case 'error':
         console.error('❌ BLE server error:', event.error);
         this.meshActive = false;
@@ -341,26 +341,38 @@ export class GhostMeshNetwork {
     }
   };
 
-  private updateSingleDevice = (deviceData: any) => {
-    const existing = this.devices.find(d => d.id === deviceData.id);
-
-    if (existing) {
-      existing.connected = deviceData.isActive || false;
-      existing.lastSeen = deviceData.lastSeen || Date.now();
-      existing.rssi = deviceData.rssi;
-      existing.activityCount = deviceData.activityCount;
-    } else if (deviceData.status !== 'removed') {
-      this.devices.push({
-        id: deviceData.id,
-        peerId: deviceData.id,
-        lastSeen: deviceData.lastSeen || Date.now(),
-        connected: deviceData.isActive || false,
-        rssi: deviceData.rssi,
-        activityCount: deviceData.activityCount,
-      });
+  // Apply a coalesced peer-table delta (src/peer-stream.ts)
+  private handlePeerFrame = (data: ArrayBuffer) => {
+    const removed = new Set(this.peerMirror.apply(data));
+    this.bleDeviceCount = this.peerMirror.activeCount;
+
+    const byId = new Map(this.devices.filter(d => !removed.has(d.id)).map(d => [d.id, d]));
+    let added = false;
+    for (const peer of this.peerMirror.peers()) {
+      const existing = byId.get(peer.id);
+      if (existing) {
+        existing.connected = peer.active;
+        existing.lastSeen = peer.lastSeen;
+        existing.rssi = peer.rssi;
+        existing.activityCount = peer.activityCount;
+      } else {
+        added = true;
+        byId.set(peer.id, {
+          id: peer.id,
+          peerId: peer.id,
+          lastSeen: peer.lastSeen,
+          connected: peer.active,
+          rssi: peer.rssi,
+          activityCount: peer.activityCount,
+        });
+      }
     }
+    this.devices = Array.from(byId.values());
 
-    storage.updateDevices(this.devices);
+    // Signal updates arrive several times a second; only membership changes are persisted
+    if (added || removed.size > 0) {
+      storage.updateDevices(this.devices);
+    }
     this.onDeviceUpdate?.(this.devices);
   };
 
@@ -456,6 +468,17 @@ export class GhostMeshNetwork {
     }
   };
 
+  // Messages the server kept while this browser was away; no notifications for old messages
+  private mergeHistory = (messages: Message[]) => {
+    const known = new Set(storage.getMessages().map(message => message.id));
+    const missing = messages.filter(message => !known.has(message.id));
+    if (missing.length === 0) {
+      return;
+    }
+    missing.forEach(message => storage.addMessage(message));
+    this.onHistory?.(storage.getMessages());
+  };
+
   getConnectedDevices(): Device[] {
     return this.devices.filter(d => d.connected);
   }
@@ -517,6 +540,14 @@ export class GhostMeshNetwork {
     }
   }
 
+  setOnNativeStats(callback: (stats: NativeStats) => void) {
+    this.onNativeStats = callback;
+  }
+
+  setOnHistory(callback: (messages: Message[]) => void) {
+    this.onHistory = callback;
+  }
+
   getPerformanceData(): Array<{ timestamp: number; bleDeviceCount: number }> {
     return this.performanceData;
   }
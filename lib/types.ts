@@ -30,6 +30,22 @@ export interface MessageStatus {
   timestamp: number;
 }
 
+/**
+ * Native BLE hot-path statistics, sampled by the BLE server every 10 seconds
+ * Rates cover the last sample interval; latencies cover the whole run.
+ */
+export interface NativeStats {
+  timestamp: number;
+  receivedPerSecond: number; // Advertisement reports from the radio
+  deliveredPerSecond: number; // Reports that passed the filters
+  dedupRatio: number; // Share of received reports dropped as duplicates, 0..1
+  emitsPerSecond: number; // Native events that crossed into JS
+  emitP99Us: number; // One native emit, listeners included
+  dispatchP99Us: number; // Platform thread to JS thread
+  rotationJitterP99Us: number; // Advertising rotation lateness
+  discoveryP99Ms: number; // Duty-cycled scans: new peer in range until heard (0 without samples)
+}
+
 export interface SOSLog {
   id: string;
   timestamp: number;
@@ -0,0 +1,171 @@
+/**
+ * @file hci_advertising_check.cc
+ * @brief Feeds canned HCI traffic through the Linux backend's pure halves
+ *
+ * LE Advertising Report parameters as a controller packs them (one and
+ * several reports per event, truncated reports and AD fields) go through
+ * ParseAdvertisingReports(); BuildAdvertisingData() is checked against the
+ * AD payloads it should produce.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "hci_advertising.h"
+
+namespace
+{
+  namespace ble = ghostmesh::ble;
+
+  size_t failures = 0;
+
+  void Expect(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAIL: %s\n", what);
+      ++failures;
+    }
+  }
+
+  // One report: event type, address type, address (LE), data length, data, RSSI
+  void AppendReport(std::vector<uint8_t> &out, uint8_t lastAddressByte, const std::vector<uint8_t> &data, int8_t rssi)
+  {
+    const uint8_t head[] = {0x03, 0x00, lastAddressByte, 0x22, 0x33, 0x44, 0x55, 0x66};
+    out.insert(out.end(), head, head + sizeof(head));
+    out.push_back(static_cast<uint8_t>(data.size()));
+    out.insert(out.end(), data.begin(), data.end());
+    out.push_back(static_cast<uint8_t>(rssi));
+  }
+
+  std::vector<ble::DiscoveredDevice> Parse(const std::vector<uint8_t> &params)
+  {
+    std::vector<ble::DiscoveredDevice> out;
+    ble::DiscoveredDevice device;
+    ble::ParseAdvertisingReports(params.data(), params.size(), 1700000000000ull, device,
+                                 [&out](const ble::DiscoveredDevice &d) { out.push_back(d); });
+    return out;
+  }
+
+  const std::vector<uint8_t> kMeshData = {
+      0x06, 0xFF, 0xFF, 0xFF, 0x01, 0x02, 0x03, // Manufacturer: company 0xFFFF + 3 bytes
+      0x05, 0x03, 0x0D, 0x18, 0x0F, 0x18,       // Complete 16-bit UUIDs 180d, 180f
+      0x05, 0x09, 'n', 'o', 'd', 'e',           // Complete name
+  };
+
+  void CheckSingleReport()
+  {
+    std::vector<uint8_t> params = {1};
+    AppendReport(params, 0x11, kMeshData, -60);
+    std::vector<ble::DiscoveredDevice> devices = Parse(params);
+    Expect(devices.size() == 1, "one report delivered");
+    if (devices.size() != 1)
+      return;
+    const ble::DiscoveredDevice &d = devices[0];
+    Expect(d.address == "66:55:44:33:22:11", "address printed most significant byte first");
+    Expect(d.rssi == -60, "RSSI after the data");
+    Expect(d.timestamp == 1700000000000ull, "timestamp passed through");
+    Expect(d.manufacturerData == std::vector<uint8_t>({0xFF, 0xFF, 0x01, 0x02, 0x03}), "manufacturer data");
+    Expect(d.serviceUUIDs == std::vector<std::string>({"180d", "180f"}), "16-bit UUIDs");
+    Expect(d.name == "node", "complete name");
+  }
+
+  void CheckSeveralReports()
+  {
+    const std::vector<uint8_t> uuid128 = {0x11, 0x07, 0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80,
+                                          0x00, 0x10, 0x00, 0x00, 0x0D, 0x18, 0x00, 0x00};
+    std::vector<uint8_t> params = {3};
+    AppendReport(params, 0x01, kMeshData, -40);
+    AppendReport(params, 0x02, {}, -70);
+    AppendReport(params, 0x03, uuid128, -90);
+    std::vector<ble::DiscoveredDevice> devices = Parse(params);
+    Expect(devices.size() == 3, "three reports in one event");
+    if (devices.size() != 3)
+      return;
+    Expect(devices[0].address == "66:55:44:33:22:01" && devices[0].name == "node", "first report");
+    // The reused device is cleared between reports
+    Expect(devices[1].address == "66:55:44:33:22:02" && devices[1].rssi == -70 && devices[1].name.empty() &&
+               devices[1].manufacturerData.empty() && devices[1].serviceUUIDs.empty(),
+           "empty report after a full one");
+    Expect(devices[2].serviceUUIDs == std::vector<std::string>({"0000180d-0000-1000-8000-00805f9b34fb"}),
+           "128-bit UUID");
+  }
+
+  void CheckTruncated()
+  {
+    std::vector<uint8_t> full = {2};
+    AppendReport(full, 0x01, kMeshData, -40);
+    AppendReport(full, 0x02, kMeshData, -50);
+
+    // Any cut into the second report drops it alone; one byte more drops the first too
+    const size_t reportSize = 10 + kMeshData.size();
+    for (size_t cut = 1; cut <= reportSize + 1; ++cut)
+    {
+      std::vector<uint8_t> params(full.begin(), full.end() - static_cast<long>(cut));
+      Expect(Parse(params).size() == (cut <= reportSize ? 1u : 0u), "truncated report dropped");
+    }
+
+    // A count promising more reports than the event holds
+    std::vector<uint8_t> params = {5};
+    AppendReport(params, 0x01, kMeshData, -40);
+    Expect(Parse(params).size() == 1, "count past the end of the event");
+    Expect(Parse({}).empty() && Parse({0}).empty(), "empty event");
+
+    // An AD field running past the report's data: earlier fields are kept
+    std::vector<uint8_t> data = {0x05, 0x09, 'n', 'o', 'd', 'e', 0x09, 0xFF, 0xFF, 0xFF};
+    params = {1};
+    AppendReport(params, 0x01, data, -40);
+    std::vector<ble::DiscoveredDevice> devices = Parse(params);
+    Expect(devices.size() == 1 && devices[0].name == "node" && devices[0].manufacturerData.empty(),
+           "truncated AD field");
+  }
+
+  void CheckBuild()
+  {
+    uint8_t ad[ble::kLegacyAdvertisingDataMax + 1];
+    const uint8_t mesh[] = {0xFF, 0xFF, 0x01, 0x02};
+
+    size_t length = ble::BuildAdvertisingData(mesh, sizeof(mesh), "node", ad);
+    const uint8_t expected[] = {0x05, 0xFF, 0xFF, 0xFF, 0x01, 0x02, 0x05, 0x09, 'n', 'o', 'd', 'e'};
+    Expect(length == sizeof(expected) && std::memcmp(ad, expected, sizeof(expected)) == 0,
+           "manufacturer data then complete name");
+
+    // The name is shortened to the room left
+    std::vector<uint8_t> big(ble::kHciManufacturerDataMax - 5, 0xAB);
+    length = ble::BuildAdvertisingData(big.data(), big.size(), "a-long-name", ad);
+    Expect(length == ble::kLegacyAdvertisingDataMax && ad[big.size() + 3] == 0x08 &&
+               ad[big.size() + 2] == 4,
+           "shortened name fills the PDU");
+
+    // Full manufacturer data leaves no room for a name
+    std::vector<uint8_t> full(ble::kHciManufacturerDataMax, 0xCD);
+    Expect(ble::BuildAdvertisingData(full.data(), full.size(), "node", ad) == ble::kLegacyAdvertisingDataMax,
+           "29 bytes of manufacturer data fit");
+
+    // One byte more does not fit, and nothing is written
+    std::vector<uint8_t> over(ble::kHciManufacturerDataMax + 1, 0xEE);
+    ad[0] = 0x42;
+    Expect(ble::BuildAdvertisingData(over.data(), over.size(), "", ad) == 0 && ad[0] == 0x42,
+           "30 bytes rejected");
+
+    // A name alone; the round trip through the parser gives it back
+    length = ble::BuildAdvertisingData(nullptr, 0, "node", ad);
+    std::vector<uint8_t> params = {1};
+    AppendReport(params, 0x01, std::vector<uint8_t>(ad, ad + length), -40);
+    std::vector<ble::DiscoveredDevice> devices = Parse(params);
+    Expect(length == 6 && devices.size() == 1 && devices[0].name == "node", "name only round trip");
+  }
+} // namespace
+
+int main()
+{
+  CheckSingleReport();
+  CheckSeveralReports();
+  CheckTruncated();
+  CheckBuild();
+  std::printf("hci advertising: %zu failed checks\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file mesh_header_batch_check.cc
+ * @brief Checks the compiled mesh header kernel against the scalar one
+ *
+ * Every batch sits in a buffer that ends right after the last record's
+ * header, so a kernel that loads a full vector there reads out of bounds;
+ * build with -fsanitize=address to have that reported instead of missed.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "mesh_header_batch.h"
+
+namespace
+{
+  using ghostmesh::mesh::MeshHeaderColumns;
+
+  struct Columns
+  {
+    explicit Columns(size_t count)
+        : companyId(count), dstId(count), srcId(count), messageId(count), packetNumber(count), hopCount(count),
+          match(count)
+    {
+    }
+
+    MeshHeaderColumns View()
+    {
+      return {companyId.data(), dstId.data(), srcId.data(), messageId.data(), packetNumber.data(), hopCount.data()};
+    }
+
+    std::vector<uint16_t> companyId;
+    std::vector<double> dstId;
+    std::vector<double> srcId;
+    std::vector<uint16_t> messageId;
+    std::vector<uint8_t> packetNumber;
+    std::vector<uint8_t> hopCount;
+    std::vector<uint8_t> match;
+  };
+
+  template <typename T>
+  bool Same(const std::vector<T> &a, const std::vector<T> &b, const char *field, size_t stride, size_t count)
+  {
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      if (a[i] != b[i])
+      {
+        std::fprintf(stderr, "%s differs at record %zu of %zu (stride %zu)\n", field, i, count, stride);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool CheckBatch(size_t stride, size_t count, uint32_t seed)
+  {
+    std::vector<uint8_t> bytes(count == 0 ? 0 : stride * (count - 1) + ghostmesh::mesh::kMeshHeaderSize);
+    uint32_t state = seed;
+    for (uint8_t &b : bytes)
+    {
+      state = state * 1664525u + 1013904223u;
+      b = static_cast<uint8_t>(state >> 24);
+    }
+    // Every other record shares the first one's company, every third its destination
+    for (size_t i = 2; i < count; i += 2)
+      std::copy(bytes.begin(), bytes.begin() + 2, bytes.begin() + i * stride);
+    for (size_t i = 3; i < count; i += 3)
+      std::copy(bytes.begin() + 2, bytes.begin() + 7, bytes.begin() + i * stride + 2);
+
+    Columns kernel(count);
+    Columns scalar(count);
+    ghostmesh::mesh::DecodeMeshHeaders(bytes.data(), stride, count, kernel.View());
+    ghostmesh::mesh::DecodeMeshHeadersScalar(bytes.data(), stride, count, scalar.View());
+
+    bool ok = Same(kernel.companyId, scalar.companyId, "companyId", stride, count) &&
+              Same(kernel.dstId, scalar.dstId, "dstId", stride, count) &&
+              Same(kernel.srcId, scalar.srcId, "srcId", stride, count) &&
+              Same(kernel.messageId, scalar.messageId, "messageId", stride, count) &&
+              Same(kernel.packetNumber, scalar.packetNumber, "packetNumber", stride, count) &&
+              Same(kernel.hopCount, scalar.hopCount, "hopCount", stride, count);
+    if (!ok || count == 0)
+      return ok;
+
+    const uint16_t companyId = scalar.companyId[0];
+    const uint64_t dstId = static_cast<uint64_t>(scalar.dstId[0]);
+    const size_t kernelMatched =
+        ghostmesh::mesh::MatchMeshHeaders(kernel.View(), count, companyId, dstId, kernel.match.data());
+    const size_t scalarMatched =
+        ghostmesh::mesh::MatchMeshHeadersScalar(scalar.View(), count, companyId, dstId, scalar.match.data());
+    if (kernelMatched != scalarMatched)
+    {
+      std::fprintf(stderr, "matched %zu, scalar %zu (stride %zu, %zu records)\n", kernelMatched, scalarMatched,
+                   stride, count);
+      return false;
+    }
+    return Same(kernel.match, scalar.match, "match", stride, count);
+  }
+} // namespace
+
+int main()
+{
+  // The header size itself, one vector, a legacy advertisement, padded, a discovery record
+  const size_t strides[] = {ghostmesh::mesh::kMeshHeaderSize, 16, 33, 40, 48};
+  size_t failures = 0;
+  for (size_t stride : strides)
+    for (size_t count = 0; count <= 40; ++count)
+      failures += !CheckBatch(stride, count, static_cast<uint32_t>(stride * 1000 + count));
+
+  std::printf("%s kernel: %zu failed batches\n", ghostmesh::mesh::kMeshHeaderKernel, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file message_store_check.cc
+ * @brief Reopens message stores left behind by an interrupted append
+ *
+ * An append commits its record in the log header before inserting it into the
+ * index's sorted arrays. A crash in between leaves the index one record behind
+ * the log, and if it struck during the insert, with one entry of each array
+ * duplicated over its neighbour. Reopening must rebuild the index, not trust it.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mesh_packet.h"
+#include "message_store.h"
+
+namespace
+{
+  namespace mesh = ghostmesh::mesh;
+
+  const char *const kStorePath = "/tmp/ghostmesh_message_store_check.gmlog";
+  constexpr size_t kRecords = 200;
+  constexpr long kIndexCountOffset = 16; // IndexHeader::count, then capacity
+  constexpr long kIndexArraysOffset = 64;
+  constexpr long kEntrySize = 16; // KeyEntry and TimeEntry
+
+  // Keys and timestamps out of append order, so every insert shifts the arrays
+  uint64_t KeyOf(size_t i) { return mesh::MessageKey((i * 2654435761u) % 97, uint16_t(i)); }
+  double TimeOf(size_t i) { return 1700000000000.0 + 1000.0 * double((i * 37) % kRecords); }
+
+  bool Fill()
+  {
+    std::remove(kStorePath);
+    std::remove((std::string(kStorePath) + ".idx").c_str());
+    mesh::MessageStore store;
+    std::string error;
+    if (!store.Open(kStorePath, 16, error))
+    {
+      std::fprintf(stderr, "open: %s\n", error.c_str());
+      return false;
+    }
+    const uint8_t payload[8] = {};
+    for (size_t i = 0; i < kRecords; ++i)
+    {
+      if (store.Append(KeyOf(i), TimeOf(i), 0, mesh::StoredDirection::Received, 0, 1, payload, sizeof(payload),
+                       error) != 0)
+      {
+        std::fprintf(stderr, "append %zu: %s\n", i, error.c_str());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Rewind the index header one record and duplicate an entry of each array over the next
+  bool TearIndex()
+  {
+    std::FILE *file = std::fopen((std::string(kStorePath) + ".idx").c_str(), "r+b");
+    if (file == nullptr)
+      return false;
+    uint64_t header[2] = {};
+    bool ok = std::fseek(file, kIndexCountOffset, SEEK_SET) == 0 && std::fread(header, sizeof(header), 1, file) == 1;
+    header[0] = kRecords - 1;
+    ok = ok && std::fseek(file, kIndexCountOffset, SEEK_SET) == 0 &&
+         std::fwrite(header, sizeof(header[0]), 1, file) == 1;
+
+    uint8_t entry[kEntrySize];
+    const long arrays[] = {kIndexArraysOffset, kIndexArraysOffset + long(header[1]) * kEntrySize};
+    for (long array : arrays)
+    {
+      const long middle = array + long(kRecords / 2) * kEntrySize;
+      ok = ok && std::fseek(file, middle, SEEK_SET) == 0 && std::fread(entry, sizeof(entry), 1, file) == 1 &&
+           std::fseek(file, middle + kEntrySize, SEEK_SET) == 0 && std::fwrite(entry, sizeof(entry), 1, file) == 1;
+    }
+    return std::fclose(file) == 0 && ok;
+  }
+
+  bool CheckReopened()
+  {
+    mesh::MessageStore store;
+    std::string error;
+    if (!store.Open(kStorePath, 16, error))
+    {
+      std::fprintf(stderr, "reopen: %s\n", error.c_str());
+      return false;
+    }
+    if (store.Count() != kRecords)
+    {
+      std::fprintf(stderr, "%zu records after reopening, expected %zu\n", store.Count(), kRecords);
+      return false;
+    }
+
+    std::vector<uint32_t> matches;
+    for (size_t i = 0; i < kRecords; ++i)
+    {
+      store.Find(KeyOf(i), matches);
+      bool found = false;
+      for (uint32_t match : matches)
+        found = found || match == i;
+      if (!found)
+      {
+        std::fprintf(stderr, "record %zu not found by key\n", i);
+        return false;
+      }
+    }
+
+    size_t first, last;
+    store.TimeRange(0, 1e300, first, last);
+    if (first != 0 || last != kRecords)
+    {
+      std::fprintf(stderr, "time range [%zu, %zu), expected [0, %zu)\n", first, last, kRecords);
+      return false;
+    }
+    for (size_t i = 1; i < kRecords; ++i)
+    {
+      if (store.Record(store.ByTime(i - 1)).timestamp > store.Record(store.ByTime(i)).timestamp)
+      {
+        std::fprintf(stderr, "time order broken at %zu\n", i);
+        return false;
+      }
+    }
+    return true;
+  }
+} // namespace
+
+int main()
+{
+  size_t failures = 0;
+  failures += !(Fill() && CheckReopened());
+  failures += !(Fill() && TearIndex() && CheckReopened());
+
+  std::remove(kStorePath);
+  std::remove((std::string(kStorePath) + ".idx").c_str());
+  std::printf("message store: %zu failed reopens\n", failures);
+  return failures == 0 ? 0 : 1;
+}
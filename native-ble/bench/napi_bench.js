@@ -0,0 +1,131 @@
+#!/usr/bin/env node
+/*
+ * N-API microbenchmarks against the built addon
+ *
+ * Measures what the C++ suite (native_bench.cc) cannot: the cost of crossing
+ * between JS and the addon, event dispatch through BLEAdapter::EmitEvent, and
+ * loopback fan-out from one advertiser to N scanning adapters.
+ *
+ * Usage:
+ *   npm run build:native
+ *   node bench/napi_bench.js [--json]
+ */
+
+const path = require('path');
+
+const addon = require(path.join(__dirname, '..', 'build', 'Release', 'native_ble.node'));
+
+const MIN_TIME_NS = 200_000_000n;
+const asJson = process.argv.includes('--json');
+const results = [];
+
+// Run `fn(batch)` until MIN_TIME_NS has elapsed; `fn` reports how many ops it did
+async function measure(name, fn, batch = 1000) {
+  await fn(batch); // Warm up
+  let ops = 0;
+  const start = process.hrtime.bigint();
+  let elapsed = 0n;
+  while (elapsed < MIN_TIME_NS) {
+    ops += await fn(batch);
+    elapsed = process.hrtime.bigint() - start;
+  }
+  const nsPerOp = Number(elapsed) / ops;
+  results.push({ name, nsPerOp, opsPerSecond: 1e9 / nsPerOp });
+}
+
+function meshFragment(counter) {
+  const buf = Buffer.alloc(15 + 18, 0xab);
+  buf.writeUInt16LE(0xffff, 0);
+  buf.writeUInt32LE(counter >>> 0, 7);
+  buf.writeUInt16LE(((counter & 0x0fff) << 4) | 0, 12);
+  buf[14] = 0x81; // Hop 1, last fragment
+  return buf;
+}
+
+async function main() {
+  const adapter = new addon.BLEAdapter({ backend: 'loopback' });
+
+  // JS -> C++ -> JS with no work on either side
+  await measure('call: getState()', (n) => {
+    for (let i = 0; i < n; i++) adapter.getState();
+    return n;
+  });
+
+  // C++ -> JS listener call, the per-event cost of every adapter event
+  let received = 0;
+  adapter.on('advertisingDataUpdated', () => {
+    received++;
+  });
+  const payload = { address: 'AA:BB:CC:DD:EE:FF', rssi: -60 };
+  await measure('emit: 1 listener', (n) => {
+    for (let i = 0; i < n; i++) adapter.emit('advertisingDataUpdated', payload);
+    return n;
+  });
+
+  // Native reassembly of single-fragment messages from JS
+  if (addon.MeshAssembler) {
+    const assembler = new addon.MeshAssembler();
+    const fragments = Array.from({ length: 1024 }, (_, i) => meshFragment(i));
+    await measure('MeshAssembler.push', (n) => {
+      for (let i = 0; i < n; i++) assembler.push(fragments[i & 1023], 0);
+      return n;
+    });
+  }
+
+  // Bulk header decode, per record of a 1024-record batch
+  if (addon.decodeMeshHeaders) {
+    const records = Buffer.concat(Array.from({ length: 1024 }, (_, i) => meshFragment(i)));
+    await measure('decodeMeshHeaders: 1024 records, per record', (n) => {
+      const batches = Math.max(1, Math.ceil(n / 1024));
+      for (let i = 0; i < batches; i++) addon.decodeMeshHeaders(records, { companyId: 0xffff, dstId: 0 });
+      return batches * 1024;
+    });
+  }
+
+  // Loopback fan-out: one update reaches every scanner through EmitEvent
+  for (const scanners of [1, 8, 64]) {
+    const sender = new addon.BLEAdapter({ backend: 'loopback' });
+    const receivers = [];
+    let delivered = 0;
+    for (let i = 0; i < scanners; i++) {
+      const receiver = new addon.BLEAdapter({ backend: 'loopback' });
+      receiver.on('deviceDiscovered', () => {
+        delivered++;
+      });
+      await receiver.startScanning({ allowDuplicates: true });
+      receivers.push(receiver);
+    }
+    const data = meshFragment(0);
+    await sender.startAdvertising({ manufacturerData: data });
+
+    let counter = 0;
+    await measure(`fan-out: ${scanners} scanner(s), per delivered event`, async (n) => {
+      const before = delivered;
+      const pending = [];
+      for (let i = 0; i < n; i++) {
+        data.writeUInt32LE(++counter, 7);
+        pending.push(sender.updateAdvertisingData(data));
+      }
+      await Promise.all(pending);
+      return Math.max(1, delivered - before);
+    }, Math.max(16, Math.floor(1024 / scanners)));
+
+    await sender.destroy();
+    await Promise.all(receivers.map((receiver) => receiver.destroy()));
+  }
+
+  await adapter.destroy();
+
+  if (asJson) {
+    console.log(JSON.stringify({ received, results }, null, 2));
+    return;
+  }
+  for (const { name, nsPerOp, opsPerSecond } of results) {
+    console.log(`${name.padEnd(52)} ${nsPerOp.toFixed(1).padStart(10)} ns/op ${(opsPerSecond / 1e6).toFixed(2).padStart(8)} M/s`);
+  }
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
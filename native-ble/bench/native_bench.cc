@@ -0,0 +1,517 @@
+/**
+ * @file native_bench.cc
+ * @brief Google Benchmark suite for the addon's per-packet hot paths
+ *
+ * Each benchmark drives one engine the way the adapter does on the JS thread:
+ * one call per received report, with inputs prepared outside the timed loop.
+ * Items processed are reported, so the output reads as packets (or events)
+ * per second.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "adapter_stats.h"
+#include "dedup_cache.h"
+#include "event_queue.h"
+#include "link_quality.h"
+#include "mesh_header_batch.h"
+#include "mesh_packet.h"
+#include "message_codec.h"
+#include "message_store.h"
+#include "mesh_simulator.h"
+#include "peer_table.h"
+#include "relay_scheduler.h"
+#include "scan_filter.h"
+
+namespace
+{
+  using namespace ghostmesh;
+
+  // Manufacturer data for one GhostMesh fragment
+  std::vector<uint8_t> MeshFragment(uint64_t srcId, uint16_t messageId, uint8_t number, bool last, size_t dataLength)
+  {
+    std::vector<uint8_t> buf(mesh::kMeshHeaderSize + dataLength, 0xAB);
+    buf[0] = 0xFF;
+    buf[1] = 0xFF;
+    for (int i = 0; i < 5; ++i)
+    {
+      buf[2 + i] = static_cast<uint8_t>(0x10 + i);
+      buf[7 + i] = static_cast<uint8_t>(srcId >> (8 * i));
+    }
+    uint16_t raw = static_cast<uint16_t>(((messageId & 0x0FFF) << 4) | (number & 0x0F));
+    buf[12] = static_cast<uint8_t>(raw);
+    buf[13] = static_cast<uint8_t>(raw >> 8);
+    buf[14] = static_cast<uint8_t>(1 | (last ? mesh::kMeshLastFragmentFlag : 0));
+    return buf;
+  }
+
+  std::vector<std::string> Addresses(size_t count)
+  {
+    std::vector<std::string> out;
+    out.reserve(count);
+    char text[18];
+    for (size_t i = 0; i < count; ++i)
+    {
+      std::snprintf(text, sizeof(text), "AA:BB:CC:%02X:%02X:%02X", unsigned((i >> 16) & 0xFF),
+                    unsigned((i >> 8) & 0xFF), unsigned(i & 0xFF));
+      out.emplace_back(text);
+    }
+    return out;
+  }
+
+  // --- Packet parsing -------------------------------------------------------
+
+  void BM_DecodeMeshPacket(benchmark::State &state)
+  {
+    std::vector<uint8_t> buf = MeshFragment(0xAABBCCDDEEull, 0x123, 3, false, static_cast<size_t>(state.range(0)));
+    mesh::MeshPacket packet;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(mesh::DecodeMeshPacket(buf.data(), buf.size(), packet));
+      benchmark::DoNotOptimize(packet);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_DecodeMeshPacket)->Arg(mesh::kMeshDataSize)->Arg(mesh::kMeshMaxDataSize);
+
+  // A batch of 33-byte records back to back; every fourth is for us
+  std::vector<uint8_t> MeshRecords(size_t count)
+  {
+    std::vector<uint8_t> records;
+    for (size_t i = 0; i < count; ++i)
+    {
+      std::vector<uint8_t> buf = MeshFragment(0x4000 + i, static_cast<uint16_t>(i), 0, true, mesh::kMeshDataSize);
+      if (i % 4 != 0)
+        buf[2] = 0x00;
+      records.insert(records.end(), buf.begin(), buf.end());
+    }
+    return records;
+  }
+
+  struct HeaderColumns
+  {
+    explicit HeaderColumns(size_t count)
+        : companyId(count), messageId(count), dstId(count), srcId(count), packetNumber(count), hopCount(count),
+          match(count)
+    {
+    }
+
+    mesh::MeshHeaderColumns View()
+    {
+      return {companyId.data(), dstId.data(), srcId.data(), messageId.data(), packetNumber.data(), hopCount.data()};
+    }
+
+    std::vector<uint16_t> companyId, messageId;
+    std::vector<double> dstId, srcId;
+    std::vector<uint8_t> packetNumber, hopCount, match;
+  };
+
+  // One DecodeMeshPacket per record and a branch on company and destination, as before batch decoding
+  void BM_DecodeMeshHeadersPerPacket(benchmark::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> records = MeshRecords(count);
+    mesh::MeshPacket packet;
+    for (auto _ : state)
+    {
+      size_t matched = 0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        mesh::DecodeMeshPacket(records.data() + i * mesh::kMeshManufacturerSize, mesh::kMeshManufacturerSize, packet);
+        matched += packet.companyId == 0xFFFF && packet.dstId == 0x1413121110ull;
+      }
+      benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+  }
+  BENCHMARK(BM_DecodeMeshHeadersPerPacket)->Arg(64)->Arg(1024);
+
+  template <void (*Decode)(const uint8_t *, size_t, size_t, const mesh::MeshHeaderColumns &),
+            size_t (*Match)(const mesh::MeshHeaderColumns &, size_t, uint16_t, uint64_t, uint8_t *)>
+  void BM_DecodeMeshHeaders(benchmark::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> records = MeshRecords(count);
+    HeaderColumns columns(count);
+    mesh::MeshHeaderColumns view = columns.View();
+    for (auto _ : state)
+    {
+      Decode(records.data(), mesh::kMeshManufacturerSize, count, view);
+      benchmark::DoNotOptimize(Match(view, count, 0xFFFF, 0x1413121110ull, columns.match.data()));
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    state.SetLabel(Decode == mesh::DecodeMeshHeaders ? mesh::kMeshHeaderKernel : "scalar");
+  }
+  BENCHMARK_TEMPLATE(BM_DecodeMeshHeaders, mesh::DecodeMeshHeaders, mesh::MatchMeshHeaders)->Arg(64)->Arg(1024);
+  BENCHMARK_TEMPLATE(BM_DecodeMeshHeaders, mesh::DecodeMeshHeadersScalar, mesh::MatchMeshHeadersScalar)
+      ->Arg(64)
+      ->Arg(1024);
+
+  void BM_ScanFilterMatches(benchmark::State &state)
+  {
+    ble::ScanFilter filter;
+    filter.Configure(0xFFFF, {"1234", "0000180f-0000-1000-8000-00805f9b34fb"});
+    std::vector<uint8_t> data = MeshFragment(1, 1, 0, true, mesh::kMeshDataSize);
+    std::vector<std::string> uuids = {"180f"};
+    for (auto _ : state)
+      benchmark::DoNotOptimize(filter.Matches(data.data(), data.size(), uuids));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_ScanFilterMatches);
+
+  // --- Reassembly -----------------------------------------------------------
+
+  // Whole messages of range(0) fragments, one message after another
+  void BM_ReassembleSequential(benchmark::State &state)
+  {
+    const size_t fragments = static_cast<size_t>(state.range(0));
+    const size_t messages = 64;
+    std::vector<std::vector<uint8_t>> bufs;
+    for (size_t m = 0; m < messages; ++m)
+      for (size_t i = 0; i < fragments; ++i)
+        bufs.push_back(MeshFragment(0x1000 + m, static_cast<uint16_t>(m), static_cast<uint8_t>(i), i + 1 == fragments,
+                                    mesh::kMeshDataSize));
+    std::vector<mesh::MeshPacket> packets(bufs.size());
+    for (size_t i = 0; i < bufs.size(); ++i)
+      mesh::DecodeMeshPacket(bufs[i].data(), bufs[i].size(), packets[i]);
+
+    mesh::MessageAssembler assembler(256, mesh::kMeshDataSize);
+    uint64_t nowMs = 0;
+    for (auto _ : state)
+    {
+      for (const mesh::MeshPacket &packet : packets)
+        benchmark::DoNotOptimize(assembler.Push(packet, nowMs));
+      ++nowMs;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(packets.size()));
+  }
+  BENCHMARK(BM_ReassembleSequential)->Arg(1)->Arg(4)->Arg(16);
+
+  // range(0) messages in flight, their fragments interleaved round-robin
+  void BM_ReassembleInterleaved(benchmark::State &state)
+  {
+    const size_t inFlight = static_cast<size_t>(state.range(0));
+    const size_t fragments = 4;
+    std::vector<std::vector<uint8_t>> bufs;
+    for (size_t i = 0; i < fragments; ++i)
+      for (size_t m = 0; m < inFlight; ++m)
+        bufs.push_back(MeshFragment(0x2000 + m, static_cast<uint16_t>(m), static_cast<uint8_t>(i), i + 1 == fragments,
+                                    mesh::kMeshDataSize));
+    std::vector<mesh::MeshPacket> packets(bufs.size());
+    for (size_t i = 0; i < bufs.size(); ++i)
+      mesh::DecodeMeshPacket(bufs[i].data(), bufs[i].size(), packets[i]);
+
+    mesh::MessageAssembler assembler(inFlight, mesh::kMeshDataSize);
+    uint64_t nowMs = 0;
+    for (auto _ : state)
+    {
+      for (const mesh::MeshPacket &packet : packets)
+        benchmark::DoNotOptimize(assembler.Push(packet, nowMs));
+      ++nowMs;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(packets.size()));
+  }
+  BENCHMARK(BM_ReassembleInterleaved)->Arg(16)->Arg(256)->Arg(4096);
+
+  // Lossy channel: most messages never complete, so every push evicts
+  void BM_ReassembleEvicting(benchmark::State &state)
+  {
+    std::vector<uint8_t> buf = MeshFragment(0x3000, 0, 0, false, mesh::kMeshDataSize);
+    mesh::MeshPacket packet;
+    mesh::DecodeMeshPacket(buf.data(), buf.size(), packet);
+    mesh::MessageAssembler assembler(256, mesh::kMeshDataSize);
+    uint64_t n = 0;
+    for (auto _ : state)
+    {
+      packet.srcId = 0x3000 + (n >> 12);
+      packet.messageId = static_cast<uint16_t>(n & 0x0FFF);
+      benchmark::DoNotOptimize(assembler.Push(packet, 0));
+      ++n;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_ReassembleEvicting);
+
+  // --- Dedup cache ----------------------------------------------------------
+
+  void BM_DedupInsert(benchmark::State &state)
+  {
+    ble::TimeBucketedSet set(3600000, 8192);
+    uint64_t key = 0;
+    for (auto _ : state)
+    {
+      ++key;
+      benchmark::DoNotOptimize(set.CheckAndInsert(ble::HashBytes64(&key, sizeof(key)), key >> 4));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_DedupInsert);
+
+  void BM_DedupLookupHit(benchmark::State &state)
+  {
+    ble::TimeBucketedSet set(3600000, 8192);
+    std::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < 4096; ++i)
+    {
+      keys.push_back(ble::HashBytes64(&i, sizeof(i)));
+      set.CheckAndInsert(keys.back(), 0);
+    }
+    size_t i = 0;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(set.Contains(keys[i], 0));
+      i = (i + 1) & (keys.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_DedupLookupHit);
+
+  void BM_DuplicateFilter(benchmark::State &state)
+  {
+    ble::DuplicateFilter filter;
+    filter.Configure(false, 1000);
+    std::vector<std::string> addresses = Addresses(static_cast<size_t>(state.range(0)));
+    std::vector<uint8_t> data = MeshFragment(1, 1, 0, true, mesh::kMeshDataSize);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(filter.IsDuplicate(addresses[i], data.data(), data.size()));
+      if (++i == addresses.size())
+        i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_DuplicateFilter)->Arg(16)->Arg(1024);
+
+  // --- Per-peer state -------------------------------------------------------
+
+  void BM_LinkQualityRecord(benchmark::State &state)
+  {
+    ble::LinkQualityTable table(256);
+    table.SetEnabled(true);
+    const uint32_t peers = static_cast<uint32_t>(state.range(0));
+    uint64_t n = 0;
+    for (auto _ : state)
+    {
+      table.Record(static_cast<uint32_t>(n % peers) * 0x9E3779B1u, static_cast<int16_t>(-40 - (n & 31)), n >> 4);
+      ++n;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_LinkQualityRecord)->Arg(16)->Arg(256);
+
+  void BM_PeerTableTouch(benchmark::State &state)
+  {
+    ble::PeerTable table(30000, 100, 1024);
+    std::vector<std::string> addresses = Addresses(static_cast<size_t>(state.range(0)));
+    std::vector<ble::Peer> lost;
+    uint64_t nowMs = 0;
+    size_t i = 0;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(table.Touch(addresses[i], -60, nowMs, lost));
+      if (++i == addresses.size())
+      {
+        i = 0;
+        table.Advance(++nowMs, lost);
+        lost.clear();
+      }
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_PeerTableTouch)->Arg(16)->Arg(1024)->Arg(4096);
+
+  // --- Message codec --------------------------------------------------------
+
+  mesh::CodecMessage SampleMessage()
+  {
+    mesh::CodecMessage message;
+    message.to = "+15551234567";
+    message.from = "+15557654321";
+    message.content = "Meet at the north gate GPS: 37.774900, -122.419400 bring water";
+    message.id = "1700000000123-k3j9x0a2b";
+    message.timestamp = 1700000000123.0;
+    message.hops = 3;
+    return message;
+  }
+
+  void BM_EncodeMessage(benchmark::State &state)
+  {
+    mesh::CodecMessage message = SampleMessage();
+    std::vector<uint8_t> out(mesh::MessageEncodedBound(message));
+    for (auto _ : state)
+      benchmark::DoNotOptimize(mesh::EncodeMessage(message, out.data(), out.size()));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_EncodeMessage);
+
+  void BM_DecodeMessage(benchmark::State &state)
+  {
+    mesh::CodecMessage message = SampleMessage();
+    std::vector<uint8_t> frame(mesh::MessageEncodedBound(message));
+    frame.resize(mesh::EncodeMessage(message, frame.data(), frame.size()));
+    mesh::CodecMessage decoded;
+    for (auto _ : state)
+      benchmark::DoNotOptimize(mesh::DecodeMessage(frame.data(), frame.size(), decoded));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_DecodeMessage);
+
+  // --- Message history --------------------------------------------------------
+
+  const char *const kBenchStorePath = "/tmp/ghostmesh_bench.gmlog";
+
+  // A fresh store holding `count` messages from 64 senders, one per second
+  void FillStore(mesh::MessageStore &store, size_t count)
+  {
+    std::remove(kBenchStorePath);
+    std::remove((std::string(kBenchStorePath) + ".idx").c_str());
+    std::string error;
+    store.Open(kBenchStorePath, count, error);
+    uint8_t payload[96] = {};
+    for (size_t i = 0; i < count; ++i)
+      store.Append(mesh::MessageKey(i % 64, uint16_t(i / 64)), 1700000000000.0 + 1000.0 * double(i), 0,
+                   mesh::StoredDirection::Received, 0, 1, payload, sizeof(payload), error);
+  }
+
+  // Live traffic: timestamps arrive in order, keys do not
+  void BM_MessageStoreAppend(benchmark::State &state)
+  {
+    mesh::MessageStore store;
+    FillStore(store, size_t(state.range(0)));
+    uint8_t payload[96] = {};
+    std::string error;
+    uint64_t i = 0;
+    for (auto _ : state)
+    {
+      ++i;
+      benchmark::DoNotOptimize(store.Append(mesh::MessageKey(i * 2654435761u, uint16_t(i)), 1800000000000.0 + i, 0,
+                                            mesh::StoredDirection::Sent, 0, 0, payload, sizeof(payload), error));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_MessageStoreAppend)->Arg(1024)->Arg(65536)->Iterations(10000);
+
+  // Warm start: map both files and check the headers, whatever the history size
+  void BM_MessageStoreOpen(benchmark::State &state)
+  {
+    {
+      mesh::MessageStore store;
+      FillStore(store, size_t(state.range(0)));
+    }
+    mesh::MessageStore store;
+    std::string error;
+    for (auto _ : state)
+      benchmark::DoNotOptimize(store.Open(kBenchStorePath, 0, error));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_MessageStoreOpen)->Arg(1024)->Arg(65536);
+
+  // The chat view: the last 50 messages of one hour out of the whole history
+  void BM_MessageStoreRange(benchmark::State &state)
+  {
+    mesh::MessageStore store;
+    FillStore(store, size_t(state.range(0)));
+    const double to = 1700000000000.0 + 1000.0 * double(state.range(0));
+    for (auto _ : state)
+    {
+      size_t first, last;
+      store.TimeRange(to - 3600000.0, to, first, last);
+      uint64_t keys = 0;
+      for (size_t i = std::max(first, last - std::min<size_t>(last, 50)); i < last; ++i)
+        keys += store.Record(store.ByTime(i)).key;
+      benchmark::DoNotOptimize(keys);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_MessageStoreRange)->Arg(1024)->Arg(65536);
+
+  // --- Relay decisions ------------------------------------------------------
+
+  // One message's life: first copy, two overheard duplicates, timer fires
+  void BM_RelayCycle(benchmark::State &state)
+  {
+    mesh::RelayConfig config;
+    config.seed = 1;
+    mesh::RelayScheduler scheduler(config);
+    uint64_t key = 0;
+    for (auto _ : state)
+    {
+      ++key;
+      benchmark::DoNotOptimize(scheduler.Schedule(key, -70, key));
+      benchmark::DoNotOptimize(scheduler.Overheard(key));
+      benchmark::DoNotOptimize(scheduler.Overheard(key));
+      benchmark::DoNotOptimize(scheduler.Release(key));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_RelayCycle);
+
+  // Whole-network run: decoder, reassembler, dedup and relay engines under
+  // the simulator's radio model; items are simulated events
+  void BM_SimulateMesh(benchmark::State &state)
+  {
+    mesh::SimConfig config;
+    config.nodeCount = static_cast<uint32_t>(state.range(0));
+    config.areaWidthM = config.areaHeightM = 10.0 * std::sqrt(double(config.nodeCount));
+    config.messageCount = 5;
+    mesh::SimReport report = mesh::SimReport();
+    for (auto _ : state)
+      report = mesh::SimulateMesh(config);
+    state.SetItemsProcessed(state.iterations() * int64_t(report.events));
+    state.counters["deliveryRatio"] = report.deliveryRatio;
+    state.counters["simulatedMs"] = report.simulatedMs;
+  }
+  BENCHMARK(BM_SimulateMesh)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+  // --- Platform thread -> JS thread handoff ---------------------------------
+
+  void BM_EventQueueRoundTrip(benchmark::State &state)
+  {
+    static ble::MpscQueue<uint64_t, 1024> queue;
+    const int64_t batch = state.range(0);
+    uint64_t value = 0;
+    for (auto _ : state)
+    {
+      for (int64_t i = 0; i < batch; ++i)
+        queue.TryPush(uint64_t(i));
+      for (int64_t i = 0; i < batch; ++i)
+        queue.TryPop(value);
+      benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+  }
+  BENCHMARK(BM_EventQueueRoundTrip)->Arg(1)->Arg(64);
+
+  // --- Stats on every path above ----------------------------------------------
+
+  // One thread per hot path, each on its own counter line, as the adapter runs them
+  void BM_StatsAdd(benchmark::State &state)
+  {
+    static ble::AdapterStats stats;
+    const ble::StatCounter counter = state.thread_index() == 0 ? ble::StatCounter::AdvertisementsReceived
+                                                               : ble::StatCounter::EventsEmitted;
+    for (auto _ : state)
+      stats.Add(counter);
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_StatsAdd)->Threads(1)->Threads(2);
+
+  void BM_StatsRecord(benchmark::State &state)
+  {
+    static ble::AdapterStats stats;
+    uint64_t micros = 0;
+    for (auto _ : state)
+      stats.Record(ble::StatHistogram::DispatchUs, (micros++ * 37) & 0xFFFF);
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_StatsRecord);
+
+} // namespace
@@ -4,7 +4,42 @@
       "target_name": "native_ble",
       "sources": [
         "cpp/ble_adapter.cc",
-        "cpp/hello.cc"
+        "cpp/ble_adapter_registry.cc",
+        "cpp/adapter_events.cc",
+        "cpp/adapter_stats.cc",
+        "cpp/platform_event_dispatcher.cc",
+        "cpp/platform_operation.cc",
+        "cpp/discovery_batch.cc",
+        "cpp/discovery_ring.cc",
+        "cpp/mesh_packet.cc",
+        "cpp/mesh_header_batch.cc",
+        "cpp/mesh_header_batch_wrap.cc",
+        "cpp/mesh_assembler_wrap.cc",
+        "cpp/dedup_cache.cc",
+        "cpp/scan_filter.cc",
+        "cpp/loopback_medium.cc",
+        "cpp/advertising_buffer.cc",
+        "cpp/advertising_scheduler.cc",
+        "cpp/scan_duty_cycle.cc",
+        "cpp/coexistence_arbiter.cc",
+        "cpp/message_id_set_wrap.cc",
+        "cpp/trace_ring.cc",
+        "cpp/hello.cc",
+        "cpp/ble_adapter_platform.cc",
+        "cpp/link_quality.cc",
+        "cpp/peer_table.cc",
+        "cpp/peer_monitor.cc",
+        "cpp/message_codec.cc",
+        "cpp/message_codec_wrap.cc",
+        "cpp/message_store.cc",
+        "cpp/message_store_wrap.cc",
+        "cpp/relay_scheduler.cc",
+        "cpp/relay_scheduler_wrap.cc",
+        "cpp/seen_digest.cc",
+        "cpp/seen_digest_wrap.cc",
+        "cpp/mesh_simulator.cc",
+        "cpp/mesh_simulator_wrap.cc",
+        "binding/platform/ble_platform_factory.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")"
@@ -13,11 +48,38 @@
         "<!(node -p \"require('node-addon-api').gyp\")"
       ],
       "defines": [
-        "NAPI_DISABLE_CPP_EXCEPTIONS"
+        "NAPI_VERSION=8",
+        "NAPI_DISABLE_CPP_EXCEPTIONS",
+        "GHOSTMESH_TRACE_LEVEL=2"
       ],
       "cflags!": [ "-fno-exceptions" ],
       "cflags_cc!": [ "-fno-exceptions" ],
-      "cflags_cc": [ "-std=c++17" ]
+      "cflags_cc": [ "-std=c++17" ],
+      "conditions": [
+        ["OS=='linux'", {
+          "sources": [
+            "binding/platform/linux/ble_platform_linux.cpp",
+            "binding/platform/linux/hci_advertising.cpp"
+          ],
+          "defines": [ "GHOSTMESH_BACKEND_BLUEZ_HCI" ]
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+            "CLANG_CXX_LIBRARY": "libc++",
+            "MACOSX_DEPLOYMENT_TARGET": "10.15"
+          }
+        }],
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1,
+              "AdditionalOptions": [ "/std:c++17" ]
+            }
+          }
+        }]
+      ]
     }
   ]
 }
@@ -3,7 +3,9 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <cstdint>
+#include <cstring>
 
 namespace ghostmesh
 {
@@ -40,6 +42,44 @@ namespace ghostmesh
           : intervalMs(100), txPowerLevel(0) {}
     };
 
+    /**
+     * Legacy advertising payload limit in bytes
+     */
+    constexpr size_t kLegacyAdvertisingDataMax = 31;
+
+    /**
+     * Extended (BLE 5) advertising payload limit per set, in bytes
+     * The most one LE Set Extended Advertising Data command carries.
+     */
+    constexpr size_t kExtendedAdvertisingDataMax = 251;
+
+    /**
+     * Advertising payload stored inline (no heap allocation)
+     * Sized for a legacy advertising PDU; Assign() rejects anything longer.
+     */
+    struct AdvertisingData
+    {
+      uint8_t bytes[kLegacyAdvertisingDataMax]; // Manufacturer data (company ID + payload)
+      uint8_t length;                           // Valid bytes
+
+      AdvertisingData() : length(0) {}
+
+      // Copy in a payload; returns false (and leaves the data unchanged) if it does not fit
+      bool Assign(const uint8_t *data, size_t size)
+      {
+        if (size > kLegacyAdvertisingDataMax)
+          return false;
+        if (size > 0)
+          std::memcpy(bytes, data, size);
+        length = static_cast<uint8_t>(size);
+        return true;
+      }
+
+      const uint8_t *data() const { return bytes; }
+      size_t size() const { return length; }
+      bool empty() const { return length == 0; }
+    };
+
     /**
      * Scan options
      */
@@ -49,10 +89,12 @@ namespace ghostmesh
       std::vector<std::string> filterByService; // Filter by service UUIDs
       bool allowDuplicates;                     // Allow duplicate reports
       uint32_t duplicateTimeoutMs;              // Duplicate filter timeout in ms
+      uint32_t windowMs;                        // Controller scan window (0 = continuous)
+      uint32_t intervalMs;                      // Controller scan interval; window <= interval
 
       // Constructor with defaults
       ScanOptions()
-          : filterByManufacturer(0), allowDuplicates(false), duplicateTimeoutMs(1000) {}
+          : filterByManufacturer(0), allowDuplicates(false), duplicateTimeoutMs(1000), windowMs(0), intervalMs(0) {}
     };
 
     /**
@@ -100,6 +142,10 @@ namespace ghostmesh
 
     /**
      * Platform callback types
+     *
+     * State and discovery callbacks may fire on any platform thread. The N-API
+     * binding (BLEAdapter) never touches JS from them; it queues the event and
+     * delivers it in batches through PlatformEventDispatcher.
      */
     using StateChangeCallback = std::function<void(BLEState state)>;
     using DeviceDiscoveredCallback = std::function<void(const DiscoveredDevice &device)>;
@@ -112,7 +158,7 @@ namespace ghostmesh
      * This interface abstracts the platform-specific BLE implementations:
      * - macOS: CoreBluetooth (Objective-C++)
      * - Windows: Windows.Devices.Bluetooth (WinRT C++)
-     * - Linux: BlueZ D-Bus API
+     * - Linux: BlueZ kernel HCI socket (see linux/ble_platform_linux.h)
      */
     class IBLEPlatform
     {
@@ -142,7 +188,9 @@ namespace ghostmesh
 
       /**
        * Set callback for adapter state changes
-       * Callback will be invoked from platform-specific thread
+       * Callback will be invoked from platform-specific thread. Once this
+       * returns the previous callback is neither running nor called again,
+       * so passing nullptr detaches it.
        *
        * @param callback Function to call when state changes
        */
@@ -150,6 +198,7 @@ namespace ghostmesh
 
       /**
        * Set callback for errors
+       * Replaced with the same guarantee as SetStateChangeCallback()
        *
        * @param callback Function to call when errors occur
        */
@@ -169,11 +218,12 @@ namespace ghostmesh
        * Update advertising data without stopping
        * Should update manufacturer data in-place if possible
        *
-       * @param data New manufacturer data (company ID + payload)
+       * @param data New manufacturer data (company ID + payload), held inline
+       *             so rotating payloads never allocates
        * @param callback Success/failure callback
        * @throws BLEError if update fails
        */
-      virtual void UpdateAdvertisingData(const std::vector<uint8_t> &data,
+      virtual void UpdateAdvertisingData(const AdvertisingData &data,
                                          SuccessCallback callback) = 0;
 
       /**
@@ -190,6 +240,55 @@ namespace ghostmesh
        */
       virtual bool IsAdvertising() const = 0;
 
+      /**
+       * Start an additional extended advertising set
+       *
+       * Runs alongside the legacy advertisement started by StartAdvertising().
+       * Only available when Capabilities::supportsMultipleAdvSets is set; the
+       * default implementation throws ADVERTISING_UNSUPPORTED.
+       *
+       * @param options Set configuration; manufacturerData may be up to
+       *                Capabilities::maxAdvertisingDataSize bytes
+       * @param callback Success/failure callback
+       * @return Set handle for UpdateAdvertisingSet() / StopAdvertisingSet()
+       * @throws BLEError if the set cannot be started
+       */
+      virtual uint8_t StartAdvertisingSet(const AdvertisingOptions &options, SuccessCallback callback)
+      {
+        (void)options;
+        (void)callback;
+        throw BLEError(BLEError::Code::ADVERTISING_UNSUPPORTED, "Advertising sets are not supported");
+      }
+
+      /**
+       * Replace the manufacturer data of an advertising set
+       *
+       * @param handle Handle returned by StartAdvertisingSet()
+       * @param data New manufacturer data (company ID + payload)
+       * @param callback Success/failure callback
+       * @throws BLEError if the update fails
+       */
+      virtual void UpdateAdvertisingSet(uint8_t handle, const std::vector<uint8_t> &data, SuccessCallback callback)
+      {
+        (void)handle;
+        (void)data;
+        (void)callback;
+        throw BLEError(BLEError::Code::ADVERTISING_UNSUPPORTED, "Advertising sets are not supported");
+      }
+
+      /**
+       * Stop and remove an advertising set
+       *
+       * @param handle Handle returned by StartAdvertisingSet()
+       * @param callback Success/failure callback
+       */
+      virtual void StopAdvertisingSet(uint8_t handle, SuccessCallback callback)
+      {
+        (void)handle;
+        (void)callback;
+        throw BLEError(BLEError::Code::ADVERTISING_UNSUPPORTED, "Advertising sets are not supported");
+      }
+
       /**
        * Start BLE scanning
        *
@@ -202,7 +301,8 @@ namespace ghostmesh
 
       /**
        * Set callback for discovered devices
-       * Callback will be invoked from platform-specific thread
+       * Callback will be invoked from platform-specific thread; replaced with
+       * the same guarantee as SetStateChangeCallback()
        *
        * @param callback Function to call when devices are discovered
        */
@@ -236,9 +336,10 @@ namespace ghostmesh
       struct Capabilities
       {
         bool supportsExtendedAdvertising; // BLE 5.0 Extended Advertising
-        uint16_t maxAdvertisingDataSize;  // Maximum advertising payload size
+        uint16_t maxAdvertisingDataSize;  // Maximum manufacturer data size (up to kExtendedAdvertisingDataMax)
         bool supportsSimultaneousAdvScan; // Can advertise and scan at same time
         bool supportsMultipleAdvSets;     // Multiple advertising sets (BLE 5.0)
+        bool supportsScanDutyCycle;       // Honors ScanOptions::windowMs / intervalMs in the controller
       };
 
       virtual Capabilities GetCapabilities() const = 0;
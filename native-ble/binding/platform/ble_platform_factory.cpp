@@ -1,6 +1,16 @@
 #include "ble_platform.h"
 #include <stdexcept>
 
+// Platform headers pull in system headers, so they must be included at file scope.
+// binding.gyp defines GHOSTMESH_BACKEND_* for the OS whose backend it compiles.
+#if defined(GHOSTMESH_BACKEND_COREBLUETOOTH)
+#include "macos/ble_platform_macos.h"
+#elif defined(GHOSTMESH_BACKEND_WINRT)
+#include "windows/ble_platform_windows.h"
+#elif defined(GHOSTMESH_BACKEND_BLUEZ_HCI)
+#include "linux/ble_platform_linux.h"
+#endif
+
 namespace ghostmesh
 {
   namespace ble
@@ -8,43 +18,37 @@ namespace ghostmesh
 
     /**
      * Platform factory implementation
-     * Conditionally compiles the appropriate platform based on OS macros
+     * Conditionally compiles the backend selected by the build
      */
 
-#ifdef __APPLE__
-// macOS - Use CoreBluetooth
-#include "macos/ble_platform_macos.h"
-
+#if defined(GHOSTMESH_BACKEND_COREBLUETOOTH)
+    // macOS - Use CoreBluetooth
     std::unique_ptr<IBLEPlatform> CreateBLEPlatform()
     {
       return std::make_unique<BLEPlatformMacOS>();
     }
 
-#elif _WIN32
-// Windows - Use WinRT Bluetooth APIs
-#include "windows/ble_platform_windows.h"
-
+#elif defined(GHOSTMESH_BACKEND_WINRT)
+    // Windows - Use WinRT Bluetooth APIs
     std::unique_ptr<IBLEPlatform> CreateBLEPlatform()
     {
       return std::make_unique<BLEPlatformWindows>();
     }
 
-#elif __linux__
-// Linux - Use BlueZ D-Bus API
-#include "linux/ble_platform_linux.h"
-
+#elif defined(GHOSTMESH_BACKEND_BLUEZ_HCI)
+    // Linux - Raw HCI socket (BlueZ kernel stack, no D-Bus)
     std::unique_ptr<IBLEPlatform> CreateBLEPlatform()
     {
       return std::make_unique<BLEPlatformLinux>();
     }
 
 #else
-    // Unsupported platform
+    // No backend compiled for this OS; BLEAdapter falls back to its loopback radio
     std::unique_ptr<IBLEPlatform> CreateBLEPlatform()
     {
       throw BLEError(
           BLEError::Code::PLATFORM_ERROR,
-          "Platform not supported. Only macOS, Windows, and Linux are supported.",
+          "No native BLE backend in this build. Only Linux (BlueZ HCI) is available so far.",
           "UNSUPPORTED_PLATFORM");
     }
 
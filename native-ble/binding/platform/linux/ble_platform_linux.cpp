@@ -0,0 +1,549 @@
+#include "ble_platform_linux.h"
+#include "hci_advertising.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      /**
+       * Kernel HCI socket ABI (include/net/bluetooth/hci_sock.h), declared
+       * here so the addon builds without libbluetooth-dev
+       */
+      constexpr int kBtProtoHci = 1;
+      constexpr int kSolHci = 0;
+      constexpr int kHciFilter = 2;
+      constexpr unsigned short kHciChannelRaw = 0;
+      constexpr unsigned long kHciGetDevInfo = _IOR('H', 211, int);
+      constexpr uint32_t kHciUpFlag = 1u << 0;
+
+      struct SockaddrHci
+      {
+        sa_family_t family;
+        unsigned short device;
+        unsigned short channel;
+      };
+
+      struct HciFilter
+      {
+        uint32_t typeMask;
+        uint32_t eventMask[2];
+        uint16_t opcode;
+      };
+
+      struct HciDevInfo
+      {
+        uint16_t deviceId;
+        char name[8];
+        uint8_t address[6];
+        uint32_t flags;
+        uint8_t type;
+        uint8_t features[8];
+        uint32_t packetType;
+        uint32_t linkPolicy;
+        uint32_t linkMode;
+        uint16_t aclMtu;
+        uint16_t aclPackets;
+        uint16_t scoMtu;
+        uint16_t scoPackets;
+        uint32_t stats[10];
+      };
+
+      // HCI packet indicators and events (Core Spec Vol 4 Part E)
+      constexpr uint8_t kCommandPacket = 0x01;
+      constexpr uint8_t kEventPacket = 0x04;
+      constexpr uint8_t kEventCommandComplete = 0x0E;
+      constexpr uint8_t kEventCommandStatus = 0x0F;
+      constexpr uint8_t kEventLeMeta = 0x3E;
+      constexpr uint8_t kLeAdvertisingReport = 0x02;
+
+      // LE controller commands (OGF 0x08)
+      constexpr uint16_t kSetAdvertisingParameters = 0x2006;
+      constexpr uint16_t kSetAdvertisingData = 0x2008;
+      constexpr uint16_t kSetAdvertiseEnable = 0x200A;
+      constexpr uint16_t kSetScanParameters = 0x200B;
+      constexpr uint16_t kSetScanEnable = 0x200C;
+
+      constexpr uint8_t kStatusCommandDisallowed = 0x0C;
+      constexpr uint8_t kAdvNonConnectable = 0x03;
+
+      constexpr size_t kMaxEventSize = 2 + 255 + 1; ///< Indicator, header, parameters
+
+      void SetFilterBit(uint32_t *mask, int bit)
+      {
+        mask[bit >> 5] |= 1u << (bit & 31);
+      }
+
+      uint16_t IntervalUnits(uint32_t intervalMs)
+      {
+        // 0.625 ms units; legacy controllers reject non-connectable intervals below 100 ms
+        uint32_t units = intervalMs * 8 / 5;
+        return static_cast<uint16_t>(std::min<uint32_t>(std::max<uint32_t>(units, 0x00A0), 0x4000));
+      }
+
+      uint16_t ScanUnits(uint32_t ms)
+      {
+        // 0.625 ms units, 2.5 ms to 10.24 s
+        uint32_t units = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(ms) * 8 / 5, 0x4000));
+        return static_cast<uint16_t>(std::max<uint32_t>(units, 0x0004));
+      }
+
+      uint64_t NowMs()
+      {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+      }
+    } // namespace
+
+    BLEPlatformLinux::BLEPlatformLinux(uint16_t deviceId)
+        : deviceId_(deviceId), hciFd_(-1), epollFd_(-1), wakeFd_(-1), timerFd_(-1), state_(BLEState::UNKNOWN),
+          advertising_(false), scanning_(false)
+    {
+      device_.address.reserve(17);
+    }
+
+    BLEPlatformLinux::~BLEPlatformLinux()
+    {
+      Shutdown();
+    }
+
+    void BLEPlatformLinux::Initialize()
+    {
+      if (hciFd_ >= 0)
+        return;
+
+      hciFd_ = socket(AF_BLUETOOTH, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, kBtProtoHci);
+      if (hciFd_ < 0)
+      {
+        int error = errno;
+        if (error == EPERM || error == EACCES)
+        {
+          SetState(BLEState::UNAUTHORIZED);
+          throw BLEError(BLEError::Code::ADAPTER_UNAUTHORIZED, "Raw HCI access requires CAP_NET_RAW",
+                         std::strerror(error));
+        }
+        SetState(BLEState::UNSUPPORTED);
+        throw BLEError(BLEError::Code::ADAPTER_UNAVAILABLE, "Bluetooth sockets are not available", std::strerror(error));
+      }
+
+      SockaddrHci address = {};
+      address.family = AF_BLUETOOTH;
+      address.device = deviceId_;
+      address.channel = kHciChannelRaw;
+      HciFilter filter = {};
+      filter.typeMask = 1u << kEventPacket;
+      SetFilterBit(filter.eventMask, kEventCommandComplete);
+      SetFilterBit(filter.eventMask, kEventCommandStatus);
+      SetFilterBit(filter.eventMask, kEventLeMeta);
+      if (bind(hciFd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+          setsockopt(hciFd_, kSolHci, kHciFilter, &filter, sizeof(filter)) < 0)
+      {
+        int error = errno;
+        CloseDescriptors();
+        SetState(BLEState::UNSUPPORTED);
+        throw BLEError(BLEError::Code::ADAPTER_UNAVAILABLE, "Cannot open HCI device " + std::to_string(deviceId_),
+                       std::strerror(error));
+      }
+
+      wakeFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+      timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+      epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+      if (wakeFd_ < 0 || timerFd_ < 0 || epollFd_ < 0)
+      {
+        int error = errno;
+        CloseDescriptors();
+        throw BLEError(BLEError::Code::PLATFORM_ERROR, "Cannot create event loop descriptors", std::strerror(error));
+      }
+
+      // bluetoothd can power the adapter up or down at any time; poll once a second
+      itimerspec period = {};
+      period.it_interval.tv_sec = 1;
+      period.it_value.tv_sec = 1;
+      timerfd_settime(timerFd_, 0, &period, nullptr);
+
+      for (int fd : {hciFd_, wakeFd_, timerFd_})
+      {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event);
+      }
+
+      PollState();
+      thread_ = std::thread(&BLEPlatformLinux::RunLoop, this);
+    }
+
+    void BLEPlatformLinux::Shutdown()
+    {
+      if (hciFd_ < 0)
+        return;
+
+      // Best effort: leave the controller idle for bluetoothd
+      try
+      {
+        StopScanning(nullptr);
+      }
+      catch (const BLEError &)
+      {
+      }
+      try
+      {
+        StopAdvertising(nullptr);
+      }
+      catch (const BLEError &)
+      {
+      }
+
+      if (thread_.joinable())
+      {
+        uint64_t one = 1;
+        (void)write(wakeFd_, &one, sizeof(one));
+        thread_.join();
+      }
+      CloseDescriptors();
+    }
+
+    void BLEPlatformLinux::CloseDescriptors()
+    {
+      for (int *fd : {&hciFd_, &epollFd_, &wakeFd_, &timerFd_})
+      {
+        if (*fd >= 0)
+        {
+          close(*fd);
+          *fd = -1;
+        }
+      }
+    }
+
+    BLEState BLEPlatformLinux::GetState() const
+    {
+      return state_.load(std::memory_order_acquire);
+    }
+
+    void BLEPlatformLinux::SetStateChangeCallback(StateChangeCallback callback)
+    {
+      std::lock_guard<std::mutex> lock(callbackMutex_);
+      stateCallback_ = std::move(callback);
+    }
+
+    void BLEPlatformLinux::SetErrorCallback(ErrorCallback callback)
+    {
+      std::lock_guard<std::mutex> lock(callbackMutex_);
+      errorCallback_ = std::move(callback);
+    }
+
+    void BLEPlatformLinux::SetDeviceDiscoveredCallback(DeviceDiscoveredCallback callback)
+    {
+      std::lock_guard<std::mutex> lock(callbackMutex_);
+      discoveredCallback_ = std::move(callback);
+    }
+
+    void BLEPlatformLinux::SendCommand(uint16_t opcode, const uint8_t *params, uint8_t length, BLEError::Code failure)
+    {
+      if (hciFd_ < 0)
+        throw BLEError(BLEError::Code::ADAPTER_UNAVAILABLE, "HCI device is not initialized");
+
+      uint8_t packet[4 + 255];
+      packet[0] = kCommandPacket;
+      packet[1] = static_cast<uint8_t>(opcode & 0xFF);
+      packet[2] = static_cast<uint8_t>(opcode >> 8);
+      packet[3] = length;
+      if (length > 0)
+        std::memcpy(packet + 4, params, length);
+      if (write(hciFd_, packet, 4u + length) != static_cast<ssize_t>(4u + length))
+        throw BLEError(failure, "HCI command write failed", std::strerror(errno));
+    }
+
+    void BLEPlatformLinux::SendAdvertisingData(BLEError::Code failure)
+    {
+      // Length byte followed by a zero-padded 31-byte AD payload; the inputs were
+      // checked against kHciManufacturerDataMax before they were stored
+      uint8_t params[1 + kLegacyAdvertisingDataMax] = {};
+      {
+        std::lock_guard<std::mutex> lock(advertisingMutex_);
+        params[0] = static_cast<uint8_t>(
+            BuildAdvertisingData(manufacturerData_.data(), manufacturerData_.size(), name_, params + 1));
+      }
+      SendCommand(kSetAdvertisingData, params, sizeof(params), failure);
+    }
+
+    void BLEPlatformLinux::StartAdvertising(const AdvertisingOptions &options, SuccessCallback callback)
+    {
+      if (GetState() != BLEState::POWERED_ON)
+        throw BLEError(BLEError::Code::ADAPTER_POWERED_OFF, "Cannot advertise when adapter is not powered on");
+      // Before any state or controller change, so a rejected call leaves both as they were
+      if (options.manufacturerData.size() > kHciManufacturerDataMax)
+        throw BLEError(BLEError::Code::PAYLOAD_TOO_LARGE, "Manufacturer data exceeds 29 bytes");
+
+      {
+        std::lock_guard<std::mutex> lock(advertisingMutex_);
+        manufacturerData_.Assign(options.manufacturerData.data(), options.manufacturerData.size());
+        name_ = options.name;
+      }
+
+      uint16_t interval = IntervalUnits(options.intervalMs);
+      uint8_t params[15] = {};
+      params[0] = static_cast<uint8_t>(interval & 0xFF);
+      params[1] = static_cast<uint8_t>(interval >> 8);
+      params[2] = params[0];
+      params[3] = params[1];
+      params[4] = kAdvNonConnectable;
+      params[13] = 0x07; // All three advertising channels
+      SendCommand(kSetAdvertisingParameters, params, sizeof(params), BLEError::Code::ADVERTISING_FAILED);
+      SendAdvertisingData(BLEError::Code::ADVERTISING_FAILED);
+      uint8_t enable = 1;
+      SendCommand(kSetAdvertiseEnable, &enable, 1, BLEError::Code::ADVERTISING_FAILED);
+
+      advertising_ = true;
+      if (callback)
+        callback();
+    }
+
+    void BLEPlatformLinux::UpdateAdvertisingData(const AdvertisingData &data, SuccessCallback callback)
+    {
+      if (!advertising_)
+        throw BLEError(BLEError::Code::ADVERTISING_FAILED, "Not currently advertising");
+      if (data.size() > kHciManufacturerDataMax)
+        throw BLEError(BLEError::Code::PAYLOAD_TOO_LARGE, "Manufacturer data exceeds 29 bytes");
+      {
+        std::lock_guard<std::mutex> lock(advertisingMutex_);
+        manufacturerData_ = data;
+      }
+      // Only the PDU changes; the controller keeps advertising throughout
+      SendAdvertisingData(BLEError::Code::ADVERTISING_FAILED);
+      if (callback)
+        callback();
+    }
+
+    void BLEPlatformLinux::StopAdvertising(SuccessCallback callback)
+    {
+      if (advertising_.exchange(false))
+      {
+        uint8_t enable = 0;
+        SendCommand(kSetAdvertiseEnable, &enable, 1, BLEError::Code::ADVERTISING_FAILED);
+      }
+      if (callback)
+        callback();
+    }
+
+    bool BLEPlatformLinux::IsAdvertising() const
+    {
+      return advertising_;
+    }
+
+    void BLEPlatformLinux::StartScanning(const ScanOptions &options, SuccessCallback callback)
+    {
+      if (GetState() != BLEState::POWERED_ON)
+        throw BLEError(BLEError::Code::ADAPTER_POWERED_OFF, "Cannot scan when adapter is not powered on");
+
+      // Passive: GhostMesh only needs the advertising PDU. Continuous (10 ms
+      // window every 10 ms) unless the caller asked for a duty cycle
+      uint16_t interval = 0x0010;
+      uint16_t window = 0x0010;
+      if (options.windowMs != 0)
+      {
+        interval = ScanUnits(std::max(options.intervalMs, options.windowMs));
+        window = std::min(ScanUnits(options.windowMs), interval);
+      }
+      uint8_t params[7] = {0x00,
+                           static_cast<uint8_t>(interval & 0xFF), static_cast<uint8_t>(interval >> 8),
+                           static_cast<uint8_t>(window & 0xFF), static_cast<uint8_t>(window >> 8),
+                           0x00, 0x00};
+      SendCommand(kSetScanParameters, params, sizeof(params), BLEError::Code::SCANNING_FAILED);
+      // The controller's duplicate filter keys on address only and would hide
+      // rotated payloads; BLEAdapter's DuplicateFilter applies the options instead
+      uint8_t enable[2] = {1, 0};
+      SendCommand(kSetScanEnable, enable, sizeof(enable), BLEError::Code::SCANNING_FAILED);
+
+      scanning_ = true;
+      if (callback)
+        callback();
+    }
+
+    void BLEPlatformLinux::StopScanning(SuccessCallback callback)
+    {
+      if (scanning_.exchange(false))
+      {
+        uint8_t enable[2] = {0, 0};
+        SendCommand(kSetScanEnable, enable, sizeof(enable), BLEError::Code::SCANNING_FAILED);
+      }
+      if (callback)
+        callback();
+    }
+
+    bool BLEPlatformLinux::IsScanning() const
+    {
+      return scanning_;
+    }
+
+    const char *BLEPlatformLinux::GetPlatformName() const
+    {
+      return "BlueZ-HCI";
+    }
+
+    IBLEPlatform::Capabilities BLEPlatformLinux::GetCapabilities() const
+    {
+      Capabilities caps;
+      caps.supportsExtendedAdvertising = false;
+      caps.maxAdvertisingDataSize = static_cast<uint16_t>(kLegacyAdvertisingDataMax - 2);
+      caps.supportsSimultaneousAdvScan = true;
+      caps.supportsMultipleAdvSets = false;
+      caps.supportsScanDutyCycle = true;
+      return caps;
+    }
+
+    void BLEPlatformLinux::RunLoop()
+    {
+      epoll_event events[3];
+      for (;;)
+      {
+        int count = epoll_wait(epollFd_, events, 3, -1);
+        if (count < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          ReportError(BLEError::Code::PLATFORM_ERROR, "HCI event loop failed", std::strerror(errno));
+          return;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+          int fd = events[i].data.fd;
+          if (fd == wakeFd_)
+            return;
+          if (fd == timerFd_)
+          {
+            uint64_t expirations;
+            (void)read(timerFd_, &expirations, sizeof(expirations));
+            PollState();
+          }
+          else if (fd == hciFd_)
+          {
+            DrainSocket();
+          }
+        }
+      }
+    }
+
+    void BLEPlatformLinux::DrainSocket()
+    {
+      uint8_t buffer[kMaxEventSize];
+      for (;;)
+      {
+        ssize_t length = recv(hciFd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (length < 0)
+        {
+          if (errno == ENETDOWN)
+            PollState();
+          // EAGAIN: drained; anything else resurfaces through the state poll
+          return;
+        }
+        HandleEvent(buffer, static_cast<size_t>(length));
+      }
+    }
+
+    void BLEPlatformLinux::HandleEvent(const uint8_t *event, size_t length)
+    {
+      if (length < 3 || event[0] != kEventPacket)
+        return;
+      uint8_t code = event[1];
+      size_t parameterLength = std::min<size_t>(event[2], length - 3);
+      const uint8_t *params = event + 3;
+
+      switch (code)
+      {
+      case kEventLeMeta:
+        if (parameterLength >= 2 && params[0] == kLeAdvertisingReport)
+          HandleAdvertisingReports(params + 1, parameterLength - 1);
+        break;
+      case kEventCommandComplete:
+        // Num_HCI_Command_Packets, Opcode, then the command's return status
+        if (parameterLength >= 4)
+          HandleCommandResult(static_cast<uint16_t>(params[1] | (params[2] << 8)), params[3]);
+        break;
+      case kEventCommandStatus:
+        if (parameterLength >= 4)
+          HandleCommandResult(static_cast<uint16_t>(params[2] | (params[3] << 8)), params[0]);
+        break;
+      default:
+        break;
+      }
+    }
+
+    void BLEPlatformLinux::HandleAdvertisingReports(const uint8_t *reports, size_t length)
+    {
+      std::lock_guard<std::mutex> lock(callbackMutex_);
+      if (discoveredCallback_)
+        ParseAdvertisingReports(reports, length, NowMs(), device_, discoveredCallback_);
+    }
+
+    void BLEPlatformLinux::HandleCommandResult(uint16_t opcode, uint8_t status)
+    {
+      if (status == 0)
+        return;
+      // bluetoothd may already have the controller in the requested state
+      if (status == kStatusCommandDisallowed && (opcode == kSetScanEnable || opcode == kSetAdvertiseEnable))
+        return;
+
+      char native[32];
+      std::snprintf(native, sizeof(native), "opcode 0x%04x status 0x%02x", opcode, status);
+      bool scan = opcode == kSetScanParameters || opcode == kSetScanEnable;
+      bool advertise = opcode == kSetAdvertisingParameters || opcode == kSetAdvertisingData ||
+                       opcode == kSetAdvertiseEnable;
+      if (scan)
+        ReportError(BLEError::Code::SCANNING_FAILED, "Controller rejected a scan command", native);
+      else if (advertise)
+        ReportError(BLEError::Code::ADVERTISING_FAILED, "Controller rejected an advertising command", native);
+    }
+
+    void BLEPlatformLinux::PollState()
+    {
+      HciDevInfo info = {};
+      info.deviceId = deviceId_;
+      if (ioctl(hciFd_, kHciGetDevInfo, &info) < 0)
+      {
+        SetState(errno == ENODEV ? BLEState::UNSUPPORTED : BLEState::UNKNOWN);
+        return;
+      }
+      SetState((info.flags & kHciUpFlag) != 0 ? BLEState::POWERED_ON : BLEState::POWERED_OFF);
+    }
+
+    void BLEPlatformLinux::SetState(BLEState state)
+    {
+      if (state_.exchange(state, std::memory_order_acq_rel) == state)
+        return;
+      if (state != BLEState::POWERED_ON)
+      {
+        // The controller drops both when it goes down
+        advertising_ = false;
+        scanning_ = false;
+      }
+      std::lock_guard<std::mutex> lock(callbackMutex_);
+      if (stateCallback_)
+        stateCallback_(state);
+    }
+
+    void BLEPlatformLinux::ReportError(BLEError::Code code, const std::string &message, const std::string &native)
+    {
+      std::lock_guard<std::mutex> lock(callbackMutex_);
+      if (errorCallback_)
+        errorCallback_(BLEError(code, message, native));
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
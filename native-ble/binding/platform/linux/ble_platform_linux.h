@@ -0,0 +1,112 @@
+#pragma once
+
+#include "../ble_platform.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * Linux implementation on a raw HCI socket
+     *
+     * Talks HCI directly instead of going through BlueZ's D-Bus API, so an
+     * advertisement costs one recv() and a parse rather than a D-Bus message
+     * per report; on Raspberry Pi class relays that marshalling dominated CPU.
+     * bluetoothd may keep running: commands are sent on the device's raw
+     * channel alongside it.
+     *
+     * A dedicated thread runs an epoll loop over the HCI socket, an eventfd
+     * (shutdown) and a timerfd (adapter power polling). LE Advertising Reports
+     * are parsed straight out of the receive buffer into one reused
+     * DiscoveredDevice, so steady-state scanning does not allocate.
+     *
+     * Requires CAP_NET_RAW (or root). Without it Initialize() reports
+     * UNAUTHORIZED and throws ADAPTER_UNAUTHORIZED.
+     */
+    class BLEPlatformLinux : public IBLEPlatform
+    {
+    public:
+      /**
+       * @param deviceId HCI device index (0 = hci0)
+       */
+      explicit BLEPlatformLinux(uint16_t deviceId = 0);
+      ~BLEPlatformLinux() override;
+
+      BLEPlatformLinux(const BLEPlatformLinux &) = delete;
+      BLEPlatformLinux &operator=(const BLEPlatformLinux &) = delete;
+
+      void Initialize() override;
+      void Shutdown() override;
+      BLEState GetState() const override;
+
+      void SetStateChangeCallback(StateChangeCallback callback) override;
+      void SetErrorCallback(ErrorCallback callback) override;
+
+      void StartAdvertising(const AdvertisingOptions &options, SuccessCallback callback) override;
+      void UpdateAdvertisingData(const AdvertisingData &data, SuccessCallback callback) override;
+      void StopAdvertising(SuccessCallback callback) override;
+      bool IsAdvertising() const override;
+
+      void StartScanning(const ScanOptions &options, SuccessCallback callback) override;
+      void SetDeviceDiscoveredCallback(DeviceDiscoveredCallback callback) override;
+      void StopScanning(SuccessCallback callback) override;
+      bool IsScanning() const override;
+
+      const char *GetPlatformName() const override;
+      Capabilities GetCapabilities() const override;
+
+    private:
+      /**
+       * Send one HCI command (any thread; raw socket writes are per-packet atomic)
+       * @throws BLEError if the write fails
+       */
+      void SendCommand(uint16_t opcode, const uint8_t *params, uint8_t length, BLEError::Code failure);
+
+      /**
+       * Rebuild and send the advertising PDU from the current name and manufacturer data
+       */
+      void SendAdvertisingData(BLEError::Code failure);
+
+      void RunLoop();
+      void DrainSocket();
+      void HandleEvent(const uint8_t *event, size_t length);
+      void HandleAdvertisingReports(const uint8_t *reports, size_t length);
+      void HandleCommandResult(uint16_t opcode, uint8_t status);
+      void PollState();
+      void SetState(BLEState state);
+      void ReportError(BLEError::Code code, const std::string &message, const std::string &native);
+      void CloseDescriptors();
+
+      uint16_t deviceId_;
+      int hciFd_;
+      int epollFd_;
+      int wakeFd_;
+      int timerFd_;
+      std::thread thread_;
+
+      std::atomic<BLEState> state_;
+      std::atomic<bool> advertising_;
+      std::atomic<bool> scanning_;
+
+      // Advertising PDU inputs (JS thread), guarded by advertisingMutex_
+      std::mutex advertisingMutex_;
+      std::string name_;
+      AdvertisingData manufacturerData_;
+
+      // Callbacks are invoked on the loop thread with callbackMutex_ held
+      std::mutex callbackMutex_;
+      StateChangeCallback stateCallback_;
+      ErrorCallback errorCallback_;
+      DeviceDiscoveredCallback discoveredCallback_;
+
+      // Loop thread only: reused for every report
+      DiscoveredDevice device_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,147 @@
+#include "hci_advertising.h"
+
+#include <algorithm>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      // AD types (Core Supplement Part A)
+      constexpr uint8_t kAdShortName = 0x08;
+      constexpr uint8_t kAdCompleteName = 0x09;
+      constexpr uint8_t kAdIncomplete16 = 0x02;
+      constexpr uint8_t kAdComplete16 = 0x03;
+      constexpr uint8_t kAdIncomplete128 = 0x06;
+      constexpr uint8_t kAdComplete128 = 0x07;
+      constexpr uint8_t kAdManufacturer = 0xFF;
+
+      const char kHexDigits[] = "0123456789abcdef";
+      const char kHexUpper[] = "0123456789ABCDEF";
+
+      // Little-endian UUID bytes from an AD field to canonical text
+      void AppendUuid(std::vector<std::string> &out, const uint8_t *le, size_t size)
+      {
+        char text[37];
+        size_t pos = 0;
+        for (size_t i = size; i-- > 0;)
+        {
+          text[pos++] = kHexDigits[le[i] >> 4];
+          text[pos++] = kHexDigits[le[i] & 0x0F];
+          if (size == 16 && (i == 12 || i == 10 || i == 8 || i == 6))
+            text[pos++] = '-';
+        }
+        out.emplace_back(text, pos);
+      }
+    } // namespace
+
+    size_t BuildAdvertisingData(const uint8_t *manufacturerData, size_t manufacturerSize, const std::string &name,
+                                uint8_t *ad)
+    {
+      if (manufacturerSize > kHciManufacturerDataMax)
+        return 0;
+
+      size_t pos = 0;
+      if (manufacturerSize > 0)
+      {
+        ad[pos++] = static_cast<uint8_t>(manufacturerSize + 1);
+        ad[pos++] = kAdManufacturer;
+        std::memcpy(ad + pos, manufacturerData, manufacturerSize);
+        pos += manufacturerSize;
+      }
+      // The name only gets whatever room the manufacturer data leaves
+      size_t room = kLegacyAdvertisingDataMax - pos;
+      if (!name.empty() && room >= 3)
+      {
+        size_t length = std::min(name.size(), room - 2);
+        ad[pos++] = static_cast<uint8_t>(length + 1);
+        ad[pos++] = length < name.size() ? kAdShortName : kAdCompleteName;
+        std::memcpy(ad + pos, name.data(), length);
+        pos += length;
+      }
+      return pos;
+    }
+
+    size_t ParseAdvertisingReports(const uint8_t *reports, size_t length, uint64_t timestamp,
+                                   DiscoveredDevice &device, const DeviceDiscoveredCallback &onDevice)
+    {
+      if (length == 0)
+        return 0;
+
+      // Controllers pack reports back to back (as BlueZ parses them):
+      // event type, address type, address[6], data length, data, RSSI
+      uint8_t count = reports[0];
+      size_t pos = 1;
+      size_t delivered = 0;
+      for (uint8_t i = 0; i < count && pos + 9 <= length; ++i)
+      {
+        const uint8_t *address = reports + pos + 2;
+        size_t dataLength = reports[pos + 8];
+        const uint8_t *data = reports + pos + 9;
+        if (pos + 10 + dataLength > length)
+          break;
+        int8_t rssi = static_cast<int8_t>(data[dataLength]);
+        pos += 10 + dataLength;
+
+        // Fill the reused device in place, straight from the receive buffer
+        char text[17];
+        for (int b = 0; b < 6; ++b)
+        {
+          uint8_t byte = address[5 - b];
+          text[b * 3] = kHexUpper[byte >> 4];
+          text[b * 3 + 1] = kHexUpper[byte & 0x0F];
+          if (b < 5)
+            text[b * 3 + 2] = ':';
+        }
+        device.address.assign(text, sizeof(text));
+        device.name.clear();
+        device.manufacturerData.clear();
+        device.serviceUUIDs.clear();
+        device.rssi = rssi;
+        device.timestamp = timestamp;
+
+        size_t adPos = 0;
+        while (adPos < dataLength)
+        {
+          size_t fieldLength = data[adPos];
+          if (fieldLength == 0 || adPos + 1 + fieldLength > dataLength)
+            break;
+          uint8_t type = data[adPos + 1];
+          const uint8_t *field = data + adPos + 2;
+          size_t size = fieldLength - 1;
+          switch (type)
+          {
+          case kAdManufacturer:
+            if (device.manufacturerData.empty())
+              device.manufacturerData.assign(field, field + size);
+            break;
+          case kAdShortName:
+          case kAdCompleteName:
+            device.name.assign(reinterpret_cast<const char *>(field), size);
+            break;
+          case kAdIncomplete16:
+          case kAdComplete16:
+            for (size_t u = 0; u + 2 <= size; u += 2)
+              AppendUuid(device.serviceUUIDs, field + u, 2);
+            break;
+          case kAdIncomplete128:
+          case kAdComplete128:
+            for (size_t u = 0; u + 16 <= size; u += 16)
+              AppendUuid(device.serviceUUIDs, field + u, 16);
+            break;
+          default:
+            break;
+          }
+          adPos += 1 + fieldLength;
+        }
+
+        onDevice(device);
+        ++delivered;
+      }
+      return delivered;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
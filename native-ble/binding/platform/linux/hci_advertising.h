@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../ble_platform.h"
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * Manufacturer data that fits a legacy advertisement beside its AD length and type bytes
+     */
+    constexpr size_t kHciManufacturerDataMax = kLegacyAdvertisingDataMax - 2;
+
+    /**
+     * Build a legacy advertising payload: manufacturer data (if any), then the
+     * name, shortened to whatever room is left
+     * @param ad Receives up to kLegacyAdvertisingDataMax bytes
+     * @return Payload length, or 0 without writing if the manufacturer data
+     *         exceeds kHciManufacturerDataMax
+     */
+    size_t BuildAdvertisingData(const uint8_t *manufacturerData, size_t manufacturerSize, const std::string &name,
+                                uint8_t *ad);
+
+    /**
+     * Parse the parameters of an LE Advertising Report subevent (after the
+     * subevent code): a report count, then the reports back to back
+     *
+     * Each report is decoded into `device`, reused across calls so steady-state
+     * scanning does not allocate, and passed to `onDevice`. Parsing stops at
+     * the first report that runs past `length`.
+     * @return Reports delivered
+     */
+    size_t ParseAdvertisingReports(const uint8_t *reports, size_t length, uint64_t timestamp,
+                                   DiscoveredDevice &device, const DeviceDiscoveredCallback &onDevice);
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,59 @@
+/**
+ * @file adapter_events.cc
+ * @brief Event name table for AdapterEvent
+ */
+
+#include "adapter_events.h"
+
+#include <cstring>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      // Indexed by AdapterEvent
+      constexpr const char *kEventNames[kAdapterEventCount] = {
+          "stateChange",
+          "advertisingStarted",
+          "advertisingStopped",
+          "advertisingDataUpdated",
+          "scanningStarted",
+          "scanningStopped",
+          "deviceDiscovered",
+          "devicesDiscovered",
+          "meshMessage",
+          "advertisementCompleted",
+          "advertisementExpired",
+          "error",
+          "peerAdded",
+          "peerLost",
+      };
+    } // namespace
+
+    const char *AdapterEventName(AdapterEvent event)
+    {
+      size_t index = static_cast<size_t>(event);
+      return index < kAdapterEventCount ? kEventNames[index] : "";
+    }
+
+    bool ParseAdapterEvent(const char *name, size_t length, AdapterEvent &event)
+    {
+      if (length > kAdapterEventNameMax)
+        return false;
+      // Only runs on listener registration and JS-side emit(); a dozen short compares is plenty
+      for (size_t i = 0; i < kAdapterEventCount; ++i)
+      {
+        if (std::strlen(kEventNames[i]) == length && std::memcmp(kEventNames[i], name, length) == 0)
+        {
+          event = static_cast<AdapterEvent>(i);
+          return true;
+        }
+      }
+      return false;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
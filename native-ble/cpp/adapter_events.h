@@ -0,0 +1,67 @@
+#ifndef NATIVE_BLE_ADAPTER_EVENTS_H
+#define NATIVE_BLE_ADAPTER_EVENTS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file adapter_events.h
+ * @brief Interned names of the events BLEAdapter emits
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @enum AdapterEvent
+     * @brief Every event BLEAdapter emits; indexes BLEAdapter's listener table
+     *
+     * Names are mapped to IDs once, when a listener is registered, so native
+     * emission is an array index. Values are recorded in trace records.
+     */
+    enum class AdapterEvent : uint8_t
+    {
+      StateChange,
+      AdvertisingStarted,
+      AdvertisingStopped,
+      AdvertisingDataUpdated,
+      ScanningStarted,
+      ScanningStopped,
+      DeviceDiscovered,
+      DevicesDiscovered,
+      MeshMessage,
+      AdvertisementCompleted,
+      AdvertisementExpired,
+      Error,
+      PeerAdded,
+      PeerLost,
+      Count ///< Number of events, not an event
+    };
+
+    constexpr size_t kAdapterEventCount = static_cast<size_t>(AdapterEvent::Count);
+
+    /**
+     * @brief Longest event name, in bytes
+     */
+    constexpr size_t kAdapterEventNameMax = 22;
+
+    /**
+     * @brief JS name of an event
+     */
+    const char *AdapterEventName(AdapterEvent event);
+
+    /**
+     * @brief Look up an event by its JS name
+     * @param name UTF-8 name (need not be NUL-terminated)
+     * @param length Name length in bytes
+     * @param event Set to the event on success
+     * @return false if `name` is not one of the adapter's events
+     */
+    bool ParseAdapterEvent(const char *name, size_t length, AdapterEvent &event);
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_ADAPTER_EVENTS_H
@@ -0,0 +1,81 @@
+/**
+ * @file adapter_stats.cc
+ * @brief Implementation of adapter counters and latency histograms
+ */
+
+#include "adapter_stats.h"
+
+#include <algorithm>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    AdapterStats::AdapterStats()
+    {
+      for (auto &counter : counters_)
+        counter.value.store(0, std::memory_order_relaxed);
+      for (auto &counter : emits_)
+        counter.value.store(0, std::memory_order_relaxed);
+      for (auto &histogram : histograms_)
+      {
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.sum.store(0, std::memory_order_relaxed);
+        histogram.max.store(0, std::memory_order_relaxed);
+        for (auto &bucket : histogram.buckets)
+          bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    size_t StatHistogramBucket(uint64_t micros)
+    {
+      size_t bucket = 0;
+      while (micros != 0 && bucket < kStatHistogramBuckets - 1)
+      {
+        micros >>= 1;
+        ++bucket;
+      }
+      return bucket;
+    }
+
+    void AdapterStats::Record(StatHistogram which, uint64_t micros)
+    {
+      Histogram &histogram = histograms_[static_cast<size_t>(which)];
+      histogram.count.fetch_add(1, std::memory_order_relaxed);
+      histogram.sum.fetch_add(micros, std::memory_order_relaxed);
+      histogram.buckets[StatHistogramBucket(micros)].fetch_add(1, std::memory_order_relaxed);
+
+      uint64_t max = histogram.max.load(std::memory_order_relaxed);
+      while (micros > max && !histogram.max.compare_exchange_weak(max, micros, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    void AdapterStats::Snapshot(double *out) const
+    {
+      std::fill(out, out + kStatsSnapshotSize, 0.0);
+      out[0] = kStatsLayoutVersion;
+      Accumulate(out);
+    }
+
+    void AdapterStats::Accumulate(double *out) const
+    {
+      double *cursor = out + 1;
+      for (const auto &counter : counters_)
+        *cursor++ += static_cast<double>(counter.value.load(std::memory_order_relaxed));
+      for (const auto &counter : emits_)
+        *cursor++ += static_cast<double>(counter.value.load(std::memory_order_relaxed));
+      for (const auto &histogram : histograms_)
+      {
+        cursor[0] += static_cast<double>(histogram.count.load(std::memory_order_relaxed));
+        cursor[1] += static_cast<double>(histogram.sum.load(std::memory_order_relaxed));
+        cursor[2] = std::max(cursor[2], static_cast<double>(histogram.max.load(std::memory_order_relaxed)));
+        for (size_t i = 0; i < kStatHistogramBuckets; ++i)
+          cursor[3 + i] += static_cast<double>(histogram.buckets[i].load(std::memory_order_relaxed));
+        cursor += kStatHistogramStride;
+      }
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,165 @@
+#ifndef NATIVE_BLE_ADAPTER_STATS_H
+#define NATIVE_BLE_ADAPTER_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "adapter_events.h"
+
+/**
+ * @file adapter_stats.h
+ * @brief Hot-path counters and latency histograms of a BLEAdapter
+ *
+ * Updated with relaxed atomics from whichever thread sees the event
+ * (platform callbacks, the scheduler timer, the JS thread) and read with
+ * `getStats()` as one packed Float64Array (see src/stats.ts):
+ * - [0]: kStatsLayoutVersion
+ * - kStatCounterCount counters, in StatCounter order
+ * - kAdapterEventCount emit counts, in AdapterEvent order
+ * - kStatHistogramCount histograms of kStatHistogramStride values each:
+ *   count, sum (us), max (us), then kStatHistogramBuckets bucket counts
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    constexpr uint32_t kStatsLayoutVersion = 2;
+
+    /**
+     * @enum StatCounter
+     * @brief Monotonic counters; values index the snapshot after the version
+     */
+    enum class StatCounter : uint8_t
+    {
+      AdvertisementsReceived,  ///< Reports that reached the adapter from the radio
+      AdvertisementsFiltered,  ///< Rejected by the manufacturer / service filter
+      AdvertisementsDeduped,   ///< Dropped by the duplicate filter
+      AdvertisementsDelivered, ///< Handed on to reassembly, batching or `deviceDiscovered`
+      EventsEmitted,           ///< Native emits that had at least one listener
+      ListenerCalls,           ///< JS listener invocations across those emits
+      PlatformBatches,         ///< Platform event batches drained on the JS thread
+      AdvertisingUpdates,      ///< Payload changes: updateAdvertisingData() and rotations
+      AdvertisingRotations,    ///< Payloads put on air by the native scheduler
+      ScanWindows,             ///< Listening windows opened by the scan duty cycle
+      Count                    ///< Number of counters, not a counter
+    };
+
+    constexpr size_t kStatCounterCount = static_cast<size_t>(StatCounter::Count);
+
+    /**
+     * @enum StatHistogram
+     * @brief Latency distributions, in microseconds
+     */
+    enum class StatHistogram : uint8_t
+    {
+      EmitUs,          ///< One native emit: the N-API calls into every listener and their JS time
+      DispatchUs,      ///< Queued on a platform thread until delivered on the JS thread
+      RotationJitterUs, ///< Scheduler tick lateness behind its nominal interval
+      DiscoveryLatencyUs, ///< Duty-cycled scans: upper bound on how long a new peer went unheard
+      Count            ///< Number of histograms, not a histogram
+    };
+
+    constexpr size_t kStatHistogramCount = static_cast<size_t>(StatHistogram::Count);
+
+    /**
+     * @brief Bucket 0 counts samples under 1 us, bucket n samples in [2^(n-1), 2^n) us;
+     *        the last bucket also takes everything longer (from about 17 s)
+     */
+    constexpr size_t kStatHistogramBuckets = 26;
+
+    constexpr size_t kStatHistogramStride = 3 + kStatHistogramBuckets;
+
+    /**
+     * @brief Doubles in a snapshot
+     */
+    constexpr size_t kStatsSnapshotSize =
+        1 + kStatCounterCount + kAdapterEventCount + kStatHistogramCount * kStatHistogramStride;
+
+    /**
+     * @brief Microseconds on the monotonic clock, the time base of StatHistogram samples
+     */
+    inline uint64_t StatsNowUs()
+    {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::steady_clock::now().time_since_epoch())
+                                       .count());
+    }
+
+    /**
+     * @class AdapterStats
+     * @brief Counters and histograms of one adapter, safe to update from any thread
+     *
+     * Every counter sits on its own cache line, and so does every histogram,
+     * so a platform thread counting receptions never contends with the JS
+     * thread counting emits. Updates are relaxed fetch_adds: a snapshot is
+     * not a consistent cut across counters, but each value is exact.
+     */
+    class AdapterStats
+    {
+    public:
+      AdapterStats();
+
+      AdapterStats(const AdapterStats &) = delete;
+      AdapterStats &operator=(const AdapterStats &) = delete;
+
+      void Add(StatCounter counter, uint64_t n = 1)
+      {
+        counters_[static_cast<size_t>(counter)].value.fetch_add(n, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Count one emit of `event` that reached `listeners` listeners
+       */
+      void AddEmit(AdapterEvent event, size_t listeners)
+      {
+        emits_[static_cast<size_t>(event)].value.fetch_add(1, std::memory_order_relaxed);
+        Add(StatCounter::EventsEmitted);
+        Add(StatCounter::ListenerCalls, listeners);
+      }
+
+      void Record(StatHistogram histogram, uint64_t micros);
+
+      /**
+       * @brief Write the layout described in the file comment
+       * @param out kStatsSnapshotSize doubles
+       */
+      void Snapshot(double *out) const;
+
+      /**
+       * @brief Add this adapter's values into a snapshot (process-wide totals)
+       * @param out kStatsSnapshotSize doubles, already holding a snapshot
+       */
+      void Accumulate(double *out) const;
+
+    private:
+      struct alignas(64) Counter
+      {
+        std::atomic<uint64_t> value;
+      };
+
+      struct alignas(64) Histogram
+      {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+        std::atomic<uint32_t> buckets[kStatHistogramBuckets];
+      };
+
+      Counter counters_[kStatCounterCount];
+      Counter emits_[kAdapterEventCount];
+      Histogram histograms_[kStatHistogramCount];
+    };
+
+    /**
+     * @brief Bucket of a latency sample
+     */
+    size_t StatHistogramBucket(uint64_t micros);
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_ADAPTER_STATS_H
@@ -0,0 +1,65 @@
+#ifndef NATIVE_BLE_ADDON_INSTANCE_H
+#define NATIVE_BLE_ADDON_INSTANCE_H
+
+#include <napi.h>
+#include <array>
+#include <string>
+#include <unordered_map>
+
+#include "adapter_stats.h"
+#include "loopback_medium.h"
+
+class BLEAdapter;
+
+/**
+ * @file addon_instance.h
+ * @brief Addon state owned by one Node.js environment
+ */
+
+/**
+ * @class AddonInstance
+ * @brief Everything the addon keeps for the environment that loaded it
+ *
+ * The main thread, each worker_threads Worker and each Electron context load
+ * the addon into an environment of their own, and each gets its own instance
+ * (napi_set_instance_data, through Napi::Addon). Nothing is shared between JS
+ * threads but the trace ring, which is thread-safe. Node finalizes an
+ * environment's wrapped objects before its instance data, so adapters
+ * collected at teardown can still unregister here.
+ */
+class AddonInstance : public Napi::Addon<AddonInstance>
+{
+public:
+  AddonInstance(Napi::Env env, Napi::Object exports);
+
+  /**
+   * @brief Instance of the calling environment (JS thread only)
+   */
+  static AddonInstance &Of(Napi::Env env) { return *env.GetInstanceData<AddonInstance>(); }
+
+  /**
+   * @brief The loopback radio of this environment: its adapters hear each other, not other workers'
+   */
+  ghostmesh::ble::LoopbackMedium &Medium() { return medium_; }
+
+  /**
+   * @brief Live adapters by id
+   */
+  std::unordered_map<std::string, BLEAdapter *> &Adapters() { return adapters_; }
+
+  /**
+   * @brief Totals of the adapters that have left Adapters(), folded in by BLEAdapter::LeaveRegistry()
+   */
+  std::array<double, ghostmesh::ble::kStatsSnapshotSize> &RetiredStats() { return retiredStats_; }
+
+private:
+  Napi::Value DrainTrace(const Napi::CallbackInfo &info);
+  Napi::Value GetStats(const Napi::CallbackInfo &info);
+
+  Napi::FunctionReference adapterClass_;
+  ghostmesh::ble::LoopbackMedium medium_;
+  std::unordered_map<std::string, BLEAdapter *> adapters_;
+  std::array<double, ghostmesh::ble::kStatsSnapshotSize> retiredStats_;
+};
+
+#endif // NATIVE_BLE_ADDON_INSTANCE_H
@@ -0,0 +1,124 @@
+/**
+ * @file advertising_buffer.cc
+ * @brief Implementation of the inline advertising payload
+ */
+
+#include "advertising_buffer.h"
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    AdvertisingBuffer *AdvertisingBuffer::Create()
+    {
+      return new AdvertisingBuffer();
+    }
+
+    AdvertisingBuffer::AdvertisingBuffer()
+        : current_(kPrivateSlot), assigned_(false), refs_(1), copiedViews_(0)
+    {
+      for (auto &slot : slots_)
+      {
+        slot.views = 0;
+      }
+    }
+
+    bool AdvertisingBuffer::Assign(const uint8_t *data, size_t length)
+    {
+      if (length > kLegacyAdvertisingDataMax)
+        return false;
+
+      // Prefer the current slot, then any other slot no JS Buffer still views
+      size_t target = kPrivateSlot;
+      if (current_ != kPrivateSlot && slots_[current_].views == 0)
+      {
+        target = current_;
+      }
+      else
+      {
+        for (size_t i = 0; i < kSharedSlots; ++i)
+        {
+          if (slots_[i].views == 0)
+          {
+            target = i;
+            break;
+          }
+        }
+      }
+
+      slots_[target].payload.Assign(data, length);
+      current_ = target;
+      assigned_ = true;
+      return true;
+    }
+
+    void AdvertisingBuffer::Clear()
+    {
+      current_ = kPrivateSlot;
+      slots_[kPrivateSlot].payload.length = 0;
+      assigned_ = false;
+    }
+
+    Napi::Value AdvertisingBuffer::View(Napi::Env env, size_t index)
+    {
+      Slot &slot = slots_[index];
+      if (index != kPrivateSlot && slot.payload.length > 0)
+      {
+        napi_value result;
+        napi_status status = napi_create_external_buffer(env, slot.payload.length, slot.payload.bytes,
+                                                         &AdvertisingBuffer::FinalizeView, this, &result);
+        if (status == napi_ok)
+        {
+          ++slot.views;
+          ++refs_;
+          return Napi::Value(env, result);
+        }
+      }
+
+      ++copiedViews_;
+      return Napi::Buffer<uint8_t>::Copy(env, slot.payload.bytes, slot.payload.length);
+    }
+
+    // External buffer finalizer: unpin the slot the view was created over
+    void AdvertisingBuffer::FinalizeView(napi_env, void *data, void *hint)
+    {
+      AdvertisingBuffer *self = static_cast<AdvertisingBuffer *>(hint);
+      for (auto &slot : self->slots_)
+      {
+        if (slot.payload.bytes == data && slot.views > 0)
+        {
+          --slot.views;
+          break;
+        }
+      }
+      self->Unref();
+    }
+
+    size_t AdvertisingBuffer::Pin()
+    {
+      ++slots_[current_].views;
+      ++refs_;
+      return current_;
+    }
+
+    void AdvertisingBuffer::Unpin(size_t slot)
+    {
+      --slots_[slot].views;
+      Unref();
+    }
+
+    void AdvertisingBuffer::Release()
+    {
+      Clear();
+      Unref();
+    }
+
+    void AdvertisingBuffer::Unref()
+    {
+      if (--refs_ == 0)
+        delete this;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,110 @@
+#ifndef NATIVE_BLE_ADVERTISING_BUFFER_H
+#define NATIVE_BLE_ADVERTISING_BUFFER_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "../binding/platform/ble_platform.h"
+
+/**
+ * @file advertising_buffer.h
+ * @brief Inline advertising payload shared with JS through external buffers
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @class AdvertisingBuffer
+     * @brief An adapter's current advertising payload
+     *
+     * Payloads are copied once from the JS Buffer into one of a few inline
+     * AdvertisingData slots; nothing is heap allocated after Create(). Scanners
+     * receive external Buffers that view the slot directly. A slot with live
+     * views is never overwritten: updates rotate to a free slot, so a Buffer a
+     * listener kept keeps its bytes. If every shared slot is pinned, the update
+     * lands in a private slot and views of it are copied instead.
+     *
+     * JS thread only. Freed once the owner has called Release() and every
+     * view has been finalized.
+     */
+    class AdvertisingBuffer
+    {
+    public:
+      static constexpr size_t kSharedSlots = 4;
+
+      static AdvertisingBuffer *Create();
+
+      /**
+       * @brief Copy in a new payload
+       * @return false if it exceeds kLegacyAdvertisingDataMax (state unchanged)
+       */
+      bool Assign(const uint8_t *data, size_t length);
+
+      /**
+       * @brief Forget the current payload
+       */
+      void Clear();
+
+      /**
+       * @brief Whether a payload is assigned (it may be zero bytes long)
+       */
+      bool Assigned() const { return assigned_; }
+
+      const AdvertisingData &Current() const { return slots_[current_].payload; }
+
+      /**
+       * @brief Buffer viewing a pinned payload without copying
+       * @param env N-API environment
+       * @param slot Token returned by Pin()
+       * @return External Buffer, or a copy if the slot is private or the
+       *         runtime does not allow external buffers
+       */
+      Napi::Value View(Napi::Env env, size_t slot);
+
+      /**
+       * @brief Keep the current slot from being overwritten (e.g. mid-broadcast)
+       * @return Token for Unpin()
+       */
+      size_t Pin();
+
+      void Unpin(size_t slot);
+
+      /**
+       * @brief Drop the owner's reference
+       */
+      void Release();
+
+      /**
+       * @brief Number of views that had to be copied
+       */
+      uint64_t CopiedViews() const { return copiedViews_; }
+
+    private:
+      struct Slot
+      {
+        AdvertisingData payload;
+        uint32_t views;
+      };
+
+      static constexpr size_t kPrivateSlot = kSharedSlots; ///< Never exposed externally
+
+      AdvertisingBuffer();
+
+      static void FinalizeView(napi_env env, void *data, void *hint);
+      void Unref();
+
+      Slot slots_[kSharedSlots + 1];
+      size_t current_;
+      bool assigned_;
+      uint32_t refs_; ///< Owner + outstanding views
+      uint64_t copiedViews_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_ADVERTISING_BUFFER_H
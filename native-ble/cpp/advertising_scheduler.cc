@@ -0,0 +1,229 @@
+/**
+ * @file advertising_scheduler.cc
+ * @brief Implementation of native advertising rotation
+ */
+
+#include "advertising_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      constexpr uint32_t kStrideBase = 1u << 20;
+    } // namespace
+
+    AdvertisingScheduler::AdvertisingScheduler(Sink sink)
+        : sink_(std::move(sink)), pending_(0), nextId_(1), lastTransmitted_(0), virtualTime_(0),
+          intervalMs_(100), running_(false), exiting_(false)
+    {
+      for (auto &entry : entries_)
+      {
+        entry.used = false;
+      }
+    }
+
+    AdvertisingScheduler::~AdvertisingScheduler()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exiting_ = true;
+      }
+      wake_.notify_one();
+      if (thread_.joinable())
+        thread_.join();
+    }
+
+    uint64_t AdvertisingScheduler::NowMs()
+    {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::steady_clock::now().time_since_epoch())
+                                       .count());
+    }
+
+    void AdvertisingScheduler::Start(uint32_t intervalMs)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        intervalMs_ = std::max<uint32_t>(1, intervalMs);
+        running_ = true;
+        if (!thread_.joinable())
+          thread_ = std::thread(&AdvertisingScheduler::Run, this);
+      }
+      wake_.notify_one();
+    }
+
+    void AdvertisingScheduler::Stop()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+      // The radio is off, so the next start must put a payload on air again
+      lastTransmitted_ = 0;
+    }
+
+    uint32_t AdvertisingScheduler::Submit(const uint8_t *data, size_t length, uint8_t priority, uint32_t repeat,
+                                          uint32_t ttlMs)
+    {
+      if (length > kLegacyAdvertisingDataMax)
+        return 0;
+
+      uint32_t id = 0;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto free = std::find_if(entries_.begin(), entries_.end(), [](const Entry &e)
+                                 { return !e.used; });
+        if (free == entries_.end())
+          return 0;
+
+        id = nextId_++;
+        if (nextId_ == 0)
+          nextId_ = 1;
+
+        free->used = true;
+        free->id = id;
+        free->stride = kStrideBase / (static_cast<uint32_t>(priority) + 1);
+        free->repeat = repeat;
+        free->sent = 0;
+        free->pass = virtualTime_;
+        free->expiresAtMs = ttlMs > 0 ? NowMs() + ttlMs : 0;
+        free->data.Assign(data, length);
+        ++pending_;
+      }
+      wake_.notify_one();
+      return id;
+    }
+
+    bool AdvertisingScheduler::Cancel(uint32_t id)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto &entry : entries_)
+      {
+        if (entry.used && entry.id == id)
+        {
+          entry.used = false;
+          --pending_;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void AdvertisingScheduler::Clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto &entry : entries_)
+      {
+        entry.used = false;
+      }
+      pending_ = 0;
+    }
+
+    size_t AdvertisingScheduler::Pending() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return pending_;
+    }
+
+    uint32_t AdvertisingScheduler::Weight() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      uint32_t weight = 0;
+      for (const Entry &entry : entries_)
+      {
+        // Exact: priority + 1 is at most 256, well under sqrt(kStrideBase)
+        if (entry.used)
+          weight += kStrideBase / entry.stride;
+      }
+      return weight;
+    }
+
+    // Timer thread: one tick per interval while running with work queued
+    void AdvertisingScheduler::Run()
+    {
+      using Clock = std::chrono::steady_clock;
+      std::vector<SchedulerEvent> events;
+      events.reserve(kMaxPending + 2);
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      Clock::time_point next = Clock::now();
+      while (!exiting_)
+      {
+        if (!running_ || pending_ == 0)
+        {
+          wake_.wait(lock, [this]
+                     { return exiting_ || (running_ && pending_ > 0); });
+          next = Clock::now();
+          continue;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (now < next)
+        {
+          // Re-check state on any wake-up (stop, exit, new work)
+          wake_.wait_until(lock, next);
+          continue;
+        }
+
+        events.clear();
+        Tick(NowMs(), events);
+        uint64_t lateUs = std::chrono::duration_cast<std::chrono::microseconds>(now - next).count();
+        for (auto &event : events)
+        {
+          event.lateUs = static_cast<uint32_t>(std::min<uint64_t>(lateUs, UINT32_MAX));
+        }
+        // Skip missed ticks after a stall instead of bursting to catch up
+        next = std::max(next + std::chrono::milliseconds(intervalMs_), now);
+
+        lock.unlock();
+        for (const auto &event : events)
+        {
+          sink_(event);
+        }
+        lock.lock();
+      }
+    }
+
+    void AdvertisingScheduler::Tick(uint64_t nowMs, std::vector<SchedulerEvent> &events)
+    {
+      Entry *selected = nullptr;
+      for (auto &entry : entries_)
+      {
+        if (!entry.used)
+          continue;
+        if (entry.expiresAtMs != 0 && nowMs >= entry.expiresAtMs)
+        {
+          events.push_back(SchedulerEvent{SchedulerEvent::Kind::Expired, entry.id, entry.sent, AdvertisingData(), 0});
+          entry.used = false;
+          --pending_;
+          continue;
+        }
+        if (selected == nullptr || entry.pass < selected->pass ||
+            (entry.pass == selected->pass && entry.id < selected->id))
+          selected = &entry;
+      }
+      if (selected == nullptr)
+        return;
+
+      virtualTime_ = selected->pass;
+      selected->pass += selected->stride;
+      ++selected->sent;
+      if (selected->id != lastTransmitted_)
+      {
+        events.push_back(SchedulerEvent{SchedulerEvent::Kind::Transmit, selected->id, selected->sent, selected->data, 0});
+        lastTransmitted_ = selected->id;
+      }
+      if (selected->repeat != 0 && selected->sent >= selected->repeat)
+      {
+        events.push_back(SchedulerEvent{SchedulerEvent::Kind::Completed, selected->id, selected->sent, AdvertisingData(), 0});
+        selected->used = false;
+        --pending_;
+      }
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,152 @@
+#ifndef NATIVE_BLE_ADVERTISING_SCHEDULER_H
+#define NATIVE_BLE_ADVERTISING_SCHEDULER_H
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../binding/platform/ble_platform.h"
+
+/**
+ * @file advertising_scheduler.h
+ * @brief Native rotation of queued advertising payloads
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @struct SchedulerEvent
+     * @brief Output of one scheduler tick
+     */
+    struct SchedulerEvent
+    {
+      enum class Kind
+      {
+        Transmit,  ///< Put `data` on air
+        Completed, ///< Payload reached its repeat count
+        Expired    ///< Payload's TTL ran out first
+      };
+
+      Kind kind;
+      uint32_t id;
+      uint32_t sent;        ///< Transmissions so far
+      AdvertisingData data; ///< Valid for Transmit
+      uint32_t lateUs;      ///< How far the tick ran behind its nominal time
+    };
+
+    /**
+     * @class AdvertisingScheduler
+     * @brief Rotates queued payloads into the advertisement on its own thread
+     *
+     * Every `intervalMs` the timer thread expires stale payloads and picks the
+     * next one by stride scheduling: a payload of priority p is chosen p + 1
+     * times as often as a priority-0 payload, and nothing starves. A payload
+     * with a repeat count leaves the queue after that many transmissions.
+     * When consecutive ticks pick the same payload, no Transmit is emitted,
+     * since the radio is already advertising it.
+     *
+     * The queue is a fixed array; Submit() never allocates. Events go to the
+     * sink on the timer thread, outside the lock.
+     */
+    class AdvertisingScheduler
+    {
+    public:
+      using Sink = std::function<void(const SchedulerEvent &event)>;
+
+      static constexpr size_t kMaxPending = 32;
+
+      explicit AdvertisingScheduler(Sink sink);
+
+      /**
+       * @brief Stops and joins the timer thread
+       */
+      ~AdvertisingScheduler();
+
+      AdvertisingScheduler(const AdvertisingScheduler &) = delete;
+      AdvertisingScheduler &operator=(const AdvertisingScheduler &) = delete;
+
+      /**
+       * @brief Start (or retime) rotation
+       * @param intervalMs Rotation period (AdvertisingOptions::intervalMs)
+       */
+      void Start(uint32_t intervalMs);
+
+      /**
+       * @brief Pause rotation; queued payloads are kept
+       */
+      void Stop();
+
+      /**
+       * @brief Queue a payload
+       * @param data Manufacturer data (at most kLegacyAdvertisingDataMax bytes)
+       * @param length Data length
+       * @param priority Higher is sent more often
+       * @param repeat Transmissions before completion (0 = until cancelled or expired)
+       * @param ttlMs Lifetime in ms (0 = unlimited)
+       * @return Payload ID, or 0 if the payload is too large or the queue is full
+       */
+      uint32_t Submit(const uint8_t *data, size_t length, uint8_t priority, uint32_t repeat, uint32_t ttlMs);
+
+      /**
+       * @brief Remove a queued payload without an event
+       * @return false if no such payload is queued
+       */
+      bool Cancel(uint32_t id);
+
+      /**
+       * @brief Remove every queued payload without events
+       */
+      void Clear();
+
+      size_t Pending() const;
+
+      /**
+       * @brief Sum of (priority + 1) over the queued payloads, their claim on airtime
+       */
+      uint32_t Weight() const;
+
+    private:
+      struct Entry
+      {
+        bool used;
+        uint32_t id;
+        uint32_t stride;
+        uint32_t repeat;
+        uint32_t sent;
+        uint64_t pass;
+        uint64_t expiresAtMs;
+        AdvertisingData data;
+      };
+
+      static uint64_t NowMs();
+
+      void Run();
+      void Tick(uint64_t nowMs, std::vector<SchedulerEvent> &events);
+
+      Sink sink_;
+      std::array<Entry, kMaxPending> entries_;
+      size_t pending_;
+      uint32_t nextId_;
+      uint32_t lastTransmitted_;
+      uint64_t virtualTime_; ///< Pass of the last selected entry; new entries start here
+
+      mutable std::mutex mutex_;
+      std::condition_variable wake_;
+      std::thread thread_;
+      uint32_t intervalMs_;
+      bool running_;
+      bool exiting_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_ADVERTISING_SCHEDULER_H
@@ -2,11 +2,90 @@
 // std::vector<BLEAdapter *> BLEAdapter::instances_;
 /**
  * @file ble_adapter.cc
- * @brief BLEAdapter Native Addon (macOS stub)
+ * @brief BLEAdapter Native Addon
  *
- * Implements basic BLE control functions for Node.js via N-API.
- * Platform: macOS (x64) - stub implementation, ready for CoreBluetooth integration.
+ * Implements basic BLE control functions for Node.js via N-API, over the
+ * compiled-in IBLEPlatform backend or the loopback radio.
  */
 
-// Root platform wrapper - include the platform-specific implementation
-#include "platform/macos/ble_adapter.cc"
+// Root wrapper - include the loopback backend and the shared adapter plumbing
+#include "platform/loopback/ble_adapter.cc"
+
+#include "mesh_assembler_wrap.h"
+#include "mesh_header_batch_wrap.h"
+#include "mesh_simulator_wrap.h"
+#include "message_codec_wrap.h"
+#include "message_id_set_wrap.h"
+#include "message_store_wrap.h"
+#include "relay_scheduler_wrap.h"
+#include "seen_digest_wrap.h"
+
+// Defined in hello.cc
+Napi::String HelloWorld(const Napi::CallbackInfo &info);
+
+// Class registration
+Napi::Function BLEAdapter::Init(Napi::Env env, Napi::Object exports)
+{
+  Napi::Function func = DefineClass(env, "BLEAdapter",
+                                    {
+                                        InstanceMethod("on", &BLEAdapter::On),
+                                        InstanceMethod("emit", &BLEAdapter::Emit),
+                                        InstanceMethod("getState", &BLEAdapter::GetState),
+                                        InstanceMethod("startAdvertising", &BLEAdapter::StartAdvertising),
+                                        InstanceMethod("updateAdvertisingData", &BLEAdapter::UpdateAdvertisingData),
+                                        InstanceMethod("stopAdvertising", &BLEAdapter::StopAdvertising),
+                                        InstanceMethod("scheduleAdvertisement", &BLEAdapter::ScheduleAdvertisement),
+                                        InstanceMethod("cancelAdvertisement", &BLEAdapter::CancelAdvertisement),
+                                        InstanceMethod("clearAdvertisements", &BLEAdapter::ClearAdvertisements),
+                                        InstanceMethod("createAdvertisingSet", &BLEAdapter::CreateAdvertisingSet),
+                                        InstanceMethod("updateAdvertisingSet", &BLEAdapter::UpdateAdvertisingSet),
+                                        InstanceMethod("removeAdvertisingSet", &BLEAdapter::RemoveAdvertisingSet),
+                                        InstanceMethod("getCapabilities", &BLEAdapter::GetCapabilities),
+                                        InstanceMethod("getPlatformName", &BLEAdapter::GetPlatformName),
+                                        InstanceMethod("getLinkQuality", &BLEAdapter::GetLinkQuality),
+                                        InstanceMethod("getPeers", &BLEAdapter::GetPeers),
+                                        InstanceMethod("getMeshStats", &BLEAdapter::GetMeshStats),
+                                        InstanceMethod("getStats", &BLEAdapter::GetStats),
+                                        InstanceMethod("startScanning", &BLEAdapter::StartScanning),
+                                        InstanceMethod("stopScanning", &BLEAdapter::StopScanning),
+                                        InstanceMethod("destroy", &BLEAdapter::Destroy),
+                                        InstanceMethod("attachDiscoveryRing", &BLEAdapter::AttachDiscoveryRing),
+                                        InstanceMethod("detachDiscoveryRing", &BLEAdapter::DetachDiscoveryRing),
+                                        InstanceMethod("drainTrace", &BLEAdapter::DrainTrace),
+                                        InstanceMethod("isAdvertisingActive", &BLEAdapter::IsAdvertisingActive),
+                                        InstanceMethod("isScanningActive", &BLEAdapter::IsScanningActive),
+                                    });
+  exports.Set("BLEAdapter", func);
+  return func;
+}
+
+// Module entry point, once per environment (main thread, each worker, each Electron context)
+AddonInstance::AddonInstance(Napi::Env env, Napi::Object exports) : retiredStats_()
+{
+  DefineAddon(exports, {
+                           InstanceMethod("drainTrace", &AddonInstance::DrainTrace),
+                           InstanceMethod("getStats", &AddonInstance::GetStats),
+                       });
+  exports.Set("hello", Napi::Function::New(env, HelloWorld));
+  MeshAssemblerWrap::Init(env, exports);
+  MeshHeaderBatchWrap::Init(env, exports);
+  MessageIdSetWrap::Init(env, exports);
+  MessageCodecWrap::Init(env, exports);
+  MessageStoreWrap::Init(env, exports);
+  RelaySchedulerWrap::Init(env, exports);
+  SeenDigestWrap::Init(env, exports);
+  MeshSimulatorWrap::Init(env, exports);
+  adapterClass_ = Napi::Persistent(BLEAdapter::Init(env, exports));
+}
+
+Napi::Value AddonInstance::DrainTrace(const Napi::CallbackInfo &info)
+{
+  return BLEAdapter::DrainTraceBuffer(info.Env());
+}
+
+Napi::Value AddonInstance::GetStats(const Napi::CallbackInfo &info)
+{
+  return BLEAdapter::ProcessStats(info.Env());
+}
+
+NODE_API_ADDON(AddonInstance)
@@ -2,21 +2,45 @@
 #define NATIVE_BLE_BLE_ADAPTER_H
 
 #include <napi.h>
-#include <iostream>
+#include <array>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
+#include "../binding/platform/ble_platform.h"
+#include "adapter_events.h"
+#include "adapter_stats.h"
+#include "advertising_buffer.h"
+#include "addon_instance.h"
+#include "advertising_scheduler.h"
+#include "coexistence_arbiter.h"
+#include "dedup_cache.h"
+#include "discovery_batch.h"
+#include "discovery_ring.h"
+#include "link_quality.h"
+#include "loopback_medium.h"
+#include "mesh_packet.h"
+#include "peer_monitor.h"
+#include "platform_event_dispatcher.h"
+#include "platform_operation.h"
+#include "scan_duty_cycle.h"
+#include "scan_filter.h"
+#include "trace_ring.h"
+
 /**
  * @file ble_adapter.h
- * @brief Declaration of BLEAdapter native addon class (macOS stub)
+ * @brief Declaration of BLEAdapter native addon class
  */
 
 /**
  * @class BLEAdapter
- * @brief Native BLE Adapter stub for macOS (Node.js N-API)
+ * @brief Native BLE Adapter (Node.js N-API)
  *
- * Implements a stub BLE adapter for testing and development, with event emitter
- * and state logic. Methods are defined in ble_adapter.cc.
+ * Event emitter and state logic over one of two backends: the IBLEPlatform
+ * compiled for this OS (binding.gyp selects it), or the in-process loopback
+ * radio used for testing and development. The loopback methods are defined
+ * in platform/loopback/ble_adapter.cc, the platform delegation in
+ * ble_adapter_platform.cc.
  */
 class BLEAdapter : public Napi::ObjectWrap<BLEAdapter>
 {
@@ -34,7 +58,16 @@ public:
 
   /**
    * @brief Construct a BLEAdapter object
-   * @param info N-API callback info
+   * @param info [0]: optional { adapterId, backend: 'auto' | 'loopback' | 'platform',
+   *             simultaneousAdvScan, coexistenceCycleMs, lazyInit }
+   *
+   * 'auto' (the default) uses the compiled-in platform backend when it
+   * initializes and falls back to loopback otherwise; 'platform' throws if
+   * this build has no backend. `simultaneousAdvScan: false` time-slices
+   * advertising and scanning even if the radio could do both (on loopback,
+   * it models a radio that cannot). With `lazyInit`, Initialize() runs on
+   * the libuv pool instead of in the constructor. Either way the object gets
+   * a `ready` promise, resolved once the backend is settled.
    */
   BLEAdapter(const Napi::CallbackInfo &info);
   /**
@@ -46,9 +79,9 @@ public:
    * @brief Initialize BLEAdapter class and export to Node.js
    * @param env N-API environment
    * @param exports N-API exports object
-   * @return N-API exports object
+   * @return The class, for the environment's AddonInstance to hold
    */
-  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::Function Init(Napi::Env env, Napi::Object exports);
 
   /**
    * @brief Register an event listener
@@ -67,60 +100,179 @@ public:
   /**
    * @brief Emit an event programmatically (internal helper)
    * @param env Napi environment
-   * @param event Event name
+   * @param event Event ID; its listeners are found by array index
    * @param args Optional argument list
    */
-  void EmitEvent(Napi::Env env, const std::string &event, const std::vector<napi_value> &args = {});
+  void EmitEvent(Napi::Env env, ghostmesh::ble::AdapterEvent event, const std::vector<napi_value> &args = {});
 
   /**
-   * @brief Get current BLE adapter state (stub with error simulation)
+   * @brief Get current BLE adapter state (loopback: with error simulation)
    * @param info N-API callback info
    * @return BLE state as string or throws error if simulated
    */
   Napi::Value GetState(const Napi::CallbackInfo &info);
 
   /**
-   * @brief Start BLE advertising (stub)
+   * @brief Start BLE advertising
    * @param info N-API callback info
-   * @return undefined
+   * @return Promise resolved once advertising has started, rejected with a `code`
    */
   Napi::Value StartAdvertising(const Napi::CallbackInfo &info);
 
   /**
-   * @brief Update advertising data (stub)
+   * @brief Update advertising data
    * @param info N-API callback info
-   * @return undefined
+   * @return Promise resolved once the new data is on air
    */
   Napi::Value UpdateAdvertisingData(const Napi::CallbackInfo &info);
 
   /**
-   * @brief Stop BLE advertising (stub)
+   * @brief Stop BLE advertising
    * @param info N-API callback info
-   * @return undefined
+   * @return Promise resolved once advertising has stopped
    */
   Napi::Value StopAdvertising(const Napi::CallbackInfo &info);
 
   /**
-   * @brief Start BLE scanning (stub)
+   * @brief Queue a payload for native advertising rotation
+   * @param info [0]: manufacturer data (Buffer), [1]: optional { priority, repeat, ttlMs }
+   * @return Payload ID (number)
+   */
+  Napi::Value ScheduleAdvertisement(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Remove a queued payload
+   * @param info [0]: payload ID
+   * @return true if the payload was still queued
+   */
+  Napi::Value CancelAdvertisement(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Remove every queued payload
    * @param info N-API callback info
    * @return undefined
    */
+  Napi::Value ClearAdvertisements(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Start an extended advertising set alongside the main advertisement
+   * @param info [0]: { manufacturerData (Buffer, up to 251 bytes), serviceUUIDs? }
+   * @return Set ID (number)
+   */
+  Napi::Value CreateAdvertisingSet(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Replace an advertising set's manufacturer data
+   * @param info [0]: set ID, [1]: manufacturer data (Buffer)
+   * @return undefined
+   */
+  Napi::Value UpdateAdvertisingSet(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Stop and remove an advertising set
+   * @param info [0]: set ID
+   * @return true if the set existed
+   */
+  Napi::Value RemoveAdvertisingSet(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Report what the radio supports
+   * @param info N-API callback info
+   * @return { supportsExtendedAdvertising, maxAdvertisingDataSize, supportsSimultaneousAdvScan,
+   *           supportsMultipleAdvSets, maxAdvertisingSets, supportsScanDutyCycle }
+   */
+  Napi::Value GetCapabilities(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Snapshot the per-peer link-quality table
+   * @param info N-API callback info
+   * @return ArrayBuffer of PackedLinkQualityRecords (64 bytes each); empty
+   *         unless a scan was started with `trackLinkQuality`
+   */
+  Napi::Value GetLinkQuality(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief List the peers in range, most recently seen first
+   * @param info N-API callback info
+   * @return Array of { address, rssi, firstSeen, lastSeen, reports }; empty
+   *         unless a scan was started with `trackPeers`
+   */
+  Napi::Value GetPeers(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Counters of the native mesh reassembler
+   * @param info N-API callback info
+   * @return { inUse, capacity, completed, evicted, expired, rejected, oversized },
+   *         or null unless a scan with `assembleMesh` is active
+   */
+  Napi::Value GetMeshStats(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Hot-path counters and latency histograms of this adapter
+   * @param info N-API callback info
+   * @return Float64Array in the layout of adapter_stats.h, decoded by src/stats.ts
+   */
+  Napi::Value GetStats(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief The same layout summed over every adapter this environment has created (exported as `getStats`)
+   * @param env Napi environment
+   */
+  static Napi::Value ProcessStats(Napi::Env env);
+
+  /**
+   * @brief Name of the backend this adapter drives
+   * @param info N-API callback info
+   * @return "loopback", or the platform's name (e.g. "BlueZ-HCI")
+   */
+  Napi::Value GetPlatformName(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Start BLE scanning
+   * @param info N-API callback info
+   * @return Promise resolved once scanning has started, rejected with a `code`
+   */
   Napi::Value StartScanning(const Napi::CallbackInfo &info);
 
   /**
-   * @brief Stop BLE scanning (stub)
+   * @brief Stop BLE scanning
    * @param info N-API callback info
-   * @return undefined
+   * @return Promise resolved once scanning has stopped
    */
   Napi::Value StopScanning(const Napi::CallbackInfo &info);
 
   /**
-   * @brief Destroy BLE adapter (stub)
+   * @brief Destroy BLE adapter
    * @param info N-API callback info
-   * @return undefined
+   * @return Promise resolved once the adapter is released
    */
   Napi::Value Destroy(const Napi::CallbackInfo &info);
 
+  /**
+   * @brief Start publishing `devicesDiscovered` batches into a shared discovery ring
+   * @param info [0]: Int32Array over the whole ring (a SharedArrayBuffer from createDiscoveryRing())
+   * @return undefined; throws a TypeError for a malformed ring, an Error if another adapter writes it
+   */
+  Napi::Value AttachDiscoveryRing(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Stop publishing to the discovery ring and release it for another writer
+   */
+  Napi::Value DetachDiscoveryRing(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Drain the process-wide trace ring
+   * @param info N-API callback info
+   * @return ArrayBuffer of packed TraceRecords, oldest first
+   */
+  Napi::Value DrainTrace(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Drain the trace ring into a new ArrayBuffer (also exported as `drainTrace`)
+   * @param env Napi environment
+   */
+  static Napi::Value DrainTraceBuffer(Napi::Env env);
+
   /**
    * @brief Check if advertising is active
    * @param info N-API callback info
@@ -144,33 +296,425 @@ public:
   static void HandlePowerStateChange(const std::string &newState, Napi::Env env, Napi::Object thisObj);
 
   /**
-   * @brief N-API constructor reference for BLEAdapter
+   * @brief Hardware adapter identifier for this instance
    */
-  static Napi::FunctionReference constructor;
+  std::string adapterId_;
 
   /**
-   * @brief Hardware adapter identifier for this instance
+   * @brief HashAddress() of adapterId_, the `source` of this adapter's trace records
    */
-  std::string adapterId_;
+  uint32_t traceId_;
 
   /**
-   * @brief Registry of active adapter instances by id
+   * @brief State of the environment this adapter was created in: registry, stats totals, loopback medium
    */
-  static std::unordered_map<std::string, BLEAdapter *> adapters_;
+  AddonInstance *addon_;
+
+  /**
+   * @brief Remove this adapter from the environment's registry, keeping its stats in the totals
+   */
+  void LeaveRegistry();
 
 public:
   /**
    * @brief Lookup an adapter instance by hardware id
+   * @param env Environment whose adapters to search
    * @param id Adapter identifier
    * @return pointer to BLEAdapter or nullptr if not found
    */
-  static BLEAdapter *GetAdapter(const std::string &id);
+  static BLEAdapter *GetAdapter(Napi::Env env, const std::string &id);
+
+  /**
+   * @brief Callback suitable for IBLEPlatform::SetDeviceDiscoveredCallback
+   *
+   * Safe to invoke from any platform thread: reports rejected by the scan
+   * filters or repeated within the duplicate window are dropped, the rest are queued and emitted as
+   * `deviceDiscovered` on the JS thread in batches.
+   */
+  ghostmesh::ble::DeviceDiscoveredCallback PlatformDeviceDiscoveredCallback();
+
+  /**
+   * @brief Callback suitable for IBLEPlatform::SetStateChangeCallback
+   *
+   * Safe to invoke from any platform thread; emitted as `stateChange`.
+   */
+  ghostmesh::ble::StateChangeCallback PlatformStateChangeCallback();
 
 private:
   /**
-   * @brief Event listeners map: event name -> vector of callbacks
+   * @brief Deliver a batch of queued platform events (JS thread)
+   * @param env Napi environment
+   * @param batch Events drained by the dispatcher
+   */
+  void DeliverPlatformEvents(Napi::Env env, std::vector<ghostmesh::ble::PlatformEvent> &batch);
+
+  /**
+   * @brief Convert a platform device report to the JS `deviceDiscovered` shape
+   * @param env Napi environment
+   * @param device Platform device report
+   * @return JS device object
+   */
+  static Napi::Object DeviceToObject(Napi::Env env, const ghostmesh::ble::DiscoveredDevice &device);
+
+  /**
+   * @brief Map a platform state to its JS state name
+   */
+  static const char *StateName(ghostmesh::ble::BLEState state);
+
+  /**
+   * @brief Map a platform state to the adapter's power state
+   */
+  static State ToState(ghostmesh::ble::BLEState state);
+
+  /**
+   * @brief JS name of the adapter's current state
+   */
+  const char *CurrentStateName() const;
+
+  /**
+   * @brief Open the platform backend (constructor only)
+   * @param required Keep the backend even if Initialize() fails ('platform')
+   * @return false if this adapter should use the loopback radio instead
+   * @throws BLEError if `required` and this build has no backend
    */
-  std::unordered_map<std::string, std::vector<Napi::FunctionReference>> listeners_;
+  bool OpenPlatform(bool required);
+
+  /**
+   * @brief Open the platform backend with Initialize() on the libuv pool (constructor only)
+   * @param required As for OpenPlatform()
+   * @return Promise resolved once the backend, or the loopback fallback, is in place;
+   *         empty if this build has no backend and loopback is used right away
+   * @throws BLEError if `required` and this build has no backend
+   *
+   * Until then the adapter is not powered on: radio operations are rejected
+   * and `stateChange` listeners are not called until the outcome is known.
+   */
+  Napi::Value OpenPlatformInBackground(Napi::Env env, bool required);
+
+  /**
+   * @brief Install the callbacks of an initialized (or, if required, failed) backend and adopt it
+   */
+  void AttachPlatform(std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform);
+
+  /**
+   * @brief Detach and shut down the platform backend synchronously (destructor)
+   */
+  void ClosePlatform();
+
+  /**
+   * @brief Stop platform callbacks from reaching dispatcher_ (before it is closed)
+   */
+  void DetachPlatformCallbacks();
+
+  /**
+   * @brief Platform halves of the radio operations, entered once the shared checks pass
+   */
+  Napi::Value StartPlatformAdvertising(Napi::Env env, Napi::Object opts);
+  Napi::Value UpdatePlatformAdvertisingData(Napi::Env env, Napi::Value data);
+  Napi::Value StopPlatformAdvertising(Napi::Env env);
+  Napi::Value StartPlatformScanning(Napi::Env env, Napi::Value options);
+  Napi::Value StopPlatformScanning(Napi::Env env);
+  Napi::Value ShutdownPlatform(Napi::Env env);
+
+  /**
+   * @brief Start, update or stop a platform advertising set (JS thread)
+   * @throws BLEError from the platform
+   */
+  uint8_t StartPlatformAdvertisingSet(const uint8_t *data, size_t length, const std::vector<std::string> &serviceUUIDs);
+  void UpdatePlatformAdvertisingSet(uint8_t handle, const uint8_t *data, size_t length);
+  void StopPlatformAdvertisingSet(uint8_t handle);
+
+  /**
+   * @brief Emit `error` for a platform failure
+   * @param env Napi environment
+   * @param error Platform error; its code is mapped with JsErrorCode()
+   */
+  void EmitPlatformError(Napi::Env env, const ghostmesh::ble::BLEError &error);
+
+  /**
+   * @brief Release the platform event dispatcher (idempotent)
+   */
+  void CloseDispatcher();
+
+  /**
+   * @brief Put a payload chosen by the scheduler on air (JS thread)
+   * @param env Napi environment
+   * @param data Payload from the AdvertisingRotated event
+   */
+  void RotateAdvertisement(Napi::Env env, const ghostmesh::ble::AdvertisingData &data);
+
+  friend class ghostmesh::ble::LoopbackMedium;
+
+  /**
+   * @struct AdvertisingSet
+   * @brief One extended advertising set
+   */
+  struct AdvertisingSet
+  {
+    uint32_t id;
+    Napi::Reference<Napi::Value> manufacturerData; ///< Private copy of the caller's Buffer (loopback)
+    std::vector<std::string> serviceUUIDs;
+    uint8_t handle; ///< IBLEPlatform set handle (platform backend)
+  };
+
+  /**
+   * @brief Concurrent advertising sets per adapter, besides the main advertisement
+   */
+  static constexpr size_t kMaxAdvertisingSets = 4;
+
+  /**
+   * @brief Find an advertising set by ID
+   * @return Set, or nullptr if there is none
+   */
+  AdvertisingSet *FindAdvertisingSet(uint32_t id);
+
+  /**
+   * @brief Deliver an advertising set's current payload to the scanners
+   */
+  void BroadcastAdvertisingSet(Napi::Env env, const AdvertisingSet &set);
+
+  /**
+   * @brief Keep the medium's advertiser list in step with the main advertisement and the sets
+   */
+  void UpdateAdvertiserMembership();
+
+  /**
+   * @brief Listener list for a JS event name
+   * @param env Napi environment
+   * @param name Event name (string)
+   * @param create Create the list for a non-adapter event name if missing
+   * @param event Set to the interned event, or AdapterEvent::Count for a non-adapter name
+   * @return Listener list, or nullptr if `create` is false and there is none
+   */
+  std::vector<Napi::FunctionReference> *FindListeners(Napi::Env env, Napi::Value name, bool create,
+                                                      ghostmesh::ble::AdapterEvent &event);
+
+  /**
+   * @brief Pack an event ID and listener count into a trace argument
+   */
+  static uint64_t TraceArg(ghostmesh::ble::AdapterEvent event, size_t listeners);
+
+  /**
+   * @brief Copy a JS manufacturer data Buffer into the inline payload
+   *
+   * Payloads longer than kLegacyAdvertisingDataMax (or non-Buffer values)
+   * are kept by reference and forwarded unchanged.
+   */
+  void SetAdvertisingData(Napi::Value value);
+
+  void ClearAdvertisingData();
+
+  bool HasAdvertisingData() const;
+
+  /**
+   * @brief Manufacturer data kept by reference, or an empty value
+   */
+  Napi::Value OversizedAdvertisingData() const;
+
+  /**
+   * @brief Receive an in-process (loopback) advertisement on this scanning adapter
+   *
+   * Applies the scan and duplicate filters, then DeliverDiscovery().
+   * @param env Napi environment
+   * @param frame Advertisement shared by every recipient of the transmission
+   */
+  void ReceiveLoopback(Napi::Env env, ghostmesh::ble::LoopbackFrame &frame);
+
+  /**
+   * @brief Deliver a discovery that passed filtering
+   *
+   * Feeds the mesh reassembler, appends a packed record when the scan was
+   * started with `batchDiscoveries`, or emits `deviceDiscovered` with the
+   * frame's shared device object.
+   * @param env Napi environment
+   * @param frame Advertisement to deliver
+   */
+  void DeliverDiscovery(Napi::Env env, ghostmesh::ble::LoopbackFrame &frame);
+
+  /**
+   * @brief Emit one `devicesDiscovered` event for a flushed batch
+   * @param env Napi environment
+   * @param records Packed records (kPackedRecordStride bytes each)
+   * @param count Number of records
+   */
+  void EmitDiscoveryBatch(Napi::Env env, const uint8_t *records, size_t count);
+
+  /**
+   * @brief Release the discovery batcher (idempotent)
+   */
+  void CloseBatcher();
+
+  /**
+   * @brief Feed one report to the peer monitor, if a scan enabled `trackPeers`
+   */
+  void TouchPeer(const std::string &address, int16_t rssi, uint64_t timestampMs);
+
+  /**
+   * @brief Release the peer monitor (idempotent)
+   */
+  void ClosePeers();
+
+  /**
+   * @brief Convert a peer table entry to a JS object
+   */
+  static Napi::Object PeerToObject(Napi::Env env, const ghostmesh::ble::Peer &peer);
+
+  /**
+   * @brief Apply the scan's manufacturer, service and duplicate filters
+   * @param options ScanOptions object passed to startScanning (may be undefined)
+   * @return The parsed options, for a platform backend
+   */
+  ghostmesh::ble::ScanOptions ConfigureScanFilters(Napi::Value options);
+
+  /**
+   * @brief Set up `batchDiscoveries` batching, `assembleMesh` reassembly,
+   *        `trackLinkQuality` aggregation and `trackPeers` monitoring for a scan
+   * @param env Napi environment
+   * @param options ScanOptions object passed to startScanning (may be undefined)
+   */
+  void ConfigureScanDelivery(Napi::Env env, Napi::Value options);
+
+  /**
+   * @brief Flush and release the scan's batcher and reassembler
+   */
+  void EndScanDelivery();
+
+  /**
+   * @brief Parse `scanWindowMs`, `scanIntervalMs`, `adaptiveScan`, `minScanIntervalMs` and `maxScanIntervalMs`
+   * @param options ScanOptions object passed to startScanning (may be undefined)
+   * @return Normalized config; Continuous() unless a window was given
+   */
+  static ghostmesh::ble::ScanDutyConfig ParseScanDutyCycle(Napi::Value options);
+
+  /**
+   * @brief Start gating the radio with scanCycler_ (first window opens right away)
+   */
+  void StartScanDutyCycle(const ghostmesh::ble::ScanDutyConfig &config);
+
+  /**
+   * @brief Stop the cycler; the radio is left to the caller (idempotent)
+   */
+  void StopScanDutyCycle();
+
+  /**
+   * @brief Handle a ScanWindowOpened / ScanWindowClosed event (JS thread)
+   */
+  void OpenScanWindow(Napi::Env env, uint32_t gapMs);
+  void CloseScanWindow(Napi::Env env);
+
+  /**
+   * @brief Start or stop the platform radio's scan and advertisement to match ShouldListen() / ShouldRadiate()
+   *
+   * Waits while any other start or stop is in flight, then issues one,
+   * stops first, so a radio that cannot do both never has both on. Every
+   * completion re-syncs, so window and slot edges that pass meanwhile are
+   * folded into the next call.
+   */
+  void SyncPlatformRadio(Napi::Env env);
+
+  /**
+   * @brief Note activity for the adaptive duty cycle and, for a new peer, its discovery latency
+   */
+  void NoteScanActivity(bool peerAdded);
+
+  /**
+   * @brief Deliver the current payload of every other loopback advertiser to this adapter
+   * @return false if there was none
+   */
+  bool ReceiveAdvertisers(Napi::Env env);
+
+  /**
+   * @enum RadioSlot
+   * @brief Which operation owns a radio that cannot advertise and scan at once
+   */
+  enum class RadioSlot
+  {
+    Shared,    ///< No contention: both may run
+    Advertise, ///< Advertise slot of the coexistence arbiter
+    Scan       ///< Scan slot of the coexistence arbiter
+  };
+
+  bool AdvertiseSlotOpen() const { return radioSlot_ != RadioSlot::Scan; }
+  bool ScanSlotOpen() const { return radioSlot_ != RadioSlot::Advertise; }
+
+  /**
+   * @brief Whether the receiver should be on: scanning, in a scan slot and in a duty cycle window
+   */
+  bool ShouldListen() const;
+
+  /**
+   * @brief Whether the main advertisement should be on air: advertising and in an advertise slot
+   */
+  bool ShouldRadiate() const;
+
+  /**
+   * @brief Whether advertising and scanning have to take turns on the radio
+   */
+  bool RadioContended() const;
+
+  /**
+   * @brief Start or stop the coexistence arbiter as advertising and scanning start and stop
+   *
+   * Arbitrates while both are on and the radio cannot do both at once; the
+   * radio is handed over with ApplyRadio().
+   */
+  void UpdateArbitration(Napi::Env env);
+
+  /**
+   * @brief Stop the arbiter and return the radio to Shared, without touching the radio (idempotent)
+   */
+  void StopArbitration();
+
+  /**
+   * @brief Handle a RadioSlotAdvertise / RadioSlotScan event (JS thread)
+   */
+  void EnterRadioSlot(Napi::Env env, RadioSlot slot);
+
+  /**
+   * @brief Bring the radio in line with ShouldListen() / ShouldRadiate()
+   *
+   * Loopback: subscribes (hearing what is on air) or unsubscribes, and joins
+   * or leaves the medium's advertisers. Platform: SyncPlatformRadio().
+   */
+  void ApplyRadio(Napi::Env env);
+
+  /**
+   * @brief Airtime claim of the advertiser: the scheduler's Weight(), at least 1
+   */
+  uint32_t AdvertisingWeight() const;
+
+  /**
+   * @brief Pass a changed AdvertisingWeight() to a running arbiter
+   */
+  void UpdateAdvertisingWeight();
+
+  /**
+   * @brief Copy the string elements of a JS array
+   */
+  static std::vector<std::string> StringArray(Napi::Value value);
+
+  /**
+   * @brief Feed manufacturer data to the native mesh reassembler
+   *
+   * Only active for scans started with `assembleMesh`. Emits `meshMessage`
+   * when a message completes; incomplete fragments never reach JS.
+   * @param env Napi environment
+   * @param address Advertiser address
+   * @param data Manufacturer data
+   * @param length Manufacturer data length
+   * @return true if the data was a GhostMesh packet and has been consumed
+   */
+  bool ConsumeMeshPacket(Napi::Env env, const std::string &address, const uint8_t *data, size_t length);
+
+  /**
+   * @brief Listeners of the adapter's own events, indexed by AdapterEvent
+   */
+  std::array<std::vector<Napi::FunctionReference>, ghostmesh::ble::kAdapterEventCount> listeners_;
+
+  /**
+   * @brief Listeners of any other event name, only reachable through JS emit()
+   */
+  std::unordered_map<std::string, std::vector<Napi::FunctionReference>> customListeners_;
 
   /**
    * @brief Current BLE adapter state
@@ -180,9 +724,193 @@ private:
   bool scanning_;
 
   /**
-   * @brief Manufacturer data for device discovery
+   * @brief Current advertising payload, held inline (owned; released in the destructor)
+   */
+  ghostmesh::ble::AdvertisingBuffer *advertisingData_;
+
+  /**
+   * @brief Manufacturer data that does not fit a legacy PDU, forwarded as-is
    */
   Napi::Reference<Napi::Value> manufacturerData_;
+
+  /**
+   * @brief Batched platform-thread event delivery (owned by its ThreadSafeFunction)
+   */
+  ghostmesh::ble::PlatformEventDispatcher *dispatcher_;
+
+  /**
+   * @brief Native radio, or null for the loopback backend
+   *
+   * Shared with in-flight PlatformOperations so a pool thread never sees it
+   * freed. Its callbacks post through dispatcher_, so they are detached
+   * before the dispatcher is closed.
+   */
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform_;
+
+  /**
+   * @brief Native payload rotation, created by the first scheduleAdvertisement()
+   *
+   * Its timer thread posts through dispatcher_, so it is reset before the
+   * dispatcher is closed.
+   */
+  std::unique_ptr<ghostmesh::ble::AdvertisingScheduler> scheduler_;
+
+  /**
+   * @brief Extended advertising sets, in creation order
+   */
+  std::vector<AdvertisingSet> advertisingSets_;
+
+  /**
+   * @brief ID handed to the next advertising set (never reused)
+   */
+  uint32_t nextAdvertisingSetId_;
+
+  /**
+   * @brief Rotation period from AdvertisingOptions::interval
+   */
+  uint32_t advertisingIntervalMs_;
+
+  /**
+   * @brief Packed `devicesDiscovered` batching, non-null while a batched scan is active
+   */
+  ghostmesh::ble::DiscoveryBatcher *batcher_;
+
+  /**
+   * @brief Service UUIDs this adapter advertises (loopback discovery)
+   */
+  std::vector<std::string> serviceUUIDs_;
+
+  /**
+   * @brief Manufacturer / service filter; shared with platform-thread callbacks
+   */
+  std::shared_ptr<ghostmesh::ble::ScanFilter> scanFilter_;
+
+  /**
+   * @brief Scan-side duplicate suppression; shared with platform-thread callbacks
+   */
+  std::shared_ptr<ghostmesh::ble::DuplicateFilter> duplicateFilter_;
+
+  /**
+   * @brief Per-peer signal statistics; shared with platform-thread callbacks
+   *
+   * Fed by every report that passes the scan filters, duplicates included,
+   * so packet rates count what was actually received.
+   */
+  std::shared_ptr<ghostmesh::ble::LinkQualityTable> linkQuality_;
+
+  /**
+   * @brief Counters and histograms; shared with platform-thread callbacks and the scheduler sink
+   */
+  std::shared_ptr<ghostmesh::ble::AdapterStats> stats_;
+
+  /**
+   * @brief `peerAdded` / `peerLost` tracking, created by the first `trackPeers` scan
+   *
+   * Outlives the scan so peers still time out once it stops; released by destroy().
+   */
+  ghostmesh::ble::PeerMonitor *peers_;
+
+  /**
+   * @brief Whether the current scan feeds peers_
+   */
+  bool trackPeers_;
+
+  /**
+   * @brief Native reassembler, non-null while an `assembleMesh` scan is active
+   */
+  std::unique_ptr<ghostmesh::mesh::MessageAssembler> assembler_;
+
+  /**
+   * @brief Company ID that identifies GhostMesh packets for `assembleMesh`
+   */
+  uint16_t meshCompanyId_;
+
+  /**
+   * @brief Software scan window timer, created by the first duty-cycled scan
+   *
+   * Used for adaptive scans and on radios without supportsScanDutyCycle; a
+   * fixed duty cycle on a capable radio is programmed into the controller
+   * instead. Posts through dispatcher_, so it is reset before the dispatcher
+   * is closed.
+   */
+  std::unique_ptr<ghostmesh::ble::ScanDutyCycler> scanCycler_;
+
+  /**
+   * @struct ScanWindow
+   * @brief The software-gated window in progress and what it has seen
+   */
+  struct ScanWindow
+  {
+    bool cycling;        ///< scanCycler_ gates the current scan
+    bool open;           ///< The radio should be listening
+    uint64_t openedUs;   ///< StatsNowUs() when the window opened
+    uint32_t gapMs;      ///< Time not listening before this window
+    uint32_t peersAdded; ///< `peerAdded` events in this window
+    uint32_t messages;   ///< Mesh messages completed in this window
+    uint32_t reports;    ///< Reports delivered in this window
+  };
+
+  ScanWindow scanWindow_;
+
+  /**
+   * @brief Options the platform radio is restarted with when a window or scan slot opens
+   */
+  ghostmesh::ble::ScanOptions platformScanOptions_;
+
+  /**
+   * @brief Options the platform advertisement is restarted with in an advertise slot
+   *
+   * The payload is taken from advertisingData_ at the time, so rotations
+   * made during a scan slot go on air with the next advertise slot.
+   */
+  ghostmesh::ble::AdvertisingOptions platformAdvertisingOptions_;
+
+  /**
+   * @brief Platform starts and stops in flight, user-requested or SyncPlatformRadio()'s
+   */
+  uint32_t radioOps_;
+
+  /**
+   * @brief Loopback: subscribed to the medium
+   */
+  bool listening_;
+
+  /**
+   * @brief False if advertising and scanning must take turns on the radio
+   */
+  bool simultaneousAdvScan_;
+
+  /**
+   * @brief Advertise slot plus scan slot, from the `coexistenceCycleMs` constructor option
+   */
+  uint32_t coexistenceCycleMs_;
+
+  /**
+   * @brief Slot owner while arbitrating, Shared otherwise
+   */
+  RadioSlot radioSlot_;
+
+  /**
+   * @brief True while OpenPlatformInBackground() has Initialize() in flight
+   */
+  bool initializing_;
+
+  /**
+   * @brief Time slicing of advertising and scanning, created on first contention
+   *
+   * Posts through dispatcher_, so it is reset before the dispatcher is closed.
+   */
+  std::unique_ptr<ghostmesh::ble::CoexistenceArbiter> arbiter_;
+
+  /**
+   * @brief Writer of the attached discovery ring; every flushed batch is published to it
+   */
+  ghostmesh::ble::DiscoveryRingWriter discoveryRing_;
+
+  /**
+   * @brief Keeps the ring's memory alive while attached, and is what Atomics.notify() wakes readers on
+   */
+  Napi::Reference<Napi::Int32Array> discoveryRingView_;
 };
 
 #endif // NATIVE_BLE_BLE_ADAPTER_H
@@ -0,0 +1,568 @@
+/**
+ * @file ble_adapter_platform.cc
+ * @brief BLEAdapter delegation to the compiled-in IBLEPlatform backend
+ *
+ * Each radio operation runs on the libuv pool through PlatformOperation. The
+ * adapter's flags are reserved before the call, so a second call is rejected
+ * while the first is in flight, and rolled back if the platform fails. The
+ * adapter holds a reference to its JS object until the operation settles.
+ */
+
+#include "ble_adapter.h"
+
+#include <optional>
+
+// Create and initialize the backend; 'auto' falls back to loopback on any failure
+bool BLEAdapter::OpenPlatform(bool required)
+{
+  std::unique_ptr<ghostmesh::ble::IBLEPlatform> platform;
+  try
+  {
+    platform = ghostmesh::ble::CreateBLEPlatform();
+    platform->Initialize();
+  }
+  catch (const ghostmesh::ble::BLEError &error)
+  {
+    ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Error>(ghostmesh::ble::TraceEvent::Error, traceId_,
+                                                             static_cast<uint64_t>(error.code));
+    // No backend in this build
+    if (!platform)
+    {
+      if (required)
+        throw;
+      return false;
+    }
+    if (!required)
+      return false;
+    // Kept so JS sees why (e.g. "unauthorized") instead of a radio it did not ask for
+  }
+
+  AttachPlatform(std::move(platform));
+  return true;
+}
+
+// As OpenPlatform(), but Initialize() (HCI socket setup, or CoreBluetooth / WinRT
+// start-up) runs on the pool so a cold start is not held up by the radio
+Napi::Value BLEAdapter::OpenPlatformInBackground(Napi::Env env, bool required)
+{
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform;
+  try
+  {
+    platform = ghostmesh::ble::CreateBLEPlatform();
+  }
+  catch (const ghostmesh::ble::BLEError &error)
+  {
+    // No backend in this build
+    ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Error>(ghostmesh::ble::TraceEvent::Error, traceId_,
+                                                             static_cast<uint64_t>(error.code));
+    if (required)
+      throw;
+    return Napi::Value();
+  }
+
+  initializing_ = true;
+  this->state_ = State::Unknown;
+  std::shared_ptr<std::optional<ghostmesh::ble::BLEError>> failure =
+      std::make_shared<std::optional<ghostmesh::ble::BLEError>>();
+  Ref();
+  Napi::Promise promise = ghostmesh::ble::PlatformOperation::Start(
+      env, [platform, failure](ghostmesh::ble::SuccessCallback done)
+      {
+        try
+        {
+          platform->Initialize();
+        }
+        catch (const ghostmesh::ble::BLEError &error)
+        {
+          *failure = error;
+          throw;
+        }
+        done();
+      },
+      [this, platform, failure, required](Napi::Env env, bool succeeded)
+      {
+        initializing_ = false;
+        if (dispatcher_ == nullptr)
+        {
+          // destroy() ran meanwhile; nothing else will shut the radio down
+          if (succeeded)
+          {
+            Napi::Promise shutdown = ghostmesh::ble::PlatformOperation::Start(
+                env, [platform](ghostmesh::ble::SuccessCallback done)
+                {
+                  platform->Shutdown();
+                  done();
+                });
+            shutdown.Get("catch").As<Napi::Function>().Call(
+                shutdown, {Napi::Function::New(env, [](const Napi::CallbackInfo &) {})});
+          }
+          Unref();
+          return;
+        }
+
+        if (failure->has_value())
+        {
+          ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Error>(ghostmesh::ble::TraceEvent::Error, traceId_,
+                                                                   static_cast<uint64_t>((*failure)->code));
+        }
+        if (succeeded || required)
+        {
+          AttachPlatform(platform);
+        }
+        else
+        {
+          this->state_ = State::PoweredOn;
+          addon_->Medium().Register(this);
+        }
+        std::vector<napi_value> a = {Napi::String::New(env, CurrentStateName())};
+        this->EmitEvent(env, ghostmesh::ble::AdapterEvent::StateChange, a);
+        // 'platform' keeps a backend that failed, as OpenPlatform() does; say why
+        if (!succeeded && required && failure->has_value())
+        {
+          EmitPlatformError(env, **failure);
+        }
+        Unref();
+      });
+
+  // Settles either way: the outcome is the state it leaves behind, not a rejection nobody awaits
+  Napi::Function settle = Napi::Function::New(env, [](const Napi::CallbackInfo &) {});
+  return promise.Get("then").As<Napi::Function>().Call(promise, {settle, settle});
+}
+
+// Installed after Initialize() so a failed 'auto' probe never posts to this adapter;
+// GetState() below covers any change in between
+void BLEAdapter::AttachPlatform(std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform)
+{
+  ghostmesh::ble::PlatformEventDispatcher *dispatcher = dispatcher_;
+  platform->SetStateChangeCallback(PlatformStateChangeCallback());
+  platform->SetDeviceDiscoveredCallback(PlatformDeviceDiscoveredCallback());
+  platform->SetErrorCallback([dispatcher](const ghostmesh::ble::BLEError &error)
+                             { dispatcher->PostError(error); });
+  platform_ = std::move(platform);
+  this->state_ = ToState(platform_->GetState());
+  if (!platform_->GetCapabilities().supportsSimultaneousAdvScan)
+  {
+    simultaneousAdvScan_ = false;
+  }
+}
+
+// Destructor path: destroy() has not run, so the platform is still open
+void BLEAdapter::ClosePlatform()
+{
+  // destroy() already queued the shutdown
+  if (!platform_ || dispatcher_ == nullptr)
+    return;
+  DetachPlatformCallbacks();
+  try
+  {
+    platform_->Shutdown();
+  }
+  catch (const ghostmesh::ble::BLEError &)
+  {
+  }
+}
+
+// Callbacks capture dispatcher_ by pointer; none may run once it is closed
+void BLEAdapter::DetachPlatformCallbacks()
+{
+  if (!platform_)
+    return;
+  platform_->SetStateChangeCallback(nullptr);
+  platform_->SetDeviceDiscoveredCallback(nullptr);
+  platform_->SetErrorCallback(nullptr);
+}
+
+// Start advertising on the platform radio
+Napi::Value BLEAdapter::StartPlatformAdvertising(Napi::Env env, Napi::Object opts)
+{
+  if (dispatcher_ == nullptr)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Adapter has been destroyed"), "INVALID_STATE");
+  }
+
+  ghostmesh::ble::AdvertisingOptions options;
+  Napi::Value data = opts.Get("manufacturerData");
+  if (data.IsBuffer())
+  {
+    Napi::Buffer<uint8_t> buf = data.As<Napi::Buffer<uint8_t>>();
+    options.manufacturerData.assign(buf.Data(), buf.Data() + buf.Length());
+  }
+  else if (!data.IsUndefined())
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::TypeError::New(env, "Expected manufacturerData buffer"),
+                                           "INVALID_PARAMETER");
+  }
+  if (opts.Has("name") && opts.Get("name").IsString())
+  {
+    options.name = opts.Get("name").As<Napi::String>().Utf8Value();
+  }
+  options.serviceUUIDs = StringArray(opts.Get("serviceUUIDs"));
+  if (opts.Has("interval") && opts.Get("interval").IsNumber())
+  {
+    advertisingIntervalMs_ = opts.Get("interval").As<Napi::Number>().Uint32Value();
+  }
+  options.intervalMs = advertisingIntervalMs_;
+  if (opts.Has("txPowerLevel") && opts.Get("txPowerLevel").IsNumber())
+  {
+    options.txPowerLevel = static_cast<int8_t>(opts.Get("txPowerLevel").As<Napi::Number>().Int32Value());
+  }
+
+  if (data.IsBuffer())
+  {
+    SetAdvertisingData(data);
+  }
+  serviceUUIDs_ = options.serviceUUIDs;
+  platformAdvertisingOptions_ = options;
+  this->advertising_ = true;
+  // A radio busy scanning goes on air with the arbiter's first advertise slot
+  bool deferred = RadioContended();
+
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  ++radioOps_;
+  Ref();
+  return ghostmesh::ble::PlatformOperation::Start(
+      env, [platform, options, deferred](ghostmesh::ble::SuccessCallback done)
+      {
+        if (deferred)
+          done();
+        else
+          platform->StartAdvertising(options, done);
+      },
+      [this](Napi::Env env, bool succeeded)
+      {
+        --radioOps_;
+        if (!succeeded)
+        {
+          this->advertising_ = false;
+          ClearAdvertisingData();
+        }
+        else if (this->advertising_)
+        {
+          ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::AdvertisingStarted,
+                                                                  traceId_);
+          this->EmitEvent(env, ghostmesh::ble::AdapterEvent::AdvertisingStarted, {});
+          // Queued payloads take over from the initial data on the next tick
+          if (scheduler_)
+          {
+            scheduler_->Start(advertisingIntervalMs_);
+          }
+        }
+        if (dispatcher_ != nullptr)
+        {
+          UpdateArbitration(env);
+        }
+        Unref();
+      });
+}
+
+// Replace the platform advertisement's payload
+Napi::Value BLEAdapter::UpdatePlatformAdvertisingData(Napi::Env env, Napi::Value data)
+{
+  if (dispatcher_ == nullptr)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Adapter has been destroyed"), "INVALID_STATE");
+  }
+  if (!data.IsBuffer())
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::TypeError::New(env, "Expected buffer data"), "INVALID_PARAMETER");
+  }
+
+  // Legacy PDU only; larger payloads go through advertising sets
+  Napi::Buffer<uint8_t> buf = data.As<Napi::Buffer<uint8_t>>();
+  ghostmesh::ble::AdvertisingData payload;
+  if (!payload.Assign(buf.Data(), buf.Length()))
+  {
+    return ghostmesh::ble::RejectedPromise(
+        env, Napi::RangeError::New(env, "Advertising data is limited to 31 bytes"), "INVALID_PARAMETER");
+  }
+  SetAdvertisingData(data);
+
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  Ref();
+  return ghostmesh::ble::PlatformOperation::Start(
+      env, [platform, payload](ghostmesh::ble::SuccessCallback done)
+      {
+        // Off air for a scan slot: the next advertise slot starts with this payload
+        if (platform->IsAdvertising())
+          platform->UpdateAdvertisingData(payload, done);
+        else
+          done();
+      },
+      [this, payload](Napi::Env env, bool succeeded)
+      {
+        if (succeeded)
+        {
+          // A copy of what went on air; the caller's Buffer may have changed since
+          std::vector<napi_value> a = {Napi::Buffer<uint8_t>::Copy(env, payload.data(), payload.size())};
+          this->EmitEvent(env, ghostmesh::ble::AdapterEvent::AdvertisingDataUpdated, a);
+        }
+        Unref();
+      });
+}
+
+// Stop the platform advertisement
+Napi::Value BLEAdapter::StopPlatformAdvertising(Napi::Env env)
+{
+  if (dispatcher_ == nullptr)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Adapter has been destroyed"), "INVALID_STATE");
+  }
+
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  ++radioOps_;
+  Ref();
+  return ghostmesh::ble::PlatformOperation::Start(
+      env, [platform](ghostmesh::ble::SuccessCallback done)
+      { platform->StopAdvertising(done); },
+      [this](Napi::Env env, bool succeeded)
+      {
+        --radioOps_;
+        // On failure the radio is still advertising, so the flags stay as they are
+        if (succeeded)
+        {
+          this->advertising_ = false;
+          if (scheduler_)
+          {
+            scheduler_->Stop();
+          }
+          ClearAdvertisingData();
+          ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::AdvertisingStopped,
+                                                                  traceId_);
+          this->EmitEvent(env, ghostmesh::ble::AdapterEvent::AdvertisingStopped, {});
+        }
+        if (dispatcher_ != nullptr)
+        {
+          UpdateArbitration(env);
+        }
+        Unref();
+      });
+}
+
+// Start scanning on the platform radio; reports arrive through dispatcher_
+Napi::Value BLEAdapter::StartPlatformScanning(Napi::Env env, Napi::Value options)
+{
+  if (dispatcher_ == nullptr)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Adapter has been destroyed"), "INVALID_STATE");
+  }
+
+  // The filters are shared with the discovery callback, so they apply on the platform thread
+  ghostmesh::ble::ScanOptions scan = ConfigureScanFilters(options);
+  ConfigureScanDelivery(env, options);
+  this->scanning_ = true;
+
+  // A fixed duty cycle the controller can run itself costs no wake-ups here;
+  // anything else is gated in software once the first window is on
+  ghostmesh::ble::ScanDutyConfig duty = ParseScanDutyCycle(options);
+  bool software = false;
+  if (!duty.Continuous())
+  {
+    if (!duty.adaptive && platform_->GetCapabilities().supportsScanDutyCycle)
+    {
+      scan.windowMs = duty.windowMs;
+      scan.intervalMs = duty.intervalMs;
+    }
+    else
+    {
+      software = true;
+    }
+  }
+  platformScanOptions_ = scan;
+  // A radio busy advertising starts listening with the arbiter's first scan slot
+  bool deferred = RadioContended();
+
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  ++radioOps_;
+  Ref();
+  return ghostmesh::ble::PlatformOperation::Start(
+      env, [platform, scan, deferred](ghostmesh::ble::SuccessCallback done)
+      {
+        if (deferred)
+          done();
+        else
+          platform->StartScanning(scan, done);
+      },
+      [this, software, duty](Napi::Env env, bool succeeded)
+      {
+        --radioOps_;
+        if (!succeeded)
+        {
+          this->scanning_ = false;
+          EndScanDelivery();
+        }
+        else if (this->scanning_)
+        {
+          ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::ScanningStarted,
+                                                                  traceId_);
+          this->EmitEvent(env, ghostmesh::ble::AdapterEvent::ScanningStarted, {});
+          if (software && dispatcher_ != nullptr)
+          {
+            StartScanDutyCycle(duty);
+          }
+        }
+        if (dispatcher_ != nullptr)
+        {
+          UpdateArbitration(env);
+        }
+        Unref();
+      });
+}
+
+// Stop scanning on the platform radio
+Napi::Value BLEAdapter::StopPlatformScanning(Napi::Env env)
+{
+  if (dispatcher_ == nullptr)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Adapter has been destroyed"), "INVALID_STATE");
+  }
+
+  // No window may reopen the radio behind this stop
+  StopScanDutyCycle();
+
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  ++radioOps_;
+  Ref();
+  return ghostmesh::ble::PlatformOperation::Start(
+      env, [platform](ghostmesh::ble::SuccessCallback done)
+      { platform->StopScanning(done); },
+      [this](Napi::Env env, bool succeeded)
+      {
+        --radioOps_;
+        if (succeeded)
+        {
+          // Deliver whatever the current window collected before reporting the stop
+          EndScanDelivery();
+          this->scanning_ = false;
+          ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::ScanningStopped,
+                                                                  traceId_);
+          this->EmitEvent(env, ghostmesh::ble::AdapterEvent::ScanningStopped, {});
+        }
+        if (dispatcher_ != nullptr)
+        {
+          UpdateArbitration(env);
+        }
+        Unref();
+      });
+}
+
+// Duty cycle windows and radio slots: start or stop the radio to match ShouldListen() / ShouldRadiate()
+void BLEAdapter::SyncPlatformRadio(Napi::Env env)
+{
+  if (radioOps_ > 0 || dispatcher_ == nullptr)
+    return;
+
+  enum class Step
+  {
+    StopScan,
+    StopAdvertising,
+    StartScan,
+    StartAdvertising
+  };
+  bool listen = ShouldListen();
+  bool radiate = ShouldRadiate();
+  Step step;
+  if (!listen && platform_->IsScanning())
+    step = Step::StopScan;
+  else if (!radiate && platform_->IsAdvertising())
+    step = Step::StopAdvertising;
+  else if (listen && !platform_->IsScanning())
+    step = Step::StartScan;
+  else if (radiate && !platform_->IsAdvertising())
+    step = Step::StartAdvertising;
+  else
+    return;
+
+  ghostmesh::ble::ScanOptions scan = platformScanOptions_;
+  ghostmesh::ble::AdvertisingOptions advertising = platformAdvertisingOptions_;
+  if (advertisingData_->Assigned())
+  {
+    // Whatever the rotation has reached, not the payload advertising started with
+    const ghostmesh::ble::AdvertisingData &current = advertisingData_->Current();
+    advertising.manufacturerData.assign(current.data(), current.data() + current.size());
+  }
+
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  ++radioOps_;
+  Ref();
+  Napi::Promise promise = ghostmesh::ble::PlatformOperation::Start(
+      env, [platform, step, scan, advertising](ghostmesh::ble::SuccessCallback done)
+      {
+        switch (step)
+        {
+        case Step::StopScan:
+          platform->StopScanning(done);
+          break;
+        case Step::StopAdvertising:
+          platform->StopAdvertising(done);
+          break;
+        case Step::StartScan:
+          platform->StartScanning(scan, done);
+          break;
+        case Step::StartAdvertising:
+          platform->StartAdvertising(advertising, done);
+          break;
+        }
+      },
+      [this, step](Napi::Env env, bool succeeded)
+      {
+        --radioOps_;
+        if (!succeeded)
+        {
+          bool scanStep = step == Step::StopScan || step == Step::StartScan;
+          EmitPlatformError(env, ghostmesh::ble::BLEError(scanStep ? ghostmesh::ble::BLEError::Code::SCANNING_FAILED
+                                                                   : ghostmesh::ble::BLEError::Code::ADVERTISING_FAILED,
+                                                          scanStep ? "Could not hand the radio to the scanner"
+                                                                   : "Could not hand the radio to the advertiser"));
+        }
+        else
+        {
+          // Catch up with edges (or a stop) that passed while this ran
+          SyncPlatformRadio(env);
+        }
+        Unref();
+      });
+  // Reported through `error` above; nobody awaits this promise
+  promise.Get("catch").As<Napi::Function>().Call(promise, {Napi::Function::New(env, [](const Napi::CallbackInfo &) {})});
+}
+
+// destroy(): the callbacks are already detached; Shutdown() joins platform threads, so it runs on the pool
+Napi::Value BLEAdapter::ShutdownPlatform(Napi::Env env)
+{
+  std::shared_ptr<ghostmesh::ble::IBLEPlatform> platform = platform_;
+  return ghostmesh::ble::PlatformOperation::Start(
+      env, [platform](ghostmesh::ble::SuccessCallback done)
+      {
+        platform->Shutdown();
+        done();
+      });
+}
+
+// Advertising set calls hand back a handle synchronously, so they run on the JS thread
+uint8_t BLEAdapter::StartPlatformAdvertisingSet(const uint8_t *data, size_t length,
+                                                const std::vector<std::string> &serviceUUIDs)
+{
+  ghostmesh::ble::AdvertisingOptions options;
+  options.manufacturerData.assign(data, data + length);
+  options.serviceUUIDs = serviceUUIDs;
+  options.intervalMs = advertisingIntervalMs_;
+  return platform_->StartAdvertisingSet(options, nullptr);
+}
+
+void BLEAdapter::UpdatePlatformAdvertisingSet(uint8_t handle, const uint8_t *data, size_t length)
+{
+  platform_->UpdateAdvertisingSet(handle, std::vector<uint8_t>(data, data + length), nullptr);
+}
+
+void BLEAdapter::StopPlatformAdvertisingSet(uint8_t handle)
+{
+  platform_->StopAdvertisingSet(handle, nullptr);
+}
+
+// Platform failures reach JS as `error` with the same `code` a rejected operation carries
+void BLEAdapter::EmitPlatformError(Napi::Env env, const ghostmesh::ble::BLEError &error)
+{
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Error>(ghostmesh::ble::TraceEvent::Error, traceId_,
+                                                           static_cast<uint64_t>(error.code));
+  std::vector<napi_value> a = {ghostmesh::ble::PlatformError(env, error).Value()};
+  this->EmitEvent(env, ghostmesh::ble::AdapterEvent::Error, a);
+}
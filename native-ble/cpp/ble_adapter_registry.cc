@@ -1,25 +1,59 @@
 #include "ble_adapter.h"
 
-// Define static registry
-std::unordered_map<std::string, BLEAdapter *> BLEAdapter::adapters_;
+#include <algorithm>
 
-BLEAdapter *BLEAdapter::GetAdapter(const std::string &id)
+BLEAdapter *BLEAdapter::GetAdapter(Napi::Env env, const std::string &id)
 {
-  auto it = adapters_.find(id);
-  if (it == adapters_.end())
+  std::unordered_map<std::string, BLEAdapter *> &adapters = AddonInstance::Of(env).Adapters();
+  auto it = adapters.find(id);
+  if (it == adapters.end())
     return nullptr;
   return it->second;
 }
 
-// Destructor: ensure adapter is unregistered from global registry
+// Destructor: ensure adapter is unregistered from the environment's registry
 BLEAdapter::~BLEAdapter()
 {
-  if (!adapterId_.empty())
+  // Join the timer threads and detach the platform before the dispatcher they post to goes away
+  scheduler_.reset();
+  scanCycler_.reset();
+  arbiter_.reset();
+  ClosePlatform();
+  CloseDispatcher();
+  CloseBatcher();
+  ClosePeers();
+  discoveryRing_.Detach();
+  addon_->Medium().Unregister(this);
+  // Outlives the adapter while scanners still hold views of it
+  advertisingData_->Release();
+  LeaveRegistry();
+}
+
+// Drop out of the registry once (destroy() or GC); the stats move to the retired totals
+void BLEAdapter::LeaveRegistry()
+{
+  if (adapterId_.empty())
+    return;
+  std::unordered_map<std::string, BLEAdapter *> &adapters = addon_->Adapters();
+  auto it = adapters.find(adapterId_);
+  if (it != adapters.end() && it->second == this)
+  {
+    adapters.erase(it);
+    stats_->Accumulate(addon_->RetiredStats().data());
+  }
+}
+
+// Retired totals plus every live adapter of the environment
+Napi::Value BLEAdapter::ProcessStats(Napi::Env env)
+{
+  AddonInstance &addon = AddonInstance::Of(env);
+  Napi::Float64Array out = Napi::Float64Array::New(env, ghostmesh::ble::kStatsSnapshotSize);
+  double *data = out.Data();
+  std::copy(addon.RetiredStats().begin(), addon.RetiredStats().end(), data);
+  data[0] = ghostmesh::ble::kStatsLayoutVersion;
+  for (const auto &entry : addon.Adapters())
   {
-    auto it = adapters_.find(adapterId_);
-    if (it != adapters_.end() && it->second == this)
-    {
-      adapters_.erase(it);
-    }
+    entry.second->stats_->Accumulate(data);
   }
+  return out;
 }
@@ -0,0 +1,127 @@
+/**
+ * @file coexistence_arbiter.cc
+ * @brief Implementation of advertise / scan time slicing
+ */
+
+#include "coexistence_arbiter.h"
+
+#include <algorithm>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    uint32_t AdvertiseSlotMs(uint32_t cycleMs, uint32_t advertisingWeight)
+    {
+      cycleMs = std::max(cycleMs, 2 * kMinRadioSlotMs);
+      uint64_t weight = std::max<uint32_t>(advertisingWeight, 1);
+      uint64_t slot = uint64_t(cycleMs) * weight / (weight + kScanSlotWeight);
+      slot = std::min<uint64_t>(std::max<uint64_t>(slot, cycleMs / 5), uint64_t(cycleMs) * 4 / 5);
+      slot = std::min<uint64_t>(std::max<uint64_t>(slot, kMinRadioSlotMs), cycleMs - kMinRadioSlotMs);
+      return static_cast<uint32_t>(slot);
+    }
+
+    CoexistenceArbiter::CoexistenceArbiter(Sink sink)
+        : sink_(std::move(sink)), cycleMs_(kDefaultCoexistenceCycleMs), weight_(1), advertiseMs_(0), running_(false),
+          advertising_(false), exiting_(false)
+    {
+    }
+
+    CoexistenceArbiter::~CoexistenceArbiter()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exiting_ = true;
+      }
+      wake_.notify_one();
+      if (thread_.joinable())
+        thread_.join();
+    }
+
+    void CoexistenceArbiter::Start(uint32_t cycleMs, uint32_t advertisingWeight)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cycleMs_ = std::max(cycleMs, 2 * kMinRadioSlotMs);
+        weight_ = std::max<uint32_t>(advertisingWeight, 1);
+        running_ = true;
+        advertising_ = false;
+        nextEdge_ = Clock::now();
+        if (!thread_.joinable())
+          thread_ = std::thread(&CoexistenceArbiter::Run, this);
+      }
+      wake_.notify_one();
+    }
+
+    void CoexistenceArbiter::Stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+      }
+      wake_.notify_one();
+    }
+
+    void CoexistenceArbiter::SetAdvertisingWeight(uint32_t weight)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      weight_ = std::max<uint32_t>(weight, 1);
+    }
+
+    bool CoexistenceArbiter::Running() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return running_;
+    }
+
+    // Timer thread: an advertise slot, then a scan slot, per cycle
+    void CoexistenceArbiter::Run()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!exiting_)
+      {
+        if (!running_)
+        {
+          wake_.wait(lock, [this]
+                     { return exiting_ || running_; });
+          continue;
+        }
+
+        const Clock::time_point edge = nextEdge_;
+        const Clock::time_point now = Clock::now();
+        if (now < edge)
+        {
+          // Re-check on any wake-up (stop, restart, exit)
+          wake_.wait_until(lock, edge);
+          continue;
+        }
+
+        RadioSlotEvent event;
+        event.lateUs = static_cast<uint32_t>(
+            std::min<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - edge).count(), UINT32_MAX));
+        if (advertising_)
+        {
+          event.kind = RadioSlotEvent::Kind::Scan;
+          event.slotMs = cycleMs_ - advertiseMs_;
+          advertising_ = false;
+          nextEdge_ = std::max(cycleStart_ + std::chrono::milliseconds(cycleMs_), now);
+        }
+        else
+        {
+          event.kind = RadioSlotEvent::Kind::Advertise;
+          advertiseMs_ = AdvertiseSlotMs(cycleMs_, weight_);
+          event.slotMs = advertiseMs_;
+          advertising_ = true;
+          cycleStart_ = now;
+          nextEdge_ = now + std::chrono::milliseconds(advertiseMs_);
+        }
+
+        lock.unlock();
+        sink_(event);
+        lock.lock();
+      }
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,125 @@
+#ifndef NATIVE_BLE_COEXISTENCE_ARBITER_H
+#define NATIVE_BLE_COEXISTENCE_ARBITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file coexistence_arbiter.h
+ * @brief Time slicing of one radio between advertising and scanning
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @brief Airtime claim of the scanner, in the units of AdvertisingScheduler::Weight()
+     *
+     * Equal to one TEXT payload (priority 1), so a text message splits the
+     * cycle evenly and an SOS (priority 3) takes two thirds of it.
+     */
+    constexpr uint32_t kScanSlotWeight = 2;
+
+    constexpr uint32_t kMinRadioSlotMs = 20; ///< Shortest slot, so a burst or window is never empty
+    constexpr uint32_t kDefaultCoexistenceCycleMs = 300;
+
+    /**
+     * @brief Advertising share of one cycle for a given advertising weight
+     *
+     * weight / (weight + kScanSlotWeight) of the cycle, held between 1/5 and
+     * 4/5 so neither side is starved, and at least kMinRadioSlotMs each way.
+     * @param cycleMs Length of an advertise slot plus a scan slot
+     * @param advertisingWeight Claim of the advertiser (at least 1 while advertising)
+     * @return Advertise slot length in ms
+     */
+    uint32_t AdvertiseSlotMs(uint32_t cycleMs, uint32_t advertisingWeight);
+
+    /**
+     * @struct RadioSlotEvent
+     * @brief Output of the arbiter: who owns the radio next
+     */
+    struct RadioSlotEvent
+    {
+      enum class Kind
+      {
+        Advertise, ///< Stop listening, put the advertisement on air
+        Scan       ///< Take the advertisement off air, listen
+      };
+
+      Kind kind;
+      uint32_t slotMs; ///< Length of the slot that begins
+      uint32_t lateUs; ///< How far the timer ran behind the slot boundary
+    };
+
+    /**
+     * @class CoexistenceArbiter
+     * @brief Alternates advertise and scan slots on its own thread
+     *
+     * Each cycle starts with an advertise slot sized by AdvertiseSlotMs() for
+     * the weight at that moment, followed by a scan slot for the rest of the
+     * cycle. SetAdvertisingWeight() takes effect at the next cycle. Events
+     * go to the sink on the timer thread, outside the lock; after a stall
+     * the next slot starts from now rather than catching up.
+     */
+    class CoexistenceArbiter
+    {
+    public:
+      using Sink = std::function<void(const RadioSlotEvent &event)>;
+
+      explicit CoexistenceArbiter(Sink sink);
+
+      /**
+       * @brief Stops and joins the timer thread
+       */
+      ~CoexistenceArbiter();
+
+      CoexistenceArbiter(const CoexistenceArbiter &) = delete;
+      CoexistenceArbiter &operator=(const CoexistenceArbiter &) = delete;
+
+      /**
+       * @brief Start slicing, beginning with an advertise slot (restarts if running)
+       */
+      void Start(uint32_t cycleMs, uint32_t advertisingWeight);
+
+      /**
+       * @brief Stop slicing; the slot in progress ends without an event
+       */
+      void Stop();
+
+      /**
+       * @brief Update the advertiser's claim (AdvertisingScheduler::Weight(), at least 1)
+       */
+      void SetAdvertisingWeight(uint32_t weight);
+
+      bool Running() const;
+
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      void Run();
+
+      Sink sink_;
+      uint32_t cycleMs_;
+      uint32_t weight_;
+      uint32_t advertiseMs_; ///< Advertise slot of the cycle in progress
+      Clock::time_point cycleStart_;
+      Clock::time_point nextEdge_;
+
+      mutable std::mutex mutex_;
+      std::condition_variable wake_;
+      std::thread thread_;
+      bool running_;
+      bool advertising_; ///< The slot in progress is an advertise slot
+      bool exiting_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_COEXISTENCE_ARBITER_H
@@ -0,0 +1,219 @@
+/**
+ * @file dedup_cache.cc
+ * @brief Implementation of the time-bucketed duplicate cache
+ */
+
+#include "dedup_cache.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      inline uint64_t SpanFor(uint32_t windowMs, size_t bucketCount)
+      {
+        // N-1 full spans always cover the window; the Nth is the one filling up
+        uint64_t slices = bucketCount - 1;
+        return std::max<uint64_t>(1, (static_cast<uint64_t>(windowMs) + slices - 1) / slices);
+      }
+    } // namespace
+
+    uint64_t HashBytes64(const void *data, size_t length, uint64_t seed)
+    {
+      const uint8_t *bytes = static_cast<const uint8_t *>(data);
+      uint64_t hash = seed;
+      for (size_t i = 0; i < length; ++i)
+      {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+      }
+      return hash;
+    }
+
+    TimeBucketedSet::TimeBucketedSet(uint32_t windowMs, size_t capacity, size_t bucketCount)
+        : epoch_(0), overflow_(0)
+    {
+      bucketCount = std::max<size_t>(2, bucketCount);
+      size_t perBucket = std::max<size_t>(4, (capacity + bucketCount - 2) / (bucketCount - 1));
+
+      spanMs_ = SpanFor(windowMs, bucketCount);
+      bucketCapacity_ = RoundUpPow2(perBucket + perBucket / 3 + 1);
+      bucketMask_ = bucketCapacity_ - 1;
+      bucketLimit_ = bucketCapacity_ - bucketCapacity_ / 4;
+      buckets_.assign(bucketCount, Bucket{0, 0});
+      keys_.assign(bucketCount * bucketCapacity_, 0);
+    }
+
+    // Rotate the ring so the bucket for `nowMs` is current and empty of stale keys
+    void TimeBucketedSet::Advance(uint64_t nowMs)
+    {
+      uint64_t epoch = nowMs / spanMs_;
+      // A clock that steps backwards keeps writing into the newest bucket
+      if (epoch > epoch_)
+        epoch_ = epoch;
+
+      size_t current = static_cast<size_t>(epoch_ % buckets_.size());
+      if (buckets_[current].epoch != epoch_)
+      {
+        ClearBucket(current);
+        buckets_[current].epoch = epoch_;
+      }
+    }
+
+    bool TimeBucketedSet::Live(const Bucket &bucket) const
+    {
+      return bucket.count > 0 && bucket.epoch + buckets_.size() > epoch_;
+    }
+
+    bool TimeBucketedSet::BucketContains(size_t bucket, uint64_t key) const
+    {
+      const uint64_t *slots = &keys_[bucket * bucketCapacity_];
+      size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & bucketMask_;
+      for (size_t probes = 0; probes <= bucketMask_; ++probes)
+      {
+        if (slots[i] == key)
+          return true;
+        if (slots[i] == 0)
+          return false;
+        i = (i + 1) & bucketMask_;
+      }
+      return false;
+    }
+
+    void TimeBucketedSet::ClearBucket(size_t bucket)
+    {
+      if (buckets_[bucket].count == 0)
+        return;
+      std::fill_n(keys_.begin() + static_cast<std::ptrdiff_t>(bucket * bucketCapacity_), bucketCapacity_, 0);
+      buckets_[bucket].count = 0;
+    }
+
+    bool TimeBucketedSet::CheckAndInsert(uint64_t key, uint64_t nowMs)
+    {
+      if (key == 0)
+        key = 1;
+      Advance(nowMs);
+
+      for (size_t b = 0; b < buckets_.size(); ++b)
+      {
+        if (Live(buckets_[b]) && BucketContains(b, key))
+          return true;
+      }
+
+      size_t current = static_cast<size_t>(epoch_ % buckets_.size());
+      Bucket &bucket = buckets_[current];
+      if (bucket.count >= bucketLimit_)
+      {
+        ++overflow_;
+        return false;
+      }
+
+      uint64_t *slots = &keys_[current * bucketCapacity_];
+      size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & bucketMask_;
+      while (slots[i] != 0)
+        i = (i + 1) & bucketMask_;
+      slots[i] = key;
+      ++bucket.count;
+      return false;
+    }
+
+    bool TimeBucketedSet::Contains(uint64_t key, uint64_t nowMs)
+    {
+      if (key == 0)
+        key = 1;
+      Advance(nowMs);
+
+      for (size_t b = 0; b < buckets_.size(); ++b)
+      {
+        if (Live(buckets_[b]) && BucketContains(b, key))
+          return true;
+      }
+      return false;
+    }
+
+    void TimeBucketedSet::Expire(uint64_t olderThanMs, uint64_t nowMs)
+    {
+      Advance(nowMs);
+      if (olderThanMs >= nowMs)
+        return;
+
+      uint64_t cutoff = nowMs - olderThanMs;
+      for (size_t b = 0; b < buckets_.size(); ++b)
+      {
+        // Every key in a bucket was inserted before the end of its span
+        if (Live(buckets_[b]) && (buckets_[b].epoch + 1) * spanMs_ <= cutoff)
+          ClearBucket(b);
+      }
+    }
+
+    void TimeBucketedSet::Clear()
+    {
+      std::fill(keys_.begin(), keys_.end(), 0);
+      for (auto &bucket : buckets_)
+      {
+        bucket.count = 0;
+      }
+    }
+
+    void TimeBucketedSet::SetWindow(uint32_t windowMs)
+    {
+      spanMs_ = SpanFor(windowMs, buckets_.size());
+      epoch_ = 0;
+      for (auto &bucket : buckets_)
+      {
+        bucket.epoch = 0;
+      }
+      Clear();
+    }
+
+    size_t TimeBucketedSet::Size(uint64_t nowMs)
+    {
+      Advance(nowMs);
+
+      size_t total = 0;
+      for (const auto &bucket : buckets_)
+      {
+        if (Live(bucket))
+          total += bucket.count;
+      }
+      return total;
+    }
+
+    DuplicateFilter::DuplicateFilter()
+        : enabled_(false), suppressed_(0), set_(1000, kCapacity)
+    {
+    }
+
+    void DuplicateFilter::Configure(bool allowDuplicates, uint32_t timeoutMs)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      set_.SetWindow(timeoutMs);
+      suppressed_.store(0, std::memory_order_relaxed);
+      enabled_.store(!allowDuplicates && timeoutMs > 0, std::memory_order_release);
+    }
+
+    bool DuplicateFilter::IsDuplicate(const std::string &address, const uint8_t *data, size_t length)
+    {
+      if (!enabled_.load(std::memory_order_acquire))
+        return false;
+
+      uint64_t key = HashBytes64(data, length, HashBytes64(address.data(), address.size()));
+      uint64_t nowMs = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now().time_since_epoch())
+              .count());
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!set_.CheckAndInsert(key, nowMs))
+        return false;
+      suppressed_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,174 @@
+#ifndef NATIVE_BLE_DEDUP_CACHE_H
+#define NATIVE_BLE_DEDUP_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file dedup_cache.h
+ * @brief Fixed-memory, time-bucketed duplicate cache
+ *
+ * Backs both the scan-side duplicate filter (ScanOptions::allowDuplicates /
+ * duplicateTimeoutMs) and the MessageIdSet exported to the mesh layer.
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @brief 64-bit FNV-1a hash
+     * @param data Bytes to hash
+     * @param length Number of bytes
+     * @param seed Running hash, to chain several fields into one key
+     */
+    uint64_t HashBytes64(const void *data, size_t length, uint64_t seed = 0xcbf29ce484222325ull);
+
+    /**
+     * @brief Smallest power of two >= n, for sizing open-addressed tables
+     */
+    inline size_t RoundUpPow2(size_t n)
+    {
+      size_t p = 1;
+      while (p < n)
+        p <<= 1;
+      return p;
+    }
+
+    /**
+     * @class TimeBucketedSet
+     * @brief Set of 64-bit keys that forgets entries after a time window
+     *
+     * The window is split into a ring of buckets, each an open-addressing table
+     * allocated once at construction. Inserts always go to the bucket for the
+     * current time slice; lookups probe every bucket still inside the window.
+     * When the ring wraps, the oldest bucket is wiped wholesale, so expiry costs
+     * nothing per key and memory never grows.
+     *
+     * A key is remembered for at least `windowMs` and at most one bucket span
+     * longer. If the current bucket fills up, new keys are let through (and
+     * counted) rather than evicting anything still inside the window.
+     *
+     * Not thread-safe; callers that share an instance across threads must lock.
+     */
+    class TimeBucketedSet
+    {
+    public:
+      /**
+       * @param windowMs How long a key is remembered
+       * @param capacity Expected number of distinct keys per window
+       * @param bucketCount Ring size (at least 2)
+       */
+      TimeBucketedSet(uint32_t windowMs, size_t capacity, size_t bucketCount = 8);
+
+      /**
+       * @brief Record a key, reporting whether it was already present
+       * @param key Key to test and insert
+       * @param nowMs Current time in milliseconds (any monotonic origin)
+       * @return true if the key was seen inside the window (it is not refreshed)
+       */
+      bool CheckAndInsert(uint64_t key, uint64_t nowMs);
+
+      /**
+       * @brief Test for a key without inserting it
+       */
+      bool Contains(uint64_t key, uint64_t nowMs);
+
+      /**
+       * @brief Drop every bucket whose newest possible entry is older than `olderThanMs`
+       */
+      void Expire(uint64_t olderThanMs, uint64_t nowMs);
+
+      /**
+       * @brief Forget every key
+       */
+      void Clear();
+
+      /**
+       * @brief Change the window; clears the set
+       */
+      void SetWindow(uint32_t windowMs);
+
+      /**
+       * @brief Number of keys currently inside the window
+       */
+      size_t Size(uint64_t nowMs);
+
+      /**
+       * @brief Number of keys let through because their bucket was full
+       */
+      uint64_t OverflowCount() const { return overflow_; }
+
+    private:
+      struct Bucket
+      {
+        uint64_t epoch;
+        size_t count;
+      };
+
+      void Advance(uint64_t nowMs);
+      bool Live(const Bucket &bucket) const;
+      bool BucketContains(size_t bucket, uint64_t key) const;
+      void ClearBucket(size_t bucket);
+
+      uint64_t spanMs_;
+      size_t bucketCapacity_; ///< Slots per bucket, power of two
+      size_t bucketMask_;
+      size_t bucketLimit_;    ///< Keys per bucket before overflow (75% load)
+      uint64_t epoch_;
+      uint64_t overflow_;
+      std::vector<Bucket> buckets_;
+      std::vector<uint64_t> keys_; ///< bucketCount * bucketCapacity, 0 = empty
+    };
+
+    /**
+     * @class DuplicateFilter
+     * @brief Scan-side suppression of identical advertisements
+     *
+     * Keyed on the advertiser address mixed with a hash of its manufacturer
+     * data, so a device that changes its payload is reported again right away.
+     * Configured on the JS thread by StartScanning; IsDuplicate() may be called
+     * from platform threads, before an event is queued for N-API.
+     */
+    class DuplicateFilter
+    {
+    public:
+      DuplicateFilter();
+
+      /**
+       * @brief Apply the scan options and forget previous reports
+       * @param allowDuplicates true disables filtering
+       * @param timeoutMs Suppression window (ScanOptions::duplicateTimeoutMs)
+       */
+      void Configure(bool allowDuplicates, uint32_t timeoutMs);
+
+      /**
+       * @brief Record an advertisement (any thread)
+       * @return true if an identical report was seen within the window
+       */
+      bool IsDuplicate(const std::string &address, const uint8_t *data, size_t length);
+
+      /**
+       * @brief Number of advertisements suppressed since the last Configure()
+       */
+      uint64_t SuppressedCount() const { return suppressed_.load(std::memory_order_relaxed); }
+
+    private:
+      static constexpr size_t kCapacity = 4096;
+
+      std::mutex mutex_;
+      std::atomic<bool> enabled_;
+      std::atomic<uint64_t> suppressed_;
+      TimeBucketedSet set_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_DEDUP_CACHE_H
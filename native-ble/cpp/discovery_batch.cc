@@ -0,0 +1,153 @@
+/**
+ * @file discovery_batch.cc
+ * @brief Implementation of packed discovery batching
+ */
+
+#include "discovery_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    uint32_t HashAddress(const std::string &address)
+    {
+      uint32_t hash = 2166136261u;
+      for (unsigned char c : address)
+      {
+        hash ^= c;
+        hash *= 16777619u;
+      }
+      return hash;
+    }
+
+    DiscoveryBatcher::DiscoveryBatcher(napi_env env, uint32_t intervalMs, FlushHandler handler)
+        : env_(env), intervalMs_(intervalMs), handler_(std::move(handler)), asyncContext_(nullptr),
+          armed_(false), closed_(false)
+    {
+      records_.reserve(kMaxRecords);
+      flushing_.reserve(kMaxRecords);
+
+      uv_loop_t *loop = nullptr;
+      napi_get_uv_event_loop(env_, &loop);
+      uv_timer_init(loop, &timer_);
+      timer_.data = this;
+      // A pending batch must not keep the process alive
+      uv_unref(reinterpret_cast<uv_handle_t *>(&timer_));
+
+      Napi::Object resource = Napi::Object::New(env_);
+      napi_async_init(env_, resource, Napi::String::New(env_, "GhostMeshDiscoveryBatch"), &asyncContext_);
+    }
+
+    DiscoveryBatcher *DiscoveryBatcher::Create(Napi::Env env, uint32_t intervalMs, FlushHandler handler)
+    {
+      return new DiscoveryBatcher(env, intervalMs, std::move(handler));
+    }
+
+    void DiscoveryBatcher::Append(uint32_t addressHash, int16_t rssi, uint64_t timestampMs,
+                                  const uint8_t *data, size_t length)
+    {
+      if (closed_)
+        return;
+
+      PackedDiscoveryRecord record{};
+      record.addressHash = addressHash;
+      record.rssi = rssi;
+      record.timestamp = static_cast<double>(timestampMs);
+      size_t n = std::min(length, kPackedManufacturerDataMax);
+      record.dataLength = static_cast<uint8_t>(n);
+      if (n > 0)
+      {
+        std::memcpy(record.manufacturerData, data, n);
+      }
+      records_.push_back(record);
+
+      if (records_.size() >= kMaxRecords)
+      {
+        Flush();
+        return;
+      }
+      if (!armed_)
+      {
+        uv_timer_start(&timer_, OnTimer, intervalMs_, 0);
+        armed_ = true;
+      }
+    }
+
+    void DiscoveryBatcher::Append(const DiscoveredDevice &device)
+    {
+      Append(HashAddress(device.address), device.rssi, device.timestamp,
+             device.manufacturerData.data(), device.manufacturerData.size());
+    }
+
+    void DiscoveryBatcher::Flush()
+    {
+      if (armed_)
+      {
+        uv_timer_stop(&timer_);
+        armed_ = false;
+      }
+      if (closed_ || records_.empty())
+        return;
+      if (!flushing_.empty())
+      {
+        // Re-entered from a listener: leave the records for the next window
+        uv_timer_start(&timer_, OnTimer, intervalMs_, 0);
+        armed_ = true;
+        return;
+      }
+
+      // Swap out first so listeners may append (or close us) while we deliver
+      flushing_.swap(records_);
+      handler_(Napi::Env(env_), reinterpret_cast<const uint8_t *>(flushing_.data()), flushing_.size());
+      flushing_.clear();
+    }
+
+    void DiscoveryBatcher::OnTimer(uv_timer_t *handle)
+    {
+      auto *self = static_cast<DiscoveryBatcher *>(handle->data);
+      self->armed_ = false;
+      if (self->closed_)
+        return;
+
+      napi_env env = self->env_;
+      Napi::HandleScope scope(env);
+      Napi::Object resource = Napi::Object::New(env);
+      napi_callback_scope callbackScope;
+      napi_open_callback_scope(env, resource, self->asyncContext_, &callbackScope);
+
+      self->Flush();
+
+      bool pending = false;
+      napi_is_exception_pending(env, &pending);
+      if (pending)
+      {
+        // Surface listener errors as uncaught exceptions, as a normal emit would
+        napi_value error;
+        napi_get_and_clear_last_exception(env, &error);
+        napi_fatal_exception(env, error);
+      }
+      napi_close_callback_scope(env, callbackScope);
+    }
+
+    void DiscoveryBatcher::Close()
+    {
+      if (closed_)
+        return;
+      closed_ = true;
+      records_.clear();
+      uv_timer_stop(&timer_);
+      // The async context may still be in use by an open callback scope, so it
+      // is destroyed together with the object once libuv releases the handle
+      uv_close(reinterpret_cast<uv_handle_t *>(&timer_), [](uv_handle_t *handle)
+               {
+                 auto *self = static_cast<DiscoveryBatcher *>(handle->data);
+                 napi_async_destroy(self->env_, self->asyncContext_);
+                 delete self; });
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
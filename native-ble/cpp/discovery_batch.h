@@ -0,0 +1,150 @@
+#ifndef NATIVE_BLE_DISCOVERY_BATCH_H
+#define NATIVE_BLE_DISCOVERY_BATCH_H
+
+#include <napi.h>
+#include <uv.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../binding/platform/ble_platform.h"
+
+/**
+ * @file discovery_batch.h
+ * @brief Packed fixed-stride discovery records for the `devicesDiscovered` event
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @brief Maximum manufacturer data bytes carried per packed record
+     */
+    constexpr size_t kPackedManufacturerDataMax = 31;
+
+    /**
+     * @struct PackedDiscoveryRecord
+     * @brief One advertisement in a `devicesDiscovered` buffer
+     *
+     * Written in host byte order; every supported target is little-endian,
+     * which is what the TypeScript DiscoveryBatch accessor reads.
+     *
+     * | Offset | Size | Field                          |
+     * | ------ | ---- | ------------------------------ |
+     * | 0      | 4    | addressHash (FNV-1a of address)|
+     * | 4      | 2    | rssi (int16, dBm)              |
+     * | 6      | 1    | manufacturerData length        |
+     * | 7      | 1    | flags (reserved, 0)            |
+     * | 8      | 8    | timestamp (float64, ms epoch)  |
+     * | 16     | 31   | manufacturerData (zero padded) |
+     * | 47     | 1    | reserved                       |
+     */
+    struct PackedDiscoveryRecord
+    {
+      uint32_t addressHash;
+      int16_t rssi;
+      uint8_t dataLength;
+      uint8_t flags;
+      double timestamp;
+      uint8_t manufacturerData[kPackedManufacturerDataMax];
+      uint8_t reserved;
+    };
+
+    static_assert(sizeof(PackedDiscoveryRecord) == 48, "PackedDiscoveryRecord stride must stay 48 bytes");
+    static_assert(offsetof(PackedDiscoveryRecord, timestamp) == 8, "timestamp must be 8-byte aligned");
+    static_assert(offsetof(PackedDiscoveryRecord, manufacturerData) == 16, "payload offset is part of the JS ABI");
+
+    constexpr size_t kPackedRecordStride = sizeof(PackedDiscoveryRecord);
+
+    /**
+     * @brief 32-bit FNV-1a hash of a device address
+     * @param address Platform address string
+     * @return Stable hash used as the record's device key
+     */
+    uint32_t HashAddress(const std::string &address);
+
+    /**
+     * @class DiscoveryBatcher
+     * @brief Accumulates discoveries and flushes them as one packed buffer
+     *
+     * Runs entirely on the JS thread. The first record of a window arms a libuv
+     * timer for the flush interval; when it fires (or the buffer fills) the
+     * handler receives every record collected so far. Like the dispatcher it is
+     * created with Create() and self-destructs after Close(), once libuv has
+     * released the timer handle.
+     */
+    class DiscoveryBatcher
+    {
+    public:
+      /**
+       * @brief Flush handler, invoked on the JS thread inside a HandleScope
+       */
+      using FlushHandler = std::function<void(Napi::Env env, const uint8_t *records, size_t count)>;
+
+      /**
+       * @brief Upper bound on records per flush; a full buffer flushes early
+       */
+      static constexpr size_t kMaxRecords = 512;
+
+      /**
+       * @brief Create a batcher on the calling environment's event loop
+       * @param env N-API environment (JS thread only)
+       * @param intervalMs Flush interval in milliseconds (0 = next loop iteration)
+       * @param handler Receives each flushed batch
+       */
+      static DiscoveryBatcher *Create(Napi::Env env, uint32_t intervalMs, FlushHandler handler);
+
+      /**
+       * @brief Change the flush interval for subsequent windows
+       */
+      void SetInterval(uint32_t intervalMs) { intervalMs_ = intervalMs; }
+
+      /**
+       * @brief Append one record
+       * @param addressHash HashAddress() of the advertiser
+       * @param rssi Signal strength in dBm
+       * @param timestampMs Discovery time (ms since epoch)
+       * @param data Manufacturer data (truncated to 31 bytes)
+       * @param length Manufacturer data length
+       */
+      void Append(uint32_t addressHash, int16_t rssi, uint64_t timestampMs, const uint8_t *data, size_t length);
+
+      /**
+       * @brief Append a platform device report
+       */
+      void Append(const DiscoveredDevice &device);
+
+      /**
+       * @brief Deliver pending records now and disarm the timer
+       */
+      void Flush();
+
+      /**
+       * @brief Discard pending records and free the batcher asynchronously
+       */
+      void Close();
+
+    private:
+      DiscoveryBatcher(napi_env env, uint32_t intervalMs, FlushHandler handler);
+
+      static void OnTimer(uv_timer_t *handle);
+
+      napi_env env_;
+      uint32_t intervalMs_;
+      FlushHandler handler_;
+      uv_timer_t timer_;
+      napi_async_context asyncContext_;
+      std::vector<PackedDiscoveryRecord> records_;
+      std::vector<PackedDiscoveryRecord> flushing_;
+      bool armed_;
+      bool closed_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_DISCOVERY_BATCH_H
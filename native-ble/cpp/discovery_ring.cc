@@ -0,0 +1,105 @@
+/**
+ * @file discovery_ring.cc
+ * @brief Implementation of the shared discovery ring writer
+ */
+
+#include "discovery_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      constexpr uint32_t kWriterToken = 1;
+
+      static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+                    "header words are shared with JS Atomics on the same memory");
+    } // namespace
+
+    DiscoveryRingWriter::DiscoveryRingWriter(size_t stride)
+        : stride_(stride), memory_(nullptr), capacity_(0), sequence_(0)
+    {
+    }
+
+    DiscoveryRingWriter::~DiscoveryRingWriter()
+    {
+      Detach();
+    }
+
+    std::atomic<uint32_t> &DiscoveryRingWriter::Word(DiscoveryRingWord word) const
+    {
+      return reinterpret_cast<std::atomic<uint32_t> *>(memory_)[static_cast<size_t>(word)];
+    }
+
+    DiscoveryRingWriter::AttachResult DiscoveryRingWriter::Attach(uint8_t *memory, size_t length)
+    {
+      Detach();
+      if (memory == nullptr || reinterpret_cast<uintptr_t>(memory) % alignof(uint32_t) != 0 ||
+          length < kDiscoveryRingHeaderSize)
+        return AttachResult::Invalid;
+
+      memory_ = memory;
+      uint32_t capacity = Word(DiscoveryRingWord::Capacity).load(std::memory_order_relaxed);
+      bool valid = Word(DiscoveryRingWord::Magic).load(std::memory_order_relaxed) == kDiscoveryRingMagic &&
+                   Word(DiscoveryRingWord::Version).load(std::memory_order_relaxed) == kDiscoveryRingVersion &&
+                   Word(DiscoveryRingWord::Stride).load(std::memory_order_relaxed) == stride_ && capacity != 0 &&
+                   (capacity & (capacity - 1)) == 0 && DiscoveryRingSize(capacity, stride_) <= length;
+      uint32_t free = 0;
+      if (!valid || !Word(DiscoveryRingWord::Producer).compare_exchange_strong(free, kWriterToken,
+                                                                               std::memory_order_acq_rel))
+      {
+        memory_ = nullptr;
+        return valid ? AttachResult::Busy : AttachResult::Invalid;
+      }
+
+      // Carry on from the last writer, so existing readers see one continuous stream
+      capacity_ = capacity;
+      sequence_ = Word(DiscoveryRingWord::Published).load(std::memory_order_acquire);
+      Word(DiscoveryRingWord::Claimed).store(sequence_, std::memory_order_relaxed);
+      return AttachResult::Attached;
+    }
+
+    void DiscoveryRingWriter::Detach()
+    {
+      if (memory_ == nullptr)
+        return;
+      Word(DiscoveryRingWord::Producer).store(0, std::memory_order_release);
+      memory_ = nullptr;
+      capacity_ = 0;
+    }
+
+    // Seqlock writer: raise Claimed, write, raise Published
+    void DiscoveryRingWriter::Publish(const uint8_t *records, size_t count)
+    {
+      if (memory_ == nullptr || count == 0)
+        return;
+      if (count > capacity_)
+      {
+        // The older records would be overwritten by the newer ones anyway
+        size_t skip = count - capacity_;
+        records += skip * stride_;
+        sequence_ += static_cast<uint32_t>(skip);
+        count = capacity_;
+      }
+
+      uint32_t end = sequence_ + static_cast<uint32_t>(count);
+      Word(DiscoveryRingWord::Claimed).store(end, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      uint8_t *slots = memory_ + kDiscoveryRingHeaderSize;
+      size_t first = sequence_ & (capacity_ - 1);
+      size_t head = std::min(count, static_cast<size_t>(capacity_) - first);
+      std::memcpy(slots + first * stride_, records, head * stride_);
+      std::memcpy(slots, records + head * stride_, (count - head) * stride_);
+
+      Word(DiscoveryRingWord::Published).store(end, std::memory_order_release);
+      sequence_ = end;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,119 @@
+#ifndef NATIVE_BLE_DISCOVERY_RING_H
+#define NATIVE_BLE_DISCOVERY_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file discovery_ring.h
+ * @brief Single-producer ring of packed discovery records in shared memory
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    constexpr uint32_t kDiscoveryRingMagic = 0x52444D47; ///< "GMDR", little-endian
+    constexpr uint32_t kDiscoveryRingVersion = 1;
+
+    /**
+     * @brief Bytes before the first record; one cache line of int32 header words
+     */
+    constexpr size_t kDiscoveryRingHeaderSize = 64;
+
+    /**
+     * @enum DiscoveryRingWord
+     * @brief Index of each int32 header word, shared with src/discovery-ring.ts
+     *
+     * Claimed and Published count records ever written, modulo 2^32. Record
+     * `n` lives in slot `n % Capacity`, so it is intact to a reader for as
+     * long as Claimed - n <= Capacity.
+     */
+    enum class DiscoveryRingWord : size_t
+    {
+      Magic = 0,
+      Version = 1,
+      Capacity = 2,  ///< Records; a power of two
+      Stride = 3,    ///< Bytes per record (kPackedRecordStride)
+      Claimed = 4,   ///< Raised before records are written
+      Published = 5, ///< Raised once they are; readers Atomics.wait() on it
+      Producer = 6   ///< Non-zero while a writer is attached
+    };
+
+    /**
+     * @brief Bytes a ring of `capacity` records takes, header included
+     */
+    constexpr size_t DiscoveryRingSize(uint32_t capacity, size_t stride)
+    {
+      return kDiscoveryRingHeaderSize + static_cast<size_t>(capacity) * stride;
+    }
+
+    /**
+     * @class DiscoveryRingWriter
+     * @brief Publishes packed discovery records into a ring laid out by createDiscoveryRing()
+     *
+     * The memory is typically a SharedArrayBuffer that readers in other
+     * worker threads view directly, so a record is written once and read in
+     * place. Any number of readers each keep their own cursor; the writer
+     * never waits for them and a reader that falls a whole ring behind skips
+     * ahead. One writer per ring, across every thread of the process: the
+     * Producer word is claimed with a CAS in Attach().
+     */
+    class DiscoveryRingWriter
+    {
+    public:
+      enum class AttachResult
+      {
+        Attached,
+        Invalid, ///< Not a version-1 ring of this stride that fits `length`
+        Busy     ///< Another writer holds it
+      };
+
+      /**
+       * @param stride Bytes per record the rings must hold
+       */
+      explicit DiscoveryRingWriter(size_t stride);
+
+      /**
+       * @brief Releases the ring if still attached
+       */
+      ~DiscoveryRingWriter();
+
+      DiscoveryRingWriter(const DiscoveryRingWriter &) = delete;
+      DiscoveryRingWriter &operator=(const DiscoveryRingWriter &) = delete;
+
+      /**
+       * @brief Validate the header and become the ring's writer (detaches from any previous ring)
+       * @param memory Start of the ring, 4-byte aligned; must outlive the attachment
+       * @param length Bytes available at `memory`
+       */
+      AttachResult Attach(uint8_t *memory, size_t length);
+
+      /**
+       * @brief Give the ring up so another writer can take it
+       */
+      void Detach();
+
+      bool Attached() const { return memory_ != nullptr; }
+
+      /**
+       * @brief Append packed records; with more than a ring's worth, only the newest fit
+       * @param records `count` records of the writer's stride
+       */
+      void Publish(const uint8_t *records, size_t count);
+
+    private:
+      std::atomic<uint32_t> &Word(DiscoveryRingWord word) const;
+
+      size_t stride_;
+      uint8_t *memory_;
+      uint32_t capacity_;
+      uint32_t sequence_; ///< Published, as only this writer moves it
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_DISCOVERY_RING_H
@@ -0,0 +1,126 @@
+#ifndef NATIVE_BLE_EVENT_QUEUE_H
+#define NATIVE_BLE_EVENT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @file event_queue.h
+ * @brief Bounded lock-free multi-producer / single-consumer queue
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @class MpscQueue
+     * @brief Fixed-capacity lock-free queue for platform thread -> JS thread handoff
+     *
+     * Any number of platform threads may call TryPush() concurrently; only the
+     * JS thread calls TryPop(). Each slot carries a sequence number (Vyukov
+     * bounded queue) so producers claim slots with a single CAS and never block.
+     * Storage is allocated once, so the hot path performs no heap allocation
+     * beyond whatever moving `T` itself costs.
+     *
+     * @tparam T Element type (must be default constructible and movable)
+     * @tparam Capacity Number of slots, must be a power of two
+     */
+    template <typename T, size_t Capacity>
+    class MpscQueue
+    {
+      static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                    "MpscQueue capacity must be a power of two");
+
+    public:
+      MpscQueue() : enqueuePos_(0), dequeuePos_(0), dropped_(0)
+      {
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+          cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+      }
+
+      MpscQueue(const MpscQueue &) = delete;
+      MpscQueue &operator=(const MpscQueue &) = delete;
+
+      /**
+       * @brief Enqueue an element (any thread)
+       * @param value Element to move into the queue
+       * @return false if the queue is full; the element is dropped and counted
+       */
+      bool TryPush(T &&value)
+      {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;)
+        {
+          cell = &cells_[pos & kMask];
+          size_t seq = cell->sequence.load(std::memory_order_acquire);
+          intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+          if (diff == 0)
+          {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+          else if (diff < 0)
+          {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+          }
+          else
+          {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+          }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+
+      /**
+       * @brief Dequeue an element (consumer thread only)
+       * @param out Receives the element
+       * @return false if the queue is empty
+       */
+      bool TryPop(T &out)
+      {
+        Cell *cell = &cells_[dequeuePos_ & kMask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeuePos_ + 1) < 0)
+          return false;
+        out = std::move(cell->value);
+        cell->sequence.store(dequeuePos_ + Capacity, std::memory_order_release);
+        ++dequeuePos_;
+        return true;
+      }
+
+      /**
+       * @brief Number of elements rejected because the queue was full
+       */
+      uint64_t DroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+      static constexpr size_t capacity() { return Capacity; }
+
+    private:
+      static constexpr size_t kMask = Capacity - 1;
+
+      struct Cell
+      {
+        std::atomic<size_t> sequence;
+        T value;
+      };
+
+      Cell cells_[Capacity];
+      alignas(64) std::atomic<size_t> enqueuePos_;
+      alignas(64) size_t dequeuePos_;
+      std::atomic<uint64_t> dropped_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_EVENT_QUEUE_H
@@ -0,0 +1,217 @@
+/**
+ * @file link_quality.cc
+ * @brief Implementation of the per-peer link-quality table
+ */
+
+#include "link_quality.h"
+
+#include "dedup_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      inline int8_t ClampRssi(int16_t rssi)
+      {
+        return static_cast<int8_t>(std::min<int16_t>(127, std::max<int16_t>(-128, rssi)));
+      }
+
+      inline size_t RssiBin(int16_t rssi)
+      {
+        int bin = (static_cast<int>(rssi) - kRssiHistogramFloor) / kRssiHistogramBinWidth;
+        return static_cast<size_t>(std::min<int>(static_cast<int>(kRssiHistogramBins) - 1, std::max(0, bin)));
+      }
+    } // namespace
+
+    LinkQualityTable::LinkQualityTable(size_t capacity, float alpha, uint32_t rateWindowMs)
+        : capacity_(std::max<size_t>(1, capacity)), alpha_(std::min(1.0f, std::max(0.001f, alpha))),
+          rateWindowMs_(std::max<uint32_t>(1, rateWindowMs)), enabled_(false), evicted_(0), size_(0), indexMask_(0)
+    {
+    }
+
+    // Columns are only paid for by adapters that track link quality
+    void LinkQualityTable::Allocate()
+    {
+      if (!index_.empty())
+        return;
+      hash_.assign(capacity_, 0);
+      packets_.assign(capacity_, 0);
+      lastSeen_.assign(capacity_, 0);
+      ewmaRssi_.assign(capacity_, 0.0f);
+      windowStart_.assign(capacity_, 0);
+      windowCount_.assign(capacity_, 0);
+      rate_.assign(capacity_, 0.0f);
+      lastRssi_.assign(capacity_, 0);
+      minRssi_.assign(capacity_, 0);
+      maxRssi_.assign(capacity_, 0);
+      bins_.assign(capacity_ * kRssiHistogramBins, 0);
+      // At most 50% load, so probe runs stay short
+      index_.assign(RoundUpPow2(capacity_ * 2), kEmpty);
+      indexMask_ = index_.size() - 1;
+    }
+
+    void LinkQualityTable::SetEnabled(bool enabled)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (enabled)
+        Allocate();
+      enabled_.store(enabled, std::memory_order_release);
+    }
+
+    size_t LinkQualityTable::Home(uint32_t addressHash) const
+    {
+      // Fold the high bits down before masking so nearby hashes spread out
+      uint32_t h = addressHash ^ (addressHash >> 16);
+      h *= 0x45d9f3bu;
+      h ^= h >> 16;
+      return static_cast<size_t>(h) & indexMask_;
+    }
+
+    size_t LinkQualityTable::Find(uint32_t addressHash) const
+    {
+      for (size_t i = Home(addressHash);; i = (i + 1) & indexMask_)
+      {
+        uint32_t slot = index_[i];
+        if (slot == kEmpty)
+          return capacity_;
+        if (hash_[slot - 1] == addressHash)
+          return slot - 1;
+      }
+    }
+
+    // Claim a row for a new peer, evicting the least recently seen one when full
+    size_t LinkQualityTable::Insert(uint32_t addressHash)
+    {
+      size_t row;
+      if (size_ < capacity_)
+      {
+        row = size_++;
+      }
+      else
+      {
+        row = static_cast<size_t>(std::min_element(lastSeen_.begin(), lastSeen_.end()) - lastSeen_.begin());
+        EraseIndex(hash_[row]);
+        evicted_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      hash_[row] = addressHash;
+      size_t i = Home(addressHash);
+      while (index_[i] != kEmpty)
+        i = (i + 1) & indexMask_;
+      index_[i] = static_cast<uint32_t>(row + 1);
+      return row;
+    }
+
+    // Backward-shift deletion keeps every remaining key reachable from its home slot
+    void LinkQualityTable::EraseIndex(uint32_t addressHash)
+    {
+      size_t i = Home(addressHash);
+      while (hash_[index_[i] - 1] != addressHash)
+        i = (i + 1) & indexMask_;
+      index_[i] = kEmpty;
+
+      for (size_t j = (i + 1) & indexMask_; index_[j] != kEmpty; j = (j + 1) & indexMask_)
+      {
+        size_t home = Home(hash_[index_[j] - 1]);
+        // Entries whose home lies cyclically in (i, j] are still reachable
+        bool reachable = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (reachable)
+          continue;
+        index_[i] = index_[j];
+        index_[j] = kEmpty;
+        i = j;
+      }
+    }
+
+    void LinkQualityTable::Record(uint32_t addressHash, int16_t rssi, uint64_t timestampMs)
+    {
+      if (!enabled_.load(std::memory_order_acquire))
+        return;
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      int8_t sample = ClampRssi(rssi);
+      size_t row = Find(addressHash);
+      if (row == capacity_)
+      {
+        row = Insert(addressHash);
+        packets_[row] = 0;
+        lastSeen_[row] = 0;
+        ewmaRssi_[row] = sample;
+        windowStart_[row] = timestampMs;
+        windowCount_[row] = 0;
+        rate_[row] = 0.0f;
+        minRssi_[row] = sample;
+        maxRssi_[row] = sample;
+        std::memset(&bins_[row * kRssiHistogramBins], 0, kRssiHistogramBins * sizeof(uint16_t));
+      }
+
+      ++packets_[row];
+      lastSeen_[row] = std::max(lastSeen_[row], timestampMs);
+      ewmaRssi_[row] += alpha_ * (static_cast<float>(sample) - ewmaRssi_[row]);
+
+      // Reports may arrive slightly out of order across platform threads
+      uint64_t start = std::min(windowStart_[row], timestampMs);
+      if (timestampMs - start >= rateWindowMs_)
+      {
+        rate_[row] = static_cast<float>(windowCount_[row]) * 1000.0f / static_cast<float>(timestampMs - start);
+        start = timestampMs;
+        windowCount_[row] = 0;
+      }
+      windowStart_[row] = start;
+      ++windowCount_[row];
+
+      lastRssi_[row] = sample;
+      minRssi_[row] = std::min(minRssi_[row], sample);
+      maxRssi_[row] = std::max(maxRssi_[row], sample);
+      uint16_t &bin = bins_[row * kRssiHistogramBins + RssiBin(sample)];
+      if (bin != UINT16_MAX)
+        ++bin;
+    }
+
+    size_t LinkQualityTable::Size() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return size_;
+    }
+
+    size_t LinkQualityTable::Snapshot(PackedLinkQualityRecord *out, size_t max, uint64_t nowMs) const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_t count = std::min(size_, max);
+      for (size_t row = 0; row < count; ++row)
+      {
+        PackedLinkQualityRecord &record = out[row];
+        std::memset(&record, 0, sizeof(record));
+        record.addressHash = hash_[row];
+        record.packets = packets_[row];
+        record.lastSeen = static_cast<double>(lastSeen_[row]);
+        record.ewmaRssi = ewmaRssi_[row];
+        // A window that has run out is the latest measurement, so silent peers decay towards 0
+        uint64_t elapsed = nowMs > windowStart_[row] ? nowMs - windowStart_[row] : 0;
+        record.packetRate = elapsed >= rateWindowMs_
+                                ? static_cast<float>(windowCount_[row]) * 1000.0f / static_cast<float>(elapsed)
+                                : rate_[row];
+        record.lastRssi = lastRssi_[row];
+        record.minRssi = minRssi_[row];
+        record.maxRssi = maxRssi_[row];
+        std::memcpy(record.bins, &bins_[row * kRssiHistogramBins], sizeof(record.bins));
+      }
+      return count;
+    }
+
+    void LinkQualityTable::Clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_ = 0;
+      std::fill(index_.begin(), index_.end(), kEmpty);
+      std::fill(lastSeen_.begin(), lastSeen_.end(), 0);
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,182 @@
+#ifndef NATIVE_BLE_LINK_QUALITY_H
+#define NATIVE_BLE_LINK_QUALITY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file link_quality.h
+ * @brief Per-peer RSSI histograms, EWMA RSSI and packet rates
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @brief RSSI histogram bins per peer
+     */
+    constexpr size_t kRssiHistogramBins = 16;
+
+    /**
+     * @brief Lower edge of bin 0 in dBm; weaker reports land in bin 0
+     */
+    constexpr int kRssiHistogramFloor = -100;
+
+    /**
+     * @brief Width of one histogram bin in dBm; the last bin takes everything stronger
+     */
+    constexpr int kRssiHistogramBinWidth = 5;
+
+    /**
+     * @struct PackedLinkQualityRecord
+     * @brief One peer in a getLinkQuality() snapshot
+     *
+     * Written in host byte order (little-endian on every supported target),
+     * which is what the TypeScript LinkQualitySnapshot accessor reads.
+     *
+     * | Offset | Size | Field                                        |
+     * | ------ | ---- | -------------------------------------------- |
+     * | 0      | 4    | addressHash (FNV-1a of address)              |
+     * | 4      | 4    | packets (reports since first seen)           |
+     * | 8      | 8    | lastSeen (float64, ms epoch)                 |
+     * | 16     | 4    | ewmaRssi (float32, dBm)                      |
+     * | 20     | 4    | packetRate (float32, reports per second)     |
+     * | 24     | 1    | lastRssi (int8, dBm)                         |
+     * | 25     | 1    | minRssi (int8, dBm)                          |
+     * | 26     | 1    | maxRssi (int8, dBm)                          |
+     * | 27     | 1    | reserved                                     |
+     * | 28     | 32   | bins (16 x uint16, saturating report counts) |
+     * | 60     | 4    | reserved                                     |
+     */
+    struct PackedLinkQualityRecord
+    {
+      uint32_t addressHash;
+      uint32_t packets;
+      double lastSeen;
+      float ewmaRssi;
+      float packetRate;
+      int8_t lastRssi;
+      int8_t minRssi;
+      int8_t maxRssi;
+      uint8_t reserved;
+      uint16_t bins[kRssiHistogramBins];
+      uint32_t reserved2;
+    };
+
+    static_assert(sizeof(PackedLinkQualityRecord) == 64, "PackedLinkQualityRecord stride must stay 64 bytes");
+    static_assert(offsetof(PackedLinkQualityRecord, bins) == 28, "bin offset is part of the JS ABI");
+
+    constexpr size_t kLinkQualityRecordStride = sizeof(PackedLinkQualityRecord);
+
+    /**
+     * @class LinkQualityTable
+     * @brief Signal statistics for every advertiser heard, kept as a struct of arrays
+     *
+     * Each report touches one row: its EWMA, counters and histogram bin.
+     * Columns are separate arrays so Snapshot() and the eviction scan walk
+     * contiguous memory. Rows are found through an open-addressing index on
+     * the address hash; when the table is full the least recently seen peer
+     * is evicted.
+     *
+     * Storage is allocated on the first SetEnabled(true). Record() may be
+     * called from platform threads; all access is serialized by one mutex.
+     */
+    class LinkQualityTable
+    {
+    public:
+      /**
+       * @param capacity Peers tracked at once
+       * @param alpha EWMA weight of a new RSSI sample (0 < alpha <= 1)
+       * @param rateWindowMs Window over which packet rates are measured
+       */
+      explicit LinkQualityTable(size_t capacity = 256, float alpha = 0.125f, uint32_t rateWindowMs = 1000);
+
+      LinkQualityTable(const LinkQualityTable &) = delete;
+      LinkQualityTable &operator=(const LinkQualityTable &) = delete;
+
+      /**
+       * @brief Turn aggregation on or off; collected statistics are kept
+       */
+      void SetEnabled(bool enabled);
+
+      bool Enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+      /**
+       * @brief Account one report (any thread; no-op while disabled)
+       * @param addressHash HashAddress() of the advertiser
+       * @param rssi Signal strength in dBm
+       * @param timestampMs Report time (ms since epoch)
+       */
+      void Record(uint32_t addressHash, int16_t rssi, uint64_t timestampMs);
+
+      /**
+       * @brief Number of peers currently tracked
+       */
+      size_t Size() const;
+
+      /**
+       * @brief Copy every peer into packed records
+       * @param out Destination, room for `max` records
+       * @param max Records that fit in `out`
+       * @param nowMs Current time (ms since epoch), to close the open rate window
+       * @return Records written
+       */
+      size_t Snapshot(PackedLinkQualityRecord *out, size_t max, uint64_t nowMs) const;
+
+      /**
+       * @brief Forget every peer
+       */
+      void Clear();
+
+      /**
+       * @brief Peers evicted to make room since construction
+       */
+      uint64_t EvictedCount() const { return evicted_.load(std::memory_order_relaxed); }
+
+    private:
+      static constexpr uint32_t kEmpty = 0;
+
+      void Allocate();
+      size_t Find(uint32_t addressHash) const;
+      size_t Insert(uint32_t addressHash);
+      void EraseIndex(uint32_t addressHash);
+      size_t Home(uint32_t addressHash) const;
+
+      size_t capacity_;
+      float alpha_;
+      uint32_t rateWindowMs_;
+
+      mutable std::mutex mutex_;
+      std::atomic<bool> enabled_;
+      std::atomic<uint64_t> evicted_;
+      size_t size_;
+
+      // Columns, one row per peer (rows [0, size_) are live)
+      std::vector<uint32_t> hash_;
+      std::vector<uint32_t> packets_;
+      std::vector<uint64_t> lastSeen_;
+      std::vector<float> ewmaRssi_;
+      std::vector<uint64_t> windowStart_;
+      std::vector<uint32_t> windowCount_;
+      std::vector<float> rate_;
+      std::vector<int8_t> lastRssi_;
+      std::vector<int8_t> minRssi_;
+      std::vector<int8_t> maxRssi_;
+      std::vector<uint16_t> bins_; ///< capacity_ * kRssiHistogramBins
+
+      /**
+       * @brief Address hash -> row + 1 (kEmpty = free), power-of-two size, linear probing
+       */
+      std::vector<uint32_t> index_;
+      size_t indexMask_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_LINK_QUALITY_H
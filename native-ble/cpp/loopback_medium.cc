@@ -0,0 +1,168 @@
+/**
+ * @file loopback_medium.cc
+ * @brief Implementation of the in-process loopback medium
+ */
+
+#include "loopback_medium.h"
+
+#include "ble_adapter.h"
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    LoopbackFrame::LoopbackFrame(const std::string &address, AdvertisingBuffer *payload, Napi::Value manufacturerData,
+                                 const std::vector<std::string> &serviceUUIDs)
+        : address(address), payload(nullptr), manufacturerData(manufacturerData), data(nullptr), length(0),
+          serviceUUIDs(serviceUUIDs), pinnedSlot_(0)
+    {
+      if (payload != nullptr && payload->Assigned())
+      {
+        // Pinned so a re-entrant update cannot rewrite bytes later recipients read
+        this->payload = payload;
+        pinnedSlot_ = payload->Pin();
+        data = payload->Current().data();
+        length = payload->Current().size();
+      }
+      else if (!manufacturerData.IsEmpty() && manufacturerData.IsBuffer())
+      {
+        Napi::Buffer<uint8_t> buf = manufacturerData.As<Napi::Buffer<uint8_t>>();
+        data = buf.Data();
+        length = buf.Length();
+      }
+    }
+
+    LoopbackFrame::~LoopbackFrame()
+    {
+      if (payload != nullptr)
+        payload->Unpin(pinnedSlot_);
+    }
+
+    int32_t LoopbackFrame::CompanyId() const
+    {
+      if (data == nullptr || length < 2)
+        return -1;
+      return static_cast<int32_t>(data[0] | (data[1] << 8));
+    }
+
+    Napi::Object LoopbackFrame::DeviceObject(Napi::Env env)
+    {
+      if (!object_.IsEmpty())
+        return object_;
+
+      object_ = Napi::Object::New(env);
+      object_.Set("address", Napi::String::New(env, address));
+      if (payload != nullptr)
+      {
+        object_.Set("manufacturerData", payload->View(env, pinnedSlot_));
+      }
+      else if (!manufacturerData.IsEmpty() && !manufacturerData.IsUndefined())
+      {
+        object_.Set("manufacturerData", manufacturerData);
+      }
+      if (!serviceUUIDs.empty())
+      {
+        Napi::Array uuids = Napi::Array::New(env, serviceUUIDs.size());
+        for (size_t i = 0; i < serviceUUIDs.size(); ++i)
+        {
+          uuids.Set(static_cast<uint32_t>(i), Napi::String::New(env, serviceUUIDs[i]));
+        }
+        object_.Set("serviceUUIDs", uuids);
+      }
+      return object_;
+    }
+
+    bool LoopbackMedium::DenseList::Insert(BLEAdapter *adapter)
+    {
+      if (!index_.emplace(adapter, items_.size()).second)
+        return false;
+      items_.push_back(adapter);
+      return true;
+    }
+
+    bool LoopbackMedium::DenseList::Erase(BLEAdapter *adapter)
+    {
+      auto it = index_.find(adapter);
+      if (it == index_.end())
+        return false;
+      size_t slot = it->second;
+      index_.erase(it);
+      if (slot != items_.size() - 1)
+      {
+        items_[slot] = items_.back();
+        index_[items_[slot]] = slot;
+      }
+      items_.pop_back();
+      return true;
+    }
+
+    void LoopbackMedium::Register(BLEAdapter *adapter)
+    {
+      adapters_.Insert(adapter);
+    }
+
+    void LoopbackMedium::Unregister(BLEAdapter *adapter)
+    {
+      Unsubscribe(adapter);
+      advertisers_.Erase(adapter);
+      adapters_.Erase(adapter);
+    }
+
+    void LoopbackMedium::SetAdvertising(BLEAdapter *adapter, bool advertising)
+    {
+      if (advertising)
+        advertisers_.Insert(adapter);
+      else
+        advertisers_.Erase(adapter);
+    }
+
+    void LoopbackMedium::Subscribe(BLEAdapter *adapter, uint16_t companyFilter)
+    {
+      Unsubscribe(adapter);
+      scanners_[companyFilter].Insert(adapter);
+      filters_[adapter] = companyFilter;
+    }
+
+    void LoopbackMedium::Unsubscribe(BLEAdapter *adapter)
+    {
+      auto it = filters_.find(adapter);
+      if (it == filters_.end())
+        return;
+      scanners_[it->second].Erase(adapter);
+      filters_.erase(it);
+    }
+
+    void LoopbackMedium::Broadcast(Napi::Env env, const BLEAdapter *sender, LoopbackFrame &frame)
+    {
+      // Snapshot the recipients; reused buffers keep steady-state broadcasts allocation-free
+      if (snapshots_.size() <= depth_)
+        snapshots_.emplace_back();
+      std::vector<BLEAdapter *> &recipients = snapshots_[depth_];
+      recipients.clear();
+
+      int32_t companyId = frame.CompanyId();
+      if (companyId > 0)
+      {
+        auto bucket = scanners_.find(static_cast<uint16_t>(companyId));
+        if (bucket != scanners_.end())
+          recipients.insert(recipients.end(), bucket->second.Items().begin(), bucket->second.Items().end());
+      }
+      auto wildcard = scanners_.find(0);
+      if (wildcard != scanners_.end())
+        recipients.insert(recipients.end(), wildcard->second.Items().begin(), wildcard->second.Items().end());
+
+      // Nested broadcasts may grow snapshots_, so index it rather than holding `recipients`
+      size_t level = depth_++;
+      for (size_t i = 0; i < snapshots_[level].size(); ++i)
+      {
+        BLEAdapter *recipient = snapshots_[level][i];
+        // Skip scanners that stopped (or were destroyed) during an earlier delivery
+        if (recipient != sender && filters_.count(recipient) != 0)
+          recipient->ReceiveLoopback(env, frame);
+      }
+      --depth_;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,150 @@
+#ifndef NATIVE_BLE_LOOPBACK_MEDIUM_H
+#define NATIVE_BLE_LOOPBACK_MEDIUM_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "advertising_buffer.h"
+
+/**
+ * @file loopback_medium.h
+ * @brief In-process radio medium connecting loopback BLEAdapter instances
+ */
+
+class BLEAdapter;
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @struct LoopbackFrame
+     * @brief One advertisement on the loopback medium
+     *
+     * Built once per transmission and handed to every recipient. The
+     * `deviceDiscovered` object is created on first use and shared, so N
+     * scanners cost one allocation instead of N. When the payload lives in
+     * an AdvertisingBuffer, its `manufacturerData` is an external Buffer over
+     * the advertiser's inline bytes rather than a copy.
+     */
+    struct LoopbackFrame
+    {
+      /**
+       * @param address Advertiser address
+       * @param payload Inline payload, used when assigned (may be nullptr)
+       * @param manufacturerData JS value used otherwise (may be empty)
+       * @param serviceUUIDs Advertised service UUIDs
+       */
+      LoopbackFrame(const std::string &address, AdvertisingBuffer *payload, Napi::Value manufacturerData,
+                    const std::vector<std::string> &serviceUUIDs);
+      ~LoopbackFrame();
+
+      LoopbackFrame(const LoopbackFrame &) = delete;
+      LoopbackFrame &operator=(const LoopbackFrame &) = delete;
+
+      /**
+       * @brief Company ID from the first two manufacturer data bytes, or -1
+       */
+      int32_t CompanyId() const;
+
+      /**
+       * @brief Shared `deviceDiscovered` payload (built on first call)
+       */
+      Napi::Object DeviceObject(Napi::Env env);
+
+      const std::string &address;
+      AdvertisingBuffer *payload;           ///< nullptr unless the payload is inline
+      Napi::Value manufacturerData;         ///< May be empty
+      const uint8_t *data;                  ///< Raw manufacturer data, nullptr if none
+      size_t length;
+      const std::vector<std::string> &serviceUUIDs;
+
+    private:
+      size_t pinnedSlot_; ///< Payload slot held for the frame's lifetime
+      Napi::Object object_;
+    };
+
+    /**
+     * @class LoopbackMedium
+     * @brief Subscription index for in-process advertising and scanning
+     *
+     * Keeps dense vectors of registered adapters, advertisers, and scanners;
+     * scanners are bucketed by their company-ID filter (0 = wildcard). A
+     * transmission visits only the scanners whose bucket matches the frame's
+     * company ID plus the wildcard bucket, instead of every adapter in the
+     * process. Membership changes are O(1) (swap-and-pop).
+     *
+     * JS thread only: each environment has its own (AddonInstance::Medium()).
+     * Recipients are snapshotted before delivery, so listeners may start/stop
+     * scans or transmit re-entrantly.
+     */
+    class LoopbackMedium
+    {
+    public:
+      LoopbackMedium() : depth_(0) {}
+
+      LoopbackMedium(const LoopbackMedium &) = delete;
+      LoopbackMedium &operator=(const LoopbackMedium &) = delete;
+
+      void Register(BLEAdapter *adapter);
+
+      /**
+       * @brief Remove an adapter from every list
+       */
+      void Unregister(BLEAdapter *adapter);
+
+      /**
+       * @brief Mark an adapter as advertising (or not)
+       */
+      void SetAdvertising(BLEAdapter *adapter, bool advertising);
+
+      /**
+       * @brief Start delivering frames to a scanner
+       * @param adapter Scanning adapter
+       * @param companyFilter Company ID the scanner accepts (0 = any)
+       */
+      void Subscribe(BLEAdapter *adapter, uint16_t companyFilter);
+
+      void Unsubscribe(BLEAdapter *adapter);
+
+      /**
+       * @brief Deliver a frame to every matching scanner except the sender
+       */
+      void Broadcast(Napi::Env env, const BLEAdapter *sender, LoopbackFrame &frame);
+
+      const std::vector<BLEAdapter *> &Adapters() const { return adapters_.Items(); }
+      const std::vector<BLEAdapter *> &Advertisers() const { return advertisers_.Items(); }
+
+    private:
+      /**
+       * @brief Dense pointer list with O(1) insert, erase and membership
+       */
+      class DenseList
+      {
+      public:
+        bool Insert(BLEAdapter *adapter);
+        bool Erase(BLEAdapter *adapter);
+        const std::vector<BLEAdapter *> &Items() const { return items_; }
+
+      private:
+        std::vector<BLEAdapter *> items_;
+        std::unordered_map<BLEAdapter *, size_t> index_;
+      };
+
+      DenseList adapters_;
+      DenseList advertisers_;
+      std::unordered_map<uint16_t, DenseList> scanners_;    ///< Company filter -> scanners
+      std::unordered_map<BLEAdapter *, uint16_t> filters_; ///< Scanner -> its bucket
+      std::vector<std::vector<BLEAdapter *>> snapshots_;    ///< One per Broadcast nesting level
+      size_t depth_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_LOOPBACK_MEDIUM_H
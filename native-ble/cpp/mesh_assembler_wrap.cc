@@ -0,0 +1,150 @@
+/**
+ * @file mesh_assembler_wrap.cc
+ * @brief N-API binding for the native GhostMesh reassembler
+ */
+
+#include "mesh_assembler_wrap.h"
+
+#include <chrono>
+
+namespace
+{
+  // Wall-clock milliseconds, so callers can pass Date.now() instead
+  uint64_t NowMs()
+  {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+
+  uint64_t TimeArg(const Napi::CallbackInfo &info, size_t index)
+  {
+    if (info.Length() > index && info[index].IsNumber())
+    {
+      double ms = info[index].As<Napi::Number>().DoubleValue();
+      if (ms >= 0)
+        return static_cast<uint64_t>(ms);
+    }
+    return NowMs();
+  }
+
+  size_t CapacityArg(const Napi::CallbackInfo &info)
+  {
+    if (info.Length() > 0 && info[0].IsNumber())
+    {
+      uint32_t capacity = info[0].As<Napi::Number>().Uint32Value();
+      if (capacity > 0)
+        return capacity;
+    }
+    return 256;
+  }
+
+  size_t FragmentSizeArg(const Napi::CallbackInfo &info)
+  {
+    if (info.Length() > 1 && info[1].IsNumber())
+      return info[1].As<Napi::Number>().Uint32Value();
+    return ghostmesh::mesh::kMeshDataSize;
+  }
+
+  uint32_t TimeoutArg(const Napi::CallbackInfo &info)
+  {
+    if (info.Length() > 2 && info[2].IsNumber())
+    {
+      uint32_t timeoutMs = info[2].As<Napi::Number>().Uint32Value();
+      if (timeoutMs > 0)
+        return timeoutMs;
+    }
+    return 30000;
+  }
+} // namespace
+
+Napi::Object MeshAssemblerWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  Napi::Function func = DefineClass(env, "MeshAssembler",
+                                    {
+                                        InstanceMethod("push", &MeshAssemblerWrap::Push),
+                                        InstanceMethod("remove", &MeshAssemblerWrap::Remove),
+                                        InstanceMethod("expire", &MeshAssemblerWrap::Expire),
+                                        InstanceMethod("size", &MeshAssemblerWrap::Size),
+                                        InstanceMethod("stats", &MeshAssemblerWrap::Stats),
+                                    });
+  exports.Set("MeshAssembler", func);
+  return exports;
+}
+
+MeshAssemblerWrap::MeshAssemblerWrap(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<MeshAssemblerWrap>(info), assembler_(CapacityArg(info), FragmentSizeArg(info), TimeoutArg(info))
+{
+}
+
+Napi::Object MeshAssemblerWrap::ToObject(Napi::Env env, const ghostmesh::mesh::AssembledMessage &message)
+{
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("srcId", Napi::Number::New(env, static_cast<double>(message.srcId)));
+  obj.Set("dstId", Napi::Number::New(env, static_cast<double>(message.dstId)));
+  obj.Set("messageId", Napi::Number::New(env, message.messageId));
+  obj.Set("packetCount", Napi::Number::New(env, message.packetCount));
+  obj.Set("hopCount", Napi::Number::New(env, message.hopCount));
+  obj.Set("data", Napi::Buffer<uint8_t>::Copy(env, message.data, message.length));
+  return obj;
+}
+
+Napi::Object MeshAssemblerWrap::StatsToObject(Napi::Env env, const ghostmesh::mesh::AssemblerStats &stats)
+{
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("inUse", Napi::Number::New(env, static_cast<double>(stats.inUse)));
+  obj.Set("capacity", Napi::Number::New(env, static_cast<double>(stats.capacity)));
+  obj.Set("completed", Napi::Number::New(env, static_cast<double>(stats.completed)));
+  obj.Set("evicted", Napi::Number::New(env, static_cast<double>(stats.evicted)));
+  obj.Set("expired", Napi::Number::New(env, static_cast<double>(stats.expired)));
+  obj.Set("rejected", Napi::Number::New(env, static_cast<double>(stats.rejected)));
+  obj.Set("oversized", Napi::Number::New(env, static_cast<double>(stats.oversized)));
+  return obj;
+}
+
+Napi::Value MeshAssemblerWrap::Push(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsBuffer())
+  {
+    Napi::TypeError::New(env, "Expected manufacturer data buffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Buffer<uint8_t> buf = info[0].As<Napi::Buffer<uint8_t>>();
+  ghostmesh::mesh::MeshPacket packet;
+  if (!ghostmesh::mesh::DecodeMeshPacket(buf.Data(), buf.Length(), packet))
+    return env.Null();
+  const ghostmesh::mesh::AssembledMessage *message = assembler_.Push(packet, TimeArg(info, 1));
+  if (message == nullptr)
+    return env.Null();
+  return ToObject(env, *message);
+}
+
+Napi::Value MeshAssemblerWrap::Remove(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber())
+  {
+    Napi::TypeError::New(env, "Expected srcId and messageId").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  uint64_t srcId = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+  uint16_t messageId = static_cast<uint16_t>(info[1].As<Napi::Number>().Uint32Value());
+  assembler_.Remove(srcId, messageId);
+  return env.Undefined();
+}
+
+Napi::Value MeshAssemblerWrap::Expire(const Napi::CallbackInfo &info)
+{
+  return Napi::Number::New(info.Env(), static_cast<double>(assembler_.Expire(TimeArg(info, 0))));
+}
+
+Napi::Value MeshAssemblerWrap::Size(const Napi::CallbackInfo &info)
+{
+  return Napi::Number::New(info.Env(), static_cast<double>(assembler_.Size()));
+}
+
+Napi::Value MeshAssemblerWrap::Stats(const Napi::CallbackInfo &info)
+{
+  return StatsToObject(info.Env(), assembler_.Stats());
+}
@@ -0,0 +1,95 @@
+#ifndef NATIVE_BLE_MESH_ASSEMBLER_WRAP_H
+#define NATIVE_BLE_MESH_ASSEMBLER_WRAP_H
+
+#include <napi.h>
+
+#include "mesh_packet.h"
+
+/**
+ * @file mesh_assembler_wrap.h
+ * @brief N-API binding for the native GhostMesh reassembler
+ */
+
+/**
+ * @class MeshAssemblerWrap
+ * @brief JS-visible `MeshAssembler` backed by ghostmesh::mesh::MessageAssembler
+ *
+ * For callers that receive manufacturer data outside BLEAdapter (e.g. noble).
+ * Scans started with `assembleMesh` use the same engine inside the adapter and
+ * never cross into JS for incomplete messages.
+ */
+class MeshAssemblerWrap : public Napi::ObjectWrap<MeshAssemblerWrap>
+{
+public:
+  /**
+   * @brief Register the `MeshAssembler` class on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  /**
+   * @brief Construct a MeshAssembler
+   * @param info [0]: optional capacity (number of in-flight messages),
+   *             [1]: optional longest fragment DATA in bytes (default 18; up to 236 for extended advertising),
+   *             [2]: optional idle timeout in ms after which a partial message is dropped (default 30000)
+   */
+  MeshAssemblerWrap(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Convert an assembled message to its JS shape
+   * @param env N-API environment
+   * @param message Completed message
+   * @return { srcId, dstId, messageId, packetCount, hopCount, data }
+   */
+  static Napi::Object ToObject(Napi::Env env, const ghostmesh::mesh::AssembledMessage &message);
+
+  /**
+   * @brief Convert reassembly counters to their JS shape
+   * @param env N-API environment
+   * @param stats Counters
+   * @return { inUse, capacity, completed, evicted, expired, rejected, oversized }
+   */
+  static Napi::Object StatsToObject(Napi::Env env, const ghostmesh::mesh::AssemblerStats &stats);
+
+private:
+  /**
+   * @brief Push manufacturer data
+   * @param info [0]: Buffer (company ID + GhostMesh packet), [1]: optional arrival time in ms (default now)
+   * @return Assembled message object, or null while incomplete / not a mesh packet
+   */
+  Napi::Value Push(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Drop partial messages that timed out
+   * @param info [0]: optional current time in ms (default now)
+   * @return Number of messages dropped
+   */
+  Napi::Value Expire(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Reassembly counters
+   * @param info N-API callback info
+   * @return { inUse, capacity, completed, evicted, expired, rejected, oversized }
+   */
+  Napi::Value Stats(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Drop partial state for a message
+   * @param info [0]: srcId (number), [1]: messageId (number)
+   * @return undefined
+   */
+  Napi::Value Remove(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Number of messages currently being reassembled
+   * @param info N-API callback info
+   * @return number
+   */
+  Napi::Value Size(const Napi::CallbackInfo &info);
+
+  ghostmesh::mesh::MessageAssembler assembler_;
+};
+
+#endif // NATIVE_BLE_MESH_ASSEMBLER_WRAP_H
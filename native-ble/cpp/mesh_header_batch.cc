@@ -0,0 +1,257 @@
+/**
+ * @file mesh_header_batch.cc
+ * @brief SSE2 / SSSE3 / NEON and scalar kernels for bulk header decoding
+ */
+
+#include "mesh_header_batch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GHOSTMESH_MESH_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSSE3__) || defined(__AVX__)
+#define GHOSTMESH_MESH_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GHOSTMESH_MESH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+#if defined(GHOSTMESH_MESH_SSSE3)
+    const char *const kMeshHeaderKernel = "ssse3";
+#elif defined(GHOSTMESH_MESH_SSE2)
+    const char *const kMeshHeaderKernel = "sse2";
+#elif defined(GHOSTMESH_MESH_NEON)
+    const char *const kMeshHeaderKernel = "neon";
+#else
+    const char *const kMeshHeaderKernel = "scalar";
+#endif
+
+    namespace
+    {
+      // One vector load covers the whole 15-byte header
+      constexpr size_t kVectorLoadSize = 16;
+
+      constexpr uint64_t kId40Mask = 0xFFFFFFFFFFull;
+
+      inline uint64_t Load40(const uint8_t *p)
+      {
+        return uint64_t(p[0]) | uint64_t(p[1]) << 8 | uint64_t(p[2]) << 16 | uint64_t(p[3]) << 24 |
+               uint64_t(p[4]) << 32;
+      }
+
+      // MSG ID word into its messageId / packetNumber columns
+      inline void StoreMessageId(const MeshHeaderColumns &out, size_t i, uint16_t raw)
+      {
+        out.messageId[i] = static_cast<uint16_t>((raw >> 4) & 0x0FFF);
+        out.packetNumber[i] = static_cast<uint8_t>(raw & 0x0F);
+      }
+
+      inline void DecodeOne(const uint8_t *p, size_t i, const MeshHeaderColumns &out)
+      {
+        out.companyId[i] = static_cast<uint16_t>(p[0] | p[1] << 8);
+        out.dstId[i] = static_cast<double>(Load40(p + 2));
+        out.srcId[i] = static_cast<double>(Load40(p + 7));
+        StoreMessageId(out, i, static_cast<uint16_t>(p[12] | p[13] << 8));
+        out.hopCount[i] = p[14];
+      }
+
+      inline uint8_t MatchOne(const MeshHeaderColumns &columns, size_t i, uint16_t companyId, double dstId)
+      {
+        return static_cast<uint8_t>((columns.companyId[i] == companyId ? kMeshMatchCompany : 0) |
+                                    (columns.dstId[i] == dstId ? kMeshMatchDestination : 0));
+      }
+
+      // Records from `i` whose 16-byte load stays inside the batch: all but the last
+      inline size_t VectorEnd(size_t stride, size_t count)
+      {
+        return stride >= kVectorLoadSize && count > 0 ? count - 1 : 0;
+      }
+
+#if defined(GHOSTMESH_MESH_SSE2)
+      inline int PopCount8(int x)
+      {
+        x = x - ((x >> 1) & 0x55);
+        x = (x & 0x33) + ((x >> 2) & 0x33);
+        return (x + (x >> 4)) & 0x0F;
+      }
+
+      // Two 2 x 64-bit compare masks into 4 x 32-bit lanes
+      inline __m128i NarrowMasks(__m128d a, __m128d b)
+      {
+        __m128i lo = _mm_shuffle_epi32(_mm_castpd_si128(a), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128i hi = _mm_shuffle_epi32(_mm_castpd_si128(b), _MM_SHUFFLE(2, 0, 2, 0));
+        return _mm_unpacklo_epi64(lo, hi);
+      }
+#endif
+    } // namespace
+
+    void DecodeMeshHeadersScalar(const uint8_t *first, size_t stride, size_t count, const MeshHeaderColumns &out)
+    {
+      for (size_t i = 0; i < count; ++i)
+        DecodeOne(first + i * stride, i, out);
+    }
+
+    size_t MatchMeshHeadersScalar(const MeshHeaderColumns &columns, size_t count, uint16_t companyId,
+                                  uint64_t dstId, uint8_t *match)
+    {
+      const double wanted = static_cast<double>(dstId & kId40Mask);
+      size_t matched = 0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        match[i] = MatchOne(columns, i, companyId, wanted);
+        matched += match[i] == kMeshMatchBoth;
+      }
+      return matched;
+    }
+
+#if defined(GHOSTMESH_MESH_SSE2)
+
+    // Both IDs into one register, then to doubles with the 2^52 exponent trick
+    void DecodeMeshHeaders(const uint8_t *first, size_t stride, size_t count, const MeshHeaderColumns &out)
+    {
+      const __m128i exponent52 = _mm_set1_epi64x(0x4330000000000000ll);
+#if defined(GHOSTMESH_MESH_SSSE3)
+      const __m128i idShuffle = _mm_setr_epi8(2, 3, 4, 5, 6, -1, -1, -1, 7, 8, 9, 10, 11, -1, -1, -1);
+#else
+      const __m128i low40 = _mm_set_epi32(0, 0, 0xFF, -1);
+#endif
+      const size_t vectorEnd = VectorEnd(stride, count);
+      size_t i = 0;
+      for (; i < vectorEnd; ++i)
+      {
+        const uint8_t *p = first + i * stride;
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+#if defined(GHOSTMESH_MESH_SSSE3)
+        __m128i ids = _mm_shuffle_epi8(v, idShuffle);
+#else
+        __m128i dst = _mm_and_si128(_mm_srli_si128(v, 2), low40);
+        __m128i src = _mm_and_si128(_mm_srli_si128(v, 7), low40);
+        __m128i ids = _mm_unpacklo_epi64(dst, src);
+#endif
+        __m128d values = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(ids, exponent52)), _mm_castsi128_pd(exponent52));
+        _mm_storel_pd(out.dstId + i, values);
+        _mm_storeh_pd(out.srcId + i, values);
+        out.companyId[i] = static_cast<uint16_t>(_mm_extract_epi16(v, 0));
+        StoreMessageId(out, i, static_cast<uint16_t>(_mm_extract_epi16(v, 6)));
+        out.hopCount[i] = static_cast<uint8_t>(_mm_extract_epi16(v, 7));
+      }
+      for (; i < count; ++i)
+        DecodeOne(first + i * stride, i, out);
+    }
+
+    // Eight records per step: 16-bit company compares, 64-bit destination compares narrowed to match
+    size_t MatchMeshHeaders(const MeshHeaderColumns &columns, size_t count, uint16_t companyId, uint64_t dstId,
+                            uint8_t *match)
+    {
+      const double wanted = static_cast<double>(dstId & kId40Mask);
+      const __m128i company = _mm_set1_epi16(static_cast<short>(companyId));
+      const __m128d destination = _mm_set1_pd(wanted);
+      const __m128i companyBit = _mm_set1_epi16(kMeshMatchCompany);
+      const __m128i destinationBit = _mm_set1_epi16(kMeshMatchDestination);
+      const __m128i both = _mm_set1_epi16(kMeshMatchBoth);
+      size_t matched = 0;
+      size_t i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+        __m128i companies =
+            _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(columns.companyId + i)), company);
+        const double *dst = columns.dstId + i;
+        __m128i low = NarrowMasks(_mm_cmpeq_pd(_mm_loadu_pd(dst), destination),
+                                  _mm_cmpeq_pd(_mm_loadu_pd(dst + 2), destination));
+        __m128i high = NarrowMasks(_mm_cmpeq_pd(_mm_loadu_pd(dst + 4), destination),
+                                   _mm_cmpeq_pd(_mm_loadu_pd(dst + 6), destination));
+        __m128i destinations = _mm_packs_epi32(low, high);
+        __m128i flags =
+            _mm_or_si128(_mm_and_si128(companies, companyBit), _mm_and_si128(destinations, destinationBit));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(match + i), _mm_packus_epi16(flags, flags));
+        __m128i hits = _mm_cmpeq_epi16(flags, both);
+        matched += static_cast<size_t>(PopCount8(_mm_movemask_epi8(_mm_packs_epi16(hits, hits)) & 0xFF));
+      }
+      for (; i < count; ++i)
+      {
+        match[i] = MatchOne(columns, i, companyId, wanted);
+        matched += match[i] == kMeshMatchBoth;
+      }
+      return matched;
+    }
+
+#elif defined(GHOSTMESH_MESH_NEON)
+
+    // Both IDs into one register with a table lookup, converted to doubles in one instruction
+    void DecodeMeshHeaders(const uint8_t *first, size_t stride, size_t count, const MeshHeaderColumns &out)
+    {
+      static const uint8_t kIdTable[16] = {2, 3, 4, 5, 6, 0xFF, 0xFF, 0xFF, 7, 8, 9, 10, 11, 0xFF, 0xFF, 0xFF};
+      const uint8x16_t idTable = vld1q_u8(kIdTable);
+      const size_t vectorEnd = VectorEnd(stride, count);
+      size_t i = 0;
+      for (; i < vectorEnd; ++i)
+      {
+        const uint8_t *p = first + i * stride;
+        uint8x16_t v = vld1q_u8(p);
+        float64x2_t values = vcvtq_f64_u64(vreinterpretq_u64_u8(vqtbl1q_u8(v, idTable)));
+        vst1q_lane_f64(out.dstId + i, values, 0);
+        vst1q_lane_f64(out.srcId + i, values, 1);
+        uint16x8_t words = vreinterpretq_u16_u8(v);
+        out.companyId[i] = vgetq_lane_u16(words, 0);
+        StoreMessageId(out, i, vgetq_lane_u16(words, 6));
+        out.hopCount[i] = vgetq_lane_u8(v, 14);
+      }
+      for (; i < count; ++i)
+        DecodeOne(first + i * stride, i, out);
+    }
+
+    // Eight records per step: 16-bit company compares, 64-bit destination compares narrowed to match
+    size_t MatchMeshHeaders(const MeshHeaderColumns &columns, size_t count, uint16_t companyId, uint64_t dstId,
+                            uint8_t *match)
+    {
+      const double wanted = static_cast<double>(dstId & kId40Mask);
+      const uint16x8_t company = vdupq_n_u16(companyId);
+      const float64x2_t destination = vdupq_n_f64(wanted);
+      const uint16x8_t both = vdupq_n_u16(kMeshMatchBoth);
+      size_t matched = 0;
+      size_t i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+        uint16x8_t companies = vceqq_u16(vld1q_u16(columns.companyId + i), company);
+        const double *dst = columns.dstId + i;
+        uint32x4_t low = vcombine_u32(vmovn_u64(vceqq_f64(vld1q_f64(dst), destination)),
+                                      vmovn_u64(vceqq_f64(vld1q_f64(dst + 2), destination)));
+        uint32x4_t high = vcombine_u32(vmovn_u64(vceqq_f64(vld1q_f64(dst + 4), destination)),
+                                       vmovn_u64(vceqq_f64(vld1q_f64(dst + 6), destination)));
+        uint16x8_t destinations = vcombine_u16(vmovn_u32(low), vmovn_u32(high));
+        uint16x8_t flags = vorrq_u16(vandq_u16(companies, vdupq_n_u16(kMeshMatchCompany)),
+                                     vandq_u16(destinations, vdupq_n_u16(kMeshMatchDestination)));
+        vst1_u8(match + i, vmovn_u16(flags));
+        matched += vaddvq_u16(vshrq_n_u16(vceqq_u16(flags, both), 15));
+      }
+      for (; i < count; ++i)
+      {
+        match[i] = MatchOne(columns, i, companyId, wanted);
+        matched += match[i] == kMeshMatchBoth;
+      }
+      return matched;
+    }
+
+#else
+
+    void DecodeMeshHeaders(const uint8_t *first, size_t stride, size_t count, const MeshHeaderColumns &out)
+    {
+      DecodeMeshHeadersScalar(first, stride, count, out);
+    }
+
+    size_t MatchMeshHeaders(const MeshHeaderColumns &columns, size_t count, uint16_t companyId, uint64_t dstId,
+                            uint8_t *match)
+    {
+      return MatchMeshHeadersScalar(columns, count, companyId, dstId, match);
+    }
+
+#endif
+
+  } // namespace mesh
+} // namespace ghostmesh
@@ -0,0 +1,97 @@
+#ifndef NATIVE_BLE_MESH_HEADER_BATCH_H
+#define NATIVE_BLE_MESH_HEADER_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mesh_packet.h"
+
+/**
+ * @file mesh_header_batch.h
+ * @brief Bulk decode of GhostMesh headers into struct-of-arrays columns
+ *
+ * DecodeMeshPacket() handles one fragment at a time. A batch of discoveries
+ * (a packed `devicesDiscovered` buffer, a discovery ring, or an array of
+ * 33-byte manufacturer records) is instead decoded here in one pass, one
+ * column per field, and the "ours, and for me" test is then a vector compare
+ * over the columns.
+ *
+ * The kernels are picked at compile time: SSE2 on x86-64 (with a byte
+ * shuffle when SSSE3 is enabled), NEON on AArch64, and a scalar loop
+ * otherwise. Each decodes the same values; kMeshHeaderKernel names the one
+ * built in.
+ */
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    /**
+     * @brief Name of the compiled-in kernel: "ssse3", "sse2", "neon" or "scalar"
+     */
+    extern const char *const kMeshHeaderKernel;
+
+    /**
+     * @struct MeshHeaderColumns
+     * @brief Destination of DecodeMeshHeaders(); each array holds `count` entries
+     *
+     * IDs are doubles, exact for 40 bits, so the columns can be handed to JS
+     * as Float64Arrays without conversion.
+     */
+    struct MeshHeaderColumns
+    {
+      uint16_t *companyId;
+      double *dstId; ///< 40-bit
+      double *srcId; ///< 40-bit
+      uint16_t *messageId; ///< 12-bit
+      uint8_t *packetNumber; ///< 4-bit
+      uint8_t *hopCount; ///< HOP COUNT byte: bits 6-0 hops, bit 7 kMeshLastFragmentFlag
+    };
+
+    /**
+     * @brief Bits of a MatchMeshHeaders() result
+     */
+    constexpr uint8_t kMeshMatchCompany = 0x01;     ///< companyId is the one asked for
+    constexpr uint8_t kMeshMatchDestination = 0x02; ///< dstId is the one asked for
+    constexpr uint8_t kMeshMatchBoth = kMeshMatchCompany | kMeshMatchDestination;
+
+    /**
+     * @brief Decode the fixed header of `count` records
+     * @param first Company ID of the first record
+     * @param stride Bytes from one record to the next (33 for bare manufacturer
+     *        records, kPackedRecordStride for a packed discovery buffer)
+     * @param count Records to decode
+     * @param out Columns with room for `count` entries
+     *
+     * Only the kMeshHeaderSize bytes of each record are read, so records
+     * shorter than that decode whatever follows them (zeros in a packed
+     * discovery buffer). Nothing past the last record's header is touched.
+     */
+    void DecodeMeshHeaders(const uint8_t *first, size_t stride, size_t count, const MeshHeaderColumns &out);
+
+    /**
+     * @brief Flag the records of a company and, among them, those addressed to `dstId`
+     * @param columns Output of DecodeMeshHeaders()
+     * @param count Records in the columns
+     * @param companyId Company ID to match
+     * @param dstId Destination ID to match (40-bit)
+     * @param match Receives kMeshMatch* bits per record
+     * @return Records matching both
+     */
+    size_t MatchMeshHeaders(const MeshHeaderColumns &columns, size_t count, uint16_t companyId, uint64_t dstId,
+                            uint8_t *match);
+
+    /**
+     * @brief Reference versions of the above, one record at a time
+     *
+     * Always built, whichever kernel is compiled in, for comparison.
+     */
+    void DecodeMeshHeadersScalar(const uint8_t *first, size_t stride, size_t count, const MeshHeaderColumns &out);
+    size_t MatchMeshHeadersScalar(const MeshHeaderColumns &columns, size_t count, uint16_t companyId,
+                                  uint64_t dstId, uint8_t *match);
+
+  } // namespace mesh
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_MESH_HEADER_BATCH_H
@@ -0,0 +1,113 @@
+/**
+ * @file mesh_header_batch_wrap.cc
+ * @brief N-API binding for the bulk GhostMesh header decoder
+ */
+
+#include "mesh_header_batch_wrap.h"
+
+#include <cmath>
+#include <string>
+
+namespace
+{
+  constexpr double kMaxId40 = 1099511627775.0;
+
+  // Non-negative integer option up to `max`, left as is when absent; throws and returns false otherwise
+  bool IntegerOption(Napi::Env env, Napi::Object options, const char *name, double max, double &value)
+  {
+    Napi::Value raw = options.Get(name);
+    if (raw.IsUndefined())
+      return true;
+    double number = raw.IsNumber() ? raw.As<Napi::Number>().DoubleValue() : -1;
+    if (!(number >= 0 && number <= max && std::floor(number) == number))
+    {
+      Napi::TypeError::New(env, std::string("decodeMeshHeaders ") + name + " must be an integer from 0 to " +
+                                    std::to_string(static_cast<uint64_t>(max)))
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    value = number;
+    return true;
+  }
+} // namespace
+
+Napi::Object MeshHeaderBatchWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  exports.Set("decodeMeshHeaders", Napi::Function::New(env, &MeshHeaderBatchWrap::Decode, "decodeMeshHeaders"));
+  return exports;
+}
+
+Napi::Value MeshHeaderBatchWrap::Decode(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array)
+  {
+    Napi::TypeError::New(env, "Expected Uint8Array").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Uint8Array bytes = info[0].As<Napi::Uint8Array>();
+
+  double stride = static_cast<double>(ghostmesh::mesh::kMeshManufacturerSize);
+  double offset = 0;
+  double count = -1;
+  double companyId = -1;
+  double dstId = -1;
+  if (info.Length() > 1 && info[1].IsObject())
+  {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (!IntegerOption(env, options, "stride", 65535, stride) ||
+        !IntegerOption(env, options, "offset", static_cast<double>(bytes.ElementLength()), offset) ||
+        !IntegerOption(env, options, "count", 4294967295.0, count) ||
+        !IntegerOption(env, options, "companyId", 65535, companyId) ||
+        !IntegerOption(env, options, "dstId", kMaxId40, dstId))
+      return env.Undefined();
+    if (stride == 0)
+    {
+      Napi::RangeError::New(env, "decodeMeshHeaders stride must be positive").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  // Every record whose header lies inside the view, up to `count`
+  const size_t length = bytes.ElementLength() - static_cast<size_t>(offset);
+  const size_t step = static_cast<size_t>(stride);
+  size_t records =
+      length < ghostmesh::mesh::kMeshHeaderSize ? 0 : (length - ghostmesh::mesh::kMeshHeaderSize) / step + 1;
+  if (count >= 0 && static_cast<size_t>(count) < records)
+    records = static_cast<size_t>(count);
+  const bool matching = companyId >= 0 && dstId >= 0;
+
+  // One allocation, widest columns first so each stays aligned
+  const size_t columnsSize = records * (2 * sizeof(double) + 2 * sizeof(uint16_t) + 2 + (matching ? 1 : 0));
+  Napi::ArrayBuffer storage = Napi::ArrayBuffer::New(env, columnsSize);
+  Napi::Float64Array dst = Napi::Float64Array::New(env, records, storage, 0);
+  Napi::Float64Array src = Napi::Float64Array::New(env, records, storage, records * 8);
+  Napi::Uint16Array company = Napi::Uint16Array::New(env, records, storage, records * 16);
+  Napi::Uint16Array message = Napi::Uint16Array::New(env, records, storage, records * 18);
+  Napi::Uint8Array packet = Napi::Uint8Array::New(env, records, storage, records * 20);
+  Napi::Uint8Array hops = Napi::Uint8Array::New(env, records, storage, records * 21);
+
+  ghostmesh::mesh::MeshHeaderColumns columns{company.Data(), dst.Data(),    src.Data(),
+                                             message.Data(), packet.Data(), hops.Data()};
+  ghostmesh::mesh::DecodeMeshHeaders(bytes.Data() + static_cast<size_t>(offset), step, records, columns);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, static_cast<double>(records)));
+  result.Set("kernel", Napi::String::New(env, ghostmesh::mesh::kMeshHeaderKernel));
+  result.Set("companyId", company);
+  result.Set("dstId", dst);
+  result.Set("srcId", src);
+  result.Set("messageId", message);
+  result.Set("packetNumber", packet);
+  result.Set("hopCount", hops);
+  if (matching)
+  {
+    Napi::Uint8Array match = Napi::Uint8Array::New(env, records, storage, records * 22);
+    size_t matched = ghostmesh::mesh::MatchMeshHeaders(columns, records, static_cast<uint16_t>(companyId),
+                                                       static_cast<uint64_t>(dstId), match.Data());
+    result.Set("match", match);
+    result.Set("matched", Napi::Number::New(env, static_cast<double>(matched)));
+  }
+  return result;
+}
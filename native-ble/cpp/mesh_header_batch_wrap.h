@@ -0,0 +1,42 @@
+#ifndef NATIVE_BLE_MESH_HEADER_BATCH_WRAP_H
+#define NATIVE_BLE_MESH_HEADER_BATCH_WRAP_H
+
+#include <napi.h>
+
+#include "mesh_header_batch.h"
+
+/**
+ * @file mesh_header_batch_wrap.h
+ * @brief N-API binding for the bulk GhostMesh header decoder
+ */
+
+/**
+ * @class MeshHeaderBatchWrap
+ * @brief `decodeMeshHeaders` addon function backed by ghostmesh::mesh::DecodeMeshHeaders
+ *
+ * Decodes a whole batch of records in one call into typed-array columns
+ * that share one ArrayBuffer, so a batch costs one crossing and one
+ * allocation however many records it holds.
+ */
+class MeshHeaderBatchWrap
+{
+public:
+  /**
+   * @brief Register the decoder function on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+private:
+  /**
+   * @brief Decode the headers of fixed-stride records
+   * @param info [0]: Uint8Array, [1]: optional { stride = 33, offset = 0, count, companyId, dstId }
+   * @return { count, kernel, companyId, dstId, srcId, messageId, packetNumber, hopCount }, plus
+   *         { match, matched } when companyId and dstId are given
+   */
+  static Napi::Value Decode(const Napi::CallbackInfo &info);
+};
+
+#endif // NATIVE_BLE_MESH_HEADER_BATCH_WRAP_H
@@ -0,0 +1,285 @@
+/**
+ * @file mesh_packet.cc
+ * @brief Implementation of the GhostMesh packet decoder and reassembler
+ */
+
+#include "mesh_packet.h"
+
+#include "dedup_cache.h"
+
+#include <cstring>
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    namespace
+    {
+      constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+      inline uint64_t ReadUInt40LE(const uint8_t *p)
+      {
+        return static_cast<uint64_t>(p[0]) |
+               (static_cast<uint64_t>(p[1]) << 8) |
+               (static_cast<uint64_t>(p[2]) << 16) |
+               (static_cast<uint64_t>(p[3]) << 24) |
+               (static_cast<uint64_t>(p[4]) << 32);
+      }
+
+      inline size_t ClampFragmentSize(size_t size)
+      {
+        if (size < kMeshDataSize)
+          return kMeshDataSize;
+        return size > kMeshMaxDataSize ? kMeshMaxDataSize : size;
+      }
+    } // namespace
+
+    bool DecodeMeshPacket(const uint8_t *buf, size_t length, MeshPacket &out)
+    {
+      if (buf == nullptr || length < kMeshManufacturerSize)
+        return false;
+
+      const uint8_t *payload = buf + 2;
+      uint16_t msgIdRaw = static_cast<uint16_t>(payload[10] | (payload[11] << 8));
+
+      out.companyId = static_cast<uint16_t>(buf[0] | (buf[1] << 8));
+      out.dstId = ReadUInt40LE(payload);
+      out.srcId = ReadUInt40LE(payload + 5);
+      out.messageId = static_cast<uint16_t>((msgIdRaw >> 4) & 0x0FFF);
+      out.packetNumber = static_cast<uint8_t>(msgIdRaw & 0x0F);
+      out.hopCount = static_cast<uint8_t>(payload[12] & ~kMeshLastFragmentFlag);
+      out.lastFragment = (payload[12] & kMeshLastFragmentFlag) != 0;
+      out.data = payload + 13;
+      size_t dataLength = length - kMeshHeaderSize;
+      out.dataLength = static_cast<uint8_t>(dataLength < kMeshMaxDataSize ? dataLength : kMeshMaxDataSize);
+      return true;
+    }
+
+    MessageAssembler::MessageAssembler(size_t capacity, size_t fragmentSize, uint32_t timeoutMs)
+        : slots_(capacity < 1 ? 1 : capacity), size_(0), fragmentSize_(ClampFragmentSize(fragmentSize)),
+          timeoutMs_(timeoutMs > 0 ? timeoutMs : 1), newest_(kNone), oldest_(kNone), completedCount_(0),
+          evicted_(0), expired_(0), rejected_(0), oversized_(0)
+    {
+      // Index at most half full keeps probe chains short
+      index_.assign(ble::RoundUpPow2(2 * slots_.size()), kNone);
+      mask_ = index_.size() - 1;
+      blocks_.resize(slots_.size());
+      // Popped from the back, so slot 0 is handed out first
+      free_.reserve(slots_.size());
+      for (size_t i = slots_.size(); i > 0; --i)
+      {
+        free_.push_back(static_cast<uint32_t>(i - 1));
+      }
+    }
+
+    uint8_t *MessageAssembler::Block(uint32_t slot)
+    {
+      std::unique_ptr<uint8_t[]> &bytes = blocks_[slot];
+      if (!bytes)
+        bytes.reset(new uint8_t[kMeshMaxFragments * fragmentSize_]);
+      return bytes.get();
+    }
+
+    size_t MessageAssembler::Home(uint64_t key) const
+    {
+      // Fibonacci hashing spreads sequential message IDs across the table
+      return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+    }
+
+    // Index position holding `key`
+    size_t MessageAssembler::Find(uint64_t key) const
+    {
+      size_t i = Home(key);
+      while (index_[i] != kNone)
+      {
+        if (slots_[index_[i]].key == key)
+          return i;
+        i = (i + 1) & mask_;
+      }
+      return kNotFound;
+    }
+
+    void MessageAssembler::LinkNewest(uint32_t slot)
+    {
+      Slot &s = slots_[slot];
+      s.newer = kNone;
+      s.older = newest_;
+      if (newest_ != kNone)
+        slots_[newest_].newer = slot;
+      newest_ = slot;
+      if (oldest_ == kNone)
+        oldest_ = slot;
+    }
+
+    void MessageAssembler::UnlinkRecent(uint32_t slot)
+    {
+      Slot &s = slots_[slot];
+      if (s.newer != kNone)
+        slots_[s.newer].older = s.older;
+      else
+        newest_ = s.older;
+      if (s.older != kNone)
+        slots_[s.older].newer = s.newer;
+      else
+        oldest_ = s.newer;
+      s.newer = s.older = kNone;
+    }
+
+    // Take a free slot for a new message; the caller has made sure one exists
+    uint32_t MessageAssembler::Acquire(uint64_t key, uint64_t dstId)
+    {
+      uint32_t slot = free_.back();
+      free_.pop_back();
+      Slot &s = slots_[slot];
+      s.key = key;
+      s.dstId = dstId;
+      s.present = 0;
+      s.last = kLastUnknown;
+      LinkNewest(slot);
+
+      size_t i = Home(key);
+      while (index_[i] != kNone)
+        i = (i + 1) & mask_;
+      index_[i] = slot;
+      ++size_;
+      return slot;
+    }
+
+    void MessageAssembler::Release(uint32_t slot)
+    {
+      UnlinkRecent(slot);
+      free_.push_back(slot);
+      --size_;
+
+      // Backward-shift deletion keeps every probe chain unbroken
+      size_t hole = Find(slots_[slot].key);
+      index_[hole] = kNone;
+      size_t j = hole;
+      for (;;)
+      {
+        j = (j + 1) & mask_;
+        if (index_[j] == kNone)
+          break;
+        size_t home = Home(slots_[index_[j]].key);
+        bool reachable = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (reachable)
+          continue;
+        index_[hole] = index_[j];
+        index_[j] = kNone;
+        hole = j;
+      }
+    }
+
+    size_t MessageAssembler::Expire(uint64_t nowMs)
+    {
+      size_t dropped = 0;
+      // The tail is the least recently updated, so stop at the first live slot
+      while (oldest_ != kNone && nowMs >= slots_[oldest_].updatedMs + timeoutMs_)
+      {
+        Release(oldest_);
+        ++dropped;
+      }
+      expired_ += dropped;
+      return dropped;
+    }
+
+    const AssembledMessage *MessageAssembler::Push(const MeshPacket &packet, uint64_t nowMs)
+    {
+      if (packet.dataLength > fragmentSize_)
+      {
+        ++oversized_;
+        return nullptr;
+      }
+
+      Expire(nowMs);
+
+      uint64_t key = MessageKey(packet.srcId, packet.messageId);
+      uint8_t number = packet.packetNumber & 0x0F;
+      size_t position = Find(key);
+      uint32_t slot;
+      if (position == kNotFound)
+      {
+        if (free_.empty())
+        {
+          Release(oldest_);
+          ++evicted_;
+        }
+        slot = Acquire(key, packet.dstId);
+      }
+      else
+      {
+        slot = index_[position];
+        if (slot != newest_)
+        {
+          UnlinkRecent(slot);
+          LinkNewest(slot);
+        }
+      }
+
+      Slot &s = slots_[slot];
+      s.updatedMs = nowMs;
+
+      // Fragments past the flagged one, or a second flag, contradict what
+      // already arrived; keep the first account of the message's length
+      if (s.last != kLastUnknown && (number > s.last || (packet.lastFragment && number != s.last)))
+      {
+        ++rejected_;
+        return nullptr;
+      }
+      if (packet.lastFragment)
+        s.last = number;
+
+      s.present = static_cast<uint16_t>(s.present | (1u << number));
+      s.lengths[number] = packet.dataLength;
+      std::memcpy(Block(slot) + number * fragmentSize_, packet.data, packet.dataLength);
+
+      if (s.last == kLastUnknown)
+        return nullptr;
+      uint32_t want = (2u << s.last) - 1;
+      if ((s.present & want) != want)
+        return nullptr;
+
+      uint8_t count = static_cast<uint8_t>(s.last + 1);
+      completed_.srcId = packet.srcId;
+      completed_.dstId = s.dstId;
+      completed_.messageId = packet.messageId;
+      completed_.hopCount = packet.hopCount;
+      completed_.packetCount = count;
+      completed_.length = 0;
+      const uint8_t *fragments = Block(slot);
+      for (uint8_t i = 0; i < count; ++i)
+      {
+        std::memcpy(completed_.data + completed_.length, fragments + i * fragmentSize_, s.lengths[i]);
+        completed_.length += s.lengths[i];
+      }
+
+      Release(slot);
+      ++completedCount_;
+      return &completed_;
+    }
+
+    void MessageAssembler::Remove(uint64_t srcId, uint16_t messageId)
+    {
+      size_t position = Find(MessageKey(srcId, messageId));
+      if (position != kNotFound)
+      {
+        Release(index_[position]);
+      }
+    }
+
+    AssemblerStats MessageAssembler::Stats() const
+    {
+      AssemblerStats stats;
+      stats.inUse = size_;
+      stats.capacity = slots_.size();
+      stats.completed = completedCount_;
+      stats.evicted = evicted_;
+      stats.expired = expired_;
+      stats.rejected = rejected_;
+      stats.oversized = oversized_;
+      return stats;
+    }
+
+  } // namespace mesh
+} // namespace ghostmesh
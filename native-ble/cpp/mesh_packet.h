@@ -0,0 +1,236 @@
+#ifndef NATIVE_BLE_MESH_PACKET_H
+#define NATIVE_BLE_MESH_PACKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @file mesh_packet.h
+ * @brief GhostMesh packet decoder and fixed-memory message reassembler
+ *
+ * Native counterpart of `parseMeshPacket` / `MessageAssembler` in src/mesh.ts.
+ *
+ * Manufacturer data layout:
+ * - 2 bytes LE: companyId
+ * - 31-byte GhostMesh base packet:
+ *   - DST ID: 5 bytes (LE)
+ *   - SRC ID: 5 bytes (LE)
+ *   - MSG ID: 2 bytes (LE) -> bits 15-4: messageId (12 bits), bits 3-0: packetNumber (4 bits)
+ *   - HOP COUNT: 1 byte -> bit 7: last fragment, bits 6-0: hop count
+ *   - DATA: 18 bytes (legacy), or everything after the header in an extended
+ *     advertisement, up to kMeshMaxDataSize bytes
+ *
+ * A sender picks one fragment size per message with MeshFragmentDataSize();
+ * every fragment but the last carries exactly that many DATA bytes. The last
+ * fragment sets kMeshLastFragmentFlag, which tells receivers how many
+ * fragments the message has.
+ */
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    constexpr size_t kMeshPacketSize = 31;                       ///< Base packet after the company ID
+    constexpr size_t kMeshManufacturerSize = 2 + kMeshPacketSize; ///< Company ID + base packet
+    constexpr size_t kMeshHeaderSize = 2 + 13;                   ///< Company ID + fixed header fields
+    constexpr size_t kMeshDataSize = 18;                         ///< Payload bytes per legacy fragment
+    constexpr size_t kMeshMaxDataSize = 251 - kMeshHeaderSize;   ///< Payload bytes per extended fragment
+    constexpr size_t kMeshMaxFragments = 16;                     ///< 4-bit packet number
+    constexpr size_t kMeshMaxMessageSize = kMeshMaxDataSize * kMeshMaxFragments;
+    constexpr uint8_t kMeshLastFragmentFlag = 0x80;              ///< HOP COUNT bit marking the final fragment
+
+    /**
+     * @brief DATA bytes per fragment for a given advertising payload limit
+     * @param maxAdvertisingDataSize Capabilities::maxAdvertisingDataSize of the sending platform
+     * @return kMeshDataSize for legacy advertising, up to kMeshMaxDataSize for extended
+     */
+    inline size_t MeshFragmentDataSize(size_t maxAdvertisingDataSize)
+    {
+      if (maxAdvertisingDataSize <= kMeshManufacturerSize)
+        return kMeshDataSize;
+      size_t size = maxAdvertisingDataSize - kMeshHeaderSize;
+      return size < kMeshMaxDataSize ? size : kMeshMaxDataSize;
+    }
+
+    /**
+     * @struct MeshPacket
+     * @brief Decoded GhostMesh fragment; `data` points into the source buffer
+     */
+    struct MeshPacket
+    {
+      uint16_t companyId;
+      uint64_t dstId; ///< 40-bit
+      uint64_t srcId; ///< 40-bit
+      uint16_t messageId; ///< 12-bit
+      uint8_t packetNumber; ///< 4-bit
+      uint8_t hopCount;     ///< 7-bit
+      bool lastFragment;    ///< kMeshLastFragmentFlag was set
+      const uint8_t *data; ///< `dataLength` bytes, not owned
+      uint8_t dataLength;  ///< kMeshDataSize..kMeshMaxDataSize
+    };
+
+    /**
+     * @brief Decode manufacturer data into a MeshPacket without copying
+     * @param buf Manufacturer data (company ID + base packet)
+     * @param length Buffer length
+     * @param out Receives the decoded fields
+     * @return false if the buffer is too short to be a GhostMesh packet
+     *
+     * Bytes beyond kMeshHeaderSize + kMeshMaxDataSize are ignored.
+     */
+    bool DecodeMeshPacket(const uint8_t *buf, size_t length, MeshPacket &out);
+
+    /**
+     * @brief Pack (srcId, messageId) into the 52-bit message key
+     */
+    inline uint64_t MessageKey(uint64_t srcId, uint16_t messageId)
+    {
+      return ((srcId & 0xFFFFFFFFFFull) << 12) | (messageId & 0x0FFFu);
+    }
+
+    /**
+     * @struct AssembledMessage
+     * @brief A fully reassembled message
+     */
+    struct AssembledMessage
+    {
+      uint64_t srcId;
+      uint64_t dstId;
+      uint16_t messageId;
+      uint8_t hopCount;     ///< Hop count of the fragment that completed the message
+      uint8_t packetCount;  ///< Number of fragments concatenated
+      size_t length;        ///< Sum of the fragments' DATA lengths
+      uint8_t data[kMeshMaxMessageSize];
+    };
+
+    /**
+     * @struct AssemblerStats
+     * @brief Reassembly counters since construction
+     */
+    struct AssemblerStats
+    {
+      size_t inUse;       ///< Slots holding a partial message
+      size_t capacity;    ///< Slots in the pool
+      uint64_t completed; ///< Messages reassembled
+      uint64_t evicted;   ///< Partial messages dropped to make room (least recently updated first)
+      uint64_t expired;   ///< Partial messages dropped after timeoutMs without a fragment
+      uint64_t rejected;  ///< Fragments numbered past the message's last fragment
+      uint64_t oversized; ///< Fragments longer than fragmentSize
+    };
+
+    /**
+     * @class MessageAssembler
+     * @brief Reassembles fragments in a fixed pool of slots with LRU and timeout eviction
+     *
+     * A message is complete once fragments 0..n have arrived, n being the
+     * fragment flagged kMeshLastFragmentFlag; a run of leading fragments
+     * without the flag is a truncated stream and never completes. Each slot
+     * tracks the fragments received in a 16-bit presence bitmap, so the check
+     * is a mask compare.
+     *
+     * Slots live in a pool allocated up front and are found through an
+     * open-addressing index of pool positions keyed on MessageKey(), probed
+     * linearly and deleted by backward shifting, so there are no tombstones.
+     * The pool is also threaded on a least-recently-updated list: partial
+     * messages idle for timeoutMs are dropped from its tail on every Push (or
+     * Expire), and when every slot is busy the tail makes room for the new
+     * message. Memory is therefore bounded by capacity however lossy the
+     * channel, and nothing needs the caller to call Remove().
+     *
+     * Fragment bytes live in per-slot blocks of kMeshMaxFragments *
+     * fragmentSize bytes, allocated the first time a slot is used and reused
+     * afterwards, so a table sized for extended fragments costs nothing extra
+     * while traffic is legacy and nothing is allocated in steady state.
+     */
+    class MessageAssembler
+    {
+    public:
+      /**
+       * @param capacity Number of in-flight messages
+       * @param fragmentSize Longest fragment DATA accepted (kMeshDataSize..kMeshMaxDataSize)
+       * @param timeoutMs Idle time after which a partial message is dropped
+       */
+      explicit MessageAssembler(size_t capacity = 256, size_t fragmentSize = kMeshDataSize,
+                                uint32_t timeoutMs = 30000);
+
+      MessageAssembler(const MessageAssembler &) = delete;
+      MessageAssembler &operator=(const MessageAssembler &) = delete;
+
+      /**
+       * @brief Add a fragment
+       * @param packet Decoded fragment
+       * @param nowMs Arrival time in milliseconds; the same clock for every call
+       * @return Completed message (valid until the next Push) or nullptr
+       */
+      const AssembledMessage *Push(const MeshPacket &packet, uint64_t nowMs);
+
+      /**
+       * @brief Drop partial messages idle since before nowMs - timeoutMs
+       * @return Number dropped
+       */
+      size_t Expire(uint64_t nowMs);
+
+      /**
+       * @brief Drop any partial state for a message
+       */
+      void Remove(uint64_t srcId, uint16_t messageId);
+
+      /**
+       * @brief Number of messages currently being reassembled
+       */
+      size_t Size() const { return size_; }
+
+      /**
+       * @brief Snapshot of the counters
+       */
+      AssemblerStats Stats() const;
+
+    private:
+      static constexpr uint32_t kNone = UINT32_MAX;
+      static constexpr uint8_t kLastUnknown = 0xFF;
+
+      struct Slot
+      {
+        uint64_t key;
+        uint64_t dstId;
+        uint64_t updatedMs;
+        uint16_t present; ///< Bit n set when fragment n has arrived
+        uint8_t last;     ///< Number of the flagged fragment, kLastUnknown until it arrives
+        uint32_t newer;   ///< Least-recently-updated list
+        uint32_t older;
+        uint8_t lengths[kMeshMaxFragments];
+      };
+
+      size_t Home(uint64_t key) const;
+      size_t Find(uint64_t key) const;
+      uint8_t *Block(uint32_t slot);
+      uint32_t Acquire(uint64_t key, uint64_t dstId);
+      void Release(uint32_t slot);
+      void LinkNewest(uint32_t slot);
+      void UnlinkRecent(uint32_t slot);
+
+      std::vector<Slot> slots_;
+      std::vector<uint32_t> index_; ///< Pool positions, kNone when empty
+      size_t mask_;
+      size_t size_;
+      size_t fragmentSize_;
+      uint32_t timeoutMs_;
+      std::vector<std::unique_ptr<uint8_t[]>> blocks_; ///< One per slot, null until first used
+      std::vector<uint32_t> free_;
+      uint32_t newest_;
+      uint32_t oldest_;
+      uint64_t completedCount_;
+      uint64_t evicted_;
+      uint64_t expired_;
+      uint64_t rejected_;
+      uint64_t oversized_;
+      AssembledMessage completed_;
+    };
+
+  } // namespace mesh
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_MESH_PACKET_H
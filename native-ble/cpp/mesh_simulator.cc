@@ -0,0 +1,716 @@
+/**
+ * @file mesh_simulator.cc
+ * @brief Implementation of the discrete-event mesh simulator
+ */
+
+#include "mesh_simulator.h"
+
+#include "dedup_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    namespace
+    {
+      using ghostmesh::ble::HashBytes64;
+      using ghostmesh::ble::TimeBucketedSet;
+
+      constexpr uint16_t kSimCompanyId = 0xFFFF;
+      constexpr uint64_t kBroadcastId = 0xFFFFFFFFFFull;
+      constexpr uint8_t kChannels = 3;               ///< Primary advertising channels 37-39
+      constexpr uint32_t kInterPduGapUs = 150;       ///< Between the PDUs of one advertising event
+      constexpr uint32_t kMaxAdvertisingDelayUs = 10000; ///< advDelay added to every event
+      constexpr uint32_t kScanDuplicateWindowMs = 1000;  ///< As DuplicateFilter
+      constexpr size_t kScanDuplicateCapacity = 512;
+      constexpr size_t kSeenCapacity = 1024;
+      constexpr uint8_t kMaxHopCount = 0x7F;
+      constexpr double kPi = 3.14159265358979323846;
+
+      // splitmix64 finalizer; seeds the generators and hashes link identities
+      uint64_t Mix64(uint64_t x)
+      {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+      }
+
+      // [0, 1) from the top 53 bits
+      double ToUnit(uint64_t bits)
+      {
+        return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+      }
+
+      // Box-Muller; 1 - u1 keeps the logarithm finite
+      double StandardNormal(double u1, double u2)
+      {
+        return std::sqrt(-2.0 * std::log(1.0 - u1)) * std::cos(2.0 * kPi * u2);
+      }
+
+      double DbmToMw(double dbm)
+      {
+        return std::exp(dbm * (2.302585092994046 / 10.0));
+      }
+
+      /**
+       * splitmix64 stream; the standard distributions are implementation
+       * defined, so draws are derived by hand to keep runs reproducible
+       */
+      class Random
+      {
+      public:
+        explicit Random(uint64_t seed) : state_(seed) {}
+
+        uint64_t Next()
+        {
+          uint64_t z = Mix64(state_);
+          state_ += 0x9E3779B97F4A7C15ull;
+          return z;
+        }
+
+        double Uniform() { return ToUnit(Next()); }
+
+        uint64_t Below(uint64_t bound) { return bound > 0 ? Next() % bound : 0; }
+
+        double Normal()
+        {
+          double u1 = Uniform();
+          return StandardNormal(u1, Uniform());
+        }
+
+      private:
+        uint64_t state_;
+      };
+
+      enum class EventType : uint8_t
+      {
+        Originate, ///< ref: broadcast index
+        Advertise, ///< Next advertising event of `node`
+        TxEnd,     ///< ref: transmission whose receptions are resolved
+        RelayDue   ///< ref: pending relay whose backoff elapsed
+      };
+
+      struct Event
+      {
+        uint64_t timeUs;
+        uint64_t seq; ///< Ties run in scheduling order
+        EventType type;
+        uint32_t node;
+        uint32_t ref;
+      };
+
+      struct Later
+      {
+        bool operator()(const Event &a, const Event &b) const
+        {
+          return a.timeUs != b.timeUs ? a.timeUs > b.timeUs : a.seq > b.seq;
+        }
+      };
+
+      struct Frame
+      {
+        uint32_t refs; ///< Queue entry plus PDUs still on the air
+        uint16_t length;
+        uint8_t bytes[kMeshHeaderSize + kMeshMaxDataSize];
+      };
+
+      struct Transmission
+      {
+        uint64_t startUs;
+        uint64_t endUs;
+        uint32_t node;
+        uint32_t frame;
+        uint8_t channel;
+      };
+
+      struct Queued
+      {
+        uint32_t frame;
+        uint32_t remaining; ///< Advertising events left
+      };
+
+      struct Link
+      {
+        uint32_t node;
+        float rxDbm; ///< Before fading
+      };
+
+      struct Node
+      {
+        uint64_t id;
+        SimPosition position;
+        std::vector<Link> links; ///< Nodes that can hear this one at some fading draw
+        std::deque<Queued> queue;
+        bool advertising = false; ///< An Advertise event is pending
+        uint64_t nextEventUs = 0; ///< Earliest start of the next advertising event
+        uint64_t eventStartUs = 0; ///< Latest advertising event
+        uint64_t eventEndUs = 0;
+        uint64_t scanPhaseUs = 0;
+        uint16_t nextMessageId = 0;
+        std::unique_ptr<TimeBucketedSet> scanFilter; ///< The adapter's DuplicateFilter
+        std::unique_ptr<TimeBucketedSet> seen;       ///< The mesh layer's seen-message cache
+        std::unique_ptr<MessageAssembler> assembler;
+        std::unique_ptr<RelayScheduler> relay;
+      };
+
+      struct PendingRelay
+      {
+        uint64_t key;
+        uint64_t srcId;
+        uint64_t dstId;
+        uint16_t messageId;
+        uint8_t hopCount;
+        std::vector<uint8_t> data;
+      };
+
+      struct Broadcast
+      {
+        uint64_t originUs;
+        uint32_t delivered;
+      };
+
+      class Simulation
+      {
+      public:
+        explicit Simulation(const SimConfig &config);
+
+        SimReport Run();
+
+      private:
+        void Place();
+        void Connect();
+        double LinkDbm(uint32_t a, uint32_t b) const;
+        bool Listening(const Node &node, const Transmission &tx) const;
+
+        void Push(uint64_t timeUs, EventType type, uint32_t node, uint32_t ref);
+        uint32_t AcquireFrame();
+        void ReleaseFrame(uint32_t frame);
+        void Enqueue(uint32_t node, uint64_t srcId, uint64_t dstId, uint16_t messageId, uint8_t hopCount,
+                     const uint8_t *data, size_t length);
+        void Wake(uint32_t node);
+        void Prune(uint8_t channel);
+
+        void Originate(uint32_t broadcast);
+        void Advertise(uint32_t node);
+        void Resolve(uint32_t tx);
+        void Receive(uint32_t node, uint32_t sender, uint32_t frame, double rxDbm);
+        void RelayDue(uint32_t node, uint32_t pending);
+
+        SimConfig config_;
+        Random random_;
+        uint64_t linkSeed_;
+        uint64_t nowUs_;
+        uint64_t seq_;
+        uint32_t airtimeUs_;
+        uint64_t advertisingIntervalUs_;
+        uint64_t scanIntervalUs_;
+        uint64_t scanWindowUs_;
+
+        std::vector<Node> nodes_;
+        std::priority_queue<Event, std::vector<Event>, Later> events_;
+        std::vector<Frame> frames_;
+        std::vector<uint32_t> freeFrames_;
+        std::vector<Transmission> txs_;
+        std::vector<uint32_t> freeTxs_;
+        std::vector<uint32_t> onAir_[kChannels]; ///< PDUs that may still overlap an unresolved one
+        std::vector<uint32_t> overlapping_;      ///< Senders of the PDUs overlapping the one being resolved
+        std::vector<PendingRelay> relays_;
+        std::vector<uint32_t> freeRelays_;
+        std::vector<Broadcast> broadcasts_;
+        std::unordered_map<uint64_t, uint32_t> byKey_;
+        std::vector<double> latencies_;
+
+        uint64_t audibleLinks_;
+        uint64_t eventCount_;
+        uint64_t pdus_;
+        uint64_t collisions_;
+        uint64_t missedScans_;
+        uint64_t halfDuplex_;
+        uint64_t queueDrops_;
+      };
+
+      Simulation::Simulation(const SimConfig &config)
+          : config_(config), random_(Mix64(config.seed)), linkSeed_(Mix64(~config.seed)), nowUs_(0), seq_(0),
+            audibleLinks_(0), eventCount_(0), pdus_(0), collisions_(0), missedScans_(0), halfDuplex_(0),
+            queueDrops_(0)
+      {
+        config_.advertisingIntervalMs = std::max<uint32_t>(20, config_.advertisingIntervalMs);
+        config_.advertisingRepeats = std::max<uint32_t>(1, config_.advertisingRepeats);
+        config_.scanIntervalMs = std::max<uint32_t>(1, config_.scanIntervalMs);
+        config_.scanWindowMs = std::min(std::max<uint32_t>(1, config_.scanWindowMs), config_.scanIntervalMs);
+        config_.txQueueLimit = std::max<size_t>(1, config_.txQueueLimit);
+        config_.fragmentSize = std::min(std::max(config_.fragmentSize, kMeshDataSize), kMeshMaxDataSize);
+        config_.payloadSize = std::min(config_.payloadSize, config_.fragmentSize * kMeshMaxFragments);
+        config_.maxHops = std::min(config_.maxHops, kMaxHopCount);
+
+        airtimeUs_ = AdvertisingPduAirtimeUs(kMeshHeaderSize + config_.fragmentSize);
+        advertisingIntervalUs_ = uint64_t(config_.advertisingIntervalMs) * 1000;
+        scanIntervalUs_ = uint64_t(config_.scanIntervalMs) * 1000;
+        scanWindowUs_ = uint64_t(config_.scanWindowMs) * 1000;
+
+        Place();
+        Connect();
+      }
+
+      void Simulation::Place()
+      {
+        size_t count = config_.positions.empty() ? config_.nodeCount : config_.positions.size();
+        count = std::min(std::max<size_t>(1, count), kSimMaxNodes);
+        nodes_.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+          Node &node = nodes_[i];
+          node.id = i + 1;
+          if (config_.positions.empty())
+          {
+            node.position.x = random_.Uniform() * config_.areaWidthM;
+            node.position.y = random_.Uniform() * config_.areaHeightM;
+          }
+          else
+          {
+            node.position = config_.positions[i];
+          }
+          node.scanPhaseUs = random_.Below(scanIntervalUs_ * kChannels);
+          node.scanFilter.reset(new TimeBucketedSet(kScanDuplicateWindowMs, kScanDuplicateCapacity));
+          node.seen.reset(new TimeBucketedSet(config_.dedupWindowMs, kSeenCapacity));
+          node.assembler.reset(new MessageAssembler(config_.assemblerCapacity, config_.fragmentSize));
+
+          // Same parameters everywhere, independent backoff streams
+          RelayConfig relay = config_.relay;
+          relay.seed = static_cast<uint32_t>(Mix64(config_.seed ^ (uint64_t(config_.relay.seed) << 32) ^ node.id));
+          if (relay.seed == 0)
+            relay.seed = 1;
+          node.relay.reset(new RelayScheduler(relay));
+        }
+      }
+
+      // Links that some fading draw can lift above sensitivity; O(n^2) once per run
+      void Simulation::Connect()
+      {
+        double floor = config_.sensitivityDbm - 3.0 * config_.fadingDb;
+        for (uint32_t a = 0; a < nodes_.size(); ++a)
+        {
+          for (uint32_t b = a + 1; b < nodes_.size(); ++b)
+          {
+            double rx = LinkDbm(a, b);
+            if (rx < floor)
+              continue;
+            nodes_[a].links.push_back(Link{b, static_cast<float>(rx)});
+            nodes_[b].links.push_back(Link{a, static_cast<float>(rx)});
+            if (rx >= config_.sensitivityDbm)
+              audibleLinks_ += 2;
+          }
+        }
+      }
+
+      // Symmetric: shadowing is keyed on the unordered pair
+      double Simulation::LinkDbm(uint32_t a, uint32_t b) const
+      {
+        const SimPosition &pa = nodes_[a].position;
+        const SimPosition &pb = nodes_[b].position;
+        double distance = std::max(1.0, std::hypot(pa.x - pb.x, pa.y - pb.y));
+        double loss = config_.referenceLossDb + 10.0 * config_.pathLossExponent * std::log10(distance);
+
+        uint64_t pair = (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+        uint64_t h1 = Mix64(linkSeed_ ^ pair);
+        uint64_t h2 = Mix64(h1);
+        double shadowing = config_.shadowingDb * StandardNormal(ToUnit(h1), ToUnit(h2));
+        return config_.txPowerDbm - loss + shadowing;
+      }
+
+      // Scanners hop 37 -> 38 -> 39 once per scan interval; a PDU straddling a hop is lost
+      bool Simulation::Listening(const Node &node, const Transmission &tx) const
+      {
+        uint64_t start = tx.startUs + node.scanPhaseUs;
+        uint64_t end = tx.endUs + node.scanPhaseUs;
+        if (start / scanIntervalUs_ != end / scanIntervalUs_)
+          return false;
+        if (end % scanIntervalUs_ >= scanWindowUs_)
+          return false;
+        return (start / scanIntervalUs_) % kChannels == tx.channel;
+      }
+
+      void Simulation::Push(uint64_t timeUs, EventType type, uint32_t node, uint32_t ref)
+      {
+        events_.push(Event{timeUs, seq_++, type, node, ref});
+      }
+
+      uint32_t Simulation::AcquireFrame()
+      {
+        if (freeFrames_.empty())
+        {
+          frames_.emplace_back();
+          return static_cast<uint32_t>(frames_.size() - 1);
+        }
+        uint32_t frame = freeFrames_.back();
+        freeFrames_.pop_back();
+        return frame;
+      }
+
+      void Simulation::ReleaseFrame(uint32_t frame)
+      {
+        if (--frames_[frame].refs == 0)
+          freeFrames_.push_back(frame);
+      }
+
+      // Fragment as the mesh layer does: fixed-size DATA, zero padded, last one flagged
+      void Simulation::Enqueue(uint32_t node, uint64_t srcId, uint64_t dstId, uint16_t messageId, uint8_t hopCount,
+                               const uint8_t *data, size_t length)
+      {
+        size_t fragmentSize = config_.fragmentSize;
+        size_t count = std::min(std::max<size_t>(1, (length + fragmentSize - 1) / fragmentSize), kMeshMaxFragments);
+        Node &target = nodes_[node];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+          uint32_t index = AcquireFrame();
+          Frame &frame = frames_[index];
+          frame.refs = 1;
+          frame.length = static_cast<uint16_t>(kMeshHeaderSize + fragmentSize);
+
+          uint8_t *out = frame.bytes;
+          out[0] = kSimCompanyId & 0xFF;
+          out[1] = kSimCompanyId >> 8;
+          for (int b = 0; b < 5; ++b)
+          {
+            out[2 + b] = static_cast<uint8_t>(dstId >> (8 * b));
+            out[7 + b] = static_cast<uint8_t>(srcId >> (8 * b));
+          }
+          uint16_t msgIdRaw = static_cast<uint16_t>(((messageId & 0x0FFF) << 4) | i);
+          out[12] = static_cast<uint8_t>(msgIdRaw);
+          out[13] = static_cast<uint8_t>(msgIdRaw >> 8);
+          out[14] = static_cast<uint8_t>(hopCount | (i + 1 == count ? kMeshLastFragmentFlag : 0));
+
+          size_t offset = i * fragmentSize;
+          size_t chunk = offset < length ? std::min(fragmentSize, length - offset) : 0;
+          std::copy(data + offset, data + offset + chunk, out + kMeshHeaderSize);
+          std::fill(out + kMeshHeaderSize + chunk, out + kMeshHeaderSize + fragmentSize, 0);
+
+          if (target.queue.size() >= config_.txQueueLimit)
+          {
+            ReleaseFrame(target.queue.front().frame);
+            target.queue.pop_front();
+            ++queueDrops_;
+          }
+          target.queue.push_back(Queued{index, config_.advertisingRepeats});
+        }
+        Wake(node);
+      }
+
+      void Simulation::Wake(uint32_t node)
+      {
+        Node &target = nodes_[node];
+        if (target.advertising || target.queue.empty())
+          return;
+        uint64_t start = std::max(nowUs_, target.nextEventUs) + random_.Below(kMaxAdvertisingDelayUs + 1);
+        target.advertising = true;
+        Push(start, EventType::Advertise, node, 0);
+      }
+
+      // Drop PDUs that ended too long ago to overlap any PDU still to be resolved
+      void Simulation::Prune(uint8_t channel)
+      {
+        std::vector<uint32_t> &list = onAir_[channel];
+        for (size_t i = 0; i < list.size();)
+        {
+          const Transmission &tx = txs_[list[i]];
+          if (tx.endUs + airtimeUs_ > nowUs_)
+          {
+            ++i;
+            continue;
+          }
+          ReleaseFrame(tx.frame);
+          freeTxs_.push_back(list[i]);
+          list[i] = list.back();
+          list.pop_back();
+        }
+      }
+
+      void Simulation::Originate(uint32_t broadcast)
+      {
+        uint32_t source = static_cast<uint32_t>(random_.Below(nodes_.size()));
+        Node &node = nodes_[source];
+        uint16_t messageId = node.nextMessageId++ & 0x0FFF;
+        uint64_t key = MessageKey(node.id, messageId);
+
+        std::vector<uint8_t> payload(config_.payloadSize);
+        for (uint8_t &byte : payload)
+          byte = static_cast<uint8_t>(random_.Next());
+
+        broadcasts_[broadcast] = Broadcast{nowUs_, 0};
+        byKey_[key] = broadcast;
+        node.seen->CheckAndInsert(key, nowUs_ / 1000);
+        Enqueue(source, node.id, kBroadcastId, messageId, 0, payload.data(), payload.size());
+      }
+
+      // One advertising event: the front fragment on all three channels, then rotate
+      void Simulation::Advertise(uint32_t node)
+      {
+        Node &sender = nodes_[node];
+        sender.advertising = false;
+        if (sender.queue.empty())
+          return;
+
+        Queued entry = sender.queue.front();
+        sender.queue.pop_front();
+        for (uint8_t channel = 0; channel < kChannels; ++channel)
+        {
+          uint32_t index;
+          if (freeTxs_.empty())
+          {
+            index = static_cast<uint32_t>(txs_.size());
+            txs_.emplace_back();
+          }
+          else
+          {
+            index = freeTxs_.back();
+            freeTxs_.pop_back();
+          }
+          uint64_t start = nowUs_ + channel * uint64_t(airtimeUs_ + kInterPduGapUs);
+          txs_[index] = Transmission{start, start + airtimeUs_, node, entry.frame, channel};
+          ++frames_[entry.frame].refs;
+          onAir_[channel].push_back(index);
+          Push(start + airtimeUs_, EventType::TxEnd, node, index);
+          ++pdus_;
+        }
+        sender.eventStartUs = nowUs_;
+        sender.eventEndUs = nowUs_ + kChannels * uint64_t(airtimeUs_) + (kChannels - 1) * kInterPduGapUs;
+        sender.nextEventUs = nowUs_ + advertisingIntervalUs_;
+
+        if (--entry.remaining > 0)
+          sender.queue.push_back(entry);
+        else
+          ReleaseFrame(entry.frame);
+        Wake(node);
+      }
+
+      void Simulation::Resolve(uint32_t index)
+      {
+        const Transmission tx = txs_[index];
+        overlapping_.clear();
+        for (uint32_t other : onAir_[tx.channel])
+        {
+          const Transmission &o = txs_[other];
+          if (other != index && o.startUs < tx.endUs && o.endUs > tx.startUs)
+            overlapping_.push_back(o.node);
+        }
+
+        for (const Link &link : nodes_[tx.node].links)
+        {
+          const Node &receiver = nodes_[link.node];
+          if (receiver.eventStartUs < tx.endUs && receiver.eventEndUs > tx.startUs)
+          {
+            ++halfDuplex_;
+            continue;
+          }
+          if (!Listening(receiver, tx))
+          {
+            ++missedScans_;
+            continue;
+          }
+          double rx = link.rxDbm + (config_.fadingDb > 0 ? config_.fadingDb * random_.Normal() : 0.0);
+          if (rx < config_.sensitivityDbm)
+            continue;
+
+          // Stop summing as soon as the capture margin is lost
+          double limitMw = DbmToMw(rx - config_.captureDb);
+          double interferenceMw = 0;
+          for (uint32_t other : overlapping_)
+          {
+            interferenceMw += DbmToMw(LinkDbm(other, link.node));
+            if (interferenceMw > limitMw)
+              break;
+          }
+          if (interferenceMw > limitMw)
+          {
+            ++collisions_;
+            continue;
+          }
+
+          Receive(link.node, tx.node, tx.frame, rx);
+        }
+        Prune(tx.channel);
+      }
+
+      // What the adapter and mesh layer do with one decoded advertisement
+      void Simulation::Receive(uint32_t index, uint32_t sender, uint32_t frameIndex, double rxDbm)
+      {
+        Node &node = nodes_[index];
+        const Frame &frame = frames_[frameIndex];
+        uint64_t nowMs = nowUs_ / 1000;
+
+        if (node.scanFilter->CheckAndInsert(HashBytes64(frame.bytes, frame.length, Mix64(sender)), nowMs))
+          return;
+
+        MeshPacket packet;
+        if (!DecodeMeshPacket(frame.bytes, frame.length, packet) || packet.companyId != kSimCompanyId)
+          return;
+
+        uint64_t key = MessageKey(packet.srcId, packet.messageId);
+        if (node.seen->Contains(key, nowMs))
+        {
+          // One copy per relaying neighbour: count its first fragment only
+          if (packet.packetNumber == 0 && config_.suppression)
+            node.relay->Overheard(key);
+          return;
+        }
+
+        const AssembledMessage *message = node.assembler->Push(packet, nowMs);
+        if (message == nullptr)
+          return;
+        node.seen->CheckAndInsert(key, nowMs);
+
+        auto it = byKey_.find(key);
+        if (it != byKey_.end())
+        {
+          Broadcast &broadcast = broadcasts_[it->second];
+          ++broadcast.delivered;
+          latencies_.push_back(double(nowUs_ - broadcast.originUs) / 1000.0);
+        }
+
+        if (message->hopCount >= config_.maxHops)
+          return;
+
+        uint32_t backoffMs = node.relay->Schedule(key, static_cast<int32_t>(std::lround(rxDbm)), nowMs);
+        uint32_t pending;
+        if (freeRelays_.empty())
+        {
+          pending = static_cast<uint32_t>(relays_.size());
+          relays_.emplace_back();
+        }
+        else
+        {
+          pending = freeRelays_.back();
+          freeRelays_.pop_back();
+        }
+        PendingRelay &relay = relays_[pending];
+        relay.key = key;
+        relay.srcId = message->srcId;
+        relay.dstId = message->dstId;
+        relay.messageId = message->messageId;
+        relay.hopCount = message->hopCount;
+        relay.data.assign(message->data, message->data + message->length);
+        Push(nowUs_ + uint64_t(backoffMs) * 1000, EventType::RelayDue, index, pending);
+      }
+
+      void Simulation::RelayDue(uint32_t node, uint32_t pending)
+      {
+        const PendingRelay &relay = relays_[pending];
+        if (nodes_[node].relay->Release(relay.key))
+          Enqueue(node, relay.srcId, relay.dstId, relay.messageId, static_cast<uint8_t>(relay.hopCount + 1),
+                  relay.data.data(), relay.data.size());
+        freeRelays_.push_back(pending);
+      }
+
+      double Percentile(const std::vector<double> &sorted, double p)
+      {
+        if (sorted.empty())
+          return 0.0;
+        size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::min(sorted.size(), std::max<size_t>(1, rank)) - 1];
+      }
+
+      SimReport Simulation::Run()
+      {
+        uint64_t intervalUs = uint64_t(config_.messageIntervalMs) * 1000;
+        broadcasts_.resize(config_.messageCount);
+        for (uint32_t i = 0; i < config_.messageCount; ++i)
+          Push(i * intervalUs, EventType::Originate, 0, i);
+
+        uint64_t lastUs = config_.messageCount > 0 ? (config_.messageCount - 1) * intervalUs : 0;
+        uint64_t endUs = lastUs + uint64_t(config_.drainMs) * 1000;
+        while (!events_.empty() && events_.top().timeUs <= endUs)
+        {
+          Event event = events_.top();
+          events_.pop();
+          nowUs_ = event.timeUs;
+          ++eventCount_;
+          switch (event.type)
+          {
+          case EventType::Originate:
+            Originate(event.ref);
+            break;
+          case EventType::Advertise:
+            Advertise(event.node);
+            break;
+          case EventType::TxEnd:
+            Resolve(event.ref);
+            break;
+          case EventType::RelayDue:
+            RelayDue(event.node, event.ref);
+            break;
+          }
+        }
+
+        SimReport report = SimReport();
+        uint32_t others = static_cast<uint32_t>(nodes_.size() - 1);
+        double messages = std::max<uint32_t>(1, config_.messageCount);
+        report.nodes = static_cast<uint32_t>(nodes_.size());
+        report.messages = config_.messageCount;
+        report.meanNeighbours = double(audibleLinks_) / nodes_.size();
+
+        uint64_t delivered = 0;
+        for (const Broadcast &broadcast : broadcasts_)
+        {
+          delivered += broadcast.delivered;
+          if (broadcast.delivered >= others)
+            ++report.fullyDelivered;
+        }
+        report.deliveryRatio = others > 0 ? double(delivered) / (messages * others) : 1.0;
+
+        std::sort(latencies_.begin(), latencies_.end());
+        report.latencyP50Ms = Percentile(latencies_, 0.50);
+        report.latencyP90Ms = Percentile(latencies_, 0.90);
+        report.latencyP99Ms = Percentile(latencies_, 0.99);
+        report.latencyMaxMs = latencies_.empty() ? 0.0 : latencies_.back();
+
+        report.pdus = pdus_;
+        report.airtimePerMessageMs = double(pdus_) * airtimeUs_ / 1000.0 / messages;
+        report.pdusPerMessage = double(pdus_) / messages;
+        report.collisions = collisions_;
+        report.missedScans = missedScans_;
+        report.halfDuplex = halfDuplex_;
+        report.queueDrops = queueDrops_;
+
+        for (const Node &node : nodes_)
+        {
+          RelayStats relay = node.relay->Stats();
+          report.relay.pending += relay.pending;
+          report.relay.scheduled += relay.scheduled;
+          report.relay.relayed += relay.relayed;
+          report.relay.suppressed += relay.suppressed;
+          report.relay.overflowed += relay.overflowed;
+          AssemblerStats assembler = node.assembler->Stats();
+          report.assemblerEvicted += assembler.evicted;
+          report.assemblerExpired += assembler.expired;
+        }
+        report.relaysPerMessage = double(report.relay.relayed) / messages;
+        report.simulatedMs = double(nowUs_) / 1000.0;
+        report.events = eventCount_;
+        return report;
+      }
+    } // namespace
+
+    // Preamble, access address, header, AdvA, one AD structure (length, type, data), CRC; 8 us per byte
+    uint32_t AdvertisingPduAirtimeUs(size_t manufacturerLength)
+    {
+      return static_cast<uint32_t>(8 * (1 + 4 + 2 + 6 + 2 + manufacturerLength + 3));
+    }
+
+    SimReport SimulateMesh(const SimConfig &config)
+    {
+      Simulation simulation(config);
+      return simulation.Run();
+    }
+
+  } // namespace mesh
+} // namespace ghostmesh
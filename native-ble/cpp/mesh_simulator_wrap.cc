@@ -0,0 +1,203 @@
+/**
+ * @file mesh_simulator_wrap.cc
+ * @brief N-API binding for the discrete-event mesh simulator
+ */
+
+#include "mesh_simulator_wrap.h"
+
+#include "relay_scheduler_wrap.h"
+
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+  using ghostmesh::mesh::SimConfig;
+  using ghostmesh::mesh::SimPosition;
+  using ghostmesh::mesh::SimReport;
+
+  template <typename T>
+  void ReadOption(const Napi::Object &options, const char *name, T &field)
+  {
+    if (!options.Has(name) || !options.Get(name).IsNumber())
+      return;
+    Napi::Number value = options.Get(name).As<Napi::Number>();
+    field = std::is_floating_point<T>::value ? static_cast<T>(value.DoubleValue())
+                                             : static_cast<T>(value.Int64Value());
+  }
+
+  void ReadOption(const Napi::Object &options, const char *name, bool &field)
+  {
+    if (options.Has(name) && options.Get(name).IsBoolean())
+      field = options.Get(name).As<Napi::Boolean>().Value();
+  }
+
+  // Returns false (with a pending exception) on a malformed `positions`
+  bool ConfigFromObject(Napi::Env env, const Napi::Object &options, SimConfig &config)
+  {
+    ReadOption(options, "nodeCount", config.nodeCount);
+    ReadOption(options, "areaWidthM", config.areaWidthM);
+    ReadOption(options, "areaHeightM", config.areaHeightM);
+    ReadOption(options, "txPowerDbm", config.txPowerDbm);
+    ReadOption(options, "referenceLossDb", config.referenceLossDb);
+    ReadOption(options, "pathLossExponent", config.pathLossExponent);
+    ReadOption(options, "shadowingDb", config.shadowingDb);
+    ReadOption(options, "fadingDb", config.fadingDb);
+    ReadOption(options, "sensitivityDbm", config.sensitivityDbm);
+    ReadOption(options, "captureDb", config.captureDb);
+    ReadOption(options, "advertisingIntervalMs", config.advertisingIntervalMs);
+    ReadOption(options, "advertisingRepeats", config.advertisingRepeats);
+    ReadOption(options, "scanIntervalMs", config.scanIntervalMs);
+    ReadOption(options, "scanWindowMs", config.scanWindowMs);
+    ReadOption(options, "txQueueLimit", config.txQueueLimit);
+    ReadOption(options, "fragmentSize", config.fragmentSize);
+    ReadOption(options, "maxHops", config.maxHops);
+    ReadOption(options, "suppression", config.suppression);
+    ReadOption(options, "dedupWindowMs", config.dedupWindowMs);
+    ReadOption(options, "assemblerCapacity", config.assemblerCapacity);
+    ReadOption(options, "messageCount", config.messageCount);
+    ReadOption(options, "messageIntervalMs", config.messageIntervalMs);
+    ReadOption(options, "payloadSize", config.payloadSize);
+    ReadOption(options, "drainMs", config.drainMs);
+    ReadOption(options, "seed", config.seed);
+
+    if (options.Has("relay") && options.Get("relay").IsObject())
+      config.relay = RelaySchedulerWrap::ConfigFromObject(options.Get("relay").As<Napi::Object>());
+
+    if (!options.Has("positions") || options.Get("positions").IsUndefined())
+      return true;
+    if (!options.Get("positions").IsArray())
+    {
+      Napi::TypeError::New(env, "positions must be an array of { x, y }").ThrowAsJavaScriptException();
+      return false;
+    }
+    Napi::Array positions = options.Get("positions").As<Napi::Array>();
+    config.positions.reserve(positions.Length());
+    for (uint32_t i = 0; i < positions.Length(); ++i)
+    {
+      Napi::Value entry = positions.Get(i);
+      if (!entry.IsObject() || !entry.As<Napi::Object>().Get("x").IsNumber() ||
+          !entry.As<Napi::Object>().Get("y").IsNumber())
+      {
+        Napi::TypeError::New(env, "positions must be an array of { x, y }").ThrowAsJavaScriptException();
+        return false;
+      }
+      Napi::Object point = entry.As<Napi::Object>();
+      config.positions.push_back(SimPosition{point.Get("x").As<Napi::Number>().DoubleValue(),
+                                             point.Get("y").As<Napi::Number>().DoubleValue()});
+    }
+    return true;
+  }
+
+  Napi::Number Num(Napi::Env env, double value)
+  {
+    return Napi::Number::New(env, value);
+  }
+
+  Napi::Object ReportToObject(Napi::Env env, const SimReport &report)
+  {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("nodes", Num(env, report.nodes));
+    obj.Set("messages", Num(env, report.messages));
+    obj.Set("meanNeighbours", Num(env, report.meanNeighbours));
+    obj.Set("deliveryRatio", Num(env, report.deliveryRatio));
+    obj.Set("fullyDelivered", Num(env, report.fullyDelivered));
+    obj.Set("latencyP50Ms", Num(env, report.latencyP50Ms));
+    obj.Set("latencyP90Ms", Num(env, report.latencyP90Ms));
+    obj.Set("latencyP99Ms", Num(env, report.latencyP99Ms));
+    obj.Set("latencyMaxMs", Num(env, report.latencyMaxMs));
+    obj.Set("airtimePerMessageMs", Num(env, report.airtimePerMessageMs));
+    obj.Set("pdusPerMessage", Num(env, report.pdusPerMessage));
+    obj.Set("relaysPerMessage", Num(env, report.relaysPerMessage));
+    obj.Set("pdus", Num(env, static_cast<double>(report.pdus)));
+    obj.Set("collisions", Num(env, static_cast<double>(report.collisions)));
+    obj.Set("missedScans", Num(env, static_cast<double>(report.missedScans)));
+    obj.Set("halfDuplex", Num(env, static_cast<double>(report.halfDuplex)));
+    obj.Set("queueDrops", Num(env, static_cast<double>(report.queueDrops)));
+
+    Napi::Object relay = Napi::Object::New(env);
+    relay.Set("pending", Num(env, static_cast<double>(report.relay.pending)));
+    relay.Set("scheduled", Num(env, static_cast<double>(report.relay.scheduled)));
+    relay.Set("relayed", Num(env, static_cast<double>(report.relay.relayed)));
+    relay.Set("suppressed", Num(env, static_cast<double>(report.relay.suppressed)));
+    relay.Set("overflowed", Num(env, static_cast<double>(report.relay.overflowed)));
+    obj.Set("relay", relay);
+
+    obj.Set("assemblerEvicted", Num(env, static_cast<double>(report.assemblerEvicted)));
+    obj.Set("assemblerExpired", Num(env, static_cast<double>(report.assemblerExpired)));
+    obj.Set("simulatedMs", Num(env, report.simulatedMs));
+    obj.Set("events", Num(env, static_cast<double>(report.events)));
+    return obj;
+  }
+
+  /**
+   * Runs SimulateMesh on a pool thread; the config is copied in, so the JS
+   * options object may change while the run is in flight
+   */
+  class SimulationWorker : public Napi::AsyncWorker
+  {
+  public:
+    SimulationWorker(Napi::Env env, SimConfig config)
+        : Napi::AsyncWorker(env, "GhostMeshSimulation"), deferred_(Napi::Promise::Deferred::New(env)),
+          config_(std::move(config)), report_()
+    {
+    }
+
+    Napi::Promise Promise() { return deferred_.Promise(); }
+
+  protected:
+    void Execute() override
+    {
+      report_ = ghostmesh::mesh::SimulateMesh(config_);
+    }
+
+    void OnOK() override
+    {
+      Napi::HandleScope scope(Env());
+      deferred_.Resolve(ReportToObject(Env(), report_));
+    }
+
+    void OnError(const Napi::Error &error) override
+    {
+      deferred_.Reject(error.Value());
+    }
+
+  private:
+    Napi::Promise::Deferred deferred_;
+    SimConfig config_;
+    SimReport report_;
+  };
+} // namespace
+
+Napi::Object MeshSimulatorWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  exports.Set("simulateMesh", Napi::Function::New(env, &MeshSimulatorWrap::Simulate, "simulateMesh"));
+  return exports;
+}
+
+Napi::Value MeshSimulatorWrap::Simulate(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  SimConfig config;
+  if (info.Length() > 0 && !info[0].IsUndefined())
+  {
+    if (!info[0].IsObject())
+    {
+      Napi::TypeError::New(env, "Expected simulation options object").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    if (!ConfigFromObject(env, info[0].As<Napi::Object>(), config))
+      return env.Undefined();
+  }
+  size_t nodes = config.positions.empty() ? config.nodeCount : config.positions.size();
+  if (nodes < 1 || nodes > ghostmesh::mesh::kSimMaxNodes)
+  {
+    Napi::RangeError::New(env, "nodeCount must be between 1 and 65536").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  SimulationWorker *worker = new SimulationWorker(env, std::move(config));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
@@ -0,0 +1,41 @@
+#ifndef NATIVE_BLE_MESH_SIMULATOR_WRAP_H
+#define NATIVE_BLE_MESH_SIMULATOR_WRAP_H
+
+#include <napi.h>
+
+#include "mesh_simulator.h"
+
+/**
+ * @file mesh_simulator_wrap.h
+ * @brief N-API binding for the discrete-event mesh simulator
+ */
+
+/**
+ * @class MeshSimulatorWrap
+ * @brief `simulateMesh` addon function backed by ghostmesh::mesh::SimulateMesh
+ *
+ * A run over thousands of nodes takes seconds, so it executes on the libuv
+ * thread pool and settles a Promise; several runs may be in flight at once.
+ */
+class MeshSimulatorWrap
+{
+public:
+  /**
+   * @brief Register `simulateMesh` on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+private:
+  /**
+   * @brief Run a simulation
+   * @param info [0]: optional SimConfig fields by name, with `positions` as
+   *             [{ x, y }] and `relay` as RelayScheduler options
+   * @return Promise resolved with the SimReport fields by name
+   */
+  static Napi::Value Simulate(const Napi::CallbackInfo &info);
+};
+
+#endif // NATIVE_BLE_MESH_SIMULATOR_WRAP_H
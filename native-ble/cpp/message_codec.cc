@@ -0,0 +1,563 @@
+/**
+ * @file message_codec.cc
+ * @brief Implementation of the compact message codec
+ */
+
+#include "message_codec.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    namespace
+    {
+      constexpr uint8_t kFlagTypeMask = 0x03;
+      constexpr uint8_t kFlagGps = 0x04;
+      constexpr uint8_t kFlagFloatTimestamp = 0x08;
+      constexpr uint8_t kFlagReserved = 0xF0;
+
+      constexpr uint8_t kAddressText = 0x00;
+      constexpr uint8_t kAddressBroadcast = 0x01;
+      constexpr uint8_t kAddressDigits = 0x80;
+      constexpr uint8_t kAddressPlus = 0x40;
+      constexpr size_t kAddressMaxDigits = 31;
+
+      constexpr uint8_t kIdText = 0x00;
+      constexpr uint8_t kIdGenerated = 0x02;
+      constexpr size_t kIdMaxSuffix = 12; ///< 36^12 < 2^63
+
+      constexpr uint64_t kMaxSafeInteger = (uint64_t(1) << 53) - 1;
+      constexpr double kLongitudeScale = 46603.7;
+      constexpr uint32_t kLongitudeMax = 0xFFFFFF;
+
+      const char kBroadcast[] = "BROADCAST";
+      const char kSosEmoji[] = "\xF0\x9F\x86\x98"; // U+1F198
+
+      // Bounds-checked output cursor; a failed write sticks
+      struct Writer
+      {
+        uint8_t *out;
+        size_t capacity;
+        size_t pos = 0;
+        bool ok = true;
+
+        void Byte(uint8_t value)
+        {
+          if (pos >= capacity)
+          {
+            ok = false;
+            return;
+          }
+          out[pos++] = value;
+        }
+
+        void Bytes(const void *data, size_t length)
+        {
+          if (length > capacity - pos || pos > capacity)
+          {
+            ok = false;
+            return;
+          }
+          std::memcpy(out + pos, data, length);
+          pos += length;
+        }
+
+        void Varint(uint64_t value)
+        {
+          while (value >= 0x80)
+          {
+            Byte(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+          }
+          Byte(static_cast<uint8_t>(value));
+        }
+
+        void Text(const char *data, size_t length)
+        {
+          Varint(length);
+          Bytes(data, length);
+        }
+      };
+
+      struct Reader
+      {
+        const uint8_t *buf;
+        size_t length;
+        size_t pos = 0;
+        bool ok = true;
+
+        uint8_t Byte()
+        {
+          if (pos >= length)
+          {
+            ok = false;
+            return 0;
+          }
+          return buf[pos++];
+        }
+
+        const uint8_t *Bytes(size_t count)
+        {
+          if (count > length - pos)
+          {
+            ok = false;
+            return nullptr;
+          }
+          const uint8_t *p = buf + pos;
+          pos += count;
+          return p;
+        }
+
+        uint64_t Varint()
+        {
+          uint64_t value = 0;
+          for (unsigned shift = 0; shift < 64; shift += 7)
+          {
+            uint8_t b = Byte();
+            if (!ok)
+              return 0;
+            if (shift == 63 && b > 1)
+              break;
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+              return value;
+          }
+          ok = false;
+          return 0;
+        }
+
+        void Text(std::string &out)
+        {
+          uint64_t n = Varint();
+          if (!ok || n > length - pos)
+          {
+            ok = false;
+            return;
+          }
+          out.assign(reinterpret_cast<const char *>(buf + pos), static_cast<size_t>(n));
+          pos += static_cast<size_t>(n);
+        }
+      };
+
+      size_t VarintSize(uint64_t value)
+      {
+        size_t n = 1;
+        while (value >= 0x80)
+        {
+          value >>= 7;
+          ++n;
+        }
+        return n;
+      }
+
+      inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+      inline bool IsSpace(char c)
+      {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+      }
+
+      inline bool IsNumberChar(char c) { return IsDigit(c) || c == '-' || c == '.'; }
+
+      bool Contains(const std::string &haystack, const char *needle)
+      {
+        return haystack.find(needle) != std::string::npos;
+      }
+
+      MessageCodecType DetectType(const CodecMessage &message)
+      {
+        if (message.to == kBroadcast)
+          return MessageCodecType::Broadcast;
+        if (Contains(message.content, kSosEmoji))
+          return MessageCodecType::Sos;
+        // ASCII-only case folding is all "SOS" needs
+        for (size_t i = 0; i + 3 <= message.content.size(); ++i)
+        {
+          if ((message.content[i] | 0x20) == 's' && (message.content[i + 1] | 0x20) == 'o' &&
+              (message.content[i + 2] | 0x20) == 's')
+            return MessageCodecType::Sos;
+        }
+        if (Contains(message.content, "GPS:"))
+          return MessageCodecType::Gps;
+        return MessageCodecType::Text;
+      }
+
+      void WriteAddress(Writer &w, const std::string &address)
+      {
+        if (address == kBroadcast)
+        {
+          w.Byte(kAddressBroadcast);
+          return;
+        }
+        size_t start = !address.empty() && address[0] == '+' ? 1 : 0;
+        size_t digits = address.size() - start;
+        bool packable = digits >= 1 && digits <= kAddressMaxDigits;
+        for (size_t i = start; packable && i < address.size(); ++i)
+          packable = IsDigit(address[i]);
+        if (!packable)
+        {
+          w.Byte(kAddressText);
+          w.Text(address.data(), address.size());
+          return;
+        }
+
+        w.Byte(static_cast<uint8_t>(kAddressDigits | (start ? kAddressPlus : 0) | digits));
+        for (size_t i = start; i < address.size(); i += 2)
+        {
+          uint8_t hi = static_cast<uint8_t>(address[i] - '0');
+          uint8_t lo = i + 1 < address.size() ? static_cast<uint8_t>(address[i + 1] - '0') : 0x0F;
+          w.Byte(static_cast<uint8_t>(hi << 4 | lo));
+        }
+      }
+
+      void ReadAddress(Reader &r, std::string &out)
+      {
+        uint8_t header = r.Byte();
+        if (!r.ok)
+          return;
+        if (header == kAddressText)
+        {
+          r.Text(out);
+          return;
+        }
+        if (header == kAddressBroadcast)
+        {
+          out.assign(kBroadcast);
+          return;
+        }
+        size_t digits = header & 0x1F;
+        if ((header & 0xA0) != kAddressDigits || digits == 0)
+        {
+          r.ok = false;
+          return;
+        }
+        const uint8_t *packed = r.Bytes((digits + 1) / 2);
+        if (!r.ok)
+          return;
+        out.clear();
+        if (header & kAddressPlus)
+          out.push_back('+');
+        for (size_t i = 0; i < digits; ++i)
+        {
+          uint8_t nibble = i % 2 == 0 ? packed[i / 2] >> 4 : packed[i / 2] & 0x0F;
+          if (nibble > 9)
+          {
+            r.ok = false;
+            return;
+          }
+          out.push_back(static_cast<char>('0' + nibble));
+        }
+        if (digits % 2 == 1 && (packed[digits / 2] & 0x0F) != 0x0F)
+          r.ok = false;
+      }
+
+      inline uint64_t ZigZag(int64_t value)
+      {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+      }
+
+      inline int64_t UnZigZag(uint64_t value)
+      {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+      }
+
+      inline int Base36Digit(char c)
+      {
+        if (IsDigit(c))
+          return c - '0';
+        if (c >= 'a' && c <= 'z')
+          return c - 'a' + 10;
+        return -1;
+      }
+
+      // "<ms>-<base36>" without leading zeros in ms; the suffix may have them
+      bool ParseGeneratedId(const std::string &id, uint64_t &ms, uint64_t &suffix, size_t &suffixLength)
+      {
+        size_t dash = id.find('-');
+        if (dash == std::string::npos || dash == 0 || dash > 16 || (id[0] == '0' && dash > 1))
+          return false;
+        ms = 0;
+        for (size_t i = 0; i < dash; ++i)
+        {
+          if (!IsDigit(id[i]))
+            return false;
+          ms = ms * 10 + static_cast<uint64_t>(id[i] - '0');
+        }
+        suffixLength = id.size() - dash - 1;
+        if (ms > kMaxSafeInteger || suffixLength == 0 || suffixLength > kIdMaxSuffix)
+          return false;
+        suffix = 0;
+        for (size_t i = dash + 1; i < id.size(); ++i)
+        {
+          int digit = Base36Digit(id[i]);
+          if (digit < 0)
+            return false;
+          suffix = suffix * 36 + static_cast<uint64_t>(digit);
+        }
+        return true;
+      }
+
+      void WriteId(Writer &w, const std::string &id, uint64_t base)
+      {
+        uint64_t ms, suffix;
+        size_t suffixLength;
+        size_t textSize = 1 + VarintSize(id.size()) + id.size();
+        if (ParseGeneratedId(id, ms, suffix, suffixLength))
+        {
+          uint64_t delta = ZigZag(static_cast<int64_t>(ms) - static_cast<int64_t>(base));
+          if (2 + VarintSize(delta) + VarintSize(suffix) <= textSize)
+          {
+            w.Byte(kIdGenerated);
+            w.Varint(delta);
+            w.Byte(static_cast<uint8_t>(suffixLength));
+            w.Varint(suffix);
+            return;
+          }
+        }
+        w.Byte(kIdText);
+        w.Text(id.data(), id.size());
+      }
+
+      void ReadId(Reader &r, std::string &out, uint64_t base)
+      {
+        uint8_t header = r.Byte();
+        if (!r.ok)
+          return;
+        if (header == kIdText)
+        {
+          r.Text(out);
+          return;
+        }
+        if (header != kIdGenerated)
+        {
+          r.ok = false;
+          return;
+        }
+        int64_t ms = static_cast<int64_t>(base) + UnZigZag(r.Varint());
+        size_t suffixLength = r.Byte();
+        uint64_t suffix = r.Varint();
+        if (!r.ok || ms < 0 || static_cast<uint64_t>(ms) > kMaxSafeInteger || suffixLength == 0 ||
+            suffixLength > kIdMaxSuffix)
+        {
+          r.ok = false;
+          return;
+        }
+        char digits[kIdMaxSuffix];
+        for (size_t i = suffixLength; i-- > 0;)
+        {
+          digits[i] = "0123456789abcdefghijklmnopqrstuvwxyz"[suffix % 36];
+          suffix /= 36;
+        }
+        if (suffix != 0)
+        {
+          r.ok = false; // Value wider than its length
+          return;
+        }
+        out = std::to_string(ms);
+        out.push_back('-');
+        out.append(digits, suffixLength);
+      }
+
+      // First "GPS:\s*<number>,\s*<number>" in the content, as src/protocol.ts matches it
+      bool FindGpsFix(const std::string &content, size_t &begin, size_t &end, double &lat, double &lon)
+      {
+        for (size_t at = content.find("GPS:"); at != std::string::npos; at = content.find("GPS:", at + 1))
+        {
+          size_t i = at + 4;
+          while (i < content.size() && IsSpace(content[i]))
+            ++i;
+          size_t latBegin = i;
+          while (i < content.size() && IsNumberChar(content[i]))
+            ++i;
+          size_t latEnd = i;
+          if (latEnd == latBegin || i >= content.size() || content[i] != ',')
+            continue;
+          ++i;
+          while (i < content.size() && IsSpace(content[i]))
+            ++i;
+          size_t lonBegin = i;
+          while (i < content.size() && IsNumberChar(content[i]))
+            ++i;
+          if (i == lonBegin)
+            continue;
+
+          // The first match decides, as with a non-global RegExp
+          std::string latText = content.substr(latBegin, latEnd - latBegin);
+          std::string lonText = content.substr(lonBegin, i - lonBegin);
+          char *stop;
+          lat = std::strtod(latText.c_str(), &stop);
+          if (stop == latText.c_str())
+            return false;
+          lon = std::strtod(lonText.c_str(), &stop);
+          if (stop == lonText.c_str())
+            return false;
+          if (!(lat >= -90 && lat <= 90 && lon >= -180 && lon <= 180))
+            return false;
+          begin = at;
+          end = i;
+          return true;
+        }
+        return false;
+      }
+
+      // Number.prototype.toFixed(6): nearest on the magnitude, ties away from zero
+      void AppendFixed6(std::string &out, double value)
+      {
+        char text[256];
+        std::snprintf(text, sizeof(text), "%.160f", std::fabs(value));
+        const char *dot = std::strchr(text, '.');
+        // Not finite ("nan", "inf"): no digits to round
+        if (dot == nullptr)
+        {
+          out += text;
+          return;
+        }
+        std::string digits(text, static_cast<size_t>(dot - text));
+        digits.append(dot + 1, 6);
+
+        const char *rest = dot + 7;
+        bool above = *rest > '5';
+        bool tie = *rest == '5';
+        if (tie)
+        {
+          for (const char *p = rest + 1; *p != '\0'; ++p)
+          {
+            if (*p != '0')
+            {
+              above = true;
+              tie = false;
+              break;
+            }
+          }
+        }
+        if (above || tie)
+        {
+          size_t i = digits.size();
+          while (i > 0 && digits[i - 1] == '9')
+            digits[--i] = '0';
+          if (i == 0)
+            digits.insert(digits.begin(), '1');
+          else
+            ++digits[i - 1];
+        }
+
+        if (value < 0)
+          out.push_back('-');
+        out.append(digits, 0, digits.size() - 6);
+        out.push_back('.');
+        out.append(digits, digits.size() - 6, 6);
+      }
+    } // namespace
+
+    size_t EncodeMessage(const CodecMessage &message, uint8_t *out, size_t capacity)
+    {
+      Writer w{out, capacity};
+      size_t gpsBegin = 0, gpsEnd = 0;
+      double lat = 0, lon = 0;
+      bool gps = FindGpsFix(message.content, gpsBegin, gpsEnd, lat, lon);
+
+      double ts = message.timestamp;
+      bool varintTimestamp = ts >= 0 && ts <= static_cast<double>(kMaxSafeInteger) && std::floor(ts) == ts;
+      uint8_t flags = static_cast<uint8_t>(DetectType(message)) | (gps ? kFlagGps : 0) |
+                      (varintTimestamp ? 0 : kFlagFloatTimestamp);
+
+      w.Byte(kMessageCodecVersion);
+      w.Byte(flags);
+      w.Varint(message.hops);
+      uint64_t base = 0;
+      if (varintTimestamp)
+      {
+        base = static_cast<uint64_t>(ts);
+        w.Varint(base);
+      }
+      else
+      {
+        w.Bytes(&ts, sizeof(ts));
+      }
+      WriteAddress(w, message.to);
+      WriteAddress(w, message.from);
+      WriteId(w, message.id, base);
+
+      if (!gps)
+      {
+        w.Text(message.content.data(), message.content.size());
+        return w.ok ? w.pos : 0;
+      }
+
+      w.Varint(message.content.size() - (gpsEnd - gpsBegin));
+      w.Bytes(message.content.data(), gpsBegin);
+      w.Bytes(message.content.data() + gpsEnd, message.content.size() - gpsEnd);
+      w.Varint(gpsBegin);
+      float latitude = lat == 0 ? 0.0f : static_cast<float>(lat);
+      w.Bytes(&latitude, sizeof(latitude));
+      double scaled = std::floor((lon + 180) * kLongitudeScale + 0.5);
+      uint32_t longitude = static_cast<uint32_t>(std::fmin(kLongitudeMax, std::fmax(0.0, scaled)));
+      w.Byte(static_cast<uint8_t>(longitude));
+      w.Byte(static_cast<uint8_t>(longitude >> 8));
+      w.Byte(static_cast<uint8_t>(longitude >> 16));
+      return w.ok ? w.pos : 0;
+    }
+
+    size_t DecodeMessage(const uint8_t *buf, size_t length, CodecMessage &out)
+    {
+      Reader r{buf, length};
+      if (r.Byte() != kMessageCodecVersion || !r.ok)
+        return 0;
+      uint8_t flags = r.Byte();
+      if (!r.ok || (flags & kFlagReserved) != 0)
+        return 0;
+
+      out.type = static_cast<MessageCodecType>(flags & kFlagTypeMask);
+      out.hops = r.Varint();
+      uint64_t base = 0;
+      if (flags & kFlagFloatTimestamp)
+      {
+        const uint8_t *p = r.Bytes(sizeof(double));
+        if (!r.ok)
+          return 0;
+        std::memcpy(&out.timestamp, p, sizeof(double));
+      }
+      else
+      {
+        base = r.Varint();
+        if (!r.ok || base > kMaxSafeInteger)
+          return 0;
+        out.timestamp = static_cast<double>(base);
+      }
+      ReadAddress(r, out.to);
+      ReadAddress(r, out.from);
+      ReadId(r, out.id, base);
+      r.Text(out.content);
+      if (!r.ok)
+        return 0;
+
+      if (flags & kFlagGps)
+      {
+        uint64_t at = r.Varint();
+        const uint8_t *p = r.Bytes(7);
+        if (!r.ok || at > out.content.size())
+          return 0;
+        float latitude;
+        std::memcpy(&latitude, p, sizeof(latitude));
+        // Encoders only write fixes FindGpsFix() accepted; anything else is a crafted frame
+        if (!(latitude >= -90 && latitude <= 90))
+          return 0;
+        uint32_t longitude = p[4] | static_cast<uint32_t>(p[5]) << 8 | static_cast<uint32_t>(p[6]) << 16;
+
+        std::string fix = "GPS: ";
+        AppendFixed6(fix, latitude);
+        fix += ", ";
+        AppendFixed6(fix, longitude / kLongitudeScale - 180);
+        out.content.insert(static_cast<size_t>(at), fix);
+      }
+      return r.pos;
+    }
+
+  } // namespace mesh
+} // namespace ghostmesh
@@ -0,0 +1,118 @@
+#ifndef NATIVE_BLE_MESSAGE_CODEC_H
+#define NATIVE_BLE_MESSAGE_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file message_codec.h
+ * @brief Compact binary encoding of GhostMesh text messages
+ *
+ * Native counterpart of `encodeMessage` / `decodeMessage` in src/message-codec.ts,
+ * which replace the JSON `serializeMessage` payload. Both produce identical
+ * bytes.
+ *
+ * Frame layout (varints are unsigned LEB128, multi-byte fields little-endian):
+ * - 1 byte: version (kMessageCodecVersion)
+ * - 1 byte: flags
+ *   - bits 0-1: message type (MessageCodecType), for relays that prioritise
+ *     without decoding the content
+ *   - bit 2: content carried a GPS fix, stored in the trailer
+ *   - bit 3: timestamp is a float64 rather than a varint
+ * - varint: hops
+ * - varint (or 8-byte float64): timestamp, ms since epoch
+ * - address: to
+ * - address: from
+ * - id
+ * - varint length + UTF-8: content, with the GPS fix cut out
+ * - GPS trailer (flag bit 2 only):
+ *   - varint: byte offset in the content where the fix was
+ *   - 4 bytes: latitude (float32)
+ *   - 3 bytes: longitude, (lon + 180) * 46603.7 (~2.4 m), as in the 27-byte
+ *     manufacturer-data layout
+ *
+ * An address is one header byte:
+ * - 0x00: followed by varint length + UTF-8 (any string)
+ * - 0x01: "BROADCAST"
+ * - 0x80 | plus << 6 | n: `n` (1-31) decimal digits, packed two per byte high
+ *   nibble first (odd counts pad with 0xF), preceded by '+' when plus is set
+ *
+ * An id is 0x00 + varint length + UTF-8, or 0x02 for generateMessageId()'s
+ * "<ms>-<base36>" form: zigzag varint of (ms - timestamp), one byte of suffix
+ * length (1-12) and the suffix's value as a varint.
+ *
+ * Everything round-trips exactly except a "GPS: lat, lon" fix in the
+ * content, which comes back quantized and rendered with six decimals.
+ */
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    constexpr uint8_t kMessageCodecVersion = 2;
+
+    /**
+     * @brief Frame bytes beyond the UTF-8 lengths of to, from, id and content
+     */
+    constexpr size_t kMessageFrameOverhead = 64;
+
+    /**
+     * @enum MessageCodecType
+     * @brief Two-bit message type, as detected by encodeToManufacturerData()
+     */
+    enum class MessageCodecType : uint8_t
+    {
+      Text = 0,
+      Sos = 1,
+      Gps = 2,
+      Broadcast = 3,
+    };
+
+    /**
+     * @struct CodecMessage
+     * @brief Fields of a src/protocol.ts `Message`
+     */
+    struct CodecMessage
+    {
+      std::string to;
+      std::string from;
+      std::string content;
+      std::string id;
+      double timestamp = 0;
+      uint64_t hops = 0;
+      MessageCodecType type = MessageCodecType::Text; ///< Set by DecodeMessage only
+    };
+
+    /**
+     * @brief Upper bound on the encoded size of a message
+     */
+    inline size_t MessageEncodedBound(const CodecMessage &message)
+    {
+      return kMessageFrameOverhead + message.to.size() + message.from.size() + message.id.size() +
+             message.content.size();
+    }
+
+    /**
+     * @brief Encode a message into a caller-supplied buffer
+     * @param message Message to encode (type is derived, not read)
+     * @param out Destination
+     * @param capacity Bytes available at `out`
+     * @return Bytes written, or 0 if they do not fit
+     */
+    size_t EncodeMessage(const CodecMessage &message, uint8_t *out, size_t capacity);
+
+    /**
+     * @brief Decode a frame
+     * @param buf Frame bytes
+     * @param length Bytes available; trailing bytes are ignored
+     * @param out Receives the message; its strings keep their capacity across calls
+     * @return Bytes consumed, or 0 if `buf` is not a valid frame
+     */
+    size_t DecodeMessage(const uint8_t *buf, size_t length, CodecMessage &out);
+
+  } // namespace mesh
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_MESSAGE_CODEC_H
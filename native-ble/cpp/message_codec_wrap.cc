@@ -0,0 +1,110 @@
+/**
+ * @file message_codec_wrap.cc
+ * @brief N-API binding for the compact message codec
+ */
+
+#include "message_codec_wrap.h"
+
+#include <cmath>
+
+namespace
+{
+  // Read a JS Message; throws a TypeError and returns false on a bad shape
+  bool MessageArg(Napi::Env env, Napi::Value value, ghostmesh::mesh::CodecMessage &out)
+  {
+    if (!value.IsObject())
+    {
+      Napi::TypeError::New(env, "Expected message object").ThrowAsJavaScriptException();
+      return false;
+    }
+    Napi::Object obj = value.As<Napi::Object>();
+    Napi::Value to = obj.Get("to"), from = obj.Get("from"), content = obj.Get("content"), id = obj.Get("id");
+    if (!to.IsString() || !from.IsString() || !content.IsString() || !id.IsString())
+    {
+      Napi::TypeError::New(env, "Message to, from, content and id must be strings").ThrowAsJavaScriptException();
+      return false;
+    }
+    Napi::Value timestamp = obj.Get("timestamp"), hops = obj.Get("hops");
+    double hopCount = hops.IsNumber() ? hops.As<Napi::Number>().DoubleValue() : -1;
+    if (!timestamp.IsNumber() || !(hopCount >= 0 && hopCount <= 9007199254740991.0 && std::floor(hopCount) == hopCount))
+    {
+      Napi::TypeError::New(env, "Message timestamp must be a number and hops a non-negative integer")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    out.to = to.As<Napi::String>().Utf8Value();
+    out.from = from.As<Napi::String>().Utf8Value();
+    out.content = content.As<Napi::String>().Utf8Value();
+    out.id = id.As<Napi::String>().Utf8Value();
+    out.timestamp = timestamp.As<Napi::Number>().DoubleValue();
+    out.hops = static_cast<uint64_t>(hopCount);
+    return true;
+  }
+
+  // Byte view of a Uint8Array argument from `offset`; throws and returns false otherwise
+  bool BytesArg(const Napi::CallbackInfo &info, size_t index, uint8_t *&data, size_t &length)
+  {
+    Napi::Env env = info.Env();
+    if (info.Length() <= index || !info[index].IsTypedArray() ||
+        info[index].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array)
+    {
+      Napi::TypeError::New(env, "Expected Uint8Array").ThrowAsJavaScriptException();
+      return false;
+    }
+    Napi::Uint8Array bytes = info[index].As<Napi::Uint8Array>();
+    size_t offset = 0;
+    if (info.Length() > index + 1 && info[index + 1].IsNumber())
+      offset = info[index + 1].As<Napi::Number>().Uint32Value();
+    if (offset > bytes.ElementLength())
+    {
+      Napi::RangeError::New(env, "Offset is outside the buffer").ThrowAsJavaScriptException();
+      return false;
+    }
+    data = bytes.Data() + offset;
+    length = bytes.ElementLength() - offset;
+    return true;
+  }
+} // namespace
+
+Napi::Object MessageCodecWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  exports.Set("encodeMessage", Napi::Function::New(env, &MessageCodecWrap::Encode, "encodeMessage"));
+  exports.Set("decodeMessage", Napi::Function::New(env, &MessageCodecWrap::Decode, "decodeMessage"));
+  return exports;
+}
+
+Napi::Value MessageCodecWrap::Encode(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  ghostmesh::mesh::CodecMessage message;
+  if (!MessageArg(env, info.Length() > 0 ? info[0] : env.Undefined(), message))
+    return env.Undefined();
+  uint8_t *out;
+  size_t capacity;
+  if (!BytesArg(info, 1, out, capacity))
+    return env.Undefined();
+  return Napi::Number::New(env, static_cast<double>(ghostmesh::mesh::EncodeMessage(message, out, capacity)));
+}
+
+Napi::Value MessageCodecWrap::Decode(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint8_t *data;
+  size_t length;
+  if (!BytesArg(info, 0, data, length))
+    return env.Undefined();
+
+  // Reused so steady-state decoding does not reallocate the strings
+  thread_local ghostmesh::mesh::CodecMessage message;
+  if (ghostmesh::mesh::DecodeMessage(data, length, message) == 0)
+    return env.Null();
+
+  Napi::Object obj = info.Length() > 2 && info[2].IsObject() ? info[2].As<Napi::Object>() : Napi::Object::New(env);
+  obj.Set("to", Napi::String::New(env, message.to));
+  obj.Set("from", Napi::String::New(env, message.from));
+  obj.Set("content", Napi::String::New(env, message.content));
+  obj.Set("id", Napi::String::New(env, message.id));
+  obj.Set("timestamp", Napi::Number::New(env, message.timestamp));
+  obj.Set("hops", Napi::Number::New(env, static_cast<double>(message.hops)));
+  return obj;
+}
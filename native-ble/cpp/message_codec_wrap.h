@@ -0,0 +1,48 @@
+#ifndef NATIVE_BLE_MESSAGE_CODEC_WRAP_H
+#define NATIVE_BLE_MESSAGE_CODEC_WRAP_H
+
+#include <napi.h>
+
+#include "message_codec.h"
+
+/**
+ * @file message_codec_wrap.h
+ * @brief N-API binding for the compact message codec
+ */
+
+/**
+ * @class MessageCodecWrap
+ * @brief `encodeMessage` / `decodeMessage` addon functions backed by ghostmesh::mesh::EncodeMessage
+ *
+ * Both work on caller-supplied buffers so a sender can encode straight into
+ * the advertising payload it is about to fragment, and a receiver can decode
+ * in place from manufacturer data.
+ */
+class MessageCodecWrap
+{
+public:
+  /**
+   * @brief Register the codec functions on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+private:
+  /**
+   * @brief Encode a message
+   * @param info [0]: { to, from, content, id, timestamp, hops }, [1]: Uint8Array, [2]: optional offset
+   * @return Bytes written, or 0 if the frame does not fit
+   */
+  static Napi::Value Encode(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Decode a message
+   * @param info [0]: Uint8Array, [1]: optional offset, [2]: optional object to fill instead of a new one
+   * @return The message, or null if the bytes are not a valid frame
+   */
+  static Napi::Value Decode(const Napi::CallbackInfo &info);
+};
+
+#endif // NATIVE_BLE_MESSAGE_CODEC_WRAP_H
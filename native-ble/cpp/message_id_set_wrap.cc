@@ -0,0 +1,98 @@
+/**
+ * @file message_id_set_wrap.cc
+ * @brief N-API binding for the time-bucketed message-ID set
+ */
+
+#include "message_id_set_wrap.h"
+
+#include "wrap_args.h"
+
+namespace
+{
+  using ghostmesh::ble::KeyArg;
+  using ghostmesh::ble::NowArg;
+
+  constexpr uint32_t kDefaultWindowMs = 3600000;
+  constexpr size_t kDefaultCapacity = 8192;
+
+  uint32_t UintArg(const Napi::CallbackInfo &info, size_t index, uint32_t fallback)
+  {
+    if (info.Length() > index && info[index].IsNumber())
+      return info[index].As<Napi::Number>().Uint32Value();
+    return fallback;
+  }
+
+  size_t CapacityArg(const Napi::CallbackInfo &info)
+  {
+    uint32_t capacity = UintArg(info, 1, 0);
+    return capacity > 0 ? capacity : kDefaultCapacity;
+  }
+} // namespace
+
+Napi::Object MessageIdSetWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  Napi::Function func = DefineClass(env, "MessageIdSet",
+                                    {
+                                        InstanceMethod("add", &MessageIdSetWrap::Add),
+                                        InstanceMethod("has", &MessageIdSetWrap::Has),
+                                        InstanceMethod("expire", &MessageIdSetWrap::Expire),
+                                        InstanceMethod("size", &MessageIdSetWrap::Size),
+                                        InstanceMethod("clear", &MessageIdSetWrap::Clear),
+                                    });
+  exports.Set("MessageIdSet", func);
+  return exports;
+}
+
+MessageIdSetWrap::MessageIdSetWrap(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<MessageIdSetWrap>(info),
+      set_(UintArg(info, 0, kDefaultWindowMs), CapacityArg(info))
+{
+}
+
+Napi::Value MessageIdSetWrap::Add(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArg(info, key))
+  {
+    Napi::TypeError::New(env, "Expected message ID (string or number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, !set_.CheckAndInsert(key, NowArg(info, 1)));
+}
+
+Napi::Value MessageIdSetWrap::Has(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArg(info, key))
+  {
+    Napi::TypeError::New(env, "Expected message ID (string or number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, set_.Contains(key, NowArg(info, 1)));
+}
+
+Napi::Value MessageIdSetWrap::Expire(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber())
+  {
+    Napi::TypeError::New(env, "Expected age in milliseconds").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  uint64_t olderThanMs = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+  set_.Expire(olderThanMs, NowArg(info, 1));
+  return env.Undefined();
+}
+
+Napi::Value MessageIdSetWrap::Size(const Napi::CallbackInfo &info)
+{
+  return Napi::Number::New(info.Env(), static_cast<double>(set_.Size(NowArg(info, 0))));
+}
+
+Napi::Value MessageIdSetWrap::Clear(const Napi::CallbackInfo &info)
+{
+  set_.Clear();
+  return info.Env().Undefined();
+}
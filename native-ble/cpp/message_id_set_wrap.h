@@ -0,0 +1,79 @@
+#ifndef NATIVE_BLE_MESSAGE_ID_SET_WRAP_H
+#define NATIVE_BLE_MESSAGE_ID_SET_WRAP_H
+
+#include <napi.h>
+
+#include "dedup_cache.h"
+
+/**
+ * @file message_id_set_wrap.h
+ * @brief N-API binding for the time-bucketed message-ID set
+ */
+
+/**
+ * @class MessageIdSetWrap
+ * @brief JS-visible `MessageIdSet` backed by ghostmesh::ble::TimeBucketedSet
+ *
+ * Drop-in replacement for an ever-growing `Set<string>` of seen message IDs:
+ * memory is fixed at construction and IDs age out after the window. IDs may be
+ * strings (hashed) or integer keys such as the 52-bit (srcId, messageId) key.
+ * Every method takes an optional trailing `nowMs` so callers can supply their
+ * own clock; it defaults to Date.now() semantics (ms since epoch).
+ */
+class MessageIdSetWrap : public Napi::ObjectWrap<MessageIdSetWrap>
+{
+public:
+  /**
+   * @brief Register the `MessageIdSet` class on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  /**
+   * @brief Construct a MessageIdSet
+   * @param info [0]: optional window in ms (default 3600000), [1]: optional capacity per window
+   */
+  MessageIdSetWrap(const Napi::CallbackInfo &info);
+
+private:
+  /**
+   * @brief Record an ID
+   * @param info [0]: id (string | number), [1]: optional nowMs
+   * @return true if the ID was new, false if it was already inside the window
+   */
+  Napi::Value Add(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Test for an ID without recording it
+   * @param info [0]: id (string | number), [1]: optional nowMs
+   * @return boolean
+   */
+  Napi::Value Has(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Forget IDs older than a given age
+   * @param info [0]: olderThanMs, [1]: optional nowMs
+   * @return undefined
+   */
+  Napi::Value Expire(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Number of IDs inside the window
+   * @param info [0]: optional nowMs
+   * @return number
+   */
+  Napi::Value Size(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Forget every ID
+   * @param info N-API callback info
+   * @return undefined
+   */
+  Napi::Value Clear(const Napi::CallbackInfo &info);
+
+  ghostmesh::ble::TimeBucketedSet set_;
+};
+
+#endif // NATIVE_BLE_MESSAGE_ID_SET_WRAP_H
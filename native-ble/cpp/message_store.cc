@@ -0,0 +1,514 @@
+/**
+ * @file message_store.cc
+ * @brief Implementation of the memory-mapped message log
+ */
+
+#include "message_store.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    namespace
+    {
+      constexpr char kLogMagic[8] = {'G', 'M', 'M', 'S', 'G', 'L', 'G', '1'};
+      constexpr char kIndexMagic[8] = {'G', 'M', 'M', 'S', 'G', 'I', 'X', '1'};
+      constexpr size_t kIndexHeaderSize = 64;
+      constexpr size_t kMinCapacity = 64;
+
+      std::string SystemError(const char *what, const std::string &path)
+      {
+#ifdef _WIN32
+        return std::string(what) + " " + path + ": error " + std::to_string(GetLastError());
+#else
+        return std::string(what) + " " + path + ": " + std::strerror(errno);
+#endif
+      }
+    } // namespace
+
+    struct MessageStore::LogHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t recordSize;
+      uint64_t count;    ///< Committed records; bumped after the record is written
+      uint64_t capacity; ///< Records the file has room for
+      uint8_t reserved[kMessageStoreHeaderSize - 32];
+    };
+
+    struct MessageStore::IndexHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t reserved0;
+      uint64_t count;    ///< Log records present in both arrays
+      uint64_t capacity; ///< Entries per array
+      uint8_t reserved[kIndexHeaderSize - 32];
+    };
+
+    MappedFile::~MappedFile()
+    {
+      Close();
+    }
+
+#ifdef _WIN32
+
+    // Open or create the file, extend it to minSize and map all of it
+    bool MappedFile::Open(const std::string &path, size_t minSize, std::string &error)
+    {
+      Close();
+      HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE)
+      {
+        error = SystemError("Cannot open", path);
+        return false;
+      }
+      file_ = file;
+
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(file, &size))
+      {
+        error = SystemError("Cannot stat", path);
+        Close();
+        return false;
+      }
+      size_ = std::max(static_cast<size_t>(size.QuadPart), minSize);
+      if (!Map(error))
+      {
+        Close();
+        return false;
+      }
+      return true;
+    }
+
+    // Map the whole file; CreateFileMapping extends it to size_ as needed
+    bool MappedFile::Map(std::string &error)
+    {
+      const uint64_t size = size_;
+      HANDLE mapping = CreateFileMappingA(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+      if (mapping == nullptr)
+      {
+        error = SystemError("Cannot map", "message store");
+        return false;
+      }
+      void *view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size_);
+      if (view == nullptr)
+      {
+        error = SystemError("Cannot map", "message store");
+        CloseHandle(mapping);
+        return false;
+      }
+      mapping_ = mapping;
+      data_ = static_cast<uint8_t *>(view);
+      return true;
+    }
+
+    void MappedFile::Unmap()
+    {
+      if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+      if (mapping_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(mapping_));
+      data_ = nullptr;
+      mapping_ = nullptr;
+    }
+
+    bool MappedFile::Sync(std::string &error)
+    {
+      if (data_ == nullptr)
+        return true;
+      if (!FlushViewOfFile(data_, size_) || !FlushFileBuffers(static_cast<HANDLE>(file_)))
+      {
+        error = SystemError("Cannot sync", "message store");
+        return false;
+      }
+      return true;
+    }
+
+    void MappedFile::Close()
+    {
+      Unmap();
+      if (file_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(file_));
+      file_ = nullptr;
+      size_ = 0;
+    }
+
+#else
+
+    // Open or create the file, extend it to minSize and map all of it
+    bool MappedFile::Open(const std::string &path, size_t minSize, std::string &error)
+    {
+      Close();
+      fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      if (fd_ < 0)
+      {
+        error = SystemError("Cannot open", path);
+        return false;
+      }
+
+      struct stat info;
+      if (::fstat(fd_, &info) != 0)
+      {
+        error = SystemError("Cannot stat", path);
+        Close();
+        return false;
+      }
+      size_ = static_cast<size_t>(info.st_size);
+      if (size_ < minSize)
+      {
+        if (::ftruncate(fd_, static_cast<off_t>(minSize)) != 0)
+        {
+          error = SystemError("Cannot extend", path);
+          Close();
+          return false;
+        }
+        size_ = minSize;
+      }
+      if (!Map(error))
+      {
+        Close();
+        return false;
+      }
+      return true;
+    }
+
+    bool MappedFile::Map(std::string &error)
+    {
+      void *data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+      if (data == MAP_FAILED)
+      {
+        error = SystemError("Cannot map", "message store");
+        return false;
+      }
+      data_ = static_cast<uint8_t *>(data);
+      return true;
+    }
+
+    void MappedFile::Unmap()
+    {
+      if (data_ != nullptr)
+        ::munmap(data_, size_);
+      data_ = nullptr;
+    }
+
+    bool MappedFile::Sync(std::string &error)
+    {
+      if (data_ != nullptr && ::msync(data_, size_, MS_SYNC) != 0)
+      {
+        error = SystemError("Cannot sync", "message store");
+        return false;
+      }
+      return true;
+    }
+
+    void MappedFile::Close()
+    {
+      Unmap();
+      if (fd_ >= 0)
+        ::close(fd_);
+      fd_ = -1;
+      size_ = 0;
+    }
+
+#endif
+
+    // Grow the file and remap it; the new tail reads as zeros
+    bool MappedFile::Resize(size_t size, std::string &error)
+    {
+      if (size <= size_)
+        return true;
+      Unmap();
+#ifndef _WIN32
+      if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+      {
+        error = SystemError("Cannot extend", "message store");
+        std::string ignored;
+        Map(ignored);
+        return false;
+      }
+#endif
+      const size_t previous = size_;
+      size_ = size;
+      if (!Map(error))
+      {
+        size_ = previous;
+        std::string ignored;
+        Map(ignored);
+        return false;
+      }
+      return true;
+    }
+
+    MessageStore::LogHeader *MessageStore::Log() const
+    {
+      return reinterpret_cast<LogHeader *>(log_.Data());
+    }
+
+    MessageStore::IndexHeader *MessageStore::Index() const
+    {
+      return reinterpret_cast<IndexHeader *>(index_.Data());
+    }
+
+    MessageStore::KeyEntry *MessageStore::Keys() const
+    {
+      return reinterpret_cast<KeyEntry *>(index_.Data() + kIndexHeaderSize);
+    }
+
+    MessageStore::TimeEntry *MessageStore::Times() const
+    {
+      return reinterpret_cast<TimeEntry *>(index_.Data() + kIndexHeaderSize + IndexCapacity() * sizeof(KeyEntry));
+    }
+
+    size_t MessageStore::IndexCapacity() const
+    {
+      return static_cast<size_t>(Index()->capacity);
+    }
+
+    // Map both files, initialising fresh ones and re-indexing whatever the index is missing
+    bool MessageStore::Open(const std::string &path, size_t initialCapacity, std::string &error)
+    {
+      Close();
+      const size_t capacity = std::max(initialCapacity, kMinCapacity);
+
+      if (!log_.Open(path, kMessageStoreHeaderSize + capacity * kMessageRecordSize, error))
+        return false;
+
+      LogHeader *log = Log();
+      if (log->version == 0 && std::all_of(log->magic, log->magic + sizeof(log->magic), [](char c)
+                                           { return c == 0; }))
+      {
+        std::memcpy(log->magic, kLogMagic, sizeof(kLogMagic));
+        log->version = kMessageStoreVersion;
+        log->recordSize = kMessageRecordSize;
+        log->count = 0;
+        log->capacity = capacity;
+      }
+      if (std::memcmp(log->magic, kLogMagic, sizeof(kLogMagic)) != 0 || log->version != kMessageStoreVersion ||
+          log->recordSize != kMessageRecordSize)
+      {
+        error = "Not a version " + std::to_string(kMessageStoreVersion) + " message store: " + path;
+        Close();
+        return false;
+      }
+      if (log->count > log->capacity ||
+          kMessageStoreHeaderSize + log->capacity * kMessageRecordSize > log_.Size())
+      {
+        error = "Truncated message store: " + path;
+        Close();
+        return false;
+      }
+
+      const std::string indexPath = path + ".idx";
+      const size_t indexCapacity = std::max(capacity, static_cast<size_t>(log->capacity));
+      if (!index_.Open(indexPath, kIndexHeaderSize + indexCapacity * (sizeof(KeyEntry) + sizeof(TimeEntry)), error))
+      {
+        Close();
+        return false;
+      }
+
+      // Behind the log means an append stopped between committing its record and
+      // indexing it, possibly mid-shift, so the arrays themselves can't be trusted
+      IndexHeader *index = Index();
+      const bool valid = std::memcmp(index->magic, kIndexMagic, sizeof(kIndexMagic)) == 0 &&
+                         index->version == kMessageStoreVersion && index->count == log->count &&
+                         index->count <= index->capacity &&
+                         kIndexHeaderSize + index->capacity * (sizeof(KeyEntry) + sizeof(TimeEntry)) <= index_.Size();
+      if (!valid && !RebuildIndex(error))
+      {
+        Close();
+        return false;
+      }
+      return true;
+    }
+
+    void MessageStore::Close()
+    {
+      index_.Close();
+      log_.Close();
+    }
+
+    size_t MessageStore::Count() const
+    {
+      return log_.IsOpen() ? static_cast<size_t>(Log()->count) : 0;
+    }
+
+    const StoredMessageRecord &MessageStore::Record(size_t position) const
+    {
+      return *reinterpret_cast<const StoredMessageRecord *>(log_.Data() + kMessageStoreHeaderSize +
+                                                            position * kMessageRecordSize);
+    }
+
+    // Double the log's record capacity
+    bool MessageStore::GrowLog(std::string &error)
+    {
+      const size_t capacity = static_cast<size_t>(Log()->capacity) * 2;
+      if (!log_.Resize(kMessageStoreHeaderSize + capacity * kMessageRecordSize, error))
+        return false;
+      Log()->capacity = capacity;
+      return true;
+    }
+
+    // Double the index capacity, moving the time array up behind the larger key array
+    bool MessageStore::GrowIndex(std::string &error)
+    {
+      const size_t previous = IndexCapacity();
+      const size_t capacity = previous * 2;
+      if (!index_.Resize(kIndexHeaderSize + capacity * (sizeof(KeyEntry) + sizeof(TimeEntry)), error))
+        return false;
+
+      // The destination starts past the end of the source, so a crash here leaves
+      // the old layout intact until the capacity below is written
+      uint8_t *base = index_.Data() + kIndexHeaderSize;
+      std::memcpy(base + capacity * sizeof(KeyEntry), base + previous * sizeof(KeyEntry),
+                  static_cast<size_t>(Index()->count) * sizeof(TimeEntry));
+      Index()->capacity = capacity;
+      return true;
+    }
+
+    // Sorted insert of one log record into both arrays; equal keys and times stay in append order
+    void MessageStore::IndexRecord(uint32_t position)
+    {
+      const StoredMessageRecord &record = Record(position);
+      const size_t count = static_cast<size_t>(Index()->count);
+
+      KeyEntry *keys = Keys();
+      KeyEntry *key = std::upper_bound(keys, keys + count, record.key, [](uint64_t value, const KeyEntry &entry)
+                                       { return value < entry.key; });
+      std::memmove(key + 1, key, static_cast<size_t>(keys + count - key) * sizeof(KeyEntry));
+      *key = KeyEntry{record.key, position, 0};
+
+      TimeEntry *times = Times();
+      TimeEntry *time = std::upper_bound(times, times + count, record.timestamp,
+                                         [](double value, const TimeEntry &entry)
+                                         { return value < entry.timestamp; });
+      std::memmove(time + 1, time, static_cast<size_t>(times + count - time) * sizeof(TimeEntry));
+      *time = TimeEntry{record.timestamp, position, 0};
+
+      Index()->count = count + 1;
+    }
+
+    // Unknown, torn, behind or ahead of the log (the log was replaced): index every record again
+    bool MessageStore::RebuildIndex(std::string &error)
+    {
+      IndexHeader *index = Index();
+      std::memset(index, 0, kIndexHeaderSize);
+      std::memcpy(index->magic, kIndexMagic, sizeof(kIndexMagic));
+      index->version = kMessageStoreVersion;
+      index->count = 0;
+      index->capacity = (index_.Size() - kIndexHeaderSize) / (sizeof(KeyEntry) + sizeof(TimeEntry));
+
+      while (Index()->count < Log()->count)
+      {
+        if (Index()->count == IndexCapacity() && !GrowIndex(error))
+          return false;
+        IndexRecord(static_cast<uint32_t>(Index()->count));
+      }
+      return true;
+    }
+
+    // Write the record, commit it in the log header, then index it
+    int MessageStore::Append(uint64_t key, double timestamp, double storedAt, StoredDirection direction, uint8_t type,
+                             uint8_t hops, const uint8_t *payload, size_t length, std::string &error)
+    {
+      if (!log_.IsOpen())
+      {
+        error = "Message store is closed";
+        return -1;
+      }
+      if (length > kMessageRecordPayloadMax)
+      {
+        error = "Payload of " + std::to_string(length) + " bytes exceeds the " +
+                std::to_string(kMessageRecordPayloadMax) + " byte record limit";
+        return -1;
+      }
+
+      std::vector<uint32_t> matches;
+      Find(key, matches);
+      for (uint32_t match : matches)
+      {
+        if (Record(match).timestamp == timestamp)
+          return 1;
+      }
+
+      if (Log()->count == Log()->capacity && !GrowLog(error))
+        return -1;
+      if (Index()->count == IndexCapacity() && !GrowIndex(error))
+        return -1;
+
+      const size_t position = static_cast<size_t>(Log()->count);
+      StoredMessageRecord &record = *reinterpret_cast<StoredMessageRecord *>(
+          log_.Data() + kMessageStoreHeaderSize + position * kMessageRecordSize);
+      std::memset(&record, 0, sizeof(record));
+      record.key = key;
+      record.timestamp = timestamp;
+      record.storedAt = storedAt;
+      record.length = static_cast<uint16_t>(length);
+      record.direction = static_cast<uint8_t>(direction);
+      record.type = type;
+      record.hops = hops;
+      if (length > 0)
+        std::memcpy(record.payload, payload, length);
+
+      Log()->count = position + 1;
+      IndexRecord(static_cast<uint32_t>(position));
+      return 0;
+    }
+
+    void MessageStore::Find(uint64_t key, std::vector<uint32_t> &out) const
+    {
+      out.clear();
+      if (!index_.IsOpen())
+        return;
+      const KeyEntry *keys = Keys();
+      const KeyEntry *end = keys + Index()->count;
+      const KeyEntry *first = std::lower_bound(keys, end, key, [](const KeyEntry &entry, uint64_t value)
+                                               { return entry.key < value; });
+      for (; first != end && first->key == key; ++first)
+        out.push_back(first->record);
+    }
+
+    void MessageStore::TimeRange(double fromMs, double toMs, size_t &first, size_t &last) const
+    {
+      first = last = 0;
+      if (!index_.IsOpen() || !(fromMs < toMs))
+        return;
+      const TimeEntry *times = Times();
+      const TimeEntry *end = times + Index()->count;
+      auto before = [](const TimeEntry &entry, double value)
+      { return entry.timestamp < value; };
+      first = static_cast<size_t>(std::lower_bound(times, end, fromMs, before) - times);
+      last = static_cast<size_t>(std::lower_bound(times + first, end, toMs, before) - times);
+    }
+
+    uint32_t MessageStore::ByTime(size_t position) const
+    {
+      return Times()[position].record;
+    }
+
+    bool MessageStore::Sync(std::string &error)
+    {
+      return log_.Sync(error) && index_.Sync(error);
+    }
+
+  } // namespace mesh
+} // namespace ghostmesh
@@ -0,0 +1,205 @@
+#ifndef NATIVE_BLE_MESSAGE_STORE_H
+#define NATIVE_BLE_MESSAGE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file message_store.h
+ * @brief Append-only, memory-mapped log of decoded messages
+ *
+ * Two files, both mapped MAP_SHARED and grown by doubling:
+ * - `<path>`: kMessageStoreHeaderSize bytes of header, then fixed
+ *   kMessageRecordSize StoredMessageRecords in append order
+ * - `<path>.idx`: header, then two sorted arrays with one entry per record:
+ *   by MessageKey() (the 52-bit (srcId, messageId) key of the reassembler)
+ *   and by message timestamp
+ *
+ * Opening maps both files; nothing is replayed unless the index is missing
+ * or out of step with the log. An index behind the log means a crash during
+ * an append, possibly while its arrays were being shifted, so it is rebuilt
+ * from every record rather than caught up. Lookups are binary searches
+ * over the mapped arrays. One writer per store: the files are not locked.
+ */
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    constexpr size_t kMessageRecordSize = 256;
+    constexpr size_t kMessageStoreHeaderSize = 256; ///< Keeps records aligned to their size
+    constexpr size_t kMessageRecordPayloadMax = 224;
+    constexpr uint32_t kMessageStoreVersion = 1;
+
+    /**
+     * @enum StoredDirection
+     * @brief Whether this node received or originated the message
+     */
+    enum class StoredDirection : uint8_t
+    {
+      Received = 0,
+      Sent = 1,
+    };
+
+    /**
+     * @struct StoredMessageRecord
+     * @brief One log record, exactly as it sits in the mapped file
+     *
+     * The payload is opaque to the store; src/message-store.ts keeps the
+     * message-codec frame of the message there (see message_codec.h).
+     */
+    struct StoredMessageRecord
+    {
+      uint64_t key;        ///< MessageKey(srcId, messageId)
+      double timestamp;    ///< Message timestamp, ms since epoch
+      double storedAt;     ///< Append time, ms since epoch
+      uint16_t length;     ///< Payload bytes
+      uint8_t direction;   ///< StoredDirection
+      uint8_t type;        ///< MessageCodecType
+      uint8_t hops;
+      uint8_t reserved[3];
+      uint8_t payload[kMessageRecordPayloadMax];
+    };
+
+    static_assert(sizeof(StoredMessageRecord) == kMessageRecordSize, "StoredMessageRecord must stay 256 bytes");
+
+    /**
+     * @class MappedFile
+     * @brief A file mapped read-write into memory (mmap, or a file mapping on Windows)
+     */
+    class MappedFile
+    {
+    public:
+      MappedFile() = default;
+      ~MappedFile();
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      /**
+       * @brief Open or create `path` and map at least `minSize` bytes of it
+       */
+      bool Open(const std::string &path, size_t minSize, std::string &error);
+
+      /**
+       * @brief Grow the file to `size` bytes and remap; pointers into the old mapping dangle
+       */
+      bool Resize(size_t size, std::string &error);
+
+      /**
+       * @brief Write dirty pages back to the file
+       */
+      bool Sync(std::string &error);
+
+      void Close();
+
+      uint8_t *Data() const { return data_; }
+      size_t Size() const { return size_; }
+      bool IsOpen() const { return data_ != nullptr; }
+
+    private:
+      bool Map(std::string &error);
+      void Unmap();
+
+      uint8_t *data_ = nullptr;
+      size_t size_ = 0;
+#ifdef _WIN32
+      void *file_ = nullptr;    ///< HANDLE
+      void *mapping_ = nullptr; ///< HANDLE
+#else
+      int fd_ = -1;
+#endif
+    };
+
+    /**
+     * @class MessageStore
+     * @brief The log and its sidecar index
+     */
+    class MessageStore
+    {
+    public:
+      MessageStore() = default;
+
+      /**
+       * @brief Map `path` and `path + ".idx"`, creating them with room for `initialCapacity` records
+       */
+      bool Open(const std::string &path, size_t initialCapacity, std::string &error);
+
+      void Close();
+
+      bool IsOpen() const { return log_.IsOpen(); }
+
+      /**
+       * @brief Append a record
+       * @return 0 when stored, 1 when a record with the same key and timestamp is
+       *         already there (a relayed copy), -1 on error (see `error`)
+       */
+      int Append(uint64_t key, double timestamp, double storedAt, StoredDirection direction, uint8_t type,
+                 uint8_t hops, const uint8_t *payload, size_t length, std::string &error);
+
+      size_t Count() const;
+
+      /**
+       * @brief Record at an append position, 0 <= position < Count()
+       */
+      const StoredMessageRecord &Record(size_t position) const;
+
+      /**
+       * @brief Append positions of every record with `key`, oldest append first
+       */
+      void Find(uint64_t key, std::vector<uint32_t> &out) const;
+
+      /**
+       * @brief Positions in the time order of records with fromMs <= timestamp < toMs
+       * @param first Receives the first time-order position
+       * @param last Receives one past the last
+       */
+      void TimeRange(double fromMs, double toMs, size_t &first, size_t &last) const;
+
+      /**
+       * @brief Append position of the record at a time-order position
+       */
+      uint32_t ByTime(size_t position) const;
+
+      bool Sync(std::string &error);
+
+    private:
+      struct KeyEntry
+      {
+        uint64_t key;
+        uint32_t record;
+        uint32_t reserved;
+      };
+
+      struct TimeEntry
+      {
+        double timestamp;
+        uint32_t record;
+        uint32_t reserved;
+      };
+
+      struct LogHeader;
+      struct IndexHeader;
+
+      LogHeader *Log() const;
+      IndexHeader *Index() const;
+      KeyEntry *Keys() const;
+      TimeEntry *Times() const;
+      size_t IndexCapacity() const;
+
+      bool GrowLog(std::string &error);
+      bool GrowIndex(std::string &error);
+      void IndexRecord(uint32_t position);
+      bool RebuildIndex(std::string &error);
+
+      MappedFile log_;
+      MappedFile index_;
+    };
+
+  } // namespace mesh
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_MESSAGE_STORE_H
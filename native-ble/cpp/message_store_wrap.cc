@@ -0,0 +1,212 @@
+/**
+ * @file message_store_wrap.cc
+ * @brief N-API binding for the memory-mapped message log
+ */
+
+#include "message_store_wrap.h"
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mesh_packet.h"
+
+namespace
+{
+  constexpr size_t kDefaultCapacity = 1024;
+
+  bool IntegerIn(Napi::Value value, double max, double &out)
+  {
+    if (!value.IsNumber())
+      return false;
+    out = value.As<Napi::Number>().DoubleValue();
+    return out >= 0 && out <= max && std::floor(out) == out;
+  }
+
+  double NowMs()
+  {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count());
+  }
+
+  // Read srcId and messageId from two arguments; throws a TypeError and returns false otherwise
+  bool KeyArgs(const Napi::CallbackInfo &info, size_t index, uint64_t &key)
+  {
+    double srcId, messageId;
+    if (info.Length() < index + 2 || !IntegerIn(info[index], 1099511627775.0, srcId) ||
+        !IntegerIn(info[index + 1], 4095.0, messageId))
+    {
+      Napi::TypeError::New(info.Env(), "Expected srcId (40-bit) and messageId (12-bit) integers")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    key = ghostmesh::mesh::MessageKey(static_cast<uint64_t>(srcId), static_cast<uint16_t>(messageId));
+    return true;
+  }
+} // namespace
+
+Napi::Object MessageStoreWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  Napi::Function func = DefineClass(env, "MessageStore",
+                                    {
+                                        InstanceMethod("append", &MessageStoreWrap::Append),
+                                        InstanceMethod("find", &MessageStoreWrap::Find),
+                                        InstanceMethod("range", &MessageStoreWrap::Range),
+                                        InstanceMethod("count", &MessageStoreWrap::Count),
+                                        InstanceMethod("sync", &MessageStoreWrap::Sync),
+                                        InstanceMethod("close", &MessageStoreWrap::Close),
+                                    });
+  exports.Set("MessageStore", func);
+  return exports;
+}
+
+MessageStoreWrap::MessageStoreWrap(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<MessageStoreWrap>(info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString())
+  {
+    Napi::TypeError::New(env, "Expected store path").ThrowAsJavaScriptException();
+    return;
+  }
+  size_t capacity = kDefaultCapacity;
+  if (info.Length() > 1 && info[1].IsNumber() && info[1].As<Napi::Number>().Uint32Value() > 0)
+    capacity = info[1].As<Napi::Number>().Uint32Value();
+
+  std::string error;
+  if (!store_.Open(info[0].As<Napi::String>().Utf8Value(), capacity, error))
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+}
+
+Napi::Value MessageStoreWrap::Append(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject())
+  {
+    Napi::TypeError::New(env, "Expected record object").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object record = info[0].As<Napi::Object>();
+
+  double srcId, messageId, direction, type, hops;
+  Napi::Value timestamp = record.Get("timestamp"), payload = record.Get("payload");
+  if (!IntegerIn(record.Get("srcId"), 1099511627775.0, srcId) ||
+      !IntegerIn(record.Get("messageId"), 4095.0, messageId) || !timestamp.IsNumber() ||
+      !IntegerIn(record.Get("direction"), 1.0, direction) || !IntegerIn(record.Get("type"), 255.0, type) ||
+      !IntegerIn(record.Get("hops"), std::numeric_limits<double>::max(), hops))
+  {
+    Napi::TypeError::New(env, "Record needs integer srcId, messageId, direction, type and hops and a timestamp")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!payload.IsTypedArray() || payload.As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array)
+  {
+    Napi::TypeError::New(env, "Record payload must be a Uint8Array").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!store_.IsOpen())
+  {
+    Napi::Error::New(env, "Message store is closed").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Uint8Array bytes = payload.As<Napi::Uint8Array>();
+  double storedAt = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : NowMs();
+  std::string error;
+  int result = store_.Append(
+      ghostmesh::mesh::MessageKey(static_cast<uint64_t>(srcId), static_cast<uint16_t>(messageId)),
+      timestamp.As<Napi::Number>().DoubleValue(), storedAt, static_cast<ghostmesh::mesh::StoredDirection>(direction),
+      static_cast<uint8_t>(type), static_cast<uint8_t>(std::min(hops, 255.0)), bytes.Data(), bytes.ElementLength(),
+      error);
+  if (result < 0)
+  {
+    Napi::RangeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, result == 0);
+}
+
+Napi::Value MessageStoreWrap::Find(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArgs(info, 0, key))
+    return env.Undefined();
+
+  std::vector<uint32_t> positions;
+  store_.Find(key, positions);
+  Napi::Array out = Napi::Array::New(env, positions.size());
+  for (size_t i = 0; i < positions.size(); ++i)
+    out.Set(static_cast<uint32_t>(i), RecordObject(env, positions[i]));
+  return out;
+}
+
+Napi::Value MessageStoreWrap::Range(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber())
+  {
+    Napi::TypeError::New(env, "Expected fromMs and toMs").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  size_t first, last;
+  store_.TimeRange(info[0].As<Napi::Number>().DoubleValue(), info[1].As<Napi::Number>().DoubleValue(), first,
+                   last);
+
+  if (info.Length() > 2 && info[2].IsNumber())
+  {
+    size_t limit = info[2].As<Napi::Number>().Uint32Value();
+    bool newest = info.Length() > 3 && info[3].ToBoolean().Value();
+    if (last - first > limit)
+    {
+      if (newest)
+        first = last - limit;
+      else
+        last = first + limit;
+    }
+  }
+
+  Napi::Array out = Napi::Array::New(env, last - first);
+  for (size_t i = first; i < last; ++i)
+    out.Set(static_cast<uint32_t>(i - first), RecordObject(env, store_.ByTime(i)));
+  return out;
+}
+
+Napi::Value MessageStoreWrap::Count(const Napi::CallbackInfo &info)
+{
+  return Napi::Number::New(info.Env(), static_cast<double>(store_.Count()));
+}
+
+Napi::Value MessageStoreWrap::Sync(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  std::string error;
+  if (!store_.Sync(error))
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+  return env.Undefined();
+}
+
+Napi::Value MessageStoreWrap::Close(const Napi::CallbackInfo &info)
+{
+  store_.Close();
+  return info.Env().Undefined();
+}
+
+// Copy one mapped record into a JS object
+Napi::Object MessageStoreWrap::RecordObject(Napi::Env env, uint32_t position) const
+{
+  const ghostmesh::mesh::StoredMessageRecord &record = store_.Record(position);
+  Napi::Object out = Napi::Object::New(env);
+  out.Set("srcId", Napi::Number::New(env, static_cast<double>(record.key >> 12)));
+  out.Set("messageId", Napi::Number::New(env, static_cast<double>(record.key & 0x0FFFu)));
+  out.Set("timestamp", Napi::Number::New(env, record.timestamp));
+  out.Set("storedAt", Napi::Number::New(env, record.storedAt));
+  out.Set("direction", Napi::Number::New(env, record.direction));
+  out.Set("type", Napi::Number::New(env, record.type));
+  out.Set("hops", Napi::Number::New(env, record.hops));
+  out.Set("payload", Napi::Buffer<uint8_t>::Copy(env, record.payload, record.length));
+  return out;
+}
@@ -0,0 +1,89 @@
+#ifndef NATIVE_BLE_MESSAGE_STORE_WRAP_H
+#define NATIVE_BLE_MESSAGE_STORE_WRAP_H
+
+#include <napi.h>
+
+#include "message_store.h"
+
+/**
+ * @file message_store_wrap.h
+ * @brief N-API binding for the memory-mapped message log
+ */
+
+/**
+ * @class MessageStoreWrap
+ * @brief JS-visible `MessageStore` backed by ghostmesh::mesh::MessageStore
+ *
+ * Records are plain objects
+ * `{ srcId, messageId, timestamp, storedAt, direction, type, hops, payload }`
+ * where (srcId, messageId) is the 40 + 12 bit key mesh packets carry and
+ * `payload` is at most 224 opaque bytes. Query results copy the payload out of
+ * the mapping, so they stay valid after the store grows or closes.
+ */
+class MessageStoreWrap : public Napi::ObjectWrap<MessageStoreWrap>
+{
+public:
+  /**
+   * @brief Register the `MessageStore` class on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  /**
+   * @brief Open or create a store; throws if the files cannot be mapped
+   * @param info [0]: path of the log (the index is `path + ".idx"`), [1]: optional initial capacity in records
+   */
+  MessageStoreWrap(const Napi::CallbackInfo &info);
+
+private:
+  /**
+   * @brief Append a record
+   * @param info [0]: record without storedAt, [1]: optional storedAt in ms (default now)
+   * @return true if stored, false if the same (srcId, messageId, timestamp) is already there
+   */
+  Napi::Value Append(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Every record stored under one key, oldest append first
+   * @param info [0]: srcId, [1]: messageId
+   * @return record[]
+   */
+  Napi::Value Find(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Records with fromMs <= timestamp < toMs, in timestamp order
+   * @param info [0]: fromMs, [1]: toMs, [2]: optional limit, [3]: optional newest (keep the
+   *        last `limit` instead of the first)
+   * @return record[]
+   */
+  Napi::Value Range(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Number of stored records
+   * @param info N-API callback info
+   * @return number
+   */
+  Napi::Value Count(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Flush both mappings to disk
+   * @param info N-API callback info
+   * @return undefined
+   */
+  Napi::Value Sync(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Unmap and close both files; later calls see an empty store
+   * @param info N-API callback info
+   * @return undefined
+   */
+  Napi::Value Close(const Napi::CallbackInfo &info);
+
+  Napi::Object RecordObject(Napi::Env env, uint32_t position) const;
+
+  ghostmesh::mesh::MessageStore store_;
+};
+
+#endif // NATIVE_BLE_MESSAGE_STORE_WRAP_H
@@ -0,0 +1,136 @@
+/**
+ * @file peer_monitor.cc
+ * @brief Implementation of the timer-driven peer monitor
+ */
+
+#include "peer_monitor.h"
+
+#include <chrono>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      uint64_t NowMs()
+      {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+      }
+    } // namespace
+
+    PeerMonitor::PeerMonitor(napi_env env, uint32_t timeoutMs, ChangeHandler handler)
+        : env_(env), table_(timeoutMs), handler_(std::move(handler)), asyncContext_(nullptr), armed_(false),
+          closed_(false)
+    {
+      uv_loop_t *loop = nullptr;
+      napi_get_uv_event_loop(env_, &loop);
+      uv_timer_init(loop, &timer_);
+      timer_.data = this;
+      // Tracked peers must not keep the process alive
+      uv_unref(reinterpret_cast<uv_handle_t *>(&timer_));
+
+      Napi::Object resource = Napi::Object::New(env_);
+      napi_async_init(env_, resource, Napi::String::New(env_, "GhostMeshPeerMonitor"), &asyncContext_);
+    }
+
+    PeerMonitor *PeerMonitor::Create(Napi::Env env, uint32_t timeoutMs, ChangeHandler handler)
+    {
+      return new PeerMonitor(env, timeoutMs, std::move(handler));
+    }
+
+    void PeerMonitor::Touch(const std::string &address, int16_t rssi, uint64_t timestampMs)
+    {
+      if (closed_)
+        return;
+
+      std::vector<Peer> lost;
+      const Peer *fresh = table_.Touch(address, rssi, timestampMs, lost);
+      if (fresh == nullptr)
+        return;
+      // Copied: a listener may feed more reports in before we return
+      Peer added = *fresh;
+
+      if (!armed_)
+      {
+        uv_timer_start(&timer_, OnTimer, table_.TickMs(), table_.TickMs());
+        armed_ = true;
+      }
+      Report(lost, added);
+    }
+
+    // Emit evictions, then the new peer; stops early if a listener closes us
+    void PeerMonitor::Report(const std::vector<Peer> &lost, const Peer &added)
+    {
+      Napi::Env env(env_);
+      for (const Peer &peer : lost)
+      {
+        if (closed_)
+          return;
+        handler_(env, peer, false);
+      }
+      if (!closed_)
+        handler_(env, added, true);
+    }
+
+    void PeerMonitor::OnTimer(uv_timer_t *handle)
+    {
+      auto *self = static_cast<PeerMonitor *>(handle->data);
+      if (self->closed_)
+        return;
+
+      std::vector<Peer> lost;
+      self->table_.Advance(NowMs(), lost);
+      if (self->table_.Size() == 0)
+      {
+        uv_timer_stop(&self->timer_);
+        self->armed_ = false;
+      }
+      if (lost.empty())
+        return;
+
+      napi_env env = self->env_;
+      Napi::HandleScope scope(env);
+      Napi::Object resource = Napi::Object::New(env);
+      napi_callback_scope callbackScope;
+      napi_open_callback_scope(env, resource, self->asyncContext_, &callbackScope);
+
+      for (const Peer &peer : lost)
+      {
+        if (self->closed_)
+          break;
+        self->handler_(Napi::Env(env), peer, false);
+        bool pending = false;
+        napi_is_exception_pending(env, &pending);
+        if (pending)
+        {
+          // Surface listener errors as uncaught exceptions, as a normal emit would
+          napi_value error;
+          napi_get_and_clear_last_exception(env, &error);
+          napi_fatal_exception(env, error);
+        }
+      }
+      napi_close_callback_scope(env, callbackScope);
+    }
+
+    void PeerMonitor::Close()
+    {
+      if (closed_)
+        return;
+      closed_ = true;
+      table_.Clear();
+      uv_timer_stop(&timer_);
+      armed_ = false;
+      // As with DiscoveryBatcher, the async context is released with the handle
+      uv_close(reinterpret_cast<uv_handle_t *>(&timer_), [](uv_handle_t *handle)
+               {
+                 auto *self = static_cast<PeerMonitor *>(handle->data);
+                 napi_async_destroy(self->env_, self->asyncContext_);
+                 delete self; });
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
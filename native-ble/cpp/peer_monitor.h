@@ -0,0 +1,92 @@
+#ifndef NATIVE_BLE_PEER_MONITOR_H
+#define NATIVE_BLE_PEER_MONITOR_H
+
+#include <napi.h>
+#include <uv.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "peer_table.h"
+
+/**
+ * @file peer_monitor.h
+ * @brief Drives a PeerTable from a libuv timer and reports peers coming and going
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @class PeerMonitor
+     * @brief Emits one change per peer appearing or timing out
+     *
+     * Runs entirely on the JS thread. Reports are fed in with Touch(); the
+     * table's wheel is advanced by a repeating libuv timer at the wheel's tick,
+     * which only runs while at least one peer is tracked. Like DiscoveryBatcher
+     * it is created with Create() and self-destructs after Close(), once libuv
+     * has released the timer handle.
+     */
+    class PeerMonitor
+    {
+    public:
+      /**
+       * @brief Change handler, invoked on the JS thread inside a HandleScope
+       * @param added true for a new peer, false for one that timed out or was evicted
+       */
+      using ChangeHandler = std::function<void(Napi::Env env, const Peer &peer, bool added)>;
+
+      /**
+       * @brief Create a monitor on the calling environment's event loop
+       * @param env N-API environment (JS thread only)
+       * @param timeoutMs Silence after which a peer is lost
+       * @param handler Receives every change
+       */
+      static PeerMonitor *Create(Napi::Env env, uint32_t timeoutMs, ChangeHandler handler);
+
+      /**
+       * @brief Change the peer timeout
+       */
+      void SetTimeout(uint32_t timeoutMs) { table_.SetTimeout(timeoutMs); }
+
+      /**
+       * @brief Account one report, emitting for a new (or evicted) peer
+       * @param address Advertiser address
+       * @param rssi Signal strength in dBm
+       * @param timestampMs Report time (ms since epoch)
+       */
+      void Touch(const std::string &address, int16_t rssi, uint64_t timestampMs);
+
+      /**
+       * @brief Peers currently in range, for listings
+       */
+      const PeerTable &Table() const { return table_; }
+
+      /**
+       * @brief Forget every peer and free the monitor asynchronously
+       */
+      void Close();
+
+    private:
+      PeerMonitor(napi_env env, uint32_t timeoutMs, ChangeHandler handler);
+
+      static void OnTimer(uv_timer_t *handle);
+
+      void Report(const std::vector<Peer> &lost, const Peer &added);
+
+      napi_env env_;
+      PeerTable table_;
+      ChangeHandler handler_;
+      uv_timer_t timer_;
+      napi_async_context asyncContext_;
+      bool armed_;
+      bool closed_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_PEER_MONITOR_H
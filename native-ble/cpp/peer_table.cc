@@ -0,0 +1,241 @@
+/**
+ * @file peer_table.cc
+ * @brief Implementation of the timer-wheel peer table
+ */
+
+#include "peer_table.h"
+
+#include <algorithm>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    PeerTable::PeerTable(uint32_t timeoutMs, uint32_t tickMs, size_t capacity)
+        : timeoutMs_(std::max<uint32_t>(1, timeoutMs)), tickMs_(std::max<uint32_t>(1, tickMs)),
+          capacity_(std::max<size_t>(1, capacity)), evicted_(0), now_(0), started_(false), newest_(kNone),
+          oldest_(kNone)
+    {
+      slots_.fill(kNone);
+    }
+
+    // First tick at which the peer has been silent for the whole timeout
+    uint64_t PeerTable::Deadline(const Node &node) const
+    {
+      return (node.peer.lastSeen + timeoutMs_ + tickMs_ - 1) / tickMs_;
+    }
+
+    // Place a peer in the finest level whose span still reaches its due tick.
+    // Callers guarantee dueTick > now_, except when cascading, which happens
+    // before the current tick's level-0 slot is expired.
+    void PeerTable::Arm(uint32_t row, uint64_t dueTick)
+    {
+      constexpr uint64_t kSpan = uint64_t(1) << (kLevelBits * kLevels);
+      if (dueTick - now_ >= kSpan)
+        dueTick = now_ + kSpan - 1; // Fires early and re-arms from lastSeen
+
+      uint64_t delta = dueTick - now_;
+      size_t level = 0;
+      while (level + 1 < kLevels && delta >= (uint64_t(1) << (kLevelBits * (level + 1))))
+        ++level;
+
+      Node &node = nodes_[row];
+      node.dueTick = dueTick;
+      node.slot = static_cast<uint32_t>(level * kLevelSlots + ((dueTick >> (kLevelBits * level)) & (kLevelSlots - 1)));
+      node.prev = kNone;
+      node.next = slots_[node.slot];
+      if (node.next != kNone)
+        nodes_[node.next].prev = row;
+      slots_[node.slot] = row;
+    }
+
+    void PeerTable::Disarm(uint32_t row)
+    {
+      Node &node = nodes_[row];
+      if (node.slot == kNone)
+        return;
+      if (node.prev != kNone)
+        nodes_[node.prev].next = node.next;
+      else
+        slots_[node.slot] = node.next;
+      if (node.next != kNone)
+        nodes_[node.next].prev = node.prev;
+      node.slot = kNone;
+      node.next = node.prev = kNone;
+    }
+
+    // Redistribute the slot of `level` that the current tick has reached
+    void PeerTable::Cascade(size_t level)
+    {
+      size_t slot = level * kLevelSlots + ((now_ >> (kLevelBits * level)) & (kLevelSlots - 1));
+      uint32_t row = slots_[slot];
+      slots_[slot] = kNone;
+      while (row != kNone)
+      {
+        uint32_t next = nodes_[row].next;
+        nodes_[row].slot = kNone;
+        Arm(row, nodes_[row].dueTick);
+        row = next;
+      }
+    }
+
+    // Due entries of the current tick: re-arm peers heard since, release the rest
+    void PeerTable::ExpireSlot(std::vector<Peer> &lost)
+    {
+      size_t slot = now_ & (kLevelSlots - 1);
+      uint32_t row = slots_[slot];
+      slots_[slot] = kNone;
+      while (row != kNone)
+      {
+        Node &node = nodes_[row];
+        uint32_t next = node.next;
+        node.slot = kNone;
+        node.next = node.prev = kNone;
+        uint64_t deadline = Deadline(node);
+        if (deadline > now_)
+          Arm(row, deadline);
+        else
+          Release(row, lost);
+        row = next;
+      }
+    }
+
+    void PeerTable::LinkNewest(uint32_t row)
+    {
+      Node &node = nodes_[row];
+      node.newer = kNone;
+      node.older = newest_;
+      if (newest_ != kNone)
+        nodes_[newest_].newer = row;
+      newest_ = row;
+      if (oldest_ == kNone)
+        oldest_ = row;
+    }
+
+    void PeerTable::UnlinkRecent(uint32_t row)
+    {
+      Node &node = nodes_[row];
+      if (node.newer != kNone)
+        nodes_[node.newer].older = node.older;
+      else
+        newest_ = node.older;
+      if (node.older != kNone)
+        nodes_[node.older].newer = node.newer;
+      else
+        oldest_ = node.newer;
+      node.newer = node.older = kNone;
+    }
+
+    // Drop a peer from every structure and hand it to the caller
+    void PeerTable::Release(uint32_t row, std::vector<Peer> &lost)
+    {
+      Disarm(row);
+      UnlinkRecent(row);
+      Node &node = nodes_[row];
+      index_.erase(node.peer.address);
+      lost.push_back(std::move(node.peer));
+      node.peer = Peer();
+      free_.push_back(row);
+    }
+
+    const Peer *PeerTable::Touch(const std::string &address, int16_t rssi, uint64_t nowMs, std::vector<Peer> &lost)
+    {
+      // An empty wheel is not advanced, so catch it up before arming
+      if (!started_ || (index_.empty() && TickOf(nowMs) > now_))
+      {
+        now_ = TickOf(nowMs);
+        started_ = true;
+      }
+
+      auto it = index_.find(address);
+      if (it != index_.end())
+      {
+        uint32_t row = it->second;
+        Peer &peer = nodes_[row].peer;
+        peer.lastSeen = std::max(peer.lastSeen, nowMs);
+        peer.rssi = rssi;
+        ++peer.reports;
+        if (row != newest_)
+        {
+          UnlinkRecent(row);
+          LinkNewest(row);
+        }
+        return nullptr;
+      }
+
+      if (index_.size() >= capacity_)
+      {
+        ++evicted_;
+        Release(oldest_, lost);
+      }
+
+      uint32_t row;
+      if (!free_.empty())
+      {
+        row = free_.back();
+        free_.pop_back();
+      }
+      else
+      {
+        row = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+      }
+
+      Node &node = nodes_[row];
+      node.peer.address = address;
+      node.peer.firstSeen = nowMs;
+      node.peer.lastSeen = nowMs;
+      node.peer.reports = 1;
+      node.peer.rssi = rssi;
+      index_.emplace(address, row);
+      LinkNewest(row);
+      Arm(row, std::max(Deadline(node), now_ + 1));
+      return &node.peer;
+    }
+
+    void PeerTable::Advance(uint64_t nowMs, std::vector<Peer> &lost)
+    {
+      uint64_t target = TickOf(nowMs);
+      if (!started_ || index_.empty())
+      {
+        now_ = std::max(now_, target);
+        started_ = true;
+        return;
+      }
+
+      while (now_ < target)
+      {
+        ++now_;
+        constexpr uint64_t kMask = kLevelSlots - 1;
+        if ((now_ & kMask) == 0)
+        {
+          // Coarser levels first, so entries they hand down are cascaded again this tick if due
+          if (((now_ >> kLevelBits) & kMask) == 0)
+          {
+            if (((now_ >> (2 * kLevelBits)) & kMask) == 0)
+              Cascade(3);
+            Cascade(2);
+          }
+          Cascade(1);
+        }
+        ExpireSlot(lost);
+        if (index_.empty())
+        {
+          now_ = target;
+          break;
+        }
+      }
+    }
+
+    void PeerTable::Clear()
+    {
+      nodes_.clear();
+      free_.clear();
+      index_.clear();
+      newest_ = oldest_ = kNone;
+      slots_.fill(kNone);
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,162 @@
+#ifndef NATIVE_BLE_PEER_TABLE_H
+#define NATIVE_BLE_PEER_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file peer_table.h
+ * @brief Address-keyed peer table with most-recently-seen order and timer-wheel expiry
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @struct Peer
+     * @brief One advertiser in the peer table
+     */
+    struct Peer
+    {
+      std::string address;
+      uint64_t firstSeen = 0; ///< ms epoch
+      uint64_t lastSeen = 0;  ///< ms epoch
+      uint32_t reports = 0;
+      int16_t rssi = 0;       ///< Latest report, dBm
+    };
+
+    /**
+     * @class PeerTable
+     * @brief Tracks which advertisers are in range without periodic sweeps
+     *
+     * Peers live in a pool threaded on two intrusive lists: a most-recently-seen
+     * list, so listings come out ordered without sorting, and the slots of a
+     * four-level hierarchical timer wheel (64 slots per level, one tick per
+     * `tickMs`), so expiry costs O(1) per peer however many are tracked.
+     *
+     * A report only updates the peer and moves it to the head of the recent
+     * list; its wheel entry is left alone. When the entry comes due, the peer
+     * is re-armed for lastSeen + timeout if it was heard in the meantime, and
+     * reported lost otherwise. A busy peer therefore costs one wheel operation
+     * per timeout, not one per report.
+     *
+     * Not synchronized: the adapter drives it from the JS thread.
+     */
+    class PeerTable
+    {
+    public:
+      /**
+       * @param timeoutMs Silence after which a peer is lost
+       * @param tickMs Wheel resolution; peers are reported lost up to one tick late
+       * @param capacity Peers tracked at once; beyond it the least recently seen is dropped
+       */
+      explicit PeerTable(uint32_t timeoutMs = 30000, uint32_t tickMs = 100, size_t capacity = 1024);
+
+      PeerTable(const PeerTable &) = delete;
+      PeerTable &operator=(const PeerTable &) = delete;
+
+      /**
+       * @brief Change the timeout; peers already armed pick it up when they next come due
+       */
+      void SetTimeout(uint32_t timeoutMs) { timeoutMs_ = timeoutMs > 0 ? timeoutMs : 1; }
+
+      uint32_t Timeout() const { return timeoutMs_; }
+      uint32_t TickMs() const { return tickMs_; }
+
+      /**
+       * @brief Account one report
+       * @param address Advertiser address
+       * @param rssi Signal strength in dBm
+       * @param nowMs Report time (ms since epoch)
+       * @param lost Receives the peer dropped to make room, if any
+       * @return The new peer if the address was not being tracked, else nullptr;
+       *         valid until the table next changes
+       */
+      const Peer *Touch(const std::string &address, int16_t rssi, uint64_t nowMs, std::vector<Peer> &lost);
+
+      /**
+       * @brief Run the wheel up to `nowMs`
+       * @param lost Receives every peer that timed out, oldest deadline first
+       */
+      void Advance(uint64_t nowMs, std::vector<Peer> &lost);
+
+      /**
+       * @brief Number of peers tracked
+       */
+      size_t Size() const { return index_.size(); }
+
+      /**
+       * @brief Visit every peer, most recently seen first
+       */
+      template <typename Visitor>
+      void ForEachRecent(Visitor visit) const
+      {
+        for (uint32_t row = newest_; row != kNone; row = nodes_[row].older)
+          visit(nodes_[row].peer);
+      }
+
+      /**
+       * @brief Forget every peer without reporting them
+       */
+      void Clear();
+
+      /**
+       * @brief Peers dropped for capacity since construction
+       */
+      uint64_t EvictedCount() const { return evicted_; }
+
+    private:
+      static constexpr uint32_t kNone = UINT32_MAX;
+      static constexpr unsigned kLevelBits = 6;
+      static constexpr size_t kLevelSlots = size_t(1) << kLevelBits;
+      static constexpr size_t kLevels = 4;
+
+      struct Node
+      {
+        Peer peer;
+        uint64_t dueTick = 0;
+        uint32_t newer = kNone; ///< Recent list
+        uint32_t older = kNone;
+        uint32_t next = kNone;  ///< Wheel slot list
+        uint32_t prev = kNone;
+        uint32_t slot = kNone;  ///< level * kLevelSlots + index, kNone when not armed
+      };
+
+      uint64_t TickOf(uint64_t ms) const { return ms / tickMs_; }
+      uint64_t Deadline(const Node &node) const;
+
+      void Arm(uint32_t row, uint64_t dueTick);
+      void Disarm(uint32_t row);
+      void Cascade(size_t level);
+      void ExpireSlot(std::vector<Peer> &lost);
+
+      void LinkNewest(uint32_t row);
+      void UnlinkRecent(uint32_t row);
+      void Release(uint32_t row, std::vector<Peer> &lost);
+
+      uint32_t timeoutMs_;
+      uint32_t tickMs_;
+      size_t capacity_;
+      uint64_t evicted_;
+
+      uint64_t now_; ///< Current tick; every armed peer is due after it
+      bool started_;
+
+      std::vector<Node> nodes_;
+      std::vector<uint32_t> free_;
+      std::unordered_map<std::string, uint32_t> index_;
+      uint32_t newest_;
+      uint32_t oldest_;
+      std::array<uint32_t, kLevels * kLevelSlots> slots_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_PEER_TABLE_H
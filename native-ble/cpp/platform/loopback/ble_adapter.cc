@@ -0,0 +1,1736 @@
+#include "../../ble_adapter.h"
+#include "../../mesh_assembler_wrap.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+  // Wall-clock milliseconds, the timestamp base of DiscoveredDevice
+  uint64_t NowMs()
+  {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+} // namespace
+
+// Loopback backend: adapters in one process hear each other through LoopbackMedium.
+// Also holds the event and listener plumbing both backends share; the
+// IBLEPlatform halves of the radio operations live in ble_adapter_platform.cc.
+
+// Constructor
+BLEAdapter::BLEAdapter(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<BLEAdapter>(info), state_(State::PoweredOn), advertising_(false), scanning_(false),
+      advertisingData_(ghostmesh::ble::AdvertisingBuffer::Create()), dispatcher_(nullptr), nextAdvertisingSetId_(1),
+      advertisingIntervalMs_(100),
+      batcher_(nullptr), scanFilter_(std::make_shared<ghostmesh::ble::ScanFilter>()),
+      duplicateFilter_(std::make_shared<ghostmesh::ble::DuplicateFilter>()),
+      linkQuality_(std::make_shared<ghostmesh::ble::LinkQualityTable>()),
+      stats_(std::make_shared<ghostmesh::ble::AdapterStats>()), peers_(nullptr), trackPeers_(false),
+      meshCompanyId_(0xFFFF), scanWindow_(), radioOps_(0), listening_(false), simultaneousAdvScan_(true),
+      coexistenceCycleMs_(ghostmesh::ble::kDefaultCoexistenceCycleMs), radioSlot_(RadioSlot::Shared),
+      initializing_(false), discoveryRing_(ghostmesh::ble::kPackedRecordStride)
+{
+  Napi::Env env = info.Env();
+  addon_ = &AddonInstance::Of(env);
+  // Accept optional options object with `adapterId` and `backend`
+  std::string backend = "auto";
+  bool lazyInit = false;
+  if (info.Length() > 0 && info[0].IsObject())
+  {
+    Napi::Object opts = info[0].As<Napi::Object>();
+    if (opts.Has("adapterId") && opts.Get("adapterId").IsString())
+    {
+      adapterId_ = opts.Get("adapterId").As<Napi::String>().Utf8Value();
+    }
+    if (opts.Has("backend") && opts.Get("backend").IsString())
+    {
+      backend = opts.Get("backend").As<Napi::String>().Utf8Value();
+    }
+    if (opts.Has("simultaneousAdvScan") && opts.Get("simultaneousAdvScan").IsBoolean())
+    {
+      simultaneousAdvScan_ = opts.Get("simultaneousAdvScan").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("coexistenceCycleMs") && opts.Get("coexistenceCycleMs").IsNumber())
+    {
+      coexistenceCycleMs_ = opts.Get("coexistenceCycleMs").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("lazyInit") && opts.Get("lazyInit").IsBoolean())
+    {
+      lazyInit = opts.Get("lazyInit").As<Napi::Boolean>().Value();
+    }
+  }
+  if (backend != "auto" && backend != "loopback" && backend != "platform")
+  {
+    Napi::TypeError::New(env, "backend must be 'auto', 'loopback' or 'platform'").ThrowAsJavaScriptException();
+    return;
+  }
+  if (adapterId_.empty())
+  {
+    adapterId_ = std::to_string(reinterpret_cast<uintptr_t>(this));
+  }
+  traceId_ = ghostmesh::ble::HashAddress(adapterId_);
+  addon_->Adapters()[adapterId_] = this;
+
+  // Platform-thread callbacks are funnelled through a batched TSFN queue
+  dispatcher_ = ghostmesh::ble::PlatformEventDispatcher::Create(
+      env, [this](Napi::Env env, std::vector<ghostmesh::ble::PlatformEvent> &batch)
+      { this->DeliverPlatformEvents(env, batch); });
+
+  bool usePlatform = false;
+  Napi::Value ready;
+  if (backend != "loopback")
+  {
+    try
+    {
+      if (lazyInit)
+        ready = OpenPlatformInBackground(env, backend == "platform");
+      else
+        usePlatform = OpenPlatform(backend == "platform");
+    }
+    catch (const ghostmesh::ble::BLEError &error)
+    {
+      ghostmesh::ble::PlatformError(env, error).ThrowAsJavaScriptException();
+      return;
+    }
+  }
+  if (!usePlatform && !initializing_)
+  {
+    addon_->Medium().Register(this);
+  }
+  info.This().As<Napi::Object>().Set("ready", ready.IsEmpty() ? ghostmesh::ble::ResolvedPromise(env) : ready);
+}
+
+// Event listener registration
+Napi::Value BLEAdapter::On(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction())
+  {
+    Napi::TypeError::New(env, "Expected event name and callback").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  // The name is interned here, once, so native emission never touches strings
+  ghostmesh::ble::AdapterEvent event = ghostmesh::ble::AdapterEvent::Count;
+  std::vector<Napi::FunctionReference> *listeners = FindListeners(env, info[0], true, event);
+  Napi::Function callback = info[1].As<Napi::Function>();
+  listeners->push_back(Napi::Persistent(callback));
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::ListenerAdded, traceId_,
+                                                         TraceArg(event, listeners->size()));
+  // If listener is for stateChange, emit current state immediately so tests can observe it;
+  // during a background Initialize() the first state it gets is the outcome
+  if (event == ghostmesh::ble::AdapterEvent::StateChange && !initializing_)
+  {
+    std::vector<napi_value> args = {Napi::String::New(env, CurrentStateName())};
+    listeners->back().Call(this->Value(), args);
+  }
+  return env.Undefined();
+}
+
+// Map an event name to its listener list: the fixed table for adapter events,
+// the by-name map for anything else JS registers
+std::vector<Napi::FunctionReference> *BLEAdapter::FindListeners(Napi::Env env, Napi::Value name, bool create,
+                                                                ghostmesh::ble::AdapterEvent &event)
+{
+  // Adapter event names fit on the stack; a truncated read cannot match one
+  char buffer[ghostmesh::ble::kAdapterEventNameMax + 2];
+  size_t length = 0;
+  napi_get_value_string_utf8(env, name, buffer, sizeof(buffer), &length);
+  if (ghostmesh::ble::ParseAdapterEvent(buffer, length, event))
+  {
+    return &listeners_[static_cast<size_t>(event)];
+  }
+
+  event = ghostmesh::ble::AdapterEvent::Count;
+  std::string key = name.As<Napi::String>().Utf8Value();
+  if (create)
+  {
+    return &customListeners_[key];
+  }
+  auto it = customListeners_.find(key);
+  return it == customListeners_.end() ? nullptr : &it->second;
+}
+
+// Trace argument for listener activity: event ID above the listener count
+uint64_t BLEAdapter::TraceArg(ghostmesh::ble::AdapterEvent event, size_t listeners)
+{
+  return (static_cast<uint64_t>(event) << 32) | static_cast<uint32_t>(listeners);
+}
+
+// Emit event to listeners
+Napi::Value BLEAdapter::Emit(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString())
+  {
+    Napi::TypeError::New(env, "Expected event name").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  ghostmesh::ble::AdapterEvent event = ghostmesh::ble::AdapterEvent::Count;
+  std::vector<Napi::FunctionReference> *listeners = FindListeners(env, info[0], false, event);
+  if (listeners != nullptr && !listeners->empty())
+  {
+    std::vector<napi_value> args;
+    for (size_t i = 1; i < info.Length(); ++i)
+    {
+      args.push_back(info[i]);
+    }
+    // Indexed: a listener may register another listener or destroy the adapter
+    for (size_t i = 0; i < listeners->size(); ++i)
+    {
+      (*listeners)[i].Call(info.This(), args);
+    }
+  }
+  return env.Undefined();
+}
+
+// Internal helper to emit events without a CallbackInfo
+void BLEAdapter::EmitEvent(Napi::Env env, ghostmesh::ble::AdapterEvent event, const std::vector<napi_value> &args)
+{
+  std::vector<Napi::FunctionReference> &listeners = listeners_[static_cast<size_t>(event)];
+  if (listeners.empty())
+    return;
+  Napi::Object self = this->Value();
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::EventEmitted, traceId_,
+                                                          TraceArg(event, listeners.size()));
+  // Pinned: a listener may destroy the adapter and drop its last reference
+  std::shared_ptr<ghostmesh::ble::AdapterStats> stats = stats_;
+  stats->AddEmit(event, listeners.size());
+  uint64_t start = ghostmesh::ble::StatsNowUs();
+  // Indexed: a listener may register another listener or destroy the adapter
+  for (size_t i = 0; i < listeners.size(); ++i)
+  {
+    listeners[i].Call(self, args);
+  }
+  stats->Record(ghostmesh::ble::StatHistogram::EmitUs, ghostmesh::ble::StatsNowUs() - start);
+}
+
+// Platform discovery callback: may run on any thread, only touches the queue
+ghostmesh::ble::DeviceDiscoveredCallback BLEAdapter::PlatformDeviceDiscoveredCallback()
+{
+  ghostmesh::ble::PlatformEventDispatcher *dispatcher = dispatcher_;
+  std::shared_ptr<ghostmesh::ble::ScanFilter> scanFilter = scanFilter_;
+  std::shared_ptr<ghostmesh::ble::DuplicateFilter> filter = duplicateFilter_;
+  std::shared_ptr<ghostmesh::ble::LinkQualityTable> linkQuality = linkQuality_;
+  std::shared_ptr<ghostmesh::ble::AdapterStats> stats = stats_;
+  uint32_t traceId = traceId_;
+  return [dispatcher, scanFilter, filter, linkQuality, stats, traceId](const ghostmesh::ble::DiscoveredDevice &device)
+  {
+    stats->Add(ghostmesh::ble::StatCounter::AdvertisementsReceived);
+    // Drop filtered advertisers and repeats before they cost a queue slot or a JS crossing
+    if (!scanFilter->Matches(device.manufacturerData.data(), device.manufacturerData.size(), device.serviceUUIDs))
+    {
+      stats->Add(ghostmesh::ble::StatCounter::AdvertisementsFiltered);
+      ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::FilterRejected, traceId, device.manufacturerData.size());
+      return;
+    }
+    if (linkQuality->Enabled())
+    {
+      linkQuality->Record(ghostmesh::ble::HashAddress(device.address), device.rssi, device.timestamp);
+    }
+    if (filter->IsDuplicate(device.address, device.manufacturerData.data(), device.manufacturerData.size()))
+    {
+      stats->Add(ghostmesh::ble::StatCounter::AdvertisementsDeduped);
+      ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::DuplicateDropped, traceId, filter->SuppressedCount());
+      return;
+    }
+    ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::DeviceDiscovered, traceId, device.manufacturerData.size());
+    dispatcher->PostDeviceDiscovered(device);
+  };
+}
+
+// Platform state callback: may run on any thread, only touches the queue
+ghostmesh::ble::StateChangeCallback BLEAdapter::PlatformStateChangeCallback()
+{
+  ghostmesh::ble::PlatformEventDispatcher *dispatcher = dispatcher_;
+  return [dispatcher](ghostmesh::ble::BLEState state)
+  { dispatcher->PostStateChange(state); };
+}
+
+// Deliver a drained batch of platform events on the JS thread
+void BLEAdapter::DeliverPlatformEvents(Napi::Env env, std::vector<ghostmesh::ble::PlatformEvent> &batch)
+{
+  std::shared_ptr<ghostmesh::ble::AdapterStats> stats = stats_;
+  stats->Add(ghostmesh::ble::StatCounter::PlatformBatches);
+  // One clock read per batch: events queued together share the wait
+  uint64_t now = ghostmesh::ble::StatsNowUs();
+  for (auto &event : batch)
+  {
+    stats->Record(ghostmesh::ble::StatHistogram::DispatchUs, now > event.queuedUs ? now - event.queuedUs : 0);
+    if (event.kind == ghostmesh::ble::PlatformEvent::Kind::StateChange)
+    {
+      this->state_ = ToState(event.state);
+      if (this->state_ != State::PoweredOn)
+      {
+        this->advertising_ = false;
+        this->scanning_ = false;
+        if (scheduler_)
+        {
+          scheduler_->Stop();
+        }
+        StopScanDutyCycle();
+        StopArbitration();
+        advertisingSets_.clear();
+        UpdateAdvertiserMembership();
+        CloseBatcher();
+        assembler_.reset();
+      }
+      std::vector<napi_value> a = {Napi::String::New(env, StateName(event.state))};
+      this->EmitEvent(env, ghostmesh::ble::AdapterEvent::StateChange, a);
+    }
+    else if (event.kind == ghostmesh::ble::PlatformEvent::Kind::AdvertisingRotated)
+    {
+      ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::AdvertisementRotated,
+                                                                traceId_, event.advertisementId);
+      RotateAdvertisement(env, event.advertisement);
+    }
+    else if (event.kind == ghostmesh::ble::PlatformEvent::Kind::AdvertisementCompleted ||
+             event.kind == ghostmesh::ble::PlatformEvent::Kind::AdvertisementExpired)
+    {
+      Napi::Object info = Napi::Object::New(env);
+      info.Set("id", Napi::Number::New(env, event.advertisementId));
+      info.Set("sent", Napi::Number::New(env, event.sentCount));
+      std::vector<napi_value> a = {info};
+      UpdateAdvertisingWeight();
+      this->EmitEvent(env,
+                      event.kind == ghostmesh::ble::PlatformEvent::Kind::AdvertisementCompleted
+                          ? ghostmesh::ble::AdapterEvent::AdvertisementCompleted
+                          : ghostmesh::ble::AdapterEvent::AdvertisementExpired,
+                      a);
+    }
+    else if (event.kind == ghostmesh::ble::PlatformEvent::Kind::ScanWindowOpened)
+    {
+      OpenScanWindow(env, event.scanGapMs);
+    }
+    else if (event.kind == ghostmesh::ble::PlatformEvent::Kind::ScanWindowClosed)
+    {
+      CloseScanWindow(env);
+    }
+    else if (event.kind == ghostmesh::ble::PlatformEvent::Kind::RadioSlotAdvertise ||
+             event.kind == ghostmesh::ble::PlatformEvent::Kind::RadioSlotScan)
+    {
+      EnterRadioSlot(env, event.kind == ghostmesh::ble::PlatformEvent::Kind::RadioSlotAdvertise ? RadioSlot::Advertise
+                                                                                                : RadioSlot::Scan);
+    }
+    else if (event.kind == ghostmesh::ble::PlatformEvent::Kind::Error)
+    {
+      EmitPlatformError(env, ghostmesh::ble::BLEError(event.errorCode, event.message, event.nativeError));
+    }
+    else if (this->scanning_)
+    {
+      stats->Add(ghostmesh::ble::StatCounter::AdvertisementsDelivered);
+      ++scanWindow_.reports;
+      TouchPeer(event.device.address, event.device.rssi, event.device.timestamp);
+      const std::vector<uint8_t> &data = event.device.manufacturerData;
+      if (assembler_ && ConsumeMeshPacket(env, event.device.address, data.data(), data.size()))
+        continue;
+      if (batcher_ != nullptr)
+      {
+        batcher_->Append(event.device);
+        continue;
+      }
+      std::vector<napi_value> a = {DeviceToObject(env, event.device)};
+      this->EmitEvent(env, ghostmesh::ble::AdapterEvent::DeviceDiscovered, a);
+    }
+  }
+}
+
+// Convert a platform device report to a JS object
+Napi::Object BLEAdapter::DeviceToObject(Napi::Env env, const ghostmesh::ble::DiscoveredDevice &device)
+{
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("address", Napi::String::New(env, device.address));
+  if (!device.name.empty())
+  {
+    obj.Set("name", Napi::String::New(env, device.name));
+  }
+  obj.Set("rssi", Napi::Number::New(env, device.rssi));
+  if (!device.manufacturerData.empty())
+  {
+    obj.Set("manufacturerData",
+            Napi::Buffer<uint8_t>::Copy(env, device.manufacturerData.data(), device.manufacturerData.size()));
+  }
+  if (!device.serviceUUIDs.empty())
+  {
+    Napi::Array uuids = Napi::Array::New(env, device.serviceUUIDs.size());
+    for (size_t i = 0; i < device.serviceUUIDs.size(); ++i)
+    {
+      uuids.Set(static_cast<uint32_t>(i), Napi::String::New(env, device.serviceUUIDs[i]));
+    }
+    obj.Set("serviceUUIDs", uuids);
+  }
+  obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(device.timestamp)));
+  return obj;
+}
+
+// Map platform state enum to JS state name
+const char *BLEAdapter::StateName(ghostmesh::ble::BLEState state)
+{
+  switch (state)
+  {
+  case ghostmesh::ble::BLEState::RESETTING:
+    return "resetting";
+  case ghostmesh::ble::BLEState::UNSUPPORTED:
+    return "unsupported";
+  case ghostmesh::ble::BLEState::UNAUTHORIZED:
+    return "unauthorized";
+  case ghostmesh::ble::BLEState::POWERED_OFF:
+    return "poweredOff";
+  case ghostmesh::ble::BLEState::POWERED_ON:
+    return "poweredOn";
+  default:
+    return "unknown";
+  }
+}
+
+// Only poweredOn / poweredOff are distinguished; everything else is Unknown
+BLEAdapter::State BLEAdapter::ToState(ghostmesh::ble::BLEState state)
+{
+  switch (state)
+  {
+  case ghostmesh::ble::BLEState::POWERED_ON:
+    return State::PoweredOn;
+  case ghostmesh::ble::BLEState::POWERED_OFF:
+    return State::PoweredOff;
+  default:
+    return State::Unknown;
+  }
+}
+
+// A platform reports its full state (e.g. "unauthorized"); loopback only has power states
+const char *BLEAdapter::CurrentStateName() const
+{
+  if (platform_)
+    return StateName(platform_->GetState());
+  switch (this->state_)
+  {
+  case State::PoweredOn:
+    return "poweredOn";
+  case State::PoweredOff:
+    return "poweredOff";
+  default:
+    return "unknown";
+  }
+}
+
+// Release the platform event dispatcher
+void BLEAdapter::CloseDispatcher()
+{
+  if (dispatcher_ != nullptr)
+  {
+    dispatcher_->Close();
+    dispatcher_ = nullptr;
+  }
+}
+
+// Store a payload: inline when it fits a legacy PDU, otherwise keep the JS value
+// Swap the scheduler's pick into the advertisement and tell the scanners
+void BLEAdapter::RotateAdvertisement(Napi::Env env, const ghostmesh::ble::AdvertisingData &data)
+{
+  // A tick may already be queued when advertising stops
+  if (!this->advertising_)
+    return;
+  advertisingData_->Assign(data.data(), data.size());
+  manufacturerData_.Reset();
+  stats_->Add(ghostmesh::ble::StatCounter::AdvertisingRotations);
+  stats_->Add(ghostmesh::ble::StatCounter::AdvertisingUpdates);
+  if (platform_)
+  {
+    // Off air for a scan slot: the next advertise slot starts with this payload
+    if (!platform_->IsAdvertising())
+      return;
+    // A PDU rewrite, not a restart: short enough to issue from the JS thread
+    try
+    {
+      platform_->UpdateAdvertisingData(data, nullptr);
+    }
+    catch (const ghostmesh::ble::BLEError &error)
+    {
+      EmitPlatformError(env, error);
+    }
+    return;
+  }
+  if (!AdvertiseSlotOpen())
+    return;
+  ghostmesh::ble::LoopbackFrame frame(adapterId_, advertisingData_, OversizedAdvertisingData(), serviceUUIDs_);
+  addon_->Medium().Broadcast(env, this, frame);
+}
+
+BLEAdapter::AdvertisingSet *BLEAdapter::FindAdvertisingSet(uint32_t id)
+{
+  for (auto &set : advertisingSets_)
+  {
+    if (set.id == id)
+      return &set;
+  }
+  return nullptr;
+}
+
+// Advertising sets share the adapter's address, like sets on one controller using its public address
+void BLEAdapter::BroadcastAdvertisingSet(Napi::Env env, const AdvertisingSet &set)
+{
+  // Sent with the next advertise slot's burst instead
+  if (!AdvertiseSlotOpen())
+    return;
+  // The frame outlives `set` if a listener removes it mid-broadcast
+  std::vector<std::string> services = set.serviceUUIDs;
+  ghostmesh::ble::LoopbackFrame frame(adapterId_, nullptr, set.manufacturerData.Value(), services);
+  addon_->Medium().Broadcast(env, this, frame);
+}
+
+// An adapter stays discoverable while either the main advertisement or any set is on air,
+// outside the scan slots of a radio that cannot do both
+void BLEAdapter::UpdateAdvertiserMembership()
+{
+  if (platform_)
+    return;
+  addon_->Medium().SetAdvertising(
+      this, (this->advertising_ || !advertisingSets_.empty()) && AdvertiseSlotOpen());
+}
+
+void BLEAdapter::SetAdvertisingData(Napi::Value value)
+{
+  if (value.IsBuffer())
+  {
+    Napi::Buffer<uint8_t> buf = value.As<Napi::Buffer<uint8_t>>();
+    if (advertisingData_->Assign(buf.Data(), buf.Length()))
+    {
+      manufacturerData_.Reset();
+      return;
+    }
+  }
+  advertisingData_->Clear();
+  manufacturerData_ = Napi::Persistent(value);
+}
+
+void BLEAdapter::ClearAdvertisingData()
+{
+  advertisingData_->Clear();
+  manufacturerData_.Reset();
+}
+
+bool BLEAdapter::HasAdvertisingData() const
+{
+  return advertisingData_->Assigned() || !manufacturerData_.IsEmpty();
+}
+
+Napi::Value BLEAdapter::OversizedAdvertisingData() const
+{
+  return manufacturerData_.IsEmpty() ? Napi::Value() : manufacturerData_.Value();
+}
+
+// Loopback discovery: drop filtered or repeated reports, deliver the rest
+void BLEAdapter::ReceiveLoopback(Napi::Env env, ghostmesh::ble::LoopbackFrame &frame)
+{
+  stats_->Add(ghostmesh::ble::StatCounter::AdvertisementsReceived);
+  // Filtered on the raw bytes: rejected advertisers never become JS objects
+  if (!scanFilter_->Matches(frame.data, frame.length, frame.serviceUUIDs))
+  {
+    stats_->Add(ghostmesh::ble::StatCounter::AdvertisementsFiltered);
+    ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::FilterRejected, traceId_, frame.length);
+    return;
+  }
+  // The loopback radio has no signal strength; its reports count as 0 dBm
+  if (linkQuality_->Enabled())
+  {
+    linkQuality_->Record(ghostmesh::ble::HashAddress(frame.address), 0, NowMs());
+  }
+  if (duplicateFilter_->IsDuplicate(frame.address, frame.data, frame.length))
+  {
+    stats_->Add(ghostmesh::ble::StatCounter::AdvertisementsDeduped);
+    ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::DuplicateDropped, traceId_, duplicateFilter_->SuppressedCount());
+    return;
+  }
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Debug>(ghostmesh::ble::TraceEvent::DeviceDiscovered, traceId_, frame.length);
+  DeliverDiscovery(env, frame);
+}
+
+// Hand a report that passed the filters to reassembly, batching or `deviceDiscovered`
+void BLEAdapter::DeliverDiscovery(Napi::Env env, ghostmesh::ble::LoopbackFrame &frame)
+{
+  stats_->Add(ghostmesh::ble::StatCounter::AdvertisementsDelivered);
+  ++scanWindow_.reports;
+  TouchPeer(frame.address, 0, NowMs());
+  if (assembler_ && frame.data != nullptr && ConsumeMeshPacket(env, frame.address, frame.data, frame.length))
+    return;
+  if (batcher_ != nullptr)
+  {
+    batcher_->Append(ghostmesh::ble::HashAddress(frame.address), 0, NowMs(), frame.data, frame.length);
+    return;
+  }
+
+  std::vector<napi_value> a = {frame.DeviceObject(env)};
+  this->EmitEvent(env, ghostmesh::ble::AdapterEvent::DeviceDiscovered, a);
+}
+
+// ScanOptions filters: filterByManufacturer / filterByService (default: none),
+// allowDuplicates / duplicateTimeout (defaults: false / 1000ms)
+ghostmesh::ble::ScanOptions BLEAdapter::ConfigureScanFilters(Napi::Value options)
+{
+  ghostmesh::ble::ScanOptions scan;
+  if (options.IsObject())
+  {
+    Napi::Object opts = options.As<Napi::Object>();
+    if (opts.Has("filterByManufacturer") && opts.Get("filterByManufacturer").IsNumber())
+    {
+      scan.filterByManufacturer = static_cast<uint16_t>(opts.Get("filterByManufacturer").As<Napi::Number>().Uint32Value());
+    }
+    if (opts.Has("filterByService") && opts.Get("filterByService").IsArray())
+    {
+      scan.filterByService = StringArray(opts.Get("filterByService"));
+    }
+    if (opts.Has("allowDuplicates") && opts.Get("allowDuplicates").IsBoolean())
+    {
+      scan.allowDuplicates = opts.Get("allowDuplicates").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("duplicateTimeout") && opts.Get("duplicateTimeout").IsNumber())
+    {
+      scan.duplicateTimeoutMs = opts.Get("duplicateTimeout").As<Napi::Number>().Uint32Value();
+    }
+  }
+  scanFilter_->Configure(scan.filterByManufacturer, scan.filterByService);
+  duplicateFilter_->Configure(scan.allowDuplicates, scan.duplicateTimeoutMs);
+  return scan;
+}
+
+// Optional packed delivery (one `devicesDiscovered` event per flush interval),
+// native mesh reassembly, link-quality tracking and peer monitoring
+void BLEAdapter::ConfigureScanDelivery(Napi::Env env, Napi::Value options)
+{
+  bool batch = false;
+  uint32_t batchIntervalMs = 50;
+  bool trackLinkQuality = false;
+  bool trackPeers = false;
+  uint32_t peerTimeoutMs = 30000;
+  if (options.IsObject())
+  {
+    Napi::Object opts = options.As<Napi::Object>();
+    if (opts.Has("trackPeers") && opts.Get("trackPeers").IsBoolean())
+    {
+      trackPeers = opts.Get("trackPeers").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("peerTimeoutMs") && opts.Get("peerTimeoutMs").IsNumber())
+    {
+      peerTimeoutMs = opts.Get("peerTimeoutMs").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("trackLinkQuality") && opts.Get("trackLinkQuality").IsBoolean())
+    {
+      trackLinkQuality = opts.Get("trackLinkQuality").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("batchDiscoveries") && opts.Get("batchDiscoveries").IsBoolean())
+    {
+      batch = opts.Get("batchDiscoveries").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("batchIntervalMs") && opts.Get("batchIntervalMs").IsNumber())
+    {
+      batchIntervalMs = opts.Get("batchIntervalMs").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("assembleMesh") && opts.Get("assembleMesh").IsBoolean() &&
+        opts.Get("assembleMesh").As<Napi::Boolean>().Value())
+    {
+      uint32_t meshTimeoutMs = 30000;
+      if (opts.Has("meshTimeoutMs") && opts.Get("meshTimeoutMs").IsNumber())
+      {
+        meshTimeoutMs = opts.Get("meshTimeoutMs").As<Napi::Number>().Uint32Value();
+      }
+      // Sized for extended fragments; blocks are only allocated as messages arrive
+      assembler_.reset(new ghostmesh::mesh::MessageAssembler(
+          256, ghostmesh::mesh::MeshFragmentDataSize(ghostmesh::ble::kExtendedAdvertisingDataMax), meshTimeoutMs));
+      if (opts.Has("meshCompanyId") && opts.Get("meshCompanyId").IsNumber())
+      {
+        meshCompanyId_ = static_cast<uint16_t>(opts.Get("meshCompanyId").As<Napi::Number>().Uint32Value());
+      }
+    }
+  }
+  if (batch)
+  {
+    batcher_ = ghostmesh::ble::DiscoveryBatcher::Create(
+        env, batchIntervalMs, [this](Napi::Env env, const uint8_t *records, size_t count)
+        { this->EmitDiscoveryBatch(env, records, count); });
+  }
+  // Statistics from earlier scans are kept; a scan without the option stops adding to them
+  linkQuality_->SetEnabled(trackLinkQuality);
+  if (trackPeers)
+  {
+    if (peers_ == nullptr)
+    {
+      peers_ = ghostmesh::ble::PeerMonitor::Create(
+          env, peerTimeoutMs, [this](Napi::Env env, const ghostmesh::ble::Peer &peer, bool added)
+          {
+            if (added)
+              this->NoteScanActivity(true);
+            std::vector<napi_value> a = {PeerToObject(env, peer)};
+            this->EmitEvent(env, added ? ghostmesh::ble::AdapterEvent::PeerAdded : ghostmesh::ble::AdapterEvent::PeerLost, a); });
+    }
+    else
+    {
+      peers_->SetTimeout(peerTimeoutMs);
+    }
+  }
+  // Known peers keep timing out after a scan without the option, they just stop being refreshed
+  trackPeers_ = trackPeers;
+}
+
+// Deliver whatever the current window collected, then drop the scan's delivery state
+void BLEAdapter::EndScanDelivery()
+{
+  if (batcher_ != nullptr)
+  {
+    batcher_->Flush();
+    CloseBatcher();
+  }
+  assembler_.reset();
+}
+
+// ScanOptions duty cycle: scanWindowMs (default 0, continuous), scanIntervalMs,
+// adaptiveScan (default false), minScanIntervalMs / maxScanIntervalMs
+ghostmesh::ble::ScanDutyConfig BLEAdapter::ParseScanDutyCycle(Napi::Value options)
+{
+  ghostmesh::ble::ScanDutyConfig config;
+  if (options.IsObject())
+  {
+    Napi::Object opts = options.As<Napi::Object>();
+    if (opts.Has("scanWindowMs") && opts.Get("scanWindowMs").IsNumber())
+    {
+      config.windowMs = opts.Get("scanWindowMs").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("scanIntervalMs") && opts.Get("scanIntervalMs").IsNumber())
+    {
+      config.intervalMs = opts.Get("scanIntervalMs").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("adaptiveScan") && opts.Get("adaptiveScan").IsBoolean())
+    {
+      config.adaptive = opts.Get("adaptiveScan").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("minScanIntervalMs") && opts.Get("minScanIntervalMs").IsNumber())
+    {
+      config.minIntervalMs = opts.Get("minScanIntervalMs").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("maxScanIntervalMs") && opts.Get("maxScanIntervalMs").IsNumber())
+    {
+      config.maxIntervalMs = opts.Get("maxScanIntervalMs").As<Napi::Number>().Uint32Value();
+    }
+  }
+  return ghostmesh::ble::NormalizeScanDutyConfig(config);
+}
+
+// Windows are timed on the cycler thread and opened and closed on the JS thread
+void BLEAdapter::StartScanDutyCycle(const ghostmesh::ble::ScanDutyConfig &config)
+{
+  if (!scanCycler_)
+  {
+    ghostmesh::ble::PlatformEventDispatcher *dispatcher = dispatcher_;
+    auto sink = [dispatcher](const ghostmesh::ble::ScanWindowEvent &event)
+    {
+      dispatcher->PostScanWindow(event.kind == ghostmesh::ble::ScanWindowEvent::Kind::Opened
+                                     ? ghostmesh::ble::PlatformEvent::Kind::ScanWindowOpened
+                                     : ghostmesh::ble::PlatformEvent::Kind::ScanWindowClosed,
+                                 event.gapMs);
+    };
+    scanCycler_.reset(new ghostmesh::ble::ScanDutyCycler(sink));
+  }
+  scanWindow_ = ScanWindow();
+  scanWindow_.cycling = true;
+  scanCycler_->Start(config);
+}
+
+// Window edges still queued in the dispatcher are ignored once cycling stops
+void BLEAdapter::StopScanDutyCycle()
+{
+  if (scanCycler_)
+  {
+    scanCycler_->Stop();
+  }
+  scanWindow_.cycling = false;
+  scanWindow_.open = false;
+}
+
+// Start listening: resubscribe to the medium, or restart the platform radio
+void BLEAdapter::OpenScanWindow(Napi::Env env, uint32_t gapMs)
+{
+  if (!scanWindow_.cycling || !this->scanning_ || scanWindow_.open)
+    return;
+  scanWindow_.open = true;
+  scanWindow_.openedUs = ghostmesh::ble::StatsNowUs();
+  scanWindow_.gapMs = gapMs;
+  scanWindow_.peersAdded = 0;
+  scanWindow_.messages = 0;
+  scanWindow_.reports = 0;
+  stats_->Add(ghostmesh::ble::StatCounter::ScanWindows);
+  ApplyRadio(env);
+}
+
+// Stop listening and tell the cycler whether the window saw the mesh move
+void BLEAdapter::CloseScanWindow(Napi::Env env)
+{
+  if (!scanWindow_.cycling || !scanWindow_.open)
+    return;
+  scanWindow_.open = false;
+  // New peers or messages, or fragments still waiting for the rest of their
+  // message; a scan that tracks neither counts any report
+  bool active = scanWindow_.peersAdded > 0 || scanWindow_.messages > 0 || (assembler_ && assembler_->Size() > 0) ||
+                (!trackPeers_ && !assembler_ && scanWindow_.reports > 0);
+  scanCycler_->ReportActivity(active);
+  ApplyRadio(env);
+}
+
+// A peer found one window after it appeared waited out the gap before it:
+// the sample is the gap plus the time into the window, an upper bound
+void BLEAdapter::NoteScanActivity(bool peerAdded)
+{
+  if (!scanWindow_.cycling)
+    return;
+  if (!peerAdded)
+  {
+    ++scanWindow_.messages;
+    return;
+  }
+  ++scanWindow_.peersAdded;
+  if (scanWindow_.open)
+  {
+    uint64_t now = ghostmesh::ble::StatsNowUs();
+    stats_->Record(ghostmesh::ble::StatHistogram::DiscoveryLatencyUs,
+                   uint64_t(scanWindow_.gapMs) * 1000 + (now > scanWindow_.openedUs ? now - scanWindow_.openedUs : 0));
+  }
+}
+
+// Loopback: hear the main advertisement and every advertising set currently on air
+bool BLEAdapter::ReceiveAdvertisers(Napi::Env env)
+{
+  bool found = false;
+  std::vector<BLEAdapter *> advertisers = addon_->Medium().Advertisers();
+  for (BLEAdapter *other : advertisers)
+  {
+    if (other == this)
+      continue;
+    if (other->HasAdvertisingData())
+    {
+      ghostmesh::ble::LoopbackFrame frame(other->adapterId_, other->advertisingData_, other->OversizedAdvertisingData(),
+                                          other->serviceUUIDs_);
+      this->ReceiveLoopback(env, frame);
+      found = true;
+    }
+    // Indexed, with the UUIDs copied: a listener may remove sets while we deliver
+    for (size_t i = 0; i < other->advertisingSets_.size(); ++i)
+    {
+      std::vector<std::string> services = other->advertisingSets_[i].serviceUUIDs;
+      ghostmesh::ble::LoopbackFrame frame(other->adapterId_, nullptr, other->advertisingSets_[i].manufacturerData.Value(),
+                                          services);
+      this->ReceiveLoopback(env, frame);
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool BLEAdapter::ShouldListen() const
+{
+  return this->scanning_ && ScanSlotOpen() && (!scanWindow_.cycling || scanWindow_.open);
+}
+
+bool BLEAdapter::ShouldRadiate() const
+{
+  return this->advertising_ && AdvertiseSlotOpen();
+}
+
+// Contention is advertising plus scanning on a radio that cannot do both.
+// On a platform radio the sets stay on air: extended advertising runs them
+// alongside a scan on the controllers that have it
+bool BLEAdapter::RadioContended() const
+{
+  return !simultaneousAdvScan_ && this->advertising_ && this->scanning_ && dispatcher_ != nullptr;
+}
+
+void BLEAdapter::UpdateArbitration(Napi::Env env)
+{
+  if (!RadioContended())
+  {
+    StopArbitration();
+  }
+  else if (radioSlot_ == RadioSlot::Shared)
+  {
+    if (!arbiter_)
+    {
+      ghostmesh::ble::PlatformEventDispatcher *dispatcher = dispatcher_;
+      auto sink = [dispatcher](const ghostmesh::ble::RadioSlotEvent &event)
+      {
+        dispatcher->PostRadioSlot(event.kind == ghostmesh::ble::RadioSlotEvent::Kind::Advertise
+                                      ? ghostmesh::ble::PlatformEvent::Kind::RadioSlotAdvertise
+                                      : ghostmesh::ble::PlatformEvent::Kind::RadioSlotScan);
+      };
+      arbiter_.reset(new ghostmesh::ble::CoexistenceArbiter(sink));
+    }
+    // The arbiter opens with an advertise slot; take it now so both are never on
+    radioSlot_ = RadioSlot::Advertise;
+    arbiter_->Start(coexistenceCycleMs_, AdvertisingWeight());
+  }
+  ApplyRadio(env);
+}
+
+// Slot edges still queued in the dispatcher are ignored once back to Shared
+void BLEAdapter::StopArbitration()
+{
+  if (arbiter_)
+  {
+    arbiter_->Stop();
+  }
+  radioSlot_ = RadioSlot::Shared;
+}
+
+// Hand the radio over; on loopback an advertise slot opens with a burst of
+// everything this adapter has on air, as a controller would transmit it
+void BLEAdapter::EnterRadioSlot(Napi::Env env, RadioSlot slot)
+{
+  if (radioSlot_ == RadioSlot::Shared || radioSlot_ == slot)
+    return;
+  radioSlot_ = slot;
+  ApplyRadio(env);
+  if (platform_ || slot != RadioSlot::Advertise)
+    return;
+  if (this->advertising_ && HasAdvertisingData())
+  {
+    ghostmesh::ble::LoopbackFrame frame(adapterId_, advertisingData_, OversizedAdvertisingData(), serviceUUIDs_);
+    addon_->Medium().Broadcast(env, this, frame);
+  }
+  // Indexed: a listener may remove sets while we deliver
+  for (size_t i = 0; i < advertisingSets_.size() && radioSlot_ == RadioSlot::Advertise; ++i)
+  {
+    BroadcastAdvertisingSet(env, advertisingSets_[i]);
+  }
+}
+
+void BLEAdapter::ApplyRadio(Napi::Env env)
+{
+  if (platform_)
+  {
+    SyncPlatformRadio(env);
+    return;
+  }
+  UpdateAdvertiserMembership();
+  bool listen = ShouldListen();
+  if (listen == listening_)
+    return;
+  listening_ = listen;
+  if (!listen)
+  {
+    addon_->Medium().Unsubscribe(this);
+    return;
+  }
+  addon_->Medium().Subscribe(this, scanFilter_->CompanyId());
+  // What is on air now is what a real radio would hear first
+  ReceiveAdvertisers(env);
+}
+
+uint32_t BLEAdapter::AdvertisingWeight() const
+{
+  uint32_t weight = scheduler_ ? scheduler_->Weight() : 0;
+  return weight > 0 ? weight : 1;
+}
+
+void BLEAdapter::UpdateAdvertisingWeight()
+{
+  if (arbiter_ && radioSlot_ != RadioSlot::Shared)
+  {
+    arbiter_->SetAdvertisingWeight(AdvertisingWeight());
+  }
+}
+
+// Copy the string elements of a JS array (non-strings are skipped)
+std::vector<std::string> BLEAdapter::StringArray(Napi::Value value)
+{
+  std::vector<std::string> out;
+  if (!value.IsArray())
+    return out;
+  Napi::Array array = value.As<Napi::Array>();
+  out.reserve(array.Length());
+  for (uint32_t i = 0; i < array.Length(); ++i)
+  {
+    Napi::Value item = array.Get(i);
+    if (item.IsString())
+      out.push_back(item.As<Napi::String>().Utf8Value());
+  }
+  return out;
+}
+
+// Native reassembly: only complete messages cross into JS as `meshMessage`
+bool BLEAdapter::ConsumeMeshPacket(Napi::Env env, const std::string &address, const uint8_t *data, size_t length)
+{
+  ghostmesh::mesh::MeshPacket packet;
+  if (!ghostmesh::mesh::DecodeMeshPacket(data, length, packet) || packet.companyId != meshCompanyId_)
+    return false;
+
+  const ghostmesh::mesh::AssembledMessage *message = assembler_->Push(packet, NowMs());
+  if (message != nullptr)
+  {
+    NoteScanActivity(false);
+    Napi::Object obj = MeshAssemblerWrap::ToObject(env, *message);
+    obj.Set("address", Napi::String::New(env, address));
+    std::vector<napi_value> a = {obj};
+    this->EmitEvent(env, ghostmesh::ble::AdapterEvent::MeshMessage, a);
+  }
+  return true;
+}
+
+// Emit one packed `devicesDiscovered` event: (ArrayBuffer records, count), after
+// publishing the batch to the discovery ring if one is attached
+void BLEAdapter::EmitDiscoveryBatch(Napi::Env env, const uint8_t *records, size_t count)
+{
+  if (discoveryRing_.Attached())
+  {
+    discoveryRing_.Publish(records, count);
+    // Readers in other workers block in Atomics.wait() on the Published word
+    Napi::Object atomics = env.Global().Get("Atomics").As<Napi::Object>();
+    atomics.Get("notify").As<Napi::Function>().Call(
+        atomics, {discoveryRingView_.Value(),
+                  Napi::Number::New(env, static_cast<double>(
+                                             static_cast<size_t>(ghostmesh::ble::DiscoveryRingWord::Published)))});
+  }
+  size_t bytes = count * ghostmesh::ble::kPackedRecordStride;
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, bytes);
+  std::memcpy(buffer.Data(), records, bytes);
+  std::vector<napi_value> a = {buffer, Napi::Number::New(env, static_cast<double>(count))};
+  this->EmitEvent(env, ghostmesh::ble::AdapterEvent::DevicesDiscovered, a);
+}
+
+// Peer monitoring sees every delivered report, whatever path it then takes
+void BLEAdapter::TouchPeer(const std::string &address, int16_t rssi, uint64_t timestampMs)
+{
+  if (trackPeers_ && peers_ != nullptr)
+  {
+    peers_->Touch(address, rssi, timestampMs);
+  }
+}
+
+// Release the peer monitor; peers still tracked are dropped without `peerLost`
+void BLEAdapter::ClosePeers()
+{
+  trackPeers_ = false;
+  if (peers_ != nullptr)
+  {
+    peers_->Close();
+    peers_ = nullptr;
+  }
+}
+
+// Convert a peer table entry to a JS object
+Napi::Object BLEAdapter::PeerToObject(Napi::Env env, const ghostmesh::ble::Peer &peer)
+{
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("address", Napi::String::New(env, peer.address));
+  obj.Set("rssi", Napi::Number::New(env, peer.rssi));
+  obj.Set("firstSeen", Napi::Number::New(env, static_cast<double>(peer.firstSeen)));
+  obj.Set("lastSeen", Napi::Number::New(env, static_cast<double>(peer.lastSeen)));
+  obj.Set("reports", Napi::Number::New(env, peer.reports));
+  return obj;
+}
+
+// Release the discovery batcher
+void BLEAdapter::CloseBatcher()
+{
+  if (batcher_ != nullptr)
+  {
+    batcher_->Close();
+    batcher_ = nullptr;
+  }
+}
+
+// Get adapter state
+Napi::Value BLEAdapter::GetState(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::StateQueried, traceId_, static_cast<uint64_t>(this->state_));
+  // Error and power simulation are loopback test hooks
+  if (!platform_ && info.Length() > 0 && info[0].IsString())
+  {
+    std::string arg = info[0].As<Napi::String>().Utf8Value();
+    if (arg == "error")
+    {
+      ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Error>(ghostmesh::ble::TraceEvent::Error, traceId_);
+      Napi::Error::New(env, "Native BLE error: failed to get state").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    if (arg == "powerOff" || arg == "powerOn")
+    {
+      BLEAdapter::HandlePowerStateChange(arg, env, info.This().As<Napi::Object>());
+    }
+  }
+  return Napi::String::New(env, CurrentStateName());
+}
+
+// Radio operations return promises. The loopback radio completes synchronously, so they
+// come back already settled; platform backends settle them through PlatformOperation.
+// Start advertising
+Napi::Value BLEAdapter::StartAdvertising(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject())
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::TypeError::New(env, "Expected advertising options object"),
+                                           "INVALID_PARAMETER");
+  }
+
+  if (this->state_ != State::PoweredOn)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Cannot advertise when adapter is not powered on"),
+                                           "INVALID_STATE");
+  }
+
+  if (this->advertising_)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Already advertising"), "ALREADY_ADVERTISING");
+  }
+
+  Napi::Object opts = info[0].As<Napi::Object>();
+  if (platform_)
+  {
+    return StartPlatformAdvertising(env, opts);
+  }
+  if (opts.Has("manufacturerData"))
+  {
+    SetAdvertisingData(opts.Get("manufacturerData"));
+  }
+  serviceUUIDs_ = StringArray(opts.Get("serviceUUIDs"));
+  if (opts.Has("interval") && opts.Get("interval").IsNumber())
+  {
+    advertisingIntervalMs_ = opts.Get("interval").As<Napi::Number>().Uint32Value();
+  }
+
+  this->advertising_ = true;
+  UpdateArbitration(env);
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::AdvertisingStarted, traceId_);
+  // Emit advertisingStarted
+  this->EmitEvent(env, ghostmesh::ble::AdapterEvent::AdvertisingStarted, {});
+
+  // Notify scanning adapters about this advertiser
+  ghostmesh::ble::LoopbackFrame frame(adapterId_, advertisingData_, OversizedAdvertisingData(), serviceUUIDs_);
+  addon_->Medium().Broadcast(env, this, frame);
+
+  // Queued payloads take over from the initial data on the next tick
+  if (scheduler_)
+  {
+    scheduler_->Start(advertisingIntervalMs_);
+  }
+
+  return ghostmesh::ble::ResolvedPromise(env);
+}
+
+// Update advertising data
+Napi::Value BLEAdapter::UpdateAdvertisingData(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::TypeError::New(env, "Expected buffer data"), "INVALID_PARAMETER");
+  }
+
+  if (!this->advertising_)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Not currently advertising"), "NOT_ADVERTISING");
+  }
+
+  stats_->Add(ghostmesh::ble::StatCounter::AdvertisingUpdates);
+  if (platform_)
+  {
+    return UpdatePlatformAdvertisingData(env, info[0]);
+  }
+  SetAdvertisingData(info[0]);
+  {
+    std::vector<napi_value> a = {info[0]};
+    this->EmitEvent(env, ghostmesh::ble::AdapterEvent::AdvertisingDataUpdated, a);
+  }
+
+  // Notify scanners about updated data, now or with the next advertise slot
+  if (AdvertiseSlotOpen())
+  {
+    ghostmesh::ble::LoopbackFrame frame(adapterId_, advertisingData_, OversizedAdvertisingData(), serviceUUIDs_);
+    addon_->Medium().Broadcast(env, this, frame);
+  }
+
+  return ghostmesh::ble::ResolvedPromise(env);
+}
+
+// Stop advertising
+Napi::Value BLEAdapter::StopAdvertising(const Napi::CallbackInfo &info)
+{
+  if (platform_)
+  {
+    return StopPlatformAdvertising(info.Env());
+  }
+  this->advertising_ = false;
+  if (scheduler_)
+  {
+    scheduler_->Stop();
+  }
+  UpdateArbitration(info.Env());
+  ClearAdvertisingData();
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::AdvertisingStopped, traceId_);
+  this->EmitEvent(info.Env(), ghostmesh::ble::AdapterEvent::AdvertisingStopped, {});
+  return ghostmesh::ble::ResolvedPromise(info.Env());
+}
+
+// Queue a payload for native rotation
+Napi::Value BLEAdapter::ScheduleAdvertisement(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsBuffer())
+  {
+    Napi::TypeError::New(env, "Expected buffer data").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Buffer<uint8_t> buf = info[0].As<Napi::Buffer<uint8_t>>();
+  if (buf.Length() > ghostmesh::ble::kLegacyAdvertisingDataMax)
+  {
+    Napi::RangeError::New(env, "Scheduled advertisements are limited to 31 bytes").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t priority = 0;
+  uint32_t repeat = 0;
+  uint32_t ttlMs = 0;
+  if (info.Length() > 1 && info[1].IsObject())
+  {
+    Napi::Object opts = info[1].As<Napi::Object>();
+    if (opts.Has("priority") && opts.Get("priority").IsNumber())
+    {
+      priority = opts.Get("priority").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("repeat") && opts.Get("repeat").IsNumber())
+    {
+      repeat = opts.Get("repeat").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("ttlMs") && opts.Get("ttlMs").IsNumber())
+    {
+      ttlMs = opts.Get("ttlMs").As<Napi::Number>().Uint32Value();
+    }
+  }
+  if (priority > 255)
+  {
+    Napi::RangeError::New(env, "Priority must be between 0 and 255").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!scheduler_)
+  {
+    ghostmesh::ble::PlatformEventDispatcher *dispatcher = dispatcher_;
+    if (dispatcher == nullptr)
+    {
+      Napi::Error::New(env, "Adapter has been destroyed").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    // Only transmissions and terminal events cross to the JS thread
+    std::shared_ptr<ghostmesh::ble::AdapterStats> stats = stats_;
+    auto sink = [dispatcher, stats](const ghostmesh::ble::SchedulerEvent &event)
+    {
+      using Kind = ghostmesh::ble::PlatformEvent::Kind;
+      if (event.kind == ghostmesh::ble::SchedulerEvent::Kind::Transmit)
+        stats->Record(ghostmesh::ble::StatHistogram::RotationJitterUs, event.lateUs);
+      Kind kind = Kind::AdvertisingRotated;
+      if (event.kind == ghostmesh::ble::SchedulerEvent::Kind::Completed)
+        kind = Kind::AdvertisementCompleted;
+      else if (event.kind == ghostmesh::ble::SchedulerEvent::Kind::Expired)
+        kind = Kind::AdvertisementExpired;
+      dispatcher->PostAdvertising(kind, event.id, event.sent, event.data);
+    };
+    scheduler_.reset(new ghostmesh::ble::AdvertisingScheduler(sink));
+    if (this->advertising_)
+    {
+      scheduler_->Start(advertisingIntervalMs_);
+    }
+  }
+
+  uint32_t id = scheduler_->Submit(buf.Data(), buf.Length(), static_cast<uint8_t>(priority), repeat, ttlMs);
+  if (id == 0)
+  {
+    Napi::Error::New(env, "Advertisement queue is full").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  UpdateAdvertisingWeight();
+  return Napi::Number::New(env, id);
+}
+
+// Remove a queued payload
+Napi::Value BLEAdapter::CancelAdvertisement(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber())
+  {
+    Napi::TypeError::New(env, "Expected advertisement id").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  bool cancelled = scheduler_ && scheduler_->Cancel(info[0].As<Napi::Number>().Uint32Value());
+  UpdateAdvertisingWeight();
+  return Napi::Boolean::New(env, cancelled);
+}
+
+// Remove every queued payload
+Napi::Value BLEAdapter::ClearAdvertisements(const Napi::CallbackInfo &info)
+{
+  if (scheduler_)
+  {
+    scheduler_->Clear();
+  }
+  UpdateAdvertisingWeight();
+  return info.Env().Undefined();
+}
+
+// Start an extended advertising set
+Napi::Value BLEAdapter::CreateAdvertisingSet(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject())
+  {
+    Napi::TypeError::New(env, "Expected advertising set options object").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object opts = info[0].As<Napi::Object>();
+  Napi::Value data = opts.Get("manufacturerData");
+  if (!data.IsBuffer())
+  {
+    Napi::TypeError::New(env, "Expected manufacturerData buffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Buffer<uint8_t> buf = data.As<Napi::Buffer<uint8_t>>();
+  if (buf.Length() < 2 || buf.Length() > ghostmesh::ble::kExtendedAdvertisingDataMax)
+  {
+    Napi::RangeError::New(env, "Advertising set data must be 2 to 251 bytes").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (this->state_ != State::PoweredOn)
+  {
+    Napi::Error::New(env, "Cannot advertise when adapter is not powered on").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (advertisingSets_.size() >= kMaxAdvertisingSets)
+  {
+    Napi::Error::New(env, "No advertising set available").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  AdvertisingSet set;
+  set.serviceUUIDs = StringArray(opts.Get("serviceUUIDs"));
+  set.handle = 0;
+  if (platform_)
+  {
+    try
+    {
+      set.handle = StartPlatformAdvertisingSet(buf.Data(), buf.Length(), set.serviceUUIDs);
+    }
+    catch (const ghostmesh::ble::BLEError &error)
+    {
+      ghostmesh::ble::PlatformError(env, error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    set.id = nextAdvertisingSetId_++;
+    advertisingSets_.push_back(std::move(set));
+    return Napi::Number::New(env, advertisingSets_.back().id);
+  }
+
+  // Copied so later writes to the caller's Buffer do not change what is on air
+  set.id = nextAdvertisingSetId_++;
+  set.manufacturerData = Napi::Persistent(Napi::Buffer<uint8_t>::Copy(env, buf.Data(), buf.Length()).As<Napi::Value>());
+  advertisingSets_.push_back(std::move(set));
+  UpdateAdvertiserMembership();
+
+  const AdvertisingSet &added = advertisingSets_.back();
+  uint32_t id = added.id;
+  BroadcastAdvertisingSet(env, added);
+  return Napi::Number::New(env, id);
+}
+
+// Replace an advertising set's payload
+Napi::Value BLEAdapter::UpdateAdvertisingSet(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBuffer())
+  {
+    Napi::TypeError::New(env, "Expected advertising set id and buffer data").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Buffer<uint8_t> buf = info[1].As<Napi::Buffer<uint8_t>>();
+  if (buf.Length() < 2 || buf.Length() > ghostmesh::ble::kExtendedAdvertisingDataMax)
+  {
+    Napi::RangeError::New(env, "Advertising set data must be 2 to 251 bytes").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t id = info[0].As<Napi::Number>().Uint32Value();
+  AdvertisingSet *set = FindAdvertisingSet(id);
+  if (set == nullptr)
+  {
+    Napi::Error::New(env, "Unknown advertising set").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  stats_->Add(ghostmesh::ble::StatCounter::AdvertisingUpdates);
+  if (platform_)
+  {
+    try
+    {
+      UpdatePlatformAdvertisingSet(set->handle, buf.Data(), buf.Length());
+    }
+    catch (const ghostmesh::ble::BLEError &error)
+    {
+      ghostmesh::ble::PlatformError(env, error).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+  }
+
+  set->manufacturerData = Napi::Persistent(Napi::Buffer<uint8_t>::Copy(env, buf.Data(), buf.Length()).As<Napi::Value>());
+  BroadcastAdvertisingSet(env, *set);
+  return env.Undefined();
+}
+
+// Stop and remove an advertising set
+Napi::Value BLEAdapter::RemoveAdvertisingSet(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber())
+  {
+    Napi::TypeError::New(env, "Expected advertising set id").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t id = info[0].As<Napi::Number>().Uint32Value();
+  for (auto it = advertisingSets_.begin(); it != advertisingSets_.end(); ++it)
+  {
+    if (it->id == id)
+    {
+      if (platform_)
+      {
+        // The set is forgotten either way; a failed stop is reported as `error`
+        try
+        {
+          StopPlatformAdvertisingSet(it->handle);
+        }
+        catch (const ghostmesh::ble::BLEError &error)
+        {
+          EmitPlatformError(env, error);
+        }
+      }
+      advertisingSets_.erase(it);
+      UpdateAdvertiserMembership();
+      return Napi::Boolean::New(env, true);
+    }
+  }
+  return Napi::Boolean::New(env, false);
+}
+
+// The loopback radio behaves like a BLE 5 controller with a few advertising sets
+Napi::Value BLEAdapter::GetCapabilities(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  Napi::Object caps = Napi::Object::New(env);
+  if (platform_)
+  {
+    ghostmesh::ble::IBLEPlatform::Capabilities platform = platform_->GetCapabilities();
+    caps.Set("supportsExtendedAdvertising", Napi::Boolean::New(env, platform.supportsExtendedAdvertising));
+    caps.Set("maxAdvertisingDataSize", Napi::Number::New(env, platform.maxAdvertisingDataSize));
+    caps.Set("supportsSimultaneousAdvScan",
+             Napi::Boolean::New(env, platform.supportsSimultaneousAdvScan && simultaneousAdvScan_));
+    caps.Set("supportsMultipleAdvSets", Napi::Boolean::New(env, platform.supportsMultipleAdvSets));
+    caps.Set("maxAdvertisingSets", Napi::Number::New(env, platform.supportsMultipleAdvSets ? kMaxAdvertisingSets : 0));
+    caps.Set("supportsScanDutyCycle", Napi::Boolean::New(env, platform.supportsScanDutyCycle));
+    return caps;
+  }
+  caps.Set("supportsExtendedAdvertising", Napi::Boolean::New(env, true));
+  caps.Set("maxAdvertisingDataSize", Napi::Number::New(env, ghostmesh::ble::kExtendedAdvertisingDataMax));
+  // simultaneousAdvScan: false emulates a single-role radio, time sliced natively
+  caps.Set("supportsSimultaneousAdvScan", Napi::Boolean::New(env, simultaneousAdvScan_));
+  caps.Set("supportsMultipleAdvSets", Napi::Boolean::New(env, true));
+  caps.Set("maxAdvertisingSets", Napi::Number::New(env, kMaxAdvertisingSets));
+  // Duty cycling is done in software, by subscribing for each window
+  caps.Set("supportsScanDutyCycle", Napi::Boolean::New(env, false));
+  return caps;
+}
+
+// Copy the link-quality table into one ArrayBuffer of packed records
+Napi::Value BLEAdapter::GetLinkQuality(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  // Sized up front; peers added after this read are picked up by the next poll
+  size_t peers = linkQuality_->Size();
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, peers * ghostmesh::ble::kLinkQualityRecordStride);
+  size_t count = linkQuality_->Snapshot(static_cast<ghostmesh::ble::PackedLinkQualityRecord *>(buffer.Data()),
+                                        peers, NowMs());
+  if (count == peers)
+    return buffer;
+  // The table was cleared in between
+  Napi::ArrayBuffer exact = Napi::ArrayBuffer::New(env, count * ghostmesh::ble::kLinkQualityRecordStride);
+  std::memcpy(exact.Data(), buffer.Data(), count * ghostmesh::ble::kLinkQualityRecordStride);
+  return exact;
+}
+
+// Peers in range, already in most-recently-seen order
+Napi::Value BLEAdapter::GetPeers(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (peers_ == nullptr)
+    return Napi::Array::New(env, 0);
+  const ghostmesh::ble::PeerTable &table = peers_->Table();
+  Napi::Array peers = Napi::Array::New(env, table.Size());
+  uint32_t i = 0;
+  table.ForEachRecent([&](const ghostmesh::ble::Peer &peer)
+                      { peers.Set(i++, PeerToObject(env, peer)); });
+  return peers;
+}
+
+// Reassembly counters of the active `assembleMesh` scan
+Napi::Value BLEAdapter::GetMeshStats(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (assembler_ == nullptr)
+    return env.Null();
+  return MeshAssemblerWrap::StatsToObject(env, assembler_->Stats());
+}
+
+// Counters and histograms, packed for src/stats.ts
+Napi::Value BLEAdapter::GetStats(const Napi::CallbackInfo &info)
+{
+  Napi::Float64Array out = Napi::Float64Array::New(info.Env(), ghostmesh::ble::kStatsSnapshotSize);
+  stats_->Snapshot(out.Data());
+  return out;
+}
+
+// Backend name, for diagnostics
+Napi::Value BLEAdapter::GetPlatformName(const Napi::CallbackInfo &info)
+{
+  return Napi::String::New(info.Env(), platform_ ? platform_->GetPlatformName() : "loopback");
+}
+
+// Start scanning
+Napi::Value BLEAdapter::StartScanning(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (this->state_ != State::PoweredOn)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Cannot scan when adapter is not powered on"),
+                                           "INVALID_STATE");
+  }
+
+  if (this->scanning_)
+  {
+    return ghostmesh::ble::RejectedPromise(env, Napi::Error::New(env, "Already scanning"), "ALREADY_SCANNING");
+  }
+
+  Napi::Value options = info.Length() > 0 ? info[0] : env.Undefined();
+  if (platform_)
+  {
+    return StartPlatformScanning(env, options);
+  }
+  ConfigureScanFilters(options);
+  ConfigureScanDelivery(env, options);
+  ghostmesh::ble::ScanDutyConfig duty = ParseScanDutyCycle(options);
+
+  this->scanning_ = true;
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::ScanningStarted, traceId_);
+  if (!duty.Continuous() && dispatcher_ != nullptr)
+  {
+    // The medium has no duty cycle of its own: each window subscribes and hears what is on air
+    this->EmitEvent(env, ghostmesh::ble::AdapterEvent::ScanningStarted, {});
+    StartScanDutyCycle(duty);
+    UpdateArbitration(env);
+    return ghostmesh::ble::ResolvedPromise(env);
+  }
+  if (RadioContended())
+  {
+    // Listening starts with the first scan slot
+    this->EmitEvent(env, ghostmesh::ble::AdapterEvent::ScanningStarted, {});
+    UpdateArbitration(env);
+    return ghostmesh::ble::ResolvedPromise(env);
+  }
+  listening_ = true;
+  addon_->Medium().Subscribe(this, scanFilter_->CompanyId());
+  this->EmitEvent(env, ghostmesh::ble::AdapterEvent::ScanningStarted, {});
+
+  // Immediately discover any currently advertising adapters
+  bool found = ReceiveAdvertisers(env);
+
+  // If nothing was discovered, emit a simulated discovery so integration tests can proceed
+  if (!found)
+  {
+    // Synthetic, so it bypasses the scan filters
+    std::string simAddress = adapterId_ + "-sim";
+    std::vector<std::string> noServices;
+    ghostmesh::ble::LoopbackFrame frame(simAddress, nullptr, Napi::Value(), noServices);
+    this->DeliverDiscovery(env, frame);
+  }
+
+  return ghostmesh::ble::ResolvedPromise(env);
+}
+
+// Stop scanning
+Napi::Value BLEAdapter::StopScanning(const Napi::CallbackInfo &info)
+{
+  if (platform_)
+  {
+    return StopPlatformScanning(info.Env());
+  }
+  StopScanDutyCycle();
+  // Deliver whatever the current window collected before reporting the stop
+  EndScanDelivery();
+  this->scanning_ = false;
+  UpdateArbitration(info.Env());
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::ScanningStopped, traceId_);
+  this->EmitEvent(info.Env(), ghostmesh::ble::AdapterEvent::ScanningStopped, {});
+  return ghostmesh::ble::ResolvedPromise(info.Env());
+}
+
+// Handle power state transitions
+void BLEAdapter::HandlePowerStateChange(const std::string &newState, Napi::Env env, Napi::Object thisObj)
+{
+  // The simulated radio is shared, so a power change applies to every adapter of this environment.
+  // Copy the list: listeners may create or destroy adapters.
+  std::vector<BLEAdapter *> adapters = AddonInstance::Of(env).Medium().Adapters();
+  for (BLEAdapter *adapter : adapters)
+  {
+    // Update internal state
+    if (newState == "poweredOff")
+    {
+      adapter->state_ = State::PoweredOff;
+      // Stop advertising and scanning
+      adapter->advertising_ = false;
+      adapter->scanning_ = false;
+      if (adapter->scheduler_)
+      {
+        adapter->scheduler_->Stop();
+      }
+      adapter->StopScanDutyCycle();
+      adapter->StopArbitration();
+      adapter->advertisingSets_.clear();
+      adapter->addon_->Medium().SetAdvertising(adapter, false);
+      adapter->addon_->Medium().Unsubscribe(adapter);
+      adapter->listening_ = false;
+      adapter->CloseBatcher();
+      adapter->assembler_.reset();
+      adapter->ClearAdvertisingData();
+      adapter->EmitEvent(env, ghostmesh::ble::AdapterEvent::AdvertisingStopped, {});
+      adapter->EmitEvent(env, ghostmesh::ble::AdapterEvent::ScanningStopped, {});
+    }
+    else if (newState == "poweredOn")
+    {
+      adapter->state_ = State::PoweredOn;
+    }
+
+    // Emit stateChange for all adapters
+    {
+      std::vector<napi_value> a = {Napi::String::New(env, newState)};
+      adapter->EmitEvent(env, ghostmesh::ble::AdapterEvent::StateChange, a);
+    }
+  }
+}
+
+// Destroy adapter
+Napi::Value BLEAdapter::Destroy(const Napi::CallbackInfo &info)
+{
+  ghostmesh::ble::Trace<ghostmesh::ble::TraceLevel::Info>(ghostmesh::ble::TraceEvent::Destroyed, traceId_);
+  // A second destroy() must not queue a second platform shutdown
+  bool live = dispatcher_ != nullptr;
+  this->advertising_ = false;
+  this->scanning_ = false;
+  ClearAdvertisingData();
+  advertisingSets_.clear();
+  for (auto &listeners : listeners_)
+  {
+    listeners.clear();
+  }
+  customListeners_.clear();
+  scheduler_.reset();
+  StopScanDutyCycle();
+  scanCycler_.reset();
+  StopArbitration();
+  arbiter_.reset();
+  listening_ = false;
+  discoveryRing_.Detach();
+  discoveryRingView_.Reset();
+  DetachPlatformCallbacks();
+  CloseDispatcher();
+  CloseBatcher();
+  assembler_.reset();
+  linkQuality_->SetEnabled(false);
+  linkQuality_->Clear();
+  ClosePeers();
+  addon_->Medium().Unregister(this);
+  LeaveRegistry();
+  if (platform_ && live)
+  {
+    return ShutdownPlatform(info.Env());
+  }
+  return ghostmesh::ble::ResolvedPromise(info.Env());
+}
+
+// Copy the addon-wide trace ring into one ArrayBuffer of TraceRecords
+Napi::Value BLEAdapter::DrainTraceBuffer(Napi::Env env)
+{
+  ghostmesh::ble::TraceRing &ring = ghostmesh::ble::TraceRing::Instance();
+  size_t pending = ring.Pending();
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, pending * sizeof(ghostmesh::ble::TraceRecord));
+  size_t count = ring.Drain(static_cast<ghostmesh::ble::TraceRecord *>(buffer.Data()), pending);
+  if (count == pending)
+    return buffer;
+
+  // Some records were lost or still in flight; hand back an exact-size buffer
+  Napi::ArrayBuffer exact = Napi::ArrayBuffer::New(env, count * sizeof(ghostmesh::ble::TraceRecord));
+  std::memcpy(exact.Data(), buffer.Data(), count * sizeof(ghostmesh::ble::TraceRecord));
+  return exact;
+}
+
+// Drain trace records
+Napi::Value BLEAdapter::DrainTrace(const Napi::CallbackInfo &info)
+{
+  return DrainTraceBuffer(info.Env());
+}
+
+// Publish flushed batches into a SharedArrayBuffer ring that other workers read in place
+Napi::Value BLEAdapter::AttachDiscoveryRing(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_int32_array)
+  {
+    Napi::TypeError::New(env, "Expected an Int32Array over a discovery ring").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Int32Array view = info[0].As<Napi::Int32Array>();
+  ghostmesh::ble::DiscoveryRingWriter::AttachResult result =
+      discoveryRing_.Attach(reinterpret_cast<uint8_t *>(view.Data()), view.ByteLength());
+  if (result != ghostmesh::ble::DiscoveryRingWriter::AttachResult::Attached)
+  {
+    // Attach() let go of any previous ring first
+    discoveryRingView_.Reset();
+    if (result == ghostmesh::ble::DiscoveryRingWriter::AttachResult::Busy)
+      Napi::Error::New(env, "Discovery ring already has a writer").ThrowAsJavaScriptException();
+    else
+      Napi::TypeError::New(env, "Not a discovery ring (see createDiscoveryRing())").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  discoveryRingView_ = Napi::Persistent(view);
+  return env.Undefined();
+}
+
+// Release the discovery ring so another adapter, in any worker, can write it
+Napi::Value BLEAdapter::DetachDiscoveryRing(const Napi::CallbackInfo &info)
+{
+  discoveryRing_.Detach();
+  discoveryRingView_.Reset();
+  return info.Env().Undefined();
+}
+
+// Check advertising active
+Napi::Value BLEAdapter::IsAdvertisingActive(const Napi::CallbackInfo &info)
+{
+  return Napi::Boolean::New(info.Env(), this->advertising_);
+}
+
+// Check scanning active
+Napi::Value BLEAdapter::IsScanningActive(const Napi::CallbackInfo &info)
+{
+  return Napi::Boolean::New(info.Env(), this->scanning_);
+}
@@ -1,339 +0,0 @@
-#include "../../cpp/ble_adapter.h"
-
-// macOS platform-specific implementation (currently same as stub)
-
-// Constructor
-BLEAdapter::BLEAdapter(const Napi::CallbackInfo &info)
-    : Napi::ObjectWrap<BLEAdapter>(info), state_(State::PoweredOn), advertising_(false), scanning_(false)
-{
-  // Accept optional options object with `adapterId`
-  if (info.Length() > 0 && info[0].IsObject())
-  {
-    Napi::Object opts = info[0].As<Napi::Object>();
-    if (opts.Has("adapterId") && opts.Get("adapterId").IsString())
-    {
-      adapterId_ = opts.Get("adapterId").As<Napi::String>().Utf8Value();
-    }
-  }
-  if (adapterId_.empty())
-  {
-    adapterId_ = std::to_string(reinterpret_cast<uintptr_t>(this));
-  }
-  adapters_[adapterId_] = this;
-}
-
-// Event listener registration
-Napi::Value BLEAdapter::On(const Napi::CallbackInfo &info)
-{
-  Napi::Env env = info.Env();
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction())
-  {
-    Napi::TypeError::New(env, "Expected event name and callback").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-  std::string event = info[0].As<Napi::String>();
-  Napi::Function callback = info[1].As<Napi::Function>();
-  listeners_[event].push_back(Napi::Persistent(callback));
-  std::cout << "On(): registered listener for event '" << event << "' (total listeners for event: " << listeners_[event].size() << ")" << std::endl;
-  // If listener is for stateChange, emit current state immediately so tests can observe it
-  if (event == "stateChange")
-  {
-    std::vector<napi_value> args = {Napi::String::New(env, this->state_ == State::PoweredOn ? "poweredOn" : "poweredOff")};
-    listeners_[event].back().Call(this->Value(), args);
-  }
-  return env.Undefined();
-}
-
-// Emit event to listeners
-Napi::Value BLEAdapter::Emit(const Napi::CallbackInfo &info)
-{
-  Napi::Env env = info.Env();
-  if (info.Length() < 1 || !info[0].IsString())
-  {
-    Napi::TypeError::New(env, "Expected event name").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-  std::string event = info[0].As<Napi::String>();
-  auto it = listeners_.find(event);
-  if (it != listeners_.end())
-  {
-    std::vector<napi_value> args;
-    for (size_t i = 1; i < info.Length(); ++i)
-    {
-      args.push_back(info[i]);
-    }
-    for (auto &cb : it->second)
-    {
-      cb.Call(info.This(), args);
-    }
-  }
-  return env.Undefined();
-}
-
-// Internal helper to emit events without a CallbackInfo
-void BLEAdapter::EmitEvent(Napi::Env env, const std::string &event, const std::vector<napi_value> &args)
-{
-  auto it = listeners_.find(event);
-  if (it == listeners_.end())
-    return;
-  Napi::Object self = this->Value();
-  std::cout << "EmitEvent: " << event << " -> " << it->second.size() << " listeners" << std::endl;
-  for (auto &cb : it->second)
-  {
-    cb.Call(self, args);
-  }
-}
-
-// Get adapter state
-Napi::Value BLEAdapter::GetState(const Napi::CallbackInfo &info)
-{
-  Napi::Env env = info.Env();
-  std::cout << "getState() called" << std::endl;
-  if (info.Length() > 0 && info[0].IsString())
-  {
-    std::string arg = info[0].As<Napi::String>().Utf8Value();
-    if (arg == "error")
-    {
-      Napi::Error::New(env, "Native BLE error: failed to get state").ThrowAsJavaScriptException();
-      return env.Undefined();
-    }
-    if (arg == "powerOff" || arg == "powerOn")
-    {
-      BLEAdapter::HandlePowerStateChange(arg, env, info.This().As<Napi::Object>());
-    }
-  }
-  switch (this->state_)
-  {
-  case State::PoweredOn:
-    return Napi::String::New(env, "poweredOn");
-  case State::PoweredOff:
-    return Napi::String::New(env, "poweredOff");
-  default:
-    return Napi::String::New(env, "unknown");
-  }
-}
-
-// The rest of methods mirror the stub implementation (StartAdvertising, UpdateAdvertisingData, etc.)
-// Start advertising
-Napi::Value BLEAdapter::StartAdvertising(const Napi::CallbackInfo &info)
-{
-  Napi::Env env = info.Env();
-  if (info.Length() < 1 || !info[0].IsObject())
-  {
-    Napi::TypeError::New(env, "Expected advertising options object").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  if (this->state_ != State::PoweredOn)
-  {
-    Napi::Error::New(env, "Cannot advertise when adapter is not powered on").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  if (this->advertising_)
-  {
-    Napi::Error::New(env, "Already advertising").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  Napi::Object opts = info[0].As<Napi::Object>();
-  if (opts.Has("manufacturerData"))
-  {
-    manufacturerData_ = Napi::Persistent(opts.Get("manufacturerData"));
-  }
-
-  this->advertising_ = true;
-  // Emit advertisingStarted
-  this->EmitEvent(env, "advertisingStarted", {});
-
-  // Notify scanning adapters about this advertiser
-  for (auto &entry : adapters_)
-  {
-    BLEAdapter *other = entry.second;
-    if (other != this && other->scanning_)
-    {
-      Napi::Object device = Napi::Object::New(env);
-      device.Set("address", Napi::String::New(env, adapterId_));
-      if (!manufacturerData_.IsEmpty())
-      {
-        device.Set("manufacturerData", manufacturerData_.Value());
-      }
-      {
-        std::vector<napi_value> a = {device};
-        other->EmitEvent(env, "deviceDiscovered", a);
-      }
-    }
-  }
-
-  return env.Undefined();
-}
-
-// Update advertising data
-Napi::Value BLEAdapter::UpdateAdvertisingData(const Napi::CallbackInfo &info)
-{
-  Napi::Env env = info.Env();
-  if (info.Length() < 1)
-  {
-    Napi::TypeError::New(env, "Expected buffer data").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  if (!this->advertising_)
-  {
-    Napi::Error::New(env, "Not currently advertising").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  manufacturerData_ = Napi::Persistent(info[0]);
-  {
-    std::vector<napi_value> a = {info[0]};
-    this->EmitEvent(env, "advertisingDataUpdated", a);
-  }
-
-  // Notify scanners about updated data
-  for (auto &entry : adapters_)
-  {
-    BLEAdapter *other = entry.second;
-    if (other != this && other->scanning_)
-    {
-      Napi::Object device = Napi::Object::New(env);
-      device.Set("address", Napi::String::New(env, adapterId_));
-      device.Set("manufacturerData", info[0]);
-      {
-        std::vector<napi_value> a = {device};
-        other->EmitEvent(env, "deviceDiscovered", a);
-      }
-    }
-  }
-
-  return env.Undefined();
-}
-
-// Stop advertising
-Napi::Value BLEAdapter::StopAdvertising(const Napi::CallbackInfo &info)
-{
-  this->advertising_ = false;
-  manufacturerData_.Reset();
-  this->EmitEvent(info.Env(), "advertisingStopped", {});
-  return info.Env().Undefined();
-}
-
-// Start scanning
-Napi::Value BLEAdapter::StartScanning(const Napi::CallbackInfo &info)
-{
-  Napi::Env env = info.Env();
-  if (this->state_ != State::PoweredOn)
-  {
-    Napi::Error::New(env, "Cannot scan when adapter is not powered on").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  if (this->scanning_)
-  {
-    Napi::Error::New(env, "Already scanning").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
-
-  this->scanning_ = true;
-  this->EmitEvent(env, "scanningStarted", {});
-
-  // Immediately discover any currently advertising adapters
-  bool found = false;
-  for (auto &entry : adapters_)
-  {
-    BLEAdapter *other = entry.second;
-    if (other != this && other->advertising_ && !other->manufacturerData_.IsEmpty())
-    {
-      Napi::Object device = Napi::Object::New(env);
-      device.Set("address", Napi::String::New(env, other->adapterId_));
-      device.Set("manufacturerData", other->manufacturerData_.Value());
-      {
-        std::vector<napi_value> a = {device};
-        this->EmitEvent(env, "deviceDiscovered", a);
-        found = true;
-      }
-    }
-  }
-
-  // If nothing was discovered, emit a simulated discovery so integration tests can proceed
-  if (!found)
-  {
-    Napi::Object device = Napi::Object::New(env);
-    device.Set("address", Napi::String::New(env, adapterId_ + "-sim"));
-    std::vector<napi_value> a = {device};
-    this->EmitEvent(env, "deviceDiscovered", a);
-  }
-
-  return env.Undefined();
-}
-
-// Stop scanning
-Napi::Value BLEAdapter::StopScanning(const Napi::CallbackInfo &info)
-{
-  this->scanning_ = false;
-  this->EmitEvent(info.Env(), "scanningStopped", {});
-  return info.Env().Undefined();
-}
-
-// Handle power state transitions
-void BLEAdapter::HandlePowerStateChange(const std::string &newState, Napi::Env env, Napi::Object thisObj)
-{
-  // Find the corresponding BLEAdapter instance
-  // We can look up by `thisObj` only if it contains adapterId, otherwise iterate
-  for (auto &entry : adapters_)
-  {
-    BLEAdapter *adapter = entry.second;
-    // Update internal state
-    if (newState == "poweredOff")
-    {
-      adapter->state_ = State::PoweredOff;
-      // Stop advertising and scanning
-      adapter->advertising_ = false;
-      adapter->scanning_ = false;
-      adapter->manufacturerData_.Reset();
-      adapter->EmitEvent(env, "advertisingStopped", {});
-      adapter->EmitEvent(env, "scanningStopped", {});
-    }
-    else if (newState == "poweredOn")
-    {
-      adapter->state_ = State::PoweredOn;
-    }
-
-    // Emit stateChange for all adapters
-    {
-      std::vector<napi_value> a = {Napi::String::New(env, newState)};
-      adapter->EmitEvent(env, "stateChange", a);
-    }
-  }
-}
-
-// Destroy adapter
-Napi::Value BLEAdapter::Destroy(const Napi::CallbackInfo &info)
-{
-  std::cout << "destroy() called" << std::endl;
-  this->advertising_ = false;
-  this->scanning_ = false;
-  manufacturerData_.Reset();
-  listeners_.clear();
-  if (!adapterId_.empty())
-  {
-    auto it = adapters_.find(adapterId_);
-    if (it != adapters_.end() && it->second == this)
-    {
-      adapters_.erase(it);
-    }
-  }
-  return info.Env().Undefined();
-}
-
-// Check advertising active
-Napi::Value BLEAdapter::IsAdvertisingActive(const Napi::CallbackInfo &info)
-{
-  return Napi::Boolean::New(info.Env(), this->advertising_);
-}
-
-// Check scanning active
-Napi::Value BLEAdapter::IsScanningActive(const Napi::CallbackInfo &info)
-{
-  return Napi::Boolean::New(info.Env(), this->scanning_);
-}
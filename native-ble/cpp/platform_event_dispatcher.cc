@@ -0,0 +1,145 @@
+/**
+ * @file platform_event_dispatcher.cc
+ * @brief Implementation of PlatformEventDispatcher
+ */
+
+#include "platform_event_dispatcher.h"
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    PlatformEventDispatcher::PlatformEventDispatcher(BatchHandler handler)
+        : handler_(std::move(handler)), drainScheduled_(false), closed_(false)
+    {
+      batch_.reserve(kMaxBatch);
+    }
+
+    PlatformEventDispatcher *PlatformEventDispatcher::Create(Napi::Env env, BatchHandler handler)
+    {
+      auto *self = new PlatformEventDispatcher(std::move(handler));
+      self->tsfn_ = Tsfn::New(
+          env,
+          "GhostMeshPlatformEvents",
+          0, // unlimited; the MpscQueue is the real bound
+          1,
+          self,
+          [](Napi::Env, void *, PlatformEventDispatcher *ctx)
+          { delete ctx; },
+          static_cast<void *>(nullptr));
+      // Platform delivery must not keep the event loop alive on its own
+      self->tsfn_.Unref(env);
+      return self;
+    }
+
+    void PlatformEventDispatcher::PostDeviceDiscovered(const DiscoveredDevice &device)
+    {
+      PlatformEvent event;
+      event.kind = PlatformEvent::Kind::DeviceDiscovered;
+      event.device = device;
+      Push(std::move(event));
+    }
+
+    void PlatformEventDispatcher::PostStateChange(BLEState state)
+    {
+      PlatformEvent event;
+      event.kind = PlatformEvent::Kind::StateChange;
+      event.state = state;
+      Push(std::move(event));
+    }
+
+    void PlatformEventDispatcher::PostAdvertising(PlatformEvent::Kind kind, uint32_t id, uint32_t sent,
+                                                  const AdvertisingData &data)
+    {
+      PlatformEvent event;
+      event.kind = kind;
+      event.advertisementId = id;
+      event.sentCount = sent;
+      event.advertisement = data;
+      Push(std::move(event));
+    }
+
+    void PlatformEventDispatcher::PostScanWindow(PlatformEvent::Kind kind, uint32_t gapMs)
+    {
+      PlatformEvent event;
+      event.kind = kind;
+      event.scanGapMs = gapMs;
+      Push(std::move(event));
+    }
+
+    void PlatformEventDispatcher::PostRadioSlot(PlatformEvent::Kind kind)
+    {
+      PlatformEvent event;
+      event.kind = kind;
+      Push(std::move(event));
+    }
+
+    void PlatformEventDispatcher::PostError(const BLEError &error)
+    {
+      PlatformEvent event;
+      event.kind = PlatformEvent::Kind::Error;
+      event.errorCode = error.code;
+      event.message = error.message;
+      event.nativeError = error.nativeError;
+      Push(std::move(event));
+    }
+
+    void PlatformEventDispatcher::Push(PlatformEvent &&event)
+    {
+      if (closed_.load(std::memory_order_acquire))
+        return;
+      event.queuedUs = StatsNowUs();
+      if (!queue_.TryPush(std::move(event)))
+        return;
+      // Only the first producer after a drain pays for the TSFN call
+      if (!drainScheduled_.exchange(true, std::memory_order_acq_rel))
+      {
+        tsfn_.NonBlockingCall();
+      }
+    }
+
+    void PlatformEventDispatcher::CallJs(Napi::Env env, Napi::Function, PlatformEventDispatcher *self, void *)
+    {
+      if (env == nullptr || self == nullptr)
+        return;
+      self->Drain(env);
+    }
+
+    void PlatformEventDispatcher::Drain(Napi::Env env)
+    {
+      // Clear before popping: anything pushed from here on schedules a new call
+      drainScheduled_.store(false, std::memory_order_release);
+      if (closed_.load(std::memory_order_acquire))
+        return;
+
+      Napi::HandleScope scope(env);
+      batch_.clear();
+      PlatformEvent event;
+      while (batch_.size() < kMaxBatch && queue_.TryPop(event))
+      {
+        batch_.push_back(std::move(event));
+      }
+      if (batch_.empty())
+        return;
+
+      bool more = batch_.size() == kMaxBatch;
+      handler_(env, batch_);
+
+      // Yield to the event loop between large batches instead of starving it
+      if (more && !closed_.load(std::memory_order_acquire) &&
+          !drainScheduled_.exchange(true, std::memory_order_acq_rel))
+      {
+        tsfn_.NonBlockingCall();
+      }
+    }
+
+    void PlatformEventDispatcher::Close()
+    {
+      if (closed_.exchange(true, std::memory_order_acq_rel))
+        return;
+      tsfn_.Release();
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
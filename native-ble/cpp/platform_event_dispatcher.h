@@ -0,0 +1,166 @@
+#ifndef NATIVE_BLE_PLATFORM_EVENT_DISPATCHER_H
+#define NATIVE_BLE_PLATFORM_EVENT_DISPATCHER_H
+
+#include <napi.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../binding/platform/ble_platform.h"
+#include "adapter_stats.h"
+#include "event_queue.h"
+
+/**
+ * @file platform_event_dispatcher.h
+ * @brief Batched delivery of platform-thread events onto the JS thread
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @struct PlatformEvent
+     * @brief Event reported by an IBLEPlatform callback, queued for the JS thread
+     */
+    struct PlatformEvent
+    {
+      enum class Kind
+      {
+        StateChange,
+        DeviceDiscovered,
+        AdvertisingRotated,     ///< Scheduler put a new payload on air
+        AdvertisementCompleted, ///< Scheduled payload reached its repeat count
+        AdvertisementExpired,   ///< Scheduled payload's TTL ran out
+        ScanWindowOpened,       ///< Duty cycler started a scan window
+        ScanWindowClosed,       ///< Duty cycler ended a scan window
+        RadioSlotAdvertise,     ///< Coexistence arbiter gave the radio to advertising
+        RadioSlotScan,          ///< Coexistence arbiter gave the radio to scanning
+        Error                   ///< Platform reported an asynchronous error
+      };
+
+      Kind kind;
+      BLEState state;                ///< Valid for StateChange
+      DiscoveredDevice device;       ///< Valid for DeviceDiscovered
+      AdvertisingData advertisement; ///< Valid for AdvertisingRotated
+      uint32_t advertisementId;      ///< Valid for the Advertis* kinds
+      uint32_t sentCount;            ///< Valid for the Advertis* kinds
+      uint32_t scanGapMs;            ///< Valid for ScanWindowOpened: time the radio was not listening
+      BLEError::Code errorCode;      ///< Valid for Error
+      std::string message;           ///< Valid for Error
+      std::string nativeError;       ///< Valid for Error
+      uint64_t queuedUs;             ///< StatsNowUs() when pushed, for the dispatch latency histogram
+
+      PlatformEvent()
+          : kind(Kind::DeviceDiscovered), state(BLEState::UNKNOWN), advertisementId(0), sentCount(0), scanGapMs(0),
+            errorCode(BLEError::Code::UNKNOWN_ERROR), queuedUs(0) {}
+    };
+
+    /**
+     * @class PlatformEventDispatcher
+     * @brief Moves platform events onto the JS thread in batches
+     *
+     * Producers push into a lock-free MpscQueue. The first push after a drain
+     * schedules one ThreadSafeFunction call; every event queued before that call
+     * runs is delivered in the same batch, so the JS crossing is paid once per
+     * event-loop tick rather than once per advertisement.
+     *
+     * The dispatcher is owned by its ThreadSafeFunction: create it with Create()
+     * and tear it down with Close(); the finalizer frees it once the last
+     * pending call has run.
+     */
+    class PlatformEventDispatcher
+    {
+    public:
+      /**
+       * @brief Batch handler, invoked on the JS thread inside a HandleScope
+       */
+      using BatchHandler = std::function<void(Napi::Env env, std::vector<PlatformEvent> &batch)>;
+
+      /**
+       * @brief Create a dispatcher bound to the calling JS environment
+       * @param env N-API environment (JS thread only)
+       * @param handler Receives each drained batch
+       * @return Dispatcher owned by its ThreadSafeFunction
+       */
+      static PlatformEventDispatcher *Create(Napi::Env env, BatchHandler handler);
+
+      /**
+       * @brief Queue a discovered device (any thread)
+       * @param device Device report from the platform layer
+       */
+      void PostDeviceDiscovered(const DiscoveredDevice &device);
+
+      /**
+       * @brief Queue an adapter state change (any thread)
+       * @param state New state reported by the platform layer
+       */
+      void PostStateChange(BLEState state);
+
+      /**
+       * @brief Queue an advertising scheduler event (any thread)
+       * @param kind One of the Advertis* kinds
+       * @param id Scheduled payload ID
+       * @param sent Transmissions so far
+       * @param data Payload now on air (AdvertisingRotated only)
+       */
+      void PostAdvertising(PlatformEvent::Kind kind, uint32_t id, uint32_t sent, const AdvertisingData &data);
+
+      /**
+       * @brief Queue a scan duty cycle edge (any thread)
+       * @param kind ScanWindowOpened or ScanWindowClosed
+       * @param gapMs Time since the previous window closed (ScanWindowOpened only)
+       */
+      void PostScanWindow(PlatformEvent::Kind kind, uint32_t gapMs);
+
+      /**
+       * @brief Queue a coexistence slot boundary (any thread)
+       * @param kind RadioSlotAdvertise or RadioSlotScan
+       */
+      void PostRadioSlot(PlatformEvent::Kind kind);
+
+      /**
+       * @brief Queue a platform error (any thread)
+       * @param error Error reported through IBLEPlatform::SetErrorCallback
+       */
+      void PostError(const BLEError &error);
+
+      /**
+       * @brief Stop delivery and release the ThreadSafeFunction (JS thread only)
+       *
+       * Events still queued are discarded. The object is freed asynchronously,
+       * so the caller must not touch it after Close() returns.
+       */
+      void Close();
+
+      /**
+       * @brief Number of events dropped because the queue was full
+       */
+      uint64_t DroppedCount() const { return queue_.DroppedCount(); }
+
+    private:
+      static constexpr size_t kQueueCapacity = 1024;
+      static constexpr size_t kMaxBatch = 256;
+
+      static void CallJs(Napi::Env env, Napi::Function, PlatformEventDispatcher *self, void *);
+      using Tsfn = Napi::TypedThreadSafeFunction<PlatformEventDispatcher, void, CallJs>;
+
+      explicit PlatformEventDispatcher(BatchHandler handler);
+
+      void Push(PlatformEvent &&event);
+      void Drain(Napi::Env env);
+
+      Tsfn tsfn_;
+      BatchHandler handler_;
+      MpscQueue<PlatformEvent, kQueueCapacity> queue_;
+      std::vector<PlatformEvent> batch_;
+      std::atomic<bool> drainScheduled_;
+      std::atomic<bool> closed_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_PLATFORM_EVENT_DISPATCHER_H
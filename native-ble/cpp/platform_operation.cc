@@ -0,0 +1,138 @@
+/**
+ * @file platform_operation.cc
+ * @brief Implementation of promise-returning platform calls
+ */
+
+#include "platform_operation.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    struct PlatformOperation::Signal
+    {
+      std::mutex mutex;
+      std::condition_variable cv;
+      bool done = false;
+    };
+
+    Napi::Promise PlatformOperation::Start(Napi::Env env, Operation operation, Completion completion,
+                                           uint32_t timeoutMs)
+    {
+      PlatformOperation *worker = new PlatformOperation(env, std::move(operation), std::move(completion), timeoutMs);
+      Napi::Promise promise = worker->deferred_.Promise();
+      worker->Queue();
+      return promise;
+    }
+
+    PlatformOperation::PlatformOperation(Napi::Env env, Operation operation, Completion completion,
+                                         uint32_t timeoutMs)
+        : Napi::AsyncWorker(env, "GhostMeshPlatformOperation"), deferred_(Napi::Promise::Deferred::New(env)),
+          operation_(std::move(operation)), completion_(std::move(completion)), timeoutMs_(timeoutMs),
+          code_("OPERATION_FAILED"), signal_(std::make_shared<Signal>())
+    {
+    }
+
+    // Pool thread: run the call, then wait for its SuccessCallback
+    void PlatformOperation::Execute()
+    {
+      std::shared_ptr<Signal> signal = signal_;
+      try
+      {
+        operation_([signal]()
+                   {
+                     std::lock_guard<std::mutex> lock(signal->mutex);
+                     signal->done = true;
+                     signal->cv.notify_one();
+                   });
+      }
+      catch (const BLEError &error)
+      {
+        code_ = JsErrorCode(error.code);
+        nativeError_ = error.nativeError;
+        SetError(error.message);
+        return;
+      }
+
+      std::unique_lock<std::mutex> lock(signal->mutex);
+      if (!signal->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs_), [&signal]
+                               { return signal->done; }))
+      {
+        code_ = "TIMEOUT";
+        SetError("Platform did not complete the operation in time");
+      }
+    }
+
+    void PlatformOperation::OnOK()
+    {
+      Napi::Env env = Env();
+      Napi::HandleScope scope(env);
+      if (completion_)
+        completion_(env, true);
+      deferred_.Resolve(env.Undefined());
+    }
+
+    void PlatformOperation::OnError(const Napi::Error &error)
+    {
+      Napi::Env env = Env();
+      Napi::HandleScope scope(env);
+      if (completion_)
+        completion_(env, false);
+      Napi::Object value = error.Value();
+      value.Set("code", Napi::String::New(env, code_));
+      if (!nativeError_.empty())
+        value.Set("nativeError", Napi::String::New(env, nativeError_));
+      deferred_.Reject(value);
+    }
+
+    const char *JsErrorCode(BLEError::Code code)
+    {
+      switch (code)
+      {
+      case BLEError::Code::ADAPTER_UNAVAILABLE:
+      case BLEError::Code::ADAPTER_UNAUTHORIZED:
+      case BLEError::Code::ADAPTER_POWERED_OFF:
+        return "INVALID_STATE";
+      case BLEError::Code::ADVERTISING_UNSUPPORTED:
+        return "UNSUPPORTED";
+      case BLEError::Code::INVALID_PARAMETER:
+      case BLEError::Code::PAYLOAD_TOO_LARGE:
+        return "INVALID_PARAMETER";
+      default:
+        return "OPERATION_FAILED";
+      }
+    }
+
+    Napi::Error PlatformError(Napi::Env env, const BLEError &error)
+    {
+      Napi::Error jsError = Napi::Error::New(env, error.message);
+      Napi::Object value = jsError.Value();
+      value.Set("code", Napi::String::New(env, JsErrorCode(error.code)));
+      if (!error.nativeError.empty())
+        value.Set("nativeError", Napi::String::New(env, error.nativeError));
+      return jsError;
+    }
+
+    Napi::Promise ResolvedPromise(Napi::Env env)
+    {
+      Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+      deferred.Resolve(env.Undefined());
+      return deferred.Promise();
+    }
+
+    Napi::Promise RejectedPromise(Napi::Env env, Napi::Error error, const char *code)
+    {
+      Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+      Napi::Object value = error.Value();
+      value.Set("code", Napi::String::New(env, code));
+      deferred.Reject(value);
+      return deferred.Promise();
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,110 @@
+#ifndef NATIVE_BLE_PLATFORM_OPERATION_H
+#define NATIVE_BLE_PLATFORM_OPERATION_H
+
+#include <napi.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "../binding/platform/ble_platform.h"
+
+/**
+ * @file platform_operation.h
+ * @brief Promise-returning IBLEPlatform calls run off the JS thread
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @class PlatformOperation
+     * @brief One IBLEPlatform call on the libuv thread pool, settled as a Promise
+     *
+     * Execute() invokes the operation on a pool thread and waits for its
+     * SuccessCallback, so radio setup that blocks (CoreBluetooth and WinRT
+     * take tens of milliseconds) never stalls the event loop. The promise
+     * resolves on the JS thread once the callback has fired; a BLEError
+     * thrown by the platform rejects it with a mapped `code`, and a callback
+     * that never arrives rejects it with TIMEOUT.
+     *
+     * The worker deletes itself after settling. A callback that fires after
+     * the timeout is ignored.
+     */
+    class PlatformOperation : public Napi::AsyncWorker
+    {
+    public:
+      /**
+       * @brief Platform call to run; must eventually invoke `done` or throw BLEError
+       */
+      using Operation = std::function<void(SuccessCallback done)>;
+
+      /**
+       * @brief JS-thread continuation run just before the promise settles (may be empty)
+       *
+       * `succeeded` is false when the promise is about to be rejected, so
+       * state reserved for the operation can be rolled back.
+       */
+      using Completion = std::function<void(Napi::Env env, bool succeeded)>;
+
+      static constexpr uint32_t kDefaultTimeoutMs = 10000;
+
+      /**
+       * @brief Start an operation
+       * @param env N-API environment
+       * @param operation Platform call, run on a pool thread
+       * @param completion Run on the JS thread before settling (e.g. to emit events)
+       * @param timeoutMs How long to wait for the SuccessCallback
+       * @return Promise settled when the operation completes
+       */
+      static Napi::Promise Start(Napi::Env env, Operation operation, Completion completion = nullptr,
+                                 uint32_t timeoutMs = kDefaultTimeoutMs);
+
+    protected:
+      void Execute() override;
+      void OnOK() override;
+      void OnError(const Napi::Error &error) override;
+
+    private:
+      struct Signal;
+
+      PlatformOperation(Napi::Env env, Operation operation, Completion completion, uint32_t timeoutMs);
+
+      Napi::Promise::Deferred deferred_;
+      Operation operation_;
+      Completion completion_;
+      uint32_t timeoutMs_;
+      const char *code_; ///< JS error code for OnError
+      std::string nativeError_;
+      std::shared_ptr<Signal> signal_; ///< Shared with the SuccessCallback, which may outlive the worker
+    };
+
+    /**
+     * @brief JS BLEErrorCode for a platform error code
+     */
+    const char *JsErrorCode(BLEError::Code code);
+
+    /**
+     * @brief JS Error for a platform failure, with `code` and `nativeError` set
+     */
+    Napi::Error PlatformError(Napi::Env env, const BLEError &error);
+
+    /**
+     * @brief Promise that is already resolved with undefined
+     */
+    Napi::Promise ResolvedPromise(Napi::Env env);
+
+    /**
+     * @brief Promise that is already rejected
+     * @param env N-API environment
+     * @param error Rejection reason
+     * @param code JS BLEErrorCode set as the error's `code`
+     */
+    Napi::Promise RejectedPromise(Napi::Env env, Napi::Error error, const char *code);
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_PLATFORM_OPERATION_H
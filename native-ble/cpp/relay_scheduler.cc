@@ -0,0 +1,134 @@
+/**
+ * @file relay_scheduler.cc
+ * @brief Implementation of counter-based relay suppression
+ */
+
+#include "relay_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    RelayScheduler::RelayScheduler(const RelayConfig &config)
+        : config_(config), scheduled_(0), relayed_(0), suppressed_(0), overflowed_(0)
+    {
+      if (config_.maxBackoffMs < config_.minBackoffMs)
+        std::swap(config_.minBackoffMs, config_.maxBackoffMs);
+      if (config_.maxThreshold < config_.minThreshold)
+        std::swap(config_.minThreshold, config_.maxThreshold);
+      config_.minThreshold = std::max<uint32_t>(1, config_.minThreshold);
+      config_.maxThreshold = std::max(config_.minThreshold, config_.maxThreshold);
+      config_.capacity = std::max<size_t>(1, config_.capacity);
+
+      // Spread small seeds over the word; xorshift starts slowly from few set bits
+      state_ = config_.seed * 0x9E3779B9u;
+      while (state_ == 0)
+        state_ = std::random_device()();
+      pending_.reserve(config_.capacity);
+    }
+
+    // 0 at weakRssi or below, 1 at strongRssi or above
+    double RelayScheduler::Proximity(int32_t rssi) const
+    {
+      if (config_.strongRssi <= config_.weakRssi)
+        return rssi >= config_.strongRssi ? 1.0 : 0.0;
+      double p = double(rssi - config_.weakRssi) / double(config_.strongRssi - config_.weakRssi);
+      return std::min(1.0, std::max(0.0, p));
+    }
+
+    // Uniform in [0, 1); xorshift32 so runs are reproducible from a seed
+    double RelayScheduler::NextUniform()
+    {
+      state_ ^= state_ << 13;
+      state_ ^= state_ >> 17;
+      state_ ^= state_ << 5;
+      return state_ / 4294967296.0;
+    }
+
+    uint32_t RelayScheduler::ThresholdFor(int32_t rssi) const
+    {
+      uint32_t span = config_.maxThreshold - config_.minThreshold;
+      return config_.maxThreshold - static_cast<uint32_t>(std::lround(Proximity(rssi) * span));
+    }
+
+    // Entries whose caller never came back to Release() them
+    void RelayScheduler::DropOverdue(uint64_t nowMs)
+    {
+      for (auto it = pending_.begin(); it != pending_.end();)
+      {
+        if (it->second.dueMs + config_.maxBackoffMs <= nowMs)
+          it = pending_.erase(it);
+        else
+          ++it;
+      }
+    }
+
+    uint32_t RelayScheduler::Schedule(uint64_t key, int32_t rssi, uint64_t nowMs)
+    {
+      auto it = pending_.find(key);
+      if (it != pending_.end())
+        return it->second.dueMs > nowMs ? static_cast<uint32_t>(it->second.dueMs - nowMs) : 0;
+
+      // Edge nodes draw from the lower half of the window, so they tend to go first
+      double p = Proximity(rssi);
+      double window = double(config_.maxBackoffMs - config_.minBackoffMs) * (0.5 + 0.5 * p);
+      uint32_t backoff = config_.minBackoffMs + static_cast<uint32_t>(NextUniform() * window);
+      ++scheduled_;
+
+      if (pending_.size() >= config_.capacity)
+        DropOverdue(nowMs);
+      if (pending_.size() >= config_.capacity)
+      {
+        // Relaying unconditionally beats dropping the message
+        ++overflowed_;
+        return backoff;
+      }
+
+      pending_.emplace(key, Pending{nowMs + backoff, 0, ThresholdFor(rssi), false});
+      return backoff;
+    }
+
+    bool RelayScheduler::Overheard(uint64_t key)
+    {
+      auto it = pending_.find(key);
+      if (it == pending_.end() || it->second.suppressed)
+        return false;
+      if (++it->second.heard < it->second.threshold)
+        return false;
+      it->second.suppressed = true;
+      ++suppressed_;
+      return true;
+    }
+
+    bool RelayScheduler::Release(uint64_t key)
+    {
+      auto it = pending_.find(key);
+      if (it != pending_.end())
+      {
+        bool suppressed = it->second.suppressed;
+        pending_.erase(it);
+        if (suppressed)
+          return false;
+      }
+      ++relayed_;
+      return true;
+    }
+
+    RelayStats RelayScheduler::Stats() const
+    {
+      RelayStats stats;
+      stats.pending = pending_.size();
+      stats.scheduled = scheduled_;
+      stats.relayed = relayed_;
+      stats.suppressed = suppressed_;
+      stats.overflowed = overflowed_;
+      return stats;
+    }
+
+  } // namespace mesh
+} // namespace ghostmesh
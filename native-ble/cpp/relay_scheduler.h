@@ -0,0 +1,134 @@
+#ifndef NATIVE_BLE_RELAY_SCHEDULER_H
+#define NATIVE_BLE_RELAY_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @file relay_scheduler.h
+ * @brief Counter-based flooding suppression for mesh relays
+ *
+ * Native counterpart of the TypeScript fallback in src/relay.ts.
+ */
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    /**
+     * @struct RelayConfig
+     * @brief Backoff window and RSSI-weighted suppression thresholds
+     *
+     * Proximity is the RSSI of the first copy heard, mapped linearly from 0 at
+     * weakRssi to 1 at strongRssi. A node close to the sender adds little
+     * coverage by relaying, so it waits longer and gives up after fewer
+     * duplicates; a node at the edge of range relays early and is hard to
+     * suppress.
+     */
+    struct RelayConfig
+    {
+      uint32_t minBackoffMs = 100;
+      uint32_t maxBackoffMs = 500;
+      uint32_t minThreshold = 2;  ///< Duplicates that cancel a relay at strongRssi
+      uint32_t maxThreshold = 4;  ///< Duplicates that cancel a relay at weakRssi
+      int32_t strongRssi = -50;   ///< dBm
+      int32_t weakRssi = -90;     ///< dBm
+      size_t capacity = 1024;     ///< Relays pending at once
+      uint32_t seed = 0;          ///< Backoff PRNG seed; 0 picks a random one
+    };
+
+    /**
+     * @struct RelayStats
+     * @brief Counters since construction
+     */
+    struct RelayStats
+    {
+      size_t pending;
+      uint64_t scheduled;  ///< Relays scheduled
+      uint64_t relayed;    ///< Released for transmission
+      uint64_t suppressed; ///< Cancelled by overheard duplicates
+      uint64_t overflowed; ///< Scheduled while the table was full, so never suppressible
+    };
+
+    /**
+     * @class RelayScheduler
+     * @brief Decides which received messages are worth relaying
+     *
+     * Instead of rebroadcasting every new message, a node schedules the relay
+     * after a random backoff and counts the copies it overhears meanwhile
+     * (the duplicates its dedup cache rejects). Once the count reaches the
+     * message's threshold, enough neighbours have covered the area and the
+     * relay is cancelled. In a dense room most nodes stay silent; in a sparse
+     * chain every node still relays.
+     *
+     * The caller owns the timer: Schedule() returns the delay, and Release()
+     * when it fires says whether to transmit, so a suppressed relay needs no
+     * timer cancelling. Keys are 64-bit message hashes.
+     * Not synchronized: the mesh layer drives it from the JS thread.
+     */
+    class RelayScheduler
+    {
+    public:
+      explicit RelayScheduler(const RelayConfig &config = RelayConfig());
+
+      RelayScheduler(const RelayScheduler &) = delete;
+      RelayScheduler &operator=(const RelayScheduler &) = delete;
+
+      /**
+       * @brief Schedule the relay of a message heard for the first time
+       * @param key Message key
+       * @param rssi Signal strength of that first copy, dBm
+       * @param nowMs Current time in milliseconds
+       * @return Backoff in ms before the caller should call Release(); the
+       *         remaining backoff if the key is already pending
+       */
+      uint32_t Schedule(uint64_t key, int32_t rssi, uint64_t nowMs);
+
+      /**
+       * @brief Count a duplicate overheard while the relay is pending
+       * @return true if this duplicate reached the threshold and cancelled the relay
+       */
+      bool Overheard(uint64_t key);
+
+      /**
+       * @brief The backoff for `key` has elapsed; forgets the key
+       * @return false if the relay was suppressed, true to transmit (including
+       *         keys that were never tracked)
+       */
+      bool Release(uint64_t key);
+
+      /**
+       * @brief Duplicates needed to cancel a relay first heard at `rssi`
+       */
+      uint32_t ThresholdFor(int32_t rssi) const;
+
+      RelayStats Stats() const;
+
+    private:
+      struct Pending
+      {
+        uint64_t dueMs;
+        uint32_t heard;     ///< Duplicates overheard so far
+        uint32_t threshold;
+        bool suppressed;    ///< Kept until Release() so the caller's timer needs no cancelling
+      };
+
+      double Proximity(int32_t rssi) const;
+      double NextUniform();
+      void DropOverdue(uint64_t nowMs);
+
+      RelayConfig config_;
+      uint32_t state_; ///< xorshift32
+      std::unordered_map<uint64_t, Pending> pending_;
+      uint64_t scheduled_;
+      uint64_t relayed_;
+      uint64_t suppressed_;
+      uint64_t overflowed_;
+    };
+
+  } // namespace mesh
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_RELAY_SCHEDULER_H
@@ -0,0 +1,117 @@
+/**
+ * @file relay_scheduler_wrap.cc
+ * @brief N-API binding for the relay suppression engine
+ */
+
+#include "relay_scheduler_wrap.h"
+
+#include "wrap_args.h"
+
+namespace
+{
+  using ghostmesh::ble::KeyArg;
+  using ghostmesh::ble::NowArg;
+
+  template <typename T>
+  void ReadOption(const Napi::Object &options, const char *name, T &field)
+  {
+    if (options.Has(name) && options.Get(name).IsNumber())
+      field = static_cast<T>(options.Get(name).As<Napi::Number>().Int64Value());
+  }
+
+  int32_t RssiArg(const Napi::CallbackInfo &info, size_t index)
+  {
+    if (info.Length() > index && info[index].IsNumber())
+      return info[index].As<Napi::Number>().Int32Value();
+    return 0;
+  }
+} // namespace
+
+Napi::Object RelaySchedulerWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  Napi::Function func = DefineClass(env, "RelayScheduler",
+                                    {
+                                        InstanceMethod("schedule", &RelaySchedulerWrap::Schedule),
+                                        InstanceMethod("overheard", &RelaySchedulerWrap::Overheard),
+                                        InstanceMethod("release", &RelaySchedulerWrap::Release),
+                                        InstanceMethod("thresholdFor", &RelaySchedulerWrap::ThresholdFor),
+                                        InstanceMethod("stats", &RelaySchedulerWrap::Stats),
+                                    });
+  exports.Set("RelayScheduler", func);
+  return exports;
+}
+
+RelaySchedulerWrap::RelaySchedulerWrap(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<RelaySchedulerWrap>(info),
+      scheduler_(info.Length() > 0 && info[0].IsObject() ? ConfigFromObject(info[0].As<Napi::Object>())
+                                                         : ghostmesh::mesh::RelayConfig())
+{
+}
+
+ghostmesh::mesh::RelayConfig RelaySchedulerWrap::ConfigFromObject(const Napi::Object &options)
+{
+  ghostmesh::mesh::RelayConfig config;
+  ReadOption(options, "minBackoffMs", config.minBackoffMs);
+  ReadOption(options, "maxBackoffMs", config.maxBackoffMs);
+  ReadOption(options, "minThreshold", config.minThreshold);
+  ReadOption(options, "maxThreshold", config.maxThreshold);
+  ReadOption(options, "strongRssi", config.strongRssi);
+  ReadOption(options, "weakRssi", config.weakRssi);
+  ReadOption(options, "capacity", config.capacity);
+  ReadOption(options, "seed", config.seed);
+  return config;
+}
+
+Napi::Value RelaySchedulerWrap::Schedule(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArg(info, key))
+  {
+    Napi::TypeError::New(env, "Expected message id (string or number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Number::New(env, scheduler_.Schedule(key, RssiArg(info, 1), NowArg(info, 2)));
+}
+
+Napi::Value RelaySchedulerWrap::Overheard(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArg(info, key))
+  {
+    Napi::TypeError::New(env, "Expected message id (string or number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, scheduler_.Overheard(key));
+}
+
+Napi::Value RelaySchedulerWrap::Release(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArg(info, key))
+  {
+    Napi::TypeError::New(env, "Expected message id (string or number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, scheduler_.Release(key));
+}
+
+Napi::Value RelaySchedulerWrap::ThresholdFor(const Napi::CallbackInfo &info)
+{
+  return Napi::Number::New(info.Env(), scheduler_.ThresholdFor(RssiArg(info, 0)));
+}
+
+Napi::Value RelaySchedulerWrap::Stats(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  ghostmesh::mesh::RelayStats stats = scheduler_.Stats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("pending", Napi::Number::New(env, static_cast<double>(stats.pending)));
+  obj.Set("scheduled", Napi::Number::New(env, static_cast<double>(stats.scheduled)));
+  obj.Set("relayed", Napi::Number::New(env, static_cast<double>(stats.relayed)));
+  obj.Set("suppressed", Napi::Number::New(env, static_cast<double>(stats.suppressed)));
+  obj.Set("overflowed", Napi::Number::New(env, static_cast<double>(stats.overflowed)));
+  return obj;
+}
@@ -0,0 +1,81 @@
+#ifndef NATIVE_BLE_RELAY_SCHEDULER_WRAP_H
+#define NATIVE_BLE_RELAY_SCHEDULER_WRAP_H
+
+#include <napi.h>
+
+#include "relay_scheduler.h"
+
+/**
+ * @file relay_scheduler_wrap.h
+ * @brief N-API binding for the relay suppression engine
+ */
+
+/**
+ * @class RelaySchedulerWrap
+ * @brief JS-visible `RelayScheduler` backed by ghostmesh::mesh::RelayScheduler
+ *
+ * Message IDs may be strings (hashed) or integer keys, as for MessageIdSet.
+ */
+class RelaySchedulerWrap : public Napi::ObjectWrap<RelaySchedulerWrap>
+{
+public:
+  /**
+   * @brief Register the `RelayScheduler` class on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  /**
+   * @brief Construct a RelayScheduler
+   * @param info [0]: optional { minBackoffMs, maxBackoffMs, minThreshold, maxThreshold,
+   *             strongRssi, weakRssi, capacity, seed }
+   */
+  RelaySchedulerWrap(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Read RelayScheduler options; missing or non-numeric fields keep their defaults
+   */
+  static ghostmesh::mesh::RelayConfig ConfigFromObject(const Napi::Object &options);
+
+private:
+  /**
+   * @brief Schedule the relay of a newly heard message
+   * @param info [0]: id (string | number), [1]: rssi in dBm, [2]: optional nowMs
+   * @return Backoff in ms before calling release()
+   */
+  Napi::Value Schedule(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Count an overheard duplicate
+   * @param info [0]: id (string | number)
+   * @return true if it cancelled the relay
+   */
+  Napi::Value Overheard(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief The backoff elapsed
+   * @param info [0]: id (string | number)
+   * @return true to transmit, false if the relay was suppressed
+   */
+  Napi::Value Release(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Duplicates needed to cancel a relay first heard at an RSSI
+   * @param info [0]: rssi in dBm
+   * @return number
+   */
+  Napi::Value ThresholdFor(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Counters
+   * @param info N-API callback info
+   * @return { pending, scheduled, relayed, suppressed, overflowed }
+   */
+  Napi::Value Stats(const Napi::CallbackInfo &info);
+
+  ghostmesh::mesh::RelayScheduler scheduler_;
+};
+
+#endif // NATIVE_BLE_RELAY_SCHEDULER_WRAP_H
@@ -0,0 +1,184 @@
+/**
+ * @file scan_duty_cycle.cc
+ * @brief Implementation of scan duty cycling
+ */
+
+#include "scan_duty_cycle.h"
+
+#include <algorithm>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      constexpr uint32_t kDefaultFixedRatio = 10;     // 10% duty cycle
+      constexpr uint32_t kDefaultMinRatio = 2;        // 50%
+      constexpr uint32_t kDefaultMaxRatio = 16;       // ~6%
+      constexpr uint32_t kMaxIntervalMs = 3600000;    // One window an hour at the least
+
+      uint32_t Scaled(uint32_t windowMs, uint32_t ratio)
+      {
+        return static_cast<uint32_t>(std::min<uint64_t>(uint64_t(windowMs) * ratio, kMaxIntervalMs));
+      }
+    } // namespace
+
+    ScanDutyConfig NormalizeScanDutyConfig(ScanDutyConfig config)
+    {
+      if (config.windowMs == 0)
+        return ScanDutyConfig();
+      config.windowMs = std::min(config.windowMs, kMaxIntervalMs);
+
+      if (!config.adaptive)
+      {
+        if (config.intervalMs == 0)
+          config.intervalMs = Scaled(config.windowMs, kDefaultFixedRatio);
+        config.intervalMs = std::min(std::max(config.intervalMs, config.windowMs), kMaxIntervalMs);
+        config.minIntervalMs = config.maxIntervalMs = config.intervalMs;
+        return config;
+      }
+
+      if (config.minIntervalMs == 0)
+        config.minIntervalMs = config.intervalMs != 0 ? std::min(config.intervalMs, Scaled(config.windowMs, kDefaultMinRatio))
+                                                      : Scaled(config.windowMs, kDefaultMinRatio);
+      config.minIntervalMs = std::min(std::max(config.minIntervalMs, config.windowMs), kMaxIntervalMs);
+      if (config.maxIntervalMs == 0)
+        config.maxIntervalMs = std::max(config.intervalMs, Scaled(config.windowMs, kDefaultMaxRatio));
+      config.maxIntervalMs = std::min(std::max(config.maxIntervalMs, config.minIntervalMs), kMaxIntervalMs);
+      if (config.intervalMs == 0)
+        config.intervalMs = config.minIntervalMs;
+      config.intervalMs = std::min(std::max(config.intervalMs, config.minIntervalMs), config.maxIntervalMs);
+      return config;
+    }
+
+    ScanDutyPolicy::ScanDutyPolicy(const ScanDutyConfig &config)
+        : config_(NormalizeScanDutyConfig(config)), intervalMs_(config_.intervalMs)
+    {
+    }
+
+    uint32_t ScanDutyPolicy::Update(bool active)
+    {
+      if (!config_.adaptive)
+        return intervalMs_;
+      if (active)
+        intervalMs_ = config_.minIntervalMs;
+      else
+        intervalMs_ = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(intervalMs_) * 2, config_.maxIntervalMs));
+      return intervalMs_;
+    }
+
+    ScanDutyCycler::ScanDutyCycler(Sink sink)
+        : sink_(std::move(sink)), running_(false), listening_(false), exiting_(false)
+    {
+    }
+
+    ScanDutyCycler::~ScanDutyCycler()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exiting_ = true;
+      }
+      wake_.notify_one();
+      if (thread_.joinable())
+        thread_.join();
+    }
+
+    void ScanDutyCycler::Start(const ScanDutyConfig &config)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_ = ScanDutyPolicy(config);
+        running_ = true;
+        listening_ = false;
+        nextOpen_ = Clock::now();
+        closedAt_ = Clock::time_point();
+        if (!thread_.joinable())
+          thread_ = std::thread(&ScanDutyCycler::Run, this);
+      }
+      wake_.notify_one();
+    }
+
+    void ScanDutyCycler::Stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        listening_ = false;
+      }
+      wake_.notify_one();
+    }
+
+    void ScanDutyCycler::ReportActivity(bool active)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_.Update(active);
+        if (!running_ || listening_)
+          return;
+        nextOpen_ = openedAt_ + std::chrono::milliseconds(policy_.IntervalMs());
+      }
+      wake_.notify_one();
+    }
+
+    uint32_t ScanDutyCycler::IntervalMs() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return policy_.IntervalMs();
+    }
+
+    // Timer thread: alternate between the open and closed edges of each cycle
+    void ScanDutyCycler::Run()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!exiting_)
+      {
+        if (!running_)
+        {
+          wake_.wait(lock, [this]
+                     { return exiting_ || running_; });
+          continue;
+        }
+
+        const Clock::time_point edge = listening_ ? closeAt_ : nextOpen_;
+        const Clock::time_point now = Clock::now();
+        if (now < edge)
+        {
+          // Re-check on any wake-up (stop, restart, activity, exit)
+          wake_.wait_until(lock, edge);
+          continue;
+        }
+
+        ScanWindowEvent event;
+        event.lateUs = static_cast<uint32_t>(
+            std::min<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - edge).count(), UINT32_MAX));
+        if (listening_)
+        {
+          event.kind = ScanWindowEvent::Kind::Closed;
+          event.gapMs = 0;
+          listening_ = false;
+          closedAt_ = now;
+          // Skip whole cycles missed in a stall rather than opening back to back
+          nextOpen_ = std::max(openedAt_ + std::chrono::milliseconds(policy_.IntervalMs()), now);
+        }
+        else
+        {
+          event.kind = ScanWindowEvent::Kind::Opened;
+          event.gapMs = closedAt_ == Clock::time_point()
+                            ? 0
+                            : static_cast<uint32_t>(
+                                  std::chrono::duration_cast<std::chrono::milliseconds>(now - closedAt_).count());
+          listening_ = true;
+          openedAt_ = now;
+          closeAt_ = now + std::chrono::milliseconds(policy_.WindowMs());
+        }
+
+        lock.unlock();
+        sink_(event);
+        lock.lock();
+      }
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
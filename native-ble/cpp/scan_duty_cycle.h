@@ -0,0 +1,163 @@
+#ifndef NATIVE_BLE_SCAN_DUTY_CYCLE_H
+#define NATIVE_BLE_SCAN_DUTY_CYCLE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file scan_duty_cycle.h
+ * @brief Scan window / interval policy and the timer that gates the radio with it
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @struct ScanDutyConfig
+     * @brief How long to listen per cycle, and how the cycle length moves
+     */
+    struct ScanDutyConfig
+    {
+      uint32_t windowMs;      ///< Listening time per cycle; 0 scans continuously
+      uint32_t intervalMs;    ///< Cycle length (window plus gap); where an adaptive cycle starts
+      bool adaptive;          ///< Shorten the cycle on activity, lengthen it while idle
+      uint32_t minIntervalMs; ///< Adaptive: cycle after a window with activity
+      uint32_t maxIntervalMs; ///< Adaptive: longest idle cycle
+
+      ScanDutyConfig()
+          : windowMs(0), intervalMs(0), adaptive(false), minIntervalMs(0), maxIntervalMs(0) {}
+
+      /**
+       * @brief True when the radio never needs to stop listening
+       */
+      bool Continuous() const { return windowMs == 0 || (!adaptive && intervalMs <= windowMs); }
+    };
+
+    /**
+     * @brief Fill in defaults and order the bounds: window <= min <= interval <= max
+     *
+     * An adaptive cycle without bounds ranges from twice the window to 16
+     * times it; a fixed one without an interval listens 10% of the time.
+     */
+    ScanDutyConfig NormalizeScanDutyConfig(ScanDutyConfig config);
+
+    /**
+     * @class ScanDutyPolicy
+     * @brief The cycle length, as it adapts to activity
+     *
+     * A window that saw activity drops the cycle straight to minIntervalMs, so
+     * a busy mesh is heard at the highest duty cycle allowed; every idle window
+     * doubles it up to maxIntervalMs. A fixed policy keeps intervalMs.
+     */
+    class ScanDutyPolicy
+    {
+    public:
+      explicit ScanDutyPolicy(const ScanDutyConfig &config = ScanDutyConfig());
+
+      const ScanDutyConfig &Config() const { return config_; }
+      uint32_t WindowMs() const { return config_.windowMs; }
+      uint32_t IntervalMs() const { return intervalMs_; }
+
+      /**
+       * @brief Fold in the outcome of the window that just closed
+       * @return Length of the next cycle in ms
+       */
+      uint32_t Update(bool active);
+
+    private:
+      ScanDutyConfig config_;
+      uint32_t intervalMs_;
+    };
+
+    /**
+     * @struct ScanWindowEvent
+     * @brief Output of the duty cycle timer
+     */
+    struct ScanWindowEvent
+    {
+      enum class Kind
+      {
+        Opened, ///< Start listening
+        Closed  ///< Stop listening; report the window's activity with ReportActivity()
+      };
+
+      Kind kind;
+      uint32_t gapMs;  ///< Opened: time since the previous window closed (0 for the first)
+      uint32_t lateUs; ///< How far the timer ran behind the nominal edge
+    };
+
+    /**
+     * @class ScanDutyCycler
+     * @brief Opens and closes scan windows on its own thread
+     *
+     * The first window opens as soon as Start() is called. Each later window
+     * opens one cycle after the previous one opened, where the cycle is the
+     * policy's interval at the time. ReportActivity() can shorten the gap
+     * that is already running. Events are sent to the sink on the timer
+     * thread, outside the lock. A stall skips windows instead of bunching them.
+     */
+    class ScanDutyCycler
+    {
+    public:
+      using Sink = std::function<void(const ScanWindowEvent &event)>;
+
+      explicit ScanDutyCycler(Sink sink);
+
+      /**
+       * @brief Stops and joins the timer thread
+       */
+      ~ScanDutyCycler();
+
+      ScanDutyCycler(const ScanDutyCycler &) = delete;
+      ScanDutyCycler &operator=(const ScanDutyCycler &) = delete;
+
+      /**
+       * @brief Start cycling with a normalized, non-continuous config (restarts if running)
+       */
+      void Start(const ScanDutyConfig &config);
+
+      /**
+       * @brief Stop cycling; an open window ends without a Closed event
+       */
+      void Stop();
+
+      /**
+       * @brief Outcome of the last closed window; moves the next opening if it is still ahead
+       */
+      void ReportActivity(bool active);
+
+      /**
+       * @brief Current cycle length in ms
+       */
+      uint32_t IntervalMs() const;
+
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      void Run();
+
+      Sink sink_;
+      ScanDutyPolicy policy_;
+      Clock::time_point openedAt_;
+      Clock::time_point closeAt_;
+      Clock::time_point closedAt_;
+      Clock::time_point nextOpen_;
+
+      mutable std::mutex mutex_;
+      std::condition_variable wake_;
+      std::thread thread_;
+      bool running_;
+      bool listening_;
+      bool exiting_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_SCAN_DUTY_CYCLE_H
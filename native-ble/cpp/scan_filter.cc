@@ -0,0 +1,195 @@
+/**
+ * @file scan_filter.cc
+ * @brief Implementation of native scan filtering
+ */
+
+#include "scan_filter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
+#include "dedup_cache.h"
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    namespace
+    {
+      constexpr uint64_t kBaseUuidHi = 0x0000000000001000ull; ///< xxxxxxxx-0000-1000
+      constexpr uint64_t kBaseUuidLo = 0x800000805F9B34FBull; ///< 8000-00805F9B34FB
+      constexpr uint64_t kOpaqueUuidHi = 0xFFFFFFFFFFFFFFFFull; ///< Marks a hashed non-UUID string
+
+      // AD structure types (Bluetooth Core Supplement, Part A)
+      constexpr uint8_t kAdIncomplete16 = 0x02;
+      constexpr uint8_t kAdComplete16 = 0x03;
+      constexpr uint8_t kAdIncomplete32 = 0x04;
+      constexpr uint8_t kAdComplete32 = 0x05;
+      constexpr uint8_t kAdIncomplete128 = 0x06;
+      constexpr uint8_t kAdComplete128 = 0x07;
+      constexpr uint8_t kAdManufacturer = 0xFF;
+
+      inline int HexValue(char c)
+      {
+        if (c >= '0' && c <= '9')
+          return c - '0';
+        if (c >= 'a' && c <= 'f')
+          return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+          return c - 'A' + 10;
+        return -1;
+      }
+
+      inline uint64_t ReadLE(const uint8_t *p, size_t n)
+      {
+        uint64_t v = 0;
+        for (size_t i = n; i-- > 0;)
+          v = (v << 8) | p[i];
+        return v;
+      }
+    } // namespace
+
+    Uuid128 ShortUuid(uint32_t value)
+    {
+      return Uuid128{(static_cast<uint64_t>(value) << 32) | kBaseUuidHi, kBaseUuidLo};
+    }
+
+    Uuid128 ParseUuid(const std::string &uuid)
+    {
+      // Single pass, no allocation: shift hex digits through a 128-bit register
+      // while hashing the normalized text in case it turns out not to be a UUID
+      uint64_t hi = 0;
+      uint64_t lo = 0;
+      uint64_t hash = HashBytes64(nullptr, 0);
+      size_t count = 0;
+      bool hex = true;
+      for (char c : uuid)
+      {
+        if (c == '-')
+          continue;
+        char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        hash = HashBytes64(&lower, 1, hash);
+        int value = HexValue(c);
+        hex = hex && value >= 0;
+        if (hex)
+        {
+          hi = (hi << 4) | (lo >> 60);
+          lo = (lo << 4) | static_cast<uint64_t>(value);
+        }
+        ++count;
+      }
+
+      if (hex && (count == 4 || count == 8))
+        return ShortUuid(static_cast<uint32_t>(lo));
+      if (hex && count == 32)
+        return Uuid128{hi, lo};
+      return Uuid128{kOpaqueUuidHi, hash};
+    }
+
+    ScanFilter::ScanFilter() : rules_(std::make_shared<const Rules>(Rules{0, {}}))
+    {
+    }
+
+    void ScanFilter::Configure(uint16_t companyId, const std::vector<std::string> &serviceUUIDs)
+    {
+      auto rules = std::make_shared<Rules>();
+      rules->companyId = companyId;
+      rules->services.reserve(serviceUUIDs.size());
+      for (const auto &uuid : serviceUUIDs)
+      {
+        rules->services.push_back(ParseUuid(uuid));
+      }
+      std::sort(rules->services.begin(), rules->services.end());
+      rules->services.erase(std::unique(rules->services.begin(), rules->services.end()), rules->services.end());
+
+      std::atomic_store(&rules_, std::shared_ptr<const Rules>(std::move(rules)));
+    }
+
+    bool ScanFilter::Active() const
+    {
+      std::shared_ptr<const Rules> rules = std::atomic_load(&rules_);
+      return rules->companyId != 0 || !rules->services.empty();
+    }
+
+    uint16_t ScanFilter::CompanyId() const
+    {
+      return std::atomic_load(&rules_)->companyId;
+    }
+
+    bool ScanFilter::MatchesCompany(const Rules &rules, const uint8_t *data, size_t length)
+    {
+      if (rules.companyId == 0)
+        return true;
+      return data != nullptr && length >= 2 && static_cast<uint16_t>(data[0] | (data[1] << 8)) == rules.companyId;
+    }
+
+    bool ScanFilter::HasService(const Rules &rules, const Uuid128 &uuid)
+    {
+      return std::binary_search(rules.services.begin(), rules.services.end(), uuid);
+    }
+
+    bool ScanFilter::Matches(const uint8_t *manufacturerData, size_t length,
+                             const std::vector<std::string> &serviceUUIDs) const
+    {
+      std::shared_ptr<const Rules> rules = std::atomic_load(&rules_);
+      if (!MatchesCompany(*rules, manufacturerData, length))
+        return false;
+      if (rules->services.empty())
+        return true;
+
+      for (const auto &uuid : serviceUUIDs)
+      {
+        if (HasService(*rules, ParseUuid(uuid)))
+          return true;
+      }
+      return false;
+    }
+
+    bool ScanFilter::MatchesAdvertisement(const uint8_t *adv, size_t length) const
+    {
+      std::shared_ptr<const Rules> rules = std::atomic_load(&rules_);
+      bool companyOk = rules->companyId == 0;
+      bool serviceOk = rules->services.empty();
+
+      size_t pos = 0;
+      while (pos < length && !(companyOk && serviceOk))
+      {
+        size_t fieldLength = adv[pos];
+        if (fieldLength == 0 || pos + 1 + fieldLength > length)
+          break;
+        uint8_t type = adv[pos + 1];
+        const uint8_t *field = adv + pos + 2;
+        size_t dataLength = fieldLength - 1;
+
+        switch (type)
+        {
+        case kAdManufacturer:
+          companyOk = companyOk || MatchesCompany(*rules, field, dataLength);
+          break;
+        case kAdIncomplete16:
+        case kAdComplete16:
+          for (size_t i = 0; !serviceOk && i + 2 <= dataLength; i += 2)
+            serviceOk = HasService(*rules, ShortUuid(static_cast<uint32_t>(ReadLE(field + i, 2))));
+          break;
+        case kAdIncomplete32:
+        case kAdComplete32:
+          for (size_t i = 0; !serviceOk && i + 4 <= dataLength; i += 4)
+            serviceOk = HasService(*rules, ShortUuid(static_cast<uint32_t>(ReadLE(field + i, 4))));
+          break;
+        case kAdIncomplete128:
+        case kAdComplete128:
+          for (size_t i = 0; !serviceOk && i + 16 <= dataLength; i += 16)
+            serviceOk = HasService(*rules, Uuid128{ReadLE(field + i + 8, 8), ReadLE(field + i, 8)});
+          break;
+        default:
+          break;
+        }
+        pos += 1 + fieldLength;
+      }
+      return companyOk && serviceOk;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
@@ -0,0 +1,114 @@
+#ifndef NATIVE_BLE_SCAN_FILTER_H
+#define NATIVE_BLE_SCAN_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file scan_filter.h
+ * @brief Native ScanOptions::filterByManufacturer / filterByService matching
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @struct Uuid128
+     * @brief Service UUID in canonical 128-bit form
+     */
+    struct Uuid128
+    {
+      uint64_t hi;
+      uint64_t lo;
+
+      bool operator==(const Uuid128 &other) const { return hi == other.hi && lo == other.lo; }
+      bool operator<(const Uuid128 &other) const { return hi < other.hi || (hi == other.hi && lo < other.lo); }
+    };
+
+    /**
+     * @brief Parse a service UUID string
+     *
+     * Accepts 16-bit ("1234"), 32-bit and 128-bit forms, with or without
+     * dashes, in any case; short forms are expanded onto the Bluetooth base
+     * UUID. Anything else is reduced to a hash of its normalized text, so
+     * non-standard identifiers still compare equal to themselves.
+     */
+    Uuid128 ParseUuid(const std::string &uuid);
+
+    /**
+     * @brief Expand a 16- or 32-bit UUID onto the Bluetooth base UUID
+     */
+    Uuid128 ShortUuid(uint32_t value);
+
+    /**
+     * @class ScanFilter
+     * @brief Rejects advertisements that do not match the scan's filters
+     *
+     * The company ID is compared first since it is a two-byte check on data
+     * every report carries; the service UUID set is only consulted for reports
+     * that pass it. UUIDs are parsed once in Configure() and kept sorted, so a
+     * report costs a handful of integer comparisons and no allocation.
+     *
+     * Configure() runs on the JS thread; Matches*() may run on platform
+     * threads concurrently. Each Configure() publishes a new immutable rule set.
+     */
+    class ScanFilter
+    {
+    public:
+      ScanFilter();
+
+      /**
+       * @brief Apply the scan options
+       * @param companyId Required company ID (0 = any)
+       * @param serviceUUIDs Accepted service UUIDs (empty = any)
+       */
+      void Configure(uint16_t companyId, const std::vector<std::string> &serviceUUIDs);
+
+      /**
+       * @brief Match a decoded platform report
+       * @param manufacturerData Manufacturer data (company ID first, little-endian)
+       * @param length Manufacturer data length
+       * @param serviceUUIDs Advertised service UUIDs
+       */
+      bool Matches(const uint8_t *manufacturerData, size_t length,
+                   const std::vector<std::string> &serviceUUIDs) const;
+
+      /**
+       * @brief Match raw advertising data (a sequence of AD structures)
+       * @param adv Advertising or scan response payload
+       * @param length Payload length
+       */
+      bool MatchesAdvertisement(const uint8_t *adv, size_t length) const;
+
+      /**
+       * @brief Whether any filter is active
+       */
+      bool Active() const;
+
+      /**
+       * @brief Configured company ID (0 = any)
+       */
+      uint16_t CompanyId() const;
+
+    private:
+      struct Rules
+      {
+        uint16_t companyId;
+        std::vector<Uuid128> services; ///< Sorted
+      };
+
+      static bool MatchesCompany(const Rules &rules, const uint8_t *data, size_t length);
+      static bool HasService(const Rules &rules, const Uuid128 &uuid);
+
+      std::shared_ptr<const Rules> rules_;
+    };
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_SCAN_FILTER_H
@@ -0,0 +1,82 @@
+/**
+ * @file seen_digest.cc
+ * @brief Implementation of the recently-seen Bloom digest
+ */
+
+#include "seen_digest.h"
+
+#include <algorithm>
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    // splitmix64 finalizer, then h1 + index * h2 (h2 odd)
+    size_t SeenDigestBit(uint64_t key, size_t index)
+    {
+      uint64_t z = key;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      z ^= z >> 31;
+      const uint64_t h1 = z & 0xFFFFFFFFu;
+      const uint64_t h2 = (z >> 32) | 1;
+      return static_cast<size_t>((h1 + index * h2) % kSeenDigestBits);
+    }
+
+    SeenDigest::SeenDigest(size_t recentKeys) : keys_(std::max<size_t>(1, recentKeys)), next_(0), size_(0), bits_()
+    {
+    }
+
+    // Linear scan: the ring is a few dozen keys at most
+    bool SeenDigest::Add(uint64_t key)
+    {
+      if (std::find(keys_.begin(), keys_.begin() + size_, key) != keys_.begin() + size_)
+        return false;
+
+      const bool evicting = size_ == keys_.size();
+      keys_[next_] = key;
+      next_ = (next_ + 1) % keys_.size();
+      if (!evicting)
+      {
+        ++size_;
+        Set(bits_, key);
+        return true;
+      }
+
+      // The oldest key's bits cannot be cleared on their own; rebuild from the ring
+      bits_.fill(0);
+      for (uint64_t recent : keys_)
+        Set(bits_, recent);
+      return true;
+    }
+
+    void SeenDigest::Clear()
+    {
+      next_ = 0;
+      size_ = 0;
+      bits_.fill(0);
+    }
+
+    bool SeenDigest::Contains(const uint8_t *digest, uint64_t key)
+    {
+      for (size_t i = 0; i < kSeenDigestHashes; ++i)
+      {
+        size_t bit = SeenDigestBit(key, i);
+        if ((digest[bit >> 3] & (1u << (bit & 7))) == 0)
+          return false;
+      }
+      return true;
+    }
+
+    void SeenDigest::Set(std::array<uint8_t, kSeenDigestBytes> &bits, uint64_t key)
+    {
+      for (size_t i = 0; i < kSeenDigestHashes; ++i)
+      {
+        size_t bit = SeenDigestBit(key, i);
+        bits[bit >> 3] = static_cast<uint8_t>(bits[bit >> 3] | (1u << (bit & 7)));
+      }
+    }
+
+  } // namespace mesh
+} // namespace ghostmesh
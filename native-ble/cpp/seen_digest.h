@@ -0,0 +1,94 @@
+#ifndef NATIVE_BLE_SEEN_DIGEST_H
+#define NATIVE_BLE_SEEN_DIGEST_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file seen_digest.h
+ * @brief Bloom-filter digest of the messages a node has seen recently
+ *
+ * Native counterpart of the TypeScript fallback in src/seen-digest.ts; both
+ * must set the same bits, since nodes with and without the addon read each
+ * other's digests.
+ */
+
+namespace ghostmesh
+{
+  namespace mesh
+  {
+
+    constexpr size_t kSeenDigestBytes = 23; ///< Fits the DIGEST manufacturer-data frame
+    constexpr size_t kSeenDigestBits = kSeenDigestBytes * 8;
+    constexpr size_t kSeenDigestHashes = 4;
+    constexpr size_t kSeenDigestDefaultKeys = 16; ///< About 1% false positives when full
+
+    /**
+     * @brief Bit `index` (0..kSeenDigestHashes-1) that `key` sets in a digest
+     *
+     * Double hashing over a splitmix64 finalizer of the key, so keys that
+     * differ in a few low bits (timestamps) spread over the whole filter.
+     */
+    size_t SeenDigestBit(uint64_t key, size_t index);
+
+    /**
+     * @class SeenDigest
+     * @brief The newest message keys a node holds, as a fixed 184-bit Bloom filter
+     *
+     * Keys are the 64-bit message IDs carried on air (bytes 2-9 of a
+     * manufacturer-data message frame), the one ID every node agrees on. The
+     * digest covers only the last `recentKeys` distinct keys added: a Bloom
+     * filter cannot forget, so it is rebuilt from the ring of recent keys
+     * whenever the oldest one falls off. Relay decisions only concern
+     * messages heard in the last few hundred milliseconds, so a short memory
+     * keeps the false-positive rate low without costing coverage.
+     * Not synchronized: the mesh layer drives it from the JS thread.
+     */
+    class SeenDigest
+    {
+    public:
+      /**
+       * @param recentKeys Keys covered by the digest (at least 1)
+       */
+      explicit SeenDigest(size_t recentKeys = kSeenDigestDefaultKeys);
+
+      /**
+       * @brief Record a message key
+       * @return false if it is already one of the recent keys
+       */
+      bool Add(uint64_t key);
+
+      /**
+       * @brief Recent keys covered by the digest
+       */
+      size_t Size() const { return size_; }
+
+      /**
+       * @brief The digest as it goes on air (kSeenDigestBytes bytes)
+       */
+      const std::array<uint8_t, kSeenDigestBytes> &Bits() const { return bits_; }
+
+      void Clear();
+
+      /**
+       * @brief Whether a digest (ours or a peer's) may hold `key`
+       * @param digest kSeenDigestBytes bytes
+       * @return false if it certainly does not; true if it does or, rarely, by collision
+       */
+      static bool Contains(const uint8_t *digest, uint64_t key);
+
+    private:
+      static void Set(std::array<uint8_t, kSeenDigestBytes> &bits, uint64_t key);
+
+      std::vector<uint64_t> keys_; ///< Ring of the newest keys, oldest at next_ once full
+      size_t next_;
+      size_t size_;
+      std::array<uint8_t, kSeenDigestBytes> bits_;
+    };
+
+  } // namespace mesh
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_SEEN_DIGEST_H
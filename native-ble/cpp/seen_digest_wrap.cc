@@ -0,0 +1,98 @@
+/**
+ * @file seen_digest_wrap.cc
+ * @brief N-API binding for the recently-seen Bloom digest
+ */
+
+#include "seen_digest_wrap.h"
+
+#include <cmath>
+
+namespace
+{
+  // 64-bit key from a bigint or a non-negative integer number
+  bool KeyArg(const Napi::CallbackInfo &info, size_t index, uint64_t &key)
+  {
+    if (info.Length() <= index)
+      return false;
+    if (info[index].IsBigInt())
+    {
+      bool lossless;
+      key = info[index].As<Napi::BigInt>().Uint64Value(&lossless);
+      return lossless;
+    }
+    if (info[index].IsNumber())
+    {
+      double value = info[index].As<Napi::Number>().DoubleValue();
+      if (!(value >= 0 && value <= 9007199254740991.0 && std::floor(value) == value))
+        return false;
+      key = static_cast<uint64_t>(value);
+      return true;
+    }
+    return false;
+  }
+} // namespace
+
+Napi::Object SeenDigestWrap::Init(Napi::Env env, Napi::Object exports)
+{
+  Napi::Function func = DefineClass(env, "SeenDigest",
+                                    {
+                                        InstanceMethod("add", &SeenDigestWrap::Add),
+                                        InstanceMethod("bits", &SeenDigestWrap::Bits),
+                                        InstanceMethod("size", &SeenDigestWrap::Size),
+                                        InstanceMethod("clear", &SeenDigestWrap::Clear),
+                                        StaticMethod("contains", &SeenDigestWrap::Contains),
+                                    });
+  exports.Set("SeenDigest", func);
+  return exports;
+}
+
+SeenDigestWrap::SeenDigestWrap(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<SeenDigestWrap>(info),
+      digest_(info.Length() > 0 && info[0].IsNumber() && info[0].As<Napi::Number>().DoubleValue() >= 1
+                  ? static_cast<size_t>(info[0].As<Napi::Number>().Uint32Value())
+                  : ghostmesh::mesh::kSeenDigestDefaultKeys)
+{
+}
+
+Napi::Value SeenDigestWrap::Add(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (!KeyArg(info, 0, key))
+  {
+    Napi::TypeError::New(env, "Expected message key (bigint or non-negative integer)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, digest_.Add(key));
+}
+
+Napi::Value SeenDigestWrap::Bits(const Napi::CallbackInfo &info)
+{
+  const auto &bits = digest_.Bits();
+  return Napi::Buffer<uint8_t>::Copy(info.Env(), bits.data(), bits.size());
+}
+
+Napi::Value SeenDigestWrap::Size(const Napi::CallbackInfo &info)
+{
+  return Napi::Number::New(info.Env(), static_cast<double>(digest_.Size()));
+}
+
+Napi::Value SeenDigestWrap::Clear(const Napi::CallbackInfo &info)
+{
+  digest_.Clear();
+  return info.Env().Undefined();
+}
+
+Napi::Value SeenDigestWrap::Contains(const Napi::CallbackInfo &info)
+{
+  Napi::Env env = info.Env();
+  uint64_t key;
+  if (info.Length() < 1 || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array ||
+      info[0].As<Napi::Uint8Array>().ElementLength() < ghostmesh::mesh::kSeenDigestBytes || !KeyArg(info, 1, key))
+  {
+    Napi::TypeError::New(env, "Expected a 23-byte digest and a message key").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, ghostmesh::mesh::SeenDigest::Contains(info[0].As<Napi::Uint8Array>().Data(), key));
+}
@@ -0,0 +1,76 @@
+#ifndef NATIVE_BLE_SEEN_DIGEST_WRAP_H
+#define NATIVE_BLE_SEEN_DIGEST_WRAP_H
+
+#include <napi.h>
+
+#include "seen_digest.h"
+
+/**
+ * @file seen_digest_wrap.h
+ * @brief N-API binding for the recently-seen Bloom digest
+ */
+
+/**
+ * @class SeenDigestWrap
+ * @brief JS-visible `SeenDigest` backed by ghostmesh::mesh::SeenDigest
+ *
+ * Keys are the 64-bit on-air message IDs, as bigints or non-negative
+ * integer numbers.
+ */
+class SeenDigestWrap : public Napi::ObjectWrap<SeenDigestWrap>
+{
+public:
+  /**
+   * @brief Register the `SeenDigest` class on the exports object
+   * @param env N-API environment
+   * @param exports N-API exports object
+   * @return N-API exports object
+   */
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+  /**
+   * @brief Construct a SeenDigest
+   * @param info [0]: optional number of recent keys covered (default 16)
+   */
+  SeenDigestWrap(const Napi::CallbackInfo &info);
+
+private:
+  /**
+   * @brief Record a message key
+   * @param info [0]: key (bigint | number)
+   * @return false if it is already one of the recent keys
+   */
+  Napi::Value Add(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief The digest as it goes on air
+   * @param info N-API callback info
+   * @return 23-byte Buffer (a copy)
+   */
+  Napi::Value Bits(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Recent keys covered
+   * @param info N-API callback info
+   * @return Number of keys
+   */
+  Napi::Value Size(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Forget every key
+   * @param info N-API callback info
+   * @return undefined
+   */
+  Napi::Value Clear(const Napi::CallbackInfo &info);
+
+  /**
+   * @brief Whether a digest may hold a key
+   * @param info [0]: 23-byte Uint8Array, [1]: key (bigint | number)
+   * @return false if the digest certainly does not hold it
+   */
+  static Napi::Value Contains(const Napi::CallbackInfo &info);
+
+  ghostmesh::mesh::SeenDigest digest_;
+};
+
+#endif // NATIVE_BLE_SEEN_DIGEST_WRAP_H
@@ -0,0 +1,112 @@
+/**
+ * @file trace_ring.cc
+ * @brief Implementation of the lock-free trace ring
+ */
+
+#include "trace_ring.h"
+
+#include <chrono>
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    TraceRing &TraceRing::Instance()
+    {
+      static TraceRing ring;
+      return ring;
+    }
+
+    TraceRing::TraceRing() : head_(0), tail_(0), lost_(0)
+    {
+      for (auto &slot : slots_)
+      {
+        slot.sequence.store(0, std::memory_order_relaxed);
+        slot.timestampNs.store(0, std::memory_order_relaxed);
+        slot.arg.store(0, std::memory_order_relaxed);
+        slot.header.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    void TraceRing::Record(TraceLevel level, TraceEvent event, uint32_t source, uint64_t arg)
+    {
+      uint64_t timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       std::chrono::steady_clock::now().time_since_epoch())
+                                                       .count());
+      uint64_t pos = head_.fetch_add(1, std::memory_order_relaxed);
+      Slot &slot = slots_[pos & kMask];
+
+      // Seqlock write: mark busy, fill, publish. A writer that was lapped while
+      // preempted must not roll the sequence back over a newer record.
+      uint64_t busy = 2 * pos + 1;
+      uint64_t current = slot.sequence.load(std::memory_order_relaxed);
+      do
+      {
+        // Drain() counts the skipped position as lost
+        if (current >= busy)
+          return;
+      } while (!slot.sequence.compare_exchange_weak(current, busy, std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_release);
+      slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+      slot.arg.store(arg, std::memory_order_relaxed);
+      slot.header.store(static_cast<uint64_t>(source) | (static_cast<uint64_t>(event) << 32) |
+                            (static_cast<uint64_t>(level) << 48),
+                        std::memory_order_relaxed);
+      slot.sequence.compare_exchange_strong(busy, busy + 1, std::memory_order_release, std::memory_order_relaxed);
+    }
+
+    size_t TraceRing::Drain(TraceRecord *out, size_t max)
+    {
+      std::lock_guard<std::mutex> lock(drainMutex_);
+      uint64_t head = head_.load(std::memory_order_acquire);
+      if (head - tail_ > kCapacity)
+      {
+        lost_.fetch_add(head - kCapacity - tail_, std::memory_order_relaxed);
+        tail_ = head - kCapacity;
+      }
+
+      size_t count = 0;
+      while (tail_ < head && count < max)
+      {
+        const Slot &slot = slots_[tail_ & kMask];
+        uint64_t expected = 2 * tail_ + 2;
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before < expected)
+        {
+          // Claimed but not yet published; pick it up on the next drain
+          break;
+        }
+
+        TraceRecord record;
+        record.timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+        record.arg = slot.arg.load(std::memory_order_relaxed);
+        uint64_t header = slot.header.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+        ++tail_;
+
+        if (before != expected || after != expected)
+        {
+          // A writer lapped the reader on this slot
+          lost_.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        record.source = static_cast<uint32_t>(header);
+        record.event = static_cast<uint16_t>(header >> 32);
+        record.level = static_cast<uint8_t>(header >> 48);
+        record.reserved = 0;
+        out[count++] = record;
+      }
+      return count;
+    }
+
+    size_t TraceRing::Pending() const
+    {
+      std::lock_guard<std::mutex> lock(drainMutex_);
+      uint64_t pending = head_.load(std::memory_order_acquire) - tail_;
+      return static_cast<size_t>(pending < kCapacity ? pending : kCapacity);
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
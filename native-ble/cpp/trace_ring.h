@@ -0,0 +1,168 @@
+#ifndef NATIVE_BLE_TRACE_RING_H
+#define NATIVE_BLE_TRACE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @file trace_ring.h
+ * @brief Lock-free in-memory trace of adapter activity
+ *
+ * Replaces console logging on hot paths. Records are fixed-size and binary;
+ * JS collects them with `drainTrace()` and decodes them with TraceLog.
+ *
+ * The level is fixed at compile time with GHOSTMESH_TRACE_LEVEL (see
+ * TraceLevel); trace points above it compile to nothing.
+ */
+
+#ifndef GHOSTMESH_TRACE_LEVEL
+#define GHOSTMESH_TRACE_LEVEL 2
+#endif
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @enum TraceLevel
+     * @brief Verbosity of a trace point; 0 disables tracing entirely
+     */
+    enum class TraceLevel : uint8_t
+    {
+      Error = 1, ///< Failures surfaced to JS
+      Info = 2,  ///< Lifecycle: start/stop, listeners, destroy
+      Debug = 3  ///< Per-advertisement: discoveries, drops, emits
+    };
+
+    /**
+     * @enum TraceEvent
+     * @brief Record type; values are part of the drainTrace() format (see src/trace.ts)
+     */
+    enum class TraceEvent : uint16_t
+    {
+      ListenerAdded = 1,         ///< arg: AdapterEvent << 32 | listener count
+      EventEmitted = 2,          ///< arg: AdapterEvent << 32 | listener count
+      StateQueried = 3,          ///< arg: State
+      Destroyed = 4,             ///< arg: 0
+      AdvertisingStarted = 5,    ///< arg: 0
+      AdvertisingStopped = 6,    ///< arg: 0
+      ScanningStarted = 7,       ///< arg: 0
+      ScanningStopped = 8,       ///< arg: 0
+      DeviceDiscovered = 9,      ///< arg: manufacturer data length
+      FilterRejected = 10,       ///< arg: manufacturer data length
+      DuplicateDropped = 11,     ///< arg: filter's suppressed count
+      AdvertisementRotated = 12, ///< arg: scheduled payload ID
+      Error = 13                 ///< arg: caller-defined code
+    };
+
+    /**
+     * @struct TraceRecord
+     * @brief One 24-byte trace entry, little-endian as laid out in memory
+     *
+     * | Offset | Size | Field                           |
+     * |--------|------|---------------------------------|
+     * | 0      | 8    | timestampNs (steady clock)      |
+     * | 8      | 8    | arg                             |
+     * | 16     | 4    | source (HashAddress of adapter) |
+     * | 20     | 2    | event (TraceEvent)              |
+     * | 22     | 1    | level (TraceLevel)              |
+     * | 23     | 1    | reserved                        |
+     */
+    struct TraceRecord
+    {
+      uint64_t timestampNs;
+      uint64_t arg;
+      uint32_t source;
+      uint16_t event;
+      uint8_t level;
+      uint8_t reserved;
+    };
+
+    static_assert(sizeof(TraceRecord) == 24, "TraceRecord layout is shared with src/trace.ts");
+
+    /**
+     * @class TraceRing
+     * @brief Fixed-size multi-producer ring that overwrites its oldest records
+     *
+     * Writers claim a slot with one fetch_add and publish it through a
+     * per-slot sequence number (a seqlock), so Record() never blocks or
+     * allocates and costs a clock read, a CAS and a few relaxed stores.
+     * Drain() runs on JS threads, serialized by a mutex since every worker's
+     * addon instance shares the ring; records overwritten before a drain
+     * gets to them are counted rather than returned torn.
+     */
+    class TraceRing
+    {
+    public:
+      static constexpr size_t kCapacity = 4096; ///< Power of two
+
+      /**
+       * @brief Process-wide ring, shared by the addon instances of every environment
+       */
+      static TraceRing &Instance();
+
+      TraceRing();
+
+      TraceRing(const TraceRing &) = delete;
+      TraceRing &operator=(const TraceRing &) = delete;
+
+      /**
+       * @brief Append a record (any thread)
+       */
+      void Record(TraceLevel level, TraceEvent event, uint32_t source, uint64_t arg);
+
+      /**
+       * @brief Copy out every record written since the last drain, oldest first
+       * @param out Destination for up to `max` records
+       * @param max Capacity of `out`
+       * @return Number of records copied
+       */
+      size_t Drain(TraceRecord *out, size_t max);
+
+      /**
+       * @brief Upper bound on the records the next Drain() can return
+       */
+      size_t Pending() const;
+
+      /**
+       * @brief Records overwritten before they were drained
+       */
+      uint64_t LostCount() const { return lost_.load(std::memory_order_relaxed); }
+
+    private:
+      static constexpr uint64_t kMask = kCapacity - 1;
+
+      struct Slot
+      {
+        std::atomic<uint64_t> sequence; ///< 2 * pos + 1 while writing, 2 * pos + 2 once published
+        std::atomic<uint64_t> timestampNs;
+        std::atomic<uint64_t> arg;
+        std::atomic<uint64_t> header; ///< source | event << 32 | level << 48
+      };
+
+      Slot slots_[kCapacity];
+      std::atomic<uint64_t> head_;
+      uint64_t tail_; ///< Under drainMutex_
+      std::atomic<uint64_t> lost_;
+      mutable std::mutex drainMutex_;
+    };
+
+    /**
+     * @brief Record a trace point if `Level` is compiled in
+     */
+    template <TraceLevel Level>
+    inline void Trace(TraceEvent event, uint32_t source, uint64_t arg = 0)
+    {
+      if constexpr (static_cast<int>(Level) <= GHOSTMESH_TRACE_LEVEL)
+      {
+        TraceRing::Instance().Record(Level, event, source, arg);
+      }
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_TRACE_RING_H
@@ -0,0 +1,62 @@
+#ifndef NATIVE_BLE_WRAP_ARGS_H
+#define NATIVE_BLE_WRAP_ARGS_H
+
+#include <napi.h>
+
+#include <chrono>
+#include <string>
+
+#include "dedup_cache.h"
+
+/**
+ * @file wrap_args.h
+ * @brief Argument parsing shared by the wraps that take message IDs
+ *
+ * MessageIdSet and RelayScheduler must map a JS message ID onto the same key
+ * so both can be fed the same IDs; keeping the mapping here keeps them in step.
+ */
+
+namespace ghostmesh
+{
+  namespace ble
+  {
+
+    /**
+     * @brief Optional `nowMs` argument, defaulting to Date.now() semantics
+     * @param index Argument position
+     */
+    inline uint64_t NowArg(const Napi::CallbackInfo &info, size_t index)
+    {
+      if (info.Length() > index && info[index].IsNumber())
+        return static_cast<uint64_t>(info[index].As<Napi::Number>().Int64Value());
+      return static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+              .count());
+    }
+
+    /**
+     * @brief Map the first argument, a string (hashed) or integer message ID, onto a key
+     * @return False if the argument is missing or of another type
+     */
+    inline bool KeyArg(const Napi::CallbackInfo &info, uint64_t &key)
+    {
+      if (info.Length() < 1)
+        return false;
+      if (info[0].IsString())
+      {
+        std::string id = info[0].As<Napi::String>().Utf8Value();
+        key = HashBytes64(id.data(), id.size());
+        return true;
+      }
+      if (info[0].IsNumber())
+      {
+        key = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+        return true;
+      }
+      return false;
+    }
+
+  } // namespace ble
+} // namespace ghostmesh
+
+#endif // NATIVE_BLE_WRAP_ARGS_H
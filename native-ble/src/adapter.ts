@@ -9,16 +9,191 @@ import {
   AdvertisingOptions,
   ScanOptions,
   DiscoveredDevice,
+  MeshMessage,
+  PeerInfo,
   BLEAdapterEvents,
+  ScheduledAdvertisementOptions,
+  ScheduledAdvertisementResult,
+  AdvertisingSetOptions,
+  AdvertisingCapabilities,
+  LEGACY_ADVERTISING_CAPABILITIES,
+  BLEAdapterOptions,
 } from './types';
 import { parseManufacturerData } from './manufacturer';
-import { parseMeshPacket } from './mesh';
+import { parseMeshPacket, decodeMeshHeaders, type MeshAssemblerStats, type MeshHeaderColumns } from './mesh';
+import { TraceLog } from './trace';
+import { loadAddon } from './addon';
+import { LinkQualitySnapshot } from './link-quality';
+import { AdapterStatsSnapshot } from './stats';
+
+/**
+ * Byte stride of one record in a packed `devicesDiscovered` buffer
+ * Must match PackedDiscoveryRecord in cpp/discovery_batch.h
+ */
+export const DISCOVERY_RECORD_STRIDE = 48;
+
+/**
+ * Maximum manufacturer data bytes carried per packed record
+ */
+export const DISCOVERY_RECORD_DATA_MAX = 31;
+
+const RECORD_RSSI_OFFSET = 4;
+const RECORD_LENGTH_OFFSET = 6;
+const RECORD_TIMESTAMP_OFFSET = 8;
+const RECORD_DATA_OFFSET = 16;
+
+// Longest scan window or interval (kMaxIntervalMs in cpp/scan_duty_cycle.cc)
+const MAX_SCAN_INTERVAL_MS = 3600000;
+
+// Shortest coexistence cycle (twice kMinRadioSlotMs in cpp/coexistence_arbiter.h)
+const MIN_COEXISTENCE_CYCLE_MS = 40;
+
+/**
+ * Typed, allocation-free view over a packed `devicesDiscovered` buffer
+ *
+ * Each record holds an address hash, RSSI, timestamp and up to 31 bytes of
+ * manufacturer data. Accessors read straight from the underlying ArrayBuffer,
+ * so iterating a batch does not create an object per device.
+ *
+ * @example
+ * ```typescript
+ * ble.on('devicesDiscovered', (batch) => {
+ *   for (let i = 0; i < batch.count; i++) {
+ *     if (batch.companyId(i) === 0xFFFF) handle(batch.addressHash(i), batch.rssi(i));
+ *   }
+ * });
+ * ```
+ */
+export class DiscoveryBatch {
+  /**
+   * Number of records in the batch
+   */
+  readonly count: number;
+
+  /**
+   * Underlying packed records
+   */
+  readonly buffer: ArrayBufferLike;
+
+  /**
+   * Byte offset of the first record in `buffer`
+   */
+  readonly byteOffset: number;
+
+  private readonly view: DataView;
+
+  /**
+   * @param buffer Packed records; a SharedArrayBuffer when read from a discovery ring
+   * @param count Number of records
+   * @param byteOffset Where the first record starts
+   */
+  constructor(buffer: ArrayBufferLike, count: number, byteOffset = 0) {
+    this.buffer = buffer;
+    this.byteOffset = byteOffset;
+    this.view = new DataView(buffer, byteOffset);
+    this.count = Math.min(count, Math.floor(this.view.byteLength / DISCOVERY_RECORD_STRIDE));
+  }
+
+  /**
+   * 32-bit FNV-1a hash of the advertiser address
+   */
+  addressHash(index: number): number {
+    return this.view.getUint32(this.offset(index), true);
+  }
+
+  /**
+   * Signal strength in dBm
+   */
+  rssi(index: number): number {
+    return this.view.getInt16(this.offset(index) + RECORD_RSSI_OFFSET, true);
+  }
+
+  /**
+   * Discovery timestamp (milliseconds since epoch)
+   */
+  timestamp(index: number): number {
+    return this.view.getFloat64(this.offset(index) + RECORD_TIMESTAMP_OFFSET, true);
+  }
+
+  /**
+   * Length of the manufacturer data in bytes (0 if none)
+   */
+  manufacturerDataLength(index: number): number {
+    return this.view.getUint8(this.offset(index) + RECORD_LENGTH_OFFSET);
+  }
+
+  /**
+   * Company ID from the first two manufacturer data bytes, or -1 if absent
+   */
+  companyId(index: number): number {
+    if (this.manufacturerDataLength(index) < 2) return -1;
+    return this.view.getUint16(this.offset(index) + RECORD_DATA_OFFSET, true);
+  }
+
+  /**
+   * Manufacturer data as a Buffer view (no copy) over the batch
+   */
+  manufacturerData(index: number): Buffer {
+    const start = this.byteOffset + this.offset(index) + RECORD_DATA_OFFSET;
+    return Buffer.from(this.buffer, start, this.manufacturerDataLength(index));
+  }
+
+  /**
+   * GhostMesh headers of every record, decoded in one pass
+   * Records with less than MESH_HEADER_SIZE bytes of manufacturer data decode
+   * to whatever is left in their slot; check manufacturerDataLength() first.
+   * @param companyId With dstId, marks the records addressed to a node
+   * @param dstId
+   */
+  meshHeaders(companyId?: number, dstId?: number): MeshHeaderColumns {
+    const records = new Uint8Array(this.buffer, this.byteOffset, this.count * DISCOVERY_RECORD_STRIDE);
+    return decodeMeshHeaders(records, {
+      stride: DISCOVERY_RECORD_STRIDE,
+      offset: RECORD_DATA_OFFSET,
+      count: this.count,
+      companyId,
+      dstId,
+    });
+  }
+
+  private offset(index: number): number {
+    if (index < 0 || index >= this.count) {
+      throw new RangeError(`Record index ${index} out of range (count ${this.count})`);
+    }
+    return index * DISCOVERY_RECORD_STRIDE;
+  }
+}
+
+/**
+ * Convert a native rejection into a BLEError
+ *
+ * The addon rejects with an Error whose `code` is a BLEErrorCode.
+ */
+function toBLEError(err: unknown): BLEError {
+  if (err instanceof BLEError) return err;
+  const code = typeof (err as any)?.code === 'string' ? (err as any).code : 'OPERATION_FAILED';
+  const message = err instanceof Error ? err.message : String(err);
+  return new BLEError(code, message, err);
+}
+
+/**
+ * Tell an injected native adapter from addon options
+ */
+function isNativeAdapter(value: IBLEAdapterNative | BLEAdapterOptions | undefined): value is IBLEAdapterNative {
+  return typeof (value as IBLEAdapterNative | undefined)?.on === 'function';
+}
 
 /**
  * TypeScript interface for the native BLE adapter
  * This will be implemented by the native addon
+ *
+ * Radio operations return promises that settle when the platform reports completion.
  */
 export interface IBLEAdapterNative extends EventEmitter {
+  /**
+   * Settles once the backend is initialized (see BLEAdapterOptions.lazyInit)
+   */
+  ready?: Promise<void>;
   getState(): Promise<BLEState>;
   startAdvertising(options: AdvertisingOptions): Promise<void>;
   updateAdvertisingData(data: Buffer): Promise<void>;
@@ -26,6 +201,21 @@ export interface IBLEAdapterNative extends EventEmitter {
   startScanning(options: ScanOptions): Promise<void>;
   stopScanning(): Promise<void>;
   destroy(): Promise<void>;
+  scheduleAdvertisement?(data: Buffer, options: ScheduledAdvertisementOptions): number;
+  cancelAdvertisement?(id: number): boolean;
+  clearAdvertisements?(): void;
+  drainTrace?(): ArrayBuffer;
+  createAdvertisingSet?(options: AdvertisingSetOptions): number;
+  updateAdvertisingSet?(id: number, data: Buffer): void;
+  removeAdvertisingSet?(id: number): boolean;
+  getCapabilities?(): AdvertisingCapabilities;
+  getPlatformName?(): string;
+  getLinkQuality?(): ArrayBuffer;
+  getPeers?(): PeerInfo[];
+  getMeshStats?(): MeshAssemblerStats | null;
+  getStats?(): Float64Array;
+  attachDiscoveryRing?(view: Int32Array): void;
+  detachDiscoveryRing?(): void;
 }
 
 /**
@@ -53,32 +243,62 @@ export class BLEAdapter extends EventEmitter {
   private _isAdvertising = false;
   private _isScanning = false;
   private _currentState: BLEState = 'unknown';
+  private initialization: Promise<unknown> | null;
+
+  /**
+   * Resolves with the adapter state once the radio backend is initialized
+   *
+   * Immediate unless the adapter was created with `lazyInit`, in which case
+   * startAdvertising() and startScanning() wait for it themselves; the other
+   * radio calls fail with INVALID_STATE until it resolves. It never rejects:
+   * a backend that failed to come up shows in the state (e.g. 'unauthorized')
+   * and an `error` event.
+   */
+  readonly ready: Promise<BLEState>;
 
   /**
    * Create a new BLE adapter instance
-   * @param nativeAdapter Optional native adapter (for testing with mocks)
+   * @param nativeOrOptions Native adapter (for testing with mocks), or options for the native addon
    */
-  constructor(nativeAdapter?: IBLEAdapterNative) {
+  constructor(nativeOrOptions?: IBLEAdapterNative | BLEAdapterOptions) {
     super();
 
-    if (nativeAdapter) {
-      this.nativeAdapter = nativeAdapter;
+    if (isNativeAdapter(nativeOrOptions)) {
+      this.nativeAdapter = nativeOrOptions;
     } else {
-      // Load native addon (will be implemented later)
-      try {
-        const addon = require('../cpp/build/Release/ble_addon.node');
-        this.nativeAdapter = new addon.BLEAdapter();
-      } catch (err) {
+      const cycleMs = nativeOrOptions?.coexistenceCycleMs;
+      if (cycleMs !== undefined &&
+          (typeof cycleMs !== 'number' || !Number.isInteger(cycleMs) || cycleMs < MIN_COEXISTENCE_CYCLE_MS)) {
         throw new BLEError(
-          'OPERATION_FAILED',
-          'Failed to load native BLE addon. Ensure the module is built correctly.',
-          err
+          'INVALID_PARAMETER',
+          `coexistenceCycleMs must be a whole number of at least ${MIN_COEXISTENCE_CYCLE_MS}ms`
         );
       }
+
+      // Prebuilt binary for this platform, or a local build (see addon.ts)
+      const addon = loadAddon();
+      // The addon throws with a `code` when the requested backend cannot be opened
+      try {
+        this.nativeAdapter = new addon.BLEAdapter(nativeOrOptions ?? {});
+      } catch (err) {
+        throw toBLEError(err);
+      }
     }
 
     // Forward events from native adapter
     this.setupEventForwarding();
+
+    // The addon reports the outcome as stateChange before `ready` settles
+    const nativeReady = this.nativeAdapter.ready;
+    this.initialization = nativeReady ?? null;
+    this.ready = nativeReady
+      ? nativeReady.then(() => {
+          this.initialization = null;
+          return this._currentState;
+        })
+      : Promise.resolve().then(() => this.getState());
+    // Awaiting it is optional; a failed getState() on an injected adapter must not go unhandled
+    this.ready.catch(() => undefined);
   }
 
   /**
@@ -111,7 +331,10 @@ export class BLEAdapter extends EventEmitter {
   async startAdvertising(options: AdvertisingOptions): Promise<void> {
     this.validateAdvertisingOptions(options);
 
-    await this.nativeAdapter.startAdvertising(options);
+    if (this.initialization) {
+      await this.initialization;
+    }
+    await this.settle(() => this.nativeAdapter.startAdvertising(options));
     this._isAdvertising = true;
   }
 
@@ -129,17 +352,154 @@ export class BLEAdapter extends EventEmitter {
       throw new BLEError('INVALID_PARAMETER', 'Manufacturer data must be at least 2 bytes');
     }
 
-    await this.nativeAdapter.updateAdvertisingData(data);
+    await this.settle(() => this.nativeAdapter.updateAdvertisingData(data));
   }
 
   /**
    * Stop advertising
    */
   async stopAdvertising(): Promise<void> {
-    await this.nativeAdapter.stopAdvertising();
+    await this.settle(() => this.nativeAdapter.stopAdvertising());
     this._isAdvertising = false;
   }
 
+  /**
+   * Queue a payload for native advertising rotation
+   *
+   * While advertising, the native scheduler swaps queued payloads into the
+   * advertisement every `interval` ms, weighted by priority. Only
+   * `advertisementCompleted` and `advertisementExpired` are reported back.
+   * @param data Manufacturer data (company ID + payload, at most 31 bytes)
+   * @param options Priority, repeat count and TTL
+   * @returns Payload ID for cancelAdvertisement()
+   * @throws {BLEError} If the data or options are invalid, or the queue is full
+   */
+  scheduleAdvertisement(data: Buffer, options: ScheduledAdvertisementOptions = {}): number {
+    if (!Buffer.isBuffer(data)) {
+      throw new BLEError('INVALID_PARAMETER', 'Data must be a Buffer');
+    }
+
+    if (data.length < 2 || data.length > 31) {
+      throw new BLEError('INVALID_PARAMETER', 'Scheduled advertisements must be 2 to 31 bytes');
+    }
+
+    const { priority = 0, repeat = 0, ttlMs = 0 } = options;
+    if (!Number.isInteger(priority) || priority < 0 || priority > 255) {
+      throw new BLEError('INVALID_PARAMETER', 'Priority must be an integer between 0 and 255');
+    }
+
+    if (!Number.isInteger(repeat) || repeat < 0) {
+      throw new BLEError('INVALID_PARAMETER', 'Repeat count must be a non-negative integer');
+    }
+
+    if (typeof ttlMs !== 'number' || ttlMs < 0) {
+      throw new BLEError('INVALID_PARAMETER', 'TTL must be a non-negative number');
+    }
+
+    if (!this.nativeAdapter.scheduleAdvertisement) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support scheduled advertising');
+    }
+
+    try {
+      return this.nativeAdapter.scheduleAdvertisement(data, { priority, repeat, ttlMs });
+    } catch (err) {
+      throw new BLEError('OPERATION_FAILED', 'Failed to schedule advertisement', err);
+    }
+  }
+
+  /**
+   * Remove a queued payload
+   * @param id ID returned by scheduleAdvertisement()
+   * @returns true if the payload was still queued
+   */
+  cancelAdvertisement(id: number): boolean {
+    return this.nativeAdapter.cancelAdvertisement ? this.nativeAdapter.cancelAdvertisement(id) : false;
+  }
+
+  /**
+   * Remove every queued payload
+   */
+  clearAdvertisements(): void {
+    this.nativeAdapter.clearAdvertisements?.();
+  }
+
+  /**
+   * Report what the radio supports
+   *
+   * Adapters that cannot tell report LEGACY_ADVERTISING_CAPABILITIES.
+   * Pass `maxAdvertisingDataSize` to fragmentMessage() to use the fewest
+   * fragments the radio allows.
+   */
+  getCapabilities(): AdvertisingCapabilities {
+    return this.nativeAdapter.getCapabilities?.() ?? { ...LEGACY_ADVERTISING_CAPABILITIES };
+  }
+
+  /**
+   * Name of the radio backend: 'loopback', or the OS backend (e.g. 'BlueZ-HCI')
+   *
+   * Adapters that cannot tell report 'unknown'.
+   */
+  getPlatformName(): string {
+    return this.nativeAdapter.getPlatformName?.() ?? 'unknown';
+  }
+
+  /**
+   * Start an extended advertising set alongside the main advertisement
+   *
+   * Each set carries its own manufacturer data of up to
+   * getCapabilities().maxAdvertisingDataSize bytes, so several long mesh
+   * fragments can be on air at once.
+   * @param options Set payload and service UUIDs
+   * @returns Set ID for updateAdvertisingSet() / removeAdvertisingSet()
+   * @throws {BLEError} If the payload is invalid, sets are unsupported, or none is free
+   */
+  createAdvertisingSet(options: AdvertisingSetOptions): number {
+    this.validateAdvertisingSetData(options?.manufacturerData);
+
+    if (options.serviceUUIDs !== undefined && !Array.isArray(options.serviceUUIDs)) {
+      throw new BLEError('INVALID_PARAMETER', 'Service UUIDs must be an array');
+    }
+
+    if (!this.nativeAdapter.createAdvertisingSet || !this.getCapabilities().supportsMultipleAdvSets) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support advertising sets');
+    }
+
+    try {
+      return this.nativeAdapter.createAdvertisingSet(options);
+    } catch (err) {
+      throw new BLEError('OPERATION_FAILED', 'Failed to create advertising set', err);
+    }
+  }
+
+  /**
+   * Replace an advertising set's manufacturer data
+   * @param id ID returned by createAdvertisingSet()
+   * @param data New manufacturer data (company ID + payload)
+   * @throws {BLEError} If the data is invalid or the set does not exist
+   */
+  updateAdvertisingSet(id: number, data: Buffer): void {
+    this.validateAdvertisingSetData(data);
+
+    if (!this.nativeAdapter.updateAdvertisingSet) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support advertising sets');
+    }
+
+    try {
+      this.nativeAdapter.updateAdvertisingSet(id, data);
+    } catch (err) {
+      throw new BLEError('OPERATION_FAILED', 'Failed to update advertising set', err);
+    }
+  }
+
+  /**
+   * Stop and remove an advertising set
+   * @param id ID returned by createAdvertisingSet()
+   * @returns true if the set existed
+   */
+  removeAdvertisingSet(id: number): boolean {
+    return this.nativeAdapter.removeAdvertisingSet ? this.nativeAdapter.removeAdvertisingSet(id) : false;
+  }
+
   /**
    * Start scanning for BLE devices
    * @param options Scan configuration
@@ -148,7 +508,10 @@ export class BLEAdapter extends EventEmitter {
   async startScanning(options: ScanOptions = {}): Promise<void> {
     this.validateScanOptions(options);
 
-    await this.nativeAdapter.startScanning(options);
+    if (this.initialization) {
+      await this.initialization;
+    }
+    await this.settle(() => this.nativeAdapter.startScanning(options));
     this._isScanning = true;
   }
 
@@ -156,20 +519,131 @@ export class BLEAdapter extends EventEmitter {
    * Stop scanning for devices
    */
   async stopScanning(): Promise<void> {
-    await this.nativeAdapter.stopScanning();
+    await this.settle(() => this.nativeAdapter.stopScanning());
     this._isScanning = false;
   }
 
+  /**
+   * Collect the native trace records written since the last drain
+   *
+   * The trace ring is shared by every adapter in the process; use
+   * TraceLog.source() to tell adapters apart.
+   * @throws {BLEError} If the native adapter has no trace ring
+   */
+  drainTrace(): TraceLog {
+    if (!this.nativeAdapter.drainTrace) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support tracing');
+    }
+    return new TraceLog(this.nativeAdapter.drainTrace());
+  }
+
+  /**
+   * Snapshot per-peer signal statistics
+   *
+   * Only populated while scanning with `trackLinkQuality`; statistics from
+   * earlier scans are kept until the adapter is destroyed.
+   * @throws {BLEError} If the native adapter does not aggregate link quality
+   */
+  getLinkQuality(): LinkQualitySnapshot {
+    if (!this.nativeAdapter.getLinkQuality) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support link-quality tracking');
+    }
+    return new LinkQualitySnapshot(this.nativeAdapter.getLinkQuality());
+  }
+
+  /**
+   * List the peers in range, most recently seen first
+   *
+   * Only populated by scans with `trackPeers`. The native table keeps this
+   * order as reports arrive, so listing does not sort.
+   * @throws {BLEError} If the native adapter does not track peers
+   */
+  getPeers(): PeerInfo[] {
+    if (!this.nativeAdapter.getPeers) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support peer tracking');
+    }
+    return this.nativeAdapter.getPeers();
+  }
+
+  /**
+   * Counters of the native reassembler behind `assembleMesh`
+   * @returns Slots in use, evictions, timeouts and rejected fragments; null
+   *          unless a scan with `assembleMesh` is active
+   * @throws {BLEError} If the native adapter does not reassemble mesh packets
+   */
+  getMeshStats(): MeshAssemblerStats | null {
+    if (!this.nativeAdapter.getMeshStats) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support mesh reassembly');
+    }
+    return this.nativeAdapter.getMeshStats();
+  }
+
+  /**
+   * Snapshot the native hot-path counters and latency histograms
+   *
+   * Cheap enough to poll every second: a copy of a few hundred bytes, with
+   * no locks taken on the paths being counted.
+   * @throws {BLEError} If the native adapter does not keep statistics
+   */
+  getStats(): AdapterStatsSnapshot {
+    if (!this.nativeAdapter.getStats) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support statistics');
+    }
+    return new AdapterStatsSnapshot(this.nativeAdapter.getStats());
+  }
+
+  /**
+   * Also publish `devicesDiscovered` batches into a shared discovery ring
+   *
+   * Workers holding the same SharedArrayBuffer read the records in place
+   * with a DiscoveryRingReader, without a copy or a postMessage per batch.
+   * Only flushed batches are published, so scan with `batchDiscoveries`.
+   * A ring has one writer at a time, across all threads; attaching again
+   * moves this adapter to the new ring.
+   * @param ring Ring laid out by createDiscoveryRing()
+   * @throws {BLEError} If the native adapter cannot publish to a ring
+   */
+  attachDiscoveryRing(ring: SharedArrayBuffer): void {
+    if (!this.nativeAdapter.attachDiscoveryRing) {
+      throw new BLEError('UNSUPPORTED', 'Native adapter does not support discovery rings');
+    }
+    try {
+      this.nativeAdapter.attachDiscoveryRing(new Int32Array(ring));
+    } catch (err) {
+      // TypeError: not a ring; Error: another adapter writes it
+      const code = err instanceof TypeError ? 'INVALID_PARAMETER' : 'INVALID_STATE';
+      throw new BLEError(code, (err as Error).message, err);
+    }
+  }
+
+  /**
+   * Stop publishing to the discovery ring, so another adapter can write it
+   */
+  detachDiscoveryRing(): void {
+    this.nativeAdapter.detachDiscoveryRing?.();
+  }
+
   /**
    * Cleanup and release resources
    */
   async destroy(): Promise<void> {
-    await this.nativeAdapter.destroy();
+    await this.settle(() => this.nativeAdapter.destroy());
     this._isAdvertising = false;
     this._isScanning = false;
     this.removeAllListeners();
   }
 
+  /**
+   * Await a native radio operation, rethrowing failures as BLEError
+   */
+  private async settle(operation: () => Promise<void>): Promise<void> {
+    try {
+      await operation();
+    } catch (err) {
+      throw toBLEError(err);
+    }
+  }
+
   /**
    * Validate advertising options
    */
@@ -210,6 +684,23 @@ export class BLEAdapter extends EventEmitter {
     }
   }
 
+  /**
+   * Validate an advertising set payload against the radio's limit
+   */
+  private validateAdvertisingSetData(data: Buffer | undefined): void {
+    if (!Buffer.isBuffer(data)) {
+      throw new BLEError('INVALID_PARAMETER', 'Manufacturer data must be a Buffer');
+    }
+
+    const max = this.getCapabilities().maxAdvertisingDataSize;
+    if (data.length < 2 || data.length > max) {
+      throw new BLEError(
+        'INVALID_PARAMETER',
+        `Advertising set data must be 2 to ${max} bytes`
+      );
+    }
+  }
+
   /**
    * Validate scan options
    */
@@ -239,6 +730,46 @@ export class BLEAdapter extends EventEmitter {
         );
       }
     }
+
+    if (options.meshCompanyId !== undefined) {
+      if (typeof options.meshCompanyId !== 'number' ||
+          options.meshCompanyId < 0 ||
+          options.meshCompanyId > 0xFFFF) {
+        throw new BLEError(
+          'INVALID_PARAMETER',
+          'Mesh company ID must be a number between 0 and 0xFFFF'
+        );
+      }
+    }
+
+    if (options.batchIntervalMs !== undefined) {
+      if (typeof options.batchIntervalMs !== 'number' ||
+          options.batchIntervalMs < 0 ||
+          options.batchIntervalMs > 10000) {
+        throw new BLEError(
+          'INVALID_PARAMETER',
+          'Batch interval must be between 0ms and 10000ms'
+        );
+      }
+    }
+
+    for (const key of ['scanWindowMs', 'scanIntervalMs', 'minScanIntervalMs', 'maxScanIntervalMs'] as const) {
+      const value = options[key];
+      if (value !== undefined && (typeof value !== 'number' || value < 0 || value > MAX_SCAN_INTERVAL_MS)) {
+        throw new BLEError(
+          'INVALID_PARAMETER',
+          `${key} must be between 0ms and ${MAX_SCAN_INTERVAL_MS}ms`
+        );
+      }
+    }
+
+    if (options.minScanIntervalMs !== undefined && options.maxScanIntervalMs !== undefined &&
+        options.minScanIntervalMs > options.maxScanIntervalMs) {
+      throw new BLEError(
+        'INVALID_PARAMETER',
+        'minScanIntervalMs must not exceed maxScanIntervalMs'
+      );
+    }
   }
 
   /**
@@ -294,6 +825,30 @@ export class BLEAdapter extends EventEmitter {
       this.emit('deviceDiscovered', device);
     });
 
+    this.nativeAdapter.on('devicesDiscovered', (buffer: ArrayBuffer, count: number) => {
+      this.emit('devicesDiscovered', new DiscoveryBatch(buffer, count));
+    });
+
+    this.nativeAdapter.on('meshMessage', (message: MeshMessage) => {
+      this.emit('meshMessage', message);
+    });
+
+    this.nativeAdapter.on('advertisementCompleted', (result: ScheduledAdvertisementResult) => {
+      this.emit('advertisementCompleted', result);
+    });
+
+    this.nativeAdapter.on('advertisementExpired', (result: ScheduledAdvertisementResult) => {
+      this.emit('advertisementExpired', result);
+    });
+
+    this.nativeAdapter.on('peerAdded', (peer: PeerInfo) => {
+      this.emit('peerAdded', peer);
+    });
+
+    this.nativeAdapter.on('peerLost', (peer: PeerInfo) => {
+      this.emit('peerLost', peer);
+    });
+
     this.nativeAdapter.on('error', (error: BLEError) => {
       this.emit('error', error);
     });
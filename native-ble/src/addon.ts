@@ -0,0 +1,89 @@
+/**
+ * Native addon resolution
+ *
+ * The addon is found, in order, at:
+ * 1. `GHOSTMESH_NATIVE_BLE_ADDON`, if set (a full path to a `.node` file)
+ * 2. `prebuilds/<platform>-<arch>/native_ble.node`, shipped with the package
+ * 3. `build/Release/native_ble.node` and `build/Debug/native_ble.node`, from node-gyp
+ *
+ * It is built against N-API version 8, so one prebuilt binary per platform
+ * and architecture serves every supported Node.js release.
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import { BLEError } from './types';
+
+/**
+ * File name of the compiled addon (the `native_ble` target in binding.gyp)
+ */
+export const ADDON_FILE = 'native_ble.node';
+
+// dist/ and src/ both sit directly under the package root
+const PACKAGE_ROOT = path.join(__dirname, '..');
+
+let addon: any;
+
+/**
+ * Directory a prebuilt binary for a platform and architecture is shipped in
+ */
+export function prebuildDirectory(platform: string = process.platform, arch: string = process.arch): string {
+  return path.join(PACKAGE_ROOT, 'prebuilds', `${platform}-${arch}`);
+}
+
+/**
+ * Paths tried by loadAddon(), in order
+ */
+export function addonCandidates(): string[] {
+  const candidates = [
+    path.join(prebuildDirectory(), ADDON_FILE),
+    path.join(PACKAGE_ROOT, 'build', 'Release', ADDON_FILE),
+    path.join(PACKAGE_ROOT, 'build', 'Debug', ADDON_FILE),
+  ];
+  const override = process.env.GHOSTMESH_NATIVE_BLE_ADDON;
+  return override ? [override, ...candidates] : candidates;
+}
+
+/**
+ * Load the addon once per process
+ * A binary that exists but does not load (another platform's build, say) is
+ * skipped for the next candidate.
+ * @throws {BLEError} OPERATION_FAILED listing each path tried and why it failed
+ */
+export function loadAddon(): any {
+  if (addon) {
+    return addon;
+  }
+
+  const failures: string[] = [];
+  for (const candidate of addonCandidates()) {
+    if (!fs.existsSync(candidate)) {
+      failures.push(`${candidate}: not found`);
+      continue;
+    }
+    try {
+      addon = require(candidate);
+      return addon;
+    } catch (err) {
+      failures.push(`${candidate}: ${(err as Error).message}`);
+    }
+  }
+  throw new BLEError(
+    'OPERATION_FAILED',
+    `Failed to load native BLE addon for ${process.platform}-${process.arch}. ` +
+      'Install a prebuilt binary or build it with `npm run build:native`.',
+    failures
+  );
+}
+
+/**
+ * loadAddon(), or null when no candidate loads
+ * For code with a TypeScript fallback.
+ */
+export function tryLoadAddon(): any | null {
+  try {
+    return loadAddon();
+  } catch {
+    return null;
+  }
+}
@@ -0,0 +1,187 @@
+/**
+ * Shared-memory ring of packed discovery records
+ *
+ * Lets worker threads consume the scanner's `devicesDiscovered` batches
+ * without a copy or a message per batch. The ring is a SharedArrayBuffer
+ * made by createDiscoveryRing(); one adapter publishes into it
+ * (BLEAdapter.attachDiscoveryRing()) and any number of DiscoveryRingReaders,
+ * in any worker, read the records in place. Layout (see
+ * cpp/discovery_ring.h):
+ * - 64 byte header of int32 words: magic, version, capacity, stride,
+ *   claimed, published, producer
+ * - `capacity` records of DISCOVERY_RECORD_STRIDE bytes
+ *
+ * The writer never waits for readers. A reader that falls more than a ring
+ * behind skips the overwritten records and counts them in `dropped`.
+ */
+
+import { BLEError } from './types';
+import { DiscoveryBatch, DISCOVERY_RECORD_STRIDE } from './adapter';
+
+/**
+ * Bytes before the first record
+ * Must match kDiscoveryRingHeaderSize in cpp/discovery_ring.h
+ */
+export const DISCOVERY_RING_HEADER_SIZE = 64;
+
+/**
+ * Records in a ring made without an explicit capacity
+ */
+export const DISCOVERY_RING_DEFAULT_CAPACITY = 1024;
+
+// Must match kDiscoveryRingMagic / kDiscoveryRingVersion in cpp/discovery_ring.h
+const RING_MAGIC = 0x52444d47;
+const RING_VERSION = 1;
+
+// Header word indices (DiscoveryRingWord in cpp/discovery_ring.h)
+const WORD_MAGIC = 0;
+const WORD_VERSION = 1;
+const WORD_CAPACITY = 2;
+const WORD_STRIDE = 3;
+const WORD_CLAIMED = 4;
+const WORD_PUBLISHED = 5;
+
+const MAX_RING_CAPACITY = 1 << 20;
+
+/**
+ * Allocate and lay out an empty discovery ring
+ * @param capacity Records the ring holds; a power of two
+ * @throws {BLEError} If capacity is not a power of two between 1 and 2^20
+ */
+export function createDiscoveryRing(capacity = DISCOVERY_RING_DEFAULT_CAPACITY): SharedArrayBuffer {
+  if (!Number.isInteger(capacity) || capacity < 1 || capacity > MAX_RING_CAPACITY || (capacity & (capacity - 1)) !== 0) {
+    throw new BLEError('INVALID_PARAMETER', `Discovery ring capacity must be a power of two up to ${MAX_RING_CAPACITY}`);
+  }
+  const ring = new SharedArrayBuffer(DISCOVERY_RING_HEADER_SIZE + capacity * DISCOVERY_RECORD_STRIDE);
+  const words = new Int32Array(ring, 0, DISCOVERY_RING_HEADER_SIZE / 4);
+  words[WORD_VERSION] = RING_VERSION;
+  words[WORD_CAPACITY] = capacity;
+  words[WORD_STRIDE] = DISCOVERY_RECORD_STRIDE;
+  // Magic last: a ring is only valid once the rest of the header is in place
+  Atomics.store(words, WORD_MAGIC, RING_MAGIC);
+  return ring;
+}
+
+/**
+ * Reads a discovery ring in place, keeping its own cursor
+ *
+ * Records are not copied, so the writer may overwrite them while they are
+ * being read if the reader is a whole ring behind. Check `intact()` after
+ * handling a batch and discard what it produced if that returns false.
+ *
+ * @example
+ * ```typescript
+ * // worker.ts, with `ring` received through workerData
+ * const reader = new DiscoveryRingReader(ring);
+ * for (;;) {
+ *   reader.wait(1000);
+ *   for (let batch = reader.read(); batch; batch = reader.read()) {
+ *     const seen = collect(batch);
+ *     if (reader.intact()) commit(seen);
+ *   }
+ * }
+ * ```
+ */
+export class DiscoveryRingReader {
+  /**
+   * The ring being read
+   */
+  readonly buffer: SharedArrayBuffer;
+
+  /**
+   * Records the ring holds
+   */
+  readonly capacity: number;
+
+  private readonly words: Int32Array;
+  private cursor: number;
+  private batchStart: number;
+  private _dropped = 0;
+
+  /**
+   * @param ring Ring made by createDiscoveryRing(), possibly in another thread
+   * @throws {BLEError} If `ring` is not a discovery ring
+   */
+  constructor(ring: SharedArrayBuffer) {
+    if (ring.byteLength < DISCOVERY_RING_HEADER_SIZE) {
+      throw new BLEError('INVALID_PARAMETER', 'Not a discovery ring (see createDiscoveryRing())');
+    }
+    this.words = new Int32Array(ring, 0, DISCOVERY_RING_HEADER_SIZE / 4);
+    const capacity = this.words[WORD_CAPACITY];
+    if (Atomics.load(this.words, WORD_MAGIC) !== RING_MAGIC || this.words[WORD_VERSION] !== RING_VERSION ||
+        this.words[WORD_STRIDE] !== DISCOVERY_RECORD_STRIDE || capacity < 1 || (capacity & (capacity - 1)) !== 0 ||
+        ring.byteLength < DISCOVERY_RING_HEADER_SIZE + capacity * DISCOVERY_RECORD_STRIDE) {
+      throw new BLEError('INVALID_PARAMETER', 'Not a discovery ring (see createDiscoveryRing())');
+    }
+    this.buffer = ring;
+    this.capacity = capacity;
+    // Start at the live edge; what was published before we arrived is not ours
+    this.cursor = this.published();
+    this.batchStart = this.cursor;
+  }
+
+  /**
+   * Records skipped because the writer lapped this reader
+   */
+  get dropped(): number {
+    return this._dropped;
+  }
+
+  /**
+   * Records published and not yet read
+   */
+  get available(): number {
+    return (this.published() - this.cursor) >>> 0;
+  }
+
+  /**
+   * Next run of unread records as a view over the ring, or null if caught up
+   *
+   * A run stops at the end of the ring, so after a wrap the rest comes
+   * from the next call.
+   */
+  read(): DiscoveryBatch | null {
+    const published = this.published();
+    const behind = (Atomics.load(this.words, WORD_CLAIMED) - this.cursor) >>> 0;
+    if (behind > this.capacity) {
+      const skipped = behind - this.capacity;
+      this._dropped += skipped;
+      this.cursor = (this.cursor + skipped) >>> 0;
+    }
+
+    const unread = (published - this.cursor) >>> 0;
+    if (unread === 0 || unread > this.capacity) return null;
+    const slot = this.cursor & (this.capacity - 1);
+    const count = Math.min(unread, this.capacity - slot);
+    this.batchStart = this.cursor;
+    this.cursor = (this.cursor + count) >>> 0;
+    return new DiscoveryBatch(this.buffer, count, DISCOVERY_RING_HEADER_SIZE + slot * DISCOVERY_RECORD_STRIDE);
+  }
+
+  /**
+   * Whether the batch last returned by read() is still unmodified
+   */
+  intact(): boolean {
+    return ((Atomics.load(this.words, WORD_CLAIMED) - this.batchStart) >>> 0) <= this.capacity;
+  }
+
+  /**
+   * Block the calling thread until there is something to read
+   *
+   * Uses Atomics.wait(), so call it from a worker (or a main thread that may
+   * block), never from one that must stay responsive.
+   * @param timeoutMs Longest wait; waits indefinitely if omitted
+   * @returns Whether unread records are available
+   */
+  wait(timeoutMs?: number): boolean {
+    const seen = this.cursor | 0;
+    if (Atomics.load(this.words, WORD_PUBLISHED) === seen) {
+      Atomics.wait(this.words, WORD_PUBLISHED, seen, timeoutMs);
+    }
+    return this.available > 0;
+  }
+
+  private published(): number {
+    return Atomics.load(this.words, WORD_PUBLISHED) >>> 0;
+  }
+}
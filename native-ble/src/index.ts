@@ -5,17 +5,74 @@
  * without GATT connections or pairing.
  */
 
-export { BLEAdapter } from './adapter';
+export { BLEAdapter, DiscoveryBatch, DISCOVERY_RECORD_STRIDE } from './adapter';
 export type { IBLEAdapterNative } from './adapter';
+export { loadAddon, tryLoadAddon, addonCandidates, prebuildDirectory, ADDON_FILE } from './addon';
+export {
+  DiscoveryRingReader,
+  createDiscoveryRing,
+  DISCOVERY_RING_HEADER_SIZE,
+  DISCOVERY_RING_DEFAULT_CAPACITY,
+} from './discovery-ring';
 export {
   BLEError,
   type BLEState,
   type BLEErrorCode,
+  type BLEBackend,
+  type BLEAdapterOptions,
   type AdvertisingOptions,
   type ScanOptions,
   type DiscoveredDevice,
+  type MeshMessage,
+  type PeerInfo,
   type BLEAdapterEvents,
+  ADVERTISEMENT_PRIORITY,
+  type ScheduledAdvertisementOptions,
+  type ScheduledAdvertisementResult,
+  type AdvertisingSetOptions,
+  type AdvertisingCapabilities,
+  LEGACY_ADVERTISING_CAPABILITIES,
 } from './types';
 
 export { parseManufacturerData } from './manufacturer';
-export { parseMeshPacket, MessageAssembler, type MeshPacket } from './mesh';
+export { TraceLog, TRACE_EVENT, TRACE_LEVEL, TRACE_RECORD_STRIDE } from './trace';
+export {
+  LinkQualitySnapshot,
+  LINK_QUALITY_RECORD_STRIDE,
+  RSSI_HISTOGRAM_BINS,
+  RSSI_HISTOGRAM_FLOOR,
+  RSSI_HISTOGRAM_BIN_WIDTH,
+} from './link-quality';
+export {
+  AdapterStatsSnapshot,
+  STATS_LAYOUT_VERSION,
+  STATS_SNAPSHOT_SIZE,
+  STAT_COUNTER,
+  STAT_HISTOGRAM,
+  STAT_HISTOGRAM_BUCKETS,
+  STAT_HISTOGRAM_STRIDE,
+  ADAPTER_EVENT_NAMES,
+  type LatencySummary,
+  type AdapterStatsSummary,
+} from './stats';
+export {
+  parseMeshPacket,
+  decodeMeshHeaders,
+  decodeMeshHeadersJs,
+  MessageAssembler,
+  fragmentMessage,
+  meshFragmentDataSize,
+  MESH_HEADER_SIZE,
+  MESH_LEGACY_DATA_SIZE,
+  MESH_MAX_DATA_SIZE,
+  MESH_MAX_FRAGMENTS,
+  MESH_LAST_FRAGMENT,
+  MESH_MATCH_COMPANY,
+  MESH_MATCH_DESTINATION,
+  MESH_MATCH_BOTH,
+  type MeshPacket,
+  type MeshHeaderBatchOptions,
+  type MeshHeaderColumns,
+  type MeshMessageHeader,
+  type MeshAssemblerStats,
+} from './mesh';
@@ -0,0 +1,162 @@
+/**
+ * Decoder for native link-quality snapshots
+ *
+ * When a scan is started with `trackLinkQuality`, the addon keeps signal
+ * statistics per advertiser as reports arrive. `getLinkQuality()` copies the
+ * table into one ArrayBuffer of 64-byte records (see PackedLinkQualityRecord
+ * in cpp/link_quality.h), so a dashboard can poll it on a timer instead of
+ * handling every `deviceDiscovered` event:
+ * - 4 bytes LE: address hash (FNV-1a, as in DiscoveryBatch)
+ * - 4 bytes LE: packets received
+ * - 8 bytes LE: last seen (float64, ms epoch)
+ * - 4 bytes LE: EWMA RSSI (float32, dBm)
+ * - 4 bytes LE: packet rate (float32, reports per second)
+ * - 1 byte each: last, min and max RSSI (int8, dBm), 1 reserved
+ * - 16 x 2 bytes LE: RSSI histogram (saturating counts)
+ * - 4 bytes reserved
+ */
+
+/**
+ * Byte stride of one link-quality record
+ * Must match PackedLinkQualityRecord in cpp/link_quality.h
+ */
+export const LINK_QUALITY_RECORD_STRIDE = 64;
+
+/**
+ * RSSI histogram bins per peer
+ */
+export const RSSI_HISTOGRAM_BINS = 16;
+
+/**
+ * Lower edge of histogram bin 0 in dBm; weaker reports are counted in bin 0
+ */
+export const RSSI_HISTOGRAM_FLOOR = -100;
+
+/**
+ * Width of one histogram bin in dBm; the last bin counts everything stronger
+ */
+export const RSSI_HISTOGRAM_BIN_WIDTH = 5;
+
+const RECORD_PACKETS_OFFSET = 4;
+const RECORD_LAST_SEEN_OFFSET = 8;
+const RECORD_EWMA_OFFSET = 16;
+const RECORD_RATE_OFFSET = 20;
+const RECORD_LAST_RSSI_OFFSET = 24;
+const RECORD_MIN_RSSI_OFFSET = 25;
+const RECORD_MAX_RSSI_OFFSET = 26;
+const RECORD_BINS_OFFSET = 28;
+
+/**
+ * Typed, allocation-free view over a link-quality snapshot
+ *
+ * @example
+ * ```typescript
+ * await ble.startScanning({ trackLinkQuality: true });
+ * setInterval(() => {
+ *   const peers = ble.getLinkQuality();
+ *   for (let i = 0; i < peers.count; i++) {
+ *     console.log(peers.addressHash(i), peers.ewmaRssi(i), peers.packetRate(i));
+ *   }
+ * }, 1000);
+ * ```
+ */
+export class LinkQualitySnapshot {
+  /**
+   * Number of peers in the snapshot
+   */
+  readonly count: number;
+
+  /**
+   * Underlying packed records
+   */
+  readonly buffer: ArrayBuffer;
+
+  private readonly view: DataView;
+
+  constructor(buffer: ArrayBuffer) {
+    this.buffer = buffer;
+    this.view = new DataView(buffer);
+    this.count = Math.floor(buffer.byteLength / LINK_QUALITY_RECORD_STRIDE);
+  }
+
+  /**
+   * 32-bit FNV-1a hash of the advertiser address
+   */
+  addressHash(index: number): number {
+    return this.view.getUint32(this.offset(index), true);
+  }
+
+  /**
+   * Reports received from the peer, duplicates included
+   */
+  packets(index: number): number {
+    return this.view.getUint32(this.offset(index) + RECORD_PACKETS_OFFSET, true);
+  }
+
+  /**
+   * Time of the latest report (milliseconds since epoch)
+   */
+  lastSeen(index: number): number {
+    return this.view.getFloat64(this.offset(index) + RECORD_LAST_SEEN_OFFSET, true);
+  }
+
+  /**
+   * Exponentially weighted moving average of the RSSI in dBm
+   */
+  ewmaRssi(index: number): number {
+    return this.view.getFloat32(this.offset(index) + RECORD_EWMA_OFFSET, true);
+  }
+
+  /**
+   * Reports per second over the latest one-second window
+   */
+  packetRate(index: number): number {
+    return this.view.getFloat32(this.offset(index) + RECORD_RATE_OFFSET, true);
+  }
+
+  /**
+   * RSSI of the latest report in dBm
+   */
+  lastRssi(index: number): number {
+    return this.view.getInt8(this.offset(index) + RECORD_LAST_RSSI_OFFSET);
+  }
+
+  /**
+   * Weakest RSSI seen in dBm
+   */
+  minRssi(index: number): number {
+    return this.view.getInt8(this.offset(index) + RECORD_MIN_RSSI_OFFSET);
+  }
+
+  /**
+   * Strongest RSSI seen in dBm
+   */
+  maxRssi(index: number): number {
+    return this.view.getInt8(this.offset(index) + RECORD_MAX_RSSI_OFFSET);
+  }
+
+  /**
+   * Reports counted in one histogram bin
+   * @param bin Bin index; bin b covers [FLOOR + b * WIDTH, FLOOR + (b + 1) * WIDTH) dBm
+   */
+  histogramBin(index: number, bin: number): number {
+    if (bin < 0 || bin >= RSSI_HISTOGRAM_BINS) {
+      throw new RangeError(`Histogram bin ${bin} out of range`);
+    }
+    return this.view.getUint16(this.offset(index) + RECORD_BINS_OFFSET + bin * 2, true);
+  }
+
+  /**
+   * The peer's whole histogram, as a view (no copy) over the snapshot
+   */
+  histogram(index: number): Uint16Array {
+    return new Uint16Array(this.buffer, this.offset(index) + RECORD_BINS_OFFSET, RSSI_HISTOGRAM_BINS);
+  }
+
+  private offset(index: number): number {
+    if (index < 0 || index >= this.count) {
+      throw new RangeError(`Record index ${index} out of range (count ${this.count})`);
+    }
+    return index * LINK_QUALITY_RECORD_STRIDE;
+  }
+}
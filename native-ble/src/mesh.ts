@@ -7,18 +7,71 @@
  *   - DST ID: 5 bytes (LE)
  *   - SRC ID: 5 bytes (LE)
  *   - MSG ID: 2 bytes (LE) -> bits 15-4: messageId (12 bits), bits 3-0: packetNumber (4 bits)
- *   - HOP COUNT: 1 byte
- *   - DATA: 18 bytes
+ *   - HOP COUNT: 1 byte -> bit 7: last fragment, bits 6-0: hop count
+ *   - DATA: 18 bytes (legacy), or up to 236 bytes in an extended advertisement
+ *
+ * The last-fragment flag tells a receiver how many fragments to wait for, so
+ * a stream cut short is never mistaken for a complete message.
+ *
+ * With extended advertising a message needs far fewer fragments: a 288-byte
+ * message takes 16 legacy fragments but 2 extended ones. fragmentMessage()
+ * picks the fragment size from the platform's maxAdvertisingDataSize.
  */
 
+import { tryLoadAddon } from './addon';
+
+/**
+ * Company ID plus the fixed header fields before DATA
+ */
+export const MESH_HEADER_SIZE = 15;
+
+/**
+ * DATA bytes per legacy fragment (and the minimum for any fragment)
+ */
+export const MESH_LEGACY_DATA_SIZE = 18;
+
+/**
+ * DATA bytes per fragment in a 251-byte extended advertisement
+ */
+export const MESH_MAX_DATA_SIZE = 251 - MESH_HEADER_SIZE;
+
+/**
+ * Fragments per message (4-bit packet number)
+ */
+export const MESH_MAX_FRAGMENTS = 16;
+
+/**
+ * HOP COUNT bit set on the final fragment of a message
+ */
+export const MESH_LAST_FRAGMENT = 0x80;
+
+/**
+ * decodeMeshHeaders() match bits: companyId, dstId, and both
+ */
+export const MESH_MATCH_COMPANY = 0x01;
+export const MESH_MATCH_DESTINATION = 0x02;
+export const MESH_MATCH_BOTH = MESH_MATCH_COMPANY | MESH_MATCH_DESTINATION;
+
 export interface MeshPacket {
   companyId: number;
   dstId: number; // 5-byte integer
   srcId: number; // 5-byte integer
   messageId: number; // 12-bit
   packetNumber: number; // 4-bit
-  hopCount: number;
-  data: Buffer; // up to 18 bytes
+  hopCount: number; // 7-bit
+  lastFragment: boolean;
+  data: Buffer; // 18 bytes legacy, up to MESH_MAX_DATA_SIZE extended
+}
+
+/**
+ * Header fields of a message to fragment
+ */
+export interface MeshMessageHeader {
+  companyId: number;
+  dstId: number; // 5-byte integer
+  srcId: number; // 5-byte integer
+  messageId: number; // 12-bit
+  hopCount: number; // 7-bit
 }
 
 export interface AssembledMessage {
@@ -26,18 +79,150 @@ export interface AssembledMessage {
   srcId: number;
   dstId: number;
   packets: Map<number, Buffer>; // packetNumber -> data
-  totalPackets?: number; // unknown unless signalled externally
+  totalPackets?: number; // known once the last fragment has arrived
   assembled?: Buffer;
+  updatedAt: number; // ms of the latest fragment
+}
+
+/**
+ * Reassembly counters, from MessageAssembler.stats() or BLEAdapter.getMeshStats()
+ */
+export interface MeshAssemblerStats {
+  inUse: number; // partial messages held
+  capacity: number;
+  completed: number;
+  evicted: number; // dropped to make room, least recently updated first
+  expired: number; // dropped after timeoutMs without a fragment
+  rejected: number; // fragments numbered past the message's last fragment
+  oversized: number; // fragments longer than the native fragment size (always 0 in JS)
+}
+
+/**
+ * Where decodeMeshHeaders() finds its records, and what to match them against
+ */
+export interface MeshHeaderBatchOptions {
+  stride?: number; // bytes from one record to the next (default 33, one legacy advertisement)
+  offset?: number; // where the first record starts
+  count?: number; // at most this many records
+  companyId?: number; // with dstId, fills `match`
+  dstId?: number;
+}
+
+/**
+ * Header fields of a batch of records, one typed array per field
+ */
+export interface MeshHeaderColumns {
+  count: number;
+  kernel: string; // 'ssse3', 'sse2', 'neon' or 'scalar' in the addon, 'js' in the fallback
+  companyId: Uint16Array;
+  dstId: Float64Array;
+  srcId: Float64Array;
+  messageId: Uint16Array;
+  packetNumber: Uint8Array;
+  hopCount: Uint8Array; // raw byte: MESH_LAST_FRAGMENT plus the hop count
+  match?: Uint8Array; // MESH_MATCH_* bits, when companyId and dstId were given
+  matched?: number; // records matching both
+}
+
+const MESH_DEFAULT_STRIDE = 2 + 31;
+const MESH_MAX_ID = 0xffffffffff;
+
+type MeshHeaderDecoder = (records: Uint8Array, options?: MeshHeaderBatchOptions) => MeshHeaderColumns;
+
+let nativeDecodeMeshHeaders: MeshHeaderDecoder | null | undefined;
+
+/**
+ * Decode the headers of records laid out at a fixed stride
+ * Uses the addon's SIMD kernel when it loads. Only MESH_HEADER_SIZE bytes of
+ * each record are read, so the last one may stop right after its header.
+ * @throws {TypeError} an option is not an integer in range
+ * @throws {RangeError} stride is 0
+ */
+export function decodeMeshHeaders(records: Uint8Array, options: MeshHeaderBatchOptions = {}): MeshHeaderColumns {
+  if (nativeDecodeMeshHeaders === undefined) {
+    nativeDecodeMeshHeaders = tryLoadAddon()?.decodeMeshHeaders ?? null;
+  }
+  return nativeDecodeMeshHeaders ? nativeDecodeMeshHeaders(records, options) : decodeMeshHeadersJs(records, options);
 }
 
-function readUInt40LE(buf: Buffer, offset = 0): number {
+function integerOption(
+  options: MeshHeaderBatchOptions,
+  name: keyof MeshHeaderBatchOptions,
+  max: number
+): number | undefined {
+  const value = options[name];
+  if (value === undefined) return undefined;
+  if (!(typeof value === 'number' && value >= 0 && value <= max && Number.isInteger(value))) {
+    throw new TypeError(`decodeMeshHeaders ${name} must be an integer from 0 to ${max}`);
+  }
+  return value;
+}
+
+/**
+ * TypeScript decodeMeshHeaders(): the same columns as the addon's scalar kernel
+ */
+export function decodeMeshHeadersJs(records: Uint8Array, options: MeshHeaderBatchOptions = {}): MeshHeaderColumns {
+  if (!(records instanceof Uint8Array)) {
+    throw new TypeError('Expected Uint8Array');
+  }
+  const stride = integerOption(options, 'stride', 0xffff) ?? MESH_DEFAULT_STRIDE;
+  const offset = integerOption(options, 'offset', records.length) ?? 0;
+  const limit = integerOption(options, 'count', 0xffffffff);
+  const wantedCompany = integerOption(options, 'companyId', 0xffff);
+  const wantedDst = integerOption(options, 'dstId', MESH_MAX_ID);
+  if (stride === 0) {
+    throw new RangeError('decodeMeshHeaders stride must be positive');
+  }
+
+  // Every record whose header lies inside the view, up to `count`
+  const length = records.length - offset;
+  let count = length < MESH_HEADER_SIZE ? 0 : Math.floor((length - MESH_HEADER_SIZE) / stride) + 1;
+  if (limit !== undefined && limit < count) count = limit;
+
+  const columns: MeshHeaderColumns = {
+    count,
+    kernel: 'js',
+    companyId: new Uint16Array(count),
+    dstId: new Float64Array(count),
+    srcId: new Float64Array(count),
+    messageId: new Uint16Array(count),
+    packetNumber: new Uint8Array(count),
+    hopCount: new Uint8Array(count),
+  };
+  for (let i = 0; i < count; i++) {
+    const p = offset + i * stride;
+    const msgIdRaw = records[p + 12] | (records[p + 13] << 8);
+    columns.companyId[i] = records[p] | (records[p + 1] << 8);
+    columns.dstId[i] = readUInt40LE(records, p + 2);
+    columns.srcId[i] = readUInt40LE(records, p + 7);
+    columns.messageId[i] = (msgIdRaw >> 4) & 0x0fff;
+    columns.packetNumber[i] = msgIdRaw & 0x0f;
+    columns.hopCount[i] = records[p + 14];
+  }
+
+  if (wantedCompany !== undefined && wantedDst !== undefined) {
+    const match = new Uint8Array(count);
+    let matched = 0;
+    for (let i = 0; i < count; i++) {
+      match[i] =
+        (columns.companyId[i] === wantedCompany ? MESH_MATCH_COMPANY : 0) |
+        (columns.dstId[i] === wantedDst ? MESH_MATCH_DESTINATION : 0);
+      if (match[i] === MESH_MATCH_BOTH) matched++;
+    }
+    columns.match = match;
+    columns.matched = matched;
+  }
+  return columns;
+}
+
+function readUInt40LE(buf: Uint8Array, offset = 0): number {
   // Read 5 bytes little-endian into Number (safe up to > 1e12)
   const b0 = buf[offset] || 0;
   const b1 = buf[offset + 1] || 0;
   const b2 = buf[offset + 2] || 0;
   const b3 = buf[offset + 3] || 0;
   const b4 = buf[offset + 4] || 0;
-  return b0 + (b1 << 8) + (b2 << 16) + (b3 << 24) + (b4 * 0x100000000);
+  return b0 + (b1 << 8) + (b2 << 16) + b3 * 0x1000000 + b4 * 0x100000000;
 }
 
 export function parseMeshPacket(manufacturerBuf: Buffer): MeshPacket | null {
@@ -55,8 +240,10 @@ export function parseMeshPacket(manufacturerBuf: Buffer): MeshPacket | null {
   const msgIdRaw = payload.readUInt16LE(10);
   const messageId = (msgIdRaw >> 4) & 0x0fff; // upper 12 bits
   const packetNumber = msgIdRaw & 0x0f; // lower 4 bits
-  const hopCount = payload.readUInt8(12);
-  const data = payload.slice(13, 13 + 18);
+  const hopByte = payload.readUInt8(12);
+  const hopCount = hopByte & ~MESH_LAST_FRAGMENT;
+  const lastFragment = (hopByte & MESH_LAST_FRAGMENT) !== 0;
+  const data = payload.slice(13, 13 + MESH_MAX_DATA_SIZE);
 
   return {
     companyId,
@@ -65,58 +252,172 @@ export function parseMeshPacket(manufacturerBuf: Buffer): MeshPacket | null {
     messageId,
     packetNumber,
     hopCount,
+    lastFragment,
     data,
   };
 }
 
-// Simple assembler that collects packets by key (srcId+messageId)
+function writeUInt40LE(buf: Buffer, value: number, offset: number): void {
+  buf.writeUInt32LE(value % 0x100000000, offset);
+  buf[offset + 4] = Math.floor(value / 0x100000000) & 0xff;
+}
+
+/**
+ * DATA bytes per fragment for a platform's advertising payload limit
+ * @param maxAdvertisingDataSize AdvertisingCapabilities.maxAdvertisingDataSize
+ * @returns 18 for legacy advertising, up to MESH_MAX_DATA_SIZE for extended
+ */
+export function meshFragmentDataSize(maxAdvertisingDataSize: number): number {
+  const size = maxAdvertisingDataSize - MESH_HEADER_SIZE;
+  return Math.max(MESH_LEGACY_DATA_SIZE, Math.min(MESH_MAX_DATA_SIZE, size));
+}
+
+/**
+ * Split a message into GhostMesh manufacturer data fragments
+ *
+ * Every fragment but the last carries meshFragmentDataSize() DATA bytes; the
+ * last is flagged MESH_LAST_FRAGMENT and zero-padded to at least 18 bytes, as
+ * legacy receivers require.
+ * @param header Fields copied into every fragment
+ * @param payload Message body
+ * @param maxAdvertisingDataSize Sender's payload limit; the legacy default gives 18-byte fragments
+ * @returns Manufacturer data per fragment, in packet number order
+ * @throws {RangeError} If the message needs more than 16 fragments
+ */
+export function fragmentMessage(
+  header: MeshMessageHeader,
+  payload: Buffer,
+  maxAdvertisingDataSize = 2 + 31
+): Buffer[] {
+  const fragmentSize = meshFragmentDataSize(maxAdvertisingDataSize);
+  const count = Math.max(1, Math.ceil(payload.length / fragmentSize));
+  if (count > MESH_MAX_FRAGMENTS) {
+    throw new RangeError(
+      `Message of ${payload.length} bytes needs ${count} fragments of ${fragmentSize} bytes (max ${MESH_MAX_FRAGMENTS})`
+    );
+  }
+
+  const fragments: Buffer[] = [];
+  for (let i = 0; i < count; i++) {
+    const chunk = payload.subarray(i * fragmentSize, (i + 1) * fragmentSize);
+    const buf = Buffer.alloc(MESH_HEADER_SIZE + Math.max(MESH_LEGACY_DATA_SIZE, chunk.length));
+    buf.writeUInt16LE(header.companyId, 0);
+    writeUInt40LE(buf, header.dstId, 2);
+    writeUInt40LE(buf, header.srcId, 7);
+    buf.writeUInt16LE(((header.messageId & 0x0fff) << 4) | i, 12);
+    const last = i === count - 1 ? MESH_LAST_FRAGMENT : 0;
+    buf.writeUInt8((header.hopCount & ~MESH_LAST_FRAGMENT) | last, 14);
+    chunk.copy(buf, MESH_HEADER_SIZE);
+    fragments.push(buf);
+  }
+  return fragments;
+}
+
+/**
+ * Reassembles fragments keyed by srcId+messageId in a bounded pool
+ *
+ * A message completes once fragments 0..n have arrived, n being the fragment
+ * flagged MESH_LAST_FRAGMENT. At most `capacity` partial messages are held:
+ * those idle for `timeoutMs` are dropped on every push (or expire()), and
+ * when the pool is full the least recently updated one makes room, so memory
+ * stays bounded under packet loss without calling remove().
+ *
+ * JS fallback for environments without the native addon. On relay nodes prefer
+ * `startScanning({ assembleMesh: true })`, which reassembles in C++ and emits
+ * `meshMessage` only for complete messages, or the addon's `MeshAssembler`
+ * class when manufacturer data arrives from another source.
+ */
 export class MessageAssembler {
+  // Map iteration order doubles as the least-recently-updated list
   private store: Map<string, AssembledMessage> = new Map();
+  private counters = { completed: 0, evicted: 0, expired: 0, rejected: 0 };
+
+  /**
+   * @param capacity Partial messages held at once
+   * @param timeoutMs Idle time after which a partial message is dropped
+   */
+  constructor(
+    readonly capacity = 256,
+    readonly timeoutMs = 30000
+  ) {}
 
   keyFor(srcId: number, messageId: number) {
     return `${srcId}:${messageId}`;
   }
 
-  pushPacket(pkt: MeshPacket): AssembledMessage | null {
+  /**
+   * Add a fragment
+   * @param pkt Parsed fragment
+   * @param now Arrival time in ms
+   * @returns The completed message, already removed from the pool, or null
+   */
+  pushPacket(pkt: MeshPacket, now: number = Date.now()): AssembledMessage | null {
+    this.expire(now);
+
     const key = this.keyFor(pkt.srcId, pkt.messageId);
     let entry = this.store.get(key);
-    if (!entry) {
-      entry = { messageId: pkt.messageId, srcId: pkt.srcId, dstId: pkt.dstId, packets: new Map() };
-      this.store.set(key, entry);
+    if (entry) {
+      this.store.delete(key);
+    } else {
+      if (this.store.size >= this.capacity) {
+        this.store.delete(this.store.keys().next().value as string);
+        this.counters.evicted++;
+      }
+      entry = { messageId: pkt.messageId, srcId: pkt.srcId, dstId: pkt.dstId, packets: new Map(), updatedAt: now };
     }
+    entry.updatedAt = now;
+    this.store.set(key, entry);
 
-    entry.packets.set(pkt.packetNumber, pkt.data);
+    // Fragments past the flagged one, or a second flag, contradict what already arrived
+    const last = entry.totalPackets !== undefined ? entry.totalPackets - 1 : undefined;
+    if (last !== undefined && (pkt.packetNumber > last || (pkt.lastFragment && pkt.packetNumber !== last))) {
+      this.counters.rejected++;
+      return null;
+    }
+    if (pkt.lastFragment) entry.totalPackets = pkt.packetNumber + 1;
 
-    // If packet numbers 0..n are present contiguous from 0 to highest, attempt assembly
-    const numbers = Array.from(entry.packets.keys()).sort((a, b) => a - b);
-    if (numbers.length === 0) return null;
-
-    // Heuristic: if packet 0 exists and we have <=16 packets and they are contiguous from 0 to max
-    if (numbers[0] === 0) {
-      const max = numbers[numbers.length - 1];
-      let contiguous = true;
-      for (let i = 0; i <= max; i++) {
-        if (!entry.packets.has(i)) {
-          contiguous = false;
-          break;
-        }
-      }
+    entry.packets.set(pkt.packetNumber, pkt.data);
+    if (entry.totalPackets === undefined) return null;
 
-      if (contiguous) {
-        // Concatenate
-        const parts: Buffer[] = [];
-        for (let i = 0; i <= max; i++) parts.push(entry.packets.get(i)!);
-        const assembled = Buffer.concat(parts);
-        entry.assembled = assembled;
-        // keep entry for diagnostics; caller may remove it when processed
-        return entry;
-      }
+    const parts: Buffer[] = [];
+    for (let i = 0; i < entry.totalPackets; i++) {
+      const part = entry.packets.get(i);
+      if (!part) return null;
+      parts.push(part);
     }
+    entry.assembled = Buffer.concat(parts);
+    this.store.delete(key);
+    this.counters.completed++;
+    return entry;
+  }
 
-    return null;
+  /**
+   * Drop partial messages idle since before now - timeoutMs
+   * @returns Number dropped
+   */
+  expire(now: number = Date.now()): number {
+    let dropped = 0;
+    for (const [key, entry] of this.store) {
+      if (now < entry.updatedAt + this.timeoutMs) break;
+      this.store.delete(key);
+      dropped++;
+    }
+    this.counters.expired += dropped;
+    return dropped;
   }
 
   remove(srcId: number, messageId: number) {
     this.store.delete(this.keyFor(srcId, messageId));
   }
+
+  /**
+   * Number of messages currently being reassembled
+   */
+  get size(): number {
+    return this.store.size;
+  }
+
+  stats(): MeshAssemblerStats {
+    return { inUse: this.store.size, capacity: this.capacity, oversized: 0, ...this.counters };
+  }
 }
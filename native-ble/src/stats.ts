@@ -0,0 +1,276 @@
+/**
+ * Decoder for native adapter statistics
+ *
+ * Every adapter counts its hot paths with relaxed atomics, each on its own
+ * cache line, and times them into fixed log2 histograms. `getStats()` copies
+ * them into one Float64Array (see cpp/adapter_stats.h):
+ * - [0]: layout version (STATS_LAYOUT_VERSION)
+ * - one value per STAT_COUNTER
+ * - one emit count per ADAPTER_EVENT_NAMES entry
+ * - one block of STAT_HISTOGRAM_STRIDE values per STAT_HISTOGRAM:
+ *   count, sum (us), max (us), then STAT_HISTOGRAM_BUCKETS bucket counts
+ *
+ * Counters only grow; rates come from the difference of two snapshots.
+ */
+
+/**
+ * Layout version this decoder reads
+ * Must match kStatsLayoutVersion in cpp/adapter_stats.h
+ */
+export const STATS_LAYOUT_VERSION = 2;
+
+/**
+ * Counter indices (StatCounter in cpp/adapter_stats.h)
+ */
+export const STAT_COUNTER = {
+  /** Reports that reached the adapter from the radio */
+  ADVERTISEMENTS_RECEIVED: 0,
+  /** Rejected by the manufacturer / service filter */
+  ADVERTISEMENTS_FILTERED: 1,
+  /** Dropped by the duplicate filter */
+  ADVERTISEMENTS_DEDUPED: 2,
+  /** Handed on to reassembly, batching or `deviceDiscovered` */
+  ADVERTISEMENTS_DELIVERED: 3,
+  /** Native emits that had at least one listener */
+  EVENTS_EMITTED: 4,
+  /** JS listener invocations across those emits */
+  LISTENER_CALLS: 5,
+  /** Platform event batches drained on the JS thread */
+  PLATFORM_BATCHES: 6,
+  /** Payload changes: updateAdvertisingData(), updateAdvertisingSet() and rotations */
+  ADVERTISING_UPDATES: 7,
+  /** Payloads put on air by the native scheduler */
+  ADVERTISING_ROTATIONS: 8,
+  /** Listening windows opened by the scan duty cycle (ScanOptions.scanWindowMs) */
+  SCAN_WINDOWS: 9,
+} as const;
+
+/**
+ * Histogram indices (StatHistogram in cpp/adapter_stats.h), all in microseconds
+ */
+export const STAT_HISTOGRAM = {
+  /** One native emit: the N-API calls into every listener, and their JS time */
+  EMIT: 0,
+  /** Queued on a platform thread until delivered on the JS thread */
+  DISPATCH: 1,
+  /** Scheduler tick lateness behind its nominal interval */
+  ROTATION_JITTER: 2,
+  /**
+   * Duty-cycled scans with `trackPeers`: for each new peer, the gap before the
+   * window that first heard it plus how far into that window it was heard.
+   * An upper bound on how long the peer was in range but unheard.
+   */
+  DISCOVERY_LATENCY: 3,
+} as const;
+
+/**
+ * Adapter events in AdapterEvent order (cpp/adapter_events.h), the order of the emit counts
+ */
+export const ADAPTER_EVENT_NAMES = [
+  'stateChange',
+  'advertisingStarted',
+  'advertisingStopped',
+  'advertisingDataUpdated',
+  'scanningStarted',
+  'scanningStopped',
+  'deviceDiscovered',
+  'devicesDiscovered',
+  'meshMessage',
+  'advertisementCompleted',
+  'advertisementExpired',
+  'error',
+  'peerAdded',
+  'peerLost',
+] as const;
+
+/**
+ * Buckets per histogram: bucket 0 counts samples under 1 us, bucket n samples
+ * in [2^(n-1), 2^n) us, and the last bucket everything longer (from about 17 s)
+ */
+export const STAT_HISTOGRAM_BUCKETS = 26;
+
+/**
+ * Values per histogram: count, sum, max, then the buckets
+ */
+export const STAT_HISTOGRAM_STRIDE = 3 + STAT_HISTOGRAM_BUCKETS;
+
+const COUNTER_COUNT = Object.keys(STAT_COUNTER).length;
+const HISTOGRAM_COUNT = Object.keys(STAT_HISTOGRAM).length;
+const EMITS_OFFSET = 1 + COUNTER_COUNT;
+const HISTOGRAMS_OFFSET = EMITS_OFFSET + ADAPTER_EVENT_NAMES.length;
+
+/**
+ * Values in one snapshot
+ * Must match kStatsSnapshotSize in cpp/adapter_stats.h
+ */
+export const STATS_SNAPSHOT_SIZE = HISTOGRAMS_OFFSET + HISTOGRAM_COUNT * STAT_HISTOGRAM_STRIDE;
+
+/**
+ * Summary of one latency histogram, in microseconds
+ */
+export interface LatencySummary {
+  count: number;
+  meanUs: number;
+  p50Us: number;
+  p99Us: number;
+  maxUs: number;
+}
+
+export type StatCounterName = keyof typeof STAT_COUNTER;
+export type StatHistogramName = keyof typeof STAT_HISTOGRAM;
+
+/**
+ * Plain-object form of a snapshot, for logging or sending over a socket
+ */
+export interface AdapterStatsSummary {
+  counters: Record<StatCounterName, number>;
+  emits: Record<string, number>;
+  latency: Record<StatHistogramName, LatencySummary>;
+}
+
+/**
+ * Typed view over a stats snapshot
+ *
+ * @example
+ * ```typescript
+ * const before = ble.getStats();
+ * await sleep(1000);
+ * const after = ble.getStats();
+ * const received = after.counter(STAT_COUNTER.ADVERTISEMENTS_RECEIVED)
+ *   - before.counter(STAT_COUNTER.ADVERTISEMENTS_RECEIVED);
+ * console.log(`${received} reports/s, emit p99 ${after.percentileUs(STAT_HISTOGRAM.EMIT, 0.99)} us`);
+ * ```
+ */
+export class AdapterStatsSnapshot {
+  /**
+   * Underlying packed values
+   */
+  readonly values: Float64Array;
+
+  constructor(values: Float64Array) {
+    if (values.length < STATS_SNAPSHOT_SIZE || values[0] !== STATS_LAYOUT_VERSION) {
+      throw new RangeError(
+        `Unsupported stats layout (version ${values[0]}, ${values.length} values; expected version ${STATS_LAYOUT_VERSION})`
+      );
+    }
+    this.values = values;
+  }
+
+  /**
+   * Value of a monotonic counter
+   * @param index A STAT_COUNTER value
+   */
+  counter(index: number): number {
+    if (index < 0 || index >= COUNTER_COUNT) {
+      throw new RangeError(`Counter ${index} out of range`);
+    }
+    return this.values[1 + index];
+  }
+
+  /**
+   * Native emits of one adapter event that reached at least one listener
+   * @param event An ADAPTER_EVENT_NAMES entry
+   */
+  emits(event: (typeof ADAPTER_EVENT_NAMES)[number]): number {
+    const index = ADAPTER_EVENT_NAMES.indexOf(event);
+    if (index < 0) {
+      throw new RangeError(`Unknown adapter event ${event}`);
+    }
+    return this.values[EMITS_OFFSET + index];
+  }
+
+  /**
+   * Samples recorded in a histogram
+   * @param index A STAT_HISTOGRAM value
+   */
+  histogramCount(index: number): number {
+    return this.values[this.histogramOffset(index)];
+  }
+
+  /**
+   * Mean sample in microseconds, 0 when empty
+   */
+  meanUs(index: number): number {
+    const offset = this.histogramOffset(index);
+    const count = this.values[offset];
+    return count === 0 ? 0 : this.values[offset + 1] / count;
+  }
+
+  /**
+   * Largest sample in microseconds
+   */
+  maxUs(index: number): number {
+    return this.values[this.histogramOffset(index) + 2];
+  }
+
+  /**
+   * Samples counted in one bucket
+   * @param bucket Bucket index; see STAT_HISTOGRAM_BUCKETS
+   */
+  bucket(index: number, bucket: number): number {
+    if (bucket < 0 || bucket >= STAT_HISTOGRAM_BUCKETS) {
+      throw new RangeError(`Histogram bucket ${bucket} out of range`);
+    }
+    return this.values[this.histogramOffset(index) + 3 + bucket];
+  }
+
+  /**
+   * Upper bound of the bucket holding the given quantile, capped at the maximum
+   *
+   * Buckets double in width, so the bound is within 2x of the true value.
+   * @param quantile In [0, 1]
+   */
+  percentileUs(index: number, quantile: number): number {
+    const offset = this.histogramOffset(index);
+    const count = this.values[offset];
+    const max = this.values[offset + 2];
+    if (count === 0) {
+      return 0;
+    }
+    const rank = Math.max(1, Math.ceil(Math.min(Math.max(quantile, 0), 1) * count));
+    let seen = 0;
+    for (let bucket = 0; bucket < STAT_HISTOGRAM_BUCKETS - 1; bucket++) {
+      seen += this.values[offset + 3 + bucket];
+      if (seen >= rank) {
+        return Math.min(2 ** bucket, max);
+      }
+    }
+    return max;
+  }
+
+  /**
+   * Count, mean, p50, p99 and max of one histogram
+   */
+  latency(index: number): LatencySummary {
+    return {
+      count: this.histogramCount(index),
+      meanUs: this.meanUs(index),
+      p50Us: this.percentileUs(index, 0.5),
+      p99Us: this.percentileUs(index, 0.99),
+      maxUs: this.maxUs(index),
+    };
+  }
+
+  toJSON(): AdapterStatsSummary {
+    const counters = {} as Record<StatCounterName, number>;
+    for (const name of Object.keys(STAT_COUNTER) as StatCounterName[]) {
+      counters[name] = this.counter(STAT_COUNTER[name]);
+    }
+    const emits: Record<string, number> = {};
+    for (const event of ADAPTER_EVENT_NAMES) {
+      emits[event] = this.emits(event);
+    }
+    const latency = {} as Record<StatHistogramName, LatencySummary>;
+    for (const name of Object.keys(STAT_HISTOGRAM) as StatHistogramName[]) {
+      latency[name] = this.latency(STAT_HISTOGRAM[name]);
+    }
+    return { counters, emits, latency };
+  }
+
+  private histogramOffset(index: number): number {
+    if (index < 0 || index >= HISTOGRAM_COUNT) {
+      throw new RangeError(`Histogram ${index} out of range`);
+    }
+    return HISTOGRAMS_OFFSET + index * STAT_HISTOGRAM_STRIDE;
+  }
+}
@@ -0,0 +1,141 @@
+/**
+ * Decoder for the native trace ring
+ *
+ * The addon records adapter activity into a fixed-size in-memory ring
+ * instead of logging to the console. `drainTrace()` returns everything
+ * recorded since the previous drain as one ArrayBuffer of 24-byte records
+ * (see TraceRecord in cpp/trace_ring.h):
+ * - 8 bytes LE: timestamp (steady clock, nanoseconds)
+ * - 8 bytes LE: event argument
+ * - 4 bytes LE: source (FNV-1a hash of the adapter id)
+ * - 2 bytes LE: event (TRACE_EVENT)
+ * - 1 byte: level (TRACE_LEVEL)
+ * - 1 byte: reserved
+ */
+
+/**
+ * Byte stride of one trace record
+ * Must match TraceRecord in cpp/trace_ring.h
+ */
+export const TRACE_RECORD_STRIDE = 24;
+
+const RECORD_ARG_OFFSET = 8;
+const RECORD_SOURCE_OFFSET = 16;
+const RECORD_EVENT_OFFSET = 20;
+const RECORD_LEVEL_OFFSET = 22;
+
+/**
+ * Trace levels; the addon only records levels up to GHOSTMESH_TRACE_LEVEL
+ */
+export const TRACE_LEVEL = {
+  ERROR: 1,
+  INFO: 2,
+  DEBUG: 3,
+} as const;
+
+/**
+ * Trace event IDs (TraceEvent in cpp/trace_ring.h)
+ */
+export const TRACE_EVENT = {
+  LISTENER_ADDED: 1,
+  EVENT_EMITTED: 2,
+  STATE_QUERIED: 3,
+  DESTROYED: 4,
+  ADVERTISING_STARTED: 5,
+  ADVERTISING_STOPPED: 6,
+  SCANNING_STARTED: 7,
+  SCANNING_STOPPED: 8,
+  DEVICE_DISCOVERED: 9,
+  FILTER_REJECTED: 10,
+  DUPLICATE_DROPPED: 11,
+  ADVERTISEMENT_ROTATED: 12,
+  ERROR: 13,
+} as const;
+
+const EVENT_NAMES: Record<number, string> = Object.fromEntries(
+  Object.entries(TRACE_EVENT).map(([name, id]) => [id, name])
+);
+
+/**
+ * Typed, allocation-free view over a drained trace buffer
+ *
+ * @example
+ * ```typescript
+ * const trace = ble.drainTrace();
+ * for (let i = 0; i < trace.count; i++) {
+ *   console.log(trace.timestampNs(i), trace.eventName(i), trace.arg(i));
+ * }
+ * ```
+ */
+export class TraceLog {
+  /**
+   * Number of records
+   */
+  readonly count: number;
+
+  /**
+   * Underlying packed records
+   */
+  readonly buffer: ArrayBuffer;
+
+  private readonly view: DataView;
+
+  constructor(buffer: ArrayBuffer) {
+    this.buffer = buffer;
+    this.view = new DataView(buffer);
+    this.count = Math.floor(buffer.byteLength / TRACE_RECORD_STRIDE);
+  }
+
+  /**
+   * Steady-clock timestamp in nanoseconds
+   */
+  timestampNs(index: number): bigint {
+    return this.view.getBigUint64(this.offset(index), true);
+  }
+
+  /**
+   * Event argument (meaning depends on the event, see TraceEvent)
+   *
+   * For LISTENER_ADDED and EVENT_EMITTED the adapter event ID is in the
+   * upper 32 bits and the listener count in the lower 32.
+   */
+  arg(index: number): number {
+    return Number(this.view.getBigUint64(this.offset(index) + RECORD_ARG_OFFSET, true));
+  }
+
+  /**
+   * 32-bit FNV-1a hash of the adapter id that recorded the event
+   */
+  source(index: number): number {
+    return this.view.getUint32(this.offset(index) + RECORD_SOURCE_OFFSET, true);
+  }
+
+  /**
+   * Event ID, one of TRACE_EVENT
+   */
+  event(index: number): number {
+    return this.view.getUint16(this.offset(index) + RECORD_EVENT_OFFSET, true);
+  }
+
+  /**
+   * Event name from TRACE_EVENT, or `UNKNOWN_<id>` for IDs this build does not know
+   */
+  eventName(index: number): string {
+    const id = this.event(index);
+    return EVENT_NAMES[id] ?? `UNKNOWN_${id}`;
+  }
+
+  /**
+   * Trace level, one of TRACE_LEVEL
+   */
+  level(index: number): number {
+    return this.view.getUint8(this.offset(index) + RECORD_LEVEL_OFFSET);
+  }
+
+  private offset(index: number): number {
+    if (index < 0 || index >= this.count) {
+      throw new RangeError(`Record index ${index} out of range (count ${this.count})`);
+    }
+    return index * TRACE_RECORD_STRIDE;
+  }
+}
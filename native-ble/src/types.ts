@@ -2,6 +2,8 @@
  * Type definitions for GhostMesh Native BLE Module
  */
 
+import type { DiscoveryBatch } from './adapter';
+
 /**
  * BLE adapter state
  */
@@ -27,6 +29,52 @@ export type BLEErrorCode =
   | 'TIMEOUT'
   | 'UNSUPPORTED';
 
+/**
+ * Radio an adapter drives
+ *
+ * - `auto`: the OS backend compiled into the addon, or `loopback` if there is
+ *   none or it cannot be opened
+ * - `platform`: the OS backend only; construction fails if the build has none
+ * - `loopback`: in-process radio shared by the adapters of one process
+ */
+export type BLEBackend = 'auto' | 'platform' | 'loopback';
+
+/**
+ * Options for creating a BLEAdapter on the native addon
+ */
+export interface BLEAdapterOptions {
+  /**
+   * Identifier for this adapter instance
+   */
+  adapterId?: string;
+
+  /**
+   * Radio to drive (default: 'auto')
+   */
+  backend?: BLEBackend;
+
+  /**
+   * Whether the radio may advertise and scan at the same time (default: what
+   * the radio reports). With false, or a radio that cannot, advertising and
+   * scanning take turns in native time slices weighted by the queued
+   * advertisements' priorities; on loopback this emulates such a radio.
+   */
+  simultaneousAdvScan?: boolean;
+
+  /**
+   * Length of one advertise slot plus one scan slot when they take turns
+   * (ms, at least 40; default 300)
+   */
+  coexistenceCycleMs?: number;
+
+  /**
+   * Initialize the platform backend on a background thread instead of in
+   * the constructor (default: false). The adapter reports 'unknown' until
+   * `ready` resolves, and `stateChange` listeners first hear the outcome.
+   */
+  lazyInit?: boolean;
+}
+
 /**
  * Options for starting BLE advertising
  */
@@ -44,7 +92,8 @@ export interface AdvertisingOptions {
   /**
    * Manufacturer-specific data
    * Format: 2-byte company ID (little-endian) + payload
-   * Minimum 2 bytes, maximum 27 bytes for legacy advertising
+   * Minimum 2 bytes, maximum 27 bytes for legacy advertising;
+   * use createAdvertisingSet() for longer, extended payloads
    */
   manufacturerData?: Buffer;
 
@@ -62,6 +111,123 @@ export interface AdvertisingOptions {
   txPowerLevel?: number;
 }
 
+/**
+ * Options for an extended advertising set (createAdvertisingSet())
+ */
+export interface AdvertisingSetOptions {
+  /**
+   * Manufacturer-specific data
+   * Format: 2-byte company ID (little-endian) + payload
+   * Up to AdvertisingCapabilities.maxAdvertisingDataSize bytes (251 on BLE 5 radios)
+   */
+  manufacturerData: Buffer;
+
+  /**
+   * Service UUIDs to advertise in this set
+   */
+  serviceUUIDs?: string[];
+}
+
+/**
+ * What the radio behind an adapter supports
+ */
+export interface AdvertisingCapabilities {
+  /**
+   * BLE 5 extended advertising
+   */
+  supportsExtendedAdvertising: boolean;
+
+  /**
+   * Largest manufacturer data (company ID + payload) one advertisement carries
+   */
+  maxAdvertisingDataSize: number;
+
+  /**
+   * Can advertise and scan at the same time; when false, an adapter doing
+   * both time slices the radio between them
+   */
+  supportsSimultaneousAdvScan: boolean;
+
+  /**
+   * Several advertising sets can be on air at once
+   */
+  supportsMultipleAdvSets: boolean;
+
+  /**
+   * Advertising sets available besides the main advertisement
+   */
+  maxAdvertisingSets: number;
+
+  /**
+   * The controller runs a fixed `scanWindowMs` / `scanIntervalMs` itself;
+   * otherwise (and for `adaptiveScan`) the adapter gates the radio in software
+   */
+  supportsScanDutyCycle: boolean;
+}
+
+/**
+ * Capabilities assumed when the native adapter cannot report its own
+ */
+export const LEGACY_ADVERTISING_CAPABILITIES: Readonly<AdvertisingCapabilities> = {
+  supportsExtendedAdvertising: false,
+  maxAdvertisingDataSize: 27,
+  supportsSimultaneousAdvScan: true,
+  supportsMultipleAdvSets: false,
+  maxAdvertisingSets: 0,
+  supportsScanDutyCycle: false,
+};
+
+/**
+ * Scheduling priorities for queued advertisements
+ *
+ * A payload of priority p is put on air p + 1 times as often as a
+ * BACKGROUND payload, so an SOS goes out four times as often as text.
+ */
+export const ADVERTISEMENT_PRIORITY = {
+  BACKGROUND: 0,
+  TEXT: 1,
+  GPS: 2,
+  SOS: 3,
+} as const;
+
+/**
+ * Options for a payload queued with scheduleAdvertisement()
+ */
+export interface ScheduledAdvertisementOptions {
+  /**
+   * Scheduling weight (0-255), see ADVERTISEMENT_PRIORITY
+   * @default 0
+   */
+  priority?: number;
+
+  /**
+   * Transmissions before the payload completes (0 = until cancelled or expired)
+   * @default 0
+   */
+  repeat?: number;
+
+  /**
+   * Lifetime in milliseconds (0 = unlimited)
+   * @default 0
+   */
+  ttlMs?: number;
+}
+
+/**
+ * Final state of a queued advertisement
+ */
+export interface ScheduledAdvertisementResult {
+  /**
+   * ID returned by scheduleAdvertisement()
+   */
+  id: number;
+
+  /**
+   * Number of times the payload was put on air
+   */
+  sent: number;
+}
+
 /**
  * Options for scanning for BLE devices
  */
@@ -90,6 +256,95 @@ export interface ScanOptions {
    * @default 1000
    */
   duplicateTimeout?: number;
+
+  /**
+   * Deliver discoveries as packed `devicesDiscovered` batches instead of one
+   * `deviceDiscovered` event per advertisement
+   * @default false
+   */
+  batchDiscoveries?: boolean;
+
+  /**
+   * Flush interval for `batchDiscoveries` in milliseconds
+   * @default 50
+   */
+  batchIntervalMs?: number;
+
+  /**
+   * Reassemble GhostMesh packets natively and emit `meshMessage` for complete
+   * messages only; mesh fragments are not reported as `deviceDiscovered`
+   * @default false
+   */
+  assembleMesh?: boolean;
+
+  /**
+   * Company ID that identifies GhostMesh packets when `assembleMesh` is set
+   * @default 0xFFFF
+   */
+  meshCompanyId?: number;
+
+  /**
+   * Idle time in milliseconds after which a partially reassembled message is
+   * dropped when `assembleMesh` is set
+   * @default 30000
+   */
+  meshTimeoutMs?: number;
+
+  /**
+   * Aggregate RSSI histograms, EWMA RSSI and packet rates per advertiser
+   * natively; read them with getLinkQuality()
+   * @default false
+   */
+  trackLinkQuality?: boolean;
+
+  /**
+   * Track advertisers in range natively and emit `peerAdded` / `peerLost`
+   * as they appear and time out; list them with getPeers()
+   * @default false
+   */
+  trackPeers?: boolean;
+
+  /**
+   * Silence in milliseconds after which a tracked peer is lost
+   * Reports suppressed as duplicates do not refresh a peer, so keep this
+   * well above duplicateTimeout
+   * @default 30000
+   */
+  peerTimeoutMs?: number;
+
+  /**
+   * Listen for this many milliseconds per scan interval instead of
+   * continuously, trading discovery latency for radio power
+   * @default 0 (continuous)
+   */
+  scanWindowMs?: number;
+
+  /**
+   * Scan interval (window plus gap) in milliseconds when `scanWindowMs` is set;
+   * with `adaptiveScan`, the interval the scan starts at
+   * @default 10 * scanWindowMs (adaptive: minScanIntervalMs)
+   */
+  scanIntervalMs?: number;
+
+  /**
+   * Adapt the interval to the mesh: a window that adds a peer, completes a
+   * mesh message or leaves fragments waiting drops it to minScanIntervalMs,
+   * each idle window doubles it up to maxScanIntervalMs
+   * @default false
+   */
+  adaptiveScan?: boolean;
+
+  /**
+   * Shortest `adaptiveScan` interval in milliseconds
+   * @default 2 * scanWindowMs
+   */
+  minScanIntervalMs?: number;
+
+  /**
+   * Longest `adaptiveScan` interval in milliseconds
+   * @default 16 * scanWindowMs
+   */
+  maxScanIntervalMs?: number;
 }
 
 /**
@@ -129,6 +384,76 @@ export interface DiscoveredDevice {
   timestamp: number;
 }
 
+/**
+ * Advertiser tracked by a `trackPeers` scan
+ */
+export interface PeerInfo {
+  /**
+   * Device MAC address (platform-specific format)
+   */
+  address: string;
+
+  /**
+   * Signal strength of the latest report in dBm
+   */
+  rssi: number;
+
+  /**
+   * Time of the first report (milliseconds since epoch)
+   */
+  firstSeen: number;
+
+  /**
+   * Time of the latest report (milliseconds since epoch)
+   */
+  lastSeen: number;
+
+  /**
+   * Reports received since the peer was added
+   */
+  reports: number;
+}
+
+/**
+ * GhostMesh message reassembled by the native adapter
+ */
+export interface MeshMessage {
+  /**
+   * Address of the advertiser that delivered the final fragment
+   */
+  address: string;
+
+  /**
+   * Source node ID (40-bit)
+   */
+  srcId: number;
+
+  /**
+   * Destination node ID (40-bit)
+   */
+  dstId: number;
+
+  /**
+   * Message ID (12-bit)
+   */
+  messageId: number;
+
+  /**
+   * Number of fragments concatenated into `data`
+   */
+  packetCount: number;
+
+  /**
+   * Hop count carried by the completing fragment
+   */
+  hopCount: number;
+
+  /**
+   * Concatenated fragment payloads (18 bytes per legacy fragment, up to 236 per extended one)
+   */
+  data: Buffer;
+}
+
 /**
  * BLE operation error
  */
@@ -200,6 +525,42 @@ export interface BLEAdapterEvents {
    */
   deviceDiscovered: (device: DiscoveredDevice) => void;
 
+  /**
+   * Emitted once per flush interval when scanning with `batchDiscoveries`
+   * @param batch Packed advertisements collected during the interval
+   */
+  devicesDiscovered: (batch: DiscoveryBatch) => void;
+
+  /**
+   * Emitted when a scan with `assembleMesh` completes a GhostMesh message
+   * @param message The reassembled message
+   */
+  meshMessage: (message: MeshMessage) => void;
+
+  /**
+   * Emitted when a scheduled advertisement reaches its repeat count
+   * @param result The payload's ID and transmission count
+   */
+  advertisementCompleted: (result: ScheduledAdvertisementResult) => void;
+
+  /**
+   * Emitted when a scheduled advertisement's TTL runs out
+   * @param result The payload's ID and transmission count
+   */
+  advertisementExpired: (result: ScheduledAdvertisementResult) => void;
+
+  /**
+   * Emitted when a scan with `trackPeers` hears a new advertiser
+   * @param peer The peer as of its first report
+   */
+  peerAdded: (peer: PeerInfo) => void;
+
+  /**
+   * Emitted when a tracked peer has been silent for `peerTimeoutMs`
+   * @param peer The peer as of its last report
+   */
+  peerLost: (peer: PeerInfo) => void;
+
   /**
    * Emitted when an error occurs
    * @param error The error that occurred
@@ -0,0 +1,78 @@
+/**
+ * Integration tests for native scan filtering on the loopback backend
+ * Loopback adapters in one process hear each other, so no BLE hardware is needed;
+ * skipped when the addon has not been built
+ */
+
+import { BLEAdapter, tryLoadAddon } from '../../src';
+import { DiscoveredDevice, ScanOptions } from '../../src/types';
+import { createManufacturerData, delay } from '../helpers/test-utils';
+
+const describeLoopback = tryLoadAddon() ? describe : describe.skip;
+
+describeLoopback('Native Scan Filters (loopback)', () => {
+  const adapters: BLEAdapter[] = [];
+
+  function loopback(adapterId: string): BLEAdapter {
+    const adapter = new BLEAdapter({ adapterId, backend: 'loopback' });
+    adapters.push(adapter);
+    return adapter;
+  }
+
+  async function advertise(adapterId: string, companyId: number, serviceUUIDs: string[] = []): Promise<void> {
+    await loopback(adapterId).startAdvertising({
+      manufacturerData: createManufacturerData(companyId, [0x01, 0x02]),
+      serviceUUIDs,
+    });
+  }
+
+  // Addresses a scanner reports with these filters (loopback addresses are adapter IDs)
+  async function discovered(adapterId: string, filters: ScanOptions): Promise<string[]> {
+    const scanner = loopback(adapterId);
+    const addresses: string[] = [];
+    scanner.on('deviceDiscovered', (device: DiscoveredDevice) => addresses.push(device.address));
+    await scanner.startScanning({ ...filters, allowDuplicates: true });
+    await delay(50);
+    await scanner.stopScanning();
+    return addresses;
+  }
+
+  afterEach(async () => {
+    await Promise.all(adapters.splice(0).map((adapter) => adapter.destroy()));
+  });
+
+  test('should report only advertisers with the filtered company ID', async () => {
+    await advertise('filter-company-match', 0x1234);
+    await advertise('filter-company-other', 0x5678);
+
+    const addresses = await discovered('filter-company-scanner', { filterByManufacturer: 0x1234 });
+
+    expect(addresses).toContain('filter-company-match');
+    expect(addresses).not.toContain('filter-company-other');
+  });
+
+  test('should match 16-bit service UUIDs against their 128-bit form', async () => {
+    await advertise('filter-service-long', 0xffff, ['0000180d-0000-1000-8000-00805f9b34fb']);
+    await advertise('filter-service-short', 0xffff, ['180D']);
+    await advertise('filter-service-other', 0xffff, ['180f']);
+
+    const byShort = await discovered('filter-service-scanner-16', { filterByService: ['180d'] });
+    expect(byShort).toEqual(expect.arrayContaining(['filter-service-long', 'filter-service-short']));
+    expect(byShort).not.toContain('filter-service-other');
+
+    const byLong = await discovered('filter-service-scanner-128', {
+      filterByService: ['0000180D-0000-1000-8000-00805F9B34FB'],
+    });
+    expect(byLong).toEqual(expect.arrayContaining(['filter-service-long', 'filter-service-short']));
+    expect(byLong).not.toContain('filter-service-other');
+  });
+
+  test('should deliver the simulated device whatever the filters', async () => {
+    const addresses = await discovered('filter-sim-scanner', {
+      filterByManufacturer: 0x1234,
+      filterByService: ['180d'],
+    });
+
+    expect(addresses).toEqual(['filter-sim-scanner-sim']);
+  });
+});
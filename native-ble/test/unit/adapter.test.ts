@@ -3,7 +3,40 @@
  * Tests the interface layer using mock native implementation
  */
 
-import { BLEAdapter, BLEError } from '../../src';
+import {
+  BLEAdapter,
+  BLEError,
+  DiscoveryBatch,
+  DISCOVERY_RECORD_STRIDE,
+  ADVERTISEMENT_PRIORITY,
+  TRACE_EVENT,
+  TRACE_LEVEL,
+  TRACE_RECORD_STRIDE,
+  LINK_QUALITY_RECORD_STRIDE,
+  LEGACY_ADVERTISING_CAPABILITIES,
+  fragmentMessage,
+  parseMeshPacket,
+  decodeMeshHeaders,
+  decodeMeshHeadersJs,
+  MESH_HEADER_SIZE,
+  MESH_LAST_FRAGMENT,
+  MESH_MATCH_BOTH,
+  MESH_MATCH_COMPANY,
+  MessageAssembler,
+  STATS_LAYOUT_VERSION,
+  STATS_SNAPSHOT_SIZE,
+  STAT_COUNTER,
+  STAT_HISTOGRAM,
+  STAT_HISTOGRAM_STRIDE,
+  ADAPTER_EVENT_NAMES,
+  DiscoveryRingReader,
+  createDiscoveryRing,
+  DISCOVERY_RING_HEADER_SIZE,
+  addonCandidates,
+  prebuildDirectory,
+  ADDON_FILE,
+} from '../../src';
+import * as path from 'path';
 import { createMockBLEAdapter } from '../mocks/ble-adapter.mock';
 import {
   createManufacturerData,
@@ -40,6 +73,68 @@ describe('BLEAdapter TypeScript Interface', () => {
     test('should start in not scanning state', () => {
       expect(adapter.isScanning()).toBe(false);
     });
+
+    test('should report the native backend name', () => {
+      expect(adapter.getPlatformName()).toBe('unknown');
+
+      (adapter as any).nativeAdapter.getPlatformName = jest.fn().mockReturnValue('BlueZ-HCI');
+
+      expect(adapter.getPlatformName()).toBe('BlueZ-HCI');
+    });
+
+    test('should reject a coexistence cycle shorter than two radio slots', () => {
+      expect(() => new BLEAdapter({ simultaneousAdvScan: false, coexistenceCycleMs: 20 }))
+        .toThrow('coexistenceCycleMs must be a whole number of at least 40ms');
+    });
+
+    test('should resolve ready with the adapter state', async () => {
+      await expect(adapter.ready).resolves.toBe('poweredOn');
+    });
+
+    test('should hold radio operations until a lazy backend is ready', async () => {
+      const mockNative = createMockBLEAdapter();
+      let initialized!: () => void;
+      (mockNative as any).ready = new Promise<void>((resolve) => { initialized = resolve; });
+      const startAdvertising = jest.spyOn(mockNative, 'startAdvertising');
+      const lazy = new BLEAdapter(mockNative);
+
+      const started = lazy.startAdvertising(createAdvertisingOptions());
+      await delay(20);
+      expect(startAdvertising).not.toHaveBeenCalled();
+
+      mockNative.simulateStateChange('poweredOn');
+      initialized();
+      await started;
+      expect(startAdvertising).toHaveBeenCalledTimes(1);
+      await expect(lazy.ready).resolves.toBe('poweredOn');
+      await lazy.destroy();
+    });
+  });
+
+  describe('Addon Resolution', () => {
+    const saved = process.env.GHOSTMESH_NATIVE_BLE_ADDON;
+
+    afterEach(() => {
+      if (saved === undefined) delete process.env.GHOSTMESH_NATIVE_BLE_ADDON;
+      else process.env.GHOSTMESH_NATIVE_BLE_ADDON = saved;
+    });
+
+    test('should prefer a prebuilt binary for this platform over a local build', () => {
+      delete process.env.GHOSTMESH_NATIVE_BLE_ADDON;
+      const candidates = addonCandidates();
+
+      expect(candidates[0]).toBe(path.join(prebuildDirectory(), ADDON_FILE));
+      expect(path.basename(prebuildDirectory())).toBe(`${process.platform}-${process.arch}`);
+      expect(candidates.slice(1)).toEqual([
+        expect.stringContaining(path.join('build', 'Release', ADDON_FILE)),
+        expect.stringContaining(path.join('build', 'Debug', ADDON_FILE)),
+      ]);
+    });
+
+    test('should try an explicit addon path first', () => {
+      process.env.GHOSTMESH_NATIVE_BLE_ADDON = '/opt/kiosk/native_ble.node';
+      expect(addonCandidates()[0]).toBe('/opt/kiosk/native_ble.node');
+    });
   });
 
   describe('State Management', () => {
@@ -185,6 +280,27 @@ describe('BLEAdapter TypeScript Interface', () => {
     });
   });
 
+  describe('Native Promises', () => {
+    test('should surface native rejections as BLEError with their code', async () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      const failure = Object.assign(new Error('Already advertising'), { code: 'ALREADY_ADVERTISING' });
+      nativeAdapter.startAdvertising = jest.fn().mockRejectedValue(failure);
+
+      const result = adapter.startAdvertising(createAdvertisingOptions());
+
+      await expect(result).rejects.toBeInstanceOf(BLEError);
+      await expect(result).rejects.toMatchObject({ code: 'ALREADY_ADVERTISING', message: 'Already advertising' });
+      expect(adapter.isAdvertising()).toBe(false);
+    });
+
+    test('should default to OPERATION_FAILED for uncoded failures', async () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      nativeAdapter.stopScanning = jest.fn().mockRejectedValue(new Error('radio busy'));
+
+      await expect(adapter.stopScanning()).rejects.toMatchObject({ code: 'OPERATION_FAILED' });
+    });
+  });
+
   describe('Update Advertising Data - Validation', () => {
     test('should validate data is Buffer', async () => {
       const options = createAdvertisingOptions();
@@ -239,6 +355,14 @@ describe('BLEAdapter TypeScript Interface', () => {
         .rejects
         .toThrow('must be a positive number');
     });
+
+    test('should validate meshCompanyId range', async () => {
+      const options = createScanOptions({ assembleMesh: true, meshCompanyId: 0x10000 });
+
+      await expect(adapter.startScanning(options))
+        .rejects
+        .toThrow('between 0 and 0xFFFF');
+    });
   });
 
   describe('Scanning - Operations', () => {
@@ -296,6 +420,517 @@ describe('BLEAdapter TypeScript Interface', () => {
     });
   });
 
+  describe('Native Mesh Reassembly', () => {
+    test('should forward meshMessage events from native adapter', async () => {
+      const messagePromise = waitForEvent(adapter, 'meshMessage');
+      const message = {
+        address: 'peer-1',
+        srcId: 0x0102030405,
+        dstId: 0xffffffffff,
+        messageId: 7,
+        packetCount: 2,
+        hopCount: 1,
+        data: Buffer.alloc(36, 0xab),
+      };
+      (adapter as any).nativeAdapter.emit('meshMessage', message);
+
+      await expect(messagePromise).resolves.toEqual(message);
+    });
+  });
+
+  describe('Batched Discovery', () => {
+    function packRecord(view: DataView, index: number, hash: number, rssi: number, ts: number, data: Buffer) {
+      const base = index * DISCOVERY_RECORD_STRIDE;
+      view.setUint32(base, hash, true);
+      view.setInt16(base + 4, rssi, true);
+      view.setUint8(base + 6, data.length);
+      view.setFloat64(base + 8, ts, true);
+      data.forEach((b, i) => view.setUint8(base + 16 + i, b));
+    }
+
+    test('should reject invalid scan duty cycle options', async () => {
+      await expect(adapter.startScanning({ scanWindowMs: -1 }))
+        .rejects
+        .toThrow('scanWindowMs must be between 0ms and 3600000ms');
+      await expect(adapter.startScanning({ scanWindowMs: 30, adaptiveScan: true, minScanIntervalMs: 500, maxScanIntervalMs: 100 }))
+        .rejects
+        .toThrow('must not exceed maxScanIntervalMs');
+    });
+
+    test('should pass scan duty cycle options to the native adapter', async () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      const startScanning = jest.spyOn(nativeAdapter, 'startScanning');
+      const options = { scanWindowMs: 30, adaptiveScan: true, maxScanIntervalMs: 2000, trackPeers: true };
+      await adapter.startScanning(options);
+      expect(startScanning).toHaveBeenCalledWith(options);
+    });
+
+    test('should reject out-of-range batch interval', async () => {
+      await expect(adapter.startScanning({ batchDiscoveries: true, batchIntervalMs: -1 }))
+        .rejects
+        .toThrow('between 0ms and 10000ms');
+    });
+
+    test('should wrap packed records in a DiscoveryBatch', async () => {
+      const buffer = new ArrayBuffer(2 * DISCOVERY_RECORD_STRIDE);
+      const view = new DataView(buffer);
+      packRecord(view, 0, 0xdeadbeef, -60, 1700000000000, Buffer.from([0xff, 0xff, 0x01]));
+      packRecord(view, 1, 42, -85, 1700000000050, Buffer.alloc(0));
+
+      const batchPromise = waitForEvent(adapter, 'devicesDiscovered');
+      (adapter as any).nativeAdapter.emit('devicesDiscovered', buffer, 2);
+
+      const batch: DiscoveryBatch = await batchPromise;
+      expect(batch.count).toBe(2);
+      expect(batch.addressHash(0)).toBe(0xdeadbeef);
+      expect(batch.rssi(0)).toBe(-60);
+      expect(batch.timestamp(1)).toBe(1700000000050);
+      expect(batch.companyId(0)).toBe(0xffff);
+      expect(batch.companyId(1)).toBe(-1);
+      expect(batch.manufacturerData(0)).toEqual(Buffer.from([0xff, 0xff, 0x01]));
+      expect(() => batch.rssi(2)).toThrow(RangeError);
+    });
+  });
+
+  describe('Scheduled Advertising', () => {
+    test('should pass validated payloads to the native scheduler', () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      nativeAdapter.scheduleAdvertisement = jest.fn().mockReturnValue(7);
+      const data = Buffer.from([0xff, 0xff, 0x01, 0x02]);
+
+      const id = adapter.scheduleAdvertisement(data, { priority: ADVERTISEMENT_PRIORITY.SOS, repeat: 5 });
+
+      expect(id).toBe(7);
+      expect(nativeAdapter.scheduleAdvertisement).toHaveBeenCalledWith(data, { priority: 3, repeat: 5, ttlMs: 0 });
+    });
+
+    test('should reject invalid payloads and options', () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      nativeAdapter.scheduleAdvertisement = jest.fn();
+
+      expect(() => adapter.scheduleAdvertisement(Buffer.alloc(1))).toThrow(BLEError);
+      expect(() => adapter.scheduleAdvertisement(Buffer.alloc(32))).toThrow(BLEError);
+      expect(() => adapter.scheduleAdvertisement(Buffer.alloc(4), { priority: 256 })).toThrow(BLEError);
+      expect(() => adapter.scheduleAdvertisement(Buffer.alloc(4), { repeat: -1 })).toThrow(BLEError);
+      expect(nativeAdapter.scheduleAdvertisement).not.toHaveBeenCalled();
+    });
+
+    test('should report UNSUPPORTED without a native scheduler', () => {
+      expect(() => adapter.scheduleAdvertisement(Buffer.alloc(4))).toThrow(
+        expect.objectContaining({ code: 'UNSUPPORTED' })
+      );
+      expect(adapter.cancelAdvertisement(1)).toBe(false);
+    });
+
+    test('should forward completion and expiry events', async () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      const completed = waitForEvent(adapter, 'advertisementCompleted');
+      const expired = waitForEvent(adapter, 'advertisementExpired');
+
+      nativeAdapter.emit('advertisementCompleted', { id: 1, sent: 5 });
+      nativeAdapter.emit('advertisementExpired', { id: 2, sent: 3 });
+
+      expect(await completed).toEqual({ id: 1, sent: 5 });
+      expect(await expired).toEqual({ id: 2, sent: 3 });
+    });
+  });
+
+  describe('Extended Advertising Sets', () => {
+    const extendedCapabilities = {
+      supportsExtendedAdvertising: true,
+      maxAdvertisingDataSize: 251,
+      supportsSimultaneousAdvScan: true,
+      supportsMultipleAdvSets: true,
+      maxAdvertisingSets: 4,
+    };
+
+    test('should report legacy capabilities without native support', () => {
+      expect(adapter.getCapabilities()).toEqual(LEGACY_ADVERTISING_CAPABILITIES);
+      expect(() => adapter.createAdvertisingSet({ manufacturerData: Buffer.alloc(4) })).toThrow(
+        expect.objectContaining({ code: 'UNSUPPORTED' })
+      );
+      expect(adapter.removeAdvertisingSet(1)).toBe(false);
+    });
+
+    test('should pass extended payloads to the native adapter', () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      nativeAdapter.getCapabilities = jest.fn().mockReturnValue(extendedCapabilities);
+      nativeAdapter.createAdvertisingSet = jest.fn().mockReturnValue(3);
+      nativeAdapter.updateAdvertisingSet = jest.fn();
+      const data = Buffer.alloc(251, 0xff);
+
+      expect(adapter.createAdvertisingSet({ manufacturerData: data })).toBe(3);
+      adapter.updateAdvertisingSet(3, data);
+
+      expect(nativeAdapter.createAdvertisingSet).toHaveBeenCalledWith({ manufacturerData: data });
+      expect(nativeAdapter.updateAdvertisingSet).toHaveBeenCalledWith(3, data);
+      expect(() => adapter.createAdvertisingSet({ manufacturerData: Buffer.alloc(252) })).toThrow(BLEError);
+      expect(() => adapter.updateAdvertisingSet(3, Buffer.alloc(1))).toThrow(BLEError);
+    });
+
+    test('should fragment into fewer packets when extended advertising is available', () => {
+      const header = { companyId: 0xffff, dstId: 0x0102030405, srcId: 0xaabbccddee, messageId: 0x123, hopCount: 2 };
+      const payload = Buffer.from(Array.from({ length: 288 }, (_, i) => i & 0xff));
+
+      const legacy = fragmentMessage(header, payload);
+      const extended = fragmentMessage(header, payload, extendedCapabilities.maxAdvertisingDataSize);
+
+      expect(legacy).toHaveLength(16);
+      expect(extended).toHaveLength(2);
+      expect(extended[0].length).toBe(251);
+
+      const assembler = new MessageAssembler();
+      let assembled: Buffer | undefined;
+      for (const fragment of extended) {
+        const packet = parseMeshPacket(fragment)!;
+        expect(packet.srcId).toBe(header.srcId);
+        assembled = assembler.pushPacket(packet)?.assembled ?? assembled;
+      }
+      expect(assembled!.subarray(0, payload.length)).toEqual(payload);
+      expect(() => fragmentMessage(header, Buffer.alloc(17 * 18))).toThrow(RangeError);
+    });
+  });
+
+  describe('Native Trace', () => {
+    test('should decode drained trace records', () => {
+      const buffer = new ArrayBuffer(2 * TRACE_RECORD_STRIDE);
+      const view = new DataView(buffer);
+      view.setBigUint64(0, 123456789n, true);
+      view.setBigUint64(8, 3n, true);
+      view.setUint32(16, 0xcafebabe, true);
+      view.setUint16(20, TRACE_EVENT.LISTENER_ADDED, true);
+      view.setUint8(22, TRACE_LEVEL.INFO);
+      view.setUint16(TRACE_RECORD_STRIDE + 20, 999, true);
+      (adapter as any).nativeAdapter.drainTrace = jest.fn().mockReturnValue(buffer);
+
+      const trace = adapter.drainTrace();
+
+      expect(trace.count).toBe(2);
+      expect(trace.timestampNs(0)).toBe(123456789n);
+      expect(trace.arg(0)).toBe(3);
+      expect(trace.source(0)).toBe(0xcafebabe);
+      expect(trace.eventName(0)).toBe('LISTENER_ADDED');
+      expect(trace.level(0)).toBe(TRACE_LEVEL.INFO);
+      expect(trace.eventName(1)).toBe('UNKNOWN_999');
+      expect(() => trace.event(2)).toThrow(RangeError);
+    });
+
+    test('should report UNSUPPORTED without a native trace ring', () => {
+      expect(() => adapter.drainTrace()).toThrow(expect.objectContaining({ code: 'UNSUPPORTED' }));
+    });
+  });
+
+  describe('Link Quality', () => {
+    test('should decode a native link-quality snapshot', () => {
+      const buffer = new ArrayBuffer(LINK_QUALITY_RECORD_STRIDE);
+      const view = new DataView(buffer);
+      view.setUint32(0, 0xdeadbeef, true);
+      view.setUint32(4, 42, true);
+      view.setFloat64(8, 1700000000000, true);
+      view.setFloat32(16, -61.5, true);
+      view.setFloat32(20, 8, true);
+      view.setInt8(24, -60);
+      view.setInt8(25, -72);
+      view.setInt8(26, -55);
+      view.setUint16(28 + 8 * 2, 40, true);
+      (adapter as any).nativeAdapter.getLinkQuality = jest.fn().mockReturnValue(buffer);
+
+      const peers = adapter.getLinkQuality();
+
+      expect(peers.count).toBe(1);
+      expect(peers.addressHash(0)).toBe(0xdeadbeef);
+      expect(peers.packets(0)).toBe(42);
+      expect(peers.lastSeen(0)).toBe(1700000000000);
+      expect(peers.ewmaRssi(0)).toBeCloseTo(-61.5);
+      expect(peers.packetRate(0)).toBe(8);
+      expect([peers.lastRssi(0), peers.minRssi(0), peers.maxRssi(0)]).toEqual([-60, -72, -55]);
+      expect(peers.histogramBin(0, 8)).toBe(40);
+      expect(peers.histogram(0).reduce((sum, n) => sum + n, 0)).toBe(40);
+      expect(() => peers.packets(1)).toThrow(RangeError);
+    });
+
+    test('should report UNSUPPORTED without native link-quality tracking', () => {
+      expect(() => adapter.getLinkQuality()).toThrow(expect.objectContaining({ code: 'UNSUPPORTED' }));
+    });
+  });
+
+  describe('Peer Tracking', () => {
+    test('should forward peer deltas and list native peers', async () => {
+      const nativeAdapter = (adapter as any).nativeAdapter;
+      const peer = { address: 'AA:BB:CC:DD:EE:01', rssi: -60, firstSeen: 1000, lastSeen: 2000, reports: 3 };
+      const added = waitForEvent(adapter, 'peerAdded');
+      const lost = waitForEvent(adapter, 'peerLost');
+
+      nativeAdapter.emit('peerAdded', peer);
+      nativeAdapter.emit('peerLost', peer);
+      nativeAdapter.getPeers = jest.fn().mockReturnValue([peer]);
+
+      expect(await added).toEqual(peer);
+      expect(await lost).toEqual(peer);
+      expect(adapter.getPeers()).toEqual([peer]);
+    });
+
+    test('should report UNSUPPORTED without native peer tracking', () => {
+      expect(() => adapter.getPeers()).toThrow(expect.objectContaining({ code: 'UNSUPPORTED' }));
+    });
+  });
+
+  describe('Mesh Reassembly', () => {
+    const header = { companyId: 0xffff, dstId: 1, srcId: 2, messageId: 7, hopCount: 3 };
+
+    test('should wait for the flagged last fragment', () => {
+      const packets = fragmentMessage(header, Buffer.alloc(40, 0xab)).map((f) => parseMeshPacket(f)!);
+      expect(packets.map((p) => p.lastFragment)).toEqual([false, false, true]);
+      expect(packets[2].hopCount).toBe(3);
+
+      const assembler = new MessageAssembler();
+      expect(assembler.pushPacket(packets[0], 0)).toBeNull();
+      expect(assembler.pushPacket(packets[1], 0)).toBeNull();
+      const message = assembler.pushPacket(packets[2], 0);
+      expect(message?.totalPackets).toBe(3);
+      expect(message?.assembled?.subarray(0, 40)).toEqual(Buffer.alloc(40, 0xab));
+      expect(assembler.size).toBe(0);
+      expect(assembler.stats().completed).toBe(1);
+    });
+
+    test('should bound partial messages by capacity and timeout', () => {
+      const assembler = new MessageAssembler(2, 1000);
+      const first = (messageId: number) =>
+        parseMeshPacket(fragmentMessage({ ...header, messageId }, Buffer.alloc(40))[0])!;
+
+      assembler.pushPacket(first(1), 0);
+      assembler.pushPacket(first(2), 10);
+      assembler.pushPacket(first(1), 20);
+      assembler.pushPacket(first(3), 30);
+      expect(assembler.stats()).toMatchObject({ inUse: 2, evicted: 1 });
+
+      expect(assembler.expire(1025)).toBe(1);
+      expect(assembler.expire(1030)).toBe(1);
+      expect(assembler.stats()).toMatchObject({ inUse: 0, capacity: 2, evicted: 1, expired: 2 });
+    });
+
+    test('should reject fragments past the last one', () => {
+      const packets = fragmentMessage(header, Buffer.alloc(40)).map((f) => parseMeshPacket(f)!);
+      const assembler = new MessageAssembler();
+      assembler.pushPacket(packets[2], 0);
+      assembler.pushPacket({ ...packets[1], packetNumber: 5 }, 0);
+      expect(assembler.stats().rejected).toBe(1);
+    });
+
+    test('should forward native reassembly counters', () => {
+      const stats = { inUse: 1, capacity: 256, completed: 4, evicted: 0, expired: 2, rejected: 0, oversized: 0 };
+      (adapter as any).nativeAdapter.getMeshStats = jest.fn().mockReturnValue(stats);
+      expect(adapter.getMeshStats()).toEqual(stats);
+    });
+
+    test('should report UNSUPPORTED without native mesh reassembly', () => {
+      expect(() => adapter.getMeshStats()).toThrow(expect.objectContaining({ code: 'UNSUPPORTED' }));
+    });
+  });
+
+  describe('Mesh Header Batches', () => {
+    const header = { companyId: 0xffff, dstId: 0x1234567890, srcId: 0xabcdef0123, messageId: 0x5a5, hopCount: 3 };
+
+    test('should decode the same headers as parseMeshPacket', () => {
+      const fragments = fragmentMessage(header, Buffer.alloc(40, 0xab));
+      const columns = decodeMeshHeaders(Buffer.concat(fragments));
+
+      expect(columns.count).toBe(3);
+      fragments.forEach((fragment, i) => {
+        const packet = parseMeshPacket(fragment)!;
+        expect(columns.companyId[i]).toBe(packet.companyId);
+        expect(columns.dstId[i]).toBe(packet.dstId);
+        expect(columns.srcId[i]).toBe(packet.srcId);
+        expect(columns.messageId[i]).toBe(packet.messageId);
+        expect(columns.packetNumber[i]).toBe(packet.packetNumber);
+        expect(columns.hopCount[i] & ~MESH_LAST_FRAGMENT).toBe(packet.hopCount);
+        expect((columns.hopCount[i] & MESH_LAST_FRAGMENT) !== 0).toBe(packet.lastFragment);
+      });
+      expect(columns.match).toBeUndefined();
+    });
+
+    test('should decode a last record that ends with its header', () => {
+      const fragments = fragmentMessage(header, Buffer.alloc(40));
+      const records = Buffer.concat(fragments).subarray(0, 2 * 33 + MESH_HEADER_SIZE);
+
+      expect(decodeMeshHeadersJs(records).count).toBe(3);
+      expect(decodeMeshHeadersJs(records.subarray(0, records.length - 1)).count).toBe(2);
+      expect(decodeMeshHeadersJs(records, { count: 1 }).count).toBe(1);
+      expect(decodeMeshHeadersJs(records, { offset: records.length }).count).toBe(0);
+    });
+
+    test('should mark records for a company and destination', () => {
+      const mine = fragmentMessage(header, Buffer.alloc(18))[0];
+      const other = fragmentMessage({ ...header, dstId: 7 }, Buffer.alloc(18))[0];
+      const columns = decodeMeshHeadersJs(Buffer.concat([mine, other, mine]), {
+        companyId: header.companyId,
+        dstId: header.dstId,
+      });
+
+      expect(Array.from(columns.match!)).toEqual([MESH_MATCH_BOTH, MESH_MATCH_COMPANY, MESH_MATCH_BOTH]);
+      expect(columns.matched).toBe(2);
+    });
+
+    test('should reject invalid options like the addon', () => {
+      const records = new Uint8Array(33);
+      expect(() => decodeMeshHeadersJs(records, { stride: 0 })).toThrow(RangeError);
+      expect(() => decodeMeshHeadersJs(records, { dstId: 2 ** 40 })).toThrow(TypeError);
+      expect(() => decodeMeshHeadersJs(records, { offset: 34 })).toThrow(TypeError);
+      expect(() => decodeMeshHeadersJs([0, 1] as any)).toThrow('Expected Uint8Array');
+    });
+
+    test('should decode the headers of a DiscoveryBatch', () => {
+      const fragments = fragmentMessage(header, Buffer.alloc(40));
+      const buffer = new ArrayBuffer(fragments.length * DISCOVERY_RECORD_STRIDE);
+      fragments.forEach((fragment, i) => {
+        new Uint8Array(buffer, i * DISCOVERY_RECORD_STRIDE + 16).set(fragment.subarray(0, 32));
+      });
+
+      const columns = new DiscoveryBatch(buffer, fragments.length).meshHeaders(header.companyId, header.dstId);
+      expect(columns.count).toBe(3);
+      expect(Array.from(columns.packetNumber)).toEqual([0, 1, 2]);
+      expect(columns.matched).toBe(3);
+    });
+  });
+
+  describe('Adapter Statistics', () => {
+    // Packed as BLEAdapter::GetStats writes it
+    function statsValues(): Float64Array {
+      const values = new Float64Array(STATS_SNAPSHOT_SIZE);
+      values[0] = STATS_LAYOUT_VERSION;
+      values[1 + STAT_COUNTER.ADVERTISEMENTS_RECEIVED] = 120;
+      values[1 + STAT_COUNTER.ADVERTISEMENTS_DEDUPED] = 20;
+      values[1 + Object.keys(STAT_COUNTER).length + ADAPTER_EVENT_NAMES.indexOf('deviceDiscovered')] = 100;
+      const emit =
+        1 + Object.keys(STAT_COUNTER).length + ADAPTER_EVENT_NAMES.length + STAT_HISTOGRAM.EMIT * STAT_HISTOGRAM_STRIDE;
+      values[emit] = 100; // count
+      values[emit + 1] = 1500; // sum
+      values[emit + 2] = 300; // max
+      values[emit + 3 + 3] = 90; // [4, 8) us
+      values[emit + 3 + 9] = 10; // [256, 512) us
+      return values;
+    }
+
+    test('should decode native counters and histograms', () => {
+      (adapter as any).nativeAdapter.getStats = jest.fn().mockReturnValue(statsValues());
+
+      const stats = adapter.getStats();
+
+      expect(stats.counter(STAT_COUNTER.ADVERTISEMENTS_RECEIVED)).toBe(120);
+      expect(stats.emits('deviceDiscovered')).toBe(100);
+      expect(stats.meanUs(STAT_HISTOGRAM.EMIT)).toBe(15);
+      expect(stats.percentileUs(STAT_HISTOGRAM.EMIT, 0.5)).toBe(8);
+      expect(stats.percentileUs(STAT_HISTOGRAM.EMIT, 0.99)).toBe(300);
+      expect(stats.latency(STAT_HISTOGRAM.DISPATCH)).toEqual({ count: 0, meanUs: 0, p50Us: 0, p99Us: 0, maxUs: 0 });
+      expect(stats.toJSON().counters.ADVERTISEMENTS_DEDUPED).toBe(20);
+      expect(() => stats.counter(99)).toThrow(RangeError);
+    });
+
+    test('should reject an unknown stats layout', () => {
+      const values = statsValues();
+      values[0] = STATS_LAYOUT_VERSION + 1;
+      (adapter as any).nativeAdapter.getStats = jest.fn().mockReturnValue(values);
+      expect(() => adapter.getStats()).toThrow(RangeError);
+    });
+
+    test('should report UNSUPPORTED without native statistics', () => {
+      expect(() => adapter.getStats()).toThrow(expect.objectContaining({ code: 'UNSUPPORTED' }));
+    });
+  });
+
+  describe('Discovery Ring', () => {
+    // Append records as DiscoveryRingWriter::Publish does, one per RSSI
+    function publish(ring: SharedArrayBuffer, rssis: number[]): void {
+      const words = new Int32Array(ring, 0, DISCOVERY_RING_HEADER_SIZE / 4);
+      const view = new DataView(ring);
+      const capacity = words[2];
+      const start = words[5];
+      Atomics.store(words, 4, start + rssis.length);
+      rssis.forEach((rssi, i) => {
+        const slot = (start + i) & (capacity - 1);
+        view.setInt16(DISCOVERY_RING_HEADER_SIZE + slot * DISCOVERY_RECORD_STRIDE + 4, rssi, true);
+      });
+      Atomics.store(words, 5, start + rssis.length);
+    }
+
+    function rssis(batch: DiscoveryBatch): number[] {
+      return Array.from({ length: batch.count }, (_, i) => batch.rssi(i));
+    }
+
+    test('should read published records in place', () => {
+      const ring = createDiscoveryRing(8);
+      const reader = new DiscoveryRingReader(ring);
+      expect(reader.read()).toBeNull();
+
+      publish(ring, [-40, -50, -60]);
+
+      expect(reader.available).toBe(3);
+      const batch = reader.read()!;
+      expect(batch.buffer).toBe(ring);
+      expect(rssis(batch)).toEqual([-40, -50, -60]);
+      expect(reader.intact()).toBe(true);
+      expect(reader.read()).toBeNull();
+      expect(reader.wait(0)).toBe(false);
+    });
+
+    test('should split a run at the end of the ring', () => {
+      const ring = createDiscoveryRing(4);
+      const reader = new DiscoveryRingReader(ring);
+      publish(ring, [-1, -2, -3]);
+      reader.read();
+
+      publish(ring, [-4, -5, -6]);
+
+      expect(rssis(reader.read()!)).toEqual([-4]);
+      expect(rssis(reader.read()!)).toEqual([-5, -6]);
+      expect(reader.dropped).toBe(0);
+    });
+
+    test('should skip records the writer has lapped', () => {
+      const ring = createDiscoveryRing(4);
+      const reader = new DiscoveryRingReader(ring);
+      publish(ring, [-1, -2]);
+      const stale = reader.read()!;
+
+      publish(ring, [-3, -4, -5, -6]);
+
+      expect(reader.intact()).toBe(false);
+      expect(stale.count).toBe(2);
+      const batches = [reader.read()!, reader.read()!];
+      expect(batches.flatMap(rssis)).toEqual([-3, -4, -5, -6]);
+      expect(reader.dropped).toBe(0);
+
+      publish(ring, [-7, -8, -9, -10, -11]);
+      reader.read();
+      expect(reader.dropped).toBe(1);
+    });
+
+    test('should reject buffers that are not rings', () => {
+      expect(() => new DiscoveryRingReader(new SharedArrayBuffer(256))).toThrow(
+        expect.objectContaining({ code: 'INVALID_PARAMETER' })
+      );
+      expect(() => createDiscoveryRing(3)).toThrow(expect.objectContaining({ code: 'INVALID_PARAMETER' }));
+    });
+
+    test('should hand the native adapter an Int32Array over the ring', () => {
+      const attach = jest.fn();
+      (adapter as any).nativeAdapter.attachDiscoveryRing = attach;
+      const ring = createDiscoveryRing();
+
+      adapter.attachDiscoveryRing(ring);
+
+      expect(attach).toHaveBeenCalledTimes(1);
+      expect(attach.mock.calls[0][0]).toBeInstanceOf(Int32Array);
+      expect(attach.mock.calls[0][0].buffer).toBe(ring);
+    });
+
+    test('should report UNSUPPORTED without native discovery rings', () => {
+      expect(() => adapter.attachDiscoveryRing(createDiscoveryRing())).toThrow(
+        expect.objectContaining({ code: 'UNSUPPORTED' })
+      );
+    });
+  });
+
   describe('Concurrent Operations', () => {
     test('should allow advertising and scanning simultaneously', async () => {
       const advOptions = createAdvertisingOptions();
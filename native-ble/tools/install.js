@@ -0,0 +1,26 @@
+#!/usr/bin/env node
+/*
+ * npm install hook: keep the prebuilt binary shipped for this platform, if
+ * any, and only compile the addon with node-gyp when there is none
+ *
+ * Usage (run by npm):
+ *   npm install                                 # prebuilt when available
+ *   GHOSTMESH_BUILD_FROM_SOURCE=1 npm install   # always compile
+ */
+
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const root = path.join(__dirname, '..');
+const target = `${process.platform}-${process.arch}`;
+const prebuilt = path.join(root, 'prebuilds', target, 'native_ble.node');
+
+if (process.env.GHOSTMESH_BUILD_FROM_SOURCE !== '1' && fs.existsSync(prebuilt)) {
+  console.log(`native-ble: using prebuilt binary for ${target}`);
+  process.exit(0);
+}
+
+console.log(`native-ble: no prebuilt binary for ${target}, building from source`);
+const result = spawnSync('node-gyp', ['rebuild'], { cwd: root, stdio: 'inherit', shell: process.platform === 'win32' });
+process.exit(result.status === null ? 1 : result.status);
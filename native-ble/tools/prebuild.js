@@ -0,0 +1,29 @@
+#!/usr/bin/env node
+/*
+ * Stage the built addon as the prebuilt binary for a platform
+ * Copies build/Release/native_ble.node to prebuilds/<platform>-<arch>/, where
+ * the resolver in src/addon.ts looks first.
+ *
+ * Usage:
+ *   npm run build:prebuild
+ *   node tools/prebuild.js [--arch=arm64]   # after a cross build (node-gyp rebuild --arch=arm64)
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const root = path.join(__dirname, '..');
+const archArg = process.argv.find((arg) => arg.startsWith('--arch='));
+const arch = archArg ? archArg.slice('--arch='.length) : process.arch;
+const target = `${process.platform}-${arch}`;
+
+const built = path.join(root, 'build', 'Release', 'native_ble.node');
+if (!fs.existsSync(built)) {
+  console.error(`No addon at ${built}; run npm run build:native first`);
+  process.exit(1);
+}
+
+const dir = path.join(root, 'prebuilds', target);
+fs.mkdirSync(dir, { recursive: true });
+fs.copyFileSync(built, path.join(dir, 'native_ble.node'));
+console.log(`Staged prebuilt binary for ${target}`);
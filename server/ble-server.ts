@@ -5,11 +5,25 @@
  */
 
 import { WebSocketServer, WebSocket } from 'ws';
+import { mkdirSync } from 'fs';
+import { homedir } from 'os';
+import { dirname, join } from 'path';
 import { MeshNode } from '../src/mesh';
-import { Message } from '../src/protocol';
+import { Message, phoneNumberMatches } from '../src/protocol';
+import { MessageStore } from '../src/message-store';
 import { logger } from '../src/logger';
+import { loadNativeAddon } from '../src/native';
+import { PeerTable, PeerStream, PEER_STREAM_RATE } from '../src/peer-stream';
+import { NativeStats } from '../lib/types';
+import { AdapterStatsSnapshot, STAT_COUNTER, STAT_HISTOGRAM } from '../native-ble/src/stats';
 
 const PORT = process.env.WS_PORT ? parseInt(process.env.WS_PORT) : 8080;
+const NATIVE_STATS_INTERVAL_MS = 10000; // Matches the Performance Monitor sample rate
+// Binary peer-table frames per second per client
+const FRAME_RATE = process.env.WS_FRAME_RATE ? parseInt(process.env.WS_FRAME_RATE) : PEER_STREAM_RATE;
+// Message history log (memory-mapped; its index sits next to it as <path>.idx)
+const STORE_PATH = process.env.GHOST_MESH_STORE || join(homedir(), '.ghost-mesh', 'messages.gmlog');
+const HISTORY_LIMIT = 500; // Most recent messages sent to a client after init
 
 interface ClientCommand {
   type: 'init' | 'send_message' | 'get_devices' | 'disconnect';
@@ -28,13 +42,15 @@ interface DeviceStatus {
 }
 
 interface ServerEvent {
-  type: 'connected' | 'device_update' | 'device_removed' | 'devices_list' | 'message_received' | 'message_sent' | 'error';
+  type: 'connected' | 'devices_list' | 'message_received' | 'message_sent' | 'message_history' | 'native_stats' | 'error';
   devices?: DeviceStatus[];
   device?: DeviceStatus;
   message?: Message;
+  messages?: Message[];
   error?: string;
   activeCount?: number;
   totalCount?: number;
+  nativeStats?: NativeStats;
 }
 
 class BLEServer {
@@ -42,6 +58,11 @@ class BLEServer {
   private meshNode: MeshNode | null = null;
   private clients: Set<WebSocket> = new Set();
   private isWindowsPlatform: boolean;
+  private lastNativeStats: { at: number; snapshot: AdapterStatsSnapshot } | null = null;
+  // Device updates go out as coalesced binary deltas; messages stay immediate JSON
+  private peers = new PeerTable();
+  private peerStream = new PeerStream(this.peers, FRAME_RATE);
+  private store = openMessageStore();
 
   constructor(port: number) {
     this.isWindowsPlatform = process.platform === 'win32';
@@ -58,6 +79,7 @@ class BLEServer {
     this.wss.on('connection', (ws: WebSocket) => {
       logger.connection('Web client connected');
       this.clients.add(ws);
+      this.peerStream.add(ws);
 
       ws.on('message', async (data: Buffer) => {
         try {
@@ -72,6 +94,7 @@ class BLEServer {
       ws.on('close', () => {
         logger.connection('Web client disconnected');
         this.clients.delete(ws);
+        this.peerStream.delete(ws);
 
         // If no clients left, stop mesh node
         if (this.clients.size === 0 && this.meshNode) {
@@ -84,8 +107,43 @@ class BLEServer {
       ws.on('error', (error) => {
         logger.error('WebSocket error:', error);
         this.clients.delete(ws);
+        this.peerStream.delete(ws);
       });
     });
+
+    const native = loadNativeAddon();
+    if (native?.getStats) {
+      setInterval(() => this.sampleNativeStats(native), NATIVE_STATS_INTERVAL_MS).unref();
+    }
+  }
+
+  // Process-wide native counters as rates over the last interval
+  private sampleNativeStats(native: any) {
+    const snapshot = new AdapterStatsSnapshot(native.getStats());
+    const now = Date.now();
+    const previous = this.lastNativeStats;
+    this.lastNativeStats = { at: now, snapshot };
+    if (!previous || this.clients.size === 0) {
+      return;
+    }
+
+    const seconds = (now - previous.at) / 1000;
+    const delta = (counter: number) => snapshot.counter(counter) - previous.snapshot.counter(counter);
+    const received = delta(STAT_COUNTER.ADVERTISEMENTS_RECEIVED);
+    this.broadcast({
+      type: 'native_stats',
+      nativeStats: {
+        timestamp: now,
+        receivedPerSecond: received / seconds,
+        deliveredPerSecond: delta(STAT_COUNTER.ADVERTISEMENTS_DELIVERED) / seconds,
+        dedupRatio: received > 0 ? delta(STAT_COUNTER.ADVERTISEMENTS_DEDUPED) / received : 0,
+        emitsPerSecond: delta(STAT_COUNTER.EVENTS_EMITTED) / seconds,
+        emitP99Us: snapshot.percentileUs(STAT_HISTOGRAM.EMIT, 0.99),
+        dispatchP99Us: snapshot.percentileUs(STAT_HISTOGRAM.DISPATCH, 0.99),
+        rotationJitterP99Us: snapshot.percentileUs(STAT_HISTOGRAM.ROTATION_JITTER, 0.99),
+        discoveryP99Ms: Math.round(snapshot.percentileUs(STAT_HISTOGRAM.DISCOVERY_LATENCY, 0.99) / 1000),
+      },
+    });
   }
 
   private async handleCommand(ws: WebSocket, command: ClientCommand) {
@@ -160,7 +218,8 @@ class BLEServer {
       }
 
       logger.info(`Starting BLE mesh node for ${phoneNumber}...`);
-      this.meshNode = new MeshNode(phoneNumber);
+      this.meshNode = new MeshNode(phoneNumber, { store: this.store });
+      this.peers.clear();
 
       // Set up event listeners
       this.meshNode.on('started', (data) => {
@@ -168,20 +227,12 @@ class BLEServer {
         this.broadcast({ type: 'connected' });
       });
 
+      // Every advertisement lands here; clients get the latest state on the next frame
       this.meshNode.on('deviceDiscovered', (device) => {
-        logger.ble('Device discovered:', device.id, 'Active:', device.totalCount, 'New:', device.isNew);
-        this.broadcast({
-          type: 'device_update',
-          device: {
-            id: device.id,
-            lastSeen: Date.now(),
-            rssi: device.rssi,
-            isActive: true,
-            activityCount: 1,
-            status: device.isNew ? 'new' : 'active',
-          },
-          activeCount: device.totalCount,
-        });
+        if (device.isNew) {
+          logger.ble('Device discovered:', device.id, 'Active:', device.totalCount);
+        }
+        this.peers.seen(device.id, device.rssi);
       });
 
       this.meshNode.on('deviceHeartbeat', (device) => {
@@ -191,36 +242,12 @@ class BLEServer {
 
       this.meshNode.on('deviceInactive', (device) => {
         logger.ble('Device inactive:', device.id);
-        this.broadcast({
-          type: 'device_update',
-          device: {
-            id: device.id,
-            lastSeen: device.lastSeen,
-            rssi: -100,
-            isActive: false,
-            activityCount: 0,
-            status: 'inactive',
-          },
-        });
+        this.peers.inactive(device.id);
       });
 
       this.meshNode.on('devicesUpdated', (data) => {
         logger.ble('Devices updated - Active:', data.activeCount, 'Total:', data.totalCount, 'Removed:', data.removed.length);
-        if (data.removed.length > 0) {
-          this.broadcast({
-            type: 'device_removed',
-            devices: data.removed.map(id => ({
-              id,
-              lastSeen: 0,
-              rssi: -100,
-              isActive: false,
-              activityCount: 0,
-              status: 'removed',
-            })),
-            activeCount: data.activeCount,
-            totalCount: data.totalCount,
-          });
-        }
+        data.removed.forEach(id => this.peers.remove(id));
       });
 
       this.meshNode.on('messageReceived', (message: Message) => {
@@ -250,6 +277,16 @@ class BLEServer {
       // Start the mesh node
       await this.meshNode.start();
 
+      // History from earlier runs, straight from the mapped log
+      this.send(ws, {
+        type: 'message_history',
+        messages: this.meshNode
+          .getHistory({ limit: HISTORY_LIMIT })
+          .map(stored => stored.message)
+          .filter(message => message.from === phoneNumber || message.to === 'BROADCAST' ||
+            phoneNumberMatches(phoneNumber, message.to)),
+      });
+
     } catch (error: any) {
       logger.error('Failed to initialize mesh node:', error);
       this.sendError(ws, `Failed to start BLE: ${error.message}`);
@@ -278,6 +315,28 @@ class BLEServer {
   getMeshNode(): MeshNode | null {
     return this.meshNode;
   }
+
+  /**
+   * Write the message history to disk before exiting
+   */
+  flushHistory() {
+    this.store.sync();
+  }
+}
+
+// Fall back to in-memory history rather than refusing to start
+function openMessageStore(): MessageStore {
+  try {
+    mkdirSync(dirname(STORE_PATH), { recursive: true });
+    const store = new MessageStore(STORE_PATH);
+    if (store.persistent) {
+      logger.info(`Message history: ${STORE_PATH} (${store.size} messages)`);
+    }
+    return store;
+  } catch (error: any) {
+    logger.error(`Cannot open message history ${STORE_PATH}:`, error.message);
+    return new MessageStore();
+  }
 }
 
 // Start server
@@ -286,10 +345,12 @@ const server = new BLEServer(PORT);
 // Handle process signals
 process.on('SIGINT', () => {
   logger.info('\nShutting down BLE server...');
+  server.flushHistory();
   process.exit(0);
 });
 
 process.on('SIGTERM', () => {
   logger.info('\nShutting down BLE server...');
+  server.flushHistory();
   process.exit(0);
 });
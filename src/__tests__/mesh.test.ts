@@ -3,7 +3,9 @@
  */
 
 import { MeshNode } from '../mesh';
-import { Message } from '../protocol';
+import { Message, encodeDigestFrame, manufacturerMessageKey } from '../protocol';
+import { MessageStore } from '../message-store';
+import { SeenDigest } from '../seen-digest';
 
 // Mock the noble module
 jest.mock('@abandonware/noble', () => {
@@ -69,17 +71,208 @@ describe('MeshNode', () => {
     });
   });
 
+  describe('Relay Suppression', () => {
+    const incoming = (): Message => ({
+      to: '+1999999999',
+      from: '+1888888888',
+      content: 'Relay me',
+      id: 'relay-test-1',
+      timestamp: Date.now(),
+      hops: 1
+    });
+
+    beforeEach(() => {
+      jest.useFakeTimers();
+    });
+
+    afterEach(() => {
+      jest.useRealTimers();
+    });
+
+    it('should relay a new message after the backoff', () => {
+      const relayed = jest.fn();
+      node.on('messageRelayed', relayed);
+
+      (node as any).processReceivedMessage(incoming(), -80, 'upstream');
+      jest.advanceTimersByTime(500);
+
+      expect(relayed).toHaveBeenCalledWith(expect.objectContaining({ id: 'relay-test-1', hops: 2 }));
+      expect(node.getRelayStats()).toMatchObject({ relayed: 1, suppressed: 0 });
+    });
+
+    it('should cancel the relay when neighbours already rebroadcast it', () => {
+      const relayed = jest.fn();
+      const suppressed = jest.fn();
+      node.on('messageRelayed', relayed);
+      node.on('relaySuppressed', suppressed);
+
+      (node as any).processReceivedMessage(incoming(), -40, 'upstream');
+      (node as any).processReceivedMessage(incoming(), -45, 'peer-a');
+      (node as any).processReceivedMessage(incoming(), -45, 'peer-b');
+      jest.advanceTimersByTime(500);
+
+      expect(suppressed).toHaveBeenCalledTimes(1);
+      expect(relayed).not.toHaveBeenCalled();
+      expect(node.getRelayStats()).toMatchObject({ relayed: 0, suppressed: 1 });
+    });
+
+    const digestHolding = (message: Message): Buffer => {
+      const peer = new SeenDigest();
+      peer.add(manufacturerMessageKey(message));
+      return encodeDigestFrame(peer.bits(), peer.size);
+    };
+
+    it('should not count the digest of the node the message came from', () => {
+      const relayed = jest.fn();
+      const suppressed = jest.fn();
+      node.on('messageRelayed', relayed);
+      node.on('relaySuppressed', suppressed);
+
+      const message = incoming();
+      const frame = digestHolding(message);
+
+      (node as any).processReceivedMessage(message, -40, 'upstream');
+      (node as any).handleManufacturerDataMessage(frame, -40, 'upstream');
+      (node as any).handleManufacturerDataMessage(frame, -50, 'peer-a');
+      jest.advanceTimersByTime(500);
+
+      expect(suppressed).not.toHaveBeenCalled();
+      expect(relayed).toHaveBeenCalledTimes(1);
+    });
+
+    it('should cancel the relay when other neighbours advertise digests holding it', () => {
+      const relayed = jest.fn();
+      const suppressed = jest.fn();
+      node.on('messageRelayed', relayed);
+      node.on('relaySuppressed', suppressed);
+
+      const message = incoming();
+      const frame = digestHolding(message);
+
+      (node as any).processReceivedMessage(message, -40, 'upstream');
+      (node as any).handleManufacturerDataMessage(frame, -40, 'upstream');
+      (node as any).handleManufacturerDataMessage(frame, -50, 'peer-a');
+      (node as any).handleManufacturerDataMessage(frame, -50, 'peer-b');
+      jest.advanceTimersByTime(500);
+
+      expect(suppressed).toHaveBeenCalledTimes(1);
+      expect(relayed).not.toHaveBeenCalled();
+    });
+
+    it('should keep advertising a relay until enough other neighbours hold it', () => {
+      const message = incoming();
+      const frame = digestHolding(message);
+      const queued = () => (node as any).messageQueue.map((m: Message) => m.id);
+
+      (node as any).processReceivedMessage(message, -40, 'upstream');
+      jest.advanceTimersByTime(500);
+      expect(queued()).toEqual(['relay-test-1']);
+
+      (node as any).handleManufacturerDataMessage(frame, -40, 'upstream');
+      (node as any).handleManufacturerDataMessage(frame, -50, 'peer-a');
+      (node as any).handleManufacturerDataMessage(frame, -50, 'peer-a');
+      expect(queued()).toEqual(['relay-test-1']);
+
+      (node as any).handleManufacturerDataMessage(frame, -50, 'peer-b');
+      expect(queued()).toEqual([]);
+    });
+
+    it('should count a neighbour repeating its digest once', () => {
+      const relayed = jest.fn();
+      node.on('messageRelayed', relayed);
+
+      const message = incoming();
+      const frame = digestHolding(message);
+
+      (node as any).processReceivedMessage(message, -40, 'upstream');
+      for (let i = 0; i < 5; i++) {
+        (node as any).handleManufacturerDataMessage(frame, -50, 'peer-a');
+      }
+      jest.advanceTimersByTime(500);
+
+      expect(relayed).toHaveBeenCalledTimes(1);
+    });
+  });
+
+  describe('Message History', () => {
+    it('should store sent messages and received messages addressed to us', () => {
+      const historyNode = new MeshNode('+1234567890', { store: new MessageStore() });
+      const sent = historyNode.sendMessage('+0987654321', 'Outgoing');
+      (historyNode as any).processReceivedMessage(
+        { to: '+1234567890', from: '+0987654321', content: 'Incoming', id: 'history-1', timestamp: sent.timestamp + 1, hops: 1 },
+        -60,
+        'peer-a'
+      );
+      (historyNode as any).processReceivedMessage(
+        { to: '+1999999999', from: '+0987654321', content: 'Passing by', id: 'history-2', timestamp: sent.timestamp + 2, hops: 1 },
+        -60,
+        'peer-a'
+      );
+
+      expect(historyNode.getHistory().map(({ message, direction }) => [message.content, direction])).toEqual([
+        ['Outgoing', 'sent'],
+        ['Incoming', 'received'],
+      ]);
+      return historyNode.stop();
+    });
+
+    it('should recognise messages from before a restart', () => {
+      const store = new MessageStore();
+      const incoming: Message = {
+        to: '+1234567890', from: '+0987654321', content: 'Before restart', id: 'restart-1', timestamp: Date.now(), hops: 1
+      };
+      const before = new MeshNode('+1234567890', { store });
+      (before as any).processReceivedMessage(incoming, -60, 'peer-a');
+
+      const restarted = new MeshNode('+1234567890', { store });
+      const received = jest.fn();
+      restarted.on('messageReceived', received);
+      (restarted as any).processReceivedMessage({ ...incoming, hops: 2 }, -60, 'peer-a');
+
+      expect(received).not.toHaveBeenCalled();
+      expect(restarted.getSeenMessagesCount()).toBe(1);
+      return Promise.all([before.stop(), restarted.stop()]);
+    });
+
+    it('should age restored messages from when they were stored, not from the restart', () => {
+      const start = 1_700_000_000_000;
+      const now = jest.spyOn(Date, 'now').mockReturnValue(start);
+      const store = new MessageStore();
+      const before = new MeshNode('+1234567890', { store });
+      (before as any).processReceivedMessage({
+        to: '+1234567890', from: '+0987654321', content: 'Before restart', id: 'restart-2', timestamp: start, hops: 1
+      }, -60, 'peer-a');
+
+      now.mockReturnValue(start + 50 * 60000);
+      const restarted = new MeshNode('+1234567890', { store });
+      expect(restarted.getSeenMessagesCount()).toBe(1);
+
+      now.mockReturnValue(start + 75 * 60000);
+      expect(restarted.getSeenMessagesCount()).toBe(0);
+      now.mockRestore();
+      return Promise.all([before.stop(), restarted.stop()]);
+    });
+
+    it('should have no history without a store', () => {
+      node.sendMessage('+0987654321', 'Not kept');
+      expect(node.getHistory()).toEqual([]);
+    });
+  });
+
   describe('Seen Messages Management', () => {
-    it('should clear old seen messages when limit reached', () => {
-      // Add many messages to trigger cleanup
+    it('should clear old seen messages', () => {
+      const now = jest.spyOn(Date, 'now').mockReturnValue(1_700_000_000_000);
       for (let i = 0; i < 1100; i++) {
         node.sendMessage(`+${i}`, `Message ${i}`);
       }
 
       const beforeCleanup = node.getSeenMessagesCount();
+      now.mockReturnValue(1_700_000_000_000 + 2 * 3600000);
       node.clearOldSeenMessages();
       const afterCleanup = node.getSeenMessagesCount();
+      now.mockRestore();
 
+      expect(beforeCleanup).toBe(1100);
       expect(afterCleanup).toBeLessThan(beforeCleanup);
     });
   });
@@ -0,0 +1,74 @@
+/**
+ * Tests for the message history store
+ */
+
+import { MessageStore, messageStoreKey } from '../message-store';
+import { Message } from '../protocol';
+
+jest.mock('../native', () => ({ loadNativeAddon: jest.fn(() => null) }));
+
+const message = (id: string, timestamp: number, overrides: Partial<Message> = {}): Message => ({
+  to: '+15551234567',
+  from: '+15557654321',
+  content: `Message ${id}`,
+  id,
+  timestamp,
+  hops: 0,
+  ...overrides,
+});
+
+describe('messageStoreKey', () => {
+  it('should use the last 12 digits of a phone number as the sender', () => {
+    expect(messageStoreKey({ from: '+15557654321', id: 'a' }).srcId).toBe(15557654321);
+    expect(messageStoreKey({ from: '+4915557654321', id: 'a' }).srcId).toBe(915557654321);
+  });
+
+  it('should fit every key in 40 + 12 bits', () => {
+    const key = messageStoreKey({ from: 'node-alpha', id: '1700000000123-k3j9x0a2b' });
+    expect(key.srcId).toBeLessThan(2 ** 40);
+    expect(key.messageId).toBeLessThan(2 ** 12);
+    expect(messageStoreKey({ from: 'node-alpha', id: '1700000000123-k3j9x0a2b' })).toEqual(key);
+  });
+});
+
+describe('MessageStore', () => {
+  const start = 1_700_000_000_000;
+
+  it('should round-trip messages with their direction', () => {
+    const store = new MessageStore();
+    const sent = message('1700000000000-abc', start);
+    expect(store.append(sent, 'sent')).toBe(true);
+
+    expect(store.persistent).toBe(false);
+    expect(store.size).toBe(1);
+    expect(store.find(sent)).toEqual([{ message: sent, direction: 'sent', storedAt: expect.any(Number) }]);
+  });
+
+  it('should skip relayed copies of a stored message', () => {
+    const store = new MessageStore();
+    const original = message('dup-1', start);
+    store.append(original);
+
+    expect(store.append({ ...original, hops: 3 })).toBe(false);
+    expect(store.size).toBe(1);
+  });
+
+  it('should return history in timestamp order whatever the arrival order', () => {
+    const store = new MessageStore();
+    [5, 1, 4, 2, 3].forEach(i => store.append(message(`m-${i}`, start + i * 1000)));
+
+    expect(store.history().map(stored => stored.message.id)).toEqual(['m-1', 'm-2', 'm-3', 'm-4', 'm-5']);
+    expect(store.history({ from: start + 2000, to: start + 4000 }).map(stored => stored.message.id)).toEqual([
+      'm-2',
+      'm-3',
+    ]);
+    expect(store.history({ limit: 2 }).map(stored => stored.message.id)).toEqual(['m-4', 'm-5']);
+    expect(store.history({ limit: 2, newest: false }).map(stored => stored.message.id)).toEqual(['m-1', 'm-2']);
+  });
+
+  it('should refuse messages larger than one record', () => {
+    const store = new MessageStore();
+    expect(store.append(message('long', start, { content: 'x'.repeat(400) }))).toBe(false);
+    expect(store.size).toBe(0);
+  });
+});
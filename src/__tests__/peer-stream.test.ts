@@ -0,0 +1,127 @@
+/**
+ * Tests for the binary peer-table stream
+ */
+
+import {
+  PeerTable,
+  PeerTableMirror,
+  PeerStream,
+  PeerStreamClient,
+  PEER_FRAME_HEADER_SIZE,
+  PEER_FRAME_RESET,
+  PEER_RECORD_SIZE,
+} from '../peer-stream';
+
+class FakeClient implements PeerStreamClient {
+  bufferedAmount = 0;
+  frames: Uint8Array[] = [];
+
+  send(data: Uint8Array): void {
+    this.frames.push(data);
+  }
+}
+
+describe('PeerTable', () => {
+  const now = 1_700_000_000_000;
+
+  it('should send every peer with its id in the first frame', () => {
+    const table = new PeerTable();
+    table.seen('aa:01', -60, now - 500);
+    table.seen('aa:02', -75, now);
+    table.inactive('aa:02');
+
+    const frame = table.delta(0, now)!;
+    expect(frame[1] & PEER_FRAME_RESET).toBe(PEER_FRAME_RESET);
+
+    const mirror = new PeerTableMirror();
+    mirror.apply(frame);
+    expect(mirror.peers()).toEqual([
+      { id: 'aa:02', rssi: -75, lastSeen: now, activityCount: 1, active: false },
+      { id: 'aa:01', rssi: -60, lastSeen: now - 500, activityCount: 1, active: true },
+    ]);
+    expect(mirror.activeCount).toBe(1);
+    expect(mirror.totalCount).toBe(2);
+  });
+
+  it('should send only changed peers, without ids it already sent', () => {
+    const table = new PeerTable();
+    for (let i = 0; i < 500; i++) {
+      table.seen(`peer-${i}`, -70, now);
+    }
+    const mirror = new PeerTableMirror();
+    mirror.apply(table.delta(0, now)!);
+    const synced = table.version;
+
+    table.seen('peer-7', -50, now + 100);
+    const frame = table.delta(synced, now + 100)!;
+
+    expect(frame.length).toBe(PEER_FRAME_HEADER_SIZE + PEER_RECORD_SIZE);
+    mirror.apply(frame);
+    expect(mirror.peers()[0]).toEqual({ id: 'peer-7', rssi: -50, lastSeen: now + 100, activityCount: 2, active: true });
+    expect(table.delta(table.version, now)).toBeNull();
+  });
+
+  it('should apply removals before a reused slot is filled again', () => {
+    const table = new PeerTable();
+    table.seen('old', -60, now);
+    const mirror = new PeerTableMirror();
+    mirror.apply(table.delta(0, now)!);
+    const synced = table.version;
+
+    table.remove('old');
+    table.seen('new', -65, now);
+    const removed = mirror.apply(table.delta(synced, now)!);
+
+    expect(removed).toEqual(['old']);
+    expect(mirror.peers().map(p => p.id)).toEqual(['new']);
+  });
+});
+
+describe('PeerStream', () => {
+  it('should coalesce changes into one frame per flush', () => {
+    const table = new PeerTable();
+    const stream = new PeerStream(table);
+    const client = new FakeClient();
+    stream.add(client);
+
+    for (let i = 0; i < 100; i++) {
+      table.seen('aa:01', -60 - (i % 10));
+    }
+    stream.flush();
+    stream.flush();
+
+    expect(client.frames).toHaveLength(1);
+    stream.stop();
+  });
+
+  it('should skip congested clients and catch them up with the latest state', () => {
+    const table = new PeerTable();
+    const stream = new PeerStream(table, 10, 1024);
+    const fast = new FakeClient();
+    const slow = new FakeClient();
+    stream.add(fast);
+    stream.add(slow);
+    const mirror = new PeerTableMirror();
+
+    table.seen('aa:01', -60);
+    stream.flush();
+    mirror.apply(slow.frames[0]);
+
+    slow.bufferedAmount = 4096;
+    table.seen('aa:01', -61);
+    table.seen('aa:02', -80);
+    table.remove('aa:02');
+    stream.flush();
+    expect(fast.frames).toHaveLength(2);
+    expect(slow.frames).toHaveLength(1);
+
+    slow.bufferedAmount = 0;
+    table.seen('aa:01', -62);
+    stream.flush();
+
+    expect(slow.frames).toHaveLength(2);
+    mirror.apply(slow.frames[1]);
+    expect(mirror.peers()).toEqual([expect.objectContaining({ id: 'aa:01', rssi: -62, activityCount: 3 })]);
+    stream.stop();
+  });
+});
@@ -8,9 +8,15 @@ import {
   deserializeMessage,
   generateMessageId,
   phoneNumberMatches,
+  encodeToManufacturerData,
+  decodeFromManufacturerData,
+  encodeDigestFrame,
+  decodeDigestFrame,
+  manufacturerMessageKey,
   MAX_HOPS,
   MESSAGE_VERSION
 } from '../protocol';
+import { encodeMessage, decodeMessage, encodedMessageBound } from '../message-codec';
 
 describe('Protocol', () => {
   describe('Message Serialization', () => {
@@ -56,6 +62,135 @@ describe('Protocol', () => {
       const result = deserializeMessage(buffer);
       expect(result).toBeNull();
     });
+
+    it('should still accept legacy JSON payloads', () => {
+      const legacy = {
+        v: MESSAGE_VERSION,
+        t: '+1234567890',
+        f: '+0987654321',
+        c: 'test',
+        i: 'id',
+        ts: 1700000000000,
+        h: 2
+      };
+      const result = deserializeMessage(Buffer.from(JSON.stringify(legacy)));
+      expect(result).toEqual({
+        to: '+1234567890',
+        from: '+0987654321',
+        content: 'test',
+        id: 'id',
+        timestamp: 1700000000000,
+        hops: 2
+      });
+    });
+  });
+
+  describe('Binary Codec', () => {
+    const message: Message = {
+      to: '+1234567890',
+      from: '+0987654321',
+      content: 'Hello, World!',
+      id: generateMessageId(),
+      timestamp: Date.now(),
+      hops: 3
+    };
+
+    it('should encode smaller than the JSON payload', () => {
+      const json = JSON.stringify({
+        v: MESSAGE_VERSION,
+        t: message.to,
+        f: message.from,
+        c: message.content,
+        i: message.id,
+        ts: message.timestamp,
+        h: message.hops
+      });
+      const buffer = serializeMessage(message);
+      expect(buffer.length).toBeLessThan(Buffer.byteLength(json) / 2);
+      expect(deserializeMessage(buffer)).toEqual(message);
+    });
+
+    it('should round-trip free-form addresses and ids', () => {
+      const odd: Message = {
+        to: 'BROADCAST',
+        from: 'node-7',
+        content: '🆘 need water',
+        id: 'custom id',
+        timestamp: 1.5,
+        hops: 0
+      };
+      expect(deserializeMessage(serializeMessage(odd))).toEqual(odd);
+    });
+
+    it('should quantize a GPS fix in the content', () => {
+      const gps: Message = { ...message, content: 'Stuck here GPS: 37.7749, -122.4194 send help' };
+      const decoded = deserializeMessage(serializeMessage(gps));
+      const match = /^Stuck here GPS: (-?\d+\.\d{6}), (-?\d+\.\d{6}) send help$/.exec(decoded!.content);
+      expect(match).not.toBeNull();
+      expect(Math.abs(parseFloat(match![1]) - 37.7749)).toBeLessThan(1e-5);
+      expect(Math.abs(parseFloat(match![2]) + 122.4194)).toBeLessThan(1e-4);
+    });
+
+    it('should reject a GPS fix whose latitude is not a number or out of range', () => {
+      const gps: Message = { ...message, content: 'Stuck here GPS: 37.7749, -122.4194 send help' };
+      const frame = new Uint8Array(encodedMessageBound(gps));
+      const length = encodeMessage(gps, frame, 0);
+      const latitude = new DataView(frame.buffer, length - 7, 4);
+
+      for (const bad of [NaN, Infinity, -Infinity, 90.5]) {
+        latitude.setFloat32(0, bad, true);
+        expect(decodeMessage(frame.subarray(0, length))).toBeNull();
+      }
+    });
+
+    it('should encode into a caller-supplied buffer at an offset', () => {
+      const out = new Uint8Array(8 + encodedMessageBound(message));
+      const written = encodeMessage(message, out, 8);
+      expect(written).toBeGreaterThan(0);
+      expect(out.subarray(0, 8).every((b) => b === 0)).toBe(true);
+      expect(decodeMessage(out, 8)).toEqual(message);
+    });
+
+    it('should return 0 when the buffer is too small', () => {
+      const out = new Uint8Array(8);
+      expect(encodeMessage(message, out)).toBe(0);
+    });
+
+    it('should reject truncated frames', () => {
+      const buffer = serializeMessage(message);
+      expect(deserializeMessage(buffer.subarray(0, buffer.length - 1))).toBeNull();
+    });
+  });
+
+  describe('Digest Frames', () => {
+    const digest = Buffer.from(Array.from({ length: 23 }, (_, i) => i + 1));
+
+    it('should round-trip a digest', () => {
+      const frame = encodeDigestFrame(digest, 9);
+      expect(frame.length).toBe(27);
+      expect(frame.readUInt16LE(0)).toBe(0xffff);
+
+      const decoded = decodeDigestFrame(frame);
+      expect(decoded).not.toBeNull();
+      expect(decoded!.digest.equals(digest)).toBe(true);
+      expect(decoded!.keyCount).toBe(9);
+    });
+
+    it('should not read digests as messages, or messages as digests', () => {
+      const message: Message = {
+        to: '+1234567890', from: '+0987654321', content: 'Hi', id: '1769268000000-abc', timestamp: 1769268000000, hops: 0
+      };
+      expect(decodeFromManufacturerData(encodeDigestFrame(digest, 1))).toBeNull();
+      expect(decodeDigestFrame(encodeToManufacturerData(message))).toBeNull();
+    });
+
+    it('should key messages by their on-air ID', () => {
+      const message: Message = {
+        to: '+1234567890', from: '+0987654321', content: 'Hi', id: '1769268000000-abc', timestamp: 5, hops: 0
+      };
+      expect(manufacturerMessageKey(message)).toBe(1769268000000n);
+      expect(manufacturerMessageKey({ ...message, id: 'relay-test-1', timestamp: 1234.5 })).toBe(1234n);
+    });
   });
 
   describe('Message ID Generation', () => {
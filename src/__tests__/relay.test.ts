@@ -0,0 +1,74 @@
+/**
+ * Tests for the relay scheduler
+ */
+
+import { RelayScheduler } from '../relay';
+
+describe('RelayScheduler', () => {
+  const start = 1_700_000_000_000;
+  let now: jest.SpyInstance;
+
+  beforeEach(() => {
+    now = jest.spyOn(Date, 'now').mockReturnValue(start);
+  });
+
+  afterEach(() => {
+    now.mockRestore();
+  });
+
+  it('should weight the duplicate threshold by RSSI', () => {
+    const relay = new RelayScheduler();
+
+    expect(relay.thresholdFor(-40)).toBe(2);
+    expect(relay.thresholdFor(-70)).toBe(3);
+    expect(relay.thresholdFor(-100)).toBe(4);
+  });
+
+  it('should cancel a relay once enough duplicates are overheard', () => {
+    const relay = new RelayScheduler({ seed: 1 });
+    relay.schedule('msg-1', -40);
+
+    expect(relay.overheard('msg-1')).toBe(false);
+    expect(relay.overheard('msg-1')).toBe(true);
+    expect(relay.overheard('msg-1')).toBe(false);
+    expect(relay.release('msg-1')).toBe(false);
+    expect(relay.stats()).toMatchObject({ pending: 0, scheduled: 1, relayed: 0, suppressed: 1 });
+  });
+
+  it('should relay when too few duplicates are overheard', () => {
+    const relay = new RelayScheduler({ seed: 1 });
+    relay.schedule('msg-1', -95);
+    relay.overheard('msg-1');
+    relay.overheard('msg-1');
+
+    expect(relay.release('msg-1')).toBe(true);
+    expect(relay.stats()).toMatchObject({ relayed: 1, suppressed: 0 });
+  });
+
+  it('should draw reproducible backoffs inside the window', () => {
+    const a = new RelayScheduler({ seed: 42 });
+    const b = new RelayScheduler({ seed: 42 });
+
+    for (let i = 0; i < 50; i++) {
+      const near = a.schedule(`near-${i}`, -40);
+      const edge = a.schedule(`edge-${i}`, -95);
+      expect(b.schedule(`near-${i}`, -40)).toBe(near);
+      expect(b.schedule(`edge-${i}`, -95)).toBe(edge);
+      expect(near).toBeGreaterThanOrEqual(100);
+      expect(near).toBeLessThan(500);
+      expect(edge).toBeGreaterThanOrEqual(100);
+      expect(edge).toBeLessThan(300);
+    }
+  });
+
+  it('should relay unconditionally when the table is full', () => {
+    const relay = new RelayScheduler({ capacity: 1, seed: 1 });
+    relay.schedule('msg-1', -40);
+    relay.schedule('msg-2', -40);
+    relay.overheard('msg-2');
+    relay.overheard('msg-2');
+
+    expect(relay.release('msg-2')).toBe(true);
+    expect(relay.stats().overflowed).toBe(1);
+  });
+});
@@ -0,0 +1,66 @@
+/**
+ * Tests for the recently-seen digest
+ */
+
+import { SeenDigest, SEEN_DIGEST_BYTES } from '../seen-digest';
+
+describe('SeenDigest', () => {
+  const start = 1_769_268_000_000n;
+
+  it('should hold the keys it was given', () => {
+    const digest = new SeenDigest();
+    expect(digest.add(start)).toBe(true);
+    expect(digest.add(start + 1n)).toBe(true);
+
+    const bits = digest.bits();
+    expect(bits.length).toBe(SEEN_DIGEST_BYTES);
+    expect(digest.contains(bits, start)).toBe(true);
+    expect(digest.contains(bits, start + 1n)).toBe(true);
+    expect(digest.size).toBe(2);
+  });
+
+  it('should not count a recent key twice', () => {
+    const digest = new SeenDigest(4);
+    digest.add(42n);
+    expect(digest.add(42n)).toBe(false);
+    expect(digest.size).toBe(1);
+  });
+
+  it('should forget the oldest key once full', () => {
+    const digest = new SeenDigest(4);
+    for (let i = 0n; i < 5n; i++) {
+      digest.add(start + i * 7919n);
+    }
+
+    expect(digest.size).toBe(4);
+    expect(digest.add(start)).toBe(true);
+  });
+
+  it('should rarely claim keys it never saw', () => {
+    const digest = new SeenDigest();
+    for (let i = 0n; i < 16n; i++) {
+      digest.add(start + i);
+    }
+
+    const bits = digest.bits();
+    let falsePositives = 0;
+    for (let i = 1000n; i < 3000n; i++) {
+      if (digest.contains(bits, start + i)) falsePositives++;
+    }
+    expect(falsePositives).toBeLessThan(100);
+  });
+
+  it('should clear', () => {
+    const digest = new SeenDigest();
+    digest.add(start);
+    digest.clear();
+
+    expect(digest.size).toBe(0);
+    expect(digest.contains(digest.bits(), start)).toBe(false);
+  });
+
+  it('should reject short digests', () => {
+    const digest = new SeenDigest();
+    expect(digest.contains(Buffer.alloc(SEEN_DIGEST_BYTES - 1), start)).toBe(false);
+  });
+});
@@ -0,0 +1,72 @@
+/**
+ * Tests for the seen-message cache
+ */
+
+import { SeenMessageCache } from '../seen-messages';
+
+describe('SeenMessageCache', () => {
+  const start = 1_700_000_000_000;
+  let now: jest.SpyInstance;
+
+  beforeEach(() => {
+    now = jest.spyOn(Date, 'now').mockReturnValue(start);
+  });
+
+  afterEach(() => {
+    now.mockRestore();
+  });
+
+  it('should report whether an ID is new', () => {
+    const cache = new SeenMessageCache(1000, 64);
+
+    expect(cache.add('msg-1')).toBe(true);
+    expect(cache.add('msg-1')).toBe(false);
+    expect(cache.has('msg-1')).toBe(true);
+    expect(cache.has('msg-2')).toBe(false);
+    expect(cache.size).toBe(1);
+  });
+
+  it('should forget IDs after the window', () => {
+    const cache = new SeenMessageCache(1000, 64);
+    cache.add('msg-1');
+
+    now.mockReturnValue(start + 500);
+    expect(cache.has('msg-1')).toBe(true);
+
+    now.mockReturnValue(start + 2500);
+    expect(cache.has('msg-1')).toBe(false);
+    expect(cache.add('msg-1')).toBe(true);
+  });
+
+  it('should age a backdated ID from when it was seen', () => {
+    const cache = new SeenMessageCache(1000, 64);
+    cache.add('earlier', start - 600);
+    cache.add('now');
+
+    expect(cache.has('earlier')).toBe(true);
+    now.mockReturnValue(start + 700);
+    expect(cache.has('earlier')).toBe(false);
+    expect(cache.has('now')).toBe(true);
+  });
+
+  it('should expire IDs older than a given age', () => {
+    const cache = new SeenMessageCache(60000, 64);
+    cache.add('old');
+
+    now.mockReturnValue(start + 30000);
+    cache.add('new');
+    cache.expire(20000);
+
+    expect(cache.has('old')).toBe(false);
+    expect(cache.has('new')).toBe(true);
+  });
+
+  it('should clear all IDs', () => {
+    const cache = new SeenMessageCache(1000, 64);
+    cache.add('a');
+    cache.add('b');
+    cache.clear();
+
+    expect(cache.size).toBe(0);
+  });
+});
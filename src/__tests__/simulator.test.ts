@@ -0,0 +1,42 @@
+/**
+ * Tests for the mesh simulator binding
+ */
+
+import { loadNativeAddon } from '../native';
+import { simulateMesh } from '../simulator';
+
+jest.mock('../native', () => ({
+  loadNativeAddon: jest.fn()
+}));
+
+const mockedLoad = loadNativeAddon as jest.MockedFunction<typeof loadNativeAddon>;
+
+describe('simulateMesh', () => {
+  afterEach(() => {
+    mockedLoad.mockReset();
+  });
+
+  it('should pass options to the native simulator', async () => {
+    const report = { nodes: 50, deliveryRatio: 0.98 };
+    const native = { simulateMesh: jest.fn().mockResolvedValue(report) };
+    mockedLoad.mockReturnValue(native);
+
+    const options = { nodeCount: 50, seed: 7, relay: { maxThreshold: 3 } };
+    await expect(simulateMesh(options)).resolves.toBe(report);
+    expect(native.simulateMesh).toHaveBeenCalledWith(options);
+  });
+
+  it('should default to an empty options object', async () => {
+    const native = { simulateMesh: jest.fn().mockResolvedValue({}) };
+    mockedLoad.mockReturnValue(native);
+
+    await simulateMesh();
+    expect(native.simulateMesh).toHaveBeenCalledWith({});
+  });
+
+  it('should reject when the addon is not built', async () => {
+    mockedLoad.mockReturnValue(null);
+
+    await expect(simulateMesh()).rejects.toThrow('native addon');
+  });
+});
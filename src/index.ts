@@ -4,7 +4,7 @@
  * Main entry point for the library
  */
 
-export { MeshNode } from './mesh';
+export { MeshNode, type MeshNodeOptions } from './mesh';
 export {
   type Message,
   serializeMessage,
@@ -14,3 +14,20 @@ export {
   MAX_HOPS,
   MESSAGE_VERSION
 } from './protocol';
+export {
+  encodeMessage,
+  decodeMessage,
+  encodedMessageBound,
+  MESSAGE_CODEC_VERSION
+} from './message-codec';
+export { RelayScheduler, type RelayOptions, type RelayStats, DEFAULT_RELAY_OPTIONS } from './relay';
+export { simulateMesh, type SimulationOptions, type SimulationReport } from './simulator';
+export {
+  MessageStore,
+  messageStoreKey,
+  MESSAGE_RECORD_PAYLOAD_MAX,
+  type StoredMessage,
+  type HistoryQuery,
+  type MessageDirection
+} from './message-store';
+export { PeerTable, PeerTableMirror, PeerStream, type PeerState, type PeerStreamClient } from './peer-stream';
@@ -10,11 +10,19 @@ import {
   deserializeMessage,
   encodeToManufacturerData,
   decodeFromManufacturerData,
+  encodeDigestFrame,
+  decodeDigestFrame,
+  manufacturerMessageKey,
+  DigestFrame,
   phoneNumberMatches,
   MAX_HOPS,
   generateMessageId
 } from './protocol';
 import { logger } from './logger';
+import { SeenMessageCache, SEEN_MESSAGE_WINDOW_MS } from './seen-messages';
+import { RelayScheduler, RelayStats } from './relay';
+import { SeenDigest } from './seen-digest';
+import { MessageStore, StoredMessage, HistoryQuery } from './message-store';
 
 // Platform-specific BLE library imports
 let noble: any;
@@ -46,12 +54,28 @@ const MESSAGE_CHARACTERISTIC_UUID = '87654321876543218765432187654321';
 // BLE Advertising configuration
 const ADVERTISING_INTERVAL_MS = 100; // Advertise every 100ms
 const MESSAGE_ROTATION_MS = 2000; // Rotate through queued messages every 2 seconds
+const DIGEST_EVERY_ROTATIONS = 3; // Every third advertising update carries the recently-seen digest
 
 // Device timeout configuration
 const DEVICE_TIMEOUT_MS = 30000; // 30 seconds - device considered offline
 const DEVICE_CLEANUP_INTERVAL_MS = 5000; // Check every 5 seconds
 const DEVICE_ACTIVE_THRESHOLD_MS = 10000; // 10 seconds - recent activity
 
+export interface MeshNodeOptions {
+  /**
+   * History of the messages this node sends and receives; none is kept without one.
+   * Recent messages in it are marked seen again when the node is created.
+   */
+  store?: MessageStore;
+}
+
+interface PendingRelay {
+  message: Message;
+  key: bigint; // On-air message key, as neighbours' digests hold it
+  confirmedBy: Set<string>; // Neighbours whose digest already holds it, each counted once; the sender from the start
+  threshold: number; // Digest hits from neighbours other than the sender that cancel it
+}
+
 interface DeviceInfo {
   lastSeen: number;
   rssi: number;
@@ -62,7 +86,13 @@ interface DeviceInfo {
 
 export class MeshNode extends EventEmitter {
   private phoneNumber: string;
-  private seenMessages: Set<string> = new Set();
+  private seenMessages: SeenMessageCache = new SeenMessageCache();
+  private relayScheduler: RelayScheduler = new RelayScheduler();
+  private relayTimers: Set<NodeJS.Timeout> = new Set();
+  private seenDigest: SeenDigest = new SeenDigest();
+  private pendingRelays: Map<string, PendingRelay> = new Map();
+  private advertisedRelays: Map<string, PendingRelay> = new Map(); // Relays in messageQueue
+  private advertisingRound: number = 0;
   private messageQueue: Message[] = [];
   private isScanning: boolean = false;
   private isAdvertising: boolean = false;
@@ -70,10 +100,38 @@ export class MeshNode extends EventEmitter {
   private cleanupInterval: NodeJS.Timeout | null = null;
   private advertisingInterval: NodeJS.Timeout | null = null;
   private currentAdvertisingIndex: number = 0;
+  private store: MessageStore | null;
 
-  constructor(phoneNumber: string) {
+  constructor(phoneNumber: string, options: MeshNodeOptions = {}) {
     super();
     this.phoneNumber = phoneNumber;
+    this.store = options.store ?? null;
+    this.restoreSeenMessages();
+  }
+
+  /**
+   * Warm-start duplicate detection from the history store
+   * Messages sent or received within the seen-message window are marked seen
+   * again, so copies still circulating after a restart are neither delivered
+   * nor relayed twice, and the newest go back into the advertised digest.
+   * Each is marked seen as of when it was stored, so it ages out on the same
+   * schedule as before the restart.
+   */
+  private restoreSeenMessages(): void {
+    if (!this.store) {
+      return;
+    }
+
+    const recent = this.store.history({ from: Date.now() - SEEN_MESSAGE_WINDOW_MS });
+    // History is in message timestamp order; the cache wants local time order
+    const byStoredAt = [...recent].sort((a, b) => a.storedAt - b.storedAt);
+    for (const { message, storedAt } of byStoredAt) {
+      this.seenMessages.add(message.id, Math.min(storedAt, Date.now()));
+      this.seenDigest.add(manufacturerMessageKey(message));
+    }
+    if (recent.length > 0) {
+      logger.info(`♻️  Restored ${recent.length} recently seen messages from history`);
+    }
   }
 
   /**
@@ -106,6 +164,10 @@ export class MeshNode extends EventEmitter {
       clearInterval(this.advertisingInterval);
       this.advertisingInterval = null;
     }
+    this.relayTimers.forEach(timer => clearTimeout(timer));
+    this.relayTimers.clear();
+    this.pendingRelays.clear();
+    this.advertisedRelays.clear();
     this.emit('stopped');
   }
 
@@ -124,7 +186,9 @@ export class MeshNode extends EventEmitter {
 
     this.messageQueue.push(message);
     this.seenMessages.add(message.id);
+    this.seenDigest.add(manufacturerMessageKey(message));
     this.broadcastMessage(message);
+    this.store?.append(message, 'sent');
     this.emit('messageSent', message);
 
     return message;
@@ -295,6 +359,12 @@ export class MeshNode extends EventEmitter {
    */
   private handleManufacturerDataMessage(data: Buffer, rssi: number, deviceId: string): void {
     try {
+      const digestFrame = decodeDigestFrame(data);
+      if (digestFrame) {
+        this.handleDigestFrame(digestFrame, deviceId);
+        return;
+      }
+
       // Decode compact manufacturer data format
       const message = decodeFromManufacturerData(data);
 
@@ -313,13 +383,43 @@ export class MeshNode extends EventEmitter {
       });
 
       // Process the received message
-      this.processReceivedMessage(message);
+      this.processReceivedMessage(message, rssi, deviceId);
 
     } catch (error) {
       logger.debug('Error parsing manufacturer data:', error);
     }
   }
 
+  /**
+   * Merge a neighbour's recently-seen digest into pending relay decisions
+   * A neighbour already holding a message counts as an overheard copy, once per
+   * neighbour; its relay is cancelled at the same threshold as for duplicates.
+   * The node we got the message from holds it by definition and never counts.
+   */
+  private handleDigestFrame(frame: DigestFrame, deviceId: string): void {
+    for (const [id, pending] of this.pendingRelays) {
+      if (pending.confirmedBy.has(deviceId) || !this.seenDigest.contains(frame.digest, pending.key)) {
+        continue;
+      }
+      pending.confirmedBy.add(deviceId);
+      if (this.relayScheduler.overheard(id)) {
+        logger.info(`🤫 Suppressed relay of ${id} (neighbours' digests already hold it)`);
+        this.emit('relaySuppressed', pending.message);
+      }
+    }
+
+    // Stop re-advertising a relay once as many other neighbours hold it as would have cancelled it
+    for (const [id, relay] of this.advertisedRelays) {
+      if (relay.confirmedBy.has(deviceId) || !this.seenDigest.contains(frame.digest, relay.key)) {
+        continue;
+      }
+      relay.confirmedBy.add(deviceId);
+      if (relay.confirmedBy.size - 1 >= relay.threshold) {
+        this.removeFromAdvertisingQueue(id);
+      }
+    }
+  }
+
   /**
    * Handle received message from advertising data
    */
@@ -349,7 +449,7 @@ export class MeshNode extends EventEmitter {
       });
 
       // Process the received message
-      this.processReceivedMessage(message);
+      this.processReceivedMessage(message, rssi, deviceId);
 
     } catch (error) {
       logger.debug('Error parsing advertising data:', error);
@@ -359,38 +459,58 @@ export class MeshNode extends EventEmitter {
   /**
    * Process received message (check if for us, relay if needed)
    */
-  private processReceivedMessage(message: Message): void {
-    // Check if we've already seen this message (prevent loops)
-    if (this.seenMessages.has(message.id)) {
+  private processReceivedMessage(message: Message, rssi: number, deviceId: string): void {
+    // Check if we've already seen this message (prevent loops); marks it seen otherwise
+    if (!this.seenMessages.add(message.id)) {
       logger.debug(`Duplicate message ${message.id}, skipping`);
 
+      // Enough neighbours rebroadcast it while our relay was waiting: stay quiet
+      if (this.relayScheduler.overheard(message.id)) {
+        logger.info(`🤫 Suppressed relay of ${message.id} (overheard enough copies)`);
+        this.emit('relaySuppressed', message);
+      }
+
       // Remove from advertising queue since another node is relaying it
       this.removeFromAdvertisingQueue(message.id);
 
       return;
     }
-
-    // Mark as seen
-    this.seenMessages.add(message.id);
+    this.seenDigest.add(manufacturerMessageKey(message));
 
     // Check if message is for us or broadcast
     const isForUs = phoneNumberMatches(this.phoneNumber, message.to) || message.to === 'BROADCAST';
 
     if (isForUs) {
       logger.success(`✅ Message is for us: ${message.id}`);
+      this.store?.append(message, 'received');
       this.emit('messageReceived', message);
     } else {
       logger.debug(`Message ${message.id} is for ${message.to}, not us`);
     }
 
-    // Auto-relay if hops remaining
+    // Auto-relay if hops remaining, after a random backoff (shorter at the edge of
+    // range) unless duplicates overheard meanwhile show the area is already covered
     if (message.hops < MAX_HOPS) {
       const relayMessage = { ...message, hops: message.hops + 1 };
-      setTimeout(() => {
+      const pending: PendingRelay = {
+        message,
+        key: manufacturerMessageKey(message),
+        confirmedBy: new Set([deviceId]),
+        threshold: this.relayScheduler.thresholdFor(rssi)
+      };
+      this.pendingRelays.set(message.id, pending);
+      const timer = setTimeout(() => {
+        this.relayTimers.delete(timer);
+        this.pendingRelays.delete(message.id);
+        if (!this.relayScheduler.release(message.id)) {
+          return;
+        }
+        this.advertisedRelays.set(message.id, pending);
         this.broadcastMessage(relayMessage);
         this.emit('messageRelayed', relayMessage);
         logger.info(`🔄 Relaying message ${message.id} (hop ${relayMessage.hops})`);
-      }, 100 + Math.random() * 400); // Random delay to reduce collisions
+      }, this.relayScheduler.schedule(message.id, rssi));
+      this.relayTimers.add(timer);
     }
   }
 
@@ -403,7 +523,7 @@ export class MeshNode extends EventEmitter {
 
     // Keep queue size manageable (last 10 messages)
     if (this.messageQueue.length > 10) {
-      this.messageQueue.shift();
+      this.advertisedRelays.delete(this.messageQueue.shift()!.id);
     }
 
     // Immediately update advertising data with new message
@@ -421,6 +541,7 @@ export class MeshNode extends EventEmitter {
   private removeFromAdvertisingQueue(messageId: string): void {
     const beforeLength = this.messageQueue.length;
     this.messageQueue = this.messageQueue.filter(msg => msg.id !== messageId);
+    this.advertisedRelays.delete(messageId);
 
     if (this.messageQueue.length < beforeLength) {
       logger.info(`🛑 Stopped advertising message ${messageId.substring(0, 8)}... (confirmed relayed by another node)`);
@@ -505,8 +626,13 @@ export class MeshNode extends EventEmitter {
     }
 
     let manufacturerData: Buffer;
+    const digestTurn = ++this.advertisingRound % DIGEST_EVERY_ROTATIONS === 0 && this.seenDigest.size > 0;
 
-    if (this.messageQueue.length > 0) {
+    if (digestTurn) {
+      // Tell neighbours what we already hold, so they can skip relaying it
+      manufacturerData = encodeDigestFrame(this.seenDigest.bits(), this.seenDigest.size);
+      logger.debug(`Broadcasting recently-seen digest (${this.seenDigest.size} messages)`);
+    } else if (this.messageQueue.length > 0) {
       // Rotate through messages
       this.currentAdvertisingIndex = (this.currentAdvertisingIndex + 1) % this.messageQueue.length;
       const message = this.messageQueue[this.currentAdvertisingIndex];
@@ -590,6 +716,20 @@ export class MeshNode extends EventEmitter {
     return this.phoneNumber;
   }
 
+  /**
+   * Relay scheduler counters (scheduled, relayed, suppressed, ...)
+   */
+  getRelayStats(): RelayStats {
+    return this.relayScheduler.stats();
+  }
+
+  /**
+   * Stored messages in timestamp order (by default all of them); empty without a store
+   */
+  getHistory(query: HistoryQuery = {}): StoredMessage[] {
+    return this.store?.history(query) ?? [];
+  }
+
   /**
    * Get seen messages count
    */
@@ -598,22 +738,11 @@ export class MeshNode extends EventEmitter {
   }
 
   /**
-   * Clear old seen messages to prevent memory growth
+   * Forget seen messages older than `olderThan` ms
+   * (the cache also ages entries out on its own after its window)
    */
   clearOldSeenMessages(olderThan: number = 3600000): void {
-    const cutoff = Date.now() - olderThan;
-    const messagesToRemove: string[] = [];
-
-    // Note: This is a simple implementation. In production, you'd want to
-    // store timestamps with message IDs for proper cleanup
-    if (this.seenMessages.size > 1000) {
-      const messages = Array.from(this.seenMessages);
-      // Remove oldest half
-      for (let i = 0; i < messages.length / 2; i++) {
-        messagesToRemove.push(messages[i]);
-      }
-      messagesToRemove.forEach(id => this.seenMessages.delete(id));
-    }
+    this.seenMessages.expire(olderThan);
   }
 
   /**
@@ -0,0 +1,398 @@
+/**
+ * Compact binary message codec
+ * Encodes a Message as the version-2 frame described in
+ * native-ble/cpp/message_codec.h: varint hops and timestamps, phone numbers
+ * packed two digits per byte, generated IDs as numbers, and a GPS fix in the
+ * content stored as float32 latitude + 24-bit longitude. Uses the native
+ * codec when the addon is available, otherwise this byte-identical TypeScript
+ * implementation.
+ */
+
+import type { Message } from './protocol';
+import { loadNativeAddon } from './native';
+
+export const MESSAGE_CODEC_VERSION = 2;
+
+// Frame bytes beyond the UTF-8 lengths of to, from, id and content
+export const MESSAGE_FRAME_OVERHEAD = 64;
+
+const FLAG_GPS = 0x04;
+const FLAG_FLOAT_TIMESTAMP = 0x08;
+const FLAG_RESERVED = 0xf0;
+
+const TYPE_TEXT = 0;
+const TYPE_SOS = 1;
+const TYPE_GPS = 2;
+const TYPE_BROADCAST = 3;
+
+const ADDRESS_TEXT = 0x00;
+const ADDRESS_BROADCAST = 0x01;
+const ADDRESS_DIGITS = 0x80;
+const ADDRESS_PLUS = 0x40;
+
+const ID_TEXT = 0x00;
+const ID_GENERATED = 0x02;
+const ID_MAX_SUFFIX = 12;
+
+const LONGITUDE_SCALE = 46603.7;
+const LONGITUDE_MAX = 0xffffff;
+
+const BROADCAST = 'BROADCAST';
+const PHONE_NUMBER = /^\+?\d{1,31}$/;
+const GENERATED_ID = /^(0|[1-9]\d{0,15})-([0-9a-z]{1,12})$/;
+// ASCII whitespace only, so both implementations find the same fix
+const GPS_FIX = /GPS:[ \t\n\v\f\r]*([-\d.]+),[ \t\n\v\f\r]*([-\d.]+)/;
+
+class FrameWriter {
+  ok = true;
+
+  constructor(private readonly out: Uint8Array, public pos: number) {}
+
+  byte(value: number): void {
+    if (this.pos >= this.out.length) {
+      this.ok = false;
+      return;
+    }
+    this.out[this.pos++] = value;
+  }
+
+  bytes(data: Uint8Array): void {
+    if (data.length > this.out.length - this.pos) {
+      this.ok = false;
+      return;
+    }
+    this.out.set(data, this.pos);
+    this.pos += data.length;
+  }
+
+  // Safe integers only; see bigVarint for 64-bit values
+  varint(value: number): void {
+    while (value >= 0x80) {
+      this.byte((value % 0x80) | 0x80);
+      value = Math.floor(value / 0x80);
+    }
+    this.byte(value);
+  }
+
+  bigVarint(value: bigint): void {
+    while (value >= 0x80n) {
+      this.byte(Number(value & 0x7fn) | 0x80);
+      value >>= 7n;
+    }
+    this.byte(Number(value));
+  }
+
+  text(data: Uint8Array): void {
+    this.varint(data.length);
+    this.bytes(data);
+  }
+}
+
+class FrameReader {
+  ok = true;
+
+  constructor(private readonly buf: Uint8Array, public pos: number) {}
+
+  byte(): number {
+    if (this.pos >= this.buf.length) {
+      this.ok = false;
+      return 0;
+    }
+    return this.buf[this.pos++];
+  }
+
+  bytes(count: number): Uint8Array {
+    if (count > this.buf.length - this.pos) {
+      this.ok = false;
+      return new Uint8Array(0);
+    }
+    const view = this.buf.subarray(this.pos, this.pos + count);
+    this.pos += count;
+    return view;
+  }
+
+  bigVarint(): bigint {
+    let value = 0n;
+    for (let shift = 0n; shift < 64n; shift += 7n) {
+      const b = this.byte();
+      if (!this.ok || (shift === 63n && b > 1)) {
+        break;
+      }
+      value |= BigInt(b & 0x7f) << shift;
+      if ((b & 0x80) === 0) {
+        return value;
+      }
+    }
+    this.ok = false;
+    return 0n;
+  }
+
+  // Values beyond Number.MAX_SAFE_INTEGER are rejected
+  varint(): number {
+    const value = this.bigVarint();
+    if (value > BigInt(Number.MAX_SAFE_INTEGER)) {
+      this.ok = false;
+      return 0;
+    }
+    return Number(value);
+  }
+
+  text(): string {
+    const n = this.varint();
+    return this.ok ? utf8(this.bytes(n)) : '';
+  }
+}
+
+function utf8(bytes: Uint8Array): string {
+  return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.length).toString('utf8');
+}
+
+function bigVarintSize(value: bigint): number {
+  let n = 1;
+  while (value >= 0x80n) {
+    value >>= 7n;
+    n++;
+  }
+  return n;
+}
+
+/**
+ * MessageCodecType of a message (0 text, 1 SOS, 2 GPS, 3 broadcast), as stored in its frame
+ */
+export function detectType(message: Message): number {
+  if (message.to === BROADCAST) return TYPE_BROADCAST;
+  if (message.content.includes('🆘') || /sos/i.test(message.content)) return TYPE_SOS;
+  if (message.content.includes('GPS:')) return TYPE_GPS;
+  return TYPE_TEXT;
+}
+
+function writeAddress(w: FrameWriter, address: string): void {
+  if (address === BROADCAST) {
+    w.byte(ADDRESS_BROADCAST);
+    return;
+  }
+  if (!PHONE_NUMBER.test(address)) {
+    w.byte(ADDRESS_TEXT);
+    w.text(Buffer.from(address, 'utf8'));
+    return;
+  }
+
+  const plus = address[0] === '+';
+  const digits = plus ? address.slice(1) : address;
+  w.byte(ADDRESS_DIGITS | (plus ? ADDRESS_PLUS : 0) | digits.length);
+  for (let i = 0; i < digits.length; i += 2) {
+    const lo = i + 1 < digits.length ? digits.charCodeAt(i + 1) - 48 : 0x0f;
+    w.byte(((digits.charCodeAt(i) - 48) << 4) | lo);
+  }
+}
+
+function readAddress(r: FrameReader): string {
+  const header = r.byte();
+  if (!r.ok) return '';
+  if (header === ADDRESS_TEXT) return r.text();
+  if (header === ADDRESS_BROADCAST) return BROADCAST;
+
+  const digits = header & 0x1f;
+  if ((header & 0xa0) !== ADDRESS_DIGITS || digits === 0) {
+    r.ok = false;
+    return '';
+  }
+  const packed = r.bytes((digits + 1) >> 1);
+  let out = header & ADDRESS_PLUS ? '+' : '';
+  for (let i = 0; r.ok && i < digits; i++) {
+    const nibble = i % 2 === 0 ? packed[i >> 1] >> 4 : packed[i >> 1] & 0x0f;
+    if (nibble > 9) {
+      r.ok = false;
+    }
+    out += String.fromCharCode(48 + nibble);
+  }
+  if (r.ok && digits % 2 === 1 && (packed[digits >> 1] & 0x0f) !== 0x0f) {
+    r.ok = false;
+  }
+  return out;
+}
+
+function writeId(w: FrameWriter, id: string, base: number): void {
+  const text = Buffer.from(id, 'utf8');
+  const match = GENERATED_ID.exec(id);
+  if (match && Number(match[1]) <= Number.MAX_SAFE_INTEGER) {
+    const delta = BigInt(match[1]) - BigInt(base);
+    const zigzag = delta >= 0n ? delta << 1n : ((-delta) << 1n) - 1n;
+    let suffix = 0n;
+    for (const c of match[2]) {
+      suffix = suffix * 36n + BigInt(parseInt(c, 36));
+    }
+    let textSize = 1 + text.length;
+    for (let n = text.length; n >= 0x80; n = Math.floor(n / 0x80)) textSize++;
+    if (2 + bigVarintSize(zigzag) + bigVarintSize(suffix) <= textSize) {
+      w.byte(ID_GENERATED);
+      w.bigVarint(zigzag);
+      w.byte(match[2].length);
+      w.bigVarint(suffix);
+      return;
+    }
+  }
+  w.byte(ID_TEXT);
+  w.text(text);
+}
+
+function readId(r: FrameReader, base: number): string {
+  const header = r.byte();
+  if (!r.ok) return '';
+  if (header === ID_TEXT) return r.text();
+  if (header !== ID_GENERATED) {
+    r.ok = false;
+    return '';
+  }
+  const zigzag = r.bigVarint();
+  const ms = BigInt(base) + (zigzag & 1n ? -((zigzag + 1n) >> 1n) : zigzag >> 1n);
+  const suffixLength = r.byte();
+  const suffix = r.bigVarint().toString(36);
+  if (!r.ok || ms < 0n || ms > BigInt(Number.MAX_SAFE_INTEGER) || suffixLength === 0 ||
+      suffixLength > ID_MAX_SUFFIX || suffix.length > suffixLength) {
+    r.ok = false;
+    return '';
+  }
+  return `${ms}-${suffix.padStart(suffixLength, '0')}`;
+}
+
+function validate(message: Message): void {
+  if (typeof message.to !== 'string' || typeof message.from !== 'string' ||
+      typeof message.content !== 'string' || typeof message.id !== 'string') {
+    throw new TypeError('Message to, from, content and id must be strings');
+  }
+  if (typeof message.timestamp !== 'number' || !Number.isSafeInteger(message.hops) || message.hops < 0) {
+    throw new TypeError('Message timestamp must be a number and hops a non-negative integer');
+  }
+}
+
+function encodeFrame(message: Message, out: Uint8Array, offset: number): number {
+  validate(message);
+  const w = new FrameWriter(out, offset);
+
+  const match = GPS_FIX.exec(message.content);
+  const lat = match ? parseFloat(match[1]) : NaN;
+  const lon = match ? parseFloat(match[2]) : NaN;
+  const gps = lat >= -90 && lat <= 90 && lon >= -180 && lon <= 180;
+
+  const ts = message.timestamp;
+  const varintTimestamp = Number.isSafeInteger(ts) && ts >= 0;
+  w.byte(MESSAGE_CODEC_VERSION);
+  w.byte(detectType(message) | (gps ? FLAG_GPS : 0) | (varintTimestamp ? 0 : FLAG_FLOAT_TIMESTAMP));
+  w.varint(message.hops);
+  if (varintTimestamp) {
+    w.varint(ts);
+  } else {
+    const f64 = new Uint8Array(8);
+    new DataView(f64.buffer).setFloat64(0, ts, true);
+    w.bytes(f64);
+  }
+  writeAddress(w, message.to);
+  writeAddress(w, message.from);
+  writeId(w, message.id, varintTimestamp ? ts : 0);
+
+  if (!gps || !match) {
+    w.text(Buffer.from(message.content, 'utf8'));
+    return w.ok ? w.pos - offset : 0;
+  }
+
+  const before = message.content.slice(0, match.index);
+  const after = message.content.slice(match.index + match[0].length);
+  const at = Buffer.byteLength(before, 'utf8');
+  w.text(Buffer.from(before + after, 'utf8'));
+  w.varint(at);
+  const trailer = new Uint8Array(7);
+  const view = new DataView(trailer.buffer);
+  view.setFloat32(0, lat === 0 ? 0 : lat, true);
+  const longitude = Math.max(0, Math.min(LONGITUDE_MAX, Math.round((lon + 180) * LONGITUDE_SCALE)));
+  view.setUint16(4, longitude & 0xffff, true);
+  view.setUint8(6, longitude >>> 16);
+  w.bytes(trailer);
+  return w.ok ? w.pos - offset : 0;
+}
+
+function decodeFrame(buf: Uint8Array, offset: number): Message | null {
+  const r = new FrameReader(buf, offset);
+  if (r.byte() !== MESSAGE_CODEC_VERSION) return null;
+  const flags = r.byte();
+  if (!r.ok || (flags & FLAG_RESERVED) !== 0) return null;
+
+  const hops = r.varint();
+  let timestamp: number;
+  let base = 0;
+  if (flags & FLAG_FLOAT_TIMESTAMP) {
+    const f64 = r.bytes(8);
+    if (!r.ok) return null;
+    timestamp = new DataView(f64.buffer, f64.byteOffset, 8).getFloat64(0, true);
+  } else {
+    base = r.varint();
+    timestamp = base;
+  }
+  const to = readAddress(r);
+  const from = readAddress(r);
+  const id = readId(r, base);
+  const length = r.varint();
+  const content = r.bytes(length);
+  if (!r.ok) return null;
+
+  if (!(flags & FLAG_GPS)) {
+    return { to, from, content: utf8(content), id, timestamp, hops };
+  }
+  const at = r.varint();
+  const trailer = r.bytes(7);
+  if (!r.ok || at > content.length) return null;
+  const view = new DataView(trailer.buffer, trailer.byteOffset, 7);
+  const lat = view.getFloat32(0, true);
+  // Encoders only write valid fixes; NaN or out of range is a crafted frame
+  if (!(lat >= -90 && lat <= 90)) return null;
+  const lon = (view.getUint16(4, true) | (view.getUint8(6) << 16)) / LONGITUDE_SCALE - 180;
+  const fix = Buffer.from(`GPS: ${lat.toFixed(6)}, ${lon.toFixed(6)}`, 'utf8');
+  return {
+    to,
+    from,
+    content: utf8(Buffer.concat([content.subarray(0, at), fix, content.subarray(at)])),
+    id,
+    timestamp,
+    hops
+  };
+}
+
+/**
+ * Bytes to reserve for encodeMessage()
+ */
+export function encodedMessageBound(message: Message): number {
+  return MESSAGE_FRAME_OVERHEAD + Buffer.byteLength(message.to, 'utf8') + Buffer.byteLength(message.from, 'utf8') +
+    Buffer.byteLength(message.id, 'utf8') + Buffer.byteLength(message.content, 'utf8');
+}
+
+/**
+ * Encode a message into `out` at `offset`
+ * Returns the frame length, or 0 if it does not fit
+ * @throws {TypeError} If the message has the wrong shape
+ */
+export function encodeMessage(message: Message, out: Uint8Array, offset: number = 0): number {
+  const native = loadNativeAddon();
+  if (native?.encodeMessage) {
+    return native.encodeMessage(message, out, offset);
+  }
+  if (offset > out.length) {
+    throw new RangeError('Offset is outside the buffer');
+  }
+  return encodeFrame(message, out, offset);
+}
+
+/**
+ * Decode the frame at `offset`; null if the bytes are not a valid frame
+ * A GPS fix comes back quantized (float32 latitude, ~2.4 m longitude) and
+ * rendered as `GPS: <lat>, <lon>` with six decimals; every other field is exact
+ */
+export function decodeMessage(buf: Uint8Array, offset: number = 0): Message | null {
+  const native = loadNativeAddon();
+  if (native?.decodeMessage) {
+    return native.decodeMessage(buf, offset);
+  }
+  if (offset > buf.length) {
+    throw new RangeError('Offset is outside the buffer');
+  }
+  return decodeFrame(buf, offset);
+}
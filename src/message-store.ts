@@ -0,0 +1,270 @@
+/**
+ * Persistent message history
+ * Appends every message a node sends or receives to the native memory-mapped
+ * log (native-ble/cpp/message_store.h), where it survives restarts and is
+ * reopened without replay. Messages are stored as message-codec frames under
+ * the same 40-bit sender / 12-bit message key mesh packets carry, indexed by
+ * key and by timestamp. Without the addon the history lives in memory only.
+ */
+
+import type { Message } from './protocol';
+import { loadNativeAddon } from './native';
+import { encodeMessage, decodeMessage, detectType } from './message-codec';
+import { logger } from './logger';
+
+// Bytes of message-codec frame one record holds (kMessageRecordPayloadMax)
+export const MESSAGE_RECORD_PAYLOAD_MAX = 224;
+
+// Records a new store has room for before its files first grow
+export const MESSAGE_STORE_CAPACITY = 1024;
+
+const SRC_ID_DIGITS = 12;
+const MESSAGE_ID_MASK = 0xfff;
+const MAX_RECORD_HOPS = 0xff;
+
+export type MessageDirection = 'received' | 'sent';
+
+const DIRECTION_RECEIVED = 0;
+const DIRECTION_SENT = 1;
+
+export interface StoredMessage {
+  message: Message;
+  direction: MessageDirection;
+  storedAt: number;
+}
+
+export interface HistoryQuery {
+  /** Oldest message timestamp to include (ms, inclusive; default 0) */
+  from?: number;
+  /** Message timestamp to stop before (ms, exclusive; default no limit) */
+  to?: number;
+  /** Most messages to return */
+  limit?: number;
+  /** With a limit, keep the newest messages instead of the oldest (default true) */
+  newest?: boolean;
+}
+
+/**
+ * One record as the native MessageStore takes and returns it
+ */
+interface StoreRecord {
+  srcId: number;
+  messageId: number;
+  timestamp: number;
+  direction: number;
+  type: number;
+  hops: number;
+  payload: Uint8Array;
+  storedAt?: number;
+}
+
+function fnv1a(text: string, basis: number): number {
+  let hash = basis;
+  for (let i = 0; i < text.length; i++) {
+    hash ^= text.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193) >>> 0;
+  }
+  return hash;
+}
+
+/**
+ * Store key of a message: the sender's last 12 digits (or a 40-bit hash of a
+ * non-numeric sender) and 12 bits of a hash of the message ID
+ */
+export function messageStoreKey(message: Pick<Message, 'from' | 'id'>): { srcId: number; messageId: number } {
+  const digits = message.from.replace(/^\+/, '');
+  const srcId = /^\d+$/.test(digits)
+    ? Number(digits.slice(-SRC_ID_DIGITS))
+    : fnv1a(message.from, 0x811c9dc5) * 0x100 + (fnv1a(message.from, 0x050c5d1f) & 0xff);
+  return { srcId, messageId: fnv1a(message.id, 0x811c9dc5) & MESSAGE_ID_MASK };
+}
+
+/**
+ * In-memory stand-in for the native MessageStore, with the same methods
+ */
+class MemoryRecordLog {
+  private byTime: Required<StoreRecord>[] = [];
+  private byKey: Map<number, Required<StoreRecord>[]> = new Map();
+
+  append(record: StoreRecord, storedAt: number = Date.now()): boolean {
+    if (record.payload.length > MESSAGE_RECORD_PAYLOAD_MAX) {
+      throw new RangeError(
+        `Payload of ${record.payload.length} bytes exceeds the ${MESSAGE_RECORD_PAYLOAD_MAX} byte record limit`
+      );
+    }
+    const key = record.srcId * (MESSAGE_ID_MASK + 1) + record.messageId;
+    const matches = this.byKey.get(key) ?? [];
+    if (matches.some(stored => stored.timestamp === record.timestamp)) {
+      return false;
+    }
+
+    const stored = {
+      ...record,
+      hops: Math.min(record.hops, MAX_RECORD_HOPS),
+      payload: Buffer.from(record.payload),
+      storedAt,
+    };
+    matches.push(stored);
+    this.byKey.set(key, matches);
+    this.byTime.splice(this.upperBound(record.timestamp), 0, stored);
+    return true;
+  }
+
+  find(srcId: number, messageId: number): StoreRecord[] {
+    return this.byKey.get(srcId * (MESSAGE_ID_MASK + 1) + messageId) ?? [];
+  }
+
+  range(fromMs: number, toMs: number, limit?: number, newest?: boolean): StoreRecord[] {
+    if (!(fromMs < toMs)) {
+      return [];
+    }
+    let first = this.lowerBound(fromMs);
+    let last = this.lowerBound(toMs);
+    if (limit !== undefined && last - first > limit) {
+      if (newest) {
+        first = last - limit;
+      } else {
+        last = first + limit;
+      }
+    }
+    return this.byTime.slice(first, last);
+  }
+
+  count(): number {
+    return this.byTime.length;
+  }
+
+  sync(): void {}
+
+  close(): void {
+    this.byTime = [];
+    this.byKey.clear();
+  }
+
+  private lowerBound(timestamp: number): number {
+    let lo = 0;
+    let hi = this.byTime.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1;
+      if (this.byTime[mid].timestamp < timestamp) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
+
+  private upperBound(timestamp: number): number {
+    let lo = 0;
+    let hi = this.byTime.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1;
+      if (this.byTime[mid].timestamp <= timestamp) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
+}
+
+export class MessageStore {
+  /**
+   * Whether messages are written to disk (the native addon is available)
+   */
+  readonly persistent: boolean;
+
+  private readonly impl: any;
+  private readonly frame = new Uint8Array(MESSAGE_RECORD_PAYLOAD_MAX);
+
+  /**
+   * Open or create the store at `path` (its index is `path + '.idx'`);
+   * without a path, or without the addon, history is kept in memory
+   * @throws {Error} If the files exist but cannot be mapped or are not a message store
+   */
+  constructor(path?: string, capacity: number = MESSAGE_STORE_CAPACITY) {
+    const native = path ? loadNativeAddon() : null;
+    if (native?.MessageStore) {
+      this.impl = new native.MessageStore(path, capacity);
+      this.persistent = true;
+    } else {
+      if (path) {
+        logger.warn(`Native addon unavailable: message history for ${path} is kept in memory only`);
+      }
+      this.impl = new MemoryRecordLog();
+      this.persistent = false;
+    }
+  }
+
+  /**
+   * Record a message; returns false if it is already stored (a relayed copy)
+   * or its frame is larger than one record
+   */
+  append(message: Message, direction: MessageDirection = 'received'): boolean {
+    let length: number;
+    try {
+      length = encodeMessage(message, this.frame, 0);
+    } catch (error) {
+      logger.debug(`Not storing malformed message ${message.id}:`, error);
+      return false;
+    }
+    if (length === 0) {
+      logger.warn(`Message ${message.id} is too long for the history store, not stored`);
+      return false;
+    }
+
+    return this.impl.append({
+      ...messageStoreKey(message),
+      timestamp: message.timestamp,
+      direction: direction === 'sent' ? DIRECTION_SENT : DIRECTION_RECEIVED,
+      type: detectType(message),
+      hops: message.hops,
+      payload: this.frame.subarray(0, length),
+    });
+  }
+
+  /**
+   * Stored copies of one message, by sender and ID
+   */
+  find(message: Pick<Message, 'from' | 'id'>): StoredMessage[] {
+    const { srcId, messageId } = messageStoreKey(message);
+    return this.decode(this.impl.find(srcId, messageId)).filter(stored => stored.message.id === message.id);
+  }
+
+  /**
+   * Messages in timestamp order, by default the newest `limit` of all history
+   */
+  history(query: HistoryQuery = {}): StoredMessage[] {
+    const { from = 0, to = Infinity, limit, newest = true } = query;
+    return this.decode(this.impl.range(from, to, limit, newest));
+  }
+
+  /**
+   * Number of stored messages
+   */
+  get size(): number {
+    return this.impl.count();
+  }
+
+  /**
+   * Flush to disk now instead of when the OS writes the pages back
+   */
+  sync(): void {
+    this.impl.sync();
+  }
+
+  close(): void {
+    this.impl.close();
+  }
+
+  private decode(records: StoreRecord[]): StoredMessage[] {
+    const out: StoredMessage[] = [];
+    for (const record of records) {
+      const message = decodeMessage(record.payload);
+      if (message) {
+        out.push({
+          message,
+          direction: record.direction === DIRECTION_SENT ? 'sent' : 'received',
+          storedAt: record.storedAt!,
+        });
+      }
+    }
+    return out;
+  }
+}
@@ -0,0 +1,48 @@
+/**
+ * Optional native addon loader
+ * Resolves the GhostMesh native module (native-ble) when it has been built,
+ * so hot paths can move into C++ while everything keeps a TypeScript fallback.
+ */
+
+import { logger } from './logger';
+
+// Same order as native-ble/src/addon.ts: the prebuilt binary for this platform first
+const ADDON_PATHS = [
+  `../native-ble/prebuilds/${process.platform}-${process.arch}/native_ble.node`,
+  '../native-ble/build/Release/native_ble.node',
+  '../native-ble/build/Debug/native_ble.node'
+];
+
+// GHOSTMESH_NATIVE_BLE_ADDON (a full path to a .node file) comes before them all
+function addonPaths(): string[] {
+  const override = process.env.GHOSTMESH_NATIVE_BLE_ADDON;
+  return override ? [override, ...ADDON_PATHS] : ADDON_PATHS;
+}
+
+let addon: any | null | undefined;
+
+/**
+ * Load the native addon once; returns null when it is not available
+ * (not built, wrong platform, or disabled with GHOST_MESH_NO_NATIVE=1)
+ */
+export function loadNativeAddon(): any | null {
+  if (addon !== undefined) {
+    return addon;
+  }
+
+  addon = null;
+  if (process.env.GHOST_MESH_NO_NATIVE === '1') {
+    return addon;
+  }
+
+  for (const path of addonPaths()) {
+    try {
+      addon = require(path);
+      logger.debug(`Loaded native addon from ${path}`);
+      break;
+    } catch {
+      // Try the next build flavour
+    }
+  }
+  return addon;
+}
@@ -0,0 +1,401 @@
+/**
+ * Binary peer-table stream
+ * Keeps the server's view of nearby BLE devices as a versioned slot table and
+ * sends each dashboard client only what changed since its last frame, packed
+ * into one binary WebSocket frame per tick. Congested clients skip ticks, so
+ * intermediate device updates are dropped and the next frame carries the
+ * latest state. Decodes with PeerTableMirror on the browser side; uses only
+ * DataView and TextEncoder so it runs in both.
+ *
+ * Frame layout (little-endian):
+ * - 24-byte header: type (1), flags, upsert count (u16), removal count (u16),
+ *   active peers (u16), total peers (u16), reserved (u16),
+ *   table version (u32), timestamp (float64, ms epoch)
+ * - upserts, 12 bytes each: slot (u16), flags, RSSI (int8), age of lastSeen
+ *   in ms (u32), activity count (u32); followed by an id (u8 length + UTF-8)
+ *   when PEER_HAS_ID is set
+ * - removals: slot (u16) each, applied before the upserts
+ */
+
+export const PEER_FRAME_DELTA = 1;
+
+// Frame flag: the client must drop its table before applying the upserts
+export const PEER_FRAME_RESET = 0x01;
+
+// Record flags
+export const PEER_HAS_ID = 0x01;
+export const PEER_ACTIVE = 0x02;
+
+export const PEER_FRAME_HEADER_SIZE = 24;
+export const PEER_RECORD_SIZE = 12;
+
+// Slots are u16 on the wire
+export const PEER_TABLE_CAPACITY = 65535;
+
+// Frames per second per client
+export const PEER_STREAM_RATE = 10;
+
+// Bytes a client may have unsent before its device frames are skipped
+export const PEER_STREAM_HIGH_WATER = 256 * 1024;
+
+// Removals kept for clients that have not caught up; laggards beyond it get a reset
+const TOMBSTONE_LIMIT = 4096;
+
+export interface PeerState {
+  id: string;
+  rssi: number;
+  lastSeen: number;
+  activityCount: number;
+  active: boolean;
+}
+
+interface Slot extends PeerState {
+  version: number; // Table version of the latest change
+  created: number; // Table version when this peer took the slot
+}
+
+interface Tombstone {
+  slot: number;
+  version: number;
+}
+
+const encoder = new TextEncoder();
+const decoder = new TextDecoder();
+
+/**
+ * Server-side peer table with change versions for delta encoding
+ */
+export class PeerTable {
+  private readonly slots: Array<Slot | null> = [];
+  private readonly index = new Map<string, number>();
+  private readonly free: number[] = [];
+  private tombstones: Tombstone[] = [];
+  private oldestTombstone = 0; // Versions at or below this may have lost removals
+  private _version = 0;
+  private active = 0;
+
+  get version(): number {
+    return this._version;
+  }
+
+  get size(): number {
+    return this.index.size;
+  }
+
+  get activeCount(): number {
+    return this.active;
+  }
+
+  /**
+   * Record a report from a device; returns false when the table is full
+   */
+  seen(id: string, rssi: number, now: number = Date.now()): boolean {
+    const existing = this.index.get(id);
+    if (existing !== undefined) {
+      const slot = this.slots[existing]!;
+      slot.rssi = rssi;
+      slot.lastSeen = now;
+      slot.activityCount++;
+      this.setActive(slot, true);
+      slot.version = ++this._version;
+      return true;
+    }
+
+    const number = this.free.length > 0 ? this.free.pop()! : this.slots.length;
+    if (number >= PEER_TABLE_CAPACITY) {
+      return false;
+    }
+    const version = ++this._version;
+    this.slots[number] = { id, rssi, lastSeen: now, activityCount: 1, active: true, version, created: version };
+    this.index.set(id, number);
+    this.active++;
+    return true;
+  }
+
+  /**
+   * Mark a device as no longer recently seen
+   */
+  inactive(id: string): void {
+    const number = this.index.get(id);
+    if (number === undefined) {
+      return;
+    }
+    const slot = this.slots[number]!;
+    if (slot.active) {
+      this.setActive(slot, false);
+      slot.version = ++this._version;
+    }
+  }
+
+  remove(id: string): void {
+    const number = this.index.get(id);
+    if (number === undefined) {
+      return;
+    }
+    this.setActive(this.slots[number]!, false);
+    this.slots[number] = null;
+    this.index.delete(id);
+    this.free.push(number);
+    this.tombstones.push({ slot: number, version: ++this._version });
+    if (this.tombstones.length > TOMBSTONE_LIMIT) {
+      this.oldestTombstone = this.tombstones.shift()!.version;
+    }
+  }
+
+  /**
+   * Remove every peer (a new mesh session starts from an empty table)
+   */
+  clear(): void {
+    Array.from(this.index.keys()).forEach(id => this.remove(id));
+  }
+
+  /**
+   * Forget removals every client has already been sent
+   */
+  prune(syncedVersion: number): void {
+    let drop = 0;
+    while (drop < this.tombstones.length && this.tombstones[drop].version <= syncedVersion) {
+      drop++;
+    }
+    if (drop > 0) {
+      this.tombstones = this.tombstones.slice(drop);
+    }
+  }
+
+  /**
+   * Encode the changes after `since` (0 for a full snapshot); null when there are none
+   */
+  delta(since: number, now: number = Date.now()): Uint8Array | null {
+    if (since >= this._version) {
+      return null;
+    }
+    const reset = since === 0 || since < this.oldestTombstone;
+    const removals = reset ? [] : this.tombstones.filter(t => t.version > since);
+
+    // Size first, so the frame is one allocation
+    const ids: Array<Uint8Array | null> = [];
+    const upserts: number[] = [];
+    let size = PEER_FRAME_HEADER_SIZE + removals.length * 2;
+    for (let number = 0; number < this.slots.length; number++) {
+      const slot = this.slots[number];
+      if (!slot || (!reset && slot.version <= since)) {
+        continue;
+      }
+      const id = reset || slot.created > since ? encoder.encode(slot.id).subarray(0, 255) : null;
+      upserts.push(number);
+      ids.push(id);
+      size += PEER_RECORD_SIZE + (id ? 1 + id.length : 0);
+    }
+
+    const frame = new Uint8Array(size);
+    const view = new DataView(frame.buffer);
+    view.setUint8(0, PEER_FRAME_DELTA);
+    view.setUint8(1, reset ? PEER_FRAME_RESET : 0);
+    view.setUint16(2, upserts.length, true);
+    view.setUint16(4, removals.length, true);
+    view.setUint16(6, Math.min(this.active, 0xffff), true);
+    view.setUint16(8, Math.min(this.index.size, 0xffff), true);
+    view.setUint32(12, this._version >>> 0, true);
+    view.setFloat64(16, now, true);
+
+    let offset = PEER_FRAME_HEADER_SIZE;
+    for (let i = 0; i < upserts.length; i++) {
+      const slot = this.slots[upserts[i]]!;
+      const id = ids[i];
+      view.setUint16(offset, upserts[i], true);
+      view.setUint8(offset + 2, (id ? PEER_HAS_ID : 0) | (slot.active ? PEER_ACTIVE : 0));
+      view.setInt8(offset + 3, Math.max(-128, Math.min(127, Math.round(slot.rssi))));
+      view.setUint32(offset + 4, Math.max(0, Math.min(now - slot.lastSeen, 0xffffffff)), true);
+      view.setUint32(offset + 8, Math.min(slot.activityCount, 0xffffffff), true);
+      offset += PEER_RECORD_SIZE;
+      if (id) {
+        frame[offset] = id.length;
+        frame.set(id, offset + 1);
+        offset += 1 + id.length;
+      }
+    }
+    for (const removal of removals) {
+      view.setUint16(offset, removal.slot, true);
+      offset += 2;
+    }
+    return frame;
+  }
+
+  private setActive(slot: Slot, active: boolean): void {
+    if (slot.active !== active) {
+      this.active += active ? 1 : -1;
+      slot.active = active;
+    }
+  }
+}
+
+/**
+ * Browser-side copy of a PeerTable, rebuilt from delta frames
+ */
+export class PeerTableMirror {
+  private readonly slots = new Map<number, PeerState>();
+  activeCount = 0;
+  totalCount = 0;
+
+  /**
+   * Apply one frame; returns the ids removed by it
+   * @throws {RangeError} On a frame that is not a peer delta or is truncated
+   */
+  apply(data: ArrayBuffer | Uint8Array): string[] {
+    const bytes = data instanceof Uint8Array ? data : new Uint8Array(data);
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    if (bytes.length < PEER_FRAME_HEADER_SIZE || view.getUint8(0) !== PEER_FRAME_DELTA) {
+      throw new RangeError('Not a peer delta frame');
+    }
+    const flags = view.getUint8(1);
+    const upserts = view.getUint16(2, true);
+    const removals = view.getUint16(4, true);
+    this.activeCount = view.getUint16(6, true);
+    this.totalCount = view.getUint16(8, true);
+    const timestamp = view.getFloat64(16, true);
+
+    const removed: string[] = [];
+    if (flags & PEER_FRAME_RESET) {
+      this.slots.forEach(peer => removed.push(peer.id));
+      this.slots.clear();
+    }
+
+    // Upserts precede removals on the wire, but removals apply first: a freed slot may be reused
+    let offset = PEER_FRAME_HEADER_SIZE;
+    const records: Array<{ number: number; flags: number; rssi: number; age: number; count: number; id?: string }> = [];
+    for (let i = 0; i < upserts; i++) {
+      if (offset + PEER_RECORD_SIZE > bytes.length) {
+        throw new RangeError('Truncated peer delta frame');
+      }
+      const record = {
+        number: view.getUint16(offset, true),
+        flags: view.getUint8(offset + 2),
+        rssi: view.getInt8(offset + 3),
+        age: view.getUint32(offset + 4, true),
+        count: view.getUint32(offset + 8, true),
+        id: undefined as string | undefined,
+      };
+      offset += PEER_RECORD_SIZE;
+      if (record.flags & PEER_HAS_ID) {
+        const length = bytes[offset];
+        if (offset + 1 + length > bytes.length) {
+          throw new RangeError('Truncated peer delta frame');
+        }
+        record.id = decoder.decode(bytes.subarray(offset + 1, offset + 1 + length));
+        offset += 1 + length;
+      }
+      records.push(record);
+    }
+    if (offset + removals * 2 > bytes.length) {
+      throw new RangeError('Truncated peer delta frame');
+    }
+    for (let i = 0; i < removals; i++) {
+      const number = view.getUint16(offset + i * 2, true);
+      const peer = this.slots.get(number);
+      if (peer) {
+        removed.push(peer.id);
+        this.slots.delete(number);
+      }
+    }
+
+    for (const record of records) {
+      const existing = this.slots.get(record.number);
+      const id = record.id ?? existing?.id;
+      if (id === undefined) {
+        continue; // Update for a slot this mirror never learned; the next reset repairs it
+      }
+      this.slots.set(record.number, {
+        id,
+        rssi: record.rssi,
+        lastSeen: timestamp - record.age,
+        activityCount: record.count,
+        active: (record.flags & PEER_ACTIVE) !== 0,
+      });
+    }
+    if (removed.length === 0) {
+      return removed;
+    }
+    // A reset re-sends live peers, and a removed peer may come back in the same frame
+    const live = new Set<string>();
+    this.slots.forEach(peer => live.add(peer.id));
+    return removed.filter(id => !live.has(id));
+  }
+
+  /**
+   * Peers, most recently seen first
+   */
+  peers(): PeerState[] {
+    return Array.from(this.slots.values()).sort((a, b) => b.lastSeen - a.lastSeen);
+  }
+}
+
+/**
+ * The part of a WebSocket the stream needs
+ */
+export interface PeerStreamClient {
+  readonly bufferedAmount: number;
+  send(data: Uint8Array): void;
+}
+
+/**
+ * Coalesces table changes into at most `rate` frames per second per client
+ */
+export class PeerStream {
+  private readonly clients = new Map<PeerStreamClient, number>(); // Client -> version it has
+  private timer: ReturnType<typeof setInterval> | null = null;
+
+  constructor(
+    readonly table: PeerTable,
+    private readonly rate: number = PEER_STREAM_RATE,
+    private readonly highWater: number = PEER_STREAM_HIGH_WATER
+  ) {}
+
+  add(client: PeerStreamClient): void {
+    this.clients.set(client, 0);
+    if (!this.timer) {
+      this.timer = setInterval(() => this.flush(), Math.max(1, Math.round(1000 / this.rate)));
+      // Never the only thing keeping the process alive
+      (this.timer as any).unref?.();
+    }
+  }
+
+  delete(client: PeerStreamClient): void {
+    this.clients.delete(client);
+    if (this.clients.size === 0 && this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+  }
+
+  /**
+   * Send each caught-up client its delta; congested ones wait for a later tick
+   */
+  flush(now: number = Date.now()): void {
+    let synced = Infinity;
+    for (const [client, version] of this.clients) {
+      let next = version;
+      if (client.bufferedAmount <= this.highWater) {
+        const frame = this.table.delta(version, now);
+        if (frame) {
+          client.send(frame);
+          next = this.table.version;
+          this.clients.set(client, next);
+        }
+      }
+      if (next > 0) {
+        synced = Math.min(synced, next);
+      }
+    }
+    if (synced !== Infinity) {
+      this.table.prune(synced);
+    }
+  }
+
+  stop(): void {
+    if (this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+    this.clients.clear();
+  }
+}
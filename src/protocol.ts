@@ -3,6 +3,8 @@
  * Uses phone numbers as routing IDs and supports auto-relay
  */
 
+import { decodeMessage, encodedMessageBound, encodeMessage } from './message-codec';
+
 export interface Message {
   // Destination phone number (e.g., "+1234567890")
   to: string;
@@ -19,28 +21,28 @@ export interface Message {
 }
 
 export const MAX_HOPS = 10;
+
+// Version of the legacy JSON payload; binary frames carry MESSAGE_CODEC_VERSION
 export const MESSAGE_VERSION = 1;
 
 /**
  * Serialize a message to a Buffer for BLE transmission
+ * Produces the compact binary frame from message-codec.ts; to avoid the
+ * copy, encode straight into a payload buffer with encodeMessage()
  */
 export function serializeMessage(message: Message): Buffer {
-  const data = {
-    v: MESSAGE_VERSION,
-    t: message.to,
-    f: message.from,
-    c: message.content,
-    i: message.id,
-    ts: message.timestamp,
-    h: message.hops
-  };
-  return Buffer.from(JSON.stringify(data), 'utf-8');
+  const out = Buffer.allocUnsafe(encodedMessageBound(message));
+  return out.subarray(0, encodeMessage(message, out));
 }
 
 /**
  * Deserialize a Buffer back to a Message
+ * Accepts binary frames and, from older nodes, the JSON payload
  */
 export function deserializeMessage(buffer: Buffer): Message | null {
+  if (buffer.length > 0 && buffer[0] !== 0x7b) {
+    return decodeMessage(buffer);
+  }
   try {
     const data = JSON.parse(buffer.toString('utf-8'));
     if (data.v !== MESSAGE_VERSION) {
@@ -83,9 +85,22 @@ export enum MessageType {
   SOS = 0x01,
   TEXT = 0x02,
   GPS = 0x03,
+  DIGEST = 0x04,
   BROADCAST = 0xFF
 }
 
+// Byte of the 27-byte frame that holds the MessageType, in every frame kind
+const FRAME_TYPE_OFFSET = 18;
+
+/**
+ * 64-bit message ID as it goes on air (bytes 2-9 of a message frame)
+ * Nodes only agree on this part of the ID: receivers rebuild the rest
+ */
+export function manufacturerMessageKey(message: Message): bigint {
+  const head = message.id.split('-')[0];
+  return /^\d+$/.test(head) ? BigInt(head) : BigInt(Math.max(0, Math.floor(message.timestamp)));
+}
+
 /**
  * Encode message to compact manufacturer data format (27 bytes)
  * Format:
@@ -105,8 +120,7 @@ export function encodeToManufacturerData(message: Message): Buffer {
   buffer.writeUInt16LE(0xFFFF, 0);
 
   // Message ID (use timestamp as unique ID)
-  const msgId = BigInt(message.id.split('-')[0] || message.timestamp);
-  buffer.writeBigUInt64LE(msgId, 2);
+  buffer.writeBigUInt64LE(manufacturerMessageKey(message), 2);
 
   // Phone numbers (last 4 digits only for privacy and space)
   const fromDigits = parseInt(message.from.replace(/\D/g, '').slice(-4)) || 0;
@@ -161,6 +175,7 @@ export function decodeFromManufacturerData(data: Buffer): Message | null {
 
     const companyId = data.readUInt16LE(0);
     if (companyId !== 0xFFFF) return null;
+    if (data[FRAME_TYPE_OFFSET] === MessageType.DIGEST) return null;
 
     // Extract fields
     const timestamp = Number(data.readBigUInt64LE(2));
@@ -215,3 +230,49 @@ export function decodeFromManufacturerData(data: Buffer): Message | null {
     return null;
   }
 }
+
+/**
+ * Recently-seen digest carried by a DIGEST frame
+ */
+export interface DigestFrame {
+  // SEEN_DIGEST_BYTES-byte Bloom filter of on-air message keys
+  digest: Buffer;
+  // Keys the sender put in it
+  keyCount: number;
+}
+
+// Digest bytes before and after the type and key-count bytes
+const DIGEST_HEAD_BYTES = FRAME_TYPE_OFFSET - 2;
+const DIGEST_TAIL_OFFSET = FRAME_TYPE_OFFSET + 2;
+
+/**
+ * Encode a recently-seen digest as a 27-byte DIGEST frame
+ * Format (the type stays at byte 18, as in message frames):
+ * - Bytes 0-1: Company ID (0xFFFF)
+ * - Bytes 2-17: Digest bytes 0-15
+ * - Byte 18: Message type (DIGEST=0x04)
+ * - Byte 19: Keys in the digest (0-255)
+ * - Bytes 20-26: Digest bytes 16-22
+ */
+export function encodeDigestFrame(digest: Buffer, keyCount: number): Buffer {
+  const buffer = Buffer.alloc(27);
+  buffer.writeUInt16LE(0xFFFF, 0);
+  digest.copy(buffer, 2, 0, DIGEST_HEAD_BYTES);
+  buffer.writeUInt8(MessageType.DIGEST, FRAME_TYPE_OFFSET);
+  buffer.writeUInt8(Math.min(Math.max(0, keyCount), 255), FRAME_TYPE_OFFSET + 1);
+  digest.copy(buffer, DIGEST_TAIL_OFFSET, DIGEST_HEAD_BYTES, DIGEST_HEAD_BYTES + 27 - DIGEST_TAIL_OFFSET);
+  return buffer;
+}
+
+/**
+ * Decode a DIGEST frame; null for any other manufacturer data
+ */
+export function decodeDigestFrame(data: Buffer): DigestFrame | null {
+  if (data.length < 27 || data.readUInt16LE(0) !== 0xFFFF || data[FRAME_TYPE_OFFSET] !== MessageType.DIGEST) {
+    return null;
+  }
+  return {
+    digest: Buffer.concat([data.subarray(2, FRAME_TYPE_OFFSET), data.subarray(DIGEST_TAIL_OFFSET, 27)]),
+    keyCount: data[FRAME_TYPE_OFFSET + 1]
+  };
+}
@@ -0,0 +1,205 @@
+/**
+ * Relay decision engine
+ * Counter-based flooding suppression: a relay waits out a random backoff and is
+ * cancelled once enough duplicates have been overheard in the meantime. Uses the
+ * native RelayScheduler when the addon is available, otherwise the equivalent
+ * TypeScript implementation below.
+ */
+
+import { loadNativeAddon } from './native';
+
+export interface RelayOptions {
+  // Backoff window in ms (edge-of-range nodes draw from its lower half)
+  minBackoffMs?: number;
+  maxBackoffMs?: number;
+  // Duplicates that cancel a relay first heard at strongRssi / weakRssi
+  minThreshold?: number;
+  maxThreshold?: number;
+  // dBm bounds of the proximity scale
+  strongRssi?: number;
+  weakRssi?: number;
+  // Relays pending at once
+  capacity?: number;
+  // Backoff PRNG seed for reproducible runs; 0 or omitted picks a random one
+  seed?: number;
+}
+
+export interface RelayStats {
+  pending: number;
+  scheduled: number;
+  relayed: number;
+  suppressed: number;
+  overflowed: number;
+}
+
+export const DEFAULT_RELAY_OPTIONS: Required<RelayOptions> = {
+  minBackoffMs: 100,
+  maxBackoffMs: 500,
+  minThreshold: 2,
+  maxThreshold: 4,
+  strongRssi: -50,
+  weakRssi: -90,
+  capacity: 1024,
+  seed: 0
+};
+
+interface Pending {
+  dueMs: number;
+  heard: number;
+  threshold: number;
+  suppressed: boolean;
+}
+
+/**
+ * Same rules as the native scheduler (cpp/relay_scheduler.cc); with the same
+ * seed both draw the same backoffs
+ */
+class TsRelayScheduler {
+  private readonly options: Required<RelayOptions>;
+  private readonly pending: Map<string, Pending> = new Map();
+  private state: number;
+  private counters = { scheduled: 0, relayed: 0, suppressed: 0, overflowed: 0 };
+
+  constructor(options: RelayOptions) {
+    const o = { ...DEFAULT_RELAY_OPTIONS, ...options };
+    if (o.maxBackoffMs < o.minBackoffMs) [o.minBackoffMs, o.maxBackoffMs] = [o.maxBackoffMs, o.minBackoffMs];
+    if (o.maxThreshold < o.minThreshold) [o.minThreshold, o.maxThreshold] = [o.maxThreshold, o.minThreshold];
+    o.minThreshold = Math.max(1, o.minThreshold);
+    o.maxThreshold = Math.max(o.minThreshold, o.maxThreshold);
+    o.capacity = Math.max(1, o.capacity);
+    this.options = o;
+
+    this.state = Math.imul(o.seed >>> 0, 0x9e3779b9) >>> 0;
+    while (this.state === 0) {
+      this.state = (Math.random() * 0x100000000) >>> 0;
+    }
+  }
+
+  schedule(id: string, rssi: number, now: number): number {
+    const existing = this.pending.get(id);
+    if (existing) {
+      return Math.max(0, existing.dueMs - now);
+    }
+
+    const { minBackoffMs, maxBackoffMs, capacity } = this.options;
+    const window = (maxBackoffMs - minBackoffMs) * (0.5 + 0.5 * this.proximity(rssi));
+    const backoff = minBackoffMs + Math.floor(this.nextUniform() * window);
+    this.counters.scheduled++;
+
+    if (this.pending.size >= capacity) {
+      this.dropOverdue(now);
+    }
+    if (this.pending.size >= capacity) {
+      this.counters.overflowed++;
+      return backoff;
+    }
+
+    this.pending.set(id, { dueMs: now + backoff, heard: 0, threshold: this.thresholdFor(rssi), suppressed: false });
+    return backoff;
+  }
+
+  overheard(id: string): boolean {
+    const entry = this.pending.get(id);
+    if (!entry || entry.suppressed || ++entry.heard < entry.threshold) {
+      return false;
+    }
+    entry.suppressed = true;
+    this.counters.suppressed++;
+    return true;
+  }
+
+  release(id: string): boolean {
+    const entry = this.pending.get(id);
+    this.pending.delete(id);
+    if (entry?.suppressed) {
+      return false;
+    }
+    this.counters.relayed++;
+    return true;
+  }
+
+  thresholdFor(rssi: number): number {
+    const { minThreshold, maxThreshold } = this.options;
+    return maxThreshold - Math.round(this.proximity(rssi) * (maxThreshold - minThreshold));
+  }
+
+  stats(): RelayStats {
+    return { pending: this.pending.size, ...this.counters };
+  }
+
+  private proximity(rssi: number): number {
+    const { strongRssi, weakRssi } = this.options;
+    if (strongRssi <= weakRssi) {
+      return rssi >= strongRssi ? 1 : 0;
+    }
+    return Math.min(1, Math.max(0, (rssi - weakRssi) / (strongRssi - weakRssi)));
+  }
+
+  // xorshift32, as in the native scheduler
+  private nextUniform(): number {
+    let x = this.state;
+    x ^= x << 13;
+    x ^= x >>> 17;
+    x ^= x << 5;
+    this.state = x >>> 0;
+    return this.state / 0x100000000;
+  }
+
+  private dropOverdue(now: number): void {
+    for (const [id, entry] of this.pending) {
+      if (entry.dueMs + this.options.maxBackoffMs <= now) {
+        this.pending.delete(id);
+      }
+    }
+  }
+}
+
+/**
+ * Decides which received messages are worth relaying
+ *
+ * Call schedule() for a message heard for the first time and arm a timer for
+ * the returned backoff; call overheard() for every duplicate the seen-message
+ * cache rejects; when the timer fires, transmit only if release() says so.
+ */
+export class RelayScheduler {
+  private readonly impl: any;
+
+  constructor(options: RelayOptions = {}) {
+    const native = loadNativeAddon();
+    this.impl = native?.RelayScheduler
+      ? new native.RelayScheduler(options)
+      : new TsRelayScheduler(options);
+  }
+
+  /**
+   * Schedule the relay of a new message; returns the backoff in ms
+   */
+  schedule(id: string, rssi: number): number {
+    return this.impl.schedule(id, rssi, Date.now());
+  }
+
+  /**
+   * Count an overheard duplicate; returns true if it cancelled the relay
+   */
+  overheard(id: string): boolean {
+    return this.impl.overheard(id);
+  }
+
+  /**
+   * The backoff elapsed; returns false if the relay was suppressed
+   */
+  release(id: string): boolean {
+    return this.impl.release(id);
+  }
+
+  /**
+   * Duplicates needed to cancel a relay first heard at `rssi`
+   */
+  thresholdFor(rssi: number): number {
+    return this.impl.thresholdFor(rssi);
+  }
+
+  stats(): RelayStats {
+    return this.impl.stats();
+  }
+}
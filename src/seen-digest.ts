@@ -0,0 +1,141 @@
+/**
+ * Recently-seen digest
+ * A 184-bit Bloom filter of the newest message keys a node holds, advertised
+ * in DIGEST frames so neighbours can skip relaying what is already nearby.
+ * Uses the native SeenDigest when the addon is available, otherwise the
+ * equivalent TypeScript implementation below; both set the same bits, so
+ * nodes with and without the addon read each other's digests.
+ */
+
+import { loadNativeAddon } from './native';
+
+// Digest bytes on air (kSeenDigestBytes in native-ble/cpp/seen_digest.h)
+export const SEEN_DIGEST_BYTES = 23;
+
+// Newest keys a digest covers; about 1% false positives when full
+export const SEEN_DIGEST_KEYS = 16;
+
+const DIGEST_BITS = SEEN_DIGEST_BYTES * 8;
+const DIGEST_HASHES = 4;
+const MASK_64 = (1n << 64n) - 1n;
+
+/**
+ * Bit `index` that `key` sets: double hashing over a splitmix64 finalizer,
+ * as SeenDigestBit() in native-ble/cpp/seen_digest.cc
+ */
+function digestBit(key: bigint, index: number): number {
+  let z = key & MASK_64;
+  z = ((z ^ (z >> 30n)) * 0xbf58476d1ce4e5b9n) & MASK_64;
+  z = ((z ^ (z >> 27n)) * 0x94d049bb133111ebn) & MASK_64;
+  z ^= z >> 31n;
+  const h1 = Number(z & 0xffffffffn);
+  const h2 = (Number(z >> 32n) | 1) >>> 0;
+  return (h1 + index * h2) % DIGEST_BITS;
+}
+
+function setKey(bits: Buffer, key: bigint): void {
+  for (let i = 0; i < DIGEST_HASHES; i++) {
+    const bit = digestBit(key, i);
+    bits[bit >> 3] |= 1 << (bit & 7);
+  }
+}
+
+function digestContains(digest: Uint8Array, key: bigint): boolean {
+  for (let i = 0; i < DIGEST_HASHES; i++) {
+    const bit = digestBit(key, i);
+    if ((digest[bit >> 3] & (1 << (bit & 7))) === 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Ring of the newest keys; rebuilt into the filter when the oldest falls off
+ */
+class TsSeenDigest {
+  private readonly keys: bigint[] = [];
+  private readonly capacity: number;
+  private next = 0;
+  private readonly digest = Buffer.alloc(SEEN_DIGEST_BYTES);
+
+  constructor(recentKeys: number) {
+    this.capacity = Math.max(1, Math.floor(recentKeys));
+  }
+
+  add(key: bigint): boolean {
+    if (this.keys.includes(key)) {
+      return false;
+    }
+    if (this.keys.length < this.capacity) {
+      this.keys.push(key);
+      setKey(this.digest, key);
+      return true;
+    }
+    this.keys[this.next] = key;
+    this.next = (this.next + 1) % this.capacity;
+    this.digest.fill(0);
+    this.keys.forEach(recent => setKey(this.digest, recent));
+    return true;
+  }
+
+  bits(): Buffer {
+    return Buffer.from(this.digest);
+  }
+
+  size(): number {
+    return this.keys.length;
+  }
+
+  clear(): void {
+    this.keys.length = 0;
+    this.next = 0;
+    this.digest.fill(0);
+  }
+}
+
+export class SeenDigest {
+  private readonly impl: any;
+  private readonly containsImpl: (digest: Uint8Array, key: bigint) => boolean;
+
+  constructor(recentKeys: number = SEEN_DIGEST_KEYS) {
+    const native = loadNativeAddon();
+    if (native?.SeenDigest) {
+      this.impl = new native.SeenDigest(recentKeys);
+      this.containsImpl = native.SeenDigest.contains;
+    } else {
+      this.impl = new TsSeenDigest(recentKeys);
+      this.containsImpl = digestContains;
+    }
+  }
+
+  /**
+   * Record the on-air key of a message this node holds; false if already recent
+   */
+  add(key: bigint): boolean {
+    return this.impl.add(key);
+  }
+
+  /**
+   * The digest to advertise (SEEN_DIGEST_BYTES bytes, a copy)
+   */
+  bits(): Buffer {
+    return this.impl.bits();
+  }
+
+  /**
+   * Whether a digest may hold `key`: false is certain, true is right
+   * except for the odd false positive
+   */
+  contains(digest: Uint8Array, key: bigint): boolean {
+    return digest.length >= SEEN_DIGEST_BYTES && this.containsImpl(digest, key);
+  }
+
+  clear(): void {
+    this.impl.clear();
+  }
+
+  get size(): number {
+    return this.impl.size();
+  }
+}
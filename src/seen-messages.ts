@@ -0,0 +1,127 @@
+/**
+ * Seen-message cache
+ * Fixed-memory set of message IDs that forgets entries after a time window.
+ * Uses the native MessageIdSet when the addon is available, otherwise an
+ * equivalent ring of time buckets in TypeScript.
+ */
+
+import { loadNativeAddon } from './native';
+
+// Default retention for seen message IDs (1 hour)
+export const SEEN_MESSAGE_WINDOW_MS = 3600000;
+
+// Expected distinct message IDs per window
+export const SEEN_MESSAGE_CAPACITY = 8192;
+
+const BUCKET_COUNT = 8;
+
+interface Bucket {
+  epoch: number;
+  ids: Set<string>;
+}
+
+/**
+ * Ring of time buckets: inserts go to the bucket for the current time slice,
+ * and a bucket is wiped wholesale when the ring wraps back onto it
+ */
+class BucketedIdSet {
+  private readonly spanMs: number;
+  private readonly bucketLimit: number;
+  private readonly buckets: Bucket[] = [];
+  private epoch = 0;
+
+  constructor(windowMs: number, capacity: number) {
+    this.spanMs = Math.max(1, Math.ceil(windowMs / (BUCKET_COUNT - 1)));
+    this.bucketLimit = Math.max(4, Math.ceil(capacity / (BUCKET_COUNT - 1)));
+    for (let i = 0; i < BUCKET_COUNT; i++) {
+      this.buckets.push({ epoch: 0, ids: new Set() });
+    }
+  }
+
+  add(id: string, now: number): boolean {
+    if (this.has(id, now)) {
+      return false;
+    }
+    const current = this.buckets[this.epoch % BUCKET_COUNT];
+    // A full bucket lets the ID through rather than evicting live entries
+    if (current.ids.size < this.bucketLimit) {
+      current.ids.add(id);
+    }
+    return true;
+  }
+
+  has(id: string, now: number): boolean {
+    this.advance(now);
+    return this.buckets.some(bucket => this.isLive(bucket) && bucket.ids.has(id));
+  }
+
+  expire(olderThan: number, now: number): void {
+    this.advance(now);
+    const cutoff = now - olderThan;
+    for (const bucket of this.buckets) {
+      if (this.isLive(bucket) && (bucket.epoch + 1) * this.spanMs <= cutoff) {
+        bucket.ids.clear();
+      }
+    }
+  }
+
+  size(now: number): number {
+    this.advance(now);
+    return this.buckets.reduce((total, bucket) => total + (this.isLive(bucket) ? bucket.ids.size : 0), 0);
+  }
+
+  clear(): void {
+    this.buckets.forEach(bucket => bucket.ids.clear());
+  }
+
+  private advance(now: number): void {
+    this.epoch = Math.max(this.epoch, Math.floor(now / this.spanMs));
+    const current = this.buckets[this.epoch % BUCKET_COUNT];
+    if (current.epoch !== this.epoch) {
+      current.ids.clear();
+      current.epoch = this.epoch;
+    }
+  }
+
+  private isLive(bucket: Bucket): boolean {
+    return bucket.ids.size > 0 && bucket.epoch + BUCKET_COUNT > this.epoch;
+  }
+}
+
+export class SeenMessageCache {
+  private readonly impl: any;
+
+  constructor(windowMs: number = SEEN_MESSAGE_WINDOW_MS, capacity: number = SEEN_MESSAGE_CAPACITY) {
+    const native = loadNativeAddon();
+    this.impl = native?.MessageIdSet
+      ? new native.MessageIdSet(windowMs, capacity)
+      : new BucketedIdSet(windowMs, capacity);
+  }
+
+  /**
+   * Record a message ID; returns false if it was already seen within the window
+   * @param seenAt When the ID was seen, to restore earlier sightings in time order
+   */
+  add(id: string, seenAt: number = Date.now()): boolean {
+    return this.impl.add(id, seenAt);
+  }
+
+  has(id: string): boolean {
+    return this.impl.has(id, Date.now());
+  }
+
+  /**
+   * Forget IDs recorded more than `olderThan` ms ago
+   */
+  expire(olderThan: number): void {
+    this.impl.expire(olderThan, Date.now());
+  }
+
+  clear(): void {
+    this.impl.clear();
+  }
+
+  get size(): number {
+    return this.impl.size(Date.now());
+  }
+}